@@ -1769,6 +1769,7 @@ m4_include([auxdir/x_ac_freeipmi.m4])
 m4_include([auxdir/x_ac_hpe_slingshot.m4])
 m4_include([auxdir/x_ac_http_parser.m4])
 m4_include([auxdir/x_ac_hwloc.m4])
+m4_include([auxdir/x_ac_jemalloc.m4])
 m4_include([auxdir/x_ac_json.m4])
 m4_include([auxdir/x_ac_jwt.m4])
 m4_include([auxdir/x_ac_lua.m4])
@@ -1793,5 +1794,6 @@ m4_include([auxdir/x_ac_sview.m4])
 m4_include([auxdir/x_ac_systemd.m4])
 m4_include([auxdir/x_ac_ucx.m4])
 m4_include([auxdir/x_ac_uid_gid_size.m4])
+m4_include([auxdir/x_ac_usdt.m4])
 m4_include([auxdir/x_ac_x11.m4])
 m4_include([auxdir/x_ac_yaml.m4])
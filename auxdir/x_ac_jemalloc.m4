@@ -0,0 +1,61 @@
+##*****************************************************************************
+#  SYNOPSIS:
+#    X_AC_JEMALLOC
+#
+#  DESCRIPTION:
+#    Test if jemalloc is wanted and installed. If found define appropriate
+#    ENVs. slurmctld is linked against it in place of the libc allocator.
+#
+##*****************************************************************************
+
+AC_DEFUN([X_AC_JEMALLOC],
+#
+# Handle user hints
+#
+[AC_MSG_CHECKING(if jemalloc is wanted)
+jemalloc_places="/usr/local /usr /opt/local /sw"
+AC_ARG_WITH([jemalloc],
+[  --with-jemalloc[[=PATH]]  Link slurmctld with jemalloc, optionally at PATH],
+[AS_IF([test "x$with_jemalloc" != xno],
+       [AS_IF([test "x$with_jemalloc" != xyes],
+              [jemalloc_places="$with_jemalloc"])
+        AC_MSG_RESULT([yes])],
+       [AC_MSG_RESULT([no])])],
+[with_jemalloc=no
+ AC_MSG_RESULT([no])])
+
+if [test "x$with_jemalloc" != xno]; then
+  HAVE_JEMALLOC=0
+  for JEMALLOC_HOME in ${jemalloc_places} ; do
+    test -f "${JEMALLOC_HOME}/include/jemalloc/jemalloc.h" || continue
+
+    JEMALLOC_OLD_LDFLAGS=$LDFLAGS
+    JEMALLOC_LDFLAGS="-L${JEMALLOC_HOME}/lib"
+    JEMALLOC_LIBS="-ljemalloc"
+    LDFLAGS="$LDFLAGS ${JEMALLOC_LDFLAGS}"
+
+    AC_LANG_SAVE
+    AC_LANG([C])
+    AC_CHECK_LIB([jemalloc], [mallctl], [ac_cv_jemalloc=yes],
+                 [ac_cv_jemalloc=no])
+    AC_LANG_RESTORE
+    unset ac_cv_lib_jemalloc_mallctl
+
+    LDFLAGS="$JEMALLOC_OLD_LDFLAGS"
+
+    if [test "$ac_cv_jemalloc" = "yes"]; then
+        AC_SUBST(JEMALLOC_LDFLAGS)
+        AC_SUBST(JEMALLOC_LIBS)
+        AC_DEFINE([HAVE_JEMALLOC], [1],
+                  [Define to 1 if slurmctld is linked with jemalloc])
+        HAVE_JEMALLOC=1
+        break
+    fi
+  done
+
+  if [test "$HAVE_JEMALLOC" != 1]; then
+    AC_MSG_ERROR([unable to locate working jemalloc installation])
+  fi
+fi
+
+])
@@ -0,0 +1,35 @@
+##*****************************************************************************
+#  SYNOPSIS:
+#    X_AC_USDT
+#
+#  DESCRIPTION:
+#    Add support for the "--enable-usdt" configure script option, which
+#    compiles SystemTap/USDT static probes into the daemons.
+#
+#  WARNINGS:
+#    This macro must be placed after AC_PROG_CC or equivalent.
+##*****************************************************************************
+
+AC_DEFUN([X_AC_USDT], [
+  AC_MSG_CHECKING([whether USDT probes are enabled])
+  AC_ARG_ENABLE(
+    [usdt],
+    AS_HELP_STRING(--enable-usdt, enable USDT static probes (needs sys/sdt.h)),
+    [ case "$enableval" in
+        yes) x_ac_usdt=yes ;;
+         no) x_ac_usdt=no ;;
+          *) AC_MSG_RESULT([doh!])
+             AC_MSG_ERROR([bad value "$enableval" for --enable-usdt]) ;;
+      esac
+    ],
+    [x_ac_usdt=no]
+  )
+  AC_MSG_RESULT([${x_ac_usdt}])
+
+  if test "$x_ac_usdt" = yes; then
+    AC_CHECK_HEADER([sys/sdt.h],
+      [AC_DEFINE([HAVE_USDT], [1],
+                 [Define to 1 to compile USDT static probes.])],
+      [AC_MSG_ERROR([--enable-usdt requires sys/sdt.h (systemtap-sdt-devel)])])
+  fi
+])
@@ -0,0 +1,759 @@
+/*****************************************************************************\
+ *  slurmd_emu.c - Emulate many slurmd daemons from a single process
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * slurmd_emu listens on the configured Port of every node it emulates and
+ * answers the RPCs slurmctld sends to a slurmd: ping, registration, batch job
+ * launch, prolog launch and job termination. Batch jobs are not run. Each one
+ * is reported complete after a configurable duration, after which slurmctld
+ * terminates the job and every node answers with an epilog complete message.
+ * This is enough for slurmctld to schedule, launch and clean up jobs normally,
+ * so the scheduler, agent and RPC paths can be loaded at a scale that would
+ * otherwise need one slurmd (and slurmstepd per job) per node.
+ */
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/common/hostlist.h"
+#include "src/common/list.h"
+#include "src/common/log.h"
+#include "src/common/node_conf.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_api.h"
+#include "src/common/slurm_rlimits_info.h"
+#include "src/common/uid.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/conmgr/conmgr.h"
+
+#include "src/interfaces/acct_gather_energy.h"
+#include "src/interfaces/auth.h"
+#include "src/interfaces/cred.h"
+#include "src/interfaces/gres.h"
+#include "src/interfaces/hash.h"
+
+typedef struct {
+	node_record_t *node_ptr;
+	list_t *jobs;		/* uint32_t job ids of running batch jobs */
+	bool registered;
+} emu_node_t;
+
+typedef struct {
+	emu_node_t *node;
+	uint32_t job_id;
+} emu_job_t;
+
+static char *conf_file = NULL;
+static char *node_list = NULL;
+static uint32_t duration_min = 60;
+static uint32_t duration_max = 60;
+static bool script_duration = true;
+static int thread_count = 0;
+
+static emu_node_t *emu_nodes = NULL;
+static int emu_node_cnt = 0;
+static time_t start_time = 0;
+static char *emu_arch = NULL;
+static char *emu_os = NULL;
+
+static pthread_mutex_t emu_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t cnt_rpc = 0;
+static uint64_t cnt_reg = 0;
+static uint64_t cnt_launch = 0;
+static uint64_t cnt_complete = 0;
+static uint64_t cnt_epilog = 0;
+static uint64_t cnt_send_fail = 0;
+static bool forward_warned = false;
+
+static void _usage(void)
+{
+	fprintf(stderr,
+"Usage: slurmd_emu [OPTIONS]\n"
+"  -d, --duration=SEC[-SEC]  Run each batch job for SEC seconds, or for a\n"
+"                            random time within the range (default 60).\n"
+"  -f, --conf=FILE           Read configuration from the specified file.\n"
+"  -h, --help                Print this help message.\n"
+"  -N, --nodes=NODELIST      Nodes to emulate (default all configured nodes).\n"
+"      --no-script-duration  Do not take the duration from a \"sleep N\"\n"
+"                            line in the batch script.\n"
+"  -t, --threads=COUNT       Number of conmgr worker threads.\n"
+"  -v, --verbose             Verbose mode. Multiple -v's increase verbosity.\n");
+}
+
+static void _parse_duration(const char *arg)
+{
+	char *end = NULL;
+	long min, max;
+
+	min = strtol(arg, &end, 10);
+	if (*end == '-')
+		max = strtol(end + 1, &end, 10);
+	else
+		max = min;
+
+	if ((*end != '\0') || (min < 0) || (max < min) || (max > INFINITE))
+		fatal("Invalid --duration: %s", arg);
+
+	duration_min = min;
+	duration_max = max;
+}
+
+static void _parse_args(int argc, char **argv)
+{
+	log_options_t logopt = LOG_OPTS_STDERR_ONLY;
+	int c = 0, option_index = 0;
+
+	enum {
+		LONG_OPT_ENUM_START = 0x100,
+		LONG_OPT_NO_SCRIPT_DURATION,
+	};
+
+	static struct option long_options[] = {
+		{"conf", required_argument, 0, 'f'},
+		{"duration", required_argument, 0, 'd'},
+		{"help", no_argument, 0, 'h'},
+		{"nodes", required_argument, 0, 'N'},
+		{"no-script-duration", no_argument, 0,
+		 LONG_OPT_NO_SCRIPT_DURATION},
+		{"threads", required_argument, 0, 't'},
+		{"verbose", no_argument, 0, 'v'},
+		{NULL, 0, 0, 0}
+	};
+
+	log_init(xbasename(argv[0]), logopt, 0, NULL);
+
+	opterr = 0;
+	while ((c = getopt_long(argc, argv, "d:f:hN:t:v",
+				long_options, &option_index)) != -1) {
+		switch (c) {
+		case (int) 'd':
+			_parse_duration(optarg);
+			break;
+		case (int) 'f':
+			xfree(conf_file);
+			conf_file = xstrdup(optarg);
+			break;
+		case (int) 'h':
+			_usage();
+			exit(0);
+			break;
+		case (int) 'N':
+			xfree(node_list);
+			node_list = xstrdup(optarg);
+			break;
+		case (int) 't':
+			thread_count = atoi(optarg);
+			if (thread_count < 1)
+				fatal("Invalid --threads: %s", optarg);
+			break;
+		case (int) 'v':
+			logopt.stderr_level++;
+			log_alter(logopt, 0, NULL);
+			break;
+		case LONG_OPT_NO_SCRIPT_DURATION:
+			script_duration = false;
+			break;
+		default:
+			_usage();
+			exit(1);
+			break;
+		}
+	}
+}
+
+/*
+ * Find the run time of a batch job. A "sleep N" command anywhere in the
+ * script (as written by sreplay or most synthetic workloads) is used as is,
+ * otherwise the --duration setting applies.
+ */
+static uint32_t _job_duration(batch_job_launch_msg_t *req)
+{
+	char *line;
+
+	if (script_duration && (line = req->script)) {
+		while (line && *line) {
+			char *end = NULL;
+			long secs;
+
+			line += strspn(line, " \t");
+			if (!xstrncmp(line, "sleep ", 6)) {
+				secs = strtol(line + 6, &end, 10);
+				if ((end != line + 6) && (secs >= 0))
+					return secs;
+			}
+			if ((line = strchr(line, '\n')))
+				line++;
+		}
+	}
+
+	if (duration_max == duration_min)
+		return duration_min;
+	return duration_min + (random() % (duration_max - duration_min + 1));
+}
+
+static int _find_job_id(void *x, void *key)
+{
+	uint32_t *job_id = x;
+
+	return (*job_id == *(uint32_t *) key);
+}
+
+/* Add a running batch job to a node. Caller must hold emu_mutex. */
+static void _add_job(emu_node_t *node, uint32_t job_id)
+{
+	uint32_t *id = xmalloc(sizeof(*id));
+
+	*id = job_id;
+	list_append(node->jobs, id);
+}
+
+/*
+ * Remove a batch job from a node. Caller must hold emu_mutex.
+ * RET true if the job was running on the node
+ */
+static bool _remove_job(emu_node_t *node, uint32_t job_id)
+{
+	return (list_delete_all(node->jobs, _find_job_id, &job_id) > 0);
+}
+
+static void _send_to_ctld(uint16_t msg_type, void *data)
+{
+	slurm_msg_t req;
+	int rc = SLURM_SUCCESS;
+
+	slurm_msg_t_init(&req);
+	req.msg_type = msg_type;
+	req.data = data;
+
+	if (slurm_send_recv_controller_rc_msg(&req, &rc, NULL) < 0)
+		rc = errno;
+
+	if (rc) {
+		slurm_mutex_lock(&emu_mutex);
+		cnt_send_fail++;
+		slurm_mutex_unlock(&emu_mutex);
+		error("%s: %s failed: %s",
+		      __func__, rpc_num2string(msg_type), slurm_strerror(rc));
+	}
+}
+
+static void _fill_registration_msg(emu_node_t *node,
+				   slurm_node_registration_status_msg_t *msg)
+{
+	config_record_t *config_ptr = node->node_ptr->config_ptr;
+	buf_t *gres_info;
+	list_itr_t *itr;
+	uint32_t *job_id;
+	int i = 0;
+
+	msg->node_name = xstrdup(node->node_ptr->name);
+	msg->hostname = xstrdup(node->node_ptr->node_hostname);
+	msg->version = xstrdup(SLURM_VERSION_STRING);
+	msg->arch = xstrdup(emu_arch);
+	msg->os = xstrdup(emu_os);
+
+	msg->cpus = config_ptr->cpus;
+	msg->boards = config_ptr->boards;
+	msg->sockets = config_ptr->tot_sockets;
+	msg->cores = config_ptr->cores;
+	msg->threads = config_ptr->threads;
+	msg->cpu_spec_list = xstrdup(config_ptr->cpu_spec_list);
+	msg->real_memory = config_ptr->real_memory;
+	msg->tmp_disk = config_ptr->tmp_disk;
+	msg->free_mem = config_ptr->real_memory;
+	msg->hash_val = slurm_conf.hash_val;
+	msg->features_avail = xstrdup(config_ptr->feature);
+	msg->features_active = xstrdup(config_ptr->feature);
+	msg->slurmd_start_time = start_time;
+	msg->up_time = time(NULL) - start_time;
+
+	/* Same layout as gres_node_config_pack() with no GRES configured */
+	gres_info = init_buf(64);
+	pack16(SLURM_PROTOCOL_VERSION, gres_info);
+	pack16(0, gres_info);
+	msg->gres_info = gres_info;
+
+	slurm_mutex_lock(&emu_mutex);
+	msg->job_count = list_count(node->jobs);
+	msg->step_id = xcalloc(msg->job_count, sizeof(*msg->step_id));
+	itr = list_iterator_create(node->jobs);
+	while ((job_id = list_next(itr))) {
+		msg->step_id[i].job_id = *job_id;
+		msg->step_id[i].step_id = SLURM_BATCH_SCRIPT;
+		msg->step_id[i].step_het_comp = NO_VAL;
+		i++;
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&emu_mutex);
+}
+
+static void _register(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	emu_node_t *node = arg;
+	slurm_node_registration_status_msg_t *msg;
+	slurm_msg_t req, resp;
+	int rc;
+
+	if (conmgr_args.status == CONMGR_WORK_STATUS_CANCELLED)
+		return;
+
+	msg = xmalloc(sizeof(*msg));
+	_fill_registration_msg(node, msg);
+
+	slurm_msg_t_init(&req);
+	slurm_msg_t_init(&resp);
+	req.msg_type = MESSAGE_NODE_REGISTRATION_STATUS;
+	req.data = msg;
+
+	rc = slurm_send_recv_controller_msg(&req, &resp, NULL);
+	slurm_free_node_registration_status_msg(msg);
+
+	if (rc < 0) {
+		slurm_mutex_lock(&emu_mutex);
+		cnt_send_fail++;
+		slurm_mutex_unlock(&emu_mutex);
+		error("%s: %s unable to register: %m",
+		      __func__, node->node_ptr->name);
+		return;
+	}
+
+	if (resp.msg_type == RESPONSE_SLURM_RC) {
+		rc = ((return_code_msg_t *) resp.data)->return_code;
+		if (rc)
+			error("%s: %s registration rejected: %s",
+			      __func__, node->node_ptr->name,
+			      slurm_strerror(rc));
+	}
+	slurm_free_msg_data(resp.msg_type, resp.data);
+
+	slurm_mutex_lock(&emu_mutex);
+	cnt_reg++;
+	if (!node->registered) {
+		node->registered = true;
+		debug("%s: %s registered", __func__, node->node_ptr->name);
+	}
+	slurm_mutex_unlock(&emu_mutex);
+}
+
+static void _complete_batch(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	emu_job_t *job = arg;
+	complete_batch_script_msg_t msg = {
+		.job_id = job->job_id,
+		.node_name = job->node->node_ptr->name,
+	};
+	bool running;
+
+	slurm_mutex_lock(&emu_mutex);
+	/* Already gone if slurmctld killed or requeued the job meanwhile */
+	if ((running = _remove_job(job->node, job->job_id)))
+		cnt_complete++;
+	slurm_mutex_unlock(&emu_mutex);
+
+	if (running && (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED)) {
+		debug("%s: JobId=%u on %s", __func__, job->job_id,
+		      job->node->node_ptr->name);
+		_send_to_ctld(REQUEST_COMPLETE_BATCH_SCRIPT, &msg);
+	}
+
+	xfree(job);
+}
+
+static void _epilog_complete(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	emu_job_t *job = arg;
+	epilog_complete_msg_t msg = {
+		.job_id = job->job_id,
+		.node_name = job->node->node_ptr->name,
+	};
+
+	if (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED)
+		_send_to_ctld(MESSAGE_EPILOG_COMPLETE, &msg);
+
+	xfree(job);
+}
+
+static void _prolog_complete(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	emu_job_t *job = arg;
+	complete_prolog_msg_t msg = {
+		.job_id = job->job_id,
+		.node_name = job->node->node_ptr->name,
+	};
+
+	if (conmgr_args.status != CONMGR_WORK_STATUS_CANCELLED)
+		_send_to_ctld(REQUEST_COMPLETE_PROLOG, &msg);
+
+	xfree(job);
+}
+
+static emu_job_t *_new_job(emu_node_t *node, uint32_t job_id)
+{
+	emu_job_t *job = xmalloc(sizeof(*job));
+
+	job->node = node;
+	job->job_id = job_id;
+
+	return job;
+}
+
+static int _reply_rc(conmgr_fd_t *con, slurm_msg_t *msg, int rc)
+{
+	slurm_msg_t resp_msg;
+	return_code_msg_t rc_msg = {
+		.return_code = rc,
+	};
+
+	response_init(&resp_msg, msg, RESPONSE_SLURM_RC, &rc_msg);
+
+	return conmgr_queue_write_msg(con, &resp_msg);
+}
+
+static int _reply_ping(conmgr_fd_t *con, slurm_msg_t *msg, emu_node_t *node)
+{
+	slurm_msg_t resp_msg;
+	ping_slurmd_resp_msg_t ping_resp = {
+		.free_mem = node->node_ptr->config_ptr->real_memory,
+	};
+
+	response_init(&resp_msg, msg, RESPONSE_PING_SLURMD, &ping_resp);
+
+	return conmgr_queue_write_msg(con, &resp_msg);
+}
+
+static int _reply_acct_gather(conmgr_fd_t *con, slurm_msg_t *msg,
+			      emu_node_t *node)
+{
+	slurm_msg_t resp_msg;
+	acct_gather_node_resp_msg_t acct_msg = {
+		.node_name = node->node_ptr->name,
+		.sensor_cnt = 1,
+	};
+	int rc;
+
+	acct_msg.energy = acct_gather_energy_alloc(acct_msg.sensor_cnt);
+	response_init(&resp_msg, msg, RESPONSE_ACCT_GATHER_UPDATE, &acct_msg);
+	rc = conmgr_queue_write_msg(con, &resp_msg);
+	acct_gather_energy_destroy(acct_msg.energy);
+
+	return rc;
+}
+
+static int _on_batch_launch(conmgr_fd_t *con, slurm_msg_t *msg,
+			    emu_node_t *node)
+{
+	batch_job_launch_msg_t *req = msg->data;
+	uint32_t duration = _job_duration(req);
+	int rc;
+
+	slurm_mutex_lock(&emu_mutex);
+	_add_job(node, req->job_id);
+	cnt_launch++;
+	slurm_mutex_unlock(&emu_mutex);
+
+	rc = _reply_rc(con, msg, SLURM_SUCCESS);
+
+	debug("%s: JobId=%u on %s for %u seconds",
+	      __func__, req->job_id, node->node_ptr->name, duration);
+	conmgr_add_work_delayed_fifo(_complete_batch,
+				     _new_job(node, req->job_id), duration, 0);
+
+	return rc;
+}
+
+static int _on_terminate(conmgr_fd_t *con, slurm_msg_t *msg, emu_node_t *node)
+{
+	kill_job_msg_t *req = msg->data;
+	int rc;
+
+	slurm_mutex_lock(&emu_mutex);
+	(void) _remove_job(node, req->step_id.job_id);
+	if (msg->msg_type != REQUEST_ABORT_JOB)
+		cnt_epilog++;
+	slurm_mutex_unlock(&emu_mutex);
+
+	rc = _reply_rc(con, msg, SLURM_SUCCESS);
+
+	/* slurmd does not run the epilog for an aborted job */
+	if (msg->msg_type != REQUEST_ABORT_JOB)
+		conmgr_add_work_fifo(_epilog_complete,
+				     _new_job(node, req->step_id.job_id));
+
+	return rc;
+}
+
+static int _on_msg(conmgr_fd_t *con, slurm_msg_t *msg, void *arg)
+{
+	emu_node_t *node = arg;
+	int rc = SLURM_SUCCESS;
+
+	if (!msg->auth_ids_set) {
+		error("%s: [%s] rejecting %s RPC with missing user auth",
+		      __func__, conmgr_fd_get_name(con),
+		      rpc_num2string(msg->msg_type));
+		slurm_free_msg(msg);
+		return SLURM_PROTOCOL_AUTHENTICATION_ERROR;
+	} else if (!validate_slurm_user(msg->auth_uid)) {
+		error("%s: [%s] rejecting %s RPC from uid %u",
+		      __func__, conmgr_fd_get_name(con),
+		      rpc_num2string(msg->msg_type), msg->auth_uid);
+		rc = _reply_rc(con, msg, ESLURM_USER_ID_MISSING);
+		goto done;
+	}
+
+	slurm_mutex_lock(&emu_mutex);
+	cnt_rpc++;
+	if (msg->forward.cnt && !forward_warned) {
+		forward_warned = true;
+		error("%s: %s: message forwarding is not emulated, set TreeWidth to at least the number of nodes",
+		      __func__, node->node_ptr->name);
+	}
+	slurm_mutex_unlock(&emu_mutex);
+
+	log_flag(PROTOCOL, "%s: %s: %s",
+		 __func__, node->node_ptr->name,
+		 rpc_num2string(msg->msg_type));
+
+	switch (msg->msg_type) {
+	case REQUEST_PING:
+		rc = _reply_ping(con, msg, node);
+		break;
+	case REQUEST_NODE_REGISTRATION_STATUS:
+		rc = _reply_ping(con, msg, node);
+		conmgr_add_work_fifo(_register, node);
+		break;
+	case REQUEST_HEALTH_CHECK:
+	case REQUEST_SIGNAL_TASKS:
+		rc = _reply_rc(con, msg, SLURM_SUCCESS);
+		break;
+	case REQUEST_ACCT_GATHER_UPDATE:
+		rc = _reply_acct_gather(con, msg, node);
+		break;
+	case REQUEST_BATCH_JOB_LAUNCH:
+		rc = _on_batch_launch(con, msg, node);
+		break;
+	case REQUEST_LAUNCH_PROLOG:
+	{
+		prolog_launch_msg_t *req = msg->data;
+
+		rc = _reply_rc(con, msg, SLURM_SUCCESS);
+		conmgr_add_work_fifo(_prolog_complete,
+				     _new_job(node, req->job_id));
+		break;
+	}
+	case REQUEST_TERMINATE_JOB:
+	case REQUEST_KILL_PREEMPTED:
+	case REQUEST_KILL_TIMELIMIT:
+	case REQUEST_ABORT_JOB:
+		rc = _on_terminate(con, msg, node);
+		break;
+	case REQUEST_REBOOT_NODES:
+	case REQUEST_RECONFIGURE:
+	case REQUEST_RECONFIGURE_WITH_CONFIG:
+		/* slurmctld does not expect a reply */
+		break;
+	case REQUEST_SHUTDOWN:
+		info("shutdown requested by slurmctld");
+		conmgr_request_shutdown();
+		break;
+	default:
+		debug("%s: %s: %s is not emulated",
+		      __func__, node->node_ptr->name,
+		      rpc_num2string(msg->msg_type));
+		rc = _reply_rc(con, msg, ESLURM_NOT_SUPPORTED);
+		break;
+	}
+
+done:
+	slurm_free_msg(msg);
+	conmgr_queue_close_fd(con);
+	return rc;
+}
+
+static void *_on_connection(conmgr_fd_t *con, void *arg)
+{
+	return arg;
+}
+
+static void _print_stats(void)
+{
+	int registered = 0;
+
+	slurm_mutex_lock(&emu_mutex);
+	for (int i = 0; i < emu_node_cnt; i++)
+		if (emu_nodes[i].registered)
+			registered++;
+	info("nodes:%d registered:%d rpcs:%"PRIu64" registrations:%"PRIu64" launches:%"PRIu64" completions:%"PRIu64" epilogs:%"PRIu64" send_failures:%"PRIu64,
+	     emu_node_cnt, registered, cnt_rpc, cnt_reg, cnt_launch,
+	     cnt_complete, cnt_epilog, cnt_send_fail);
+	slurm_mutex_unlock(&emu_mutex);
+}
+
+static void _on_sigint(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	info("Caught SIGINT. Shutting down.");
+	conmgr_request_shutdown();
+}
+
+static void _on_sigusr1(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	_print_stats();
+}
+
+static void _on_sigpipe(conmgr_callback_args_t conmgr_args, void *arg)
+{
+	info("Caught SIGPIPE. Ignoring.");
+}
+
+static void _init_nodes(void)
+{
+	hostlist_t *hl = NULL;
+	node_record_t *node_ptr;
+
+	if (node_list && !(hl = hostlist_create(node_list)))
+		fatal("Invalid --nodes: %s", node_list);
+
+	emu_nodes = xcalloc(node_record_count, sizeof(*emu_nodes));
+	for (int i = 0; (node_ptr = next_node(&i)); i++) {
+		if (hl && (hostlist_find(hl, node_ptr->name) < 0))
+			continue;
+		emu_nodes[emu_node_cnt].node_ptr = node_ptr;
+		emu_nodes[emu_node_cnt].jobs = list_create(xfree_ptr);
+		emu_node_cnt++;
+	}
+	FREE_NULL_HOSTLIST(hl);
+
+	if (!emu_node_cnt)
+		fatal("No nodes to emulate");
+	if (slurm_conf.tree_width < emu_node_cnt)
+		warning("TreeWidth=%u is lower than the %d emulated nodes, forwarded messages will fail",
+			slurm_conf.tree_width, emu_node_cnt);
+}
+
+static void _listen_nodes(void)
+{
+	conmgr_events_t events = {
+		.on_connection = _on_connection,
+		.on_msg = _on_msg,
+	};
+
+	for (int i = 0; i < emu_node_cnt; i++) {
+		emu_node_t *node = &emu_nodes[i];
+		int fd, rc;
+
+		if ((fd = slurm_init_msg_engine_port(node->node_ptr->port)) < 0)
+			fatal("%s: %s: unable to listen on port %u, every emulated node on a host needs its own Port: %m",
+			      __func__, node->node_ptr->name,
+			      node->node_ptr->port);
+
+		if ((rc = conmgr_process_fd_listen(fd, CON_TYPE_RPC, events,
+						   NULL, 0, node)))
+			fatal("%s: conmgr refused fd=%d: %s",
+			      __func__, fd, slurm_strerror(rc));
+	}
+}
+
+extern int main(int argc, char **argv)
+{
+	conmgr_callbacks_t callbacks = {NULL, NULL};
+	struct utsname buf;
+
+	_parse_args(argc, argv);
+
+	slurm_conf_init(conf_file);
+	init_node_conf();
+	if (gres_init() != SLURM_SUCCESS)
+		fatal("gres_init() failed");
+	build_all_nodeline_info(true, 0);
+
+	if (auth_g_init())
+		fatal("auth_g_init() failed");
+	if (hash_g_init())
+		fatal("hash_g_init() failed");
+	if (cred_g_init())
+		fatal("cred_g_init() failed");
+
+	if (getuid() != slurm_conf.slurm_user_id) {
+		char *user = uid_to_string(getuid());
+		warning("slurmd_emu running as %s instead of SlurmUser(%s)",
+			user, slurm_conf.slurm_user_name);
+		xfree(user);
+	}
+
+	_init_nodes();
+
+	uname(&buf);
+	emu_arch = xstrdup(buf.machine);
+	xstrfmtcat(emu_os, "%s %s %s", buf.sysname, buf.release, buf.version);
+	start_time = time(NULL);
+	srandom(getpid());
+
+	/* Each emulated node holds a listening socket plus its connections */
+	rlimits_use_max_nofile();
+	conmgr_init(thread_count, (emu_node_cnt * 2), callbacks);
+
+	conmgr_add_work_signal(SIGINT, _on_sigint, NULL);
+	conmgr_add_work_signal(SIGTERM, _on_sigint, NULL);
+	conmgr_add_work_signal(SIGUSR1, _on_sigusr1, NULL);
+	conmgr_add_work_signal(SIGPIPE, _on_sigpipe, NULL);
+
+	_listen_nodes();
+
+	/* Register every node once, as a freshly started slurmd would */
+	for (int i = 0; i < emu_node_cnt; i++)
+		conmgr_add_work_fifo(_register, &emu_nodes[i]);
+
+	info("emulating %d nodes", emu_node_cnt);
+	conmgr_run(true);
+	_print_stats();
+
+	conmgr_fini();
+
+	for (int i = 0; i < emu_node_cnt; i++)
+		FREE_NULL_LIST(emu_nodes[i].jobs);
+	xfree(emu_nodes);
+	xfree(emu_arch);
+	xfree(emu_os);
+	xfree(conf_file);
+	xfree(node_list);
+	return 0;
+}
@@ -1039,6 +1039,11 @@ enum node_states {
 #define SHOW_FEDERATION	0x0040	/* Show federated state information.
 				 * Shows local info if not in federation */
 #define SHOW_FUTURE	0x0080	/* Show future nodes */
+#define SHOW_DELTA	0x0100	/* Only send jobs changed since update_time,
+				 * see slurm_load_jobs_delta() */
+#define SHOW_ACTIVE	0x0200	/* Omit jobs that have finished, i.e. send
+				 * only pending, running, suspended, stage out
+				 * and completing jobs */
 
 /* CR_CPU, CR_SOCKET and CR_CORE are mutually exclusive
  * CR_MEMORY may be added to any of the above values or used by itself
@@ -1650,6 +1655,9 @@ typedef struct job_descriptor {	/* For submit, allocate, and update requests */
 	uint32_t job_id;	/* job ID, default set by Slurm */
 	char * job_id_str;      /* string representation of the jobid */
 	char *job_size_str;
+	uint16_t job_submit_done; /* count of job_submit plugins already run
+				   * without locks, used internally in the
+				   * slurmctld, DON'T PACK */
 	uint16_t kill_on_node_fail; /* 1 if node failure to kill job,
 				     * 0 otherwise,default=1 */
 	char *licenses;		/* licenses required by the job */
@@ -1971,6 +1979,10 @@ typedef struct job_info_msg {
 	time_t last_update;	/* time of latest info */
 	uint32_t record_count;	/* number of records */
 	slurm_job_info_t *job_array;	/* the job records */
+	bool delta;		/* SHOW_DELTA response, job_array only holds
+				 * jobs changed since the requested time */
+	uint32_t job_id_cnt;	/* number of job_ids */
+	uint32_t *job_ids;	/* with delta, IDs of all jobs reported */
 } job_info_msg_t;
 
 typedef struct {
@@ -2883,6 +2895,7 @@ typedef struct reservation_name_msg {
 #define CONF_FLAG_SHR		SLURM_BIT(14) /* SlurmdParameters=shutdown_on_reboot */
 #define CONF_FLAG_CONTAIN_SPANK SLURM_BIT(15) /* SlurmdParameters=contain_spank */
 #define CONF_FLAG_NO_STDIO	SLURM_BIT(16) /* AccountingStoreFlags=no_stdio */
+#define CONF_FLAG_PUSH_HB	SLURM_BIT(17) /* SlurmdParameters=push_heartbeat */
 
 #define LOG_FMT_ISO8601_MS      0
 #define LOG_FMT_ISO8601         1
@@ -3193,6 +3206,13 @@ typedef struct submit_response_msg {
 	char *job_submit_user_msg; /* job submit plugin user_msg */
 } submit_response_msg_t;
 
+typedef struct submit_jobs_response_msg {
+	uint32_t job_cnt;	/* number of elements in the arrays below */
+	uint32_t *error_code;	/* per job error or warning code */
+	uint32_t *job_id;	/* per job ID, 0 if the job was rejected */
+	char **job_submit_user_msg; /* per job submit plugin user_msg */
+} submit_jobs_response_msg_t;
+
 /* NOTE: If setting node_addr and/or node_hostname then comma separate names
  * and include an equal number of node_names */
 typedef struct slurm_update_node_msg {
@@ -3322,6 +3342,49 @@ typedef struct stats_info_response_msg {
 	uint32_t rpc_dump_count;
 	uint32_t *rpc_dump_types;
 	char **rpc_dump_hostlist;
+
+	uint8_t lock_stats_enabled;
+	uint32_t lock_stats_cnt;	/* read and write of each lock type */
+	uint32_t *lock_cnt;
+	uint64_t *lock_wait_time;	/* usec */
+	uint64_t *lock_wait_max;	/* usec */
+	uint64_t *lock_hold_time;	/* usec */
+	uint64_t *lock_hold_max;	/* usec */
+	uint32_t lock_wait_hist_cnt;	/* buckets per lock_stats_cnt */
+	uint32_t *lock_wait_hist;
+
+	uint32_t lock_caller_size;
+	char **lock_caller_name;
+	uint32_t *lock_caller_cnt;
+	uint64_t *lock_caller_wait_time;	/* usec */
+	uint64_t *lock_caller_wait_max;	/* usec */
+	uint64_t *lock_caller_hold_time;	/* usec */
+
+	uint64_t bitmap_cache_hits;
+	uint64_t bitmap_cache_misses;
+
+	uint32_t fair_tree_cycle_counter;
+	uint32_t fair_tree_cycle_last;	/* usec */
+	uint32_t fair_tree_cycle_max;	/* usec */
+	uint64_t fair_tree_cycle_sum;	/* usec */
+
+	uint32_t xmalloc_stats_cnt;
+	char **xmalloc_stats_name;
+	uint64_t *xmalloc_stats_allocs;
+	uint64_t *xmalloc_stats_frees;
+	uint64_t *xmalloc_stats_bytes;
+
+	uint32_t rpc_hist_cnt;		/* log2 usec buckets per RPC type/user */
+	uint32_t *rpc_type_hist;
+	uint32_t *rpc_user_hist;
+
+	uint32_t plugin_stats_cnt;
+	char **plugin_stats_name;	/* plugin type */
+	char **plugin_stats_op;		/* dispatch function */
+	uint32_t *plugin_stats_calls;
+	uint64_t *plugin_stats_time;	/* usec */
+	uint64_t *plugin_stats_max;	/* usec */
+	uint32_t *plugin_stats_hist;	/* rpc_hist_cnt buckets per op */
 } stats_info_response_msg_t;
 
 #define TRIGGER_FLAG_PERM		0x0001
@@ -3615,6 +3678,26 @@ extern int slurm_submit_batch_job(job_desc_msg_t *job_desc_msg,
 extern int slurm_submit_batch_het_job(list_t *job_req_list,
 				      submit_response_msg_t **slurm_alloc_msg);
 
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit many independent jobs for
+ *			     later execution. The controller creates all of
+ *			     them under a single lock acquisition.
+ * NOTE: free the response using slurm_free_submit_jobs_response_msg
+ * IN job_req_list - list of batch job requests, type job_desc_msg_t
+ * OUT resp - per job results, in the order of job_req_list
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list,
+				   submit_jobs_response_msg_t **resp);
+
+/*
+ * slurm_free_submit_jobs_response_msg - free the response of
+ *	slurm_submit_batch_jobs
+ * IN msg - pointer to job submit response message
+ */
+extern void slurm_free_submit_jobs_response_msg(
+	submit_jobs_response_msg_t *msg);
+
 /*
  * slurm_free_submit_response_response_msg - free slurm
  *	job submit response message
@@ -4182,6 +4265,20 @@ extern int slurm_load_jobs(time_t update_time,
 			   job_info_msg_t **job_info_msg_pptr,
 			   uint16_t show_flags);
 
+/*
+ * slurm_load_jobs_delta - update job information previously loaded with
+ *	slurm_load_jobs() or slurm_load_jobs_delta(), only transferring the
+ *	records of jobs that changed
+ * IN/OUT job_info_msg_pptr - current job information, replaced on success.
+ *	If *job_info_msg_pptr is NULL all job information is loaded.
+ * IN show_flags - job filtering options, same as used for *job_info_msg_pptr
+ * RET 0 or -1 on error, errno is SLURM_NO_CHANGE_IN_DATA if
+ *	*job_info_msg_pptr is still current
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_jobs_delta(job_info_msg_t **job_info_msg_pptr,
+				 uint16_t show_flags);
+
 /*
  * slurm_load_job_state - issue RPC to get state of requested jobs
  * IN job_id_count - number of jobs in job_ids pointer.
@@ -4932,6 +5029,13 @@ extern int slurm_set_debug_level(uint32_t debug_level);
  */
 extern int slurm_set_schedlog_level(uint32_t schedlog_level);
 
+/*
+ * slurm_sched_trace_dump - issue RPC to have slurmctld write its scheduler
+ *	trace to the file "sched_trace" in StateSaveLocation
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_sched_trace_dump(void);
+
 /*
  * slurm_set_fs_dampeningfactor - issue RPC to set slurm fs dampening factor
  * IN factor - requested fs dampening factor
@@ -1398,7 +1398,7 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	    cluster_in_federation(ptr, cluster_name)) {
 		/* In federation. Need full info from all clusters */
 		update_time = (time_t) 0;
-		show_flags &= (~SHOW_LOCAL);
+		show_flags &= ~(SHOW_LOCAL | SHOW_DELTA);
 	} else {
 		/* Report local cluster info only */
 		show_flags |= SHOW_LOCAL;
@@ -1427,6 +1427,126 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	return rc;
 }
 
+static int _sort_job_by_id(const void *x, const void *y)
+{
+	const slurm_job_info_t *j1 = x, *j2 = y;
+
+	if (j1->job_id < j2->job_id)
+		return -1;
+	if (j1->job_id > j2->job_id)
+		return 1;
+	return 0;
+}
+
+/*
+ * Build complete job information from old_msg and the changed records in
+ * delta_msg, moving records out of both messages.
+ * RET merged message or NULL if delta_msg references an unknown job
+ */
+static job_info_msg_t *_merge_job_delta(job_info_msg_t *old_msg,
+					job_info_msg_t *delta_msg)
+{
+	job_info_msg_t *new_msg;
+	slurm_job_info_t key = { 0 }, *job, **jobs;
+
+	qsort(old_msg->job_array, old_msg->record_count,
+	      sizeof(slurm_job_info_t), _sort_job_by_id);
+	qsort(delta_msg->job_array, delta_msg->record_count,
+	      sizeof(slurm_job_info_t), _sort_job_by_id);
+
+	jobs = xcalloc(delta_msg->job_id_cnt + 1, sizeof(*jobs));
+	for (int i = 0; i < delta_msg->job_id_cnt; i++) {
+		key.job_id = delta_msg->job_ids[i];
+		if (!(jobs[i] = bsearch(&key, delta_msg->job_array,
+					delta_msg->record_count,
+					sizeof(slurm_job_info_t),
+					_sort_job_by_id)) &&
+		    !(jobs[i] = bsearch(&key, old_msg->job_array,
+					old_msg->record_count,
+					sizeof(slurm_job_info_t),
+					_sort_job_by_id))) {
+			xfree(jobs);
+			return NULL;
+		}
+	}
+
+	new_msg = xmalloc(sizeof(*new_msg));
+	new_msg->last_backfill = delta_msg->last_backfill;
+	new_msg->last_update = delta_msg->last_update;
+	if (delta_msg->job_id_cnt)
+		new_msg->job_array = xcalloc(delta_msg->job_id_cnt,
+					     sizeof(slurm_job_info_t));
+
+	for (int i = 0; i < delta_msg->job_id_cnt; i++) {
+		job = jobs[i];
+		if ((job >= old_msg->job_array) &&
+		    (job < (old_msg->job_array + old_msg->record_count))) {
+			job->bitflags &= ~BACKFILL_LAST;
+			if ((job->bitflags & BACKFILL_SCHED) &&
+			    new_msg->last_backfill && IS_JOB_PENDING(job) &&
+			    (new_msg->last_backfill <= job->last_sched_eval))
+				job->bitflags |= BACKFILL_LAST;
+		}
+		new_msg->job_array[new_msg->record_count++] = *job;
+		memset(job, 0, sizeof(*job));
+	}
+	xfree(jobs);
+
+	return new_msg;
+}
+
+/*
+ * slurm_load_jobs_delta - update job information previously loaded with
+ *	slurm_load_jobs() or slurm_load_jobs_delta(), only transferring the
+ *	records of jobs that changed
+ * IN/OUT job_info_msg_pptr - current job information, replaced on success.
+ *	If *job_info_msg_pptr is NULL all job information is loaded.
+ * IN show_flags - job filtering options, same as used for *job_info_msg_pptr
+ * RET 0 or -1 on error, errno is SLURM_NO_CHANGE_IN_DATA if
+ *	*job_info_msg_pptr is still current
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_jobs_delta(job_info_msg_t **job_info_msg_pptr,
+				 uint16_t show_flags)
+{
+	job_info_msg_t *old_msg = *job_info_msg_pptr, *new_msg = NULL;
+	job_info_msg_t *merged_msg;
+	int rc;
+
+	if (!old_msg)
+		return slurm_load_jobs(0, job_info_msg_pptr, show_flags);
+
+	/*
+	 * slurm_load_jobs() drops update_time when merging information from
+	 * other clusters of a federation, which then returns full responses.
+	 */
+	if ((rc = slurm_load_jobs(old_msg->last_update, &new_msg,
+				  (show_flags | SHOW_DELTA))))
+		return rc;
+
+	if (!new_msg->delta) {
+		/* Full response, e.g. from an older slurmctld */
+		slurm_free_job_info_msg(old_msg);
+		*job_info_msg_pptr = new_msg;
+		return SLURM_SUCCESS;
+	}
+
+	if (!(merged_msg = _merge_job_delta(old_msg, new_msg))) {
+		slurm_free_job_info_msg(new_msg);
+		new_msg = NULL;
+		if ((rc = slurm_load_jobs(0, &new_msg, show_flags)))
+			return rc;
+		merged_msg = new_msg;
+		new_msg = NULL;
+	}
+
+	slurm_free_job_info_msg(old_msg);
+	slurm_free_job_info_msg(new_msg);
+	*job_info_msg_pptr = merged_msg;
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -43,8 +43,36 @@
 #include "slurm/slurmdb.h"
 
 #include "src/interfaces/accounting_storage.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
+/*
+ * Jobs sharing a cluster, account, wckey and lineage always land in the same
+ * grouping, so remember where the last such job went instead of searching
+ * every cluster and account grouping again for each job.
+ */
+typedef struct {
+	char *key;
+	slurmdb_report_cluster_grouping_t *cluster_group;
+	slurmdb_report_acct_grouping_t *acct_group; /* NULL to skip job */
+} group_match_t;
+
+static void _group_match_id(void *item, const char **key, uint32_t *key_len)
+{
+	group_match_t *match = item;
+
+	*key = match->key;
+	*key_len = strlen(match->key);
+}
+
+static void _group_match_free(void *item)
+{
+	group_match_t *match = item;
+
+	xfree(match->key);
+	xfree(match);
+}
+
 static int _sort_group_asc(void *v1, void *v2)
 {
 	char *group_a = *(char **)v1;
@@ -155,6 +183,7 @@ static List _process_grouped_report(
 	List object_list = NULL, object2_list = NULL;
 
 	List tmp_acct_list = NULL;
+	xhash_t *match_hash = NULL;
 	bool destroy_job_cond = 0;
 	bool destroy_grouping_list = 0;
 	bool individual = 0;
@@ -343,11 +372,15 @@ static List _process_grouped_report(
 		list_iterator_destroy(itr2);
 
 no_objects:
+	match_hash = xhash_init(_group_match_id, _group_match_free);
 	itr = list_iterator_create(job_list);
 
 	while((job = list_next(itr))) {
 		char *local_cluster = "UNKNOWN";
 		char tmp_acct[200];
+		group_match_t *match;
+		char *key = NULL;
+		uint64_t count;
 
 		if (!job->elapsed) {
 			/* here we don't care about jobs that didn't
@@ -379,6 +412,20 @@ no_objects:
 			}
 		}
 
+		xstrfmtcat(key, "%s\n%s\n%s\n%s", local_cluster, tmp_acct,
+			   (job->lineage ? job->lineage : ""),
+			   (job->wckey ? job->wckey : ""));
+		if ((match = xhash_get_str(match_hash, key))) {
+			xfree(key);
+			if (!(acct_group = match->acct_group))
+				continue;
+			cluster_group = match->cluster_group;
+			goto add_job;
+		}
+		match = xmalloc(sizeof(*match));
+		match->key = key;
+		xhash_add(match_hash, match);
+
 		list_iterator_reset(cluster_itr);
 		while((cluster_group = list_next(cluster_itr))) {
 			if (!xstrcmp(local_cluster, cluster_group->cluster))
@@ -476,14 +523,17 @@ no_objects:
 			list_iterator_reset(group_itr);
 		}
 
+		match->cluster_group = cluster_group;
+		match->acct_group = acct_group;
+
+add_job:
+		if ((count = slurmdb_find_tres_count_in_string(
+			     job->tres_alloc_str, tres_id)) == INFINITE64)
+			continue;
+
 		local_itr = list_iterator_create(acct_group->groups);
 		while ((job_group = list_next(local_itr))) {
-			uint64_t count;
-
-			if (((count = slurmdb_find_tres_count_in_string(
-				      job->tres_alloc_str, tres_id))
-			     == INFINITE64) ||
-			    (count < job_group->min_size) ||
+			if ((count < job_group->min_size) ||
 			    (count > job_group->max_size))
 				continue;
 
@@ -525,6 +575,7 @@ no_objects:
 	list_iterator_destroy(cluster_itr);
 
 end_it:
+	xhash_free_ptr(&match_hash);
 	FREE_NULL_LIST(object_list);
 
 	FREE_NULL_LIST(object2_list);
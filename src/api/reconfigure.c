@@ -416,6 +416,29 @@ slurm_set_schedlog_level (uint32_t schedlog_level)
         return SLURM_SUCCESS;
 }
 
+/*
+ * slurm_sched_trace_dump - issue RPC to have slurmctld write its scheduler
+ *	trace to the file "sched_trace" in StateSaveLocation
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_sched_trace_dump(void)
+{
+	int rc;
+	slurm_msg_t req_msg;
+
+	slurm_msg_t_init(&req_msg);
+	req_msg.msg_type = REQUEST_SCHED_TRACE_DUMP;
+
+	if (slurm_send_recv_controller_rc_msg(&req_msg, &rc,
+					      working_cluster_rec) < 0)
+		return SLURM_ERROR;
+
+	if (rc)
+		slurm_seterrno_ret(rc);
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * slurm_set_fs_dampeningfactor - issue RPC to set fs dampening factor
  * IN factor  - requested fs dampening factor
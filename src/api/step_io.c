@@ -61,6 +61,13 @@
 
 #define STDIO_MAX_FREE_BUF 1024
 
+/*
+ * Max number of messages handled for one server connection or output file
+ * per eio loop iteration. Handling a single message per poll() of every
+ * connection made large steps' output throughput depend on their node count.
+ */
+#define STDIO_MAX_MSG_BATCH 32
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -283,7 +290,7 @@ _server_readable(eio_obj_t *obj)
 }
 
 static int
-_server_read(eio_obj_t *obj, List objs)
+_server_read_msg(eio_obj_t *obj)
 {
 	struct server_io_info *s = (struct server_io_info *) obj->arg;
 	void *buf;
@@ -435,6 +442,31 @@ _server_read(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+/* Return true if fd has data to read right now */
+static bool _fd_has_input(int fd)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+	return ((poll(&pfd, 1, 0) == 1) && (pfd.revents & POLLIN));
+}
+
+static int
+_server_read(eio_obj_t *obj, List objs)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+	int rc, cnt = 0;
+
+	/* Read the messages already received, up to STDIO_MAX_MSG_BATCH */
+	do {
+		rc = _server_read_msg(obj);
+	} while ((rc == SLURM_SUCCESS) && (++cnt < STDIO_MAX_MSG_BATCH) &&
+		 !s->in_msg && (obj->fd >= 0) && !obj->shutdown &&
+		 !s->in_eof && _outgoing_buf_free(s->cio) &&
+		 _fd_has_input(obj->fd));
+
+	return rc;
+}
+
 static bool
 _server_writable(eio_obj_t *obj)
 {
@@ -567,7 +599,7 @@ static bool _file_writable(eio_obj_t *obj)
 	return false;
 }
 
-static int _file_write(eio_obj_t *obj, List objs)
+static int _file_write_msg(eio_obj_t *obj)
 {
 	struct file_write_info *info = (struct file_write_info *) obj->arg;
 	void *ptr;
@@ -626,6 +658,20 @@ static int _file_write(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+static int _file_write(eio_obj_t *obj, List objs)
+{
+	struct file_write_info *info = (struct file_write_info *) obj->arg;
+	int rc, cnt = 0;
+
+	/* Write the queued messages, up to STDIO_MAX_MSG_BATCH */
+	do {
+		rc = _file_write_msg(obj);
+	} while ((rc == SLURM_SUCCESS) && (++cnt < STDIO_MAX_MSG_BATCH) &&
+		 !info->out_msg && !list_is_empty(info->msg_queue));
+
+	return rc;
+}
+
 /**********************************************************************
  * File read functions
  **********************************************************************/
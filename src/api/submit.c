@@ -155,3 +155,100 @@ extern int slurm_submit_batch_het_job(List job_req_list,
 
 	return SLURM_SUCCESS;
 }
+
+/* Submit at most SUBMIT_BATCH_JOBS_MAX jobs, appending the results to resp */
+static int _submit_batch_jobs(list_t *job_req_list,
+			      submit_jobs_response_msg_t *resp)
+{
+	int rc;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	submit_jobs_response_msg_t *part;
+	uint32_t cnt;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	req_msg.msg_type = REQUEST_SUBMIT_BATCH_JOBS;
+	req_msg.data     = job_req_list;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					    working_cluster_rec);
+	if (rc == SLURM_ERROR)
+		return SLURM_ERROR;
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		part = resp_msg.data;
+		cnt = resp->job_cnt + part->job_cnt;
+		xrecalloc(resp->job_id, cnt, sizeof(uint32_t));
+		xrecalloc(resp->error_code, cnt, sizeof(uint32_t));
+		xrecalloc(resp->job_submit_user_msg, cnt, sizeof(char *));
+		for (int i = 0; i < part->job_cnt; i++) {
+			resp->job_id[resp->job_cnt] = part->job_id[i];
+			resp->error_code[resp->job_cnt] = part->error_code[i];
+			resp->job_submit_user_msg[resp->job_cnt] =
+				part->job_submit_user_msg[i];
+			part->job_submit_user_msg[i] = NULL;
+			resp->job_cnt++;
+		}
+		slurm_free_submit_jobs_response_msg(part);
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit many independent jobs for
+ *			     later execution
+ * NOTE: free the response using slurm_free_submit_jobs_response_msg
+ * IN job_req_list - List of batch job requests, type job_desc_msg_t
+ * OUT resp - per job results, in the order of job_req_list
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list,
+				   submit_jobs_response_msg_t **resp)
+{
+	int rc = SLURM_SUCCESS;
+	job_desc_msg_t *req;
+	list_t *batch_list;
+	list_itr_t *iter;
+
+	*resp = xmalloc(sizeof(submit_jobs_response_msg_t));
+
+	/*
+	 * Send the requests in messages of at most SUBMIT_BATCH_JOBS_MAX
+	 * jobs, so one message never holds the controller's locks for long
+	 */
+	batch_list = list_create(NULL);
+	iter = list_iterator_create(job_req_list);
+	while ((req = list_next(iter))) {
+		if (req->alloc_sid == NO_VAL)
+			req->alloc_sid = getsid(0);
+		list_append(batch_list, req);
+		if (list_count(batch_list) < SUBMIT_BATCH_JOBS_MAX)
+			continue;
+		if ((rc = _submit_batch_jobs(batch_list, *resp)))
+			break;
+		list_flush(batch_list);
+	}
+	list_iterator_destroy(iter);
+	if (!rc && list_count(batch_list))
+		rc = _submit_batch_jobs(batch_list, *resp);
+	FREE_NULL_LIST(batch_list);
+
+	if (rc && !(*resp)->job_cnt) {
+		slurm_free_submit_jobs_response_msg(*resp);
+		*resp = NULL;
+	}
+
+	return rc;
+}
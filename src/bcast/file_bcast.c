@@ -71,6 +71,8 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+#include "src/interfaces/hash.h"
+
 #include "file_bcast.h"
 
 /*
@@ -88,6 +90,26 @@ void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
+typedef struct {
+	file_bcast_msg_t *bcast_msg;	/* fields shared by every block */
+	uint32_t block_cnt;		/* blocks in the file */
+	pthread_mutex_t mutex;		/* protects fields below */
+	uint32_t next_block;		/* next block_no to send */
+	struct bcast_parameters *params;
+	int rc;				/* first failure, if any */
+	uint64_t size_compressed;
+	uint64_t size_uncompressed;
+	uint32_t time_compression;
+} bcast_pipeline_t;
+
+typedef struct {
+	file_bcast_msg_t bcast_msg;	/* by hash, with peer_nodes set */
+	struct bcast_parameters *params;
+	char *peer;			/* node asked to send the block */
+	int rc;
+	pthread_t tid;
+} peer_send_t;
+
 static int   _bcast_file(struct bcast_parameters *params);
 static int   _file_bcast(struct bcast_parameters *params,
 			 file_bcast_msg_t *bcast_msg,
@@ -163,10 +185,15 @@ static int _get_job_info(struct bcast_parameters *params)
 	return rc;
 }
 
-/* Issue the RPC to transfer the file's data */
-static int _file_bcast(struct bcast_parameters *params,
-		       file_bcast_msg_t *bcast_msg,
-		       job_sbcast_cred_msg_t *sbcast_cred)
+/*
+ * Issue the RPC to transfer the file's data to node_list. If missing is set,
+ * nodes answering ESLURMD_BCAST_BLOCK_MISSING are added to it instead of
+ * being treated as failures. If hits is set, nodes that succeeded are added
+ * to it.
+ */
+static int _send_block(struct bcast_parameters *params,
+		       file_bcast_msg_t *bcast_msg, char *node_list,
+		       hostlist_t *missing, hostlist_t *hits)
 {
 	List ret_list = NULL;
 	list_itr_t *itr;
@@ -181,8 +208,7 @@ static int _file_bcast(struct bcast_parameters *params,
 	msg.forward.tree_width = params->tree_width;
 	msg.msg_type = REQUEST_FILE_BCAST;
 
-	ret_list = slurm_send_recv_msgs(sbcast_cred->node_list, &msg,
-					params->timeout);
+	ret_list = slurm_send_recv_msgs(node_list, &msg, params->timeout);
 	if (ret_list == NULL) {
 		error("slurm_send_recv_msgs: %m");
 		exit(1);
@@ -192,8 +218,16 @@ static int _file_bcast(struct bcast_parameters *params,
 	while ((ret_data_info = list_next(itr))) {
 		msg_rc = slurm_get_return_code(ret_data_info->type,
 					       ret_data_info->data);
-		if (msg_rc == SLURM_SUCCESS)
+		if (msg_rc == SLURM_SUCCESS) {
+			if (hits)
+				hostlist_push_host(hits,
+						   ret_data_info->node_name);
+			continue;
+		}
+		if (missing && (msg_rc == ESLURMD_BCAST_BLOCK_MISSING)) {
+			hostlist_push_host(missing, ret_data_info->node_name);
 			continue;
+		}
 
 		error("REQUEST_FILE_BCAST(%s): %s",
 		      ret_data_info->node_name,
@@ -206,6 +240,127 @@ static int _file_bcast(struct bcast_parameters *params,
 	return rc;
 }
 
+static void *_peer_send_thread(void *arg)
+{
+	peer_send_t *peer_send = arg;
+
+	peer_send->rc = _send_block(peer_send->params, &peer_send->bcast_msg,
+				    peer_send->peer, NULL, NULL);
+
+	return NULL;
+}
+
+/*
+ * Split the nodes missing a block between nodes that already have it cached,
+ * and ask each of those to send it on to its share. Shares whose peer fails
+ * get the data from sbcast instead. The first and last blocks are never sent
+ * this way, as resending those to a node that already got them would fail.
+ */
+static int _peer_send(struct bcast_parameters *params,
+		      file_bcast_msg_t *bcast_msg, file_bcast_msg_t *by_hash,
+		      hostlist_t *hits, hostlist_t *missing)
+{
+	int missing_cnt = hostlist_count(missing);
+	int peer_cnt = MIN(MIN(hostlist_count(hits), missing_cnt), MAX_THREADS);
+	int share = (missing_cnt + peer_cnt - 1) / peer_cnt;
+	peer_send_t *peer_sends = xcalloc(peer_cnt, sizeof(*peer_sends));
+	int rc = SLURM_SUCCESS, rc2;
+
+	for (int i = 0; i < peer_cnt; i++) {
+		hostlist_t *targets = hostlist_create(NULL);
+		char *host;
+
+		for (int j = 0; (j < share) && (host = hostlist_shift(missing));
+		     j++) {
+			hostlist_push_host(targets, host);
+			free(host);
+		}
+		peer_sends[i].params = params;
+		peer_sends[i].bcast_msg = *by_hash;
+		peer_sends[i].bcast_msg.peer_nodes =
+			hostlist_ranged_string_xmalloc(targets);
+		peer_sends[i].peer = hostlist_shift(hits);
+		FREE_NULL_HOSTLIST(targets);
+
+		debug("block %u sent from %s to %s", bcast_msg->block_no,
+		      peer_sends[i].peer, peer_sends[i].bcast_msg.peer_nodes);
+		slurm_thread_create(&peer_sends[i].tid, _peer_send_thread,
+				    &peer_sends[i]);
+	}
+
+	for (int i = 0; i < peer_cnt; i++) {
+		pthread_join(peer_sends[i].tid, NULL);
+		if (peer_sends[i].rc != SLURM_SUCCESS) {
+			debug("block %u from %s failed, sending it to %s",
+			      bcast_msg->block_no, peer_sends[i].peer,
+			      peer_sends[i].bcast_msg.peer_nodes);
+			if ((rc2 = _send_block(params, bcast_msg,
+					       peer_sends[i].bcast_msg.peer_nodes,
+					       NULL, NULL)))
+				rc = rc2;
+		}
+		xfree(peer_sends[i].bcast_msg.peer_nodes);
+		free(peer_sends[i].peer);
+	}
+	xfree(peer_sends);
+
+	return rc;
+}
+
+/*
+ * Issue the RPC to transfer the file's data. With BCAST_FLAG_BLOCK_CACHE the
+ * block is first offered by hash alone, and the data is only sent to the
+ * nodes that do not already have it in their block cache.
+ */
+static int _file_bcast(struct bcast_parameters *params,
+		       file_bcast_msg_t *bcast_msg,
+		       job_sbcast_cred_msg_t *sbcast_cred)
+{
+	file_bcast_msg_t by_hash = *bcast_msg;
+	hostlist_t *missing, *hits = NULL;
+	int rc;
+
+	if (!(params->flags & BCAST_FLAG_BLOCK_CACHE) ||
+	    !bcast_msg->uncomp_len)
+		return _send_block(params, bcast_msg, sbcast_cred->node_list,
+				   NULL, NULL);
+
+	by_hash.block_hash.type = HASH_PLUGIN_K12;
+	if (hash_g_compute((char *) src + bcast_msg->block_offset,
+			   bcast_msg->uncomp_len, NULL, 0,
+			   &by_hash.block_hash) < 0)
+		return _send_block(params, bcast_msg, sbcast_cred->node_list,
+				   NULL, NULL);
+	by_hash.flags |= FILE_BCAST_BY_HASH;
+	by_hash.compress = COMPRESS_OFF;
+	by_hash.block = NULL;
+	by_hash.block_len = 0;
+
+	missing = hostlist_create(NULL);
+	if (params->flags & BCAST_FLAG_PEER_SEND)
+		hits = hostlist_create(NULL);
+	rc = _send_block(params, &by_hash, sbcast_cred->node_list, missing,
+			 hits);
+	if ((rc != SLURM_SUCCESS) || !hostlist_count(missing)) {
+		/* nothing left to send */
+	} else if (hits && hostlist_count(hits) &&
+		   !(bcast_msg->flags & FILE_BCAST_LAST_BLOCK) &&
+		   (bcast_msg->block_no != 1)) {
+		rc = _peer_send(params, bcast_msg, &by_hash, hits, missing);
+	} else {
+		char *node_list = hostlist_ranged_string_xmalloc(missing);
+
+		debug("block %u not cached on %s",
+		      bcast_msg->block_no, node_list);
+		rc = _send_block(params, bcast_msg, node_list, NULL, NULL);
+		xfree(node_list);
+	}
+	FREE_NULL_HOSTLIST(missing);
+	FREE_NULL_HOSTLIST(hits);
+
+	return rc;
+}
+
 /* load a buffer with data from the file to broadcast,
  * return number of bytes read, zero on end of file */
 static int _get_block_none(char **buffer, int *orig_len, bool *more,
@@ -305,6 +460,152 @@ static int _next_block(struct bcast_parameters *params,
 	return _get_block_none(buffer, orig_len, more, file_start);
 }
 
+/*
+ * Fill in the data for bcast_msg->block_offset. Unlike _next_block() this
+ * keeps no state between calls, so blocks can be prepared concurrently.
+ * Uncompressed blocks point straight into the mmap'd file rather than a copy.
+ */
+static void _get_block_at(struct bcast_parameters *params,
+			  file_bcast_msg_t *bcast_msg)
+{
+	char *position = (char *) src + bcast_msg->block_offset;
+	int size = MIN(block_len, f_stat.st_size - bcast_msg->block_offset);
+
+	bcast_msg->uncomp_len = size;
+#if HAVE_LZ4
+	if (params->compress == COMPRESS_LZ4) {
+		int bound = LZ4_compressBound(size);
+
+		bcast_msg->block = xmalloc(bound);
+		if (!(bcast_msg->block_len =
+		      LZ4_compress_default(position, bcast_msg->block, size,
+					   bound))) {
+			/* compression failure */
+			fatal("LZ4 compression error");
+		}
+		return;
+	}
+#endif
+	bcast_msg->block = position;
+	bcast_msg->block_len = size;
+}
+
+/* Prepare and broadcast one block, recording its outcome in pipeline */
+static int _pipeline_send_block(bcast_pipeline_t *pipeline, uint32_t block_no,
+				bool last)
+{
+	file_bcast_msg_t bcast_msg = *pipeline->bcast_msg;
+	int rc;
+	DEF_TIMERS;
+
+	bcast_msg.block_no = block_no;
+	bcast_msg.block_offset = (uint64_t) (block_no - 1) * block_len;
+	if (last)
+		bcast_msg.flags |= FILE_BCAST_LAST_BLOCK;
+
+	START_TIMER;
+	_get_block_at(pipeline->params, &bcast_msg);
+	END_TIMER;
+	debug("block %u, size %u", bcast_msg.block_no, bcast_msg.block_len);
+
+	rc = _file_bcast(pipeline->params, &bcast_msg, sbcast_cred);
+	if (bcast_msg.compress)
+		xfree(bcast_msg.block);
+
+	slurm_mutex_lock(&pipeline->mutex);
+	pipeline->time_compression += DELTA_TIMER;
+	pipeline->size_uncompressed += bcast_msg.uncomp_len;
+	pipeline->size_compressed += bcast_msg.block_len;
+	if (rc && !pipeline->rc)
+		pipeline->rc = rc;
+	slurm_mutex_unlock(&pipeline->mutex);
+
+	return rc;
+}
+
+static void *_pipeline_thread(void *arg)
+{
+	bcast_pipeline_t *pipeline = arg;
+	uint32_t block_no;
+
+	while (true) {
+		slurm_mutex_lock(&pipeline->mutex);
+		if (pipeline->rc ||
+		    (pipeline->next_block >= pipeline->block_cnt)) {
+			slurm_mutex_unlock(&pipeline->mutex);
+			break;
+		}
+		block_no = pipeline->next_block++;
+		slurm_mutex_unlock(&pipeline->mutex);
+
+		if (_pipeline_send_block(pipeline, block_no, false))
+			break;
+	}
+
+	return NULL;
+}
+
+/*
+ * Broadcast the file with up to params->pipeline_depth blocks in flight.
+ * Each thread reads, compresses and sends its own blocks, so the next block
+ * is already on the wire while the previous ones are still being relayed
+ * down the message tree. slurmd writes every block at its own offset.
+ *
+ * The first block registers the destination file on each node and the last
+ * block closes it, so those two are sent on their own.
+ */
+static int _bcast_file_pipeline(struct bcast_parameters *params,
+				file_bcast_msg_t *bcast_msg,
+				uint64_t *size_uncompressed,
+				uint64_t *size_compressed,
+				uint32_t *time_compression)
+{
+	bcast_pipeline_t pipeline = {
+		.bcast_msg = bcast_msg,
+		.block_cnt = (f_stat.st_size + block_len - 1) / block_len,
+		.next_block = 2,
+		.params = params,
+	};
+	pthread_t *threads;
+	int thread_cnt;
+
+	if (params->compress == COMPRESS_LZ4) {
+#if !HAVE_LZ4
+		info("lz4 compression not supported, sending uncompressed file.");
+		params->compress = COMPRESS_OFF;
+#endif
+	} else if (params->compress != COMPRESS_OFF) {
+		error("File compression type %u not supported,"
+		      " sending uncompressed file.", params->compress);
+		params->compress = COMPRESS_OFF;
+	}
+	bcast_msg->compress = params->compress;
+
+	slurm_mutex_init(&pipeline.mutex);
+
+	if (_pipeline_send_block(&pipeline, 1, false))
+		goto done;
+
+	thread_cnt = MIN(params->pipeline_depth, pipeline.block_cnt - 2);
+	threads = xcalloc(thread_cnt, sizeof(*threads));
+	for (int i = 0; i < thread_cnt; i++)
+		slurm_thread_create(&threads[i], _pipeline_thread, &pipeline);
+	for (int i = 0; i < thread_cnt; i++)
+		pthread_join(threads[i], NULL);
+	xfree(threads);
+
+	if (!pipeline.rc)
+		(void) _pipeline_send_block(&pipeline, pipeline.block_cnt, true);
+
+done:
+	slurm_mutex_destroy(&pipeline.mutex);
+	*size_uncompressed = pipeline.size_uncompressed;
+	*size_compressed = pipeline.size_compressed;
+	*time_compression = pipeline.time_compression;
+
+	return pipeline.rc;
+}
+
 /* read and broadcast the file */
 static int _bcast_file(struct bcast_parameters *params)
 {
@@ -349,6 +650,14 @@ static int _bcast_file(struct bcast_parameters *params)
 	else if (params->tree_width != 0xfffd)
 		params->tree_width = MIN(MAX_THREADS, params->tree_width);
 
+	if ((params->pipeline_depth > 1) &&
+	    (f_stat.st_size > ((int64_t) block_len * 2))) {
+		rc = _bcast_file_pipeline(params, &bcast_msg,
+					  &size_uncompressed, &size_compressed,
+					  &time_compression);
+		more = false;
+	}
+
 	while (more) {
 		START_TIMER;
 		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
@@ -624,8 +933,19 @@ fini:
 extern int bcast_file(struct bcast_parameters *params)
 {
 	List lib_paths = NULL;
+	char *tmp;
 	int rc;
 
+	if ((tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				    "BlockCache="))) {
+		if (atoi(tmp) > 0)
+			params->flags |= BCAST_FLAG_BLOCK_CACHE;
+		xfree(tmp);
+	}
+	if ((params->flags & BCAST_FLAG_BLOCK_CACHE) &&
+	    xstrcasestr(slurm_conf.bcast_parameters, "peer_send"))
+		params->flags |= BCAST_FLAG_PEER_SEND;
+
 	if ((rc = _file_state(params)) != SLURM_SUCCESS)
 		return rc;
 	if ((rc = _get_job_info(params)) != SLURM_SUCCESS)
@@ -44,6 +44,8 @@
 #define BCAST_FLAG_PRESERVE	 0x0002
 #define BCAST_FLAG_SEND_LIBS	 0x0004
 #define BCAST_FLAG_SHARED_OBJECT 0x0008
+#define BCAST_FLAG_BLOCK_CACHE	 0x0010
+#define BCAST_FLAG_PEER_SEND	 0x0020
 
 struct bcast_parameters {
 	uint32_t block_size;
@@ -52,6 +54,7 @@ struct bcast_parameters {
 	char *dst_fname;
 	char *exe_fname;
 	uint16_t flags;
+	uint32_t pipeline_depth;	/* blocks in flight, 0 or 1 is serial */
 	slurm_selected_step_t *selected_step;
 	char *src_fname;
 	uint32_t step_id;
@@ -46,6 +46,7 @@
 
 #include "src/common/slurmdbd_pack.h"
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/gres.h"
@@ -54,7 +55,7 @@
 #include "src/slurmdbd/read_config.h"
 
 #define ASSOC_HASH_SIZE 1000
-#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % ASSOC_HASH_SIZE)
+#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % assoc_hash_size)
 
 typedef struct {
 	char *req;
@@ -68,6 +69,11 @@ typedef struct {
 	uint64_t **tres_cnt;
 } foreach_tres_pos_t;
 
+typedef struct {
+	char *name;	/* lower case copy of the record's name */
+	void *rec;
+} name_hash_t;
+
 slurmdb_assoc_rec_t *assoc_mgr_root_assoc = NULL;
 uint32_t g_qos_max_priority = 0;
 uint32_t g_assoc_max_priority = 0;
@@ -92,6 +98,13 @@ static pthread_mutex_t assoc_lock_init = PTHREAD_MUTEX_INITIALIZER;
 static assoc_init_args_t init_setup;
 static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
+/* Only changed while assoc_hash_id and assoc_hash are not allocated */
+static uint32_t assoc_hash_size = ASSOC_HASH_SIZE;
+static xhash_t *user_hash_uid = NULL;	/* first user rec of each uid */
+static xhash_t *user_hash_name = NULL;	/* name_hash_t of each user */
+static slurmdb_qos_rec_t **qos_hash_id = NULL; /* g_qos_count entries */
+static uint32_t qos_hash_id_cnt = 0;
+static xhash_t *qos_hash_name = NULL;	/* name_hash_t of each qos */
 static int *assoc_mgr_tres_old_pos = NULL;
 
 static bool _running_cache(void)
@@ -138,9 +151,9 @@ static int _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
 	if (assoc->partition)
 		index += _get_str_inx(assoc->partition);
 
-	index %= ASSOC_HASH_SIZE;
+	index %= (int) assoc_hash_size;
 	if (index < 0)
-		index += ASSOC_HASH_SIZE;
+		index += assoc_hash_size;
 
 	return index;
 
@@ -151,10 +164,10 @@ static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
 	int inx = ASSOC_HASH_ID_INX(assoc->id);
 
 	if (!assoc_hash_id)
-		assoc_hash_id = xcalloc(ASSOC_HASH_SIZE,
+		assoc_hash_id = xcalloc(assoc_hash_size,
 					sizeof(slurmdb_assoc_rec_t *));
 	if (!assoc_hash)
-		assoc_hash = xcalloc(ASSOC_HASH_SIZE,
+		assoc_hash = xcalloc(assoc_hash_size,
 				     sizeof(slurmdb_assoc_rec_t *));
 
 	assoc->assoc_next_id = assoc_hash_id[inx];
@@ -706,6 +719,199 @@ static int _list_find_user(void *x, void *key)
 	return 0;
 }
 
+static void _name_hash_id(void *item, const char **key, uint32_t *key_len)
+{
+	name_hash_t *entry = item;
+
+	*key = entry->name;
+	*key_len = strlen(entry->name);
+}
+
+static void _name_hash_free(void *item)
+{
+	name_hash_t *entry = item;
+
+	xfree(entry->name);
+	xfree(entry);
+}
+
+/* Names are compared case insensitively, like xstrcasecmp() does */
+static void *_name_hash_get(xhash_t *table, const char *name)
+{
+	name_hash_t *entry;
+	char *key;
+
+	if (!table || !name)
+		return NULL;
+
+	key = xstrdup(name);
+	xstrtolower(key);
+	entry = xhash_get_str(table, key);
+	xfree(key);
+
+	return entry ? entry->rec : NULL;
+}
+
+/* The first record added with a name is kept */
+static void _name_hash_add(xhash_t *table, const char *name, void *rec)
+{
+	name_hash_t *entry;
+
+	if (!table || !name || _name_hash_get(table, name))
+		return;
+
+	entry = xmalloc(sizeof(*entry));
+	entry->name = xstrdup(name);
+	xstrtolower(entry->name);
+	entry->rec = rec;
+	xhash_add(table, entry);
+}
+
+static void _name_hash_delete(xhash_t *table, const char *name, void *rec)
+{
+	char *key;
+
+	if (!table || !name || (_name_hash_get(table, name) != rec))
+		return;
+
+	key = xstrdup(name);
+	xstrtolower(key);
+	xhash_delete_str(table, key);
+	xfree(key);
+}
+
+static void _user_hash_uid_id(void *item, const char **key,
+			      uint32_t *key_len)
+{
+	slurmdb_user_rec_t *user = item;
+
+	*key = (const char *) &user->uid;
+	*key_len = sizeof(user->uid);
+}
+
+/*
+ * Return the first user in assoc_mgr_user_list with the given uid, as
+ * list_find_first(_list_find_uid) would. Users without a known uid are not
+ * hashed, so NO_VAL falls back to walking the list.
+ */
+static slurmdb_user_rec_t *_find_user_by_uid(uint32_t uid)
+{
+	if (!assoc_mgr_user_list)
+		return NULL;
+
+	if (uid == NO_VAL)
+		return list_find_first(assoc_mgr_user_list, _list_find_uid,
+				       &uid);
+
+	return xhash_get(user_hash_uid, (char *) &uid, sizeof(uid));
+}
+
+/* Return the user matching as list_find_first(_list_find_user) would */
+static slurmdb_user_rec_t *_find_user(slurmdb_user_rec_t *user)
+{
+	if (user->uid != NO_VAL)
+		return _find_user_by_uid(user->uid);
+
+	return _name_hash_get(user_hash_name, user->name);
+}
+
+/* Call with user write lock before a user rec is added or its uid changed */
+static void _add_user_hash(slurmdb_user_rec_t *user)
+{
+	if ((user->uid != NO_VAL) &&
+	    !xhash_get(user_hash_uid, (char *) &user->uid, sizeof(user->uid)))
+		xhash_add(user_hash_uid, user);
+	_name_hash_add(user_hash_name, user->name, user);
+}
+
+/*
+ * Call with user write lock before a user rec is freed or its uid or name
+ * changed. If another user shares the uid it takes over the uid slot.
+ */
+static void _delete_user_hash(slurmdb_user_rec_t *user)
+{
+	list_itr_t *itr;
+	slurmdb_user_rec_t *other;
+
+	_name_hash_delete(user_hash_name, user->name, user);
+
+	if ((user->uid == NO_VAL) ||
+	    (xhash_get(user_hash_uid, (char *) &user->uid,
+		       sizeof(user->uid)) != user))
+		return;
+
+	xhash_delete(user_hash_uid, (char *) &user->uid, sizeof(user->uid));
+
+	itr = list_iterator_create(assoc_mgr_user_list);
+	while ((other = list_next(itr))) {
+		if ((other != user) && (other->uid == user->uid)) {
+			xhash_add(user_hash_uid, other);
+			break;
+		}
+	}
+	list_iterator_destroy(itr);
+}
+
+/* Call with user write lock after assoc_mgr_user_list is replaced */
+static void _rebuild_user_hash(void)
+{
+	list_itr_t *itr;
+	slurmdb_user_rec_t *user;
+
+	xhash_free(user_hash_uid);
+	xhash_free(user_hash_name);
+
+	if (!assoc_mgr_user_list)
+		return;
+
+	user_hash_uid = xhash_init(_user_hash_uid_id, NULL);
+	user_hash_name = xhash_init(_name_hash_id, _name_hash_free);
+
+	itr = list_iterator_create(assoc_mgr_user_list);
+	while ((user = list_next(itr)))
+		_add_user_hash(user);
+	list_iterator_destroy(itr);
+}
+
+/* Call with qos read lock */
+static slurmdb_qos_rec_t *_find_qos_by_id(uint32_t id)
+{
+	if (id >= qos_hash_id_cnt)
+		return NULL;
+
+	return qos_hash_id[id];
+}
+
+/* Call with qos write lock after assoc_mgr_qos_list changes */
+static void _rebuild_qos_hash(void)
+{
+	list_itr_t *itr;
+	slurmdb_qos_rec_t *qos;
+
+	xfree(qos_hash_id);
+	qos_hash_id_cnt = 0;
+	xhash_free(qos_hash_name);
+
+	if (!assoc_mgr_qos_list)
+		return;
+
+	qos_hash_name = xhash_init(_name_hash_id, _name_hash_free);
+
+	itr = list_iterator_create(assoc_mgr_qos_list);
+	while ((qos = list_next(itr))) {
+		if (qos->id >= qos_hash_id_cnt) {
+			uint32_t cnt = MAX(qos->id + 1, g_qos_count);
+
+			xrecalloc(qos_hash_id, cnt, sizeof(*qos_hash_id));
+			qos_hash_id_cnt = cnt;
+		}
+		if (!qos_hash_id[qos->id])
+			qos_hash_id[qos->id] = qos;
+		_name_hash_add(qos_hash_name, qos->name, qos);
+	}
+	list_iterator_destroy(itr);
+}
+
 static int _list_find_coord(void *x, void *key)
 {
 	slurmdb_user_rec_t *user = x;
@@ -739,8 +945,7 @@ static void _set_user_default_acct(slurmdb_assoc_rec_t *assoc,
 	/* set up the default if this is it */
 	if ((assoc->is_def == 1) && (assoc->uid != NO_VAL)) {
 		if (!user)
-			user = list_find_first(assoc_mgr_user_list,
-					       _list_find_uid, &assoc->uid);
+			user = _find_user_by_uid(assoc->uid);
 
 		if (!user)
 			return;
@@ -770,8 +975,7 @@ static void _clear_user_default_acct(slurmdb_assoc_rec_t *assoc)
 
 	/* set up the default if this is it */
 	if ((assoc->is_def == 0) && (assoc->uid != NO_VAL)) {
-		slurmdb_user_rec_t *user = list_find_first(
-			assoc_mgr_user_list, _list_find_uid, &assoc->uid);
+		slurmdb_user_rec_t *user = _find_user_by_uid(assoc->uid);
 
 		if (!user)
 			return;
@@ -798,8 +1002,7 @@ static void _set_user_default_wckey(slurmdb_wckey_rec_t *wckey,
 	/* set up the default if this is it */
 	if ((wckey->is_def == 1) && (wckey->uid != NO_VAL)) {
 		if (!user)
-			user = list_find_first(assoc_mgr_user_list,
-					       _list_find_uid, &wckey->uid);
+			user = _find_user_by_uid(wckey->uid);
 
 		if (!user)
 			return;
@@ -1110,6 +1313,12 @@ static int _post_assoc_list(void)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	/*
+	 * Keep the hash chains short for large association lists, every
+	 * parent lookup below walks the chain of its id.
+	 */
+	assoc_hash_size = MAX(ASSOC_HASH_SIZE,
+			      list_count(assoc_mgr_assoc_list));
 
 	itr = list_iterator_create(assoc_mgr_assoc_list);
 
@@ -1741,6 +1950,7 @@ static int _get_assoc_mgr_qos_list(void *db_conn, int enforce)
 	new_list = NULL;
 
 	_post_qos_list(assoc_mgr_qos_list);
+	_rebuild_qos_hash();
 
 	assoc_mgr_unlock(&locks);
 
@@ -1769,6 +1979,7 @@ static int _get_assoc_mgr_user_list(void *db_conn, int enforce)
 	}
 
 	_post_user_list(assoc_mgr_user_list);
+	_rebuild_user_hash();
 
 	assoc_mgr_unlock(&locks);
 	return SLURM_SUCCESS;
@@ -1978,9 +2189,7 @@ static int _refresh_assoc_mgr_qos_list(void *db_conn, int enforce)
 		list_itr_t *itr = list_iterator_create(current_qos);
 
 		while ((curr_qos = list_next(itr))) {
-			if (!(qos_rec = list_find_first(assoc_mgr_qos_list,
-							slurmdb_find_qos_in_list,
-							&curr_qos->id)))
+			if (!(qos_rec = _find_qos_by_id(curr_qos->id)))
 				continue;
 			slurmdb_destroy_qos_usage(curr_qos->usage);
 			curr_qos->usage = qos_rec->usage;
@@ -1991,6 +2200,7 @@ static int _refresh_assoc_mgr_qos_list(void *db_conn, int enforce)
 	}
 
 	assoc_mgr_qos_list = current_qos;
+	_rebuild_qos_hash();
 
 	assoc_mgr_unlock(&locks);
 
@@ -2021,6 +2231,7 @@ static int _refresh_assoc_mgr_user_list(void *db_conn, int enforce)
 	FREE_NULL_LIST(assoc_mgr_user_list);
 
 	assoc_mgr_user_list = current_users;
+	_rebuild_user_hash();
 
 	assoc_mgr_unlock(&locks);
 
@@ -2166,6 +2377,11 @@ extern int assoc_mgr_fini(bool save_state)
 	FREE_NULL_LIST(assoc_mgr_qos_list);
 	FREE_NULL_LIST(assoc_mgr_user_list);
 	FREE_NULL_LIST(assoc_mgr_wckey_list);
+	xhash_free(user_hash_uid);
+	xhash_free(user_hash_name);
+	xfree(qos_hash_id);
+	qos_hash_id_cnt = 0;
+	xhash_free(qos_hash_name);
 	if (assoc_mgr_tres_name_array) {
 		int i;
 		for (i=0; i<g_tres_count; i++)
@@ -2216,8 +2432,7 @@ static slurmdb_admin_level_t _get_admin_level_internal(void *db_conn,
 		return SLURMDB_ADMIN_NOTSET;
 	}
 
-	found_user = list_find_first_ro(assoc_mgr_user_list,
-					_list_find_uid, &uid);
+	found_user = _find_user_by_uid(uid);
 
 	if (found_user)
 		level = found_user->admin_level;
@@ -2887,8 +3102,7 @@ extern int assoc_mgr_fill_in_user(void *db_conn, slurmdb_user_rec_t *user,
 		return SLURM_SUCCESS;
 	}
 
-	if (!(found_user = list_find_first_ro(assoc_mgr_user_list,
-					      _list_find_user, user))) {
+	if (!(found_user = _find_user(user))) {
 		if (!locked)
 			assoc_mgr_unlock(&locks);
 		if (enforce & ACCOUNTING_ENFORCE_ASSOCS)
@@ -2932,7 +3146,6 @@ extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 				 int enforce,
 				 slurmdb_qos_rec_t **qos_pptr, bool locked)
 {
-	list_itr_t *itr = NULL;
 	slurmdb_qos_rec_t * found_qos = NULL;
 	assoc_mgr_lock_t locks = { .qos = READ_LOCK };
 
@@ -2967,14 +3180,8 @@ extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 		return SLURM_SUCCESS;
 	}
 
-	itr = list_iterator_create(assoc_mgr_qos_list);
-	while ((found_qos = list_next(itr))) {
-		if (qos->id == found_qos->id)
-			break;
-		else if (qos->name && !xstrcasecmp(qos->name, found_qos->name))
-			break;
-	}
-	list_iterator_destroy(itr);
+	if (!(found_qos = _find_qos_by_id(qos->id)) && qos->name)
+		found_qos = _name_hash_get(qos_hash_name, qos->name);
 
 	if (!found_qos) {
 		if (!locked)
@@ -4628,7 +4835,6 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 	slurmdb_user_rec_t * rec = NULL;
 	slurmdb_user_rec_t * object = NULL;
 
-	list_itr_t *itr = NULL;
 	int rc = SLURM_SUCCESS;
 	uid_t pw_uid;
 	assoc_mgr_lock_t locks = { .assoc = WRITE_LOCK, .user = WRITE_LOCK,
@@ -4642,18 +4848,9 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 		return SLURM_SUCCESS;
 	}
 
-	itr = list_iterator_create(assoc_mgr_user_list);
 	while ((object = list_pop(update->objects))) {
-		list_iterator_reset(itr);
-		while ((rec = list_next(itr))) {
-			char *name;
-			if (object->old_name)
-				name = object->old_name;
-			else
-				name = object->name;
-			if (!xstrcasecmp(name, rec->name))
-				break;
-		}
+		rec = _name_hash_get(user_hash_name, object->old_name ?
+				     object->old_name : object->name);
 
 		//info("%d user %s", update->type, object->name);
 		switch(update->type) {
@@ -4673,11 +4870,13 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 					      rec->name);
 					break;
 				}
+				_delete_user_hash(rec);
 				xfree(rec->old_name);
 				rec->old_name = rec->name;
 				rec->name = object->name;
 				object->name = NULL;
 				rc = _change_user_name(rec);
+				_add_user_hash(rec);
 			}
 
 			if (object->default_acct) {
@@ -4708,6 +4907,7 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 			} else
 				object->uid = pw_uid;
 			list_append(assoc_mgr_user_list, object);
+			_add_user_hash(object);
 			_handle_new_user_coord(object);
 			object = NULL;
 			break;
@@ -4718,7 +4918,8 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 			}
 			list_delete_first(assoc_mgr_coord_list,
 					  slurm_find_ptr_in_list, rec);
-			list_delete_item(itr);
+			_delete_user_hash(rec);
+			list_delete_ptr(assoc_mgr_user_list, rec);
 			break;
 		case SLURMDB_ADD_COORD:
 			/* same as SLURMDB_REMOVE_COORD */
@@ -4745,7 +4946,6 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 
 		slurmdb_destroy_user_rec(object);
 	}
-	list_iterator_destroy(itr);
 	if (!locked)
 		assoc_mgr_unlock(&locks);
 
@@ -4809,6 +5009,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 				assoc_mgr_set_qos_tres_cnt(object);
 
 			list_append(assoc_mgr_qos_list, object);
+			_rebuild_qos_hash();
 /* 			char *tmp = get_qos_complete_str_bitstr( */
 /* 				assoc_mgr_qos_list, */
 /* 				object->preempt_bitstr); */
@@ -5122,6 +5323,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 				list_append(remove_list, rec);
 			} else
 				list_delete_item(itr);
+			_rebuild_qos_hash();
 
 			if (!assoc_mgr_assoc_list)
 				break;
@@ -6413,6 +6615,7 @@ extern int load_assoc_mgr_state(bool only_tres)
 			FREE_NULL_LIST(assoc_mgr_user_list);
 			assoc_mgr_user_list = msg->my_list;
 			_post_user_list(assoc_mgr_user_list);
+			_rebuild_user_hash();
 			debug("Recovered %u users",
 			      list_count(assoc_mgr_user_list));
 			msg->my_list = NULL;
@@ -6452,6 +6655,7 @@ extern int load_assoc_mgr_state(bool only_tres)
 			FREE_NULL_LIST(assoc_mgr_qos_list);
 			assoc_mgr_qos_list = msg->my_list;
 			_post_qos_list(assoc_mgr_qos_list);
+			_rebuild_qos_hash();
 			debug("Recovered %u qos",
 			      list_count(assoc_mgr_qos_list));
 			msg->my_list = NULL;
@@ -6607,7 +6811,7 @@ extern void assoc_mgr_set_uid(uid_t uid, char *username)
 		return;
 	}
 
-	if (list_find_first_ro(assoc_mgr_user_list, _list_find_uid, &uid)) {
+	if (_find_user_by_uid(uid)) {
 		debug2("%s: uid=%u already known", __func__, uid);
 		assoc_mgr_unlock(&read_lock);
 		return;
@@ -6621,8 +6825,7 @@ extern void assoc_mgr_set_uid(uid_t uid, char *username)
 		return;
 	}
 
-	if (!(user = list_find_first(assoc_mgr_user_list, _list_find_user,
-				     &lookup))) {
+	if (!(user = _find_user(&lookup))) {
 		debug2("%s: user %s not in assoc_mgr_user_list",
 		       __func__, username);
 		assoc_mgr_unlock(&write_locks);
@@ -6631,7 +6834,9 @@ extern void assoc_mgr_set_uid(uid_t uid, char *username)
 
 	debug2("%s: adding mapping for user %s uid %u",
 	       __func__, username, uid);
+	_delete_user_hash(user);
 	user->uid = uid;
+	_add_user_hash(user);
 
 	if (assoc_mgr_assoc_list)
 		list_for_each(assoc_mgr_assoc_list, _each_assoc_set_uid, user);
@@ -6700,7 +6905,9 @@ static int _for_each_user_missing_uids(void *x, void *arg)
 	} else {
 		debug3("%s: found uid %u for user %s",
 		       __func__, pw_uid, object->name);
+		_delete_user_hash(object);
 		object->uid = pw_uid;
+		_add_user_hash(object);
 	}
 
 	return 1;
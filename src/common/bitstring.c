@@ -42,6 +42,7 @@
 #include "config.h"
 
 #include <ctype.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -227,22 +228,159 @@ static const char* hexmask_lookup[256] = {
 #endif
 
 /*
- * Allocate a bitstring.
- *   nbits (IN)		valid bits in new bitstring, initialized to all clear
+ * Per-thread cache of freed bitstrings, reused by bit_alloc() for bitstrings
+ * of the same size rather than going through malloc() and free().
+ * Disabled unless bit_cache_init() is called.
+ */
+#define BIT_CACHE_SIZE 16
+/* Fold thread counters into the totals after this many allocations */
+#define BIT_CACHE_STATS_INTERVAL 1024
+
+typedef struct {
+	int cnt;
+	bitstr_t *bits[BIT_CACHE_SIZE];
+	uint64_t hits;
+	uint64_t misses;
+} bit_cache_t;
+
+static bool bit_cache_enabled = false;
+static pthread_key_t bit_cache_key;
+static pthread_once_t bit_cache_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t bit_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t bit_cache_hits = 0;
+static uint64_t bit_cache_misses = 0;
+
+static void _bit_cache_stats_fold(bit_cache_t *cache)
+{
+	slurm_mutex_lock(&bit_cache_mutex);
+	bit_cache_hits += cache->hits;
+	bit_cache_misses += cache->misses;
+	slurm_mutex_unlock(&bit_cache_mutex);
+	cache->hits = 0;
+	cache->misses = 0;
+}
+
+/* Release the cache of an exiting thread */
+static void _bit_cache_destroy(void *arg)
+{
+	bit_cache_t *cache = arg;
+
+	_bit_cache_stats_fold(cache);
+	for (int i = 0; i < cache->cnt; i++)
+		xfree(cache->bits[i]);
+	xfree(cache);
+}
+
+static void _bit_cache_key_create(void)
+{
+	if (pthread_key_create(&bit_cache_key, _bit_cache_destroy))
+		fatal("%s: pthread_key_create failed: %m", __func__);
+}
+
+static bit_cache_t *_bit_cache_get(void)
+{
+	bit_cache_t *cache;
+
+	if (!bit_cache_enabled)
+		return NULL;
+
+	if (!(cache = pthread_getspecific(bit_cache_key))) {
+		cache = xmalloc(sizeof(*cache));
+		if (pthread_setspecific(bit_cache_key, cache))
+			fatal("%s: pthread_setspecific failed: %m", __func__);
+	}
+
+	return cache;
+}
+
+/*
+ * Enable reuse of freed bitstrings in the calling process.
+ * Intended for daemons that allocate many short lived bitstrings of a few
+ * fixed sizes (e.g. node and core bitmaps in slurmctld).
+ */
+extern void bit_cache_init(void)
+{
+	slurm_mutex_lock(&bit_cache_mutex);
+	pthread_once(&bit_cache_once, _bit_cache_key_create);
+	bit_cache_enabled = true;
+	slurm_mutex_unlock(&bit_cache_mutex);
+}
+
+/*
+ * Get the count of bitstring allocations satisfied from and missing the
+ * bitstring cache. Counts of running threads are included periodically.
+ */
+extern void bit_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+	slurm_mutex_lock(&bit_cache_mutex);
+	*hits = bit_cache_hits;
+	*misses = bit_cache_misses;
+	slurm_mutex_unlock(&bit_cache_mutex);
+}
+
+extern void bit_cache_reset_stats(void)
+{
+	slurm_mutex_lock(&bit_cache_mutex);
+	bit_cache_hits = 0;
+	bit_cache_misses = 0;
+	slurm_mutex_unlock(&bit_cache_mutex);
+}
+
+/*
+ * Allocate a bitstring, from the calling thread's cache if possible.
+ *   nbits (IN)		valid bits in new bitstring
+ *   clear (IN)		clear all bits, or leave their contents undefined
  *   RETURN		new bitstring
  */
-bitstr_t *bit_alloc(bitoff_t nbits)
+static bitstr_t *_bit_alloc(bitoff_t nbits, bool clear)
 {
-	bitstr_t *new;
+	size_t size = _bitstr_words(nbits) * sizeof(bitstr_t);
+	bit_cache_t *cache;
+	bitstr_t *new = NULL;
 
 	_assert_valid_size(nbits);
-	new = xmalloc(_bitstr_words(nbits) * sizeof(bitstr_t));
+
+	if ((cache = _bit_cache_get())) {
+		for (int i = cache->cnt - 1; i >= 0; i--) {
+			if (_bitstr_bits(cache->bits[i]) != nbits)
+				continue;
+			new = cache->bits[i];
+			cache->bits[i] = cache->bits[--cache->cnt];
+			break;
+		}
+		if (new) {
+			cache->hits++;
+			if (clear)
+				memset(new, 0, size);
+		} else {
+			cache->misses++;
+		}
+		if ((cache->hits + cache->misses) >= BIT_CACHE_STATS_INTERVAL)
+			_bit_cache_stats_fold(cache);
+	}
+
+	if (!new) {
+		if (clear)
+			new = xmalloc(size);
+		else
+			new = xmalloc_nz(size);
+	}
 
 	_bitstr_magic(new) = BITSTR_MAGIC;
 	_bitstr_bits(new) = nbits;
 	return new;
 }
 
+/*
+ * Allocate a bitstring.
+ *   nbits (IN)		valid bits in new bitstring, initialized to all clear
+ *   RETURN		new bitstring
+ */
+bitstr_t *bit_alloc(bitoff_t nbits)
+{
+	return _bit_alloc(nbits, true);
+}
+
 /*
  * Reallocate a bitstring (expand or contract size).
  *   b (IN)		pointer to old bitstring
@@ -268,9 +406,17 @@ bitstr_t *slurm_bit_realloc(bitstr_t **b, bitoff_t nbits)
  */
 void slurm_bit_free(bitstr_t **b)
 {
+	bit_cache_t *cache;
+
 	xassert(*b);
 	xassert(_bitstr_magic(*b) == BITSTR_MAGIC);
 	_bitstr_magic(*b) = 0;
+
+	if ((cache = _bit_cache_get()) && (cache->cnt < BIT_CACHE_SIZE)) {
+		cache->bits[cache->cnt++] = *b;
+		*b = NULL;
+		return;
+	}
 	xfree(*b);
 }
 
@@ -877,7 +1023,8 @@ bit_copy(bitstr_t *b)
 
 	newsize_bits  = bit_size(b);
 	len = (_bitstr_words(newsize_bits) - BITSTR_OVERHEAD)*sizeof(bitstr_t);
-	new = bit_alloc(newsize_bits);
+	/* Every word is overwritten below, skip clearing them */
+	new = _bit_alloc(newsize_bits, false);
 	if (new)
 		memcpy(&new[BITSTR_OVERHEAD], &b[BITSTR_OVERHEAD], len);
 
@@ -899,6 +1046,17 @@ bit_copybits(bitstr_t *dest, bitstr_t *src)
 
 #ifdef HAVE___BUILTIN_POPCOUNTLL
 #define hweight __builtin_popcountll
+
+/*
+ * Generic x86-64 builds implement __builtin_popcountll() with a libgcc call
+ * per word. Build the counting loops a second time using the POPCNT
+ * instruction and select the version to use at load time.
+ */
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define HWEIGHT_CLONES __attribute__((target_clones("popcnt", "default")))
+#endif
+#endif
 #else
 /*
  * Returns the hamming weight (i.e. the number of bits set) in a word.
@@ -914,12 +1072,16 @@ hweight(uint64_t w)
 }
 #endif
 
+#ifndef HWEIGHT_CLONES
+#define HWEIGHT_CLONES
+#endif
+
 /*
  * Count the number of bits set in bitstring.
  *   b (IN)		bitstring to check
  *   RETURN		count of set bits
  */
-int32_t
+HWEIGHT_CLONES int32_t
 bit_set_count(bitstr_t *b)
 {
 	int32_t count = 0;
@@ -946,7 +1108,7 @@ bit_set_count(bitstr_t *b)
  *   end (IN)	last bit to check+1
  *   RETURN		count of set bits
  */
-int32_t
+HWEIGHT_CLONES int32_t
 bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 {
 	int32_t count = 0, eow;
@@ -981,6 +1143,7 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 	return count;
 }
 
+HWEIGHT_CLONES
 static int32_t _bit_overlap_internal(bitstr_t *b1, bitstr_t *b2, bool count_it)
 {
 	int32_t count = 0;
@@ -1127,7 +1290,6 @@ bit_rotate_copy(bitstr_t *b1, int32_t n, bitoff_t nbits)
 	}
 
 	new = bit_alloc(nbits);
-	bit_nclear(new,0,nbits-1);
 
 	/* bits shifting up */
 	for (bit = 0; bit < (bitsize-wrapbits); bit++) {
@@ -1194,7 +1356,7 @@ static bitoff_t _ffsn(bitstr_t b, bitoff_t n)
  * if n > bit_set_count(b), return the position of the last set bit
  * return -1 if b is empty or n == 0
  */
-bitoff_t bit_nth_set(bitstr_t *b, bitoff_t n)
+HWEIGHT_CLONES bitoff_t bit_nth_set(bitstr_t *b, bitoff_t n)
 {
 	bitoff_t bit, bit_cnt, last_bit;
 	bitstr_t mask = -1;
@@ -1254,7 +1416,7 @@ void bit_pick_firstn(bitstr_t *b, bitoff_t n)
 /*
  * build a bitmap containing the first nbits of b which are set
  */
-bitstr_t *
+HWEIGHT_CLONES bitstr_t *
 bit_pick_cnt(bitstr_t *b, bitoff_t nbits)
 {
 	bitoff_t bit = 0, new_bits, count = 0;
@@ -1354,7 +1516,7 @@ char *bit_fmt_full(bitstr_t *b)
 {
 	int32_t word;
 	bitoff_t start, bit;
-	char *str = NULL, *comma = "";
+	char *str = NULL, *pos = NULL, *comma = "";
 	_assert_bitstr_valid(b);
 
 	for (bit = 0; bit < _bitstr_bits(b); ) {
@@ -1370,11 +1532,12 @@ char *bit_fmt_full(bitstr_t *b)
 				bit++;
 			}
 			if (bit == start)	/* add single bit position */
-				xstrfmtcat(str, "%s%"BITSTR_FMT"",
-					   comma, start);
+				xstrfmtcatat(str, &pos, "%s%"BITSTR_FMT"",
+					     comma, start);
 			else 			/* add bit position range */
-				xstrfmtcat(str, "%s%"BITSTR_FMT"-%"BITSTR_FMT,
-					   comma, start, bit);
+				xstrfmtcatat(str, &pos,
+					     "%s%"BITSTR_FMT"-%"BITSTR_FMT,
+					     comma, start, bit);
 			comma = ",";
 		}
 		bit++;
@@ -1393,7 +1556,7 @@ char *bit_fmt_range(bitstr_t *b, int offset, int len)
 {
 	int32_t word;
 	bitoff_t start, fini_bit, bit;
-	char *str = NULL, *comma = "";
+	char *str = NULL, *pos = NULL, *comma = "";
 	_assert_bitstr_valid(b);
 
 	fini_bit = MIN(_bitstr_bits(b), offset + len);
@@ -1410,12 +1573,13 @@ char *bit_fmt_range(bitstr_t *b, int offset, int len)
 				bit++;
 			}
 			if (bit == start) {	/* add single bit position */
-				xstrfmtcat(str, "%s%"BITSTR_FMT"",
-					   comma, (start - offset));
+				xstrfmtcatat(str, &pos, "%s%"BITSTR_FMT"",
+					     comma, (start - offset));
 			} else {		/* add bit position range */
-				xstrfmtcat(str, "%s%"BITSTR_FMT"-%"BITSTR_FMT,
-					   comma, (start - offset),
-					   (bit - offset));
+				xstrfmtcatat(str, &pos,
+					     "%s%"BITSTR_FMT"-%"BITSTR_FMT,
+					     comma, (start - offset),
+					     (bit - offset));
 			}
 			comma = ",";
 		}
@@ -1608,6 +1772,76 @@ int32_t *bitstr2inx(bitstr_t *b)
 	return bit_inx;
 }
 
+/*
+ * convert a hex mask of a bitstring of nbits directly to inx format,
+ * equivalent to bit_unfmt_hexmask() followed by bitstr2inx() without
+ * building the intermediate bitstring
+ * returns an xmalloc()'d array of int32_t that must be xfree()'d or NULL if
+ * str is not a valid hex mask of nbits
+ */
+int32_t *hexmask2inx(const char *str, bitoff_t nbits)
+{
+	const char *curpos;
+	int32_t *bit_inx;
+	bitoff_t bit = 0, start = -1, max_bits;
+	int32_t len, pos = 0;
+
+	if (!str)
+		return NULL;
+
+	if (!xstrncmp(str, "0x", 2))	/* Bypass 0x */
+		str += 2;
+	len = strlen(str);
+
+	/* same worst case as bitstr2inx() for the bits the mask can hold */
+	max_bits = MIN(nbits, ((bitoff_t) len) * 4);
+	bit_inx = xmalloc_nz(sizeof(int32_t) * (max_bits + 2));
+
+	for (curpos = str + len - 1; curpos >= str; curpos--) {
+		int current;
+
+		if (isdigit(*curpos))
+			current = *curpos - '0';
+		else if (isxdigit(*curpos))
+			current = toupper(*curpos) - ('A' - 10);
+		else
+			goto fail;
+
+		/* skip whole digits that do not start or end a range */
+		if ((!current && (start < 0)) ||
+		    ((current == 0xf) && (start >= 0) && ((bit + 3) < nbits))) {
+			bit += 4;
+			continue;
+		}
+
+		for (int i = 0; i < 4; i++, bit++) {
+			if (current & (1 << i)) {
+				if (bit >= nbits)
+					goto fail;
+				if (start < 0)
+					start = bit;
+			} else if (start >= 0) {
+				bit_inx[pos++] = start;
+				bit_inx[pos++] = bit - 1;
+				start = -1;
+			}
+		}
+	}
+
+	if (start >= 0) {
+		bit_inx[pos++] = start;
+		bit_inx[pos++] = bit - 1;
+	}
+	/* terminate array with -1 */
+	bit_inx[pos] = -1;
+
+	return bit_inx;
+
+fail:
+	xfree(bit_inx);
+	return NULL;
+}
+
 /* If trim_output is true, strip off leading zeros from result. */
 static char *_bit_fmt_hexmask(bitstr_t *bitmap, bool trim_output)
 {
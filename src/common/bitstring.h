@@ -118,6 +118,11 @@ void slurm_bit_free(bitstr_t **b);
 #define bit_realloc(__b, __n) slurm_bit_realloc((bitstr_t **)&(__b), __n)
 bitstr_t *slurm_bit_realloc(bitstr_t **b, bitoff_t nbits);
 
+/* reuse of freed bitstrings, see bitstring.c */
+extern void bit_cache_init(void);
+extern void bit_cache_stats(uint64_t *hits, uint64_t *misses);
+extern void bit_cache_reset_stats(void);
+
 /* new */
 bitoff_t bit_nffs(bitstr_t *b, int32_t n);
 bitoff_t bit_nffc(bitstr_t *b, int32_t n);
@@ -143,6 +148,7 @@ extern int32_t *bitfmt2int(const char *bit_str_ptr);
 char *  inx2bitfmt (int32_t *inx);
 int     inx2bitstr(bitstr_t *b, int32_t *inx);
 int32_t *bitstr2inx(bitstr_t *b);
+int32_t *hexmask2inx(const char *str, bitoff_t nbits);
 char	*bit_fmt_hexmask(bitstr_t *b);
 char    *bit_fmt_hexmask_trim(bitstr_t *b);
 int 	bit_unfmt_hexmask(bitstr_t *b, const char *str);
@@ -43,6 +43,7 @@
 #include "src/common/log.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -50,6 +51,14 @@
 #define DATA_MAGIC 0x1992189F
 #define DATA_LIST_MAGIC 0x1992F89F
 #define DATA_LIST_NODE_MAGIC 0x1921F89F
+/*
+ * Inline string storage in data_t. xmalloc() adds a 16 byte header, which
+ * puts a 16 byte and a 24 byte data_t in the same malloc() chunk size, so
+ * the extra 8 bytes of inline string come for free.
+ */
+#define DATA_STRING_INLINE_SIZE (2 * sizeof(void *))
+/* Index dictionary keys once a dictionary has this many entries */
+#define DATA_DICT_INDEX_MIN 16
 
 typedef struct data_list_s data_list_t;
 typedef struct data_list_node_s data_list_node_t;
@@ -92,7 +101,8 @@ typedef struct data_list_node_s {
 	data_list_node_t *next;
 
 	data_t *data;
-	char *key; /* key for dictionary (only) */
+	char *key; /* key for dictionary (only) - points to key_buf */
+	char key_buf[]; /* key is allocated with the node */
 } data_list_node_t;
 
 /* Single linked list for list_u and dict_u */
@@ -102,6 +112,8 @@ typedef struct data_list_s {
 
 	data_list_node_t *begin;
 	data_list_node_t *end;
+
+	xhash_t *index; /* key index for large dictionaries or NULL */
 } data_list_t;
 
 /*
@@ -119,7 +131,7 @@ struct data_s {
 		data_list_t *list_u;
 		data_list_t *dict_u;
 		int64_t int_u;
-		char string_inline_u[sizeof(void *)];
+		char string_inline_u[DATA_STRING_INLINE_SIZE];
 		char *string_ptr_u;
 		double float_u;
 		bool bool_u;
@@ -256,8 +268,9 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 	}
 
 	dl->count--;
+	if (dl->index && dn->key)
+		xhash_pop_str(dl->index, dn->key);
 	FREE_NULL_DATA(dn->data);
-	xfree(dn->key);
 
 	dn->magic = ~DATA_LIST_NODE_MAGIC;
 	xfree(dn);
@@ -296,6 +309,7 @@ static void _release_data_list(data_list_t *dl)
 #endif
 
 finish:
+	xhash_free(dl->index);
 	dl->magic = ~DATA_LIST_MAGIC;
 	xfree(dl);
 }
@@ -303,18 +317,20 @@ finish:
 /*
  * Create new data list node entry
  * IN d - data type to take ownership of
- * IN key - dictionary key to dup or NULL
+ * IN key - dictionary key to copy into node or NULL
  */
 static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
 {
-	data_list_node_t *dn = xmalloc(sizeof(*dn));
+	const size_t key_bytes = (key ? (strlen(key) + 1) : 0);
+	data_list_node_t *dn = xmalloc(sizeof(*dn) + key_bytes);
 	dn->magic = DATA_LIST_NODE_MAGIC;
 
 	_check_magic(d);
 
 	dn->data = d;
 	if (key) {
-		dn->key = xstrdup(key);
+		memcpy(dn->key_buf, key, key_bytes);
+		dn->key = dn->key_buf;
 
 		log_flag(DATA, "%s: new dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
 			 __func__, (uintptr_t) dn, dn->key, dn->data);
@@ -326,6 +342,59 @@ static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
 	return dn;
 }
 
+static void _dict_node_id(void *item, const char **key, uint32_t *key_len)
+{
+	data_list_node_t *dn = item;
+
+	*key = dn->key;
+	*key_len = strlen(dn->key);
+}
+
+/*
+ * Add dictionary node to key index, creating the index once the dictionary is
+ * large enough that linear searches get expensive. List order is untouched.
+ */
+static void _dict_index_add(data_list_t *dl, data_list_node_t *dn)
+{
+	if (!dn->key)
+		return;
+
+	if (dl->index) {
+		xhash_add(dl->index, dn);
+		return;
+	}
+
+	if (dl->count < DATA_DICT_INDEX_MIN)
+		return;
+
+	dl->index = xhash_init(_dict_node_id, NULL);
+	for (data_list_node_t *i = dl->begin; i; i = i->next)
+		xhash_add(dl->index, i);
+
+	log_flag(DATA, "%s: indexed data-list(0x%"PRIxPTR")[%zu]",
+		 __func__, (uintptr_t) dl, dl->count);
+}
+
+static data_list_node_t *_dict_find_node(const data_list_t *dl,
+					 const char *key)
+{
+	data_list_node_t *i;
+
+	_check_data_list_magic(dl);
+
+	if (dl->index)
+		return xhash_get_str(dl->index, key);
+
+	for (i = dl->begin; i; i = i->next) {
+		_check_data_list_node_magic(i);
+
+		if (!xstrcmp(key, i->key))
+			break;
+	}
+
+	return i;
+}
+
 static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 {
 	data_list_node_t *n = _new_data_list_node(d, key);
@@ -346,6 +415,7 @@ static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_dict_index_add(dl, n);
 
 	if (n->key)
 		log_flag(DATA, "%s: append dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
@@ -372,6 +442,7 @@ static void _data_list_prepend(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_dict_index_add(dl, n);
 
 	log_flag(DATA, "%s: prepend %pD[%s]->data-list-node(0x%"PRIxPTR")[%s]=%pD",
 		 __func__, d, key, (uintptr_t) n, n->key, n->data);
@@ -465,6 +536,8 @@ extern data_t *data_set_float(data_t *data, double value)
 	if (!data)
 		return NULL;
 
+	_release(data);
+
 	data->type = TYPE_FLOAT;
 	data->data.float_u = value;
 
@@ -761,16 +834,7 @@ extern const data_t *data_key_get_const(const data_t *data, const char *key)
 	if (!data->data.dict_u->count)
 		return NULL;
 
-	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
+	i = _dict_find_node(data->data.dict_u, key);
 
 	if (i)
 		return i->data;
@@ -778,15 +842,9 @@ extern const data_t *data_key_get_const(const data_t *data, const char *key)
 		return NULL;
 }
 
-static bool _match_string(const char *key, data_t *data, void *needle_ptr)
-{
-	const char *needle = needle_ptr;
-	return !xstrcmp(key, needle);
-}
-
 extern data_t *data_key_get(data_t *data, const char *key)
 {
-	return data_dict_find_first(data, _match_string, (void *) key);
+	return (data_t *) data_key_get_const(data, key);
 }
 
 extern data_t *data_key_get_int(data_t *data, int64_t key)
@@ -921,16 +979,7 @@ extern bool data_key_unset(data_t *data, const char *key)
 	if (!key || data->type != TYPE_DICT)
 		return NULL;
 
-	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
+	i = _dict_find_node(data->data.dict_u, key);
 
 	if (!i) {
 		log_flag(DATA, "%s: remove non-existent key in %pD[%s]",
@@ -1721,6 +1770,7 @@ static int _convert_data_float_from_string(data_t *data)
 	const char *str = data_get_string(data);
 	int i = 0;
 	bool negative = false;
+	double value;
 
 	xassert(str);
 
@@ -1736,10 +1786,7 @@ static int _convert_data_float_from_string(data_t *data)
 
 		if (!xstrcasecmp(&str[i], "nf") ||
 		    !xstrcasecmp(&str[i], "nfinity")) {
-			if (negative)
-				data_set_float(data, -INFINITY);
-			else
-				data_set_float(data, INFINITY);
+			value = (negative ? -INFINITY : INFINITY);
 
 			goto converted;
 		}
@@ -1751,10 +1798,7 @@ static int _convert_data_float_from_string(data_t *data)
 		i++;
 
 		if (!xstrcasecmp(&str[i], "an")) {
-			if (negative)
-				data_set_float(data, -NAN);
-			else
-				data_set_float(data, NAN);
+			value = (negative ? -NAN : NAN);
 
 			goto converted;
 		}
@@ -1767,9 +1811,7 @@ static int _convert_data_float_from_string(data_t *data)
 		double x;
 
 		if (sscanf(&str[i], "%lf%c", &x, &end) == 1) {
-			if (negative)
-				x *= -1;
-			data_set_float(data, x);
+			value = (negative ? -x : x);
 			goto converted;
 		}
 	}
@@ -1778,7 +1820,9 @@ static int _convert_data_float_from_string(data_t *data)
 
 converted:
 	log_flag(DATA, "%s: converted %pD to float: %s->%lf",
-		 __func__, data, str, data_get_float(data));
+		 __func__, data, str, value);
+	/* str is released here */
+	data_set_float(data, value);
 	return SLURM_SUCCESS;
 
 fail:
@@ -104,7 +104,7 @@ static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
 static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
 					list_t *l);
 static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
-			   eio_obj_t *map[], list_t *objList);
+			   int ready, eio_obj_t *map[], list_t *objList);
 static void _poll_handle_event(short revents, eio_obj_t *obj, list_t *objList);
 
 eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
@@ -275,6 +275,7 @@ int eio_handle_mainloop(eio_handle_t *eio)
 	eio_obj_t    **map     = NULL;
 	unsigned int   maxnfds = 0, nfds = 0;
 	unsigned int   n       = 0;
+	int            ready;
 	time_t shutdown_time;
 
 	xassert (eio != NULL);
@@ -313,14 +314,23 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
 		slurm_mutex_unlock(&eio->shutdown_mutex);
-		if (_poll_internal(pollfds, nfds, shutdown_time) < 0)
+		if ((ready = _poll_internal(pollfds, nfds, shutdown_time)) < 0)
 			goto error;
 
-		/* See if we've been told to shut down by eio_signal_shutdown */
-		if (pollfds[nfds-1].revents & POLLIN)
-			_eio_wakeup_handler(eio);
+		/*
+		 * revents is left unchanged when poll() is interrupted, so only
+		 * look at it when poll() reported ready descriptors.
+		 */
+		if (ready) {
+			/* Told to shut down by eio_signal_shutdown()? */
+			if (pollfds[nfds-1].revents & POLLIN) {
+				_eio_wakeup_handler(eio);
+				ready--;
+			}
 
-		_poll_dispatch(pollfds, nfds - 1, map, eio->obj_list);
+			_poll_dispatch(pollfds, nfds - 1, ready, map,
+				       eio->obj_list);
+		}
 
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
@@ -426,14 +436,15 @@ static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
 	return nfds;
 }
 
+/* Stop scanning pfds once all "ready" descriptors have been handled */
 static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
-			   eio_obj_t *map[], list_t *objList)
+			   int ready, eio_obj_t *map[], list_t *objList)
 {
-	int i;
-
-	for (i = 0; i < nfds; i++) {
-		if (pfds[i].revents > 0)
+	for (int i = 0; (i < nfds) && (ready > 0); i++) {
+		if (pfds[i].revents > 0) {
 			_poll_handle_event(pfds[i].revents, map[i], objList);
+			ready--;
+		}
 	}
 }
 
@@ -57,9 +57,22 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+#define FWD_FAIL_CNT	64	/* Recently failed forwarders remembered */
+#define FWD_FAIL_TTL	60	/* Seconds to avoid a failed forwarder */
+
+typedef struct {
+	char *name;
+	time_t time;
+} fwd_fail_t;
+
 static slurm_node_alias_addrs_t *last_alias_addrs = NULL;
 static pthread_mutex_t alias_addrs_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static fwd_fail_t fwd_fail[FWD_FAIL_CNT];
+static int fwd_fail_next = 0;
+static int fwd_fail_used = 0;
+static pthread_mutex_t fwd_fail_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 typedef struct {
 	pthread_cond_t *notify;
 	int            *p_thr_count;
@@ -68,6 +81,8 @@ typedef struct {
 	int timeout;
 	hostlist_t *tree_hl;
 	pthread_mutex_t *tree_mutex;
+	msg_bufs_t *shared_bufs;
+	time_t shared_time;
 } fwd_tree_t;
 
 static void _start_msg_tree_internal(hostlist_t *hl, hostlist_t **sp_hl,
@@ -96,6 +111,86 @@ void _destroy_tree_fwd(fwd_tree_t *fwd_tree)
 	}
 }
 
+/* Remember that name failed to relay a message. */
+static void _fwd_fail_record(const char *name)
+{
+	time_t now = time(NULL);
+	fwd_fail_t *slot = NULL;
+
+	slurm_mutex_lock(&fwd_fail_mutex);
+	for (int i = 0; i < fwd_fail_used; i++) {
+		if (!xstrcmp(fwd_fail[i].name, name)) {
+			slot = &fwd_fail[i];
+			break;
+		}
+	}
+	if (!slot) {
+		slot = &fwd_fail[fwd_fail_next];
+		fwd_fail_next = (fwd_fail_next + 1) % FWD_FAIL_CNT;
+		fwd_fail_used = MAX(fwd_fail_used, fwd_fail_next);
+		if (fwd_fail_next == 0)
+			fwd_fail_used = FWD_FAIL_CNT;
+		xfree(slot->name);
+		slot->name = xstrdup(name);
+	}
+	slot->time = now;
+	slurm_mutex_unlock(&fwd_fail_mutex);
+}
+
+/* Forget a prior failure of name once it relays successfully. */
+static void _fwd_fail_clear(const char *name)
+{
+	slurm_mutex_lock(&fwd_fail_mutex);
+	for (int i = 0; i < fwd_fail_used; i++) {
+		if (!xstrcmp(fwd_fail[i].name, name)) {
+			fwd_fail[i].time = 0;
+			break;
+		}
+	}
+	slurm_mutex_unlock(&fwd_fail_mutex);
+}
+
+/* Call with fwd_fail_mutex locked */
+static bool _fwd_fail_recent(const char *name, time_t now)
+{
+	for (int i = 0; i < fwd_fail_used; i++) {
+		if (!xstrcmp(fwd_fail[i].name, name))
+			return ((now - fwd_fail[i].time) < FWD_FAIL_TTL);
+	}
+	return false;
+}
+
+/*
+ * The first host of each sublist relays the message to the rest of it. Move
+ * hosts which recently failed to do so to the end of the sublist so that a
+ * dead forwarder does not cost the whole branch a connection timeout.
+ */
+static void _avoid_failed_forwarders(hostlist_t *hl)
+{
+	time_t now;
+	int cnt;
+
+	if (!hl || ((cnt = hostlist_count(hl)) < 2))
+		return;
+
+	now = time(NULL);
+	slurm_mutex_lock(&fwd_fail_mutex);
+	for (int i = 0; fwd_fail_used && (i < (cnt - 1)); i++) {
+		char *name = hostlist_nth(hl, 0);
+
+		if (!_fwd_fail_recent(name, now)) {
+			free(name);
+			break;
+		}
+		log_flag(ROUTE, "%s: skipping recently failed forwarder %s",
+			 __func__, name);
+		hostlist_delete_nth(hl, 0);
+		hostlist_push_host(hl, name);
+		free(name);
+	}
+	slurm_mutex_unlock(&fwd_fail_mutex);
+}
+
 static int _forward_get_addr(forward_struct_t *fwd_struct, char *name,
 			     slurm_addr_t *address)
 {
@@ -144,6 +239,7 @@ static void *_forward_thread(void *arg)
 		if ((fd = slurm_open_msg_conn(&addr)) < 0) {
 			error("%s: failed to %s (%pA): %m",
 			      __func__, name, &addr);
+			_fwd_fail_record(name);
 
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
 			mark_as_failed_forward(
@@ -208,6 +304,7 @@ static void *_forward_thread(void *arg)
 				     get_buf_data(buffer),
 				     get_buf_offset(buffer)) < 0) {
 			error("%s: slurm_msg_sendto: %m", __func__);
+			_fwd_fail_record(name);
 
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
 			mark_as_failed_forward(&fwd_struct->ret_list, name,
@@ -274,6 +371,8 @@ static void *_forward_thread(void *arg)
 
 		if (!ret_list || (fwd_msg->header.forward.cnt != 0
 				  && list_count(ret_list) <= 1)) {
+			if (fwd_msg->header.forward.cnt)
+				_fwd_fail_record(name);
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
 			mark_as_failed_forward(&fwd_struct->ret_list, name,
 					       errno);
@@ -288,8 +387,13 @@ static void *_forward_thread(void *arg)
 				continue;
 			}
 			goto cleanup;
-		} else if ((fwd_msg->header.forward.cnt + 1) !=
-			   list_count(ret_list)) {
+		}
+
+		if (fwd_msg->header.forward.cnt)
+			_fwd_fail_clear(name);
+
+		if ((fwd_msg->header.forward.cnt + 1) !=
+		    list_count(ret_list)) {
 			/* this should never be called since the above
 			   should catch the failed forwards and pipe
 			   them back down, but this is here so we
@@ -434,6 +538,17 @@ static void *_fwd_tree_thread(void *arg)
 		send_msg.forward.tree_width =
 			fwd_tree->orig_msg->forward.tree_width;
 		send_msg.forward.timeout = fwd_tree->timeout;
+
+		/*
+		 * Reuse the body and auth credential packed once in
+		 * start_msg_tree() unless the credential is getting old, in
+		 * which case pack and sign the message again.
+		 */
+		if (fwd_tree->shared_bufs &&
+		    (difftime(time(NULL), fwd_tree->shared_time) < 60))
+			send_msg.shared_bufs = fwd_tree->shared_bufs;
+		else
+			send_msg.shared_bufs = NULL;
 		if ((send_msg.forward.cnt = hostlist_count(fwd_tree->tree_hl))){
 			buf = hostlist_ranged_string_xmalloc(
 					fwd_tree->tree_hl);
@@ -453,6 +568,13 @@ static void *_fwd_tree_thread(void *arg)
 
 		ret_list = slurm_send_addr_recv_msgs(&send_msg, name,
 						     fwd_tree->timeout);
+		if (send_msg.forward.cnt) {
+			if (!ret_list || (errno ==
+					  SLURM_COMMUNICATIONS_CONNECTION_ERROR))
+				_fwd_fail_record(name);
+			else
+				_fwd_fail_clear(name);
+		}
 
 		xfree(send_msg.forward.nodelist);
 
@@ -563,6 +685,7 @@ static void _start_msg_tree_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		if (sp_hl) {
 			fwd_tree->tree_hl = sp_hl[j];
 			sp_hl[j] = NULL;
+			_avoid_failed_forwarders(fwd_tree->tree_hl);
 		} else if (hl) {
 			char *name = hostlist_shift(hl);
 			fwd_tree->tree_hl = hostlist_create(name);
@@ -616,6 +739,7 @@ static void _forward_msg_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		fwd_msg->header.ret_cnt = 0;
 
 		if (sp_hl) {
+			_avoid_failed_forwarders(sp_hl[j]);
 			buf = hostlist_ranged_string_xmalloc(sp_hl[j]);
 			hostlist_destroy(sp_hl[j]);
 		} else {
@@ -792,6 +916,39 @@ static void _get_dynamic_addrs(hostlist_t *hl, slurm_msg_t *msg)
 	slurm_mutex_unlock(&alias_addrs_mutex);
 }
 
+/*
+ * Pack the message body and auth credential once for every branch of the
+ * tree. Only the header, which carries each branch's forward list, differs
+ * between the messages sent by the _fwd_tree_thread()s.
+ */
+static void _pack_shared_bufs(slurm_msg_t *msg, fwd_tree_t *fwd_tree,
+			      msg_bufs_t *buffers)
+{
+	slurm_msg_t pack_msg;
+
+	/* Compressed bodies depend on the peer, do not share them */
+	if (!msg->restrict_uid_set || (msg->flags & SLURM_MSG_ACCEPT_LZ4))
+		return;
+
+	slurm_msg_t_init(&pack_msg);
+	pack_msg.msg_type = msg->msg_type;
+	pack_msg.flags = msg->flags;
+	pack_msg.data = msg->data;
+	pack_msg.protocol_version = msg->protocol_version;
+	slurm_msg_set_r_uid(&pack_msg, msg->restrict_uid);
+
+	if (slurm_buffers_pack_msg(&pack_msg, buffers, false)) {
+		FREE_NULL_BUFFER(buffers->header);
+		FREE_NULL_BUFFER(buffers->auth);
+		FREE_NULL_BUFFER(buffers->body);
+		return;
+	}
+	FREE_NULL_BUFFER(buffers->header);
+
+	fwd_tree->shared_bufs = buffers;
+	fwd_tree->shared_time = time(NULL);
+}
+
 /*
  * start_msg_tree  - logic to begin the forward tree and
  *                   accumulate the return codes from processes getting the
@@ -815,6 +972,7 @@ extern list_t *start_msg_tree(hostlist_t *hl, slurm_msg_t *msg, int timeout)
 	int host_count = 0;
 	hostlist_t **sp_hl;
 	int hl_count = 0;
+	msg_bufs_t shared_bufs = { 0 };
 
 	xassert(hl);
 	xassert(msg);
@@ -843,6 +1001,9 @@ extern list_t *start_msg_tree(hostlist_t *hl, slurm_msg_t *msg, int timeout)
 	fwd_tree.p_thr_count = &thr_count;
 	fwd_tree.tree_mutex = &tree_mutex;
 
+	if (hl_count > 1)
+		_pack_shared_bufs(msg, &fwd_tree, &shared_bufs);
+
 	_start_msg_tree_internal(NULL, sp_hl, &fwd_tree, hl_count);
 
 	xfree(sp_hl);
@@ -863,6 +1024,9 @@ extern list_t *start_msg_tree(hostlist_t *hl, slurm_msg_t *msg, int timeout)
 	slurm_mutex_destroy(&tree_mutex);
 	slurm_cond_destroy(&notify);
 
+	FREE_NULL_BUFFER(shared_bufs.auth);
+	FREE_NULL_BUFFER(shared_bufs.body);
+
 	return ret_list;
 }
 
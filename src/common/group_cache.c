@@ -44,28 +44,45 @@
  *   is -1 for not enough space, and we will xrealloc to handle this.
  *   In practice, if the name service cannot resolve a given user ID you will
  *   get an array back with a single element equal to the gid passed in.
+ * - Entries are indexed by uid in a hash table. The list is kept to own the
+ *   entries and to walk them on cleanup.
+ * - Name service lookups are done without holding gids_mutex, so a slow
+ *   LDAP/SSSD lookup for one user does not block lookups for every other.
+ * - Failed lookups are cached for a short time (negative caching) to avoid
+ *   hammering the name service for an unresolvable uid.
+ * - In slurmctld and slurmd, entries used during the last quarter of their
+ *   lifetime are refreshed ahead of expiry by a background thread, so users
+ *   that are actively launching jobs never wait on the name service.
  */
 
 #include <grp.h>
 
 #include "src/common/group_cache.h"
 #include "src/common/list.h"
+#include "src/common/macros.h"
 #include "src/common/read_config.h"
+#include "src/common/run_in_daemon.h"
 #include "src/common/timers.h"
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
 /* how many groups to use by default to avoid repeated calls to getgrouplist */
 #define NGROUPS_START 64
+/* max seconds to remember that a uid could not be resolved */
+#define NEGATIVE_CACHE_TIME 30
+/* max concurrent background refreshes */
+#define MAX_REFRESH_THREADS 4
 
 typedef struct gids_cache {
 	uid_t uid;
 	gid_t gid;
 	char *username;
-	int ngids;
+	int ngids;		/* 0 for a negative entry */
 	gid_t *gids;
 	time_t expiration;
+	bool refreshing;	/* background refresh in progress */
 } gids_cache_t;
 
 typedef struct gids_cache_needle {
@@ -76,6 +93,8 @@ typedef struct gids_cache_needle {
 
 static pthread_mutex_t gids_mutex = PTHREAD_MUTEX_INITIALIZER;
 static List gids_cache_list = NULL;
+static xhash_t *gids_cache_hash = NULL;
+static int refresh_thread_cnt = 0;
 
 static void _group_cache_list_delete(void *x)
 {
@@ -85,82 +104,61 @@ static void _group_cache_list_delete(void *x)
 	xfree(entry);
 }
 
+static void _group_cache_hash_id(void *item, const char **key,
+				 uint32_t *key_len)
+{
+	gids_cache_t *entry = item;
+
+	*key = (const char *) &entry->uid;
+	*key_len = sizeof(entry->uid);
+}
+
 /* call on daemon shutdown to cleanup properly */
 void group_cache_purge(void)
 {
 	slurm_mutex_lock(&gids_mutex);
+	xhash_free(gids_cache_hash);
 	FREE_NULL_LIST(gids_cache_list);
 	slurm_mutex_unlock(&gids_mutex);
 }
 
-static int _find_entry(void *x, void *key)
+/* Must be called with gids_mutex held */
+static gids_cache_t *_find_entry(uid_t uid)
 {
-	gids_cache_t *entry = (gids_cache_t *) x;
-	gids_cache_needle_t *needle = (gids_cache_needle_t *) key;
+	if (!gids_cache_hash)
+		return NULL;
 
-	return (needle->uid == entry->uid);
+	return xhash_get(gids_cache_hash, (const char *) &uid, sizeof(uid));
 }
 
 /*
- * This populates a new entry (or re-populates an old entry) using getpwuid_r()
- * to determine the primary group. getpwuid_r() should be used here instead of
- * the job's group to handle when the job was submited with a secondary group.
+ * Resolve the primary group, username and extended groups of a uid from the
+ * name service. getpwuid_r() should be used here instead of the job's group
+ * to handle when the job was submited with a secondary group.
+ *
+ * This is the slow part of a cache miss and must be called without holding
+ * gids_mutex.
  *
- * On failure of getpwuid_r(), we will fallback to the job's group since it is
- * the only "safe" group we can determine.
+ * IN: uid
+ * IN: size_hint - initial size of the gids array
+ * OUT: result - gid, username, ngids and gids are filled in
+ * RET: false if getpwuid_r() failed (nothing to free in result)
  */
-static void _init_or_reinit_entry(gids_cache_t **in,
-				  gids_cache_needle_t *needle)
+static bool _lookup_groups(uid_t uid, int size_hint, gids_cache_t *result)
 {
 	char buffer[PW_BUF_SIZE];
-	gids_cache_t *entry;
-	struct passwd pwd, *result;
+	struct passwd pwd, *pw;
 	int rc;
 
-	xassert(needle);
-
-	rc = slurm_getpwuid_r(needle->uid, &pwd, buffer, PW_BUF_SIZE, &result);
-	if (!result || !result->pw_name) {
-		if (!result && !rc)
+	rc = slurm_getpwuid_r(uid, &pwd, buffer, PW_BUF_SIZE, &pw);
+	if (!pw || !pw->pw_name) {
+		if (!pw && !rc)
 			error("%s: getpwuid_r(%u): no record found",
-			      __func__, needle->uid);
+			      __func__, uid);
 		else
 			error("%s: getpwuid_r(%u): %s",
-			      __func__, needle->uid, strerror(rc));
-
-		if (*in) {
-			/* discard this now-invalid cache entry */
-			list_delete_ptr(gids_cache_list, *in);
-			*in = NULL;
-		}
-
-		return;
-	}
-
-	if (*in) {
-		/*
-		 * Reusing the existing cache record. Reset ngids to the
-		 * current buffer size to avoid needing to loop around
-		 * on getgrouplist() to determine the correct size.
-		 */
-		entry = *in;
-		entry->ngids = xsize(entry->gids) / sizeof(gid_t);
-
-		if (xstrcmp(entry->username, result->pw_name)) {
-			error("Cached username %s did not match queried username %s?",
-			      entry->username, result->pw_name);
-			xfree(entry->username);
-		}
-
-		if (entry->gid != result->pw_gid)
-			debug("Cached user=%s changed primary gid from %u to %u?",
-			      result->pw_name, entry->gid, result->pw_gid);
-	} else {
-		/* Brand new entry */
-		entry = xmalloc(sizeof(*entry));
-		entry->uid = needle->uid;
-		entry->ngids = NGROUPS_START;
-		entry->gids = xcalloc(NGROUPS_START, sizeof(gid_t));
+			      __func__, uid, strerror(rc));
+		return false;
 	}
 
 	/*
@@ -171,18 +169,151 @@ static void _init_or_reinit_entry(gids_cache_t **in,
 	 * where the extended group membership does not explicitly include the
 	 * primary gid.
 	 */
-	entry->gid = result->pw_gid;
+	result->gid = pw->pw_gid;
+	result->username = xstrdup(pw->pw_name);
+	result->ngids = MAX(size_hint, NGROUPS_START);
+	result->gids = xcalloc(result->ngids, sizeof(gid_t));
 
-	/* Reuse cached value if possible to skip an xstrdup() */
-	if (!entry->username)
-		entry->username = xstrdup(result->pw_name);
+#if defined(__APPLE__)
+	/*
+	 * macOS has (int *) for the third argument instead
+	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
+	 */
+	while (getgrouplist(result->username, result->gid,
+			    (int *)result->gids, &result->ngids) == -1) {
+#else
+	/*
+	 * result->gid will be in the result. This is the users primary
+	 * group as determined from passwd.
+	 */
+	while (getgrouplist(result->username, result->gid,
+			    result->gids, &result->ngids) == -1) {
+#endif
+		/* group list larger than array, resize array to fit */
+		result->gids = xrecalloc(result->gids, result->ngids,
+					 sizeof(gid_t));
+	}
 
-	entry->expiration = time(NULL) + slurm_conf.group_time;
+	return true;
+}
+
+/*
+ * Store the result of _lookup_groups() in the cache, creating the entry if
+ * needed. Must be called with gids_mutex held.
+ *
+ * IN: uid
+ * IN/OUT: fresh - values are moved into the cache entry
+ * IN: found - return value of _lookup_groups()
+ * IN: refresh - called from a background refresh, failed lookups then keep
+ *	the existing values until they expire instead of caching the failure
+ * RET: cache entry or NULL if the cache was purged during a refresh
+ */
+static gids_cache_t *_update_entry(uid_t uid, gids_cache_t *fresh, bool found,
+				   bool refresh)
+{
+	gids_cache_t *entry = _find_entry(uid);
 
-	if (!*in) {
-		*in = entry;
+	if (!entry) {
+		if (refresh && !gids_cache_list) {
+			/* group_cache_purge() was called in the meantime */
+			xfree(fresh->gids);
+			xfree(fresh->username);
+			return NULL;
+		}
+
+		if (!gids_cache_list)
+			gids_cache_list = list_create(_group_cache_list_delete);
+		if (!gids_cache_hash)
+			gids_cache_hash = xhash_init(_group_cache_hash_id,
+						     NULL);
+
+		entry = xmalloc(sizeof(*entry));
+		entry->uid = uid;
 		list_prepend(gids_cache_list, entry);
+		xhash_add(gids_cache_hash, entry);
 	}
+
+	if (refresh)
+		entry->refreshing = false;
+
+	if (!found) {
+		if (refresh && entry->ngids)
+			return entry;
+
+		/* discard the now-invalid values, remember the failure */
+		xfree(entry->gids);
+		xfree(entry->username);
+		entry->ngids = 0;
+		entry->expiration = time(NULL) +
+			MIN(slurm_conf.group_time, NEGATIVE_CACHE_TIME);
+		return entry;
+	}
+
+	if (entry->username && xstrcmp(entry->username, fresh->username))
+		error("Cached username %s did not match queried username %s?",
+		      entry->username, fresh->username);
+
+	if (entry->ngids && (entry->gid != fresh->gid))
+		debug("Cached user=%s changed primary gid from %u to %u?",
+		      fresh->username, entry->gid, fresh->gid);
+
+	xfree(entry->gids);
+	xfree(entry->username);
+	entry->gid = fresh->gid;
+	entry->username = fresh->username;
+	entry->ngids = fresh->ngids;
+	entry->gids = fresh->gids;
+	entry->expiration = time(NULL) + slurm_conf.group_time;
+
+	fresh->username = NULL;
+	fresh->gids = NULL;
+
+	return entry;
+}
+
+static void *_refresh_entry(void *arg)
+{
+	uid_t *uid = arg;
+	gids_cache_t fresh = { 0 };
+	bool found;
+
+	found = _lookup_groups(*uid, NGROUPS_START, &fresh);
+
+	slurm_mutex_lock(&gids_mutex);
+	if (_update_entry(*uid, &fresh, found, true))
+		debug2("%s: refreshed entry for uid=%u", __func__, *uid);
+	refresh_thread_cnt--;
+	slurm_mutex_unlock(&gids_mutex);
+
+	xfree(uid);
+	return NULL;
+}
+
+/*
+ * Refresh a valid entry in the background if it is about to expire.
+ * Must be called with gids_mutex held.
+ */
+static void _refresh_ahead(gids_cache_t *entry, time_t now)
+{
+	uid_t *uid;
+
+	if (entry->refreshing || !entry->ngids ||
+	    (refresh_thread_cnt >= MAX_REFRESH_THREADS) ||
+	    ((entry->expiration - now) > (slurm_conf.group_time / 4)))
+		return;
+
+	/*
+	 * Only the long-running daemons benefit from this, and other
+	 * processes may fork while the thread holds name service locks.
+	 */
+	if (!running_in_slurmctld() && !running_in_slurmd())
+		return;
+
+	entry->refreshing = true;
+	refresh_thread_cnt++;
+	uid = xmalloc(sizeof(*uid));
+	*uid = entry->uid;
+	slurm_thread_create_detached(_refresh_entry, uid);
 }
 
 /*
@@ -193,77 +324,64 @@ static void _init_or_reinit_entry(gids_cache_t **in,
  */
 static int _group_cache_lookup_internal(gids_cache_needle_t *needle, gid_t **gids)
 {
-	gids_cache_t *entry;
+	gids_cache_t *entry, fresh = { 0 };
 	int ngids; /* need a copy to safely return outside the lock */
+	int size_hint = NGROUPS_START;
+	time_t now = time(NULL);
+	bool found;
 	DEF_TIMERS;
 	START_TIMER;
 
 	slurm_mutex_lock(&gids_mutex);
-	if (!gids_cache_list)
-		gids_cache_list = list_create(_group_cache_list_delete);
+	entry = _find_entry(needle->uid);
 
-	entry = list_find_first(gids_cache_list, _find_entry, needle);
-
-	if (entry && (entry->expiration > time(NULL))) {
-		debug2("%s: found valid entry for user=%s",
-		       __func__, entry->username);
+	if (entry && (entry->expiration > now)) {
+		debug2("%s: found valid entry for uid=%u",
+		       __func__, entry->uid);
+		_refresh_ahead(entry, now);
 		goto out;
 	}
 
 	if (entry) {
-		/* The timestamp is too old, need to replace the values. */
+		/*
+		 * The timestamp is too old, need to replace the values.
+		 * Start from the current buffer size to avoid needing to loop
+		 * around on getgrouplist() to determine the correct size.
+		 */
 		debug2("%s: found old entry for uid=%u, refreshing",
 		       __func__, entry->uid);
+		if (entry->gids)
+			size_hint = xsize(entry->gids) / sizeof(gid_t);
 	} else {
 		debug2("%s: no entry found for uid=%u", __func__, needle->uid);
 	}
+	slurm_mutex_unlock(&gids_mutex);
 
-	_init_or_reinit_entry(&entry, needle);
-
-	if (!entry) {
+	/* Cache lookup failed or entry value was too old, fetch new value. */
+	found = _lookup_groups(needle->uid, size_hint, &fresh);
+	if (!found)
 		error("failed to init group cache entry for uid=%u",
 		      needle->uid);
 
+	slurm_mutex_lock(&gids_mutex);
+	entry = _update_entry(needle->uid, &fresh, found, false);
+
+out:
+	xfree(*gids);
+	if (!entry->ngids) {
 		/*
 		 * getgrouplist() does not have a way to signal failure, so
 		 * return the primary group as the single member of the
 		 * extended group list.
 		 */
+		ngids = 1;
 		*gids = xmalloc(sizeof(gid_t));
-		*gids[0] = needle->gid;
-		slurm_mutex_unlock(&gids_mutex);
-		return 1;
-	}
-
-	/*
-	 * Cache lookup failed or entry value was too old, fetch new value and
-	 * insert it into cache.
-	 */
-#if defined(__APPLE__)
-	/*
-	 * macOS has (int *) for the third argument instead
-	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
-	 */
-	while (getgrouplist(entry->username, entry->gid,
-			    (int *)entry->gids, &entry->ngids) == -1) {
-#else
-	/*
-	 * entry->gid will be in the result. This is the users primary
-	 * group as determined from passwd.
-	 */
-	while (getgrouplist(entry->username, entry->gid,
-			    entry->gids, &entry->ngids) == -1) {
-#endif
-		/* group list larger than array, resize array to fit */
-		entry->gids = xrecalloc(entry->gids, entry->ngids,
-					sizeof(gid_t));
+		(*gids)[0] = needle->gid;
+	} else {
+		ngids = entry->ngids;
+		*gids = copy_gids(entry->ngids, entry->gids);
 	}
 
-out:
-	ngids = entry->ngids;
-	xfree(*gids);
-	*gids = copy_gids(entry->ngids, entry->gids);
-
 	slurm_mutex_unlock(&gids_mutex);
 
 	END_TIMER3("group_cache_lookup() took",
@@ -295,10 +413,12 @@ static int _cleanup_search(void *x, void *key)
 	gids_cache_t *cached = (gids_cache_t *) x;
 	time_t *now = (time_t *) key;
 
-	if (cached->expiration < *now)
-		return 1;
+	if (cached->refreshing || (cached->expiration >= *now))
+		return 0;
 
-	return 0;
+	xhash_delete(gids_cache_hash, (const char *) &cached->uid,
+		     sizeof(cached->uid));
+	return 1;
 }
 
 /*
@@ -2183,6 +2183,27 @@ done:
 	return ret;
 }
 
+int hostlist_for_each_range(hostlist_t *hl, hostlist_range_f f, void *arg)
+{
+	int rc = 0;
+
+	if (!hl)
+		return 0;
+
+	LOCK_HOSTLIST(hl);
+	for (int i = 0; i < hl->nranges; i++) {
+		hostrange_t *hr = hl->hr[i];
+
+		if ((rc = f(hr->prefix, hr->lo, hr->hi, hr->width,
+			    hr->singlehost, arg)) < 0)
+			break;
+		rc = 0;
+	}
+	UNLOCK_HOSTLIST(hl);
+
+	return rc;
+}
+
 int hostlist_find(hostlist_t *hl, const char *hostname)
 {
 
@@ -3287,6 +3308,63 @@ done:
 	return retval;
 }
 
+/*
+ * Return 1 if range hr shares at least one host (or, with cover set, all of
+ * its hosts) with a single range of the set, comparing the ranges directly
+ * instead of expanding hr into hostnames.
+ * Ranges which only match after hostrange_hn_within() adjusts a hostname's
+ * prefix are not detected here, so a return of 0 is not conclusive.
+ * Assumes that the set->hl lock is already held.
+ */
+static int _hostset_match_range(hostset_t *set, hostrange_t *hr, bool cover)
+{
+	for (int i = 0; i < set->hl->nranges; i++) {
+		hostrange_t *sr = set->hl->hr[i];
+
+		if ((sr->singlehost != hr->singlehost) ||
+		    strcmp(sr->prefix, hr->prefix))
+			continue;
+		if (hr->singlehost)
+			return 1;
+		if (sr->width != hr->width)
+			continue;
+		if (cover && (sr->lo <= hr->lo) && (hr->hi <= sr->hi))
+			return 1;
+		if (!cover && (sr->lo <= hr->hi) && (hr->lo <= sr->hi))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Remove from hl every range lying entirely within one range of the set.
+ * RET number of hosts removed
+ */
+static int _hostset_remove_covered(hostset_t *set, hostlist_t *hl)
+{
+	int i, j = 0, removed = 0;
+
+	LOCK_HOSTLIST(set->hl);
+	for (i = 0; i < hl->nranges; i++) {
+		hostrange_t *hr = hl->hr[i];
+
+		if (_hostset_match_range(set, hr, true)) {
+			removed += hostrange_count(hr);
+			hostrange_destroy(hr);
+		} else {
+			hl->hr[j++] = hr;
+		}
+	}
+	for (i = j; i < hl->nranges; i++)
+		hl->hr[i] = NULL;
+	hl->nranges = j;
+	hl->nhosts -= removed;
+	UNLOCK_HOSTLIST(set->hl);
+
+	return removed;
+}
+
 int hostset_intersects(hostset_t *set, const char *hosts)
 {
 	int retval = 0;
@@ -3295,7 +3373,18 @@ int hostset_intersects(hostset_t *set, const char *hosts)
 
 	xassert(set->hl->magic == HOSTLIST_MAGIC);
 
-	hl = hostlist_create(hosts);
+	if (!(hl = hostlist_create(hosts)))
+		return 0;
+
+	LOCK_HOSTLIST(set->hl);
+	for (int i = 0; !retval && (i < hl->nranges); i++)
+		retval = _hostset_match_range(set, hl->hr[i], false);
+	UNLOCK_HOSTLIST(set->hl);
+	if (retval) {
+		hostlist_destroy(hl);
+		return retval;
+	}
+
 	while ((hostname = hostlist_pop(hl)) != NULL) {
 		retval += hostset_find_host(set, hostname);
 		free(hostname);
@@ -3319,7 +3408,8 @@ int hostset_within(hostset_t *set, const char *hosts)
 	if (!(hl = hostlist_create(hosts)))
 		return (0);
 	nhosts = hostlist_count(hl);
-	nfound = 0;
+	/* Only expand the ranges not covered as a whole by the set */
+	nfound = _hostset_remove_covered(set, hl);
 
 	while ((hostname = hostlist_pop(hl)) != NULL) {
 		nfound += hostset_find_host(set, hostname);
@@ -288,6 +288,25 @@ void hostlist_sort(hostlist_t *hl);
  */
 void hostlist_uniq(hostlist_t *hl);
 
+/* hostlist_for_each_range():
+ *
+ * Call f() once for each range of hosts in hostlist hl, without expanding
+ * the range into hostnames. For a numeric range, the hosts are prefix
+ * followed by each number from lo to hi zero padded to width digits. A host
+ * without a numeric suffix is passed with singlehost set and name prefix.
+ * The hostlist is locked while f() runs, so f() must not use hl.
+ *
+ * Only meaningful for single dimension hostlists, where the suffix is a
+ * decimal number.
+ *
+ * Iteration stops if f() returns a negative value, which is then returned.
+ * Otherwise returns 0.
+ */
+typedef int (*hostlist_range_f)(const char *prefix, unsigned long lo,
+				unsigned long hi, int width, int singlehost,
+				void *arg);
+int hostlist_for_each_range(hostlist_t *hl, hostlist_range_f f, void *arg);
+
 /* Return the base used for encoding numeric hostlist suffixes */
 #define hostlist_get_base(_dimensions) ((_dimensions) > 1 ? 36 : 10)
 
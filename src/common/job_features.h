@@ -61,6 +61,10 @@ typedef struct {
 	uint8_t op_code;		/* separator, see FEATURE_OP_ above */
 	bitstr_t *node_bitmap_active;	/* nodes with this feature active */
 	bitstr_t *node_bitmap_avail;	/* nodes with this feature available */
+	uint64_t node_bitmap_gen;	/* feature_list_gen the bitmaps were
+					 * built from, 0 if never built */
+	bool node_bitmap_reboot;	/* node_bitmap_avail built with
+					 * can_reboot set */
 	uint16_t paren;			/* count of enclosing parenthesis */
 } job_feature_t;
 
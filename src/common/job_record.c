@@ -36,6 +36,7 @@
 #include "src/common/port_mgr.h"
 #include "src/common/assoc_mgr.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/xhash.h"
 
 #include "src/interfaces/jobacct_gather.h"
 #include "src/interfaces/gres.h"
@@ -53,6 +54,15 @@ typedef struct {
 	int node_count;
 } node_inx_cnt_t;
 
+typedef struct {
+	char *str;
+	uint32_t ref_cnt;
+} job_str_t;
+
+/* See job_record_str_intern(), entries keyed by their string */
+static xhash_t *job_str_table = NULL;
+static pthread_mutex_t job_str_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 extern job_record_t *job_record_create(void)
 {
 	job_record_t *job_ptr = xmalloc(sizeof(*job_ptr));
@@ -139,14 +149,123 @@ static void _clear_job_gres_details(job_record_t *job_ptr)
 	job_ptr->gres_detail_cnt = 0;
 }
 
+/* Drop this record's reference to argv, env_sup and submit_line */
+static void _release_job_details_args(job_details_t *details)
+{
+	if (details->args_ref_cnt && (--(*details->args_ref_cnt) > 0)) {
+		/* Still referenced by other tasks of the job array */
+		details->args_ref_cnt = NULL;
+		details->argv = NULL;
+		details->argc = 0;
+		details->env_sup = NULL;
+		details->env_cnt = 0;
+		details->submit_line = NULL;
+		return;
+	}
+
+	xfree(details->args_ref_cnt);
+	for (int i = 0; i < details->argc; i++)
+		xfree(details->argv[i]);
+	xfree(details->argv);
+	details->argc = 0;
+	for (int i = 0; i < details->env_cnt; i++)
+		xfree(details->env_sup[i]);
+	xfree(details->env_sup);
+	details->env_cnt = 0;
+	xfree(details->submit_line);
+}
+
+extern void job_details_share_args(job_details_t *dest, job_details_t *src)
+{
+	if (!src->args_ref_cnt) {
+		src->args_ref_cnt = xmalloc(sizeof(*src->args_ref_cnt));
+		*src->args_ref_cnt = 1;
+	}
+	(*src->args_ref_cnt)++;
+
+	dest->args_ref_cnt = src->args_ref_cnt;
+	dest->argc = src->argc;
+	dest->argv = src->argv;
+	dest->env_cnt = src->env_cnt;
+	dest->env_sup = src->env_sup;
+	dest->submit_line = src->submit_line;
+}
+
+static void _job_str_id(void *item, const char **key, uint32_t *key_len)
+{
+	job_str_t *entry = item;
+
+	*key = entry->str;
+	*key_len = strlen(entry->str);
+}
+
+static void _job_str_free(void *item)
+{
+	job_str_t *entry = item;
+
+	xfree(entry->str);
+	xfree(entry);
+}
+
+extern char *job_record_str_intern(const char *str)
+{
+	job_str_t *entry;
+
+	if (!str)
+		return NULL;
+
+	slurm_mutex_lock(&job_str_mutex);
+	if (!job_str_table)
+		job_str_table = xhash_init(_job_str_id, _job_str_free);
+	if (!(entry = xhash_get_str(job_str_table, str))) {
+		entry = xmalloc(sizeof(*entry));
+		entry->str = xstrdup(str);
+		xhash_add(job_str_table, entry);
+	}
+	entry->ref_cnt++;
+	slurm_mutex_unlock(&job_str_mutex);
+
+	return entry->str;
+}
+
+extern void job_record_str_release(char **str_ptr)
+{
+	job_str_t *entry;
+
+	if (!*str_ptr)
+		return;
+
+	slurm_mutex_lock(&job_str_mutex);
+	entry = xhash_get_str(job_str_table, *str_ptr);
+	xassert(entry && (entry->str == *str_ptr));
+	if (entry && !--entry->ref_cnt)
+		xhash_delete_str(job_str_table, *str_ptr);
+	slurm_mutex_unlock(&job_str_mutex);
+
+	*str_ptr = NULL;
+}
+
+/* As safe_unpackstr() but store an interned copy of the string */
+static int _unpackstr_intern(char **str_ptr, buf_t *buffer)
+{
+	char *str = NULL;
+
+	safe_unpackstr(&str, buffer);
+	*str_ptr = job_record_str_intern(str);
+	xfree(str);
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	return SLURM_ERROR;
+}
+
 /*
  * _delete_job_details - delete a job's detail record and clear it's pointer
  * IN job_entry - pointer to job_record to clear the record of
  */
 static void _delete_job_details(job_record_t *job_entry)
 {
-	int i;
-
 	if (job_entry->details == NULL)
 		return;
 
@@ -164,18 +283,13 @@ static void _delete_job_details(job_record_t *job_entry)
 	}
 
 	xfree(job_entry->details->acctg_freq);
-	for (i=0; i<job_entry->details->argc; i++)
-		xfree(job_entry->details->argv[i]);
-	xfree(job_entry->details->argv);
+	_release_job_details_args(job_entry->details);
 	xfree(job_entry->details->cpu_bind);
 	free_cron_entry(job_entry->details->crontab_entry);
 	FREE_NULL_LIST(job_entry->details->depend_list);
 	xfree(job_entry->details->dependency);
 	xfree(job_entry->details->orig_dependency);
 	xfree(job_entry->details->env_hash);
-	for (i=0; i<job_entry->details->env_cnt; i++)
-		xfree(job_entry->details->env_sup[i]);
-	xfree(job_entry->details->env_sup);
 	xfree(job_entry->details->std_err);
 	FREE_NULL_BITMAP(job_entry->details->exc_node_bitmap);
 	xfree(job_entry->details->exc_nodes);
@@ -190,7 +304,6 @@ static void _delete_job_details(job_record_t *job_entry)
 	xfree(job_entry->details->prefer);
 	xfree(job_entry->details->req_context);
 	xfree(job_entry->details->std_out);
-	xfree(job_entry->details->submit_line);
 	FREE_NULL_BITMAP(job_entry->details->req_node_bitmap);
 	xfree(job_entry->details->req_nodes);
 	xfree(job_entry->details->script);
@@ -212,7 +325,7 @@ extern void job_record_delete(void *job_entry)
 	xassert(job_ptr->magic == JOB_MAGIC);
 
 	_delete_job_details(job_ptr);
-	xfree(job_ptr->account);
+	job_record_str_release(&job_ptr->account);
 	xfree(job_ptr->admin_comment);
 	xfree(job_ptr->alias_list);
 	xfree(job_ptr->alloc_node);
@@ -300,8 +413,8 @@ extern void job_record_delete(void *job_entry)
 	xfree(job_ptr->tres_req_str);
 	xfree(job_ptr->tres_fmt_req_str);
 	select_g_select_jobinfo_free(job_ptr->select_jobinfo);
-	xfree(job_ptr->user_name);
-	xfree(job_ptr->wckey);
+	job_record_str_release(&job_ptr->user_name);
+	job_record_str_release(&job_ptr->wckey);
 
 	job_ptr->job_id = 0;
 	/* make sure we don't delete record twice */
@@ -1431,7 +1544,6 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	uint8_t open_mode, overcommit, prolog_running;
 	uint8_t share_res, whole_node, features_use = 0;
 	time_t begin_time, accrue_time = 0, submit_time;
-	int i;
 	List depend_list = NULL;
 	multi_core_data_t *mc_ptr;
 	cron_entry_t *crontab_entry = NULL;
@@ -1600,18 +1712,13 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	/* free any left-over detail data */
 	xfree(job_ptr->details->acctg_freq);
 	xfree(job_ptr->details->arbitrary_tpn);
-	for (i=0; i<job_ptr->details->argc; i++)
-		xfree(job_ptr->details->argv[i]);
-	xfree(job_ptr->details->argv);
+	_release_job_details_args(job_ptr->details);
 	xfree(job_ptr->details->cpu_bind);
 	FREE_NULL_LIST(job_ptr->details->depend_list);
 	xfree(job_ptr->details->dependency);
 	xfree(job_ptr->details->orig_dependency);
 	xfree(job_ptr->details->std_err);
 	xfree(job_ptr->details->env_hash);
-	for (i=0; i<job_ptr->details->env_cnt; i++)
-		xfree(job_ptr->details->env_sup[i]);
-	xfree(job_ptr->details->env_sup);
 	xfree(job_ptr->details->exc_nodes);
 	xfree(job_ptr->details->features);
 	xfree(job_ptr->details->cluster_features);
@@ -1620,7 +1727,6 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	xfree(job_ptr->details->mem_bind);
 	xfree(job_ptr->details->script_hash);
 	xfree(job_ptr->details->std_out);
-	xfree(job_ptr->details->submit_line);
 	xfree(job_ptr->details->req_nodes);
 	xfree(job_ptr->details->work_dir);
 
@@ -1924,10 +2030,13 @@ extern int job_record_unpack(job_record_t **out,
 			goto unpack_error;
 		}
 		safe_unpackstr(&job_ptr->name, buffer);
-		safe_unpackstr(&job_ptr->user_name, buffer);
-		safe_unpackstr(&job_ptr->wckey, buffer);
+		if (_unpackstr_intern(&job_ptr->user_name, buffer))
+			goto unpack_error;
+		if (_unpackstr_intern(&job_ptr->wckey, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->alloc_node, buffer);
-		safe_unpackstr(&job_ptr->account, buffer);
+		if (_unpackstr_intern(&job_ptr->account, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->admin_comment, buffer);
 		safe_unpackstr(&job_ptr->comment, buffer);
 		safe_unpackstr(&job_ptr->extra, buffer);
@@ -2151,10 +2260,13 @@ extern int job_record_unpack(job_record_t **out,
 			goto unpack_error;
 		}
 		safe_unpackstr(&job_ptr->name, buffer);
-		safe_unpackstr(&job_ptr->user_name, buffer);
-		safe_unpackstr(&job_ptr->wckey, buffer);
+		if (_unpackstr_intern(&job_ptr->user_name, buffer))
+			goto unpack_error;
+		if (_unpackstr_intern(&job_ptr->wckey, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->alloc_node, buffer);
-		safe_unpackstr(&job_ptr->account, buffer);
+		if (_unpackstr_intern(&job_ptr->account, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->admin_comment, buffer);
 		safe_unpackstr(&job_ptr->comment, buffer);
 		safe_unpackstr(&job_ptr->extra, buffer);
@@ -2375,10 +2487,13 @@ extern int job_record_unpack(job_record_t **out,
 			goto unpack_error;
 		}
 		safe_unpackstr(&job_ptr->name, buffer);
-		safe_unpackstr(&job_ptr->user_name, buffer);
-		safe_unpackstr(&job_ptr->wckey, buffer);
+		if (_unpackstr_intern(&job_ptr->user_name, buffer))
+			goto unpack_error;
+		if (_unpackstr_intern(&job_ptr->wckey, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->alloc_node, buffer);
-		safe_unpackstr(&job_ptr->account, buffer);
+		if (_unpackstr_intern(&job_ptr->account, buffer))
+			goto unpack_error;
 		safe_unpackstr(&job_ptr->admin_comment, buffer);
 		safe_unpackstr(&job_ptr->comment, buffer);
 		safe_unpackstr(&job_ptr->extra, buffer);
@@ -77,6 +77,9 @@ typedef struct {
 					 * node for arbitrary distribution */
 	uint32_t argc;			/* count of argv elements */
 	char **argv;			/* arguments for a batch job script */
+	uint32_t *args_ref_cnt;		/* reference count if argv, env_sup
+					 * and submit_line are shared by the
+					 * tasks of a job array, else NULL */
 	time_t begin_time;		/* start at this time (srun --begin),
 					 * resets to time first eligible
 					 * (all dependencies satisfied) */
@@ -98,6 +101,8 @@ typedef struct {
 	cron_entry_t *crontab_entry;	/* crontab entry (job submitted through
 					 * scrontab) */
 	uint16_t orig_cpus_per_task;	/* requested value of cpus_per_task */
+	bool depend_settled;		/* depend_list needs no retest until a
+					 * job it depends on changes state */
 	List depend_list;		/* list of job_ptr:state pairs */
 	char *dependency;		/* wait for other jobs */
 	char *orig_dependency;		/* original value (for archiving) */
@@ -242,19 +247,56 @@ typedef struct job_record job_record_t;
 struct job_record {
 	uint32_t magic;			/* magic cookie for data integrity */
 					/* DO NOT ALPHABETIZE */
-	char    *account;		/* account number to charge */
+	/*
+	 * Fields tested by the passes over every job in job_list (job queue
+	 * building, time limits and purging) come first so they share the first
+	 * few cache lines of the record. The rest are in alphabetical order.
+	 */
+	uint32_t job_id;		/* job ID */
+	uint32_t job_state;		/* state of the job */
+	uint32_t priority;		/* relative priority of the job,
+					 * zero == held (don't initiate) */
+	uint32_t state_reason;		/* reason job still pending or failed
+					 * see slurm.h:enum job_state_reason */
+	uint32_t time_limit;		/* time_limit minutes or INFINITE,
+					 * NO_VAL implies partition max_time */
+	uint64_t bit_flags;             /* various job flags */
+	job_record_t *job_next;		/* next entry with same hash index */
+	job_details_t *details;		/* job details */
+	part_record_t *part_ptr;	/* pointer to the partition record */
+	List part_ptr_list;		/* list of pointers to partition recs */
+	job_array_struct_t *array_recs;	/* job array details,
+					 * only in meta-job record */
+	priority_parts_t *part_prio;	/* partition based priority */
+	slurmdb_qos_rec_t *qos_ptr;	/* pointer to the quality of
+					 * service record used for
+					 * this job, confirm the
+					 * value before use */
+	slurmdb_assoc_rec_t *assoc_ptr; /* job's assoc record ptr confirm the
+					 * value before use */
+	slurmctld_resv_t *resv_ptr;	/* reservation structure pointer */
+	List resv_list;                 /* Filled in if the job is requesting
+					 * more than one reservation,
+					 * DON'T PACK. */
+	time_t end_time;		/* time execution ended, actual or
+					 * expected. if terminated from suspend
+					 * state, this is time suspend began */
+	time_t start_time;		/* time execution begins,
+					 * actual or expected */
+	uint32_t array_job_id;		/* job_id of a job array or 0 if N/A */
+	uint32_t array_task_id;		/* task_id of a job array */
+	uint32_t het_job_id;		/* job ID of HetJob leader */
+	bool preempt_in_progress;	/* Preemption of other jobs in progress
+					 * in order to start this job,
+					 * (Internal use only, don't save) */
+
+	char    *account;		/* account number to charge, interned */
 	char    *admin_comment;		/* administrator's arbitrary comment */
 	char	*alias_list;		/* node name to address aliases */
 	char    *alloc_node;		/* local node making resource alloc */
 	uint16_t alloc_resp_port;	/* RESPONSE_RESOURCE_ALLOCATION port */
 	uint32_t alloc_sid;		/* local sid making resource alloc */
-	uint32_t array_job_id;		/* job_id of a job array or 0 if N/A */
-	uint32_t array_task_id;		/* task_id of a job array */
-	job_array_struct_t *array_recs;	/* job array details,
-					 * only in meta-job record */
 	uint32_t assoc_id;              /* used for accounting plugins */
-	slurmdb_assoc_rec_t *assoc_ptr; /* job's assoc record ptr confirm the
-					 * value before use */
 	char *batch_features;		/* features required for batch script */
 	uint16_t batch_flag;		/* 1 or 2 if batch job (with script),
 					 * 2 indicates retry mode (one retry) */
@@ -264,7 +306,6 @@ struct job_record {
 					 * billing weight. Recalculated upon job
 					 * resize.  Cannot be calculated until
 					 * the job is alloocated resources. */
-	uint64_t bit_flags;             /* various job flags */
 	char *burst_buffer;		/* burst buffer specification */
 	char *burst_buffer_state;	/* burst buffer state */
 	char *clusters;			/* clusters job is submitted to with -M
@@ -282,13 +323,9 @@ struct job_record {
 	time_t deadline;		/* deadline */
 	uint32_t delay_boot;		/* Delay boot for desired node mode */
 	uint32_t derived_ec;		/* highest exit code of all job steps */
-	job_details_t *details;		/* job details */
 	uint16_t direct_set_prio;	/* Priority set directly if
 					 * set the system will not
 					 * change the priority any further. */
-	time_t end_time;		/* time execution ended, actual or
-					 * expected. if terminated from suspend
-					 * state, this is time suspend began */
 	time_t end_time_exp;		/* when we believe the job is
 					   going to end. */
 	bool epilog_running;		/* true of EpilogSlurmctld is running */
@@ -320,21 +357,20 @@ struct job_record {
 					 * to be passed to slurmdbd */
 	uint32_t group_id;		/* group submitted under */
 	het_job_details_t *het_details;	/* HetJob details */
-	uint32_t het_job_id;		/* job ID of HetJob leader */
 	char *het_job_id_set;		/* job IDs for all components */
 	uint32_t het_job_offset;	/* HetJob component index */
 	List het_job_list;		/* List of job pointers to all
 					 * components */
-	uint32_t job_id;		/* job ID */
 	identity_t *id;			/* job identity */
-	job_record_t *job_next;		/* next entry with same hash index */
 	job_record_t *job_array_next_j;	/* job array linked list by job_id */
 	job_record_t *job_array_next_t;	/* job array linked list by task_id */
 	job_record_t *job_preempt_comp; /* het job preempt component */
 	job_resources_t *job_resrcs;	/* details of allocated cores */
-	uint32_t job_state;		/* state of the job */
 	uint16_t kill_on_node_fail;	/* 1 if job should be killed on
 					 * node failure */
+	uint64_t info_hash[2];		/* hash of job info last packed for
+					 * SHOW_DELTA without/with SHOW_DETAIL */
+	time_t info_change[2];		/* when info_hash last changed */
 	time_t last_sched_eval;		/* last time job was evaluated for scheduling */
 	char *licenses;			/* licenses required by the job */
 	List license_list;		/* structure with license info */
@@ -377,21 +413,13 @@ struct job_record {
 					 * submitted from */
 	uint16_t other_port;		/* port for client communications */
 	char *partition;		/* name of job partition(s) */
-	List part_ptr_list;		/* list of pointers to partition recs */
 	bool part_nodes_missing;	/* set if job's nodes removed from this
 					 * partition */
-	part_record_t *part_ptr;	/* pointer to the partition record */
-	priority_parts_t *part_prio;	/* partition based priority */
 	time_t pre_sus_time;		/* time job ran prior to last suspend */
 	time_t preempt_time;		/* job preemption signal time */
-	bool preempt_in_progress;	/* Preemption of other jobs in progress
-					 * in order to start this job,
-					 * (Internal use only, don't save) */
 	uint32_t prep_epilog_cnt;	/* count of epilog async tasks left */
 	uint32_t prep_prolog_cnt;	/* count of prolog async tasks left */
 	bool prep_prolog_failed;	/* any prolog_slurmctld failed */
-	uint32_t priority;		/* relative priority of the job,
-					 * zero == held (don't initiate) */
 	priority_factors_t *prio_factors; /* cached value of priority factors
 					   * figured out in the priority plugin
 					   */
@@ -399,20 +427,15 @@ struct job_record {
 	time_t prolog_launch_time;	/* When the prolog was launched from the
 					 * controller -- PrologFlags=alloc */
 	uint32_t qos_id;		/* quality of service id */
-	slurmdb_qos_rec_t *qos_ptr;	/* pointer to the quality of
-					 * service record used for
-					 * this job, confirm the
-					 * value before use */
 	void *qos_blocking_ptr;		/* internal use only, DON'T PACK */
+	uint32_t queue_rank;		/* position in the last sorted job
+					 * queue, used to presort the next
+					 * one, internal use only, DON'T PACK */
 	uint8_t reboot;			/* node reboot requested before start */
 	uint16_t restart_cnt;		/* count of restarts */
 	time_t resize_time;		/* time of latest size change */
 	uint32_t resv_id;		/* reservation ID */
-	List resv_list;                 /* Filled in if the job is requesting
-					 * more than one reservation,
-					 * DON'T PACK. */
 	char *resv_name;		/* reservation name */
-	slurmctld_resv_t *resv_ptr;	/* reservation structure pointer */
 	char *resv_ports;		/* MPI ports reserved for job */
 	int *resv_port_array;		/* MPI reserved port indexes */
 	uint16_t resv_port_cnt;		/* count of MPI ports reserved per node */
@@ -431,11 +454,7 @@ struct job_record {
 					 * creating message or the
 					 * lowest slurmd in the
 					 * allocation */
-	time_t start_time;		/* time execution begins,
-					 * actual or expected */
 	char *state_desc;		/* optional details for state_reason */
-	uint32_t state_reason;		/* reason job still pending or failed
-					 * see slurm.h:enum job_state_reason */
 	uint32_t state_reason_prev_db;	/* Previous state_reason that isn't
 					 * priority or resources, only stored in
 					 * the database. */
@@ -444,8 +463,6 @@ struct job_record {
 	void *switch_jobinfo;		/* opaque blob for switch plugin */
 	char *system_comment;		/* slurmctld's arbitrary comment */
 	time_t time_last_active;	/* time of last job activity */
-	uint32_t time_limit;		/* time_limit minutes or INFINITE,
-					 * NO_VAL implies partition max_time */
 	uint32_t time_min;		/* minimum time_limit minutes or
 					 * INFINITE,
 					 * zero implies same as time_limit */
@@ -473,14 +490,14 @@ struct job_record {
 	char *tres_alloc_str;           /* simple tres string for job */
 	char *tres_fmt_alloc_str;       /* formatted tres string for job */
 	uint32_t user_id;		/* user the job runs as */
-	char *user_name;		/* string version of user */
+	char *user_name;		/* string version of user, interned */
 	uint16_t wait_all_nodes;	/* if set, wait for all nodes to boot
 					 * before starting the job */
 	uint16_t warn_flags;		/* flags for signal to send */
 	uint16_t warn_signal;		/* signal to send before end_time */
 	uint16_t warn_time;		/* when to send signal before
 					 * end_time (secs) */
-	char *wckey;			/* optional wckey */
+	char *wckey;			/* optional wckey, interned */
 
 	/* Request number of switches support */
 	uint32_t req_switch;  /* Minimum number of switches                */
@@ -649,6 +666,24 @@ extern void job_record_free_null_array_recs(job_record_t *array_recs);
  */
 extern void job_record_free_fed_details(job_fed_details_t **fed_details_pptr);
 
+/*
+ * Make dest reference the argv, env_sup and submit_line of src rather than
+ * copying them. These are never modified once a job array's meta record has
+ * been created, so they are shared by all of its split out tasks.
+ */
+extern void job_details_share_args(job_details_t *dest, job_details_t *src);
+
+/*
+ * Return a shared, reference counted copy of str (or NULL). Used for the
+ * job record fields marked "interned" above, which take few distinct values
+ * across all jobs. Interned strings must never be modified or xfree()'d,
+ * drop them with job_record_str_release() instead.
+ */
+extern char *job_record_str_intern(const char *str);
+
+/* Drop a reference returned by job_record_str_intern() and clear *str_ptr */
+extern void job_record_str_release(char **str_ptr);
+
 typedef struct {
 	slurm_step_id_t *step_id;
 	uint16_t show_flags;
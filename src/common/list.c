@@ -126,6 +126,25 @@ struct xlist {
 	pthread_rwlock_t      mutex;        /* mutex to protect access to list   */
 };
 
+/*
+ * Per-thread cache of freed list nodes and iterators, reused by the next list
+ * operation of the same thread rather than going through malloc() and free().
+ * Disabled unless list_cache_init() is called.
+ */
+#define LIST_CACHE_NODES 1024
+#define LIST_CACHE_ITRS 16
+
+typedef struct {
+	list_node_t *nodes;		/* chained through next */
+	int node_cnt;
+	list_itr_t *itrs;		/* chained through iNext */
+	int itr_cnt;
+} list_cache_t;
+
+static bool list_cache_enabled = false;
+static pthread_key_t list_cache_key;
+static pthread_once_t list_cache_once = PTHREAD_ONCE_INIT;
+
 /****************
  *  Prototypes  *
  ****************/
@@ -143,6 +162,110 @@ static int _list_mutex_is_locked(pthread_rwlock_t *mutex);
  *  Functions  *
  ***************/
 
+/* Release the cache of an exiting thread */
+static void _list_cache_destroy(void *arg)
+{
+	list_cache_t *cache = arg;
+
+	while (cache->nodes) {
+		list_node_t *p = cache->nodes;
+		cache->nodes = p->next;
+		xfree(p);
+	}
+	while (cache->itrs) {
+		list_itr_t *i = cache->itrs;
+		cache->itrs = i->iNext;
+		xfree(i);
+	}
+	xfree(cache);
+}
+
+static void _list_cache_key_create(void)
+{
+	if (pthread_key_create(&list_cache_key, _list_cache_destroy))
+		fatal("%s: pthread_key_create failed: %m", __func__);
+}
+
+static list_cache_t *_list_cache_get(void)
+{
+	list_cache_t *cache;
+
+	if (!list_cache_enabled)
+		return NULL;
+
+	if (!(cache = pthread_getspecific(list_cache_key))) {
+		cache = xmalloc(sizeof(*cache));
+		if (pthread_setspecific(list_cache_key, cache))
+			fatal("%s: pthread_setspecific failed: %m", __func__);
+	}
+
+	return cache;
+}
+
+extern void list_cache_init(void)
+{
+	pthread_once(&list_cache_once, _list_cache_key_create);
+	list_cache_enabled = true;
+}
+
+/* Contents of the returned node are undefined */
+static list_node_t *_node_alloc(void)
+{
+	list_cache_t *cache = _list_cache_get();
+	list_node_t *p;
+
+	if (cache && (p = cache->nodes)) {
+		cache->nodes = p->next;
+		cache->node_cnt--;
+		return p;
+	}
+
+	return xmalloc(sizeof(*p));
+}
+
+static void _node_free(list_node_t *p)
+{
+	list_cache_t *cache = _list_cache_get();
+
+	if (cache && (cache->node_cnt < LIST_CACHE_NODES)) {
+		p->next = cache->nodes;
+		cache->nodes = p;
+		cache->node_cnt++;
+		return;
+	}
+
+	xfree(p);
+}
+
+/* Contents of the returned iterator are undefined */
+static list_itr_t *_itr_alloc(void)
+{
+	list_cache_t *cache = _list_cache_get();
+	list_itr_t *i;
+
+	if (cache && (i = cache->itrs)) {
+		cache->itrs = i->iNext;
+		cache->itr_cnt--;
+		return i;
+	}
+
+	return xmalloc(sizeof(*i));
+}
+
+static void _itr_free(list_itr_t *i)
+{
+	list_cache_t *cache = _list_cache_get();
+
+	if (cache && (cache->itr_cnt < LIST_CACHE_ITRS)) {
+		i->iNext = cache->itrs;
+		cache->itrs = i;
+		cache->itr_cnt++;
+		return;
+	}
+
+	xfree(i);
+}
+
 /* list_create()
  */
 extern list_t *list_create(ListDelF f)
@@ -176,7 +299,7 @@ extern void list_destroy(list_t *l)
 		xassert(i->magic == LIST_ITR_MAGIC);
 		i->magic = ~LIST_ITR_MAGIC;
 		iTmp = i->iNext;
-		xfree(i);
+		_itr_free(i);
 		i = iTmp;
 	}
 	p = l->head;
@@ -184,7 +307,7 @@ extern void list_destroy(list_t *l)
 		pTmp = p->next;
 		if (p->data && l->fDel)
 			l->fDel(p->data);
-		xfree(p);
+		_node_free(p);
 		p = pTmp;
 	}
 	l->magic = ~LIST_MAGIC;
@@ -813,7 +936,7 @@ extern void *list_dequeue(list_t *l)
  */
 extern list_itr_t *list_iterator_create(list_t *l)
 {
-	list_itr_t *i = xmalloc(sizeof(*i));
+	list_itr_t *i = _itr_alloc();
 
 	xassert(l != NULL);
 
@@ -868,7 +991,7 @@ extern void list_iterator_destroy(list_itr_t *i)
 	slurm_rwlock_unlock(&i->list->mutex);
 
 	i->magic = ~LIST_ITR_MAGIC;
-	xfree(i);
+	_itr_free(i);
 }
 
 static void *_list_next_locked(list_itr_t *i)
@@ -1007,7 +1130,7 @@ static void _list_node_create(list_t *l, list_node_t **pp, void *x)
 	xassert(pp != NULL);
 	xassert(x != NULL);
 
-	p = xmalloc(sizeof(list_node_t));
+	p = _node_alloc();
 
 	p->data = x;
 	if (!(p->next = *pp))
@@ -1061,7 +1184,7 @@ static void *_list_node_destroy(list_t *l, list_node_t **pp)
 		xassert((i->pos == *i->prev) ||
 		       ((*i->prev) && (i->pos == (*i->prev)->next)));
 	}
-	xfree(p);
+	_node_free(p);
 
 	return v;
 }
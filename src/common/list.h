@@ -93,6 +93,13 @@ typedef int (*ListForF) (void *x, void *arg);
  *  General-Purpose Functions  *
  *******************************/
 
+/*
+ *  Enable reuse of freed list nodes and iterators by the thread that freed
+ *    them, instead of returning them to malloc(). Intended for daemons that
+ *    create and drain many short lived lists (e.g. job queues in slurmctld).
+ */
+extern void list_cache_init(void);
+
 /*
  *  Creates and returns a new empty list.
  *  The deletion function [f] is used to deallocate memory used by items
@@ -58,6 +58,7 @@
 #include <errno.h>
 #include <poll.h>
 #include <pthread.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -87,6 +88,9 @@
 #  define LINEBUFSIZE 256
 #endif
 
+/* Max logfile bytes queued for the async writer before dropping lines */
+#define LOG_ASYNC_MAX_BYTES (16 * 1024 * 1024)
+
 #define NAMELEN 16
 
 #define LOG_MACRO(level, sched, fmt) {				\
@@ -149,6 +153,21 @@ static bool syslog_open = false;
 static volatile log_level_t highest_log_level = LOG_LEVEL_END;
 static volatile log_level_t highest_sched_log_level = LOG_LEVEL_QUIET;
 
+/*
+ * Async logfile writer state. Lines are queued under log_lock and async_lock
+ * and written by async_tid without holding log_lock. Anything replacing
+ * log->logfp first waits for the queue to drain with _async_drain().
+ */
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t async_tid = 0;
+static bool async_busy = false;
+static bool async_shutdown = false;
+static char *async_buf = NULL;
+static size_t async_len = 0;
+static uint64_t async_dropped = 0;
+static uint64_t async_dropped_total = 0;
+
 #define LOG_INITIALIZED ((log != NULL) && (log->initialized))
 #define SCHED_LOG_INITIALIZED ((sched_log != NULL) && (sched_log->initialized))
 /* define a default argv0 */
@@ -167,7 +186,17 @@ extern char * program_invocation_name;
  */
 static void _atfork_prep()   { slurm_mutex_lock(&log_lock);   }
 static void _atfork_parent() { slurm_mutex_unlock(&log_lock); }
-static void _atfork_child()  { slurm_mutex_unlock(&log_lock); }
+static void _atfork_child()
+{
+	/* The writer thread does not exist in the child */
+	pthread_mutex_init(&async_lock, NULL);
+	pthread_cond_init(&async_cond, NULL);
+	async_busy = false;
+	async_tid = 0;
+	xfree(async_buf);
+	async_len = 0;
+	slurm_mutex_unlock(&log_lock);
+}
 static bool at_forked = false;
 #define atfork_install_handlers()					\
 	while (!at_forked) {						\
@@ -176,6 +205,7 @@ static bool at_forked = false;
 	}
 
 static void _log_flush(log_t *log);
+static void _async_drain(void);
 
 static log_level_t _highest_level(log_level_t a, log_level_t b, log_level_t c)
 {
@@ -287,6 +317,161 @@ static int _fd_writeable(int fd)
 	return 1;
 }
 
+static void _async_write(int fd, char *data, size_t len)
+{
+	while (len) {
+		ssize_t rc = write(fd, data, len);
+
+		if (rc < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			return;
+		}
+		data += rc;
+		len -= rc;
+	}
+}
+
+static void *_async_writer(void *arg)
+{
+	sigset_t set;
+
+	/* Leave signal handling to the threads of the daemon */
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	slurm_mutex_lock(&async_lock);
+	while (true) {
+		char *data;
+		size_t len;
+		uint64_t dropped;
+		int fd;
+
+		if (!async_buf) {
+			if (async_shutdown)
+				break;
+			slurm_cond_wait(&async_cond, &async_lock);
+			continue;
+		}
+
+		data = async_buf;
+		len = async_len;
+		dropped = async_dropped;
+		async_buf = NULL;
+		async_len = 0;
+		async_dropped = 0;
+		async_busy = true;
+		slurm_mutex_unlock(&async_lock);
+
+		/* log->logfp cannot change while async_busy is set */
+		if (log && log->logfp && ((fd = fileno(log->logfp)) >= 0)) {
+			if (dropped) {
+				char time[64], *msg;
+
+				log_timestamp(time, sizeof(time));
+				msg = xstrdup_printf("[%s] error: log queue full, dropped %"PRIu64" messages\n",
+						     time, dropped);
+				_async_write(fd, msg, strlen(msg));
+				xfree(msg);
+			}
+			_async_write(fd, data, len);
+		}
+		xfree(data);
+
+		slurm_mutex_lock(&async_lock);
+		async_busy = false;
+		slurm_cond_broadcast(&async_cond);
+	}
+	slurm_mutex_unlock(&async_lock);
+
+	return NULL;
+}
+
+/*
+ * Queue a complete logfile line for the writer thread, taking ownership of
+ * line. Caller must hold log_lock.
+ */
+static void _async_queue(char **line)
+{
+	size_t len = strlen(*line);
+
+	slurm_mutex_lock(&async_lock);
+	if ((async_len + len) > LOG_ASYNC_MAX_BYTES) {
+		async_dropped++;
+		async_dropped_total++;
+		xfree(*line);
+	} else if (!async_buf) {
+		async_buf = *line;
+		async_len = len;
+		*line = NULL;
+	} else {
+		xstrcat(async_buf, *line);
+		async_len += len;
+		xfree(*line);
+	}
+	slurm_cond_broadcast(&async_cond);
+	slurm_mutex_unlock(&async_lock);
+}
+
+/*
+ * Wait for the writer thread to write everything queued so far.
+ * Caller must hold log_lock so no new lines are queued meanwhile.
+ */
+static void _async_drain(void)
+{
+	if (!async_tid)
+		return;
+
+	slurm_mutex_lock(&async_lock);
+	while (async_buf || async_busy)
+		slurm_cond_wait(&async_cond, &async_lock);
+	slurm_mutex_unlock(&async_lock);
+}
+
+/* Caller must hold log_lock */
+static void _async_stop(void)
+{
+	if (!async_tid)
+		return;
+
+	slurm_mutex_lock(&async_lock);
+	async_shutdown = true;
+	slurm_cond_broadcast(&async_cond);
+	slurm_mutex_unlock(&async_lock);
+
+	pthread_join(async_tid, NULL);
+	async_tid = 0;
+	async_shutdown = false;
+}
+
+extern void log_set_async(bool enable)
+{
+	slurm_mutex_lock(&log_lock);
+	if (!enable) {
+		_async_stop();
+	} else if (!async_tid) {
+		int err = pthread_create(&async_tid, NULL, _async_writer, NULL);
+
+		if (err) {
+			fprintf(stderr, "%s: pthread_create error: %s\n",
+				__func__, strerror(err));
+			async_tid = 0;
+		}
+	}
+	slurm_mutex_unlock(&log_lock);
+}
+
+extern uint64_t log_async_dropped(void)
+{
+	uint64_t dropped;
+
+	slurm_mutex_lock(&async_lock);
+	dropped = async_dropped_total;
+	slurm_mutex_unlock(&async_lock);
+
+	return dropped;
+}
+
 /*
  * Initialize log with
  * prog = program name to tag error messages with
@@ -300,6 +485,9 @@ _log_init(char *prog, log_options_t opt, log_facility_t fac, char *logfile )
 {
 	int rc = 0;
 
+	/* logfp may be replaced below */
+	_async_drain();
+
 	if (!log)  {
 		log = xmalloc(sizeof(log_t));
 		log->logfp = NULL;
@@ -528,6 +716,7 @@ void log_fini(void)
 
 	slurm_mutex_lock(&log_lock);
 	_log_flush(log);
+	_async_stop();
 	xfree(log->argv0);
 	xfree(log->prefix);
 	if (log->buf)
@@ -614,6 +803,7 @@ int log_alter_with_fp(log_options_t opt, log_facility_t fac, FILE *fp_in)
 	int rc = 0;
 	slurm_mutex_lock(&log_lock);
 	rc = _log_init(NULL, opt, fac, NULL);
+	_async_drain();
 	if (log->logfp)
 		fclose(log->logfp); /* Ignore errors */
 	log->logfp = fp_in;
@@ -1284,6 +1474,9 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 	char *eol = "\n";
 	int priority = LOG_INFO;
 
+	/* format the basic message outside of the lock */
+	buf = vxstrfmt(fmt, args);
+
 	slurm_mutex_lock(&log_lock);
 
 	if (!LOG_INITIALIZED) {
@@ -1296,7 +1489,6 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 
 	if (SCHED_LOG_INITIALIZED && sched &&
 	    (highest_sched_log_level > LOG_LEVEL_QUIET)) {
-		buf = vxstrfmt(fmt, args);
 		xlogfmtcat(&msgbuf, "[%M] %s%s", sched_log->prefix, pfx);
 		_log_printf(sched_log, sched_log->fbuf, sched_log->logfp,
 			    "sched: %s%s\n", msgbuf, buf);
@@ -1363,12 +1555,6 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 
 	}
 
-	if (!buf) {
-		/* format the basic message,
-		 * if not already done for scheduling log */
-		buf = vxstrfmt(fmt, args);
-	}
-
 	if (level <= log->opt.stderr_level) {
 
 		fflush(stdout);
@@ -1424,17 +1610,27 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 					   SER_FLAGS_COMPACT);
 		FREE_NULL_DATA(out);
 
-		if (json)
+		if (json && async_tid && !log->opt.buffered) {
+			xstrcat(json, "\n");
+			_async_queue(&json);
+		} else if (json) {
 			_log_printf(log, log->fbuf, log->logfp, "%s\n", json);
+			fflush(log->logfp);
+		}
 
 		xfree(json);
-		fflush(log->logfp);
 		xfree(msgbuf);
 	} else {
 		xassert(log->opt.logfile_fmt == LOG_FILE_FMT_TIMESTAMP);
 		xlogfmtcat(&msgbuf, "[%M] %s%s", log->prefix, pfx);
-		_log_printf(log, log->fbuf, log->logfp, "%s%s\n", msgbuf, buf);
-		fflush(log->logfp);
+		if (async_tid && !log->opt.buffered) {
+			xstrfmtcat(msgbuf, "%s\n", buf);
+			_async_queue(&msgbuf);
+		} else {
+			_log_printf(log, log->fbuf, log->logfp, "%s%s\n",
+				    msgbuf, buf);
+			fflush(log->logfp);
+		}
 
 		xfree(msgbuf);
 	}
@@ -1469,8 +1665,10 @@ log_has_data()
 static void
 _log_flush(log_t *log)
 {
-	if (!log->opt.buffered)
+	if (!log->opt.buffered) {
+		_async_drain();
 		return;
+	}
 
 	if (log->opt.stderr_level)
 		cbuf_read_to_fd(log->buf, fileno(stderr), -1);
@@ -171,6 +171,16 @@ void log_reinit(void);
  */
 void log_fini(void);
 
+/*
+ * Write logfile lines from a background thread instead of the calling
+ * thread. Lines are dropped once too much output is queued, see
+ * log_async_dropped().
+ */
+extern void log_set_async(bool enable);
+
+/* Number of logfile lines dropped by the async writer so far */
+extern uint64_t log_async_dropped(void);
+
 /*
  * Close scheduler log and free associated memory
  */
@@ -0,0 +1,202 @@
+/*****************************************************************************\
+ *  mpsc_queue.c - lock-free multiple producer, single consumer queue
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "src/common/macros.h"
+#include "src/common/mpsc_queue.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+
+/*
+ * The queue is the intrusive MPSC design by Dmitry Vyukov: a singly linked
+ * list with a stub node at the head. Producers atomically swap themselves in
+ * as the tail and then link the previous tail to the new node. The consumer
+ * owns the head, and the node it dequeues becomes the new stub.
+ *
+ * Nodes are recycled through a shared stack. Only the consumer pushes onto
+ * it, while producers take the whole stack with one atomic exchange and hand
+ * back what they do not need. Since no thread ever pops a single node off
+ * the stack with a compare-and-swap, it is not subject to the ABA problem.
+ * The consumer first collects freed nodes on a private list and only
+ * publishes them when the shared stack has been drained.
+ */
+
+#define MPSC_QUEUE_MAGIC 0x3a5c0e7e
+
+/* Upper bound on idle nodes kept per queue */
+#define MPSC_QUEUE_POOL_MAX 1024
+
+typedef struct mpsc_node {
+	struct mpsc_node *next;
+	void *data;
+} mpsc_node_t;
+
+struct mpsc_queue {
+	int magic; /* MPSC_QUEUE_MAGIC */
+
+	/* consumer only */
+	mpsc_node_t *head;
+	mpsc_node_t *free_first;
+	mpsc_node_t *free_last;
+	int free_cnt;
+
+	/* shared with producers */
+	mpsc_node_t *tail;
+	mpsc_node_t *pool;
+};
+
+static void _free_chain(mpsc_node_t *node)
+{
+	while (node) {
+		mpsc_node_t *next = node->next;
+		xfree(node);
+		node = next;
+	}
+}
+
+/* Push a chain of nodes ending in last back onto the shared stack */
+static void _pool_push(mpsc_queue_t *queue, mpsc_node_t *first,
+		       mpsc_node_t *last)
+{
+	mpsc_node_t *top = __atomic_load_n(&queue->pool, __ATOMIC_RELAXED);
+
+	do {
+		last->next = top;
+	} while (!__atomic_compare_exchange_n(&queue->pool, &top, first, true,
+					      __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+}
+
+static mpsc_node_t *_node_get(mpsc_queue_t *queue)
+{
+	mpsc_node_t *node, *rest, *last, *expect = NULL;
+
+	if (!(node = __atomic_exchange_n(&queue->pool, NULL, __ATOMIC_ACQUIRE)))
+		return xmalloc(sizeof(*node));
+
+	if (!(rest = node->next))
+		return node;
+
+	/* Usually nobody refilled the stack meanwhile */
+	if (__atomic_compare_exchange_n(&queue->pool, &expect, rest, false,
+					__ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		return node;
+
+	for (last = rest; last->next; last = last->next)
+		;
+	_pool_push(queue, rest, last);
+	return node;
+}
+
+/* Only called by the consumer */
+static void _node_put(mpsc_queue_t *queue, mpsc_node_t *node)
+{
+	if (queue->free_cnt >= MPSC_QUEUE_POOL_MAX) {
+		xfree(node);
+	} else {
+		node->next = queue->free_first;
+		if (!queue->free_first)
+			queue->free_last = node;
+		queue->free_first = node;
+		queue->free_cnt++;
+	}
+
+	if (queue->free_first &&
+	    !__atomic_load_n(&queue->pool, __ATOMIC_RELAXED)) {
+		_pool_push(queue, queue->free_first, queue->free_last);
+		queue->free_first = queue->free_last = NULL;
+		queue->free_cnt = 0;
+	}
+}
+
+extern mpsc_queue_t *mpsc_queue_create(void)
+{
+	mpsc_queue_t *queue = xmalloc(sizeof(*queue));
+
+	queue->magic = MPSC_QUEUE_MAGIC;
+	queue->head = queue->tail = xmalloc(sizeof(mpsc_node_t));
+
+	return queue;
+}
+
+extern void mpsc_queue_destroy(mpsc_queue_t *queue)
+{
+	xassert(queue->magic == MPSC_QUEUE_MAGIC);
+
+	_free_chain(queue->head);
+	_free_chain(queue->free_first);
+	_free_chain(queue->pool);
+	queue->magic = ~MPSC_QUEUE_MAGIC;
+	xfree(queue);
+}
+
+extern void mpsc_queue_enqueue(mpsc_queue_t *queue, void *x)
+{
+	mpsc_node_t *node, *prev;
+
+	xassert(queue->magic == MPSC_QUEUE_MAGIC);
+
+	node = _node_get(queue);
+	node->data = x;
+	node->next = NULL;
+
+	prev = __atomic_exchange_n(&queue->tail, node, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+extern void *mpsc_queue_dequeue(mpsc_queue_t *queue)
+{
+	mpsc_node_t *stub, *next;
+	void *x;
+
+	xassert(queue->magic == MPSC_QUEUE_MAGIC);
+
+	stub = queue->head;
+	if (!(next = __atomic_load_n(&stub->next, __ATOMIC_ACQUIRE)))
+		return NULL;
+
+	x = next->data;
+	next->data = NULL;
+	queue->head = next;
+	_node_put(queue, stub);
+
+	return x;
+}
+
+extern bool mpsc_queue_is_empty(mpsc_queue_t *queue)
+{
+	xassert(queue->magic == MPSC_QUEUE_MAGIC);
+
+	return !__atomic_load_n(&queue->head->next, __ATOMIC_ACQUIRE);
+}
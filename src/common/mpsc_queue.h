@@ -0,0 +1,85 @@
+/*****************************************************************************\
+ *  mpsc_queue.h - lock-free multiple producer, single consumer queue
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _MPSC_QUEUE_H
+#define _MPSC_QUEUE_H
+
+#include <stdbool.h>
+
+/*
+ * FIFO queue where any number of threads may enqueue concurrently without
+ * taking a lock, but only one thread at a time may dequeue. It is meant to
+ * replace a list_t used only through list_enqueue() and list_dequeue() on
+ * paths where many threads feed a single worker.
+ *
+ * Queue nodes released by the consumer are kept for reuse by producers, so a
+ * queue in steady state does not allocate memory.
+ */
+typedef struct mpsc_queue mpsc_queue_t;
+
+#define FREE_NULL_MPSC_QUEUE(_X)		\
+	do {					\
+		if (_X)				\
+			mpsc_queue_destroy(_X);	\
+		_X = NULL;			\
+	} while (0)
+
+extern mpsc_queue_t *mpsc_queue_create(void);
+
+/*
+ * Free the queue itself. Items still queued are not freed.
+ * No other thread may be using the queue.
+ */
+extern void mpsc_queue_destroy(mpsc_queue_t *queue);
+
+/* Append x to the tail of the queue. Safe to call from any thread. */
+extern void mpsc_queue_enqueue(mpsc_queue_t *queue, void *x);
+
+/*
+ * Remove and return the item at the head of the queue.
+ * Only the consumer thread may call this.
+ * RET item or NULL if the queue is empty, or if the only queued item is still
+ *	being linked in by its producer. Producers should signal the consumer
+ *	after mpsc_queue_enqueue() returns to cover the latter case.
+ */
+extern void *mpsc_queue_dequeue(mpsc_queue_t *queue);
+
+/*
+ * Only the consumer thread may call this.
+ * RET true if mpsc_queue_dequeue() would return NULL
+ */
+extern bool mpsc_queue_is_empty(mpsc_queue_t *queue);
+
+#endif
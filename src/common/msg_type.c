@@ -78,6 +78,8 @@ const static entry_t msg_types[] = {
 	ENTRY(REQUEST_SET_SUSPEND_EXC_PARTS),
 	ENTRY(REQUEST_SET_SUSPEND_EXC_STATES),
 	ENTRY(REQUEST_DBD_RELAY),
+	ENTRY(REQUEST_SCHED_TRACE_DUMP),
+	ENTRY(MESSAGE_NODE_HEARTBEAT),
 	ENTRY(PERSIST_RC),
 	ENTRY(REQUEST_BUILD_INFO),
 	ENTRY(RESPONSE_BUILD_INFO),
@@ -165,6 +167,8 @@ const static entry_t msg_types[] = {
 	ENTRY(RESPONSE_HET_JOB_ALLOCATION),
 	ENTRY(REQUEST_HET_JOB_ALLOC_INFO),
 	ENTRY(REQUEST_SUBMIT_BATCH_HET_JOB),
+	ENTRY(REQUEST_SUBMIT_BATCH_JOBS),
+	ENTRY(RESPONSE_SUBMIT_BATCH_JOBS),
 	ENTRY(REQUEST_CTLD_MULT_MSG),
 	ENTRY(RESPONSE_CTLD_MULT_MSG),
 	ENTRY(REQUEST_SIB_MSG),
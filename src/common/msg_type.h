@@ -73,6 +73,8 @@ typedef enum {
 	REQUEST_SET_SUSPEND_EXC_PARTS,
 	REQUEST_SET_SUSPEND_EXC_STATES,
 	REQUEST_DBD_RELAY,
+	REQUEST_SCHED_TRACE_DUMP,
+	MESSAGE_NODE_HEARTBEAT,
 
 	DBD_MESSAGES_START	= 1400,
 	PERSIST_RC = 1433, /* To mirror the DBD_RC this is replacing */
@@ -190,6 +192,8 @@ typedef enum {
 	RESPONSE_HET_JOB_ALLOCATION,
 	REQUEST_HET_JOB_ALLOC_INFO,
 	REQUEST_SUBMIT_BATCH_HET_JOB,
+	REQUEST_SUBMIT_BATCH_JOBS,
+	RESPONSE_SUBMIT_BATCH_JOBS,		/* 4030 */
 
 	REQUEST_CTLD_MULT_MSG = 4500,
 	RESPONSE_CTLD_MULT_MSG,
@@ -96,8 +96,34 @@ uint16_t *cr_node_num_cores = NULL;
 uint32_t *cr_node_cores_offset = NULL;
 bool spec_cores_first = false;
 
+/*
+ * Node records indexed by the numeric suffix of their names, one entry per
+ * name prefix, so node lists like "tux[1-1000]" are mapped to node records
+ * without building and hashing every hostname. Built by rehash_node().
+ */
+#define NAME_INDEX_MAX_PREFIX 64
+typedef struct {
+	char *prefix;
+	int prefix_len;
+	unsigned long max_num;
+	int node_cnt;
+	int *inx;	/* node index by suffix, -1 if none, NULL if sparse */
+} name_index_t;
+
+typedef struct {
+	bitstr_t *bitmap;
+	bool best_effort;
+	const char *caller;
+	int rc;
+} name2bitmap_args_t;
+
+static name_index_t *name_index = NULL;
+static int name_index_cnt = 0;
+
 /* Local function definitions */
 static void _delete_config_record(void);
+static bool _hostlist2bitmap_ranges(hostlist_t *hl, name2bitmap_args_t *args);
+static void _name_index_free(void);
 static void _delete_node_config_ptr(node_record_t *node_ptr);
 #if _DEBUG
 static void	_dump_hash (void);
@@ -1099,6 +1125,7 @@ extern void init_node_conf(void)
 	last_node_index = -1;
 	xfree(node_record_table_ptr);
 	xhash_free(node_hash_table);
+	_name_index_free();
 
 	if (config_list)	/* delete defunct configuration entries */
 		_delete_config_record();
@@ -1120,6 +1147,7 @@ extern void node_fini2 (void)
 	node_record_t *node_ptr;
 
 	xhash_free(node_hash_table);
+	_name_index_free();
 	for (i = 0; (node_ptr = next_node(&i)); i++)
 		delete_node_record(node_ptr);
 
@@ -1171,9 +1199,12 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 	char *this_node_name;
 	bitstr_t *my_bitmap;
 	hostlist_t *host_list;
+	name2bitmap_args_t args = { .best_effort = best_effort,
+				    .caller = __func__ };
 
 	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
 	*bitmap = my_bitmap;
+	args.bitmap = my_bitmap;
 
 	if (node_names == NULL) {
 		info("node_name2bitmap: node_names is NULL");
@@ -1188,6 +1219,11 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 		return rc;
 	}
 
+	if (_hostlist2bitmap_ranges(host_list, &args)) {
+		hostlist_destroy(host_list);
+		return args.rc;
+	}
+
 	while ( (this_node_name = hostlist_shift (host_list)) ) {
 		node_record_t *node_ptr;
 		node_ptr = _find_node_record(this_node_name, best_effort, true);
@@ -1219,10 +1255,16 @@ extern int hostlist2bitmap(hostlist_t *hl, bool best_effort, bitstr_t **bitmap)
 	bitstr_t *my_bitmap;
 	char *name;
 	hostlist_iterator_t *hi;
+	name2bitmap_args_t args = { .best_effort = best_effort,
+				    .caller = __func__ };
 
 	FREE_NULL_BITMAP(*bitmap);
 	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
 	*bitmap = my_bitmap;
+	args.bitmap = my_bitmap;
+
+	if (_hostlist2bitmap_ranges(hl, &args))
+		return args.rc;
 
 	hi = hostlist_iterator_create(hl);
 	while ((name = hostlist_next(hi))) {
@@ -1309,6 +1351,181 @@ extern void purge_node_rec(void *in)
 	xfree(node_ptr);
 }
 
+static void _name_index_free(void)
+{
+	for (int i = 0; i < name_index_cnt; i++) {
+		xfree(name_index[i].prefix);
+		xfree(name_index[i].inx);
+	}
+	xfree(name_index);
+	name_index_cnt = 0;
+}
+
+/*
+ * Split name into prefix length and numeric suffix.
+ * RET false if name has no usable numeric suffix
+ */
+static bool _name_split(const char *name, int *prefix_len, unsigned long *num)
+{
+	int len = strlen(name), i = len;
+
+	while ((i > 0) && isdigit((unsigned char) name[i - 1]))
+		i--;
+
+	/* No suffix, or one too large to index */
+	if ((i == len) || ((len - i) > 9))
+		return false;
+
+	*prefix_len = i;
+	*num = strtoul(name + i, NULL, 10);
+	return true;
+}
+
+static name_index_t *_name_index_find_prefix(const char *prefix, int len)
+{
+	for (int i = 0; i < name_index_cnt; i++) {
+		if ((name_index[i].prefix_len == len) &&
+		    !strncmp(name_index[i].prefix, prefix, len))
+			return &name_index[i];
+	}
+	return NULL;
+}
+
+static void _name_index_build(void)
+{
+	node_record_t *node_ptr;
+	unsigned long num;
+	int len;
+
+	_name_index_free();
+
+	for (int i = 0; (node_ptr = next_node(&i)); i++) {
+		name_index_t *ent;
+
+		if (!node_ptr->name || !_name_split(node_ptr->name, &len, &num))
+			continue;
+		if (!(ent = _name_index_find_prefix(node_ptr->name, len))) {
+			if (name_index_cnt >= NAME_INDEX_MAX_PREFIX)
+				continue;
+			xrecalloc(name_index, (name_index_cnt + 1),
+				  sizeof(*name_index));
+			ent = &name_index[name_index_cnt++];
+			ent->prefix = xstrndup(node_ptr->name, len);
+			ent->prefix_len = len;
+		}
+		ent->max_num = MAX(ent->max_num, num);
+		ent->node_cnt++;
+	}
+
+	for (int i = 0; i < name_index_cnt; i++) {
+		name_index_t *ent = &name_index[i];
+
+		/* Leave sparse suffixes to the hash table */
+		if (ent->max_num > ((4UL * ent->node_cnt) + 1024))
+			continue;
+		ent->inx = xcalloc((ent->max_num + 1), sizeof(int));
+		for (unsigned long j = 0; j <= ent->max_num; j++)
+			ent->inx[j] = -1;
+	}
+
+	for (int i = 0; (node_ptr = next_node(&i)); i++) {
+		name_index_t *ent;
+
+		if (!node_ptr->name || !_name_split(node_ptr->name, &len, &num))
+			continue;
+		if (!(ent = _name_index_find_prefix(node_ptr->name, len)) ||
+		    !ent->inx || (ent->inx[num] != -1))
+			continue;
+		ent->inx[num] = node_ptr->index;
+	}
+}
+
+/*
+ * Find the node named name, which is ent's prefix followed by num. The index
+ * is only rebuilt by rehash_node(), so verify the name of the record found.
+ * RET NULL if not found, use _find_node_record() instead.
+ */
+static node_record_t *_name_index_lookup(name_index_t *ent, unsigned long num,
+					 const char *name)
+{
+	node_record_t *node_ptr;
+	int inx;
+
+	if (!ent || !ent->inx || (num > ent->max_num) ||
+	    ((inx = ent->inx[num]) < 0) || (inx >= node_record_count))
+		return NULL;
+
+	if (!(node_ptr = node_record_table_ptr[inx]) ||
+	    xstrcmp(node_ptr->name, name))
+		return NULL;
+
+	return node_ptr;
+}
+
+static void _name2bitmap_set(name2bitmap_args_t *args, char *name)
+{
+	node_record_t *node_ptr;
+
+	if ((node_ptr = _find_node_record(name, args->best_effort, true))) {
+		bit_set(args->bitmap, node_ptr->index);
+	} else {
+		error("%s: invalid node specified: \"%s\"", args->caller,
+		      name);
+		if (!args->best_effort)
+			args->rc = EINVAL;
+	}
+}
+
+static int _name2bitmap_range(const char *prefix, unsigned long lo,
+			      unsigned long hi, int width, int singlehost,
+			      void *arg)
+{
+	name2bitmap_args_t *args = arg;
+	name_index_t *ent;
+	char *name = NULL;
+
+	if (singlehost) {
+		name = xstrdup(prefix);
+		_name2bitmap_set(args, name);
+		xfree(name);
+		return 0;
+	}
+
+	ent = _name_index_find_prefix(prefix, strlen(prefix));
+	for (unsigned long num = lo; num <= hi; num++) {
+		node_record_t *node_ptr;
+		char buf[256];
+		int len = snprintf(buf, sizeof(buf), "%s%0*lu", prefix, width,
+				   num);
+
+		if ((len < 0) || (len >= sizeof(buf))) {
+			name = xstrdup_printf("%s%0*lu", prefix, width, num);
+			_name2bitmap_set(args, name);
+			xfree(name);
+		} else if ((node_ptr = _name_index_lookup(ent, num, buf))) {
+			bit_set(args->bitmap, node_ptr->index);
+		} else {
+			_name2bitmap_set(args, buf);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Set the bits of every node of hl in bitmap, walking the hostlist ranges
+ * through the name index when names are single dimensional.
+ * RET false if the hostlist must be expanded by the caller instead
+ */
+static bool _hostlist2bitmap_ranges(hostlist_t *hl, name2bitmap_args_t *args)
+{
+	if (!name_index_cnt || (slurmdb_setup_cluster_dims() != 1))
+		return false;
+
+	(void) hostlist_for_each_range(hl, _name2bitmap_range, args);
+	return true;
+}
+
 /*
  * rehash_node - build a hash table of the node_record entries.
  * NOTE: using xhash implementation
@@ -1326,6 +1543,7 @@ extern void rehash_node (void)
 			continue;	/* vestigial record */
 		xhash_add(node_hash_table, node_ptr);
 	}
+	_name_index_build();
 
 #if _DEBUG
 	_dump_hash();
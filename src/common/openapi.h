@@ -331,6 +331,9 @@ typedef struct {
 typedef struct {
 	time_t update_time;
 	uint16_t show_flags;
+	uint32_t limit; /* max number of jobs to return or 0 for all */
+	uint32_t cursor; /* only return jobs with job_id > cursor */
+	list_t *fields; /* list of job field names (char *) or NULL for all */
 } openapi_job_info_query_t;
 
 typedef struct {
@@ -228,7 +228,8 @@ extern int try_grow_buf(buf_t *buffer, uint32_t size)
 		return ESLURM_DATA_TOO_LARGE;
 	}
 
-	if (!try_xrealloc(buffer->head, new_size))
+	/* Only bytes up to processed are ever read back */
+	if (!try_xrealloc_nz(buffer->head, new_size))
 		return ENOMEM;
 
 	buffer->size = new_size;
@@ -922,7 +923,7 @@ int unpackmem_xmalloc(char **valp, uint32_t *size_valp, buf_t *buffer)
 	if (remaining_buf(buffer) < *size_valp)
 		goto unpack_error;
 
-	safe_xmalloc(*valp, *size_valp);
+	safe_xmalloc_nz(*valp, *size_valp);
 	memcpy(*valp, &buffer->head[buffer->processed], *size_valp);
 	buffer->processed += *size_valp;
 
@@ -960,7 +961,7 @@ int unpackstr_xmalloc(char **valp, uint32_t *size_valp, buf_t *buffer)
 		goto unpack_error;
 	if (buffer->head[buffer->processed + *size_valp - 1] != '\0')
 		goto unpack_error;
-	safe_xmalloc(*valp, *size_valp);
+	safe_xmalloc_nz(*valp, *size_valp);
 	memcpy(*valp, &buffer->head[buffer->processed], *size_valp);
 	buffer->processed += *size_valp;
 
@@ -354,13 +354,24 @@ extern int unpackmem_array(char *valp, uint32_t size_valp, buf_t *buffer);
 		*bitmap = NULL;						\
 } while (0)
 
-/* note: this would be faster if collapsed into a single function
- * rather than a combination of unpack_bit_str_hex and bitstr2inx */
-#define unpack_bit_str_hex_as_inx(inx, buf) do {	\
-	bitstr_t *b = NULL;				\
-	unpack_bit_str_hex(&b, buf);			\
-	*inx = bitstr2inx(b);				\
-	FREE_NULL_BITMAP(b);				\
+/*
+ * Same wire format as unpack_bit_str_hex() but converts the hex mask in place
+ * to inx format without allocating a copy of the mask or a bitstring.
+ */
+#define unpack_bit_str_hex_as_inx(inx, buf) do {			\
+	char *_mask = NULL;						\
+	uint32_t _size, _len = 0;					\
+	xassert(buf->magic == BUF_MAGIC);				\
+	safe_unpack32(&_size, buf);					\
+	if (_size != NO_VAL) {						\
+		safe_unpackmem_ptr(&_mask, &_len, buf);			\
+		if (_len && (_mask[_len - 1] != '\0'))			\
+			goto unpack_error;				\
+	}								\
+	if ((_size == NO_VAL) || !_size)				\
+		*inx = bitstr2inx(NULL);				\
+	else if (!(*inx = hexmask2inx(_mask, _size)))			\
+		goto unpack_error;					\
 } while (0)
 
 #define unpack_bit_str_hex_as_fmt_str(str, buf) do {	\
@@ -426,6 +437,15 @@ extern int unpackmem_array(char *valp, uint32_t size_valp, buf_t *buffer);
 		goto unpack_error;			\
 } while (0)
 
+/* As safe_xmalloc() for memory that is about to be overwritten entirely */
+#define safe_xmalloc_nz(p, sz) do {			\
+	size_t _sz = sz;				\
+	if (!_sz)					\
+		p = NULL;				\
+	else if (!(p = try_xmalloc_nz(_sz)))		\
+		goto unpack_error;			\
+} while (0)
+
 #define FREE_NULL_BUFFER(_X)		\
 	do {				\
 		if (_X) free_buf (_X);	\
@@ -40,7 +40,6 @@
 \*****************************************************************************/
 
 #include <ctype.h>
-#include <regex.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -62,7 +61,6 @@
 #include "src/common/slurm_protocol_socket.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
-#include "src/common/xregex.h"
 #include "src/common/xstring.h"
 
 #include "slurm/slurm.h"
@@ -90,14 +88,6 @@ strong_alias(transfer_s_p_options,	slurm_transfer_s_p_options);
 
 #define CONF_HASH_LEN 173
 
-static char *keyvalue_pattern =
-	"^[[:space:]]*"
-	"([[:alnum:]_.]+)" /* key */
-	"[[:space:]]*([-*+/]?)=[[:space:]]*"
-	"((\"([^\"]*)\")|([^[:space:]]+))" /* value: quoted with whitespace,
-					    * or unquoted and no whitespace */
-	"([[:space:]]|$)";
-
 struct s_p_values {
 	char *key;
 	int type;
@@ -112,7 +102,6 @@ struct s_p_values {
 };
 
 struct s_p_hashtbl {
-	regex_t keyvalue_re;
 	s_p_values_t *hash[CONF_HASH_LEN];
 };
 
@@ -200,9 +189,6 @@ s_p_hashtbl_t *s_p_hashtbl_create_cnt(const s_p_options_t options[], int *cnt)
 		_conf_hashtbl_insert(tbl, value);
 	}
 
-	if (regcomp(&tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return tbl;
 }
 
@@ -286,68 +272,99 @@ void s_p_hashtbl_destroy(s_p_hashtbl_t *tbl)
 		}
 	}
 
-	regfree(&tbl->keyvalue_re);
-
 	xfree(tbl);
 }
 
 /*
- * IN tbl - table to work off
+ * Find the first key=value pair at the start of line:
+ *
+ *	[space]* key [space]* [-*+/]? = [space]* value ([space] | end)
+ *
+ * key is made of alphanumerics, '_' and '.'. value is either a quoted string,
+ * which may contain whitespace, or a run of non-whitespace. A quoted string
+ * not followed by whitespace or the end of the line is taken as part of an
+ * unquoted value, quotes included.
+ *
  * IN line - string to be search for a key=value pair
  * OUT key - pointer to the key string (caller must free with xfree())
  * OUT value - pointer to the value string (caller must free with xfree())
  * OUT remaining - pointer into the "line" string denoting the start
  *                 of the unsearched portion of the string
+ * OUT operator - operator preceding '=', S_P_OPERATOR_SET if none
  * Return 0 when a key-value pair is found, and -1 otherwise.
  */
-static int _keyvalue_regex(s_p_hashtbl_t *tbl, const char *line,
-			   char **key, char **value, char **remaining,
+static int _keyvalue_parse(const char *line, char **key, char **value,
+			   char **remaining,
 			   slurm_parser_operator_t *operator)
 {
-	size_t nmatch = 8;
-	regmatch_t pmatch[8];
-	char op;
-	int rc;
+	const char *p = line, *key_ptr, *value_ptr, *end;
+	int value_len;
 
 	*key = NULL;
 	*value = NULL;
-	*remaining = (char *)line;
+	*remaining = (char *) line;
 	*operator = S_P_OPERATOR_SET;
-	memset(pmatch, 0, sizeof(regmatch_t)*nmatch);
 
-	if ((rc = regexec(&tbl->keyvalue_re, line, nmatch, pmatch, 0))) {
-		if (rc != REG_NOMATCH)
-			dump_regex_error(rc, &tbl->keyvalue_re, "regexec(%s)",
-					 line);
+	while (isspace((unsigned char) *p))
+		p++;
+
+	key_ptr = p;
+	while (isalnum((unsigned char) *p) || (*p == '_') || (*p == '.'))
+		p++;
+	if (p == key_ptr)
+		return -1;
+	end = p;
+
+	while (isspace((unsigned char) *p))
+		p++;
+
+	if (*p == '+') {
+		*operator = S_P_OPERATOR_ADD;
+		p++;
+	} else if (*p == '-') {
+		*operator = S_P_OPERATOR_SUB;
+		p++;
+	} else if (*p == '*') {
+		*operator = S_P_OPERATOR_MUL;
+		p++;
+	} else if (*p == '/') {
+		*operator = S_P_OPERATOR_DIV;
+		p++;
+	}
+	if (*p++ != '=') {
+		*operator = S_P_OPERATOR_SET;
 		return -1;
 	}
 
-	*key = (char *)(xstrndup(line + pmatch[1].rm_so,
-				 pmatch[1].rm_eo - pmatch[1].rm_so));
-	if (pmatch[2].rm_so != -1 &&
-	    (pmatch[2].rm_so != pmatch[2].rm_eo)) {
-		op = *(line + pmatch[2].rm_so);
-		if (op == '+') {
-			*operator = S_P_OPERATOR_ADD;
-		} else if (op == '-') {
-			*operator = S_P_OPERATOR_SUB;
-		} else if (op == '*') {
-			*operator = S_P_OPERATOR_MUL;
-		} else if (op == '/') {
-			*operator = S_P_OPERATOR_DIV;
+	while (isspace((unsigned char) *p))
+		p++;
+
+	value_ptr = NULL;
+	if (*p == '"') {
+		const char *close = strchr(p + 1, '"');
+
+		if (close && (!close[1] || isspace((unsigned char) close[1]))) {
+			value_ptr = p + 1;
+			value_len = close - value_ptr;
+			*remaining = (char *) (close + 1);
 		}
 	}
-	if (pmatch[5].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[5].rm_so,
-					   pmatch[5].rm_eo - pmatch[5].rm_so));
-	} else if (pmatch[6].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[6].rm_so,
-					   pmatch[6].rm_eo - pmatch[6].rm_so));
-	} else {
-		*value = xstrdup("");
+	if (!value_ptr) {
+		const char *run = p;
+
+		while (*run && !isspace((unsigned char) *run))
+			run++;
+		if (run == p) {
+			*operator = S_P_OPERATOR_SET;
+			return -1;
+		}
+		value_ptr = p;
+		value_len = run - p;
+		*remaining = (char *) run;
 	}
 
-	*remaining = (char *)(line + pmatch[3].rm_eo);
+	*key = xstrndup(key_ptr, end - key_ptr);
+	*value = xstrndup(value_ptr, value_len);
 
 	return 0;
 }
@@ -517,13 +534,6 @@ s_p_hashtbl_t *_hashtbl_copy_keys(const s_p_hashtbl_t *from_tbl)
 		}
 	}
 
-	/*
-	 * We cannot copy a regex since a regfree() on either
-	 * the original or the copy can affect the other one.
-	 */
-	if (regcomp(&to_tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return to_tbl;
 }
 
@@ -990,7 +1000,7 @@ int s_p_parse_line(s_p_hashtbl_t *hashtbl, const char *line, char **leftover)
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	while (_keyvalue_regex(hashtbl, ptr, &key, &value, &new_leftover, &op) == 0) {
+	while (_keyvalue_parse(ptr, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			if (_handle_keyvalue_match(p, value, new_leftover,
@@ -1027,7 +1037,7 @@ static int _parse_next_key(s_p_hashtbl_t *hashtbl,
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	if (_keyvalue_regex(hashtbl, line, &key, &value, &new_leftover, &op) == 0) {
+	if (_keyvalue_parse(line, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			if (_handle_keyvalue_match(p, value, new_leftover,
@@ -1577,13 +1587,6 @@ static s_p_hashtbl_t *_parse_expline_adapt_table(const s_p_hashtbl_t *tbl)
 		}
 	}
 
-	/*
-	 * We cannot copy a regex since a regfree() on either
-	 * the original or the copy can affect the other one.
-	 */
-	if (regcomp(&to_tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return to_tbl;
 }
 
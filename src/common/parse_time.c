@@ -668,8 +668,8 @@ static void _make_time_str_internal(time_t *time, bool utc, char *string,
 	} else if (*time == (time_t) NO_VAL) {
 		snprintf(string, size, "None");
 	} else {
-		static char fmt_buf[32];
-		static const char *display_fmt = "%FT%T";
+		char fmt_buf[32];
+		const char *display_fmt = "%FT%T";
 
 		if (!utc) {
 			char *fmt = getenv("SLURM_TIME_FORMAT");
@@ -994,7 +994,8 @@ static buf_t *_slurm_persist_recv_msg(persist_conn_t *persist_conn,
 		goto endit;
 	}
 
-	msg = try_xmalloc(msg_size);
+	/* Freed below unless every byte is read */
+	msg = try_xmalloc_nz(msg_size);
 	if (!msg) {
 		error("%s: Unable to allocate msg with %u bytes",
 		      __func__, msg_size);
@@ -0,0 +1,176 @@
+/*****************************************************************************\
+ *  plugin_stats.c - per plugin operation timing
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "src/common/macros.h"
+#include "src/common/plugin_stats.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#define PLUGIN_STATS_MAX 256
+
+typedef struct {
+	char *plugin;
+	const char *op;
+	uint32_t calls;
+	uint64_t time;	/* usec */
+	uint64_t max;	/* usec */
+	uint32_t hist[RPC_HIST_CNT];
+} plugin_op_stats_t;
+
+static bool enabled = false;
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static plugin_op_stats_t stats[PLUGIN_STATS_MAX];
+static uint32_t stats_cnt = 0;
+
+static uint64_t _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t) ts.tv_sec * USEC_IN_SEC) + (ts.tv_nsec / 1000);
+}
+
+/* Call with stats_mutex held */
+static plugin_op_stats_t *_find(const char *plugin, const char *op)
+{
+	plugin_op_stats_t *s;
+
+	for (int i = 0; i < stats_cnt; i++) {
+		if ((stats[i].op == op) && !xstrcmp(stats[i].plugin, plugin))
+			return &stats[i];
+	}
+
+	if (stats_cnt >= PLUGIN_STATS_MAX)
+		return NULL;
+
+	s = &stats[stats_cnt++];
+	s->plugin = xstrdup(plugin);
+	s->op = op;
+
+	return s;
+}
+
+extern void plugin_stats_enable(void)
+{
+	__atomic_store_n(&enabled, true, __ATOMIC_RELAXED);
+}
+
+extern uint64_t plugin_stats_start(void)
+{
+	if (!__atomic_load_n(&enabled, __ATOMIC_RELAXED))
+		return 0;
+
+	return _now();
+}
+
+extern void plugin_stats_end(uint64_t start, const char *plugin,
+			     const char *op)
+{
+	plugin_op_stats_t *s;
+	uint64_t delta;
+
+	if (!start)
+		return;
+
+	delta = _now() - start;
+
+	slurm_mutex_lock(&stats_mutex);
+	if ((s = _find(plugin, op))) {
+		s->calls++;
+		s->time += delta;
+		s->max = MAX(s->max, delta);
+		s->hist[rpc_hist_bucket(delta)]++;
+	}
+	slurm_mutex_unlock(&stats_mutex);
+}
+
+extern void plugin_stats_reset(void)
+{
+	slurm_mutex_lock(&stats_mutex);
+	for (int i = 0; i < stats_cnt; i++) {
+		stats[i].calls = 0;
+		stats[i].time = 0;
+		stats[i].max = 0;
+		memset(stats[i].hist, 0, sizeof(stats[i].hist));
+	}
+	slurm_mutex_unlock(&stats_mutex);
+}
+
+extern uint32_t plugin_stats_get(char ***plugins, char ***ops,
+				 uint32_t **calls, uint64_t **time,
+				 uint64_t **max, uint32_t **hist)
+{
+	uint32_t cnt;
+
+	*plugins = *ops = NULL;
+	*calls = *hist = NULL;
+	*time = *max = NULL;
+
+	if (!__atomic_load_n(&enabled, __ATOMIC_RELAXED))
+		return 0;
+
+	slurm_mutex_lock(&stats_mutex);
+	if (!(cnt = stats_cnt)) {
+		slurm_mutex_unlock(&stats_mutex);
+		return 0;
+	}
+
+	*plugins = xcalloc(cnt, sizeof(char *));
+	*ops = xcalloc(cnt, sizeof(char *));
+	*calls = xcalloc(cnt, sizeof(uint32_t));
+	*time = xcalloc(cnt, sizeof(uint64_t));
+	*max = xcalloc(cnt, sizeof(uint64_t));
+	*hist = xcalloc(cnt * RPC_HIST_CNT, sizeof(uint32_t));
+	for (int i = 0; i < cnt; i++) {
+		(*plugins)[i] = stats[i].plugin;
+		(*ops)[i] = (char *) stats[i].op;
+		(*calls)[i] = stats[i].calls;
+		(*time)[i] = stats[i].time;
+		(*max)[i] = stats[i].max;
+		memcpy(&(*hist)[i * RPC_HIST_CNT], stats[i].hist,
+		       sizeof(stats[i].hist));
+	}
+	slurm_mutex_unlock(&stats_mutex);
+
+	return cnt;
+}
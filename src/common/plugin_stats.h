@@ -0,0 +1,81 @@
+/*****************************************************************************\
+ *  plugin_stats.h - per plugin operation timing
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _PLUGIN_STATS_H
+#define _PLUGIN_STATS_H
+
+#include <inttypes.h>
+
+/*
+ * Optional call count and latency accounting for plugin operations,
+ * recorded by the *_g_*() dispatch functions in src/interfaces.
+ *
+ * Usage in a dispatch function:
+ *	uint64_t start = plugin_stats_start();
+ *	rc = (*(ops[i].op))(...);
+ *	plugin_stats_end(start, g_context[i]->type, __func__);
+ *
+ * While disabled plugin_stats_start() returns 0 and plugin_stats_end()
+ * returns immediately.
+ */
+
+extern void plugin_stats_enable(void);
+
+/* RET start time for plugin_stats_end() or 0 if accounting is disabled */
+extern uint64_t plugin_stats_start(void);
+
+/*
+ * Record one call started at start.
+ * IN plugin - plugin type, e.g. "select/cons_tres"
+ * IN op - name of the dispatching function, must be a static string
+ */
+extern void plugin_stats_end(uint64_t start, const char *plugin,
+			     const char *op);
+
+/* Zero all counters, keeping the known operations */
+extern void plugin_stats_reset(void);
+
+/*
+ * Copy out the counters.
+ * OUT plugins, ops - xmalloc()'d arrays of names owned by plugin_stats
+ * OUT calls, time, max - xmalloc()'d arrays of counters, times in usec
+ * OUT hist - xmalloc()'d array of RPC_HIST_CNT log2 buckets per operation
+ * RET number of operations, 0 if accounting is not enabled
+ */
+extern uint32_t plugin_stats_get(char ***plugins, char ***ops,
+				 uint32_t **calls, uint64_t **time,
+				 uint64_t **max, uint32_t **hist);
+
+#endif
@@ -5286,6 +5286,9 @@ static int _validate_and_set_defaults(slurm_conf_t *conf,
 	if (xstrcasestr(conf->slurmd_params, "contain_spank"))
 		conf->conf_flags |= CONF_FLAG_CONTAIN_SPANK;
 
+	if (xstrcasestr(conf->slurmd_params, "push_heartbeat"))
+		conf->conf_flags |= CONF_FLAG_PUSH_HB;
+
 	if (!s_p_get_string(&conf->slurmd_pidfile, "SlurmdPidFile", hashtbl))
 		conf->slurmd_pidfile = xstrdup(DEFAULT_SLURMD_PIDFILE);
 
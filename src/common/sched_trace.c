@@ -0,0 +1,270 @@
+/*****************************************************************************\
+ *  sched_trace.c - binary trace ring of scheduler decisions
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "src/common/fd.h"
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/pack.h"
+#include "src/common/sched_trace.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/strlcpy.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#define SCHED_TRACE_MAGIC 0x53545243	/* "STRC" */
+
+bool sched_trace_active = false;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static sched_trace_rec_t *trace_ring = NULL;
+static uint32_t trace_size = 0;		/* record slots in trace_ring */
+static uint32_t trace_next = 0;		/* next slot to write */
+static bool trace_wrapped = false;	/* every slot has been written */
+
+extern void sched_trace_init(uint32_t records)
+{
+	slurm_mutex_lock(&trace_mutex);
+	if (records != trace_size) {
+		xfree(trace_ring);
+		if (records)
+			trace_ring = xcalloc(records, sizeof(*trace_ring));
+		trace_size = records;
+		trace_next = 0;
+		trace_wrapped = false;
+		sched_trace_active = (records != 0);
+	}
+	slurm_mutex_unlock(&trace_mutex);
+}
+
+extern void sched_trace_fini(void)
+{
+	sched_trace_init(0);
+}
+
+extern void sched_trace_add(sched_trace_phase_t phase, uint8_t flags,
+			    uint32_t job_id, const char *part, int result,
+			    uint32_t nodes_tested)
+{
+	sched_trace_rec_t *rec;
+	struct timeval now;
+
+	if (!sched_trace_active)
+		return;
+
+	gettimeofday(&now, NULL);
+
+	slurm_mutex_lock(&trace_mutex);
+	if (!trace_size) {
+		slurm_mutex_unlock(&trace_mutex);
+		return;
+	}
+	rec = &trace_ring[trace_next];
+	rec->usec = ((uint64_t) now.tv_sec * USEC_IN_SEC) + now.tv_usec;
+	rec->job_id = job_id;
+	rec->nodes_tested = nodes_tested;
+	rec->result = result;
+	rec->phase = phase;
+	rec->flags = flags;
+	if (part)
+		strlcpy(rec->part, part, sizeof(rec->part));
+	else
+		rec->part[0] = '\0';
+	if (++trace_next >= trace_size) {
+		trace_next = 0;
+		trace_wrapped = true;
+	}
+	slurm_mutex_unlock(&trace_mutex);
+}
+
+static void _pack_rec(sched_trace_rec_t *rec, buf_t *buffer)
+{
+	pack64(rec->usec, buffer);
+	pack32(rec->job_id, buffer);
+	pack32(rec->nodes_tested, buffer);
+	pack32((uint32_t) rec->result, buffer);
+	pack8(rec->phase, buffer);
+	pack8(rec->flags, buffer);
+	packstr(rec->part, buffer);
+}
+
+static int _unpack_rec(sched_trace_rec_t *rec, buf_t *buffer)
+{
+	char *part = NULL;
+	uint32_t result;
+
+	safe_unpack64(&rec->usec, buffer);
+	safe_unpack32(&rec->job_id, buffer);
+	safe_unpack32(&rec->nodes_tested, buffer);
+	safe_unpack32(&result, buffer);
+	rec->result = (int32_t) result;
+	safe_unpack8(&rec->phase, buffer);
+	safe_unpack8(&rec->flags, buffer);
+	safe_unpackstr(&part, buffer);
+	strlcpy(rec->part, part ? part : "", sizeof(rec->part));
+	xfree(part);
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(part);
+	return SLURM_ERROR;
+}
+
+extern int sched_trace_dump(const char *path)
+{
+	int fd, rc = SLURM_SUCCESS;
+	uint32_t cnt, i, j;
+	char *new_path;
+	buf_t *buffer;
+
+	slurm_mutex_lock(&trace_mutex);
+	if (!trace_size) {
+		slurm_mutex_unlock(&trace_mutex);
+		return ESLURM_DISABLED;
+	}
+
+	/* Copy the ring out while locked, write the file without the lock */
+	cnt = trace_wrapped ? trace_size : trace_next;
+	buffer = init_buf(BUF_SIZE + (cnt * (sizeof(sched_trace_rec_t) + 4)));
+	pack32(SCHED_TRACE_MAGIC, buffer);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(time(NULL), buffer);
+	pack32(cnt, buffer);
+	j = trace_wrapped ? trace_next : 0;
+	for (i = 0; i < cnt; i++) {
+		_pack_rec(&trace_ring[j], buffer);
+		if (++j >= trace_size)
+			j = 0;
+	}
+	slurm_mutex_unlock(&trace_mutex);
+
+	new_path = xstrdup_printf("%s.new", path);
+	fd = open(new_path, O_CREAT|O_WRONLY|O_TRUNC|O_CLOEXEC, 0600);
+	if (fd < 0) {
+		rc = errno;
+		error("%s: unable to create %s: %m", __func__, new_path);
+		goto fini;
+	}
+	safe_write(fd, get_buf_data(buffer), get_buf_offset(buffer));
+	if ((rc = fsync_and_close(fd, "sched_trace")))
+		goto fini;
+	if (rename(new_path, path)) {
+		rc = errno;
+		error("%s: unable to rename %s to %s: %m",
+		      __func__, new_path, path);
+	}
+	goto fini;
+
+rwfail:
+	rc = errno;
+	error("%s: unable to write %s: %m", __func__, new_path);
+	(void) close(fd);
+fini:
+	if (rc)
+		(void) unlink(new_path);
+	xfree(new_path);
+	FREE_NULL_BUFFER(buffer);
+	return rc;
+}
+
+extern int sched_trace_load(const char *path, sched_trace_rec_t **recs,
+			    uint32_t *rec_cnt, time_t *dump_time)
+{
+	uint32_t magic, cnt = 0, i;
+	uint16_t protocol_version;
+	sched_trace_rec_t *tmp = NULL;
+	buf_t *buffer;
+
+	*recs = NULL;
+	*rec_cnt = 0;
+
+	if (!(buffer = create_mmap_buf(path)))
+		return errno ? errno : SLURM_ERROR;
+
+	safe_unpack32(&magic, buffer);
+	if (magic != SCHED_TRACE_MAGIC) {
+		error("%s: %s is not a scheduler trace file", __func__, path);
+		goto unpack_error;
+	}
+	safe_unpack16(&protocol_version, buffer);
+	if ((protocol_version > SLURM_PROTOCOL_VERSION) ||
+	    (protocol_version < SLURM_MIN_PROTOCOL_VERSION)) {
+		error("%s: %s has unsupported version %hu",
+		      __func__, path, protocol_version);
+		goto unpack_error;
+	}
+	safe_unpack_time(dump_time, buffer);
+	safe_unpack32(&cnt, buffer);
+	/* Each packed record needs at least 26 bytes */
+	if (cnt > (remaining_buf(buffer) / 26))
+		goto unpack_error;
+
+	tmp = xcalloc(cnt ? cnt : 1, sizeof(*tmp));
+	for (i = 0; i < cnt; i++) {
+		if (_unpack_rec(&tmp[i], buffer))
+			goto unpack_error;
+	}
+
+	FREE_NULL_BUFFER(buffer);
+	*recs = tmp;
+	*rec_cnt = cnt;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("%s: unable to read scheduler trace file %s", __func__, path);
+	xfree(tmp);
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_ERROR;
+}
+
+extern const char *sched_trace_phase_str(uint8_t phase)
+{
+	switch (phase) {
+	case SCHED_TRACE_MAIN:
+		return "Main";
+	case SCHED_TRACE_BACKFILL:
+		return "Backfill";
+	case SCHED_TRACE_SELECT:
+		return "Select";
+	}
+
+	return "Unknown";
+}
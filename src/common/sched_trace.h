@@ -0,0 +1,101 @@
+/*****************************************************************************\
+ *  sched_trace.h - binary trace ring of scheduler decisions
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SCHED_TRACE_H
+#define _SCHED_TRACE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "slurm/slurm.h"
+
+/* Scheduler code path which produced a trace record */
+typedef enum {
+	SCHED_TRACE_MAIN = 1,	/* _schedule() */
+	SCHED_TRACE_BACKFILL,	/* _attempt_backfill() */
+	SCHED_TRACE_SELECT,	/* select_nodes() */
+} sched_trace_phase_t;
+
+/* sched_trace_rec_t flags */
+#define SCHED_TRACE_FLAG_TEST_ONLY	SLURM_BIT(0)
+
+#define SCHED_TRACE_PART_LEN 32
+
+typedef struct {
+	uint64_t usec;		/* time of the decision, usec since epoch */
+	uint32_t job_id;
+	uint32_t nodes_tested;	/* candidate nodes considered, 0 if unknown */
+	int32_t result;		/* SLURM_SUCCESS or slurm errno */
+	uint8_t phase;		/* sched_trace_phase_t */
+	uint8_t flags;		/* SCHED_TRACE_FLAG_* */
+	char part[SCHED_TRACE_PART_LEN]; /* partition, may be truncated */
+} sched_trace_rec_t;
+
+/* Set while a trace ring is allocated, callers may skip building records */
+extern bool sched_trace_active;
+
+/*
+ * (Re)size the trace ring to hold the most recent "records" decisions.
+ * Existing records are discarded if the size changes. 0 disables tracing.
+ */
+extern void sched_trace_init(uint32_t records);
+
+extern void sched_trace_fini(void);
+
+/* Append a record to the trace ring, overwriting the oldest if full */
+extern void sched_trace_add(sched_trace_phase_t phase, uint8_t flags,
+			    uint32_t job_id, const char *part, int result,
+			    uint32_t nodes_tested);
+
+/*
+ * Write the trace ring, oldest record first, to the file "path".
+ * RET SLURM_SUCCESS, ESLURM_DISABLED if tracing is off, or errno
+ */
+extern int sched_trace_dump(const char *path);
+
+/*
+ * Read a file written by sched_trace_dump().
+ * OUT recs - xmalloc()'d array of records, caller must xfree()
+ * OUT rec_cnt - number of records in recs
+ * OUT dump_time - time the file was written
+ * RET SLURM_SUCCESS or error code
+ */
+extern int sched_trace_load(const char *path, sched_trace_rec_t **recs,
+			    uint32_t *rec_cnt, time_t *dump_time);
+
+extern const char *sched_trace_phase_str(uint8_t phase);
+
+#endif
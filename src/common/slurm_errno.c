@@ -547,6 +547,8 @@ slurm_errtab_t slurm_errtab[] = {
 	  "Unable to satisfy cpu bind request"			},
 	{ ERRTAB_ENTRY(ESLURMD_CPU_LAYOUT_ERROR),
 	  "Unable to layout tasks on given cpus"		},
+	{ ERRTAB_ENTRY(ESLURMD_BCAST_BLOCK_MISSING),
+	  "File broadcast block not found in block cache"	},
 
 	/* socket specific Slurm communications error */
 
@@ -56,6 +56,10 @@
 #include <time.h>
 #include <unistd.h>
 
+#if HAVE_LZ4
+#include <lz4.h>
+#endif
+
 #include "src/common/assoc_mgr.h"
 #include "src/common/fd.h"
 #include "src/common/forward.h"
@@ -86,6 +90,32 @@ typedef struct {
 	slurm_addr_t vip_addr;
 } slurm_protocol_config_t;
 
+/*
+ * Buffers kept by each thread between slurm_send_node_msg() calls so that
+ * steady state sends reuse already grown buffers instead of allocating and
+ * page faulting new ones for every message.
+ */
+typedef struct {
+	buf_t *header;
+	buf_t *auth;
+	buf_t *body;
+	uint32_t body_peak; /* largest body packed since last trim */
+	uint32_t body_uses; /* messages packed since last trim */
+} send_buf_cache_t;
+
+/*
+ * Resolved controller addresses, kept so that every RPC to slurmctld does
+ * not resolve each SlurmctldHost again. Ports are filled in per call.
+ */
+typedef struct {
+	slurm_addr_t *controller_addr;
+	int control_cnt;
+	time_t expiration;
+	time_t last_update;	/* slurm_conf.last_update when resolved */
+	slurm_addr_t vip_addr;
+	bool vip_addr_set;
+} ctld_addr_cache_t;
+
 strong_alias(convert_num_unit2, slurm_convert_num_unit2);
 strong_alias(convert_num_unit, slurm_convert_num_unit);
 strong_alias(revert_num_unit, slurm_revert_num_unit);
@@ -95,9 +125,17 @@ strong_alias(get_unit_type, slurm_get_unit_type);
 /* EXTERNAL VARIABLES */
 
 /* #DEFINES */
+/* Number of sends between checks if the cached body buffer is oversized */
+#define SEND_BUF_TRIM_INTERVAL 64
+/* Smallest message body compressed for peers accepting compression */
+#define MSG_COMPRESS_MIN_SIZE (64 * 1024)
 
 /* STATIC VARIABLES */
 static int message_timeout = -1;
+static pthread_key_t send_buf_cache_key;
+static pthread_once_t send_buf_cache_once = PTHREAD_ONCE_INIT;
+static ctld_addr_cache_t ctld_addr_cache = { 0 };
+static pthread_mutex_t ctld_addr_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* STATIC FUNCTIONS */
 static char *_global_auth_key(void);
@@ -120,6 +158,52 @@ static void _slurm_api_free_comm_config(slurm_protocol_config_t *proto_conf)
 	}
 }
 
+/*
+ * Refresh ctld_addr_cache from conf unless it is still valid.
+ * Call with slurm_conf and ctld_addr_cache_mutex locked.
+ */
+static void _ctld_addr_cache_refresh(slurm_conf_t *conf)
+{
+	ctld_addr_cache_t *cache = &ctld_addr_cache;
+	time_t now = time(NULL);
+	bool resolved = true;
+
+	if (cache->controller_addr &&
+	    (cache->last_update == conf->last_update) &&
+	    (cache->control_cnt == conf->control_cnt) &&
+	    (cache->expiration > now))
+		return;
+
+	xfree(cache->controller_addr);
+	cache->controller_addr = xcalloc(conf->control_cnt,
+					 sizeof(slurm_addr_t));
+	cache->control_cnt = conf->control_cnt;
+
+	for (int i = 0; i < cache->control_cnt; i++) {
+		if (!conf->control_addr[i])
+			continue;
+		slurm_set_addr(&cache->controller_addr[i], 0,
+			       conf->control_addr[i]);
+		if (slurm_addr_is_unspec(&cache->controller_addr[i]))
+			resolved = false;
+	}
+
+	cache->vip_addr_set = false;
+	if (conf->slurmctld_addr) {
+		cache->vip_addr_set = true;
+		slurm_set_addr(&cache->vip_addr, 0, conf->slurmctld_addr);
+		if (slurm_addr_is_unspec(&cache->vip_addr))
+			resolved = false;
+	}
+
+	cache->last_update = conf->last_update;
+	/* Try again on the next call if anything failed to resolve */
+	if (resolved)
+		cache->expiration = now + conf->getnameinfo_cache_timeout;
+	else
+		cache->expiration = 0;
+}
+
 /*
  * Get communication data structure based upon configuration file
  * RET communication information structure, call _slurm_api_free_comm_config
@@ -146,24 +230,28 @@ static slurm_protocol_config_t *_slurm_api_get_comm_config(void)
 	port = slurm_conf.slurmctld_port;
 	port += (time(NULL) + getpid()) % slurm_conf.slurmctld_port_count;
 
+	slurm_mutex_lock(&ctld_addr_cache_mutex);
+	_ctld_addr_cache_refresh(conf);
+
 	proto_conf = xmalloc(sizeof(slurm_protocol_config_t));
-	proto_conf->controller_addr = xcalloc(conf->control_cnt,
+	proto_conf->control_cnt = ctld_addr_cache.control_cnt;
+	proto_conf->controller_addr = xcalloc(proto_conf->control_cnt,
 					      sizeof(slurm_addr_t));
-	proto_conf->control_cnt = conf->control_cnt;
+	memcpy(proto_conf->controller_addr, ctld_addr_cache.controller_addr,
+	       (sizeof(slurm_addr_t) * proto_conf->control_cnt));
 
 	for (int i = 0; i < proto_conf->control_cnt; i++) {
-
-		if (conf->control_addr[i]) {
-			slurm_set_addr(&proto_conf->controller_addr[i],
-				       port, conf->control_addr[i]);
-		}
+		if (!slurm_addr_is_unspec(&proto_conf->controller_addr[i]))
+			slurm_set_port(&proto_conf->controller_addr[i], port);
 	}
 
-	if (conf->slurmctld_addr) {
+	if (ctld_addr_cache.vip_addr_set) {
 		proto_conf->vip_addr_set = true;
-		slurm_set_addr(&proto_conf->vip_addr, port,
-			       conf->slurmctld_addr);
+		proto_conf->vip_addr = ctld_addr_cache.vip_addr;
+		if (!slurm_addr_is_unspec(&proto_conf->vip_addr))
+			slurm_set_port(&proto_conf->vip_addr, port);
 	}
+	slurm_mutex_unlock(&ctld_addr_cache_mutex);
 
 cleanup:
 	slurm_conf_unlock();
@@ -272,6 +360,223 @@ static int _compute_hash(buf_t *buffer, slurm_msg_t *msg, slurm_hash_t *hash)
 
 }
 
+/* Release the send buffers of an exiting thread */
+static void _send_buf_cache_destroy(void *arg)
+{
+	send_buf_cache_t *cache = arg;
+
+	FREE_NULL_BUFFER(cache->header);
+	FREE_NULL_BUFFER(cache->auth);
+	FREE_NULL_BUFFER(cache->body);
+	xfree(cache);
+}
+
+static void _send_buf_cache_key_create(void)
+{
+	if (pthread_key_create(&send_buf_cache_key, _send_buf_cache_destroy))
+		fatal("%s: pthread_key_create failed: %m", __func__);
+}
+
+static send_buf_cache_t *_send_buf_cache_get(void)
+{
+	send_buf_cache_t *cache;
+
+	pthread_once(&send_buf_cache_once, _send_buf_cache_key_create);
+
+	if (!(cache = pthread_getspecific(send_buf_cache_key))) {
+		cache = xmalloc(sizeof(*cache));
+		if (pthread_setspecific(send_buf_cache_key, cache))
+			fatal("%s: pthread_setspecific failed: %m", __func__);
+	}
+
+	return cache;
+}
+
+/*
+ * Move the calling thread's cached buffers into buffers for packing.
+ * The auth buffer is left cached when the message will not carry one.
+ */
+static void _send_buf_cache_take(msg_bufs_t *buffers, bool auth)
+{
+	send_buf_cache_t *cache = _send_buf_cache_get();
+
+	buffers->header = cache->header;
+	buffers->body = cache->body;
+	cache->header = NULL;
+	cache->body = NULL;
+
+	if (auth) {
+		buffers->auth = cache->auth;
+		cache->auth = NULL;
+	}
+}
+
+static void _send_buf_cache_store(buf_t **cached, buf_t **buffer)
+{
+	if (!*buffer)
+		return;
+
+	FREE_NULL_BUFFER(*cached);
+	*cached = *buffer;
+	*buffer = NULL;
+}
+
+/*
+ * Return buffers to the calling thread's cache. A body buffer that stayed
+ * more than twice the size of anything packed into it over the last
+ * SEND_BUF_TRIM_INTERVAL sends is released to trim the high water mark left
+ * behind by an occasional huge message.
+ */
+static void _send_buf_cache_put(msg_bufs_t *buffers)
+{
+	send_buf_cache_t *cache = _send_buf_cache_get();
+
+	if (buffers->body) {
+		cache->body_peak = MAX(cache->body_peak,
+				       get_buf_offset(buffers->body));
+
+		if (++cache->body_uses >= SEND_BUF_TRIM_INTERVAL) {
+			if (size_buf(buffers->body) >
+			    MAX(BUF_SIZE, (2 * cache->body_peak)))
+				FREE_NULL_BUFFER(buffers->body);
+			cache->body_peak = 0;
+			cache->body_uses = 0;
+		}
+	}
+
+	_send_buf_cache_store(&cache->header, &buffers->header);
+	_send_buf_cache_store(&cache->auth, &buffers->auth);
+	_send_buf_cache_store(&cache->body, &buffers->body);
+}
+
+#if HAVE_LZ4
+/*
+ * Large info responses which are unpacked into copies of their contents, so
+ * the buffer the body was decompressed into can be discarded afterwards.
+ */
+static bool _msg_type_compressible(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case RESPONSE_ASSOC_MGR_INFO:
+	case RESPONSE_JOB_INFO:
+	case RESPONSE_JOB_STEP_INFO:
+	case RESPONSE_NODE_INFO:
+	case RESPONSE_PARTITION_INFO:
+		return true;
+	default:
+		return false;
+	}
+}
+#endif
+
+/*
+ * Compress a packed message body with LZ4 if the peer has accepted it.
+ * The compressed body is the uncompressed size followed by the LZ4 block.
+ * RET true if buffers->body was replaced with the compressed body
+ */
+static bool _compress_body(slurm_msg_t *msg, msg_bufs_t *buffers)
+{
+#if HAVE_LZ4
+	uint32_t size = get_buf_offset(buffers->body);
+	buf_t *out = NULL;
+	int bound, len;
+
+	if (!(msg->flags & SLURM_MSG_ACCEPT_LZ4) ||
+	    (msg->protocol_version < SLURM_24_11_PROTOCOL_VERSION) ||
+	    (size < MSG_COMPRESS_MIN_SIZE) ||
+	    !_msg_type_compressible(msg->msg_type))
+		return false;
+
+	if ((bound = LZ4_compressBound(size)) <= 0)
+		return false;
+
+	if (!(out = try_init_buf(bound + sizeof(uint32_t))))
+		return false;
+
+	pack32(size, out);
+	len = LZ4_compress_default(get_buf_data(buffers->body),
+				   (get_buf_data(out) + get_buf_offset(out)),
+				   size, bound);
+
+	if ((len <= 0) || ((len + get_buf_offset(out)) >= size)) {
+		/* incompressible, send as is */
+		FREE_NULL_BUFFER(out);
+		return false;
+	}
+
+	set_buf_offset(out, (get_buf_offset(out) + len));
+	log_flag(NET, "%s: compressed %s body from %u to %u bytes",
+		 __func__, rpc_num2string(msg->msg_type), size,
+		 get_buf_offset(out));
+
+	FREE_NULL_BUFFER(buffers->body);
+	buffers->body = out;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* Unpack a received message body, decompressing it first if needed */
+static int _unpack_msg_body(slurm_msg_t *msg, buf_t *buffer)
+{
+#if HAVE_LZ4
+	buf_t *body = NULL;
+	uint32_t size;
+	int rc, len;
+
+	if (!(msg->flags & SLURM_MSG_LZ4))
+		return unpack_msg(msg, buffer);
+
+	safe_unpack32(&size, buffer);
+	if (size > MAX_MSG_SIZE) {
+		error("%s: invalid uncompressed size %u for %s",
+		      __func__, size, rpc_num2string(msg->msg_type));
+		return SLURM_ERROR;
+	}
+
+	if (!(body = try_init_buf(size)))
+		return SLURM_ERROR;
+
+	len = LZ4_decompress_safe((get_buf_data(buffer) +
+				   get_buf_offset(buffer)),
+				  get_buf_data(body), remaining_buf(buffer),
+				  size);
+	if ((len < 0) || (len != size)) {
+		error("%s: LZ4 decompression of %s failed",
+		      __func__, rpc_num2string(msg->msg_type));
+		FREE_NULL_BUFFER(body);
+		return SLURM_ERROR;
+	}
+	set_buf_offset(buffer, size_buf(buffer));
+
+	rc = unpack_msg(msg, body);
+	FREE_NULL_BUFFER(body);
+	return rc;
+
+unpack_error:
+	return SLURM_ERROR;
+#else
+	if (msg->flags & SLURM_MSG_LZ4) {
+		error("%s: received LZ4 compressed %s without LZ4 support",
+		      __func__, rpc_num2string(msg->msg_type));
+		return SLURM_ERROR;
+	}
+
+	return unpack_msg(msg, buffer);
+#endif
+}
+
+/* Reuse a buffer handed in by the caller or create a new one */
+static buf_t *_reset_or_init_buf(buf_t *buffer)
+{
+	if (!buffer)
+		return init_buf(BUF_SIZE);
+
+	set_buf_offset(buffer, 0);
+	return buffer;
+}
+
 static int _get_tres_id(char *type, char *name)
 {
 	slurmdb_tres_rec_t tres_rec;
@@ -946,7 +1251,7 @@ skip_auth:
 
 	if ((header.body_length != remaining_buf(buffer)) ||
 	    _check_hash(buffer, &header, msg, auth_cred) ||
-	    (unpack_msg(msg, buffer) != SLURM_SUCCESS)) {
+	    (_unpack_msg_body(msg, buffer) != SLURM_SUCCESS)) {
 		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
 		auth_g_destroy(auth_cred);
 		goto total_return;
@@ -1242,7 +1547,7 @@ skip_auth:
 
 	if ((header.body_length != remaining_buf(buffer)) ||
 	    _check_hash(buffer, &header, &msg, auth_cred) ||
-	    (unpack_msg(&msg, buffer) != SLURM_SUCCESS)) {
+	    (_unpack_msg_body(&msg, buffer) != SLURM_SUCCESS)) {
 		auth_g_destroy(auth_cred);
 		FREE_NULL_BUFFER(buffer);
 		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
@@ -1424,7 +1729,7 @@ skip_auth:
 	msg.flags = header.flags;
 
 	if ((header.body_length > remaining_buf(buffer)) ||
-	    (unpack_msg(&msg, buffer) != SLURM_SUCCESS)) {
+	    (_unpack_msg_body(&msg, buffer) != SLURM_SUCCESS)) {
 		FREE_NULL_BUFFER(buffer);
 		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
 		goto total_return;
@@ -1679,7 +1984,7 @@ skip_auth:
 
 	if ((header.body_length != remaining_buf(buffer)) ||
 	    _check_hash(buffer, &header, msg, auth_cred) ||
-	     (unpack_msg(msg, buffer) != SLURM_SUCCESS) ) {
+	     (_unpack_msg_body(msg, buffer) != SLURM_SUCCESS) ) {
 		auth_g_destroy(auth_cred);
 		FREE_NULL_BUFFER(buffer);
 		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
@@ -1729,18 +2034,22 @@ extern int slurm_buffers_pack_msg(slurm_msg_t *msg, msg_bufs_t *buffers,
 	time_t start_time = time(NULL);
 	slurm_hash_t hash = { 0 };
 	int h_len = 0;
+	bool compressed;
 
 	if (!msg->restrict_uid_set)
 		fatal("%s: restrict_uid is not set", __func__);
 	/*
 	 * Pack message into buffer
 	 */
-	buffers->body = init_buf(BUF_SIZE);
+	buffers->body = _reset_or_init_buf(buffers->body);
 	pack_msg(msg, buffers->body);
 	log_flag_hex(NET_RAW, get_buf_data(buffers->body),
 		     get_buf_offset(buffers->body),
 		     "%s: packed body", __func__);
 
+	/* the hash covers the body as sent */
+	compressed = _compress_body(msg, buffers);
+
 	if (msg->flags & SLURM_NO_AUTH_CRED)
 		goto skip_auth1;
 
@@ -1783,6 +2092,14 @@ skip_auth1:
 
 	init_header(&header, msg, msg->flags);
 
+	header.flags &= ~SLURM_MSG_LZ4;
+	if (compressed)
+		header.flags |= SLURM_MSG_LZ4;
+#if HAVE_LZ4
+	if (msg->protocol_version >= SLURM_24_11_PROTOCOL_VERSION)
+		header.flags |= SLURM_MSG_ACCEPT_LZ4;
+#endif
+
 	if (msg->flags & SLURM_NO_AUTH_CRED)
 		goto skip_auth2;
 
@@ -1810,7 +2127,7 @@ skip_auth1:
 	/*
 	 * Pack auth credential
 	 */
-	buffers->auth = init_buf(BUF_SIZE);
+	buffers->auth = _reset_or_init_buf(buffers->auth);
 
 	rc = auth_g_pack(auth_cred, buffers->auth, header.version);
 	if (rc) {
@@ -1832,7 +2149,7 @@ skip_auth2:
 	 * Pack and send message
 	 */
 	update_header(&header, get_buf_offset(buffers->body));
-	buffers->header = init_buf(BUF_SIZE);
+	buffers->header = _reset_or_init_buf(buffers->header);
 	pack_header(&header, buffers->header);
 	log_flag_hex(NET_RAW, get_buf_data(buffers->header),
 		     get_buf_offset(buffers->header),
@@ -1845,6 +2162,45 @@ skip_auth2:
  * send message functions
 \**********************************************************************/
 
+/*
+ * Send msg using the body and auth credential in msg->shared_bufs, packed
+ * once by slurm_buffers_pack_msg() for every destination of a message tree.
+ * Only the header, which carries the per-destination forward list, is packed
+ * here into buffers->header.
+ */
+static int _send_shared_msg(int fd, slurm_msg_t *msg, msg_bufs_t *buffers)
+{
+	msg_bufs_t send_bufs;
+	header_t header;
+
+	xassert(msg->shared_bufs->body);
+
+	if (msg->forward.init != FORWARD_INIT) {
+		forward_init(&msg->forward);
+		msg->ret_list = NULL;
+	}
+
+	if (!msg->forward.tree_width)
+		msg->forward.tree_width = slurm_conf.tree_width;
+
+	init_header(&header, msg, msg->flags);
+	header.flags &= ~SLURM_MSG_LZ4;
+#if HAVE_LZ4
+	if (msg->protocol_version >= SLURM_24_11_PROTOCOL_VERSION)
+		header.flags |= SLURM_MSG_ACCEPT_LZ4;
+#endif
+	update_header(&header, get_buf_offset(msg->shared_bufs->body));
+
+	buffers->header = _reset_or_init_buf(buffers->header);
+	pack_header(&header, buffers->header);
+
+	send_bufs.header = buffers->header;
+	send_bufs.auth = msg->shared_bufs->auth;
+	send_bufs.body = msg->shared_bufs->body;
+
+	return slurm_bufs_sendto(fd, &send_bufs);
+}
+
 /*
  * Send a slurm message over an open file descriptor `fd'
  * Returns the size of the message sent in bytes, or -1 on failure.
@@ -1889,10 +2245,14 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 	/*
 	 * Pack and send message
 	 */
-	if ((rc = slurm_buffers_pack_msg(msg, &buffers, true)))
-		goto cleanup;
+	_send_buf_cache_take(&buffers, !(msg->flags & SLURM_NO_AUTH_CRED));
 
-	rc = slurm_bufs_sendto(fd, &buffers);
+	if (msg->shared_bufs)
+		rc = _send_shared_msg(fd, msg, &buffers);
+	else if ((rc = slurm_buffers_pack_msg(msg, &buffers, true)))
+		goto cleanup;
+	else
+		rc = slurm_bufs_sendto(fd, &buffers);
 
 	if (rc >= 0) {
 		/* sent successfully */
@@ -1913,9 +2273,7 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 	}
 
 cleanup:
-	FREE_NULL_BUFFER(buffers.header);
-	FREE_NULL_BUFFER(buffers.auth);
-	FREE_NULL_BUFFER(buffers.body);
+	_send_buf_cache_put(&buffers);
 	return rc;
 }
 
@@ -374,7 +374,8 @@ extern int slurm_unpack_addr_array(slurm_addr_t **addr_array_ptr,
  * Pack message into buffers to be ready to send.
  *
  * IN msg - message to pack
- * IN buffers - buffers to populate with packed message
+ * IN buffers - buffers to populate with packed message. Any buffers already
+ *    set are reset and reused instead of allocating new ones.
  * IN block_for_forwarding - call the forward_wait() which blocks until
  *    forwarding
  * RET SLURM_SUCCESS or error
@@ -105,5 +105,7 @@
 #define CTLD_QUEUE_PROCESSING	SLURM_BIT(5)
 #define SLURM_NO_AUTH_CRED	SLURM_BIT(6)
 #define SLURM_PACK_ADDRS	SLURM_BIT(7)
+#define SLURM_MSG_ACCEPT_LZ4	SLURM_BIT(8) /* sender can receive LZ4 bodies */
+#define SLURM_MSG_LZ4		SLURM_BIT(9) /* body is LZ4 compressed */
 
 #endif
@@ -1379,6 +1379,7 @@ extern void slurm_free_config_response_msg(config_response_msg_t *msg)
 	if (msg) {
 		FREE_NULL_LIST(msg->config_files);
 		xfree(msg->slurmd_spooldir);
+		FREE_NULL_BUFFER(msg->packed);
 		xfree(msg);
 	}
 }
@@ -2224,6 +2225,14 @@ extern void slurm_free_epilog_complete_msg(epilog_complete_msg_t * msg)
 	}
 }
 
+extern void slurm_free_node_heartbeat_msg(node_heartbeat_msg_t *msg)
+{
+	if (msg) {
+		xfree(msg->node_name);
+		xfree(msg);
+	}
+}
+
 extern void slurm_free_srun_job_complete_msg(
 		srun_job_complete_msg_t * msg)
 {
@@ -2341,10 +2350,73 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 			xfree(msg->rpc_dump_hostlist[i]);
 		}
 		xfree(msg->rpc_dump_hostlist);
+		xfree(msg->lock_cnt);
+		xfree(msg->lock_wait_time);
+		xfree(msg->lock_wait_max);
+		xfree(msg->lock_hold_time);
+		xfree(msg->lock_hold_max);
+		xfree(msg->lock_wait_hist);
+		for (i = 0; i < msg->lock_caller_size; i++)
+			xfree(msg->lock_caller_name[i]);
+		xfree(msg->lock_caller_name);
+		xfree(msg->lock_caller_cnt);
+		xfree(msg->lock_caller_wait_time);
+		xfree(msg->lock_caller_wait_max);
+		xfree(msg->lock_caller_hold_time);
+		xfree_array(msg->xmalloc_stats_name);
+		xfree(msg->xmalloc_stats_allocs);
+		xfree(msg->xmalloc_stats_frees);
+		xfree(msg->xmalloc_stats_bytes);
+		xfree(msg->rpc_type_hist);
+		xfree(msg->rpc_user_hist);
+		xfree_array(msg->plugin_stats_name);
+		xfree_array(msg->plugin_stats_op);
+		xfree(msg->plugin_stats_calls);
+		xfree(msg->plugin_stats_time);
+		xfree(msg->plugin_stats_max);
+		xfree(msg->plugin_stats_hist);
 		xfree(msg);
 	}
 }
 
+extern int rpc_hist_bucket(uint64_t usec)
+{
+	int bucket = 0;
+
+	while (usec && (bucket < (RPC_HIST_CNT - 1))) {
+		usec >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+extern uint64_t rpc_hist_percentile(const uint32_t *hist, uint32_t hist_cnt,
+				    double pct)
+{
+	uint64_t total = 0, sum = 0, want;
+	double rank;
+
+	for (int i = 0; i < hist_cnt; i++)
+		total += hist[i];
+	if (!total)
+		return NO_VAL64;
+
+	/* Rank of the wanted sample, rounded up */
+	rank = (total * pct) / 100.0;
+	want = (uint64_t) rank;
+	if ((want < rank) || !want)
+		want++;
+
+	for (int i = 0; i < hist_cnt; i++) {
+		sum += hist[i];
+		if (sum >= want)
+			return i ? (((uint64_t) 1) << i) : 0;
+	}
+
+	return ((uint64_t) 1) << (hist_cnt - 1);
+}
+
 /* Free job array oriented response with individual return codes by task ID */
 extern void slurm_free_job_array_resp(job_array_resp_msg_t *msg)
 {
@@ -4067,6 +4139,21 @@ extern void slurm_free_submit_response_response_msg(submit_response_msg_t * msg)
 	}
 }
 
+extern void slurm_free_submit_jobs_response_msg(
+	submit_jobs_response_msg_t *msg)
+{
+	if (msg) {
+		if (msg->job_submit_user_msg) {
+			for (int i = 0; i < msg->job_cnt; i++)
+				xfree(msg->job_submit_user_msg[i]);
+			xfree(msg->job_submit_user_msg);
+		}
+		xfree(msg->error_code);
+		xfree(msg->job_id);
+		xfree(msg);
+	}
+}
+
 
 /*
  * slurm_free_ctl_conf - free slurm control information response message
@@ -4109,6 +4196,7 @@ extern void slurm_free_job_info_msg(job_info_msg_t * job_buffer_ptr)
 			_free_all_job_info(job_buffer_ptr);
 			xfree(job_buffer_ptr->job_array);
 		}
+		xfree(job_buffer_ptr->job_ids);
 		xfree(job_buffer_ptr);
 	}
 }
@@ -4481,6 +4569,7 @@ extern void slurm_free_file_bcast_msg(file_bcast_msg_t *msg)
 		xfree(msg->block);
 		xfree(msg->fname);
 		xfree(msg->exe_fname);
+		xfree(msg->peer_nodes);
 		xfree(msg->user_name);
 		delete_sbcast_cred(msg->cred);
 		xfree(msg);
@@ -4849,6 +4938,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case MESSAGE_EPILOG_COMPLETE:
 		slurm_free_epilog_complete_msg(data);
 		break;
+	case MESSAGE_NODE_HEARTBEAT:
+		slurm_free_node_heartbeat_msg(data);
+		break;
 	case RESPONSE_JOB_STEP_INFO:
 		slurm_free_job_step_info_response_msg(data);
 		break;
@@ -4901,6 +4993,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case RESPONSE_SUBMIT_BATCH_JOB:
 		slurm_free_submit_response_response_msg(data);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		slurm_free_submit_jobs_response_msg(data);
+		break;
 	case RESPONSE_ACCT_GATHER_UPDATE:
 	case RESPONSE_ACCT_GATHER_ENERGY:
 		slurm_free_acct_gather_node_resp_msg(data);
@@ -5098,6 +5193,7 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
 	case REQUEST_TAKEOVER:
+	case REQUEST_SCHED_TRACE_DUMP:
 	case RESPONSE_FORWARD_FAILED:
 	case REQUEST_DAEMON_STATUS:
 	case REQUEST_HEALTH_CHECK:
@@ -5230,6 +5326,7 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 	case RESPONSE_HET_JOB_ALLOCATION:
 		FREE_NULL_LIST(data);
 		break;
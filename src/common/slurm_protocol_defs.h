@@ -77,6 +77,12 @@
 
 #define FORWARD_INIT 0xfffe
 
+/* Most jobs accepted in one REQUEST_SUBMIT_BATCH_JOBS message */
+#define SUBMIT_BATCH_JOBS_MAX 1000
+
+/* Number of log2 usec buckets in the per RPC processing time histograms */
+#define RPC_HIST_CNT 32
+
 /* Defined job states */
 #define IS_JOB_PENDING(_X)		\
 	((_X->job_state & JOB_STATE_BASE) == JOB_PENDING)
@@ -309,6 +315,10 @@ typedef struct slurm_msg {
 				 buffer starts. */
 	buf_t *buffer;		/* DON'T PACK! ptr to buffer that msg was
 				 * unpacked from. */
+	msg_bufs_t *shared_bufs; /* DON'T PACK OR FREE! body and auth
+				  * credential already packed for this
+				  * message, sent as is instead of packing
+				  * data again. */
 	persist_conn_t *conn;	/* DON'T PACK OR FREE! this is here to
 				 * distinguish a persistent connection from a
 				 * normal connection. It should be filled in
@@ -532,6 +542,12 @@ typedef struct epilog_complete_msg {
 	char    *node_name;
 } epilog_complete_msg_t;
 
+typedef struct node_heartbeat_msg {
+	uint32_t cpu_load;	/* CPU load * 100 */
+	uint64_t free_mem;	/* free memory in MiB */
+	char *node_name;
+} node_heartbeat_msg_t;
+
 #define REBOOT_FLAGS_ASAP 0x0001	/* Drain to reboot ASAP */
 typedef struct reboot_msg {
 	char *features;
@@ -978,6 +994,13 @@ typedef struct {
 typedef struct {
 	List config_files;
 	char *slurmd_spooldir;
+
+	/*
+	 * Do not pack - the message already packed for packed_version, sent
+	 * as is by pack_config_response_msg() for peers of that version
+	 */
+	buf_t *packed;
+	uint16_t packed_version;
 } config_response_msg_t;
 
 typedef struct kvs_get_msg {
@@ -999,6 +1022,8 @@ typedef enum {
 	FILE_BCAST_LAST_BLOCK = 1 << 1,	/* last file block */
 	FILE_BCAST_SO = 1 << 2, 	/* shared object */
 	FILE_BCAST_EXE = 1 << 3,	/* executable ahead of shared object */
+	FILE_BCAST_BY_HASH = 1 << 4,	/* no data, load block_hash from cache */
+	FILE_BCAST_FROM_PEER = 1 << 5,	/* relayed by slurmd for the cred user */
 } file_bcast_flags_t;
 
 typedef struct file_bcast_msg {
@@ -1018,6 +1043,8 @@ typedef struct file_bcast_msg {
 	uint64_t block_offset;	/* offset for this data block */
 	uint32_t uncomp_len;	/* uncompressed length of this data block */
 	char *block;		/* data for this block */
+	slurm_hash_t block_hash; /* hash of uncompressed data, or type 0 */
+	char *peer_nodes;	/* send cached block_hash on to these nodes */
 	uint64_t file_size;	/* file size */
 } file_bcast_msg_t;
 
@@ -1455,6 +1482,20 @@ extern void slurm_free_part_info_request_msg(part_info_request_msg_t *msg);
 extern void slurm_free_sib_msg(sib_msg_t *msg);
 extern void slurm_free_stats_info_request_msg(stats_info_request_msg_t *msg);
 extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg);
+
+/* Map a time in usec to its RPC_HIST_CNT histogram bucket */
+extern int rpc_hist_bucket(uint64_t usec);
+
+/*
+ * Estimate a percentile from an RPC processing time histogram.
+ * Bucket 0 counts 0 usec, bucket N counts [2^(N-1), 2^N) usec and the last
+ * bucket also counts everything longer.
+ * IN hist - hist_cnt buckets
+ * IN pct - percentile wanted, between 0 and 100
+ * RET upper bound of the matching bucket in usec or NO_VAL64 if empty
+ */
+extern uint64_t rpc_hist_percentile(const uint32_t *hist, uint32_t hist_cnt,
+				    double pct);
 extern void slurm_free_resv_info_request_msg(resv_info_request_msg_t *msg);
 extern void slurm_free_set_debug_flags_msg(set_debug_flags_msg_t *msg);
 extern void slurm_free_set_debug_level_msg(set_debug_level_msg_t *msg);
@@ -1535,6 +1576,7 @@ extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t *msg);
 extern void slurm_free_kill_jobs_resp_job_t(kill_jobs_resp_job_t *job_resp);
 extern void slurm_free_kill_jobs_response_msg(kill_jobs_resp_msg_t *msg);
 extern void slurm_free_epilog_complete_msg(epilog_complete_msg_t * msg);
+extern void slurm_free_node_heartbeat_msg(node_heartbeat_msg_t *msg);
 extern void slurm_free_srun_job_complete_msg(srun_job_complete_msg_t * msg);
 extern void slurm_free_srun_ping_msg(srun_ping_msg_t * msg);
 extern void slurm_free_net_forward_msg(net_forward_msg_t *msg);
@@ -1556,6 +1598,8 @@ extern void slurm_free_job_step_create_response_msg(
 		job_step_create_response_msg_t * msg);
 extern void slurm_free_submit_response_response_msg(
 		submit_response_msg_t * msg);
+extern void slurm_free_submit_jobs_response_msg(
+	submit_jobs_response_msg_t *msg);
 extern void slurm_free_ctl_conf(slurm_ctl_conf_info_msg_t * config_ptr);
 extern void slurm_free_job_info_msg(job_info_msg_t * job_buffer_ptr);
 extern void slurm_free_job_step_info_response_msg(
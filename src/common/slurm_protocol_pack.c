@@ -1493,6 +1493,53 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void _pack_submit_jobs_response_msg(const slurm_msg_t *smsg,
+					   buf_t *buffer)
+{
+	submit_jobs_response_msg_t *msg = smsg->data;
+	xassert(msg);
+
+	if (smsg->protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		pack32(msg->job_cnt, buffer);
+		for (int i = 0; i < msg->job_cnt; i++) {
+			pack32(msg->job_id[i], buffer);
+			pack32(msg->error_code[i], buffer);
+			packstr(msg->job_submit_user_msg[i], buffer);
+		}
+	}
+}
+
+static int _unpack_submit_jobs_response_msg(slurm_msg_t *smsg, buf_t *buffer)
+{
+	submit_jobs_response_msg_t *tmp_ptr = xmalloc(sizeof(*tmp_ptr));
+	smsg->data = tmp_ptr;
+
+	if (smsg->protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&tmp_ptr->job_cnt, buffer);
+		if (tmp_ptr->job_cnt > NO_VAL)
+			goto unpack_error;
+		safe_xcalloc(tmp_ptr->job_id, tmp_ptr->job_cnt,
+			     sizeof(uint32_t));
+		safe_xcalloc(tmp_ptr->error_code, tmp_ptr->job_cnt,
+			     sizeof(uint32_t));
+		safe_xcalloc(tmp_ptr->job_submit_user_msg, tmp_ptr->job_cnt,
+			     sizeof(char *));
+		for (int i = 0; i < tmp_ptr->job_cnt; i++) {
+			safe_unpack32(&tmp_ptr->job_id[i], buffer);
+			safe_unpack32(&tmp_ptr->error_code[i], buffer);
+			safe_unpackstr(&tmp_ptr->job_submit_user_msg[i],
+				       buffer);
+		}
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_submit_jobs_response_msg(tmp_ptr);
+	smsg->data = NULL;
+	return SLURM_ERROR;
+}
+
 static int _unpack_node_info_msg(node_info_msg_t **msg, buf_t *buffer,
 				 uint16_t protocol_version)
 {
@@ -2220,6 +2267,42 @@ extern int slurm_pack_list(List send_list,
 	return rc;
 }
 
+extern int slurm_pack_list_pop(List send_list, pack_function_t pack_function,
+			       void (*destroy_function) (void *object),
+			       buf_t *buffer, uint16_t protocol_version)
+{
+	uint32_t count = 0;
+	uint32_t header_position;
+	int rc = SLURM_SUCCESS;
+	void *object;
+
+	if (!send_list) {
+		/* let user know there wasn't a list (error) */
+		pack32(NO_VAL, buffer);
+		return rc;
+	}
+
+	header_position = get_buf_offset(buffer);
+
+	count = list_count(send_list);
+	pack32(count, buffer);
+
+	while ((object = list_pop(send_list))) {
+		(*(pack_function))(object, protocol_version, buffer);
+		(*(destroy_function))(object);
+		if (size_buf(buffer) > REASONABLE_BUF_SIZE) {
+			error("%s: size limit exceeded", __func__);
+			/* rewind buffer, pack NO_VAL as count instead */
+			set_buf_offset(buffer, header_position);
+			pack32(NO_VAL, buffer);
+			rc = ESLURM_RESULT_TOO_LARGE;
+			break;
+		}
+	}
+
+	return rc;
+}
+
 extern int slurm_pack_list_until(List send_list, pack_function_t pack_function,
 				 buf_t *buffer, uint32_t max_buf_size,
 				 uint16_t protocol_version)
@@ -3213,7 +3296,12 @@ static int _unpack_job_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 	smsg->data = msg;
 
 	/* load buffer's header (data structure version and time) */
-	if (smsg->protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (smsg->protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->record_count, buffer);
+		safe_unpack_time(&msg->last_update, buffer);
+		safe_unpack_time(&msg->last_backfill, buffer);
+		safe_unpackbool(&msg->delta, buffer);
+	} else if (smsg->protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->record_count, buffer);
 		safe_unpack_time(&msg->last_update, buffer);
 		safe_unpack_time(&msg->last_backfill, buffer);
@@ -3236,6 +3324,9 @@ static int _unpack_job_info_msg(slurm_msg_t *smsg, buf_t *buffer)
 			job_ptr->bitflags |= BACKFILL_LAST;
 	}
 
+	if (msg->delta)
+		safe_unpack32_array(&msg->job_ids, &msg->job_id_cnt, buffer);
+
 	return SLURM_SUCCESS;
 
 unpack_error:
@@ -9758,6 +9849,12 @@ extern void pack_config_response_msg(config_response_msg_t *msg,
 {
 	xassert(msg);
 
+	if (msg->packed && (msg->packed_version == protocol_version)) {
+		packmem_array(get_buf_data(msg->packed),
+			      get_buf_offset(msg->packed), buffer);
+		return;
+	}
+
 	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		slurm_pack_list(msg->config_files, pack_config_file, buffer,
 				protocol_version);
@@ -10376,6 +10473,41 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void _pack_node_heartbeat_msg(node_heartbeat_msg_t *msg,
+				     buf_t *buffer, uint16_t protocol_version)
+{
+	xassert(msg);
+
+	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+		pack32(msg->cpu_load, buffer);
+		pack64(msg->free_mem, buffer);
+		packstr(msg->node_name, buffer);
+	}
+}
+
+static int _unpack_node_heartbeat_msg(node_heartbeat_msg_t **msg_ptr,
+				      buf_t *buffer, uint16_t protocol_version)
+{
+	node_heartbeat_msg_t *msg;
+
+	xassert(msg_ptr);
+	msg = xmalloc(sizeof(*msg));
+	*msg_ptr = msg;
+
+	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->cpu_load, buffer);
+		safe_unpack64(&msg->free_mem, buffer);
+		safe_unpackstr(&msg->node_name, buffer);
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_node_heartbeat_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
 static void _pack_ping_slurmd_resp(ping_slurmd_resp_msg_t *msg,
 				   buf_t *buffer, uint16_t protocol_version)
 {
@@ -10422,7 +10554,32 @@ static void _pack_file_bcast(file_bcast_msg_t * msg , buf_t *buffer,
 
 	grow_buf(buffer,  msg->block_len);
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		pack32(msg->block_no, buffer);
+		pack16(msg->compress, buffer);
+		pack16(msg->flags, buffer);
+		pack16(msg->modes, buffer);
+
+		pack32(msg->uid, buffer);
+		packstr(msg->user_name, buffer);
+		pack32(msg->gid, buffer);
+
+		pack_time(msg->atime, buffer);
+		pack_time(msg->mtime, buffer);
+
+		packstr(msg->fname, buffer);
+		packstr(msg->exe_fname, buffer);
+		pack32(msg->block_len, buffer);
+		pack32(msg->uncomp_len, buffer);
+		pack64(msg->block_offset, buffer);
+		pack64(msg->file_size, buffer);
+		packmem(msg->block, msg->block_len, buffer);
+		pack8(msg->block_hash.type, buffer);
+		packmem_array((char *) msg->block_hash.hash,
+			      sizeof(msg->block_hash.hash), buffer);
+		packstr(msg->peer_nodes, buffer);
+		pack_sbcast_cred(msg->cred, buffer, protocol_version);
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		pack32(msg->block_no, buffer);
 		pack16(msg->compress, buffer);
 		pack16(msg->flags, buffer);
@@ -10477,7 +10634,38 @@ static int _unpack_file_bcast(file_bcast_msg_t ** msg_ptr , buf_t *buffer,
 	msg = xmalloc ( sizeof (file_bcast_msg_t) ) ;
 	*msg_ptr = msg;
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->block_no, buffer);
+		safe_unpack16(&msg->compress, buffer);
+		safe_unpack16(&msg->flags, buffer);
+		safe_unpack16(&msg->modes, buffer);
+
+		safe_unpack32(&msg->uid, buffer);
+		safe_unpackstr(&msg->user_name, buffer);
+		safe_unpack32(&msg->gid, buffer);
+
+		safe_unpack_time(&msg->atime, buffer);
+		safe_unpack_time(&msg->mtime, buffer);
+
+		safe_unpackstr(&msg->fname, buffer);
+		safe_unpackstr(&msg->exe_fname, buffer);
+		safe_unpack32(&msg->block_len, buffer);
+		safe_unpack32(&msg->uncomp_len, buffer);
+		safe_unpack64(&msg->block_offset, buffer);
+		safe_unpack64(&msg->file_size, buffer);
+		safe_unpackmem_xmalloc(&msg->block, &uint32_tmp, buffer);
+		if (uint32_tmp != msg->block_len)
+			goto unpack_error;
+		safe_unpack8(&msg->block_hash.type, buffer);
+		safe_unpackmem_array((char *) msg->block_hash.hash,
+				     sizeof(msg->block_hash.hash), buffer);
+		safe_unpackstr(&msg->peer_nodes, buffer);
+
+		msg->cred = unpack_sbcast_cred(buffer, msg,
+					       protocol_version);
+		if (msg->cred == NULL)
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->block_no, buffer);
 		safe_unpack16(&msg->compress, buffer);
 		safe_unpack16(&msg->flags, buffer);
@@ -11212,7 +11400,199 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 	msg = xmalloc ( sizeof (stats_info_response_msg_t) );
 	*msg_ptr = msg ;
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->parts_packed, buffer);
+		if (msg->parts_packed) {
+			safe_unpack_time(&msg->req_time, buffer);
+			safe_unpack_time(&msg->req_time_start, buffer);
+			safe_unpack32(&msg->server_thread_count, buffer);
+			safe_unpack32(&msg->agent_queue_size, buffer);
+			safe_unpack32(&msg->agent_count, buffer);
+			safe_unpack32(&msg->agent_thread_count, buffer);
+			safe_unpack32(&msg->dbd_agent_queue_size, buffer);
+			safe_unpack32(&msg->gettimeofday_latency, buffer);
+			safe_unpack32(&msg->jobs_submitted, buffer);
+			safe_unpack32(&msg->jobs_started, buffer);
+			safe_unpack32(&msg->jobs_completed, buffer);
+			safe_unpack32(&msg->jobs_canceled, buffer);
+			safe_unpack32(&msg->jobs_failed, buffer);
+			safe_unpack32(&msg->jobs_pending, buffer);
+			safe_unpack32(&msg->jobs_running, buffer);
+			safe_unpack_time(&msg->job_states_ts, buffer);
+
+			safe_unpack32(&msg->schedule_cycle_max, buffer);
+			safe_unpack32(&msg->schedule_cycle_last, buffer);
+			safe_unpack32(&msg->schedule_cycle_sum, buffer);
+			safe_unpack32(&msg->schedule_cycle_counter, buffer);
+			safe_unpack32(&msg->schedule_cycle_depth, buffer);
+			safe_unpack32_array(&msg->schedule_exit,
+					    &msg->schedule_exit_cnt, buffer);
+			safe_unpack32(&msg->schedule_queue_len, buffer);
+
+			safe_unpack32(&msg->bf_backfilled_jobs, buffer);
+			safe_unpack32(&msg->bf_last_backfilled_jobs, buffer);
+			safe_unpack32(&msg->bf_cycle_counter, buffer);
+			safe_unpack64(&msg->bf_cycle_sum, buffer);
+			safe_unpack32(&msg->bf_cycle_last, buffer);
+			safe_unpack32(&msg->bf_last_depth, buffer);
+			safe_unpack32(&msg->bf_last_depth_try, buffer);
+
+			safe_unpack32(&msg->bf_queue_len, buffer);
+			safe_unpack32(&msg->bf_cycle_max, buffer);
+			safe_unpack_time(&msg->bf_when_last_cycle, buffer);
+			safe_unpack32(&msg->bf_depth_sum, buffer);
+			safe_unpack32(&msg->bf_depth_try_sum, buffer);
+			safe_unpack32(&msg->bf_queue_len_sum, buffer);
+			safe_unpack32(&msg->bf_table_size, buffer);
+			safe_unpack32(&msg->bf_table_size_sum, buffer);
+
+			safe_unpack32(&msg->bf_active, buffer);
+			safe_unpack32(&msg->bf_backfilled_het_jobs, buffer);
+			safe_unpack32_array(&msg->bf_exit,
+					    &msg->bf_exit_cnt, buffer);
+		}
+
+		safe_unpack32(&msg->rpc_type_size, buffer);
+		safe_unpack16_array(&msg->rpc_type_id, &uint32_tmp, buffer);
+		safe_unpack32_array(&msg->rpc_type_cnt, &uint32_tmp, buffer);
+		safe_unpack64_array(&msg->rpc_type_time, &uint32_tmp, buffer);
+
+		safe_unpack8(&msg->rpc_queue_enabled, buffer);
+		if (msg->rpc_queue_enabled) {
+			safe_unpack16_array(&msg->rpc_type_queued,
+					    &uint32_tmp, buffer);
+			safe_unpack64_array(&msg->rpc_type_dropped,
+					    &uint32_tmp, buffer);
+			safe_unpack16_array(&msg->rpc_type_cycle_last,
+					    &uint32_tmp, buffer);
+			safe_unpack16_array(&msg->rpc_type_cycle_max,
+					    &uint32_tmp, buffer);
+		}
+
+		safe_unpack32(&msg->rpc_user_size, buffer);
+		safe_unpack32_array(&msg->rpc_user_id, &uint32_tmp, buffer);
+		safe_unpack32_array(&msg->rpc_user_cnt, &uint32_tmp, buffer);
+		safe_unpack64_array(&msg->rpc_user_time, &uint32_tmp, buffer);
+
+		safe_unpack32_array(&msg->rpc_queue_type_id,
+				    &msg->rpc_queue_type_count,
+				    buffer);
+		safe_unpack32_array(&msg->rpc_queue_count,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->rpc_queue_type_count)
+			goto unpack_error;
+
+		safe_unpack32_array(&msg->rpc_dump_types,
+				    &msg->rpc_dump_count,
+				    buffer);
+		safe_unpackstr_array(&msg->rpc_dump_hostlist,
+				     &uint32_tmp,
+				     buffer);
+		if (uint32_tmp != msg->rpc_dump_count)
+			goto unpack_error;
+
+		safe_unpack8(&msg->lock_stats_enabled, buffer);
+		if (msg->lock_stats_enabled) {
+			safe_unpack32_array(&msg->lock_cnt,
+					    &msg->lock_stats_cnt, buffer);
+			safe_unpack64_array(&msg->lock_wait_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_wait_max,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_hold_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_hold_max,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+			safe_unpack32_array(&msg->lock_wait_hist,
+					    &uint32_tmp, buffer);
+			if (!msg->lock_stats_cnt ||
+			    (uint32_tmp % msg->lock_stats_cnt))
+				goto unpack_error;
+			msg->lock_wait_hist_cnt = uint32_tmp /
+						  msg->lock_stats_cnt;
+
+			safe_unpackstr_array(&msg->lock_caller_name,
+					     &msg->lock_caller_size, buffer);
+			safe_unpack32_array(&msg->lock_caller_cnt,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_caller_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_caller_wait_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_caller_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_caller_wait_max,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_caller_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_caller_hold_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_caller_size)
+				goto unpack_error;
+		}
+
+		safe_unpack64(&msg->bitmap_cache_hits, buffer);
+		safe_unpack64(&msg->bitmap_cache_misses, buffer);
+
+		safe_unpack32(&msg->fair_tree_cycle_counter, buffer);
+		safe_unpack32(&msg->fair_tree_cycle_last, buffer);
+		safe_unpack32(&msg->fair_tree_cycle_max, buffer);
+		safe_unpack64(&msg->fair_tree_cycle_sum, buffer);
+
+		safe_unpackstr_array(&msg->xmalloc_stats_name,
+				     &msg->xmalloc_stats_cnt, buffer);
+		safe_unpack64_array(&msg->xmalloc_stats_allocs,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->xmalloc_stats_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&msg->xmalloc_stats_frees,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->xmalloc_stats_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&msg->xmalloc_stats_bytes,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->xmalloc_stats_cnt)
+			goto unpack_error;
+
+		safe_unpack32(&msg->rpc_hist_cnt, buffer);
+		safe_unpack32_array(&msg->rpc_type_hist, &uint32_tmp, buffer);
+		if (uint32_tmp != (msg->rpc_type_size * msg->rpc_hist_cnt))
+			goto unpack_error;
+		safe_unpack32_array(&msg->rpc_user_hist, &uint32_tmp, buffer);
+		if (uint32_tmp != (msg->rpc_user_size * msg->rpc_hist_cnt))
+			goto unpack_error;
+
+		safe_unpackstr_array(&msg->plugin_stats_name,
+				     &msg->plugin_stats_cnt, buffer);
+		safe_unpackstr_array(&msg->plugin_stats_op, &uint32_tmp,
+				     buffer);
+		if (uint32_tmp != msg->plugin_stats_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&msg->plugin_stats_calls, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != msg->plugin_stats_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&msg->plugin_stats_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != msg->plugin_stats_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&msg->plugin_stats_max, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != msg->plugin_stats_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&msg->plugin_stats_hist, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != (msg->plugin_stats_cnt * msg->rpc_hist_cnt))
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->parts_packed, buffer);
 		if (msg->parts_packed) {
 			safe_unpack_time(&msg->req_time, buffer);
@@ -12447,6 +12827,7 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		_pack_job_desc_list_msg((List) msg->data, buffer,
 					msg->protocol_version);
 		break;
@@ -12495,6 +12876,7 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
 	case REQUEST_TAKEOVER:
+	case REQUEST_SCHED_TRACE_DUMP:
 	case REQUEST_DAEMON_STATUS:
 	case REQUEST_HEALTH_CHECK:
 	case REQUEST_ACCT_GATHER_UPDATE:
@@ -12536,6 +12918,9 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case RESPONSE_SUBMIT_BATCH_JOB:
 		_pack_submit_response_msg(msg, buffer);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		_pack_submit_jobs_response_msg(msg, buffer);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		_pack_resource_allocation_response_msg(msg, buffer);
@@ -12923,6 +13308,10 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 		_pack_ping_slurmd_resp((ping_slurmd_resp_msg_t *)msg->data,
 				       buffer, msg->protocol_version);
 		break;
+	case MESSAGE_NODE_HEARTBEAT:
+		_pack_node_heartbeat_msg(msg->data, buffer,
+					 msg->protocol_version);
+		break;
 	case REQUEST_LICENSE_INFO:
 		_pack_license_info_request_msg((license_info_request_msg_t *)
 					       msg->data,
@@ -13098,6 +13487,7 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		rc = _unpack_job_desc_list_msg((List *) &(msg->data),
 					       buffer, msg->protocol_version);
 		break;
@@ -13148,6 +13538,7 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 	case REQUEST_CONTROL:
 	case REQUEST_CONTROL_STATUS:
 	case REQUEST_TAKEOVER:
+	case REQUEST_SCHED_TRACE_DUMP:
 	case REQUEST_DAEMON_STATUS:
 	case REQUEST_HEALTH_CHECK:
 	case REQUEST_ACCT_GATHER_UPDATE:
@@ -13191,6 +13582,9 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 	case RESPONSE_SUBMIT_BATCH_JOB:
 		rc = _unpack_submit_response_msg(msg, buffer);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		rc = _unpack_submit_jobs_response_msg(msg, buffer);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		rc = _unpack_resource_allocation_response_msg(msg, buffer);
@@ -13625,6 +14019,11 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 					      &msg->data, buffer,
 					      msg->protocol_version);
 		break;
+	case MESSAGE_NODE_HEARTBEAT:
+		rc = _unpack_node_heartbeat_msg((node_heartbeat_msg_t **)
+						&msg->data, buffer,
+						msg->protocol_version);
+		break;
 	case RESPONSE_LICENSE_INFO:
 		rc = _unpack_license_info_msg((license_info_msg_t **)&(msg->data),
 					      buffer,
@@ -102,6 +102,15 @@ extern int slurm_pack_list(List send_list,
 						  uint16_t rpc_version,
 						  buf_t *buffer),
 			   buf_t *buffer, uint16_t protocol_version);
+/*
+ * Same as slurm_pack_list() but each object is removed from send_list and
+ * freed with destroy_function as soon as it is packed, so that a large list
+ * and its packed copy are not both held in memory. send_list is empty on
+ * return.
+ */
+extern int slurm_pack_list_pop(List send_list, pack_function_t pack_function,
+			       void (*destroy_function) (void *object),
+			       buf_t *buffer, uint16_t protocol_version);
 extern int slurm_pack_list_until(List send_list, pack_function_t pack_function,
 				 buf_t *buffer, uint32_t max_buf_size,
 				 uint16_t protocol_version);
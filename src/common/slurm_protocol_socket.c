@@ -143,9 +143,9 @@ extern ssize_t slurm_msg_recvfrom_timeout(int fd, char **pbuf, size_t *lenp,
 		slurm_seterrno_ret(SLURM_PROTOCOL_INSANE_MSG_LENGTH);
 
 	/*
-	 *  Allocate memory on heap for message
+	 *  Allocate memory on heap for message, all of which is read below
 	 */
-	if (!(*pbuf = try_xmalloc(msglen)))
+	if (!(*pbuf = try_xmalloc_nz(msglen)))
 		slurm_seterrno_ret(ENOMEM);
 
 	if (slurm_recv_timeout(fd, *pbuf, msglen, timeout) != msglen) {
@@ -50,6 +50,17 @@
 strong_alias(pack_slurm_step_layout, slurm_pack_slurm_step_layout);
 strong_alias(unpack_slurm_step_layout, slurm_unpack_slurm_step_layout);
 
+/*
+ * How the tids arrays are sent over the wire. Block and cyclic layouts are
+ * fully described by the per-node task counts, so only those are sent and
+ * the receiver rebuilds tids from them.
+ */
+typedef enum {
+	LAYOUT_TIDS_EXPLICIT = 0,
+	LAYOUT_TIDS_BLOCK,
+	LAYOUT_TIDS_CYCLIC,
+} layout_tids_fmt_t;
+
 /* build maps for task layout on nodes */
 static int _init_task_layout(slurm_step_layout_req_t *step_layout_req,
 			     slurm_step_layout_t *step_layout,
@@ -314,12 +325,168 @@ extern void slurm_step_layout_merge(slurm_step_layout_t *step_layout1,
 	hostlist_destroy(hl2);
 }
 
+/*
+ * Fill tids from tasks as either a block (consecutive task ids per node) or
+ * cyclic (task ids dealt round-robin over nodes with room left) layout.
+ * When check is set, compare against the existing tids instead and return
+ * false on the first mismatch.
+ */
+static bool _layout_tids_build(slurm_step_layout_t *step_layout,
+			       layout_tids_fmt_t fmt, bool check)
+{
+	uint32_t *cnt, tid = 0, i;
+	bool match = true;
+
+	if (fmt == LAYOUT_TIDS_BLOCK) {
+		for (i = 0; i < step_layout->node_cnt; i++) {
+			for (uint32_t j = 0; j < step_layout->tasks[i]; j++) {
+				if (!check)
+					step_layout->tids[i][j] = tid;
+				else if (step_layout->tids[i][j] != tid)
+					return false;
+				tid++;
+			}
+		}
+		return true;
+	}
+
+	cnt = xcalloc(step_layout->node_cnt, sizeof(*cnt));
+	while (match && (tid < step_layout->task_cnt)) {
+		for (i = 0; i < step_layout->node_cnt; i++) {
+			if (cnt[i] >= step_layout->tasks[i])
+				continue;
+			if (!check) {
+				step_layout->tids[i][cnt[i]] = tid;
+			} else if (step_layout->tids[i][cnt[i]] != tid) {
+				match = false;
+				break;
+			}
+			cnt[i]++;
+			tid++;
+		}
+	}
+	xfree(cnt);
+
+	return match;
+}
+
+static layout_tids_fmt_t _layout_tids_fmt(slurm_step_layout_t *step_layout)
+{
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < step_layout->node_cnt; i++)
+		sum += step_layout->tasks[i];
+	if (sum != step_layout->task_cnt)
+		return LAYOUT_TIDS_EXPLICIT;
+
+	if (_layout_tids_build(step_layout, LAYOUT_TIDS_BLOCK, true))
+		return LAYOUT_TIDS_BLOCK;
+	if (_layout_tids_build(step_layout, LAYOUT_TIDS_CYCLIC, true))
+		return LAYOUT_TIDS_CYCLIC;
+	return LAYOUT_TIDS_EXPLICIT;
+}
+
+/* Pack per-node task counts as runs of identical values */
+static void _pack_layout_tasks(slurm_step_layout_t *step_layout,
+			       buf_t *buffer)
+{
+	uint32_t *vals, *reps, runs = 0;
+
+	vals = xcalloc(step_layout->node_cnt, sizeof(*vals));
+	reps = xcalloc(step_layout->node_cnt, sizeof(*reps));
+	for (uint32_t i = 0; i < step_layout->node_cnt; i++) {
+		if (runs && (vals[runs - 1] == step_layout->tasks[i])) {
+			reps[runs - 1]++;
+			continue;
+		}
+		vals[runs] = step_layout->tasks[i];
+		reps[runs] = 1;
+		runs++;
+	}
+	pack32_array(vals, runs, buffer);
+	pack32_array(reps, runs, buffer);
+	xfree(vals);
+	xfree(reps);
+}
+
+static int _unpack_layout_tasks(slurm_step_layout_t *step_layout,
+				buf_t *buffer)
+{
+	uint32_t *vals = NULL, *reps = NULL, runs, reps_cnt, n = 0;
+
+	safe_unpack32_array(&vals, &runs, buffer);
+	safe_unpack32_array(&reps, &reps_cnt, buffer);
+	if (reps_cnt != runs)
+		goto unpack_error;
+
+	safe_xcalloc(step_layout->tasks, step_layout->node_cnt,
+		     sizeof(uint32_t));
+	for (uint32_t r = 0; r < runs; r++) {
+		if (reps[r] > (step_layout->node_cnt - n))
+			goto unpack_error;
+		for (uint32_t i = 0; i < reps[r]; i++)
+			step_layout->tasks[n++] = vals[r];
+	}
+	if (n != step_layout->node_cnt)
+		goto unpack_error;
+
+	xfree(vals);
+	xfree(reps);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(vals);
+	xfree(reps);
+	return SLURM_ERROR;
+}
+
 extern void pack_slurm_step_layout(slurm_step_layout_t *step_layout,
 				   buf_t *buffer, uint16_t protocol_version)
 {
 	uint32_t i = 0;
 
-	if (protocol_version >= SLURM_23_11_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		layout_tids_fmt_t fmt;
+
+		if (step_layout)
+			i = 1;
+
+		pack16(i, buffer);
+		if (!i)
+			return;
+		packstr(step_layout->front_end, buffer);
+		packstr(step_layout->node_list, buffer);
+		pack32(step_layout->node_cnt, buffer);
+		pack16(step_layout->start_protocol_ver, buffer);
+		pack32(step_layout->task_cnt, buffer);
+		pack32(step_layout->task_dist, buffer);
+
+		_pack_layout_tasks(step_layout, buffer);
+		fmt = _layout_tids_fmt(step_layout);
+		pack8(fmt, buffer);
+		if (fmt == LAYOUT_TIDS_EXPLICIT) {
+			for (i = 0; i < step_layout->node_cnt; i++) {
+				pack32_array(step_layout->tids[i],
+					     step_layout->tasks[i],
+					     buffer);
+			}
+		}
+
+		pack16_array(step_layout->cpt_compact_array,
+			     step_layout->cpt_compact_cnt, buffer);
+		pack32_array(step_layout->cpt_compact_reps,
+			     step_layout->cpt_compact_cnt, buffer);
+
+		if (step_layout->alias_addrs) {
+			char *tmp_str =
+				create_net_cred(step_layout->alias_addrs,
+						protocol_version);
+			packstr(tmp_str, buffer);
+			xfree(tmp_str);
+		} else {
+			packnull(buffer);
+		}
+	} else if (protocol_version >= SLURM_23_11_PROTOCOL_VERSION) {
 		if (step_layout)
 			i = 1;
 
@@ -387,7 +554,71 @@ extern int unpack_slurm_step_layout(slurm_step_layout_t **layout, buf_t *buffer,
 	int i;
 	char *tmp_str = NULL;
 
-	if (protocol_version >= SLURM_23_11_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		uint8_t fmt;
+		uint64_t sum = 0;
+
+		safe_unpack16(&uint16_tmp, buffer);
+		if (!uint16_tmp)
+			return SLURM_SUCCESS;
+
+		step_layout = xmalloc(sizeof(slurm_step_layout_t));
+		*layout = step_layout;
+
+		safe_unpackstr(&step_layout->front_end, buffer);
+		safe_unpackstr(&step_layout->node_list, buffer);
+		safe_unpack32(&step_layout->node_cnt, buffer);
+		safe_unpack16(&step_layout->start_protocol_ver, buffer);
+		safe_unpack32(&step_layout->task_cnt, buffer);
+		safe_unpack32(&step_layout->task_dist, buffer);
+
+		if (_unpack_layout_tasks(step_layout, buffer))
+			goto unpack_error;
+		for (i = 0; i < step_layout->node_cnt; i++)
+			sum += step_layout->tasks[i];
+
+		safe_unpack8(&fmt, buffer);
+		safe_xcalloc(step_layout->tids, step_layout->node_cnt,
+			     sizeof(uint32_t *));
+		if (fmt == LAYOUT_TIDS_EXPLICIT) {
+			for (i = 0; i < step_layout->node_cnt; i++) {
+				safe_unpack32_array(&(step_layout->tids[i]),
+						    &num_tids, buffer);
+				if (num_tids != step_layout->tasks[i])
+					goto unpack_error;
+			}
+		} else if (((fmt == LAYOUT_TIDS_BLOCK) ||
+			    (fmt == LAYOUT_TIDS_CYCLIC)) &&
+			   (sum == step_layout->task_cnt)) {
+			for (i = 0; i < step_layout->node_cnt; i++)
+				safe_xcalloc(step_layout->tids[i],
+					     step_layout->tasks[i],
+					     sizeof(uint32_t));
+			_layout_tids_build(step_layout, fmt, false);
+		} else {
+			goto unpack_error;
+		}
+
+		safe_unpack16_array(&step_layout->cpt_compact_array,
+				    &step_layout->cpt_compact_cnt, buffer);
+		safe_unpack32_array(&step_layout->cpt_compact_reps,
+				    &uint32_tmp, buffer);
+		xassert(uint32_tmp == step_layout->cpt_compact_cnt);
+
+		safe_unpackstr(&tmp_str, buffer);
+		if (running_in_slurmctld()) {
+			/* See comment for SLURM_23_11_PROTOCOL_VERSION below */
+			xfree(tmp_str);
+		} else if (tmp_str) {
+			step_layout->alias_addrs =
+				extract_net_cred(tmp_str, protocol_version);
+			if (!step_layout->alias_addrs) {
+				xfree(tmp_str);
+				goto unpack_error;
+			}
+			step_layout->alias_addrs->net_cred = tmp_str;
+		}
+	} else if (protocol_version >= SLURM_23_11_PROTOCOL_VERSION) {
 		safe_unpack16(&uint16_tmp, buffer);
 		if (!uint16_tmp)
 			return SLURM_SUCCESS;
@@ -70,6 +70,20 @@
 #include "src/common/xregex.h"
 #include "src/common/xstring.h"
 
+/*
+ * Steps found by the last stepd_available() scan. Every stepd creates and
+ * unlinks its socket in the spool directory, so the list stays valid for as
+ * long as the directory's mtime is unchanged.
+ */
+static struct {
+	char *directory;
+	char *nodename;
+	struct timespec mtime;	/* directory mtime when scanned */
+	struct timespec scanned;	/* when the scan started */
+	list_t *steps;		/* list of step_loc_t */
+} stepd_cache = { 0 };
+static pthread_mutex_t stepd_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 strong_alias(stepd_available, slurm_stepd_available);
 strong_alias(stepd_connect, slurm_stepd_connect);
 strong_alias(stepd_get_uid, slurm_stepd_get_uid);
@@ -530,6 +544,62 @@ _sockname_regex(regex_t *re, const char *filename, slurm_step_id_t *step_id)
  *
  * Returns a list of pointers to step_loc_t structures.
  */
+static int _copy_step_loc(void *x, void *arg)
+{
+	step_loc_t *src = x, *dest = xmalloc(sizeof(*dest));
+
+	dest->directory = xstrdup(src->directory);
+	dest->nodename = xstrdup(src->nodename);
+	dest->protocol_version = src->protocol_version;
+	dest->step_id = src->step_id;
+	list_append(arg, dest);
+
+	return 0;
+}
+
+/*
+ * The cached scan can only be trusted once the directory's mtime is at least
+ * one second older than the scan, as filesystems with a coarse mtime would
+ * not reflect a change made later within the same tick.
+ */
+static list_t *_stepd_cache_get(const char *directory, const char *nodename,
+				struct stat *stat_buf)
+{
+	list_t *l = NULL;
+
+	slurm_mutex_lock(&stepd_cache_mutex);
+	if (stepd_cache.steps &&
+	    !xstrcmp(stepd_cache.directory, directory) &&
+	    !xstrcmp(stepd_cache.nodename, nodename) &&
+	    (stepd_cache.mtime.tv_sec == stat_buf->st_mtim.tv_sec) &&
+	    (stepd_cache.mtime.tv_nsec == stat_buf->st_mtim.tv_nsec) &&
+	    (stepd_cache.scanned.tv_sec > (stat_buf->st_mtim.tv_sec + 1))) {
+		l = list_create((ListDelF) _free_step_loc_t);
+		(void) list_for_each(stepd_cache.steps, _copy_step_loc, l);
+	}
+	slurm_mutex_unlock(&stepd_cache_mutex);
+
+	return l;
+}
+
+static void _stepd_cache_set(const char *directory, const char *nodename,
+			     struct stat *stat_buf, struct timespec *scanned,
+			     list_t *steps)
+{
+	slurm_mutex_lock(&stepd_cache_mutex);
+	xfree(stepd_cache.directory);
+	xfree(stepd_cache.nodename);
+	FREE_NULL_LIST(stepd_cache.steps);
+
+	stepd_cache.directory = xstrdup(directory);
+	stepd_cache.nodename = xstrdup(nodename);
+	stepd_cache.mtime = stat_buf->st_mtim;
+	stepd_cache.scanned = *scanned;
+	stepd_cache.steps = list_create((ListDelF) _free_step_loc_t);
+	(void) list_for_each(steps, _copy_step_loc, stepd_cache.steps);
+	slurm_mutex_unlock(&stepd_cache_mutex);
+}
+
 extern list_t *stepd_available(const char *directory, const char *nodename)
 {
 	list_t *l = NULL;
@@ -537,6 +607,7 @@ extern list_t *stepd_available(const char *directory, const char *nodename)
 	struct dirent *ent;
 	regex_t re;
 	struct stat stat_buf;
+	struct timespec scanned;
 	char *local_nodename = NULL;
 
 	if (nodename == NULL) {
@@ -553,21 +624,31 @@ extern list_t *stepd_available(const char *directory, const char *nodename)
 		slurm_conf_unlock();
 	}
 
-	l = list_create((ListDelF) _free_step_loc_t);
-	if (_sockname_regex_init(&re, nodename) == -1)
-		goto done;
-
 	/*
 	 * Make sure that "directory" exists and is a directory.
 	 */
+	clock_gettime(CLOCK_REALTIME, &scanned);
 	if (stat(directory, &stat_buf) < 0) {
 		error("Domain socket directory %s: %m", directory);
-		goto done;
+		l = list_create((ListDelF) _free_step_loc_t);
+		xfree(local_nodename);
+		return l;
 	} else if (!S_ISDIR(stat_buf.st_mode)) {
 		error("%s is not a directory", directory);
-		goto done;
+		l = list_create((ListDelF) _free_step_loc_t);
+		xfree(local_nodename);
+		return l;
+	}
+
+	if ((l = _stepd_cache_get(directory, nodename, &stat_buf))) {
+		xfree(local_nodename);
+		return l;
 	}
 
+	l = list_create((ListDelF) _free_step_loc_t);
+	if (_sockname_regex_init(&re, nodename) == -1)
+		goto done;
+
 	if ((dp = opendir(directory)) == NULL) {
 		error("Unable to open directory: %m");
 		goto done;
@@ -588,6 +669,7 @@ extern list_t *stepd_available(const char *directory, const char *nodename)
 	}
 
 	closedir(dp);
+	_stepd_cache_set(directory, nodename, &stat_buf, &scanned, l);
 done:
 	xfree(local_nodename);
 	regfree(&re);
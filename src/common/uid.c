@@ -204,6 +204,19 @@ extern void uid_cache_clear(void)
 	slurm_mutex_unlock(&uid_lock);
 }
 
+/* Compare only the uid, the padding after it is not initialized */
+static int _uid_cache_cmp(const void *v1, const void *v2)
+{
+	uid_t uid1 = ((const uid_cache_entry_t *) v1)->uid;
+	uid_t uid2 = ((const uid_cache_entry_t *) v2)->uid;
+
+	if (uid1 < uid2)
+		return -1;
+	if (uid1 > uid2)
+		return 1;
+	return 0;
+}
+
 extern char *uid_to_string_cached(uid_t uid)
 {
 	uid_cache_entry_t *entry;
@@ -211,7 +224,7 @@ extern char *uid_to_string_cached(uid_t uid)
 
 	slurm_mutex_lock(&uid_lock);
 	entry = bsearch(&target, uid_cache, uid_cache_used,
-			sizeof(uid_cache_entry_t), slurm_sort_uint_list_asc);
+			sizeof(uid_cache_entry_t), _uid_cache_cmp);
 	if (entry == NULL) {
 		uid_cache_entry_t new_entry = {uid, uid_to_string(uid)};
 		uid_cache_used++;
@@ -219,7 +232,7 @@ extern char *uid_to_string_cached(uid_t uid)
 				     sizeof(uid_cache_entry_t)*uid_cache_used);
 		uid_cache[uid_cache_used-1] = new_entry;
 		qsort(uid_cache, uid_cache_used, sizeof(uid_cache_entry_t),
-		      slurm_sort_uint_list_asc);
+		      _uid_cache_cmp);
 		slurm_mutex_unlock(&uid_lock);
 		return new_entry.username;
 	}
@@ -0,0 +1,83 @@
+/*****************************************************************************\
+ *  usdt.h - USDT static probe definitions
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _USDT_H
+#define _USDT_H
+
+#include "config.h"
+
+/*
+ * Static probes for bpftrace/SystemTap, compiled in with --enable-usdt.
+ * All probes use the "slurm" provider, e.g.:
+ *	bpftrace -e 'usdt:/usr/sbin/slurmctld:slurm:rpc_done { ... }'
+ *
+ * Without --enable-usdt the macros expand to nothing and their arguments
+ * are not evaluated. With it, each probe is a single nop until attached.
+ *
+ * Probes:
+ *	slurmctld: rpc_start(msg_type, uid), rpc_done(msg_type, uid, usec)
+ *	slurmctld: lock_acquire(levels, caller), lock_acquired(levels, caller),
+ *		   lock_release(levels)
+ *		   levels packs the conf/job/node/part/fed lock_level_t, one
+ *		   per byte starting from the lowest
+ *	slurmctld: job_test_start(job_id, mode), job_test_done(job_id, rc)
+ *	slurmctld: bf_job_start(job_id, array_task_id),
+ *		   bf_job_started(job_id, rc)
+ *	slurmctld: agent_send(msg_type, node_name),
+ *		   agent_response(msg_type, node_name, rc)
+ *	slurmstepd: task_fork(job_id, step_id, task_id, pid),
+ *		    task_exit(job_id, step_id, task_id, wait_status)
+ */
+
+#ifdef HAVE_USDT
+
+#include <sys/sdt.h>
+
+#define SLURM_PROBE1(name, a1) DTRACE_PROBE1(slurm, name, a1)
+#define SLURM_PROBE2(name, a1, a2) DTRACE_PROBE2(slurm, name, a1, a2)
+#define SLURM_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(slurm, name, a1, a2, a3)
+#define SLURM_PROBE4(name, a1, a2, a3, a4) \
+	DTRACE_PROBE4(slurm, name, a1, a2, a3, a4)
+
+#else
+
+#define SLURM_PROBE1(name, a1)
+#define SLURM_PROBE2(name, a1, a2)
+#define SLURM_PROBE3(name, a1, a2, a3)
+#define SLURM_PROBE4(name, a1, a2, a3, a4)
+
+#endif
+
+#endif
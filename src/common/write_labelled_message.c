@@ -84,17 +84,18 @@ extern int write_labelled_message(int fd, void *buf, int len, int task_id,
 	int line_len;
 	int rc = -1;
 
-	if (label) {
-		prefix = _build_label(task_id, task_id_width, het_job_offset,
-				      het_job_task_offset);
-	}
+	/* Without a label the lines need not be written one by one */
+	if (!label)
+		return (len > 0) ? _write_line(fd, NULL, NULL, buf, len) : -1;
+
+	prefix = _build_label(task_id, task_id_width, het_job_offset,
+			      het_job_task_offset);
 
 	while (remaining > 0) {
 		start = buf + written;
 		end = memchr(start, '\n', remaining);
 		if (end == NULL) { /* no newline found */
-			if (label)
-				suffix = "\n";
+			suffix = "\n";
 			rc = _write_line(fd, prefix, suffix, start, remaining);
 			if (rc <= 0) {
 				goto done;
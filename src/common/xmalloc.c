@@ -58,6 +58,171 @@ strong_alias(xsize, slurm_xsize);
 
 #define XMALLOC_MAGIC 0x42
 
+/*
+ * With accounting enabled the upper bits of the magic word carry the index of
+ * the subsystem that made the allocation, so xfree() can credit it back.
+ */
+#define XMALLOC_TAG_SHIFT 8
+#define XMALLOC_MAGIC_OK(p) (((p)[0] & 0xff) == XMALLOC_MAGIC)
+
+#define XMALLOC_STATS_MAX 64
+#define XMALLOC_STATS_NAME_LEN 32
+#define XMALLOC_FILE_SLOTS 1024
+
+typedef struct {
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t bytes;
+} xmalloc_counter_t;
+
+typedef struct {
+	const char *file;
+	size_t tag;
+} xmalloc_file_slot_t;
+
+static bool xmalloc_stats = false;
+static pthread_mutex_t xmalloc_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Tag 0 is reserved for allocations that are not accounted */
+static uint32_t xmalloc_stats_cnt = 1;
+static char xmalloc_stats_name[XMALLOC_STATS_MAX][XMALLOC_STATS_NAME_LEN];
+static xmalloc_counter_t xmalloc_counter[XMALLOC_STATS_MAX];
+/* __FILE__ pointer to tag, filled in under xmalloc_stats_lock */
+static xmalloc_file_slot_t xmalloc_file_slot[XMALLOC_FILE_SLOTS];
+
+/*
+ * Name the subsystem of a source file: the directory under src/, or the
+ * plugin type for plugins (e.g. "slurmctld", "plugins/select").
+ */
+static void _file_subsys(const char *file, char *name)
+{
+	const char *p = file, *s, *end;
+	size_t len;
+
+	while ((s = strstr(p, "src/")))
+		p = s + 4;
+	if (p == file && (s = strrchr(file, '/')))
+		p = s + 1;
+
+	if (!(end = strchr(p, '/')) && !(end = strrchr(p, '.')))
+		end = p + strlen(p);
+	else if (!strncmp(p, "plugins/", 8) && (s = strchr(end + 1, '/')))
+		end = s;
+
+	len = MIN(end - p, XMALLOC_STATS_NAME_LEN - 1);
+	memcpy(name, p, len);
+	name[len] = '\0';
+}
+
+static size_t _tag_lookup(const char *file)
+{
+	char name[XMALLOC_STATS_NAME_LEN];
+	uint32_t i, slot = ((uintptr_t) file >> 3) % XMALLOC_FILE_SLOTS;
+	const char *f;
+	size_t tag = 0;
+
+	for (i = 0; i < XMALLOC_FILE_SLOTS; i++) {
+		uint32_t s = (slot + i) % XMALLOC_FILE_SLOTS;
+
+		f = __atomic_load_n(&xmalloc_file_slot[s].file,
+				    __ATOMIC_ACQUIRE);
+		if (f == file)
+			return xmalloc_file_slot[s].tag;
+		if (!f)
+			break;
+	}
+
+	_file_subsys(file, name);
+
+	/* Do not log from here, that would allocate */
+	pthread_mutex_lock(&xmalloc_stats_lock);
+	for (i = 1; i < xmalloc_stats_cnt; i++) {
+		if (!strcmp(xmalloc_stats_name[i], name)) {
+			tag = i;
+			break;
+		}
+	}
+	if (!tag && (xmalloc_stats_cnt < XMALLOC_STATS_MAX)) {
+		tag = xmalloc_stats_cnt;
+		strcpy(xmalloc_stats_name[tag], name);
+		__atomic_store_n(&xmalloc_stats_cnt, tag + 1, __ATOMIC_RELEASE);
+	}
+	for (i = 0; tag && (i < XMALLOC_FILE_SLOTS); i++) {
+		uint32_t s = (slot + i) % XMALLOC_FILE_SLOTS;
+
+		f = xmalloc_file_slot[s].file;
+		if (f == file)
+			break;
+		if (f)
+			continue;
+		xmalloc_file_slot[s].tag = tag;
+		__atomic_store_n(&xmalloc_file_slot[s].file, file,
+				 __ATOMIC_RELEASE);
+		break;
+	}
+	pthread_mutex_unlock(&xmalloc_stats_lock);
+
+	return tag;
+}
+
+static size_t _stats_alloc(const char *file, size_t size)
+{
+	size_t tag;
+
+	if (!__atomic_load_n(&xmalloc_stats, __ATOMIC_RELAXED) ||
+	    !(tag = _tag_lookup(file)))
+		return XMALLOC_MAGIC;
+
+	__atomic_fetch_add(&xmalloc_counter[tag].allocs, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&xmalloc_counter[tag].bytes, size, __ATOMIC_RELAXED);
+
+	return XMALLOC_MAGIC | (tag << XMALLOC_TAG_SHIFT);
+}
+
+static void _stats_free(size_t *p)
+{
+	size_t tag = p[0] >> XMALLOC_TAG_SHIFT;
+
+	if (!tag)
+		return;
+
+	__atomic_fetch_add(&xmalloc_counter[tag].frees, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_sub(&xmalloc_counter[tag].bytes, p[1], __ATOMIC_RELAXED);
+}
+
+extern void xmalloc_stats_enable(void)
+{
+	__atomic_store_n(&xmalloc_stats, true, __ATOMIC_RELAXED);
+}
+
+extern uint32_t xmalloc_stats_get(char ***names, uint64_t **allocs,
+				  uint64_t **frees, uint64_t **bytes)
+{
+	uint32_t cnt = __atomic_load_n(&xmalloc_stats_cnt, __ATOMIC_ACQUIRE);
+
+	*names = NULL;
+	*allocs = *frees = *bytes = NULL;
+
+	if (!__atomic_load_n(&xmalloc_stats, __ATOMIC_RELAXED) || (cnt <= 1))
+		return 0;
+
+	/* Skip the untracked tag 0 */
+	cnt--;
+	*names = xcalloc(cnt, sizeof(char *));
+	*allocs = xcalloc(cnt, sizeof(uint64_t));
+	*frees = xcalloc(cnt, sizeof(uint64_t));
+	*bytes = xcalloc(cnt, sizeof(uint64_t));
+	for (uint32_t i = 0; i < cnt; i++) {
+		xmalloc_counter_t *c = &xmalloc_counter[i + 1];
+
+		(*names)[i] = xmalloc_stats_name[i + 1];
+		(*allocs)[i] = __atomic_load_n(&c->allocs, __ATOMIC_RELAXED);
+		(*frees)[i] = __atomic_load_n(&c->frees, __ATOMIC_RELAXED);
+		(*bytes)[i] = __atomic_load_n(&c->bytes, __ATOMIC_RELAXED);
+	}
+
+	return cnt;
+}
+
 /*
  * "Safe" version of malloc().
  *   size (IN)	number of bytes to malloc
@@ -105,7 +270,8 @@ void *slurm_xcalloc(size_t count, size_t size, bool clear, bool try,
 		log_oom(file, line, func);
 		abort();
 	}
-	p[0] = XMALLOC_MAGIC;	/* add "secret" magic cookie */
+	/* add "secret" magic cookie */
+	p[0] = _stats_alloc(file, count_size);
 	p[1] = count_size;	/* store size in buffer */
 
 	return &p[2];
@@ -147,11 +313,11 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 	total_size = count_size + 2 * sizeof(size_t);
 
 	if (*item != NULL) {
-		size_t old_size;
+		size_t old_size, tag;
 		p = (size_t *)*item - 2;
 
 		/* magic cookie still there? */
-		xassert(p[0] == XMALLOC_MAGIC);
+		xassert(XMALLOC_MAGIC_OK(p));
 		old_size = p[1];
 
 		p = realloc(p, total_size);
@@ -163,7 +329,13 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 			if (clear)
 				memset(p_new, 0, (count_size - old_size));
 		}
-		xassert(p[0] == XMALLOC_MAGIC);
+		xassert(XMALLOC_MAGIC_OK(p));
+
+		/* Resizing stays with the subsystem that allocated it */
+		if ((tag = p[0] >> XMALLOC_TAG_SHIFT))
+			__atomic_fetch_add(&xmalloc_counter[tag].bytes,
+					   count_size - old_size,
+					   __ATOMIC_RELAXED);
 	} else {
 		/* Initialize new memory */
 		if (clear)
@@ -172,7 +344,7 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 			p = malloc(total_size);
 		if (p == NULL)
 			goto error;
-		p[0] = XMALLOC_MAGIC;
+		p[0] = _stats_alloc(file, count_size);
 	}
 
 	p[1] = count_size;
@@ -194,7 +366,7 @@ size_t xsize(void *item)
 {
 	size_t *p = (size_t *)item - 2;
 	xassert(item != NULL);
-	xassert(p[0] == XMALLOC_MAGIC); /* CLANG false positive here */
+	xassert(XMALLOC_MAGIC_OK(p)); /* CLANG false positive here */
 	return p[1];
 }
 
@@ -208,7 +380,8 @@ void slurm_xfree(void **item)
 	if (*item != NULL) {
 		size_t *p = (size_t *)*item - 2;
 		/* magic cookie still there? */
-		xassert(p[0] == XMALLOC_MAGIC);
+		xassert(XMALLOC_MAGIC_OK(p));
+		_stats_free(p);
 		p[0] = 0;	/* make sure xfree isn't called twice */
 		free(p);
 		*item = NULL;
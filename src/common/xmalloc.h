@@ -49,6 +49,7 @@
  * xmalloc(size) allocates size bytes and returns a pointer to the allocated
  * memory. The memory is set to zero. xmalloc() will not return unless
  * there are no errors. The memory must be freed using xfree().
+ * The _nz variants skip the zeroing, for buffers the caller fills entirely.
  *
  * xrealloc(p, newsize) changes the size of the block pointed to by p to the
  * value of newsize. Newly allocated memory is zeroed. If p is NULL,
@@ -63,12 +64,17 @@
  * p. The memory must have been allocated with [try_]xmalloc() or
  * [try_]xrealloc().
  *
+ * xmalloc_stats_enable() starts counting allocations, frees and live bytes
+ * per subsystem (the source directory of the caller). Memory allocated
+ * before this call is not accounted.
+ *
 \*****************************************************************************/
 
 #ifndef _XMALLOC_H
 #define _XMALLOC_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #define xcalloc(__cnt, __sz) \
@@ -89,6 +95,9 @@
 #define xmalloc_nz(__sz) \
 	slurm_xcalloc(1, __sz, false, false, __FILE__, __LINE__, __func__)
 
+#define try_xmalloc_nz(__sz) \
+	slurm_xcalloc(1, __sz, false, true, __FILE__, __LINE__, __func__)
+
 #define xfree(__p) slurm_xfree((void **)&(__p))
 
 #define xfree_array(__p) slurm_xfree_array((void ***)&(__p))
@@ -108,6 +117,9 @@
 #define xrealloc_nz(__p, __sz) \
         slurm_xrecalloc((void **)&(__p), 1, __sz, false, false, __FILE__, __LINE__, __func__)
 
+#define try_xrealloc_nz(__p, __sz) \
+        slurm_xrecalloc((void **)&(__p), 1, __sz, false, true, __FILE__, __LINE__, __func__)
+
 void *slurm_xcalloc(size_t, size_t, bool, bool, const char *, int, const char *);
 void slurm_xfree(void **);
 void slurm_xfree_array(void ***);
@@ -117,4 +129,15 @@ size_t xsize(void *item);
 
 void xfree_ptr(void *);
 
+extern void xmalloc_stats_enable(void);
+
+/*
+ * Copy out the per-subsystem counters.
+ * OUT names - xmalloc()'d array of static subsystem names
+ * OUT allocs, frees, bytes - xmalloc()'d arrays of counters
+ * RET number of subsystems, 0 if accounting is not enabled
+ */
+extern uint32_t xmalloc_stats_get(char ***names, uint64_t **allocs,
+				  uint64_t **frees, uint64_t **bytes);
+
 #endif /* !_XMALLOC_H */
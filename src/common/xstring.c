@@ -61,6 +61,7 @@
 #include "src/common/xstring.h"
 
 #define XFGETS_CHUNKSIZE 64
+#define XSTRFMT_STACK_SIZE 256
 
 /*
  * Define slurm-specific aliases for use by plugins, see slurm_xlator.h
@@ -329,30 +330,48 @@ extern void _xrfc3339timecat(char **buf)
 	_xstrfmtcat(buf, "%s%s", p, z);
 }
 
+/*
+ * Format into a stack buffer and append the result to str at orig_len.
+ * Only output longer than the stack buffer goes through a heap copy. The
+ * arguments are never formatted in place, as they may point into str.
+ * RET length appended
+ */
+static size_t _vprintf_at(char **str, size_t orig_len, const char *fmt,
+			  va_list ap)
+{
+	char buf[XSTRFMT_STACK_SIZE], *p = buf;
+	va_list our_ap;
+	int n;
+
+	va_copy(our_ap, ap);
+	n = vsnprintf(buf, sizeof(buf), fmt, our_ap);
+	va_end(our_ap);
+
+	if (n < 0)
+		return 0;
+	if (n >= sizeof(buf))
+		_xstrdup_vprintf(&p, fmt, ap);
+
+	_makespace(str, orig_len, n);
+	memcpy(*str + orig_len, p, n + 1);
+
+	if (p != buf)
+		xfree(p);
+
+	return n;
+}
+
 /*
  * append formatted string with printf-style args to buf, expanding
  * buf as needed
  */
 void _xstrfmtcat(char **str, const char *fmt, ...)
 {
-	char *p = NULL;
 	va_list ap;
 
 	va_start(ap, fmt);
-	_xstrdup_vprintf(&p, fmt, ap);
+	_vprintf_at(str, (*str ? strlen(*str) : 0), fmt, ap);
 	va_end(ap);
-
-	if (!p)
-		return;
-
-	/* If str does not exist yet, just give it back p directly */
-	if (!*str) {
-		*str = p;
-		return;
-	}
-
-	xstrcat(*str, p);
-	xfree(p);
 }
 
 /*
@@ -367,35 +386,20 @@ void _xstrfmtcat(char **str, const char *fmt, ...)
 void _xstrfmtcatat(char **str, char **pos, const char *fmt, ...)
 {
 	size_t orig_len, append_len;
-	char *p = NULL;
 	va_list ap;
 
-	va_start(ap, fmt);
-	append_len = _xstrdup_vprintf(&p, fmt, ap);
-	va_end(ap);
-
-	if (!p)
-		return;
-
-	/* No string yet to append to, so just return p. */
 	if (!*str) {
-		*str = p;
-		*pos = p + append_len;
-		return;
-	}
-
-	if (!*pos) {
+		orig_len = 0;
+	} else if (!*pos) {
 		orig_len = strlen(*str);
-		*pos = *str + orig_len;
 	} else {
 		xassert(*pos >= *str);
 		orig_len = *pos - *str;
 	}
 
-	_makespace(str, orig_len, append_len);
-
-	memcpy(*str + orig_len, p, append_len);
-	xfree(p);
+	va_start(ap, fmt);
+	append_len = _vprintf_at(str, orig_len, fmt, ap);
+	va_end(ap);
 
 	/*
 	 * Update *pos. Cannot happen earlier as _makespace() may have
@@ -331,6 +331,14 @@ extern int conmgr_queue_send_fd(conmgr_fd_t *con, int fd);
 extern int conmgr_queue_write_data(conmgr_fd_t *con, const void *buffer,
 				   const size_t bytes);
 
+/*
+ * Queue already packed buffer to be written to connection without copying.
+ * IN con connection manager connection struct
+ * IN buf buffer to write upto its offset. Ownership is taken in all cases.
+ * RET SLURM_SUCCESS or error
+ */
+extern int conmgr_queue_write_buf(conmgr_fd_t *con, buf_t *buf);
+
 /*
  * Write packed msg to connection (from callback).
  * NOTE: type=CON_TYPE_RPC only
@@ -47,6 +47,8 @@
 #include "src/conmgr/mgr.h"
 
 #define DEFAULT_READ_BYTES 512
+/* Max read()s done by handle_read() before returning to poll() */
+#define READ_BATCH_MAX 8
 
 /*
  * Default number of write()s to queue up using the stack instead of xmalloc().
@@ -106,40 +108,49 @@ extern void handle_read(conmgr_callback_args_t conmgr_args, void *arg)
 		return;
 	}
 
-	readable = _get_fd_readable(con);
+	/*
+	 * A read() that fills the whole request likely left more data queued,
+	 * so keep reading instead of going back through poll() for every
+	 * chunk of a large message.
+	 */
+	for (int i = 0; i < READ_BATCH_MAX; i++) {
+		readable = _get_fd_readable(con);
 
-	/* Grow buffer as needed to handle the incoming data */
-	if ((rc = try_grow_buf_remaining(con->in, readable))) {
-		error("%s: [%s] unable to allocate larger input buffer: %s",
-		      __func__, con->name, slurm_strerror(rc));
-		close_con(false, con);
-		return;
-	}
+		/* Grow buffer as needed to handle the incoming data */
+		if ((rc = try_grow_buf_remaining(con->in, readable))) {
+			error("%s: [%s] unable to allocate larger input buffer: %s",
+			      __func__, con->name, slurm_strerror(rc));
+			close_con(false, con);
+			return;
+		}
 
-	/* check for errors with a NULL read */
-	read_c = read(con->input_fd,
-		      (get_buf_data(con->in) + get_buf_offset(con->in)),
-		      readable);
-	if (read_c == -1) {
-		if (errno == EAGAIN || errno == EWOULDBLOCK) {
-			log_flag(NET, "%s: [%s] socket would block on read",
+		/* check for errors with a NULL read */
+		read_c = read(con->input_fd,
+			      (get_buf_data(con->in) + get_buf_offset(con->in)),
+			      readable);
+		if (read_c == -1) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				log_flag(NET, "%s: [%s] socket would block on read",
+					 __func__, con->name);
+				return;
+			}
+
+			log_flag(NET, "%s: [%s] error while reading: %m",
 				 __func__, con->name);
+			close_con(false, con);
+			return;
+		} else if (read_c == 0) {
+			log_flag(NET, "%s: [%s] read %zd bytes and EOF with %u bytes to process already in buffer",
+				 __func__, con->name, read_c,
+				 get_buf_offset(con->in));
+
+			slurm_mutex_lock(&mgr.mutex);
+			/* lock to tell mgr that we are done */
+			con->read_eof = true;
+			slurm_mutex_unlock(&mgr.mutex);
 			return;
 		}
 
-		log_flag(NET, "%s: [%s] error while reading: %m",
-			 __func__, con->name);
-		close_con(false, con);
-		return;
-	} else if (read_c == 0) {
-		log_flag(NET, "%s: [%s] read %zd bytes and EOF with %u bytes to process already in buffer",
-			 __func__, con->name, read_c, get_buf_offset(con->in));
-
-		slurm_mutex_lock(&mgr.mutex);
-		/* lock to tell mgr that we are done */
-		con->read_eof = true;
-		slurm_mutex_unlock(&mgr.mutex);
-	} else {
 		log_flag(NET, "%s: [%s] read %zd bytes with %u bytes to process already in buffer",
 			 __func__, con->name, read_c, get_buf_offset(con->in));
 		log_flag_hex(NET_RAW,
@@ -147,6 +158,9 @@ extern void handle_read(conmgr_callback_args_t conmgr_args, void *arg)
 			     read_c, "%s: [%s] read", __func__, con->name);
 
 		get_buf_offset(con->in) += read_c;
+
+		if (read_c < readable)
+			break;
 	}
 }
 
@@ -397,6 +411,28 @@ extern int conmgr_queue_write_data(conmgr_fd_t *con, const void *buffer,
 	return SLURM_SUCCESS;
 }
 
+extern int conmgr_queue_write_buf(conmgr_fd_t *con, buf_t *buf)
+{
+	xassert(con->magic == MAGIC_CON_MGR_FD);
+	xassert(buf->magic == BUF_MAGIC);
+
+	/* outgoing buffers are written from offset upto size */
+	buf->size = get_buf_offset(buf);
+	set_buf_offset(buf, 0);
+
+	log_flag(NET, "%s: [%s] write of %u bytes queued",
+		 __func__, con->name, size_buf(buf));
+
+	log_flag_hex(NET_RAW, get_buf_data(buf), size_buf(buf),
+		     "%s: queuing up write", __func__);
+
+	list_append(con->out, buf);
+	slurm_mutex_lock(&mgr.mutex);
+	EVENT_SIGNAL(&mgr.watch_sleep);
+	slurm_mutex_unlock(&mgr.mutex);
+	return SLURM_SUCCESS;
+}
+
 extern void conmgr_fd_get_in_buffer(const conmgr_fd_t *con,
 				    const void **data_ptr, size_t *bytes_ptr)
 {
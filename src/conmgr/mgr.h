@@ -412,9 +412,14 @@ extern int on_rpc_connection_data(conmgr_fd_t *con, void *arg);
 extern conmgr_fd_t *con_find_by_fd(int fd);
 
 /*
- * Wrap work requested to notify mgr when that work is complete
+ * Run work and release it
+ * NOTE: Caller must not hold mgr.mutex lock
+ * IN work - work to run. Takes ownership.
+ * RET connection of work (or NULL). Caller must lock mgr.mutex, unset
+ *	con->work_active and signal mgr.watch_sleep to notify mgr that the
+ *	work is complete.
  */
-extern void wrap_work(work_t *work);
+extern conmgr_fd_t *wrap_work(work_t *work);
 
 /*
  * Notify all worker thread to shutdown.
@@ -161,22 +161,24 @@ extern int conmgr_queue_write_msg(conmgr_fd_t *con, slurm_msg_t *msg)
 	/* switch to network order */
 	msglen = htonl(msglen);
 
-	//TODO: handing over the buffers would be better than copying
-
 	if ((rc = conmgr_queue_write_data(con, &msglen, sizeof(msglen))))
 		goto cleanup;
 
-	if ((rc = conmgr_queue_write_data(con, get_buf_data(buffers.header),
-					  get_buf_offset(buffers.header))))
+	/* hand over the packed buffers instead of copying them */
+	rc = conmgr_queue_write_buf(con, buffers.header);
+	buffers.header = NULL;
+	if (rc)
 		goto cleanup;
 
-	if (buffers.auth &&
-	    (rc = conmgr_queue_write_data(con, get_buf_data(buffers.auth),
-					  get_buf_offset(buffers.auth))))
-		goto cleanup;
+	if (buffers.auth) {
+		rc = conmgr_queue_write_buf(con, buffers.auth);
+		buffers.auth = NULL;
+		if (rc)
+			goto cleanup;
+	}
 
-	rc = conmgr_queue_write_data(con, get_buf_data(buffers.body),
-				     get_buf_offset(buffers.body));
+	rc = conmgr_queue_write_buf(con, buffers.body);
+	buffers.body = NULL;
 cleanup:
 	if (!rc) {
 		log_flag(PROTOCOL, "%s: [%s] sending RPC %s",
@@ -421,6 +421,75 @@ static void _inspect_connections(conmgr_callback_args_t conmgr_args, void *arg)
 	slurm_mutex_unlock(&mgr.mutex);
 }
 
+typedef struct {
+	int events;		/* events handled so far */
+	conmgr_fd_t **cons;	/* connections indexed by fd */
+	int cons_size;
+} poll_events_args_t;
+
+static void _add_fd_con(poll_events_args_t *args, int fd, conmgr_fd_t *con)
+{
+	/* first connection found wins, as with con_find_by_fd() */
+	if ((fd >= 0) && (fd < args->cons_size) && !args->cons[fd])
+		args->cons[fd] = con;
+}
+
+static int _foreach_max_fd(void *x, void *arg)
+{
+	conmgr_fd_t *con = x;
+	int *max_fd = arg;
+
+	*max_fd = MAX(*max_fd, MAX(con->input_fd, con->output_fd));
+	return SLURM_SUCCESS;
+}
+
+static int _foreach_add_fd_con(void *x, void *arg)
+{
+	conmgr_fd_t *con = x;
+
+	_add_fd_con(arg, con->input_fd, con);
+	_add_fd_con(arg, con->output_fd, con);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Find connection for a polled fd. A single event is looked up directly but
+ * once there are more, index all connections by fd to avoid walking every
+ * connection for each event.
+ */
+static conmgr_fd_t *_find_poll_con(poll_events_args_t *args, int fd)
+{
+	conmgr_fd_t *con;
+
+	if (args->events++ < 1)
+		return con_find_by_fd(fd);
+
+	if (!args->cons) {
+		int max_fd = -1;
+
+		(void) list_for_each(mgr.connections, _foreach_max_fd, &max_fd);
+		(void) list_for_each(mgr.listen_conns, _foreach_max_fd,
+				     &max_fd);
+
+		args->cons_size = max_fd + 1;
+		args->cons = xcalloc(MAX(args->cons_size, 1),
+				     sizeof(*args->cons));
+		(void) list_for_each(mgr.connections, _foreach_add_fd_con,
+				     args);
+		(void) list_for_each(mgr.listen_conns, _foreach_add_fd_con,
+				     args);
+	}
+
+	if (fd >= args->cons_size)
+		return NULL;
+
+	/* an earlier event may have closed the connection's fd */
+	if ((con = args->cons[fd]) &&
+	    ((con->input_fd == fd) || (con->output_fd == fd)))
+		return con;
+	return NULL;
+}
+
 /* caller (or thread) must hold mgr.mutex lock */
 static int _handle_poll_event(int fd, pollctl_events_t events, void *arg)
 {
@@ -428,7 +497,7 @@ static int _handle_poll_event(int fd, pollctl_events_t events, void *arg)
 
 	xassert(fd >= 0);
 
-	if (!(con = con_find_by_fd(fd))) {
+	if (!(con = _find_poll_con(arg, fd))) {
 		/* close_con() was called during poll() was running */
 		log_flag(CONMGR, "%s: Ignoring events for unknown fd:%d",
 			 __func__, fd);
@@ -483,6 +552,7 @@ static int _handle_poll_event(int fd, pollctl_events_t events, void *arg)
 /* Poll all connections */
 static void _poll_connections(conmgr_callback_args_t conmgr_args, void *arg)
 {
+	poll_events_args_t args = { 0 };
 	int rc;
 
 	xassert(!conmgr_args.con);
@@ -509,11 +579,12 @@ static void _poll_connections(conmgr_callback_args_t conmgr_args, void *arg)
 
 	slurm_mutex_lock(&mgr.mutex);
 
-	if ((rc = pollctl_for_each_event(_handle_poll_event, NULL,
+	if ((rc = pollctl_for_each_event(_handle_poll_event, &args,
 					 XSTRINGIFY(_handle_poll_event),
 					 __func__)))
 		fatal_abort("%s: should never fail: pollctl_for_each_event()=%s",
 			    __func__, slurm_strerror(rc));
+	xfree(args.cons);
 
 done:
 	xassert(mgr.poll_active);
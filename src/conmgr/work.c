@@ -195,7 +195,7 @@ static void _log_work(work_t *work, const char *caller, const char *fmt, ...)
 	xfree(fmtstr);
 }
 
-extern void wrap_work(work_t *work)
+extern conmgr_fd_t *wrap_work(work_t *work)
 {
 	conmgr_fd_t *con = work->con;
 
@@ -210,17 +210,10 @@ extern void wrap_work(work_t *work)
 
 	_log_work(work, __func__, "END");
 
-	if (con) {
-		slurm_mutex_lock(&mgr.mutex);
-		con->work_active = false;
-		/* con may be xfree()ed any time once lock is released */
-
-		EVENT_SIGNAL(&mgr.watch_sleep);
-		slurm_mutex_unlock(&mgr.mutex);
-	}
-
 	work->magic = ~MAGIC_WORK;
 	xfree(work);
+
+	return con;
 }
 
 /*
@@ -237,8 +230,9 @@ static void _handle_work_run(work_t *work)
 {
 	xassert(work->magic == MAGIC_WORK);
 
-	_log_work(work, __func__, "Enqueueing work. work:%u",
-		  list_count(mgr.work));
+	if (slurm_conf.debug_flags & DEBUG_FLAG_CONMGR)
+		_log_work(work, __func__, "Enqueueing work. work:%u",
+			  list_count(mgr.work));
 
 	/* add to work list and signal a thread if watch is active */
 	list_append(mgr.work, work);
@@ -266,8 +260,9 @@ static void _handle_work_pending(work_t *work)
 	}
 
 	if (depend & CONMGR_WORK_DEP_TIME_DELAY) {
-		_log_work(work, __func__, "Enqueueing delayed work. delayed_work:%u",
-			  list_count(mgr.delayed_work));
+		if (slurm_conf.debug_flags & DEBUG_FLAG_CONMGR)
+			_log_work(work, __func__, "Enqueueing delayed work. delayed_work:%u",
+				  list_count(mgr.delayed_work));
 		list_append(mgr.delayed_work, work);
 		update_timer();
 		return;
@@ -275,8 +270,9 @@ static void _handle_work_pending(work_t *work)
 
 	if (depend & CONMGR_WORK_DEP_CON_WRITE_COMPLETE) {
 		xassert(con);
-		_log_work(work, __func__, "Enqueueing connection write complete work. work_active=%c pending_writes=%u pending_write_complete_work:%u",
-			 (con->work_active ? 'T' : 'F'), list_count(con->out), list_count(con->write_complete_work));
+		if (slurm_conf.debug_flags & DEBUG_FLAG_CONMGR)
+			_log_work(work, __func__, "Enqueueing connection write complete work. work_active=%c pending_writes=%u pending_write_complete_work:%u",
+				 (con->work_active ? 'T' : 'F'), list_count(con->out), list_count(con->write_complete_work));
 		list_append(con->write_complete_work, work);
 		return;
 	}
@@ -288,8 +284,9 @@ static void _handle_work_pending(work_t *work)
 	}
 
 	if (con) {
-		_log_work(work, __func__, "Enqueueing connection work. work_active=%c pending_work:%u",
-			 (con->work_active ? 'T' : 'F'), list_count(con->work));
+		if (slurm_conf.debug_flags & DEBUG_FLAG_CONMGR)
+			_log_work(work, __func__, "Enqueueing connection work. work_active=%c pending_work:%u",
+				 (con->work_active ? 'T' : 'F'), list_count(con->work));
 		list_append(con->work, work);
 
 		/* trigger watch() if there is a connection involved */
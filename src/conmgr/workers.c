@@ -172,6 +172,7 @@ static void *_worker(void *arg)
 	 */
 	while (true) {
 		work_t *work = NULL;
+		conmgr_fd_t *con = NULL;
 
 		work = list_pop(mgr.work);
 
@@ -212,12 +213,22 @@ static void *_worker(void *arg)
 		slurm_mutex_unlock(&mgr.mutex);
 
 		/* run work via wrap_work() which will xfree(work) */
-		wrap_work(work);
+		con = wrap_work(work);
 		work = NULL;
 
 		/* Lock mutex after running work */
 		slurm_mutex_lock(&mgr.mutex);
 
+		/*
+		 * Release the connection here instead of in wrap_work() to
+		 * only take mgr.mutex once per finished work.
+		 */
+		if (con) {
+			con->work_active = false;
+			/* con may be xfree()ed any time once lock is released */
+			EVENT_SIGNAL(&mgr.watch_sleep);
+		}
+
 		mgr.workers.active--;
 
 		log_flag(CONMGR, "%s: [%u] finished active_workers=%u/%u queue=%u",
@@ -78,6 +78,30 @@ static int _find_db_key(void *x, void *key)
 	return 1;
 }
 
+typedef struct {
+	char *query;
+	MYSQL_STMT *stmt;
+} db_stmt_t;
+
+static void _destroy_db_stmt(void *arg)
+{
+	db_stmt_t *db_stmt = arg;
+
+	if (db_stmt) {
+		if (db_stmt->stmt)
+			mysql_stmt_close(db_stmt->stmt);
+		xfree(db_stmt->query);
+		xfree(db_stmt);
+	}
+}
+
+static int _find_db_stmt(void *x, void *key)
+{
+	db_stmt_t *db_stmt = x;
+
+	return !xstrcmp(db_stmt->query, key);
+}
+
 /* NOTE: Ensure that mysql_conn->lock is set on function entry */
 static int _clear_results(MYSQL *db_conn)
 {
@@ -718,6 +742,8 @@ void _set_mysql_ssl_opts(MYSQL *db_conn, const char *options)
 			key = val_str;
 		else if (!xstrcasecmp(opt_str, "SSL_CIPHER"))
 			cipher = val_str;
+		else if (!xstrcasecmp(opt_str, "JOB_PARTITIONS"))
+			goto next; /* used by accounting_storage/mysql */
 		else {
 			error("Invalid storage option '%s'", opt_str);
 			goto next;
@@ -878,6 +904,9 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 
 	slurm_mutex_lock(&mysql_conn->lock);
 
+	/* Statements are only valid on the connection that prepared them */
+	FREE_NULL_LIST(mysql_conn->stmt_list);
+
 	if (!(mysql_conn->db_conn = mysql_init(mysql_conn->db_conn))) {
 		slurm_mutex_unlock(&mysql_conn->lock);
 		fatal("mysql_init failed: %s",
@@ -953,6 +982,7 @@ extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 {
 	slurm_mutex_lock(&mysql_conn->lock);
 	if (mysql_conn && mysql_conn->db_conn) {
+		FREE_NULL_LIST(mysql_conn->stmt_list);
 		if (mysql_thread_safe())
 			mysql_thread_end();
 		mysql_close(mysql_conn->db_conn);
@@ -1108,6 +1138,72 @@ fini:
 	return result;
 }
 
+extern MYSQL_STMT *mysql_db_stmt_execute(mysql_conn_t *mysql_conn,
+					 char *query, MYSQL_BIND *params,
+					 MYSQL_BIND *results)
+{
+	db_stmt_t *db_stmt = NULL;
+	MYSQL_STMT *stmt = NULL;
+
+	if (!mysql_conn || !mysql_conn->db_conn) {
+		fatal("You haven't inited this storage yet.");
+		return NULL;	/* For CLANG false positive */
+	}
+
+	slurm_mutex_lock(&mysql_conn->lock);
+
+	/* clear out the old results so we don't get a 2014 error */
+	_clear_results(mysql_conn->db_conn);
+
+	if (!mysql_conn->stmt_list)
+		mysql_conn->stmt_list = list_create(_destroy_db_stmt);
+	else
+		db_stmt = list_find_first(mysql_conn->stmt_list, _find_db_stmt,
+					  query);
+
+	if (!db_stmt) {
+		if (!(stmt = mysql_stmt_init(mysql_conn->db_conn))) {
+			error("mysql_stmt_init failed: %s",
+			      mysql_error(mysql_conn->db_conn));
+			goto fini;
+		}
+		if (mysql_stmt_prepare(stmt, query, strlen(query))) {
+			error("mysql_stmt_prepare failed: %d %s\n%s",
+			      mysql_stmt_errno(stmt), mysql_stmt_error(stmt),
+			      query);
+			mysql_stmt_close(stmt);
+			stmt = NULL;
+			goto fini;
+		}
+		db_stmt = xmalloc(sizeof(*db_stmt));
+		db_stmt->query = xstrdup(query);
+		db_stmt->stmt = stmt;
+		list_append(mysql_conn->stmt_list, db_stmt);
+	}
+	stmt = db_stmt->stmt;
+
+	if ((params && mysql_stmt_bind_param(stmt, params)) ||
+	    mysql_stmt_execute(stmt) ||
+	    (results && mysql_stmt_bind_result(stmt, results)) ||
+	    mysql_stmt_store_result(stmt)) {
+		error("mysql_stmt_execute failed: %d %s\n%s",
+		      mysql_stmt_errno(stmt), mysql_stmt_error(stmt), query);
+		/* Prepare it again next time in case it became invalid */
+		list_delete_ptr(mysql_conn->stmt_list, db_stmt);
+		stmt = NULL;
+	}
+
+fini:
+	/*
+	 * Starting in MariaDB 10.2 many of the api commands started
+	 * setting errno erroneously.
+	 */
+	if (stmt)
+		errno = 0;
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return stmt;
+}
+
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 {
 	int rc = SLURM_SUCCESS;
@@ -66,6 +66,7 @@ typedef struct {
 	pthread_mutex_t lock;
 	char *pre_commit_query;
 	List update_list;
+	List stmt_list;	/* prepared statements, see mysql_db_stmt_execute */
 	int conn;
 	uint64_t wsrep_trx_fragment_size_orig;
 	char *wsrep_trx_fragment_unit_orig;
@@ -105,6 +106,19 @@ extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 				     char *query, bool last);
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query);
 
+/*
+ * Execute a statement with '?' placeholders. It is prepared on its first use
+ * on this connection and kept, so the server parses it only once.
+ * IN query - statement text, also the key of the statement cache
+ * IN params - input parameters, one per placeholder, or NULL
+ * IN results - output columns bound for mysql_stmt_fetch(), or NULL
+ * RET the executed statement with its result stored, or NULL on error. The
+ * caller fetches the rows and must call mysql_stmt_free_result() on it.
+ */
+extern MYSQL_STMT *mysql_db_stmt_execute(mysql_conn_t *mysql_conn,
+					 char *query, MYSQL_BIND *params,
+					 MYSQL_BIND *results);
+
 extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query);
 
 extern int mysql_db_create_table(mysql_conn_t *mysql_conn, char *table_name,
@@ -40,9 +40,12 @@
 #  include "config.h"
 #endif
 
+#include <fcntl.h>
 #include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #if HAVE_SYS_PRCTL_H
 #  include <sys/prctl.h>
@@ -285,6 +288,98 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+extern void acct_gather_energy_write_snapshot(const char *path,
+					      time_t poll_time,
+					      uint16_t sensor_cnt,
+					      acct_gather_energy_t *energy)
+{
+	int fd;
+	char *new_file = NULL;
+	buf_t *buffer;
+
+	if (!path || !sensor_cnt || !energy)
+		return;
+
+	buffer = init_buf(BUF_SIZE);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(poll_time, buffer);
+	pack16(sensor_cnt, buffer);
+	for (int i = 0; i < sensor_cnt; i++)
+		acct_gather_energy_pack(&energy[i], buffer,
+					SLURM_PROTOCOL_VERSION);
+
+	/*
+	 * Readers mmap() the file, so replace it with rename() instead of
+	 * rewriting it in place. No fsync(), stale readings are not worth
+	 * keeping over a crash.
+	 */
+	xstrfmtcat(new_file, "%s.new", path);
+	if ((fd = open(new_file, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC,
+		       0600)) < 0) {
+		debug("%s: unable to create %s: %m", __func__, new_file);
+		goto end;
+	}
+	safe_write(fd, get_buf_data(buffer), get_buf_offset(buffer));
+	close(fd);
+
+	if (rename(new_file, path))
+		debug("%s: unable to rename %s to %s: %m",
+		      __func__, new_file, path);
+	goto end;
+
+rwfail:
+	debug("%s: unable to write %s: %m", __func__, new_file);
+	close(fd);
+	(void) unlink(new_file);
+end:
+	FREE_NULL_BUFFER(buffer);
+	xfree(new_file);
+}
+
+extern int acct_gather_energy_read_snapshot(const char *path, uint16_t delta,
+					    uint16_t *sensor_cnt,
+					    acct_gather_energy_t **energy)
+{
+	buf_t *buffer;
+	uint16_t protocol_version, cnt = 0;
+	time_t poll_time;
+	acct_gather_energy_t *e = NULL, *energy_ptr;
+
+	xassert(sensor_cnt);
+	xassert(energy);
+
+	if (!path || !(buffer = create_mmap_buf(path)))
+		return SLURM_ERROR;
+
+	safe_unpack16(&protocol_version, buffer);
+	if (protocol_version != SLURM_PROTOCOL_VERSION)
+		goto unpack_error;
+	safe_unpack_time(&poll_time, buffer);
+	if ((time(NULL) - poll_time) > delta)
+		goto unpack_error;
+	safe_unpack16(&cnt, buffer);
+	if (!cnt)
+		goto unpack_error;
+
+	e = acct_gather_energy_alloc(cnt);
+	for (int i = 0; i < cnt; i++) {
+		energy_ptr = &e[i];
+		if (acct_gather_energy_unpack(&energy_ptr, buffer,
+					      protocol_version, false))
+			goto unpack_error;
+	}
+
+	FREE_NULL_BUFFER(buffer);
+	*sensor_cnt = cnt;
+	*energy = e;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	acct_gather_energy_destroy(e);
+	FREE_NULL_BUFFER(buffer);
+	return SLURM_ERROR;
+}
+
 extern int acct_gather_energy_g_update_node_energy(void)
 {
 	int retval = SLURM_ERROR;
@@ -64,6 +64,34 @@ extern int acct_gather_energy_unpack(acct_gather_energy_t **energy,
 				     buf_t *buffer, uint16_t protocol_version,
 				     bool need_alloc);
 
+/*
+ * Publish the node-level readings of a slurmd collector thread to file so
+ * that slurmstepd can read them without an energy RPC to slurmd.
+ *
+ * IN path - snapshot file, usually under SlurmdSpoolDir
+ * IN poll_time - time the readings were taken
+ * IN sensor_cnt - number of elements in energy
+ * IN energy - readings as returned by ENERGY_DATA_STRUCT
+ */
+extern void acct_gather_energy_write_snapshot(const char *path,
+					      time_t poll_time,
+					      uint16_t sensor_cnt,
+					      acct_gather_energy_t *energy);
+
+/*
+ * Read readings published by acct_gather_energy_write_snapshot().
+ *
+ * IN path - snapshot file
+ * IN delta - only use the snapshot if it is newer than this in seconds
+ * OUT sensor_cnt - number of elements in energy
+ * OUT energy - must be freed with acct_gather_energy_destroy()
+ * RET SLURM_SUCCESS or SLURM_ERROR if missing, stale or unreadable, in which
+ *     case the caller should fall back to slurm_get_node_energy().
+ */
+extern int acct_gather_energy_read_snapshot(const char *path, uint16_t delta,
+					    uint16_t *sensor_cnt,
+					    acct_gather_energy_t **energy);
+
 extern int acct_gather_energy_g_update_node_energy(void);
 extern int acct_gather_energy_g_get_sum(enum acct_energy_type data_type,
 					acct_gather_energy_t *energy);
@@ -44,6 +44,7 @@
 #include "src/common/macros.h"
 #include "src/common/plugin.h"
 #include "src/common/plugrack.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/util-net.h"
@@ -332,6 +333,7 @@ void *auth_g_create(int index, char *auth_info, uid_t r_uid,
 		    void *data, int dlen)
 {
 	cred_wrapper_t *cred;
+	uint64_t start;
 
 	xassert(g_context_num > 0);
 
@@ -339,7 +341,9 @@ void *auth_g_create(int index, char *auth_info, uid_t r_uid,
 		return NULL;
 
 	slurm_rwlock_rdlock(&context_lock);
+	start = plugin_stats_start();
 	cred = (*(ops[index].create))(auth_info, r_uid, data, dlen);
+	plugin_stats_end(start, g_context[index]->type, __func__);
 	slurm_rwlock_unlock(&context_lock);
 
 	if (cred)
@@ -363,6 +367,7 @@ extern int auth_g_verify(void *cred, char *auth_info)
 {
 	int rc = SLURM_ERROR;
 	cred_wrapper_t *wrap = cred;
+	uint64_t start;
 
 	xassert(g_context_num > 0);
 
@@ -370,7 +375,9 @@ extern int auth_g_verify(void *cred, char *auth_info)
 		return SLURM_ERROR;
 
 	slurm_rwlock_rdlock(&context_lock);
+	start = plugin_stats_start();
 	rc = (*(ops[wrap->index].verify))(cred, auth_info);
+	plugin_stats_end(start, g_context[wrap->index]->type, __func__);
 	slurm_rwlock_unlock(&context_lock);
 
 	return rc;
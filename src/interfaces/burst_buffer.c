@@ -48,6 +48,7 @@
 #include "src/common/macros.h"
 #include "src/common/pack.h"
 #include "src/common/plugin.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/plugrack.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/xmalloc.h"
@@ -579,7 +580,10 @@ extern int bb_g_job_test_stage_in(job_record_t *job_ptr, bool test_only)
 	xassert(g_context_cnt >= 0);
 	slurm_mutex_lock(&g_context_lock);
 	for (i = 0; i < g_context_cnt; i++) {
+		uint64_t start = plugin_stats_start();
+
 		rc2 = (*(ops[i].job_test_stage_in))(job_ptr, test_only);
+		plugin_stats_end(start, g_context[i]->type, __func__);
 		rc = MIN(rc, rc2);
 	}
 	slurm_mutex_unlock(&g_context_lock);
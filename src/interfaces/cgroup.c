@@ -57,6 +57,8 @@ typedef struct {
 	int	(*step_get_pids)	(pid_t **pids, int *npids);
 	int	(*step_suspend)		(void);
 	int	(*step_resume)		(void);
+	int	(*step_kill)		(void);
+	int	(*step_wait_empty)	(int timeout_ms);
 	int	(*step_destroy)		(cgroup_ctl_type_t sub);
 	bool	(*has_pid)		(pid_t pid);
 	cgroup_limits_t *(*constrain_get) (cgroup_ctl_type_t sub,
@@ -91,6 +93,8 @@ static const char *syms[] = {
 	"cgroup_p_step_get_pids",
 	"cgroup_p_step_suspend",
 	"cgroup_p_step_resume",
+	"cgroup_p_step_kill",
+	"cgroup_p_step_wait_empty",
 	"cgroup_p_step_destroy",
 	"cgroup_p_has_pid",
 	"cgroup_p_constrain_get",
@@ -828,6 +832,26 @@ extern int cgroup_g_step_resume(void)
 	return (*(ops.step_resume))();
 }
 
+extern int cgroup_g_step_kill(void)
+{
+	xassert(plugin_inited != PLUGIN_NOT_INITED);
+
+	if (plugin_inited == PLUGIN_NOOP)
+		return SLURM_ERROR;
+
+	return (*(ops.step_kill))();
+}
+
+extern int cgroup_g_step_wait_empty(int timeout_ms)
+{
+	xassert(plugin_inited != PLUGIN_NOT_INITED);
+
+	if (plugin_inited == PLUGIN_NOOP)
+		return SLURM_ERROR;
+
+	return (*(ops.step_wait_empty))(timeout_ms);
+}
+
 extern int cgroup_g_step_destroy(cgroup_ctl_type_t sub)
 {
 	xassert(plugin_inited != PLUGIN_NOT_INITED);
@@ -297,6 +297,24 @@ extern int cgroup_g_step_suspend(void);
  */
 extern int cgroup_g_step_resume(void);
 
+/*
+ * SIGKILL all the user processes of the step at once (cgroup.kill).
+ *
+ * RET SLURM_SUCCESS if the kill was issued, SLURM_ERROR if not supported and
+ *     the caller must signal the pids itself.
+ */
+extern int cgroup_g_step_kill(void);
+
+/*
+ * Wait for the user processes of the step to be gone, or the timeout to expire.
+ *
+ * IN timeout_ms - Maximum time to wait, in milliseconds.
+ * RET SLURM_SUCCESS if we blocked waiting (the caller must still check the
+ *     pids), SLURM_ERROR if there was nothing to block on or waiting is not
+ *     supported, in which case the caller must sleep by itself.
+ */
+extern int cgroup_g_step_wait_empty(int timeout_ms);
+
 /*
  * If the caller (typically from a plugin) is the only one using this step
  * object, rmdir the controller's step directories and destroy the associated
@@ -55,6 +55,7 @@
 #include "src/common/log.h"
 #include "src/common/macros.h"
 #include "src/common/plugin.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/plugrack.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_pack.h"
@@ -192,6 +193,7 @@ extern slurm_cred_t *slurm_cred_create(slurm_cred_arg_t *arg, bool sign_it,
 	slurm_cred_t *cred = NULL;
 	int i = 0, sock_recs = 0;
 	bool release_id = false;
+	uint64_t start;
 	identity_t fake_id = { .uid = arg->uid, .gid = arg->gid, .fake = true };
 
 	xassert(arg);
@@ -231,7 +233,9 @@ extern slurm_cred_t *slurm_cred_create(slurm_cred_arg_t *arg, bool sign_it,
 	}
 
 	identity_debug2(arg->id, __func__);
+	start = plugin_stats_start();
 	cred = (*(ops.cred_create))(arg, sign_it, protocol_version);
+	plugin_stats_end(start, g_context->type, __func__);
 
 	/* Release any values populated through _fill_cred_gids(). */
 	if (release_id)
@@ -643,7 +647,12 @@ extern void slurm_cred_pack(slurm_cred_t *cred, buf_t *buffer,
 
 extern slurm_cred_t *slurm_cred_unpack(buf_t *buffer, uint16_t protocol_version)
 {
-	return (*(ops.cred_unpack))(buffer, protocol_version);
+	uint64_t start = plugin_stats_start();
+	slurm_cred_t *cred = (*(ops.cred_unpack))(buffer, protocol_version);
+
+	plugin_stats_end(start, g_context->type, __func__);
+
+	return cred;
 }
 
 extern slurm_cred_t *slurm_cred_alloc(bool alloc_arg)
@@ -49,6 +49,7 @@
 
 #include "src/common/macros.h"
 #include "src/common/plugin.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/plugrack.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/xmalloc.h"
@@ -64,6 +65,9 @@ typedef struct slurm_submit_ops {
 		      uint32_t submit_uid, char **err_msg);
 } slurm_submit_ops_t;
 
+typedef int (*submit_unlocked_fn_t)(job_desc_msg_t *job_desc,
+				    uint32_t submit_uid, char **err_msg);
+
 /*
  * Must be synchronized with slurm_submit_ops_t above.
  */
@@ -77,6 +81,14 @@ static slurm_submit_ops_t *ops = NULL;
 static plugin_context_t **g_context = NULL;
 static pthread_rwlock_t context_lock = PTHREAD_RWLOCK_INITIALIZER;
 
+/*
+ * Optional "job_submit_unlocked" symbol of each plugin. Only the leading
+ * plugins that provide it are used, so plugin order is kept. Set only when
+ * SlurmctldParameters=job_submit_unlocked.
+ */
+static submit_unlocked_fn_t *unlocked_ops = NULL;
+static int unlocked_cnt = 0;
+
 /*
  * Initialize the job submit plugin.
  *
@@ -125,6 +137,21 @@ extern int job_submit_g_init(bool locked)
 	}
 	xfree(tmp_plugin_list);
 
+	if ((rc == SLURM_SUCCESS) &&
+	    xstrcasestr(slurm_conf.slurmctld_params, "job_submit_unlocked")) {
+		unlocked_ops = xcalloc(g_context_cnt,
+				       sizeof(submit_unlocked_fn_t));
+		for (int i = 0; i < g_context_cnt; i++) {
+			if (!(unlocked_ops[i] = plugin_get_sym(
+				      g_context[i]->cur_plugin,
+				      "job_submit_unlocked")))
+				break;
+			unlocked_cnt++;
+		}
+		if (!unlocked_cnt)
+			info("job_submit_unlocked set, but the first of JobSubmitPlugins does not support it");
+	}
+
 fini:
 	if (rc != SLURM_SUCCESS)
 		job_submit_g_fini(true);
@@ -158,6 +185,8 @@ extern int job_submit_g_fini(bool locked)
 	}
 	xfree(ops);
 	xfree(g_context);
+	xfree(unlocked_ops);
+	unlocked_cnt = 0;
 	g_context_cnt = -1;
 
 fini:
@@ -194,7 +223,8 @@ extern int job_submit_g_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	START_TIMER;
 
 	/* Set to NO_VAL so that it can only be set by the job submit plugin. */
-	job_desc->site_factor = NO_VAL;
+	if (!job_desc->job_submit_done)
+		job_desc->site_factor = NO_VAL;
 
 	slurm_rwlock_rdlock(&context_lock);
 	xassert(g_context_cnt >= 0);
@@ -203,9 +233,60 @@ extern int job_submit_g_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	 * partition structures. Do not attempt to unlock them and then
 	 * lock again (say with a write lock) since doing so will trigger
 	 * a deadlock with the context_lock above.
+	 *
+	 * Skip plugins already run by job_submit_g_submit_unlocked().
 	 */
-	for (i = 0; ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++)
+	for (i = job_desc->job_submit_done;
+	     ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++) {
+		uint64_t start = plugin_stats_start();
+
 		rc = (*(ops[i].submit))(job_desc, submit_uid, err_msg);
+		plugin_stats_end(start, g_context[i]->type, __func__);
+	}
+	slurm_rwlock_unlock(&context_lock);
+	END_TIMER2(__func__);
+
+	return rc;
+}
+
+/*
+ * Execute the job_submit_unlocked() function of the leading job submit
+ * plugins that provide one, without any slurmctld locks held. The plugins
+ * run here are skipped by the following job_submit_g_submit() call.
+ * If any plugin function returns anything other than SLURM_SUCCESS
+ * then stop and forward it's return value.
+ * IN job_desc - Job request specification
+ * IN submit_uid - User issuing job submit request
+ * OUT err_msg - Custom error message to the user, caller to xfree results
+ */
+extern int job_submit_g_submit_unlocked(job_desc_msg_t *job_desc,
+					uint32_t submit_uid, char **err_msg)
+{
+	DEF_TIMERS;
+	int i, rc = SLURM_SUCCESS;
+
+	xassert(!verify_lock(JOB_LOCK, READ_LOCK));
+	xassert(!verify_lock(PART_LOCK, READ_LOCK));
+
+	slurm_rwlock_rdlock(&context_lock);
+	xassert(g_context_cnt >= 0);
+	if (!unlocked_cnt || job_desc->job_submit_done) {
+		slurm_rwlock_unlock(&context_lock);
+		return SLURM_SUCCESS;
+	}
+
+	START_TIMER;
+
+	/* Set to NO_VAL so that it can only be set by the job submit plugin. */
+	job_desc->site_factor = NO_VAL;
+
+	for (i = 0; ((i < unlocked_cnt) && (rc == SLURM_SUCCESS)); i++) {
+		uint64_t start = plugin_stats_start();
+
+		rc = (*(unlocked_ops[i]))(job_desc, submit_uid, err_msg);
+		plugin_stats_end(start, g_context[i]->type, __func__);
+	}
+	job_desc->job_submit_done = i;
 	slurm_rwlock_unlock(&context_lock);
 	END_TIMER2(__func__);
 
@@ -235,8 +316,12 @@ extern int job_submit_g_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 
 	slurm_rwlock_rdlock(&context_lock);
 	xassert(g_context_cnt >= 0);
-	for (i = 0; ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++)
+	for (i = 0; ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++) {
+		uint64_t start = plugin_stats_start();
+
 		rc = (*(ops[i].modify))(job_desc, job_ptr, submit_uid, err_msg);
+		plugin_stats_end(start, g_context[i]->type, __func__);
+	}
 	slurm_rwlock_unlock(&context_lock);
 	END_TIMER2(__func__);
 
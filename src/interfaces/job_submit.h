@@ -74,6 +74,18 @@ extern int job_submit_g_fini(bool locked);
 extern int job_submit_g_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 			       char **err_msg);
 
+/*
+ * Execute the job_submit_unlocked() function of the leading job submit
+ * plugins that provide one, with no slurmctld locks held. Only active with
+ * SlurmctldParameters=job_submit_unlocked. The plugins run here are skipped
+ * by the later job_submit_g_submit() for the same job_desc.
+ * IN job_desc - Job request specification
+ * IN submit_uid - User issuing job submit request
+ * OUT err_msg - Custom error message to the user, caller to xfree results
+ */
+extern int job_submit_g_submit_unlocked(job_desc_msg_t *job_desc,
+					uint32_t submit_uid, char **err_msg);
+
 /*
  * Execute the job_modify() function in each job submit plugin.
  * This should be called
@@ -166,16 +166,19 @@ static int _add_preemptable_job(void *x, void *arg)
 	if (candidate->het_job_id && !candidate->het_job_list)
 		return 0;
 
-	if (_is_job_preempt_exempt(candidate, preemptor))
-		return 0;
 	/*
-	 * We have to check the entire bitmap space here before we can check
-	 * each part of a hetjob in _is_job_preempt_exempt()
+	 * Most jobs are pending, finished or elsewhere on the cluster, so
+	 * filter on that before consulting the plugin and the limits. We have
+	 * to check the entire bitmap space here before we can check each part
+	 * of a hetjob in _is_job_preempt_exempt()
 	 */
 	if (!job_overlap_and_running(preemptor->part_ptr->node_bitmap,
 				     preemptor->license_list, candidate))
 		return 0;
 
+	if (_is_job_preempt_exempt(candidate, preemptor))
+		return 0;
+
 	/* This job is a preemption candidate */
 	if (!candidates->preemptee_job_list)
 		candidates->preemptee_job_list = list_create(NULL);
@@ -185,24 +188,48 @@ static int _add_preemptable_job(void *x, void *arg)
 	return 0;
 }
 
-static int _sort_by_prio(void *x, void *y)
+typedef struct {
+	job_record_t *job_ptr;
+	uint32_t prio;
+} preempt_prio_t;
+
+static int _sort_by_prio(const void *x, const void *y)
 {
-	int rc;
-	uint32_t job_prio1, job_prio2;
-	job_record_t *j1 = *(job_record_t **)x;
-	job_record_t *j2 = *(job_record_t **)y;
+	const preempt_prio_t *p1 = x, *p2 = y;
 
-	(void)(*(ops.get_data))(j1, PREEMPT_DATA_PRIO, &job_prio1);
-	(void)(*(ops.get_data))(j2, PREEMPT_DATA_PRIO, &job_prio2);
+	if (p1->prio > p2->prio)
+		return 1;
+	else if (p1->prio < p2->prio)
+		return -1;
+	return 0;
+}
 
-	if (job_prio1 > job_prio2)
-		rc = 1;
-	else if (job_prio1 < job_prio2)
-		rc = -1;
-	else
-		rc = 0;
+/*
+ * Sort the candidates by preemption priority, asking the plugin for each
+ * job's priority once rather than on every comparison.
+ */
+static void _sort_candidates_by_prio(list_t *job_list)
+{
+	int cnt = list_count(job_list), i = 0;
+	preempt_prio_t *prio_array;
+	job_record_t *job_ptr;
+
+	if (cnt < 2)
+		return;
+
+	prio_array = xcalloc(cnt, sizeof(*prio_array));
+	while ((job_ptr = list_pop(job_list))) {
+		prio_array[i].job_ptr = job_ptr;
+		(void)(*(ops.get_data))(job_ptr, PREEMPT_DATA_PRIO,
+					&prio_array[i].prio);
+		i++;
+	}
 
-	return rc;
+	qsort(prio_array, cnt, sizeof(*prio_array), _sort_by_prio);
+
+	for (i = 0; i < cnt; i++)
+		list_append(job_list, prio_array[i].job_ptr);
+	xfree(prio_array);
 }
 
 static int _sort_by_youngest(void *x, void *y)
@@ -314,7 +341,7 @@ extern List slurm_find_preemptable_jobs(job_record_t *job_ptr)
 	if (candidates.preemptee_job_list && youngest_order)
 		list_sort(candidates.preemptee_job_list, _sort_by_youngest);
 	else if (candidates.preemptee_job_list)
-		list_sort(candidates.preemptee_job_list, _sort_by_prio);
+		_sort_candidates_by_prio(candidates.preemptee_job_list);
 
 	return candidates.preemptee_job_list;
 }
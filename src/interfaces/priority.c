@@ -38,6 +38,7 @@
 
 #include "src/interfaces/priority.h"
 #include "src/common/plugin.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/plugrack.h"
 #include "src/common/xstring.h"
 
@@ -137,9 +138,16 @@ extern void priority_g_thread_start(void)
 
 extern uint32_t priority_g_set(uint32_t last_prio, job_record_t *job_ptr)
 {
+	uint64_t start;
+	uint32_t prio;
+
 	xassert(g_priority_context);
 
-	return (*(ops.set))(last_prio, job_ptr);
+	start = plugin_stats_start();
+	prio = (*(ops.set))(last_prio, job_ptr);
+	plugin_stats_end(start, g_priority_context->type, __func__);
+
+	return prio;
 }
 
 extern void priority_g_reconfig(bool assoc_clear)
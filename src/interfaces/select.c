@@ -44,7 +44,9 @@
 
 #include "src/common/list.h"
 #include "src/interfaces/select.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/usdt.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
 
@@ -496,14 +498,24 @@ extern int select_g_job_test(job_record_t *job_ptr, bitstr_t *bitmap,
 			     List *preemptee_job_list,
 			     resv_exc_t *resv_exc_ptr)
 {
+	int rc;
+	uint64_t start;
+
 	xassert(select_context_cnt >= 0);
 
-	return (*(ops[select_context_default].job_test))
+	SLURM_PROBE2(job_test_start, job_ptr->job_id, mode);
+	start = plugin_stats_start();
+	rc = (*(ops[select_context_default].job_test))
 		(job_ptr, bitmap,
 		 min_nodes, max_nodes,
 		 req_nodes, mode,
 		 preemptee_candidates, preemptee_job_list,
 		 resv_exc_ptr);
+	plugin_stats_end(start, select_context[select_context_default]->type,
+			 __func__);
+	SLURM_PROBE2(job_test_done, job_ptr->job_id, rc);
+
+	return rc;
 }
 
 /*
@@ -54,6 +54,7 @@
 #include "as_mysql_fix_runaway_jobs.h"
 #include "as_mysql_job.h"
 #include "as_mysql_jobacct_process.h"
+#include "as_mysql_partition.h"
 #include "as_mysql_problems.h"
 #include "as_mysql_qos.h"
 #include "as_mysql_resource.h"
@@ -1475,6 +1476,8 @@ extern int create_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
 	};
 
 	char table_name[200];
+	char *ending = NULL;
+	int rc;
 
 	if (create_cluster_assoc_table(mysql_conn, cluster_name)
 	    == SLURM_ERROR)
@@ -1551,6 +1554,17 @@ extern int create_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
 	    == SLURM_ERROR)
 		return SLURM_ERROR;
 
+	/*
+	 * The column a table is partitioned on has to be in its primary key,
+	 * so partitioning is removed before the primary key is changed back.
+	 */
+	if (!as_mysql_job_partitions &&
+	    ((as_mysql_partition_remove(mysql_conn, cluster_name, job_table)
+	      != SLURM_SUCCESS) ||
+	     (as_mysql_partition_remove(mysql_conn, cluster_name, step_table)
+	      != SLURM_SUCCESS)))
+		return SLURM_ERROR;
+
 	snprintf(table_name, sizeof(table_name), "\"%s_%s\"",
 		 cluster_name, job_table);
 
@@ -1558,28 +1572,31 @@ extern int create_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
 	 * sacct_def is the index for query's with state as time_start is used
 	 * in these queries. sacct_def2 is for plain sacct queries.
 	 */
-	if (mysql_db_create_table(mysql_conn, table_name, job_table_fields,
-				  ", primary key (job_db_inx), "
-				  "unique index (id_job, time_submit), "
-				  "key old_tuple (id_job, "
-				  "id_assoc, time_submit), "
-				  "key rollup (time_eligible, time_end), "
-				  "key rollup2 (time_end, time_eligible), "
-				  "key nodes_alloc (nodes_alloc), "
-				  "key wckey (id_wckey), "
-				  "key qos (id_qos), "
-				  "key association (id_assoc), "
-				  "key array_job (id_array_job), "
-				  "key het_job (het_job_id), "
-				  "key reserv (id_resv), "
-				  "key sacct_def (id_user, time_start, "
-				  "time_end), "
-				  "key sacct_def2 (id_user, time_end, "
-				  "time_eligible), "
-				  "key env_hash_inx (env_hash_inx), "
-				  "key script_hash_inx (script_hash_inx), "
-				  "key archive_purge (time_end))")
-	    == SLURM_ERROR)
+	ending = xstrdup_printf(", primary key (job_db_inx%s), "
+				"unique index (id_job, time_submit), "
+				"key old_tuple (id_job, "
+				"id_assoc, time_submit), "
+				"key rollup (time_eligible, time_end), "
+				"key rollup2 (time_end, time_eligible), "
+				"key nodes_alloc (nodes_alloc), "
+				"key wckey (id_wckey), "
+				"key qos (id_qos), "
+				"key association (id_assoc), "
+				"key array_job (id_array_job), "
+				"key het_job (het_job_id), "
+				"key reserv (id_resv), "
+				"key sacct_def (id_user, time_start, "
+				"time_end), "
+				"key sacct_def2 (id_user, time_end, "
+				"time_eligible), "
+				"key env_hash_inx (env_hash_inx), "
+				"key script_hash_inx (script_hash_inx), "
+				"key archive_purge (time_end))",
+				as_mysql_job_partitions ? ", time_submit" : "");
+	rc = mysql_db_create_table(mysql_conn, table_name, job_table_fields,
+				   ending);
+	xfree(ending);
+	if (rc == SLURM_ERROR)
 		return SLURM_ERROR;
 
 	snprintf(table_name, sizeof(table_name), "\"%s_%s\"",
@@ -1622,12 +1639,14 @@ extern int create_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
 
 	snprintf(table_name, sizeof(table_name), "\"%s_%s\"",
 		 cluster_name, step_table);
-	if (mysql_db_create_table(mysql_conn, table_name,
-				  step_table_fields,
-				  ", primary key (job_db_inx, id_step, "
-				  "step_het_comp), "
-				  "key archive_purge (time_end))")
-	    == SLURM_ERROR)
+	ending = xstrdup_printf(", primary key (job_db_inx, id_step, "
+				"step_het_comp%s), "
+				"key archive_purge (time_end))",
+				as_mysql_job_partitions ? ", time_start" : "");
+	rc = mysql_db_create_table(mysql_conn, table_name, step_table_fields,
+				   ending);
+	xfree(ending);
+	if (rc == SLURM_ERROR)
 		return SLURM_ERROR;
 
 	snprintf(table_name, sizeof(table_name), "\"%s_%s\"",
@@ -1679,7 +1698,7 @@ extern int create_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
 	    == SLURM_ERROR)
 		return SLURM_ERROR;
 
-	return SLURM_SUCCESS;
+	return as_mysql_partition_tables(mysql_conn, cluster_name);
 }
 
 extern int remove_cluster_tables(mysql_conn_t *mysql_conn, char *cluster_name)
@@ -2853,6 +2872,7 @@ extern int init(void)
 {
 	int rc = SLURM_SUCCESS;
 	mysql_conn_t *mysql_conn = NULL;
+	char *temp_str;
 
 	if (slurmdbd_conf->dbd_backup) {
 		char node_name_short[128];
@@ -2870,6 +2890,9 @@ extern int init(void)
 	mysql_db_info = create_mysql_db_info(SLURM_MYSQL_PLUGIN_AS);
 	mysql_db_name = acct_get_db_name();
 
+	if ((temp_str = xstrcasestr(mysql_db_info->params, "JOB_PARTITIONS=")))
+		as_mysql_job_partitions = atoi(temp_str + 15);
+
 	debug2("mysql_connect() called for db %s", mysql_db_name);
 	mysql_conn = create_mysql_conn(0, 1, NULL);
 	while (mysql_db_get_db_connection(
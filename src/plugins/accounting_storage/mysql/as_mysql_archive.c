@@ -42,6 +42,7 @@
 #include <unistd.h>
 
 #include "as_mysql_archive.h"
+#include "as_mysql_partition.h"
 #include "src/common/env.h"
 #include "src/common/slurm_time.h"
 #include "src/common/slurmdbd_defs.h"
@@ -69,6 +70,9 @@
 
 #define MAX_PURGE_LIMIT 50000 /* Number of records that are purged at a time
 				 so that locks can be periodically released. */
+#define MAX_PURGE_ONLY_LIMIT 5000 /* Same as MAX_PURGE_LIMIT when nothing is
+				     archived, smaller transactions keep the
+				     row locks short for live inserts. */
 #define MAX_ARCHIVE_AGE (60 * 60 * 24 * 60) /* If archive data is older than
 					       this then archive by month to
 					       handle large datasets. */
@@ -5094,6 +5098,7 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 	char    *query = NULL, *sql_table = NULL,
 		*col_name = NULL;
 	uint32_t tmp_archive_period;
+	int purge_limit;
 
 	switch (purge_type) {
 	case PURGE_EVENT:
@@ -5206,6 +5211,26 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 		return SLURM_ERROR;
 	}
 
+	/*
+	 * When archiving, each delete must match the rows just archived by
+	 * _archive_table(), which uses MAX_PURGE_LIMIT.
+	 */
+	if (SLURMDB_PURGE_ARCHIVE_SET(purge_attr))
+		purge_limit = MAX_PURGE_LIMIT;
+	else
+		purge_limit = MAX_PURGE_ONLY_LIMIT;
+
+	/*
+	 * When only purging, drop the partitions holding nothing but purgeable
+	 * records first, leaving just the rest of the period to be deleted row
+	 * by row.
+	 */
+	if (!SLURMDB_PURGE_ARCHIVE_SET(purge_attr) &&
+	    ((purge_type == PURGE_JOB) || (purge_type == PURGE_STEP)) &&
+	    (as_mysql_partition_purge(mysql_conn, cluster_name, sql_table,
+				      curr_end) == SLURM_ERROR))
+		return SLURM_ERROR;
+
 	/* continue archive/purge until no records in the period are found */
 	while (1) {
 		rc = _get_oldest_record(mysql_conn, cluster_name, sql_table,
@@ -5279,7 +5304,7 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				"delete from \"%s\" where "
 				"%s <= %ld && cluster='%s' order by %s asc LIMIT %d",
 				sql_table, col_name, tmp_end, cluster_name,
-				col_name, MAX_PURGE_LIMIT);
+				col_name, purge_limit);
 			break;
 		case PURGE_USAGE:
 		case PURGE_CLUSTER_USAGE:
@@ -5287,32 +5312,42 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				"delete from \"%s_%s\" where "
 				"%s <= %ld order by %s asc LIMIT %d",
 				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
+				tmp_end, col_name, purge_limit);
 			break;
 		default:
 			query = xstrdup_printf(
 				"delete from \"%s_%s\" where "
 				"%s <= %ld && time_end != 0 order by %s asc LIMIT %d",
 				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
+				tmp_end, col_name, purge_limit);
 			break;
 		}
 		DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
 
 		/*
-		 * Don't loop this query, just do it once, since we are only
-		 * archiving and purging MAX_PURGE_LIMIT rows at a time.
+		 * When archiving don't loop this query, just do it once, since
+		 * we are only archiving and purging MAX_PURGE_LIMIT rows at a
+		 * time. Otherwise keep deleting purge_limit rows at a time until
+		 * the period is empty, without looking for the oldest record
+		 * again in between.
 		 * mysql_db_delete_affected_rows will return < 0 on failure or
 		 * 0 if no records are affected.
 		 */
-		if ((rc = mysql_db_delete_affected_rows(
+		while ((rc = mysql_db_delete_affected_rows(
 				mysql_conn, query)) > 0) {
+			bool last = (rc < purge_limit) ||
+				SLURMDB_PURGE_ARCHIVE_SET(purge_attr);
+
 			/* Commit here every time since this could create a huge
 			 * transaction.
 			 */
-			if ((rc = mysql_db_commit(mysql_conn)))
+			if ((rc = mysql_db_commit(mysql_conn))) {
 				error("Couldn't commit cluster (%s) purge",
 				      cluster_name);
+				break;
+			}
+			if (last)
+				break;
 		}
 
 		xfree(query);
@@ -5327,6 +5362,13 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 		}
 	}
 
+	/* Archived records were deleted, drop the partitions left empty */
+	if (SLURMDB_PURGE_ARCHIVE_SET(purge_attr) &&
+	    ((purge_type == PURGE_JOB) || (purge_type == PURGE_STEP)) &&
+	    (as_mysql_partition_purge(mysql_conn, cluster_name, sql_table,
+				      curr_end) == SLURM_ERROR))
+		return SLURM_ERROR;
+
 	return SLURM_SUCCESS;
 }
 
@@ -63,6 +63,10 @@ typedef struct {
 	int my_left; /* 2 versions after 23.11 */
 	char *old_parent; /* 2 versions after 23.11 */
 	char *old_cluster; /* 2 versions after 23.11 */
+	char *par_limits_acct;
+	char *par_limits_cluster;
+	MYSQL_RES *par_limits_result;
+	MYSQL_ROW par_limits_row;
 	int rc;
 	char *ret_str;
 	char *ret_str_pos;
@@ -755,9 +759,26 @@ static int _set_assoc_lft_rgt(
 	return rc;
 }
 
-static int _set_assoc_limits_for_add(
-	mysql_conn_t *mysql_conn, slurmdb_assoc_rec_t *assoc)
+static void _clear_parent_limits(add_assoc_cond_t *add_assoc_cond)
+{
+	if (add_assoc_cond->par_limits_result)
+		mysql_free_result(add_assoc_cond->par_limits_result);
+	add_assoc_cond->par_limits_result = NULL;
+	add_assoc_cond->par_limits_row = NULL;
+	xfree(add_assoc_cond->par_limits_acct);
+	xfree(add_assoc_cond->par_limits_cluster);
+}
+
+/*
+ * The parent limits of the last parent looked up are kept in add_assoc_cond
+ * so adding many users under the same account only has to call
+ * get_parent_limits once.  Adding an account association clears them since
+ * it could change the limits inherited by anything below it.
+ */
+static int _set_assoc_limits_for_add(add_assoc_cond_t *add_assoc_cond,
+				     slurmdb_assoc_rec_t *assoc)
 {
+	mysql_conn_t *mysql_conn = add_assoc_cond->mysql_conn;
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	char *query = NULL;
@@ -774,18 +795,32 @@ static int _set_assoc_limits_for_add(
 	else
 		return SLURM_SUCCESS;
 
-	query = xstrdup_printf("call get_parent_limits('%s', "
-			       "'%s', '%s', %u);",
-			       assoc_table, parent, assoc->cluster, 0);
-	debug4("%d(%s:%d) query\n%s",
-	       mysql_conn->conn, THIS_FILE, __LINE__, query);
-	if (!(result = mysql_db_query_ret(mysql_conn, query, 1))) {
+	if (!assoc->user ||
+	    xstrcmp(parent, add_assoc_cond->par_limits_acct) ||
+	    xstrcmp(assoc->cluster, add_assoc_cond->par_limits_cluster)) {
+		_clear_parent_limits(add_assoc_cond);
+
+		query = xstrdup_printf("call get_parent_limits('%s', "
+				       "'%s', '%s', %u);",
+				       assoc_table, parent, assoc->cluster, 0);
+		debug4("%d(%s:%d) query\n%s",
+		       mysql_conn->conn, THIS_FILE, __LINE__, query);
+		if (!(result = mysql_db_query_ret(mysql_conn, query, 1))) {
+			xfree(query);
+			return SLURM_ERROR;
+		}
 		xfree(query);
-		return SLURM_ERROR;
+
+		add_assoc_cond->par_limits_result = result;
+		add_assoc_cond->par_limits_row = mysql_fetch_row(result);
+		if (assoc->user) {
+			add_assoc_cond->par_limits_acct = xstrdup(parent);
+			add_assoc_cond->par_limits_cluster =
+				xstrdup(assoc->cluster);
+		}
 	}
-	xfree(query);
 
-	if (!(row = mysql_fetch_row(result)))
+	if (!(row = add_assoc_cond->par_limits_row))
 		goto end_it;
 
 	if (row[ASSOC2_REQ_DEF_QOS] && assoc->def_qos_id == INFINITE)
@@ -863,7 +898,8 @@ static int _set_assoc_limits_for_add(
 	}
 
 end_it:
-	mysql_free_result(result);
+	if (!add_assoc_cond->par_limits_acct)
+		_clear_parent_limits(add_assoc_cond);
 
 	return SLURM_SUCCESS;
 }
@@ -3191,7 +3227,7 @@ static int _add_assoc_internal(add_assoc_cond_t *add_assoc_cond)
 	add_assoc_cond->flags |= ADD_ASSOC_FLAG_ADDED;
 
 	if (!add_assoc_cond->moved_parent) {
-		_set_assoc_limits_for_add(mysql_conn, assoc);
+		_set_assoc_limits_for_add(add_assoc_cond, assoc);
 		if ((add_assoc_cond->rpc_version <
 		     SLURM_23_11_PROTOCOL_VERSION) &&
 		    (assoc->lft == NO_VAL))
@@ -4009,6 +4045,7 @@ end_it:
 	xfree(add_assoc_cond.extra);
 	xfree(add_assoc_cond.old_parent);
 	xfree(add_assoc_cond.old_cluster);
+	_clear_parent_limits(&add_assoc_cond);
 	xfree(add_assoc_cond.ret_str);
 	xfree(add_assoc_cond.txn_query);
 	xfree(add_assoc_cond.user_name);
@@ -4123,6 +4160,7 @@ extern char *as_mysql_add_assocs_cond(mysql_conn_t *mysql_conn, uint32_t uid,
 				&add_assoc_cond);
 	assoc_mgr_unlock(&locks);
 
+	_clear_parent_limits(&add_assoc_cond);
 	xfree(add_assoc_cond.cols);
 	xfree(add_assoc_cond.extra);
 	FREE_NULL_LIST(add_assoc_cond.coord_users);
@@ -103,7 +103,7 @@ static int _first_job_roll_up(mysql_conn_t *mysql_conn, time_t first_start)
 extern int as_mysql_fix_runaway_jobs(mysql_conn_t *mysql_conn, uint32_t uid,
 				     List runaway_jobs)
 {
-	char *query = NULL, *job_ids = NULL;
+	char *query = NULL, *job_ids = NULL, *job_ids_pos = NULL;
 	slurmdb_job_rec_t *job = NULL;
 	list_itr_t *iter = NULL;
 	int rc = SLURM_SUCCESS;
@@ -165,7 +165,8 @@ extern int as_mysql_fix_runaway_jobs(mysql_conn_t *mysql_conn, uint32_t uid,
 			goto bail;
 		}
 
-		xstrfmtcat(job_ids, "%s%d", ((job_ids) ? "," : ""), job->jobid);
+		xstrfmtcatat(job_ids, &job_ids_pos, "%s%d",
+			     ((job_ids) ? "," : ""), job->jobid);
 	}
 	list_iterator_destroy(iter);
 
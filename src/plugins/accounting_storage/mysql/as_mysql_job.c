@@ -98,32 +98,44 @@ static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 static uint64_t _get_db_index(mysql_conn_t *mysql_conn,
 			      time_t submit, uint32_t jobid)
 {
-	MYSQL_RES *result = NULL;
-	MYSQL_ROW row;
+	MYSQL_STMT *stmt;
+	MYSQL_BIND params[2], results[1];
+	int submit_int = (int) submit;
 	uint64_t db_index = 0;
+	/*
+	 * This runs for every step and job update whose job start wasn't
+	 * processed yet, use a prepared statement to skip the query parsing.
+	 */
 	char *query = xstrdup_printf("select job_db_inx from \"%s_%s\" where "
-				     "time_submit=%d and id_job=%u",
-				     mysql_conn->cluster_name, job_table,
-				     (int)submit, jobid);
-
-	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
-		xfree(query);
-		return 0;
-	}
+				     "time_submit=? and id_job=?",
+				     mysql_conn->cluster_name, job_table);
+
+	memset(params, 0, sizeof(params));
+	params[0].buffer_type = MYSQL_TYPE_LONG;
+	params[0].buffer = &submit_int;
+	params[1].buffer_type = MYSQL_TYPE_LONG;
+	params[1].buffer = &jobid;
+	params[1].is_unsigned = true;
+
+	memset(results, 0, sizeof(results));
+	results[0].buffer_type = MYSQL_TYPE_LONGLONG;
+	results[0].buffer = &db_index;
+	results[0].is_unsigned = true;
+
+	stmt = mysql_db_stmt_execute(mysql_conn, query, params, results);
 	xfree(query);
+	if (!stmt)
+		return 0;
 
-	row = mysql_fetch_row(result);
-	if (!row) {
-		mysql_free_result(result);
+	if (mysql_stmt_fetch(stmt)) {
+		db_index = 0;
 		debug4("We can't get a db_index for this combo, "
 		       "time_submit=%d and id_job=%u.  "
 		       "We must not have heard about the start yet, "
 		       "no big deal, we will get one right after this.",
 		       (int)submit, jobid);
-		return 0;
 	}
-	db_index = slurm_atoull(row[0]);
-	mysql_free_result(result);
+	mysql_stmt_free_result(stmt);
 
 	return db_index;
 }
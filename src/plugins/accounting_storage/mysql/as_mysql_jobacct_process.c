@@ -42,6 +42,7 @@
 \*****************************************************************************/
 
 #include "as_mysql_jobacct_process.h"
+#include "as_mysql_partition.h"
 
 typedef struct {
 	hostlist_t *hl;
@@ -1699,6 +1700,22 @@ extern int setup_job_cond_limits(slurmdb_job_cond_t *job_cond,
 		}
 	}
 
+	/*
+	 * No job in the time window was submitted after its end. Saying so
+	 * lets MySQL skip the later partitions of the job table.
+	 */
+	if (as_mysql_job_partitions && job_cond->usage_end &&
+	    ((job_cond->state_list && list_count(job_cond->state_list)) ||
+	     !job_cond->step_list || !list_count(job_cond->step_list) ||
+	     !(job_cond->flags & JOBCOND_FLAG_NO_DEFAULT_USAGE))) {
+		if (*extra)
+			xstrcat(*extra, " && ");
+		else
+			xstrcat(*extra, " where ");
+		xstrfmtcat(*extra, "(t1.time_submit <= %ld)",
+			   job_cond->usage_end);
+	}
+
 	if (job_cond->wckey_list && list_count(job_cond->wckey_list)) {
 		set = 0;
 		if (*extra)
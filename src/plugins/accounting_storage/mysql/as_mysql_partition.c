@@ -0,0 +1,373 @@
+/*****************************************************************************\
+ *  as_mysql_partition.c - time partitioning of the job and step tables.
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "as_mysql_partition.h"
+#include "src/common/slurm_time.h"
+
+/*
+ * The job table is partitioned on time_submit, which is part of its unique
+ * index already, and the step table on time_start. Each partition holds one
+ * month and the last one, PARTITION_FUTURE, catches anything past the
+ * months created ahead of time. It is kept empty so adding months to the
+ * end of the table never has to move records around.
+ */
+#define PARTITION_FUTURE "pfuture"
+
+typedef struct {
+	char *name;
+	time_t end; /* 0 for the MAXVALUE partition */
+} partition_t;
+
+uint32_t as_mysql_job_partitions = 0;
+
+static void _destroy_partition(void *object)
+{
+	partition_t *part = object;
+
+	if (part) {
+		xfree(part->name);
+		xfree(part);
+	}
+}
+
+static char *_partition_col(char *table)
+{
+	if (!xstrcmp(table, job_table))
+		return "time_submit";
+	return "time_start";
+}
+
+static time_t _month_start(time_t when, int months)
+{
+	struct tm parts;
+
+	localtime_r(&when, &parts);
+	parts.tm_sec = 0;
+	parts.tm_min = 0;
+	parts.tm_hour = 0;
+	parts.tm_mday = 1;
+	parts.tm_mon += months;
+
+	return slurm_mktime(&parts);
+}
+
+static void _add_month_partitions(char **query, time_t start, time_t end)
+{
+	struct tm parts;
+	time_t next;
+
+	for (; start < end; start = next) {
+		next = _month_start(start, 1);
+		localtime_r(&start, &parts);
+		xstrfmtcat(*query, "partition p%04d%02d values less than (%ld), ",
+			   parts.tm_year + 1900, parts.tm_mon + 1, next);
+	}
+}
+
+/*
+ * Get the partitions of a table in order. The list is left empty when the
+ * table isn't partitioned.
+ */
+static int _get_partitions(mysql_conn_t *mysql_conn, char *cluster_name,
+			   char *table, List *part_list)
+{
+	MYSQL_RES *result = NULL;
+	MYSQL_ROW row;
+	char *query;
+
+	query = xstrdup_printf("select partition_name, partition_description "
+			       "from information_schema.partitions where "
+			       "table_schema=database() && "
+			       "table_name='%s_%s' && "
+			       "partition_name is not null "
+			       "order by partition_ordinal_position",
+			       cluster_name, table);
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+		xfree(query);
+		return SLURM_ERROR;
+	}
+	xfree(query);
+
+	*part_list = list_create(_destroy_partition);
+	while ((row = mysql_fetch_row(result))) {
+		partition_t *part = xmalloc(sizeof(*part));
+
+		part->name = xstrdup(row[0]);
+		if (row[1] && xstrcasecmp(row[1], "MAXVALUE"))
+			part->end = slurm_atoul(row[1]);
+		list_append(*part_list, part);
+	}
+	mysql_free_result(result);
+
+	return SLURM_SUCCESS;
+}
+
+/* Partition a table that isn't yet, from its oldest record to end */
+static int _partition_table(mysql_conn_t *mysql_conn, char *cluster_name,
+			    char *table, time_t end)
+{
+	MYSQL_RES *result = NULL;
+	MYSQL_ROW row;
+	char *query, *col = _partition_col(table);
+	time_t first = time(NULL);
+	int rc;
+
+	query = xstrdup_printf("select min(%s) from \"%s_%s\" where %s > 0",
+			       col, cluster_name, table, col);
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+		xfree(query);
+		return SLURM_ERROR;
+	}
+	xfree(query);
+	if ((row = mysql_fetch_row(result)) && row[0])
+		first = MIN(first, slurm_atoul(row[0]));
+	mysql_free_result(result);
+
+	info("Partitioning table %s_%s by month of %s, this could take a while",
+	     cluster_name, table, col);
+
+	query = xstrdup_printf("alter table \"%s_%s\" partition by range (%s) (",
+			       cluster_name, table, col);
+	_add_month_partitions(&query, _month_start(first, 0), end);
+	xstrcat(query, "partition " PARTITION_FUTURE
+		" values less than maxvalue)");
+
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+	rc = mysql_db_query(mysql_conn, query);
+	xfree(query);
+	if (rc != SLURM_SUCCESS)
+		error("Couldn't partition table %s_%s", cluster_name, table);
+
+	return rc;
+}
+
+/* Add the partitions of the months up to end */
+static int _extend_partitions(mysql_conn_t *mysql_conn, char *cluster_name,
+			      char *table, List part_list, time_t end)
+{
+	list_itr_t *itr;
+	partition_t *part, *future = NULL;
+	time_t last_end = 0;
+	char *query;
+	int rc;
+
+	itr = list_iterator_create(part_list);
+	while ((part = list_next(itr))) {
+		if (!part->end)
+			future = part;
+		else if (part->end > last_end)
+			last_end = part->end;
+	}
+	list_iterator_destroy(itr);
+
+	if (last_end >= end)
+		return SLURM_SUCCESS;
+	else if (!last_end)
+		last_end = time(NULL);
+
+	/*
+	 * The MAXVALUE partition is empty unless the months ahead ran out, so
+	 * splitting it is cheap.
+	 */
+	if (future)
+		query = xstrdup_printf("alter table \"%s_%s\" reorganize "
+				       "partition %s into (",
+				       cluster_name, table, future->name);
+	else
+		query = xstrdup_printf("alter table \"%s_%s\" add partition (",
+				       cluster_name, table);
+
+	_add_month_partitions(&query, _month_start(last_end, 0), end);
+
+	if (future)
+		xstrfmtcat(query, "partition %s values less than maxvalue)",
+			   future->name);
+	else /* remove the trailing ", " */
+		query[strlen(query) - 2] = ')';
+
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+	rc = mysql_db_query(mysql_conn, query);
+	xfree(query);
+	if (rc != SLURM_SUCCESS)
+		error("Couldn't add partitions to table %s_%s",
+		      cluster_name, table);
+
+	return rc;
+}
+
+static int _check_partitions(mysql_conn_t *mysql_conn, char *cluster_name,
+			     char *table, time_t end)
+{
+	List part_list = NULL;
+	int rc;
+
+	if ((rc = _get_partitions(mysql_conn, cluster_name, table,
+				  &part_list)) != SLURM_SUCCESS)
+		return rc;
+
+	if (!list_count(part_list))
+		rc = _partition_table(mysql_conn, cluster_name, table, end);
+	else
+		rc = _extend_partitions(mysql_conn, cluster_name, table,
+					part_list, end);
+	FREE_NULL_LIST(part_list);
+
+	return rc;
+}
+
+extern int as_mysql_partition_tables(mysql_conn_t *mysql_conn,
+				     char *cluster_name)
+{
+	time_t end;
+
+	if (!as_mysql_job_partitions)
+		return SLURM_SUCCESS;
+
+	end = _month_start(time(NULL), as_mysql_job_partitions + 1);
+
+	if (_check_partitions(mysql_conn, cluster_name, job_table, end) ||
+	    _check_partitions(mysql_conn, cluster_name, step_table, end))
+		return SLURM_ERROR;
+
+	return SLURM_SUCCESS;
+}
+
+extern int as_mysql_partition_remove(mysql_conn_t *mysql_conn,
+				     char *cluster_name, char *table)
+{
+	List part_list = NULL;
+	char *query;
+	int rc;
+
+	if ((rc = _get_partitions(mysql_conn, cluster_name, table,
+				  &part_list)) != SLURM_SUCCESS)
+		return rc;
+
+	if (!list_count(part_list)) {
+		FREE_NULL_LIST(part_list);
+		return SLURM_SUCCESS;
+	}
+	FREE_NULL_LIST(part_list);
+
+	info("Removing partitioning of table %s_%s, this could take a while",
+	     cluster_name, table);
+
+	query = xstrdup_printf("alter table \"%s_%s\" remove partitioning",
+			       cluster_name, table);
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+	rc = mysql_db_query(mysql_conn, query);
+	xfree(query);
+	if (rc != SLURM_SUCCESS)
+		error("Couldn't remove partitioning of table %s_%s",
+		      cluster_name, table);
+
+	return rc;
+}
+
+extern int as_mysql_partition_purge(mysql_conn_t *mysql_conn,
+				    char *cluster_name, char *table,
+				    time_t purge_end)
+{
+	MYSQL_RES *result = NULL;
+	List part_list = NULL;
+	list_itr_t *itr;
+	partition_t *part;
+	char *query;
+	int dropped = 0, rc = SLURM_SUCCESS;
+
+	if (!as_mysql_job_partitions)
+		return 0;
+
+	if (_get_partitions(mysql_conn, cluster_name, table, &part_list))
+		return SLURM_ERROR;
+
+	itr = list_iterator_create(part_list);
+	while ((part = list_next(itr))) {
+		bool busy;
+
+		/* Later partitions hold records that can't be purged yet */
+		if (!part->end || (part->end > (purge_end + 1)))
+			break;
+
+		/*
+		 * A record still running or ending after purge_end keeps the
+		 * partition around, the regular purge takes care of the rest
+		 * of it.
+		 */
+		query = xstrdup_printf("select 1 from \"%s_%s\" partition (%s) "
+				       "where time_end = 0 || time_end > %ld "
+				       "limit 1",
+				       cluster_name, table, part->name,
+				       purge_end);
+		DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+		if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+			xfree(query);
+			rc = SLURM_ERROR;
+			break;
+		}
+		xfree(query);
+		busy = mysql_num_rows(result);
+		mysql_free_result(result);
+
+		if (busy) {
+			log_flag(DB_ARCHIVE, "Keeping partition %s of %s_%s, it has records newer than %ld",
+				 part->name, cluster_name, table, purge_end);
+			continue;
+		}
+
+		query = xstrdup_printf("alter table \"%s_%s\" drop partition %s",
+				       cluster_name, table, part->name);
+		DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+		rc = mysql_db_query(mysql_conn, query);
+		xfree(query);
+		if (rc != SLURM_SUCCESS) {
+			error("Couldn't drop partition %s of table %s_%s",
+			      part->name, cluster_name, table);
+			break;
+		}
+		log_flag(DB_ARCHIVE, "Dropped partition %s of %s_%s",
+			 part->name, cluster_name, table);
+		dropped++;
+	}
+	list_iterator_destroy(itr);
+	FREE_NULL_LIST(part_list);
+
+	if (rc != SLURM_SUCCESS)
+		return SLURM_ERROR;
+
+	return dropped;
+}
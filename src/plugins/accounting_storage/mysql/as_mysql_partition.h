@@ -0,0 +1,76 @@
+/*****************************************************************************\
+ *  as_mysql_partition.h - time partitioning of the job and step tables.
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _HAVE_MYSQL_PARTITION_H
+#define _HAVE_MYSQL_PARTITION_H
+
+#include "accounting_storage_mysql.h"
+
+/*
+ * Number of months of empty partitions kept ahead of now in the job and step
+ * tables, set with StorageParameters=JOB_PARTITIONS=<months>. 0 means the
+ * tables are not partitioned.
+ */
+extern uint32_t as_mysql_job_partitions;
+
+/*
+ * Partition the job and step tables of a cluster by month, or add the
+ * partitions of the coming months when they already are.
+ *
+ * RET SLURM_SUCCESS on success, SLURM_ERROR otherwise.
+ */
+extern int as_mysql_partition_tables(mysql_conn_t *mysql_conn,
+				     char *cluster_name);
+
+/*
+ * Turn a partitioned job or step table back into a single table.
+ * Nothing is done when the table isn't partitioned or doesn't exist.
+ *
+ * RET SLURM_SUCCESS on success, SLURM_ERROR otherwise.
+ */
+extern int as_mysql_partition_remove(mysql_conn_t *mysql_conn,
+				     char *cluster_name, char *table);
+
+/*
+ * Drop the partitions of a job or step table only holding records that ended
+ * before purge_end.
+ *
+ * RET number of partitions dropped, SLURM_ERROR on error.
+ */
+extern int as_mysql_partition_purge(mysql_conn_t *mysql_conn,
+				    char *cluster_name, char *table,
+				    time_t purge_end);
+
+#endif
@@ -42,6 +42,7 @@
 #include "as_mysql_archive.h"
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 
 enum {
 	TIME_ALLOC,
@@ -139,14 +140,34 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
+static void _id_usage_hash_id(void *item, const char **key, uint32_t *key_len)
 {
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
+	local_id_usage_t *loc = item;
 
-	if (loc->id == id)
-		return 1;
-	return 0;
+	*key = (const char *) &loc->id;
+	*key_len = sizeof(loc->id);
+}
+
+/*
+ * Find the usage record of an association or wckey in an hourly rollup, or
+ * add it to the list and the hash when it isn't tracked yet.
+ */
+static local_id_usage_t *_get_id_usage(List usage_list, xhash_t *usage_hash,
+				       int id, bool make_tres)
+{
+	local_id_usage_t *usage;
+
+	if ((usage = xhash_get(usage_hash, (const char *) &id, sizeof(id))))
+		return usage;
+
+	usage = xmalloc(sizeof(local_id_usage_t));
+	usage->id = id;
+	if (make_tres)
+		usage->loc_tres = list_create(_destroy_local_tres_usage);
+	list_append(usage_list, usage);
+	xhash_add(usage_hash, usage);
+
+	return usage;
 }
 
 static void _remove_job_tres_time_from_cluster(List c_tres, List j_tres,
@@ -734,10 +755,15 @@ static int _process_cluster_usage(mysql_conn_t *mysql_conn,
 	return rc;
 }
 
+/*
+ * Statements for every association or wckey go into the same query, so append
+ * at *pos rather than searching for the end of a query which can run to many
+ * megabytes.
+ */
 static void _create_id_usage_insert(char *cluster_name, int type,
 				    time_t curr_start, time_t now,
 				    local_id_usage_t *id_usage,
-				    char **query)
+				    char **query, char **pos)
 {
 	local_tres_usage_t *loc_tres;
 	list_itr_t *itr;
@@ -770,27 +796,27 @@ static void _create_id_usage_insert(char *cluster_name, int type,
 	itr = list_iterator_create(id_usage->loc_tres);
 	while ((loc_tres = list_next(itr))) {
 		if (!first) {
-			xstrfmtcat(*query,
-				   ", (%ld, %ld, %u, %ld, %u, %"PRIu64")",
-				   now, now,
-				   id_usage->id, curr_start, loc_tres->id,
-				   loc_tres->time_alloc);
+			xstrfmtcatat(*query, pos,
+				     ", (%ld, %ld, %u, %ld, %u, %"PRIu64")",
+				     now, now,
+				     id_usage->id, curr_start, loc_tres->id,
+				     loc_tres->time_alloc);
 		} else {
-			xstrfmtcat(*query,
-				   "insert into \"%s_%s\" "
-				   "(creation_time, mod_time, id, "
-				   "time_start, id_tres, alloc_secs) "
-				   "values (%ld, %ld, %u, %ld, %u, %"PRIu64")",
-				   cluster_name, table, now, now,
-				   id_usage->id, curr_start, loc_tres->id,
-				   loc_tres->time_alloc);
+			xstrfmtcatat(*query, pos,
+				     "insert into \"%s_%s\" "
+				     "(creation_time, mod_time, id, "
+				     "time_start, id_tres, alloc_secs) "
+				     "values (%ld, %ld, %u, %ld, %u, %"PRIu64")",
+				     cluster_name, table, now, now,
+				     id_usage->id, curr_start, loc_tres->id,
+				     loc_tres->time_alloc);
 			first = 0;
 		}
 	}
 	list_iterator_destroy(itr);
-	xstrfmtcat(*query,
-		   " on duplicate key update mod_time=%ld, "
-		   "alloc_secs=VALUES(alloc_secs);", now);
+	xstrfmtcatat(*query, pos,
+		     " on duplicate key update mod_time=%ld, "
+		     "alloc_secs=VALUES(alloc_secs);", now);
 }
 
 static int _add_resv_usage_to_cluster(void *object, void *arg)
@@ -1259,7 +1285,7 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	time_t now = time(NULL);
 	time_t curr_start = start;
 	time_t curr_end = curr_start + add_sec;
-	char *query = NULL;
+	char *query = NULL, *query_pos = NULL;
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	list_itr_t *a_itr = NULL;
@@ -1270,6 +1296,13 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	List cluster_down_list = list_create(_destroy_local_cluster_usage);
 	List wckey_usage_list = list_create(_destroy_local_id_usage);
 	List resv_usage_list = list_create(_destroy_local_resv_usage);
+	/*
+	 * Index the usage records by id, the lists own them. Hours with many
+	 * associations and wckeys would otherwise scan the lists for every
+	 * job.
+	 */
+	xhash_t *assoc_usage_hash = xhash_init(_id_usage_hash_id, NULL);
+	xhash_t *wckey_usage_hash = xhash_init(_id_usage_hash_id, NULL);
 	uint16_t track_wckey = slurm_get_track_wckey();
 	local_cluster_usage_t *loc_c_usage = NULL;
 	local_cluster_usage_t *c_usage = NULL;
@@ -1485,13 +1518,13 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			}
 
 			if (last_id != assoc_id) {
-				a_usage = xmalloc(sizeof(local_id_usage_t));
-				a_usage->id = assoc_id;
-				list_append(assoc_usage_list, a_usage);
-				last_id = assoc_id;
 				/* a_usage->loc_tres is made later,
 				   don't do it here.
 				*/
+				a_usage = _get_id_usage(assoc_usage_list,
+							assoc_usage_hash,
+							assoc_id, false);
+				last_id = assoc_id;
 			}
 
 			/* Short circuit this so so we don't get a pointer. */
@@ -1500,20 +1533,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
-
-				if (!w_usage) {
-					w_usage = xmalloc(
-						sizeof(local_id_usage_t));
-					w_usage->id = wckey_id;
-					list_append(wckey_usage_list,
-						    w_usage);
-					w_usage->loc_tres = list_create(
-						_destroy_local_tres_usage);
-				}
+				w_usage = _get_id_usage(wckey_usage_list,
+							wckey_usage_hash,
+							wckey_id, true);
 				last_wckeyid = wckey_id;
 			}
 
@@ -1721,20 +1743,12 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				tmp_itr = list_iterator_create(
 					r_usage->local_assocs);
 				while ((assoc = list_next(tmp_itr))) {
-					uint32_t associd = slurm_atoul(assoc);
-					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
-						a_usage = xmalloc(
-							sizeof(local_id_usage_t));
-						a_usage->id = associd;
-						list_append(assoc_usage_list,
-							    a_usage);
-						a_usage->loc_tres = list_create(
-							_destroy_local_tres_usage);
-					}
+					int associd = slurm_atoul(assoc);
+					if (last_id != associd)
+						a_usage = _get_id_usage(
+							assoc_usage_list,
+							assoc_usage_hash,
+							associd, true);
 					last_id = associd;
 
 					_add_time_tres(a_usage->loc_tres,
@@ -1782,10 +1796,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		}
 
 		list_iterator_reset(a_itr);
+		query_pos = NULL;
 		while ((a_usage = list_next(a_itr)))
 			_create_id_usage_insert(cluster_name, ASSOC_TABLES,
 						curr_start, now,
-						a_usage, &query);
+						a_usage, &query, &query_pos);
 		if (query) {
 			DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s",
 			         query);
@@ -1801,10 +1816,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			goto end_loop;
 
 		list_iterator_reset(w_itr);
+		query_pos = NULL;
 		while ((w_usage = list_next(w_itr)))
 			_create_id_usage_insert(cluster_name, WCKEY_TABLES,
 						curr_start, now,
-						w_usage, &query);
+						w_usage, &query, &query_pos);
 		if (query) {
 			DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s",
 			         query);
@@ -1824,6 +1840,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		a_usage     = NULL;
 		w_usage     = NULL;
 
+		xhash_clear(assoc_usage_hash);
+		xhash_clear(wckey_usage_hash);
 		list_flush(assoc_usage_list);
 		list_flush(cluster_down_list);
 		list_flush(wckey_usage_list);
@@ -1846,6 +1864,8 @@ end_it:
 	if (r_itr)
 		list_iterator_destroy(r_itr);
 
+	xhash_free(assoc_usage_hash);
+	xhash_free(wckey_usage_hash);
 	FREE_NULL_LIST(assoc_usage_list);
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(wckey_usage_list);
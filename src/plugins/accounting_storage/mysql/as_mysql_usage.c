@@ -37,6 +37,7 @@
 \*****************************************************************************/
 
 #include "as_mysql_cluster.h"
+#include "as_mysql_partition.h"
 #include "as_mysql_usage.h"
 #include "as_mysql_rollup.h"
 #include "src/common/macros.h"
@@ -388,6 +389,14 @@ end_it:
 			error("Couldn't commit rollup of cluster %s",
 			      local_rollup->cluster_name);
 			rc = SLURM_ERROR;
+		} else if (as_mysql_job_partitions) {
+			/*
+			 * Keep the months ahead partitioned. This is done
+			 * after the commit as altering a table commits on its
+			 * own, and a failure here doesn't undo the rollup.
+			 */
+			(void) as_mysql_partition_tables(
+				&mysql_conn, local_rollup->cluster_name);
 		}
 	} else {
 		error("Cluster %s rollup failed", local_rollup->cluster_name);
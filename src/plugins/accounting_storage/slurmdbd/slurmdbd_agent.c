@@ -55,18 +55,30 @@ typedef struct {
 	list_t *my_list;
 } foreach_get_my_list_t;
 
+typedef struct {
+	int acked;
+	list_itr_t *itr;
+	int rc;
+} foreach_get_rc_t;
+
 persist_conn_t *slurmdbd_conn = NULL;
 
 
 #define DBD_MAGIC		0xDEAD3219
+#define DBD_STATE_WRITE_SIZE	(1024 * 1024)
 #define DEBUG_PRINT_MAX_MSG_TYPES 10
 #define MAX_DBD_DEFAULT_ACTION MAX_DBD_ACTION_DISCARD
+#define MAX_DBD_BATCH_RPCS	1000
+/* Max number of DBD_SEND_MULT_MSG batches sent before reading the replies */
+#define MAX_DBD_BATCHES_IN_FLIGHT 4
 
 static pthread_mutex_t agent_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
 static pthread_cond_t shutdown_cond = PTHREAD_COND_INITIALIZER;
 static List      agent_list     = (List) NULL;
 static pthread_t agent_tid      = 0;
+/* Messages at the head of agent_list sent but not yet acknowledged */
+static int       agent_in_flight = 0;
 
 static bool      halt_agent          = 0;
 static time_t    slurmdbd_shutdown   = 0;
@@ -162,15 +174,17 @@ static int _get_return_code(void)
 static int _get_return_codes(void *x, void *arg)
 {
 	buf_t *out_buf = x;
-	int *rc_ptr = arg;
+	foreach_get_rc_t *args = arg;
 	buf_t *b;
 
-	if ((*rc_ptr = _unpack_return_code(slurmdbd_conn->version, out_buf)) !=
-	    SLURM_SUCCESS)
+	if ((args->rc = _unpack_return_code(slurmdbd_conn->version, out_buf))
+	    != SLURM_SUCCESS)
 		return -1;
 
-	if ((b = list_dequeue(agent_list))) {
+	if ((b = list_next(args->itr))) {
+		(void) list_remove(args->itr);
 		FREE_NULL_BUFFER(b);
+		args->acked++;
 	} else {
 		error("DBD_GOT_MULT_MSG unpack message error");
 	}
@@ -178,7 +192,15 @@ static int _get_return_codes(void *x, void *arg)
 	return 0;
 }
 
-static int _handle_mult_rc_ret(void)
+/*
+ * Read the reply to a DBD_SEND_MULT_MSG and remove the acknowledged messages
+ * from agent_list. The batch starts after the first "skip" messages of the
+ * list, which are left from earlier batches that failed.
+ * OUT acked - number of messages acknowledged
+ * OUT got_reply - false if no reply could be read, the connection was then
+ *		    abandoned and no other reply should be expected on it
+ */
+static int _handle_mult_rc_ret(int skip, int *acked, bool *got_reply)
 {
 	buf_t *buffer;
 	uint16_t msg_type;
@@ -186,8 +208,9 @@ static int _handle_mult_rc_ret(void)
 	dbd_list_msg_t *list_msg = NULL;
 	int rc = SLURM_ERROR;
 
+	*acked = 0;
 	buffer = slurm_persist_recv_msg(slurmdbd_conn);
-	if (buffer == NULL)
+	if (!(*got_reply = (buffer != NULL)))
 		return rc;
 
 	safe_unpack16(&msg_type, buffer);
@@ -203,8 +226,18 @@ static int _handle_mult_rc_ret(void)
 
 		slurm_mutex_lock(&agent_lock);
 		if (agent_list) {
+			foreach_get_rc_t args = {
+				.itr = list_iterator_create(agent_list),
+				.rc = SLURM_ERROR,
+			};
+
+			for (int i = 0; (i < skip) && list_next(args.itr); i++)
+				;
 			list_for_each(list_msg->my_list, _get_return_codes,
-				      &rc);
+				      &args);
+			list_iterator_destroy(args.itr);
+			rc = args.rc;
+			*acked = args.acked;
 		}
 		slurm_mutex_unlock(&agent_lock);
 		slurmdbd_free_list_msg(list_msg);
@@ -254,59 +287,52 @@ unpack_error:
 /****************************************************************************
  * Functions for agent to manage queue of pending message for the Slurm DBD
  ****************************************************************************/
-static buf_t *_load_dbd_rec(int fd)
+/*
+ * Copy the next saved message out of the mmap()'d state file. Records are a
+ * native uint32_t size, the packed message and DBD_MAGIC.
+ * RET the message or NULL at the end of the file or on error
+ */
+static buf_t *_load_dbd_rec(buf_t *file)
 {
-	ssize_t size, rd_size;
 	uint32_t msg_size, magic;
-	char *msg;
+	char *data = get_buf_data(file) + get_buf_offset(file);
+	uint32_t remaining = remaining_buf(file);
 	buf_t *buffer;
 
-	size = sizeof(msg_size);
-	rd_size = read(fd, &msg_size, size);
-	if (rd_size == 0)
+	if (!remaining)
 		return NULL;
-	if (rd_size != size) {
-		error("state recover error: %m");
+	if (remaining < sizeof(msg_size)) {
+		error("state recover error, truncated record");
 		return NULL;
 	}
+	memcpy(&msg_size, data, sizeof(msg_size));
 	if (msg_size > MAX_BUF_SIZE) {
 		error("state recover error, msg_size=%u", msg_size);
 		return NULL;
 	}
-
-	buffer = init_buf((int) msg_size);
-	set_buf_offset(buffer, msg_size);
-	msg = get_buf_data(buffer);
-	size = msg_size;
-	while (size) {
-		rd_size = read(fd, msg, size);
-		if ((rd_size > 0) && (rd_size <= size)) {
-			msg += rd_size;
-			size -= rd_size;
-		} else if ((rd_size == -1) && (errno == EINTR))
-			continue;
-		else {
-			error("state recover error: %m");
-			FREE_NULL_BUFFER(buffer);
-			return NULL;
-		}
+	if ((remaining - sizeof(msg_size)) < (msg_size + sizeof(magic))) {
+		error("state recover error, truncated record");
+		return NULL;
 	}
-
-	size = sizeof(magic);
-	rd_size = read(fd, &magic, size);
-	if ((rd_size != size) || (magic != DBD_MAGIC)) {
+	memcpy(&magic, data + sizeof(msg_size) + msg_size, sizeof(magic));
+	if (magic != DBD_MAGIC) {
 		error("state recover error");
-		FREE_NULL_BUFFER(buffer);
 		return NULL;
 	}
 
+	buffer = init_buf(msg_size);
+	memcpy(get_buf_data(buffer), data + sizeof(msg_size), msg_size);
+	set_buf_offset(buffer, msg_size);
+	set_buf_offset(file, get_buf_offset(file) + sizeof(msg_size) +
+		       msg_size + sizeof(magic));
+
 	return buffer;
 }
 
 static void _load_dbd_state(void)
 {
 	char *dbd_fname = NULL;
-	buf_t *buffer;
+	buf_t *buffer, *file = NULL;
 	int fd, recovered = 0;
 	uint16_t rpc_version = 0;
 
@@ -323,7 +349,15 @@ static void _load_dbd_state(void)
 	} else {
 		char *ver_str = NULL;
 
-		buffer = _load_dbd_rec(fd);
+		/*
+		 * Map the file rather than reading it record by record, a
+		 * large backlog would otherwise take three read() calls for
+		 * each message.
+		 */
+		(void) close(fd);
+		if (!(file = create_mmap_buf(dbd_fname)))
+			goto end_it;
+		buffer = _load_dbd_rec(file);
 		if (buffer == NULL)
 			goto end_it;
 		/* This is set to the end of the buffer for send so we
@@ -346,7 +380,7 @@ static void _load_dbd_state(void)
 			   skip it.
 			*/
 			if (!buffer)
-				buffer = _load_dbd_rec(fd);
+				buffer = _load_dbd_rec(file);
 			if (buffer == NULL)
 				break;
 			if (rpc_version != SLURM_PROTOCOL_VERSION) {
@@ -377,45 +411,51 @@ static void _load_dbd_state(void)
 
 	end_it:
 		verbose("recovered %d pending RPCs", recovered);
-		(void) close(fd);
+		FREE_NULL_BUFFER(file);
 	}
 	xfree(dbd_fname);
 }
 
-static int _save_dbd_rec(int fd, buf_t *buffer)
+/* Write out the records gathered by _save_dbd_rec() */
+static int _flush_dbd_recs(int fd, buf_t *out)
+{
+	safe_write(fd, get_buf_data(out), get_buf_offset(out));
+	set_buf_offset(out, 0);
+
+	return SLURM_SUCCESS;
+
+rwfail:
+	error("state save error: %m");
+	return SLURM_ERROR;
+}
+
+/*
+ * Append a message to the state being saved, flushing it to the file in
+ * DBD_STATE_WRITE_SIZE blocks rather than writing every record piece by piece.
+ */
+static int _save_dbd_rec(int fd, buf_t *out, buf_t *buffer)
 {
-	ssize_t size, wrote;
 	uint32_t msg_size = get_buf_offset(buffer);
 	uint32_t magic = DBD_MAGIC;
-	char *msg = get_buf_data(buffer);
+	char *data;
 
-	size = sizeof(msg_size);
-	wrote = write(fd, &msg_size, size);
-	if (wrote != size) {
-		error("state save error: %m");
+	if (try_grow_buf_remaining(out, sizeof(msg_size) + msg_size +
+				   sizeof(magic))) {
+		error("state save error: message of %u bytes", msg_size);
 		return SLURM_ERROR;
 	}
 
-	wrote = 0;
-	while (wrote < msg_size) {
-		wrote = write(fd, msg, msg_size);
-		if (wrote > 0) {
-			msg += wrote;
-			msg_size -= wrote;
-		} else if ((wrote == -1) && (errno == EINTR))
-			continue;
-		else {
-			error("state save error: %m");
-			return SLURM_ERROR;
-		}
-	}
+	data = get_buf_data(out) + get_buf_offset(out);
+	memcpy(data, &msg_size, sizeof(msg_size));
+	data += sizeof(msg_size);
+	memcpy(data, get_buf_data(buffer), msg_size);
+	data += msg_size;
+	memcpy(data, &magic, sizeof(magic));
+	set_buf_offset(out, get_buf_offset(out) + sizeof(msg_size) + msg_size +
+		       sizeof(magic));
 
-	size = sizeof(magic);
-	wrote = write(fd, &magic, size);
-	if (wrote != size) {
-		error("state save error: %m");
-		return SLURM_ERROR;
-	}
+	if (get_buf_offset(out) >= DBD_STATE_WRITE_SIZE)
+		return _flush_dbd_recs(fd, out);
 
 	return SLURM_SUCCESS;
 }
@@ -423,7 +463,7 @@ static int _save_dbd_rec(int fd, buf_t *buffer)
 static void _save_dbd_state(void)
 {
 	char *dbd_fname = NULL;
-	buf_t *buffer;
+	buf_t *buffer, *out = NULL;
 	int fd, rc, wrote = 0;
 	uint16_t msg_type;
 	uint32_t offset;
@@ -437,9 +477,10 @@ static void _save_dbd_state(void)
 		char curr_ver_str[10];
 		snprintf(curr_ver_str, sizeof(curr_ver_str),
 			 "VER%d", SLURM_PROTOCOL_VERSION);
+		out = init_buf(DBD_STATE_WRITE_SIZE);
 		buffer = init_buf(strlen(curr_ver_str));
 		packstr(curr_ver_str, buffer);
-		rc = _save_dbd_rec(fd, buffer);
+		rc = _save_dbd_rec(fd, out, buffer);
 		FREE_NULL_BUFFER(buffer);
 		if (rc != SLURM_SUCCESS)
 			goto end_it;
@@ -464,15 +505,18 @@ static void _save_dbd_state(void)
 				continue;
 			}
 
-			rc = _save_dbd_rec(fd, buffer);
+			rc = _save_dbd_rec(fd, out, buffer);
 			FREE_NULL_BUFFER(buffer);
 			if (rc != SLURM_SUCCESS)
 				break;
 			wrote++;
 		}
+		if ((rc == SLURM_SUCCESS) && get_buf_offset(out))
+			rc = _flush_dbd_recs(fd, out);
 	}
 
 end_it:
+	FREE_NULL_BUFFER(out);
 	if (fd >= 0) {
 		verbose("saved %d pending RPCs", wrote);
 		rc = fsync_and_close(fd, "dbd.messages");
@@ -516,6 +560,26 @@ static int _purge_agent_list_req(void *x, void *arg)
 	return 0;
 }
 
+/* Purge queued records, except the ones sent and waiting for a reply */
+static int _purge_agent_list(uint16_t purge_type)
+{
+	list_itr_t *itr = list_iterator_create(agent_list);
+	int purged = 0;
+	buf_t *buffer;
+
+	for (int i = 0; (i < agent_in_flight) && list_next(itr); i++)
+		;
+	while ((buffer = list_next(itr))) {
+		if (_purge_agent_list_req(buffer, &purge_type)) {
+			list_delete_item(itr);
+			purged++;
+		}
+	}
+	list_iterator_destroy(itr);
+
+	return purged;
+}
+
 static void _max_dbd_msg_action(uint32_t *msg_cnt)
 {
 	int purged = 0;
@@ -530,16 +594,12 @@ static void _max_dbd_msg_action(uint32_t *msg_cnt)
 
 	/* MAX_DBD_ACTION_DISCARD */
 	if (*msg_cnt >= (slurm_conf.max_dbd_msgs - 1)) {
-		uint16_t purge_type = DBD_STEP_START;
-		purged = list_delete_all(agent_list, _purge_agent_list_req,
-					 &purge_type);
+		purged = _purge_agent_list(DBD_STEP_START);
 		*msg_cnt -= purged;
 		info("purge %d step records", purged);
 	}
 	if (*msg_cnt >= (slurm_conf.max_dbd_msgs - 1)) {
-		uint16_t purge_type = DBD_JOB_START;
-		purged = list_delete_all(agent_list, _purge_agent_list_req,
-					 &purge_type);
+		purged = _purge_agent_list(DBD_JOB_START);
 		*msg_cnt -= purged;
 		info("purge %d job start records", purged);
 	}
@@ -604,6 +664,102 @@ static int _get_my_list(void *x, void *arg)
 	return 0;
 }
 
+/*
+ * Pack a DBD_SEND_MULT_MSG with the queued messages following the first
+ * "skip" ones. Call with agent_lock held.
+ * OUT cnt - number of messages in the batch
+ * RET the packed batch or NULL when there is nothing more to send
+ */
+static buf_t *_pack_batch(int skip, int *cnt)
+{
+	persist_msg_t list_req = {
+		.conn = slurmdbd_conn,
+		.msg_type = DBD_SEND_MULT_MSG,
+	};
+	dbd_list_msg_t list_msg = {
+		.my_list = list_create(NULL),
+	};
+	foreach_get_my_list_t args = {
+		.msg_size = sizeof(list_req),
+		.my_list = list_msg.my_list,
+	};
+	list_itr_t *itr = list_iterator_create(agent_list);
+	buf_t *buffer;
+
+	for (int i = 0; (i < skip) && list_next(itr); i++)
+		;
+	while ((list_count(list_msg.my_list) < MAX_DBD_BATCH_RPCS) &&
+	       (buffer = list_next(itr)) && !_get_my_list(buffer, &args))
+		;
+	list_iterator_destroy(itr);
+
+	if ((*cnt = list_count(list_msg.my_list)) || !skip) {
+		list_req.data = &list_msg;
+		buffer = pack_slurmdbd_msg(&list_req, SLURM_PROTOCOL_VERSION);
+	} else {
+		buffer = NULL;
+	}
+	FREE_NULL_LIST(list_msg.my_list);
+
+	return buffer;
+}
+
+/*
+ * Send the queued messages as up to MAX_DBD_BATCHES_IN_FLIGHT batches before
+ * waiting for the replies, so the round trip to the slurmdbd is paid once for
+ * all of them. The slurmdbd processes the batches in order and replies in
+ * that same order. Call with slurmdbd_lock held so no other RPC is sent on the
+ * connection in between.
+ * RET SLURM_SUCCESS if all messages were acknowledged
+ */
+static int _send_batches(void)
+{
+	int batch_cnt[MAX_DBD_BATCHES_IN_FLIGHT];
+	int batches = 0, skip = 0, rc = SLURM_SUCCESS;
+	buf_t *buffer;
+
+	slurm_mutex_lock(&agent_lock);
+	while (agent_list && (batches < MAX_DBD_BATCHES_IN_FLIGHT) &&
+	       (buffer = _pack_batch(agent_in_flight, &batch_cnt[batches]))) {
+		agent_in_flight += batch_cnt[batches];
+		slurm_mutex_unlock(&agent_lock);
+
+		rc = slurm_persist_send_msg(slurmdbd_conn, buffer);
+		FREE_NULL_BUFFER(buffer);
+
+		slurm_mutex_lock(&agent_lock);
+		if (rc != SLURM_SUCCESS) {
+			if (!*slurmdbd_conn->shutdown)
+				error("Failure sending message: %d: %m", rc);
+			agent_in_flight -= batch_cnt[batches];
+			break;
+		}
+		batches++;
+	}
+	slurm_mutex_unlock(&agent_lock);
+
+	for (int i = 0; i < batches; i++) {
+		int acked = 0, batch_rc;
+		bool got_reply = false;
+
+		if ((batch_rc = _handle_mult_rc_ret(skip, &acked, &got_reply)))
+			rc = batch_rc;
+
+		slurm_mutex_lock(&agent_lock);
+		if (got_reply) {
+			agent_in_flight -= batch_cnt[i];
+			skip += batch_cnt[i] - acked;
+		} else {
+			/* Connection lost, the rest will be resent */
+			agent_in_flight = 0;
+			i = batches;
+		}
+		slurm_mutex_unlock(&agent_lock);
+	}
+
+	return rc;
+}
+
 static void *_agent(void *x)
 {
 	int rc;
@@ -611,22 +767,16 @@ static void *_agent(void *x)
 	buf_t *buffer;
 	struct timespec abs_time;
 	static time_t fail_time = 0;
-	persist_msg_t list_req = {0};
-	dbd_list_msg_t list_msg;
+	bool mult;
 	DEF_TIMERS;
 
 	slurm_mutex_lock(&agent_lock);
 	agent_running = true;
 	slurm_mutex_unlock(&agent_lock);
 
-	list_req.msg_type = DBD_SEND_MULT_MSG;
-	list_req.conn = slurmdbd_conn;
-	list_req.data = &list_msg;
-	memset(&list_msg, 0, sizeof(dbd_list_msg_t));
-
 	log_flag(DBD_AGENT, "slurmdbd agent_count=%d with msg_type=%s",
 		 list_count(agent_list),
-		 slurmdbd_msg_type_2_str(list_req.msg_type, 1));
+		 slurmdbd_msg_type_2_str(DBD_SEND_MULT_MSG, 1));
 
 	while (*slurmdbd_conn->shutdown == 0) {
 		slurm_mutex_lock(&slurmdbd_lock);
@@ -673,26 +823,13 @@ static void *_agent(void *x)
 		           (slurm_conf.debug_flags & DEBUG_FLAG_DBD_AGENT))
 			info("agent_count:%d", cnt);
 		/* Leave item on the queue until processing complete */
-		if (agent_list) {
-			if (cnt > 1) {
-				int max_rpcs = 1000;
-				foreach_get_my_list_t args = {
-					.msg_size = sizeof(list_req),
-					.my_list = list_create(NULL),
-				};
-
-				list_msg.my_list = args.my_list;
-
-				list_for_each_max(agent_list, &max_rpcs,
-						  _get_my_list, &args, 1, true);
-				buffer = pack_slurmdbd_msg(
-					&list_req, SLURM_PROTOCOL_VERSION);
-			} else
-				buffer = list_peek(agent_list);
-		} else
+		mult = (agent_list && (cnt > 1));
+		if (agent_list && !mult)
+			buffer = list_peek(agent_list);
+		else
 			buffer = NULL;
 		slurm_mutex_unlock(&agent_lock);
-		if (buffer == NULL) {
+		if (!mult && (buffer == NULL)) {
 			slurm_mutex_unlock(&slurmdbd_lock);
 
 			slurm_mutex_lock(&assoc_cache_mutex);
@@ -708,16 +845,21 @@ static void *_agent(void *x)
 		/* NOTE: agent_lock is clear here, so we can add more
 		 * requests to the queue while waiting for this RPC to
 		 * complete. */
-		rc = slurm_persist_send_msg(slurmdbd_conn, buffer);
-		if (rc != SLURM_SUCCESS) {
+		if (mult) {
+			rc = _send_batches();
+			if ((rc != SLURM_SUCCESS) && *slurmdbd_conn->shutdown) {
+				slurm_mutex_unlock(&slurmdbd_lock);
+				END_TIMER2("slurmdbd agent: shutdown");
+				break;
+			}
+		} else if ((rc = slurm_persist_send_msg(slurmdbd_conn, buffer))
+			   != SLURM_SUCCESS) {
 			if (*slurmdbd_conn->shutdown) {
 				slurm_mutex_unlock(&slurmdbd_lock);
 				END_TIMER2("slurmdbd agent: shutdown");
 				break;
 			}
 			error("Failure sending message: %d: %m", rc);
-		} else if (list_msg.my_list) {
-			rc = _handle_mult_rc_ret();
 		} else {
 			rc = _get_return_code();
 			if (rc == EAGAIN) {
@@ -740,28 +882,15 @@ static void *_agent(void *x)
 		slurm_mutex_lock(&agent_lock);
 		if (agent_list && (rc == SLURM_SUCCESS)) {
 			/*
-			 * If we sent a mult_msg we just need to free buffer,
-			 * we don't need to requeue, just mark list_msg.my_list
-			 * as NULL as that is the sign we sent a mult_msg.
+			 * The messages of a mult_msg were already removed from
+			 * the queue as they were acknowledged.
 			 */
-			if (list_msg.my_list) {
-				if (list_msg.my_list != agent_list)
-					FREE_NULL_LIST(list_msg.my_list);
-				list_msg.my_list = NULL;
-			} else
+			if (!mult) {
 				buffer = list_dequeue(agent_list);
-
-			FREE_NULL_BUFFER(buffer);
-			fail_time = 0;
-		} else {
-			/* We need to free a mult_msg even on failure */
-			if (list_msg.my_list) {
-				if (list_msg.my_list != agent_list)
-					FREE_NULL_LIST(list_msg.my_list);
-				list_msg.my_list = NULL;
 				FREE_NULL_BUFFER(buffer);
 			}
-
+			fail_time = 0;
+		} else {
 			fail_time = time(NULL);
 
 			if (slurm_conf.debug_flags & DEBUG_FLAG_DBD_AGENT) {
@@ -48,6 +48,7 @@
 
 #define DEFAULT_GPU_TIMEOUT 10
 #define DEFAULT_GPU_FREQ 30
+#define SNAPSHOT_FILE "energy_gpu"
 
 /*
  * These are defined here so when we link with something other than
@@ -101,6 +102,7 @@ static uint16_t gpus_len = 0;
 static uint64_t *start_current_energies = NULL;
 
 static int dataset_id = -1; // id of the dataset for profile data
+static char *snapshot_file = NULL;
 
 static bool flag_energy_accounting_shutdown = false;
 static bool flag_thread_started = false;
@@ -259,6 +261,39 @@ static int _thread_update_node_energy(void)
 	return rc;
 }
 
+/*
+ * Path of the file where slurmd publishes the node readings for the stepds
+ */
+static char *_snapshot_file(void)
+{
+	if (!snapshot_file && conf && conf->spooldir)
+		xstrfmtcat(snapshot_file, "%s/%s", conf->spooldir,
+			   SNAPSHOT_FILE);
+
+	return snapshot_file;
+}
+
+/*
+ * Publish the readings the gpu thread just took so the stepds can skip the
+ * energy RPC. Must be called with gpu_mutex held.
+ */
+static void _write_snapshot(void)
+{
+	acct_gather_energy_t *energies;
+
+	if (!gpus_len)
+		return;
+
+	energies = acct_gather_energy_alloc(gpus_len);
+	for (uint16_t i = 0; i < gpus_len; i++)
+		memcpy(&energies[i], &gpus[i].energy,
+		       sizeof(acct_gather_energy_t));
+	acct_gather_energy_write_snapshot(_snapshot_file(),
+					  gpus[gpus_len - 1].last_update_time,
+					  gpus_len, energies);
+	acct_gather_energy_destroy(energies);
+}
+
 /*
  * _thread_init initializes values and conf for the gpu thread
  */
@@ -319,6 +354,7 @@ static void *_thread_gpu_run(void *no_data)
 	slurm_mutex_lock(&gpu_mutex);
 	while (!flag_energy_accounting_shutdown) {
 		_thread_update_node_energy();
+		_write_snapshot();
 
 		/* Sleep until the next time. */
 		abs.tv_sec += DEFAULT_GPU_FREQ;
@@ -484,7 +520,13 @@ static int _get_joules_task(uint16_t delta)
 	if (!gres_get_gres_cnt())
 		return SLURM_SUCCESS;
 
-	if (slurm_get_node_energy(conf->node_name, context_id, delta, &gpu_cnt,
+	/*
+	 * Readings published by slurmd are as good as the RPC response if
+	 * they are newer than delta, and avoid the round trip.
+	 */
+	if (acct_gather_energy_read_snapshot(_snapshot_file(), delta, &gpu_cnt,
+					     &energies) &&
+	    slurm_get_node_energy(conf->node_name, context_id, delta, &gpu_cnt,
 				  &energies)) {
 		if (errno == ESLURMD_TOO_MANY_RPCS)
 			log_flag(ENERGY, "energy RPC limit reached on slurmd, request dropped");
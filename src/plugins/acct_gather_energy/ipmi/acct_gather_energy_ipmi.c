@@ -90,6 +90,7 @@ slurmd_conf_t *conf = NULL;
 /* IPMI extended DCMI power modes will be identified by these invented ids. */
 #define DCMI_MODE 0xBEEF
 #define DCMI_ENH_MODE 0xBEAF
+#define SNAPSHOT_FILE "energy_ipmi"
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -140,6 +141,7 @@ static time_t last_update_time = 0;
 static time_t previous_update_time = 0;
 static stepd_step_rec_t *step = NULL;
 static int context_id = -1;
+static char *snapshot_file = NULL;
 
 /* array of struct to track the status of multiple sensors */
 typedef struct sensor_status {
@@ -700,6 +702,38 @@ static void _update_energy(acct_gather_energy_t *e, uint32_t last_update_watt,
 	e->poll_time = time(NULL);
 }
 
+/*
+ * Path of the file where slurmd publishes the node readings for the stepds
+ */
+static char *_snapshot_file(void)
+{
+	if (!snapshot_file && conf && conf->spooldir)
+		xstrfmtcat(snapshot_file, "%s/%s", conf->spooldir,
+			   SNAPSHOT_FILE);
+
+	return snapshot_file;
+}
+
+/*
+ * Publish the readings the ipmi thread just took so the stepds can skip the
+ * energy RPC. Must be called with ipmi_mutex held.
+ */
+static void _write_snapshot(void)
+{
+	acct_gather_energy_t *energies;
+
+	if (!sensors_len)
+		return;
+
+	energies = acct_gather_energy_alloc(sensors_len);
+	for (uint16_t i = 0; i < sensors_len; i++)
+		memcpy(&energies[i], &sensors[i].energy,
+		       sizeof(acct_gather_energy_t));
+	acct_gather_energy_write_snapshot(_snapshot_file(), last_update_time,
+					  sensors_len, energies);
+	acct_gather_energy_destroy(energies);
+}
+
 /*
  * _thread_update_node_energy calls _read_ipmi_values and updates all values
  * for node consumption
@@ -904,6 +938,7 @@ static void *_thread_ipmi_run(void *no_data)
 	slurm_mutex_lock(&ipmi_mutex);
 	while (!flag_energy_accounting_shutdown) {
 		_thread_update_node_energy(&ipmi_dcmi_ctx);
+		_write_snapshot();
 
 		/* Sleep until the next time. */
 		abs.tv_sec += slurm_ipmi_conf.freq;
@@ -970,7 +1005,13 @@ static int _get_joules_task(uint16_t delta)
 
 	xassert(context_id != -1);
 
-	if (slurm_get_node_energy(conf->node_name, context_id, delta,
+	/*
+	 * Readings published by slurmd are as good as the RPC response if
+	 * they are newer than delta, and avoid the round trip.
+	 */
+	if (acct_gather_energy_read_snapshot(_snapshot_file(), delta,
+					     &sensor_cnt, &energies) &&
+	    slurm_get_node_energy(conf->node_name, context_id, delta,
 				  &sensor_cnt, &energies)) {
 		if (errno == ESLURMD_TOO_MANY_RPCS)
 			log_flag(ENERGY, "energy RPC limit reached on slurmd, request dropped");
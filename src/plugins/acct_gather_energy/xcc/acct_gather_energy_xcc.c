@@ -88,6 +88,8 @@ slurmd_conf_t *conf = NULL;
 #define XCC_SD650_RESPONSE_LEN 16
 #define XCC_SD650V2_RESPONSE_LEN 40
 
+#define SNAPSHOT_FILE "energy_xcc"
+
 /*
  * These variables are required by the generic plugin interface.  If they
  * are not found in the plugin, the plugin loader will ignore it.
@@ -251,6 +253,7 @@ static pthread_t thread_ipmi_id_launcher = 0;
 static pthread_t thread_ipmi_id_run = 0;
 static stepd_step_rec_t *step = NULL;
 static int context_id = -1;
+static char *snapshot_file = NULL;
 
 static void _reset_slurm_ipmi_conf(slurm_ipmi_conf_t *slurm_ipmi_conf)
 {
@@ -654,6 +657,32 @@ static void _sd650v2_update_node_energy(xcc_raw_single_data_t *xcc_raw)
 		 xcc_energy.consumed_energy, elapsed, xcc_energy.ave_watts);
 }
 
+/*
+ * Path of the file where slurmd publishes the node readings for the stepds
+ */
+static char *_snapshot_file(void)
+{
+	if (!snapshot_file && conf && conf->spooldir)
+		xstrfmtcat(snapshot_file, "%s/%s", conf->spooldir,
+			   SNAPSHOT_FILE);
+
+	return snapshot_file;
+}
+
+/*
+ * Publish the reading the ipmi thread just took so the stepds can skip the
+ * energy RPC. Must be called with ipmi_mutex held.
+ */
+static void _write_snapshot(void)
+{
+	if (!xcc_energy.poll_time)
+		return;
+
+	acct_gather_energy_write_snapshot(_snapshot_file(),
+					  xcc_energy.poll_time, 1,
+					  &xcc_energy);
+}
+
 /*
  * _thread_update_node_energy calls _read_ipmi_values and updates all values
  * for node consumption.
@@ -782,6 +811,7 @@ static void *_thread_ipmi_run(void *no_data)
 	slurm_mutex_lock(&ipmi_mutex);
 	while (!flag_energy_accounting_shutdown) {
 		_thread_update_node_energy(&ipmi_ctx);
+		_write_snapshot();
 
 		/* Sleep until the next time. */
 		abs.tv_sec += slurm_ipmi_conf.freq;
@@ -845,9 +875,12 @@ static int _get_joules_task(uint16_t delta)
 
 	/*
 	 * 'delta' parameter means "use cache" if data is newer than delta
-	 * seconds ago, otherwise just inquiry ipmi again.
+	 * seconds ago, otherwise just inquiry ipmi again. Readings published
+	 * by slurmd avoid the round trip when they are recent enough.
 	 */
-	if (slurm_get_node_energy(conf->node_name, context_id, delta,
+	if (acct_gather_energy_read_snapshot(_snapshot_file(), delta,
+					     &sensor_cnt, &new) &&
+	    slurm_get_node_energy(conf->node_name, context_id, delta,
 				  &sensor_cnt, &new)) {
 		if (errno == ESLURMD_TOO_MANY_RPCS)
 			log_flag(ENERGY, "energy RPC limit reached on slurmd, request dropped");
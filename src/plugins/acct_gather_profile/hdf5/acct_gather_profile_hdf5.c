@@ -67,12 +67,17 @@
 #include "src/slurmd/common/privileges.h"
 #include "hdf5_api.h"
 
-#define HDF5_CHUNK_SIZE 10
-/* Compression level, a value of 0 through 9. Level 0 is faster but offers the
- * least compression; level 9 is slower but offers maximum compression.
- * A setting of -1 indicates that no compression is desired. */
+/* Number of records per chunk. Samples are appended one at a time and stay in
+ * the chunk cache until the chunk is full, so larger chunks mean far fewer
+ * chunks for sh5util to copy and index when merging node files. */
+#define HDF5_CHUNK_SIZE 256
+/* Compression level, a value of 0 through 9. Level 0 stores the data
+ * uncompressed through the deflate filter; level 9 is slower but offers
+ * maximum compression. A setting of -1 indicates that no compression is
+ * desired. Level 1 packs the mostly monotonic sample series well for little
+ * CPU per chunk. */
 /* TODO: Make this configurable with a parameter */
-#define HDF5_COMPRESS 0
+#define HDF5_COMPRESS 1
 
 /*
  * These variables are required by the generic plugin interface.  If they
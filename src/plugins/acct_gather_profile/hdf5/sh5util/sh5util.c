@@ -123,6 +123,9 @@ const char plugin_type[] = "";
 #define H5free_memory free
 #endif
 
+/* Number of records read from a table with each H5PTget_next() call */
+#define READ_BATCH_RECORDS 1024
+
 sh5util_opts_t params;
 
 typedef struct table {
@@ -922,50 +925,65 @@ static void _extract_totals(size_t nb_fields, size_t *offsets, hid_t *types,
                             hsize_t type_size, hid_t table_id,
                             table_t *table, FILE *output)
 {
-	hsize_t nrecords;
-	size_t i, j;
-	uint8_t *data;
+	hsize_t nrecords, cnt;
+	size_t i, j, k;
+	uint8_t *data, *last;
+	bool is_uint64[nb_fields], is_double[nb_fields];
 
 	/* allocate space for aggregate values: 4 values (min, max,
 	 * sum, avg) on 8 bytes (uint64_t/double) for each field */
 	uint64_t *agg_i;
 	double *agg_d;
 
-	data = xmalloc(type_size);
+	data = xmalloc(type_size * READ_BATCH_RECORDS);
+	last = data;
 	agg_i = xmalloc(nb_fields * 4 * sizeof(uint64_t));
 	agg_d = (double *)agg_i;
 	H5PTget_num_packets(table_id, &nrecords);
 
+	for (j = 0; j < nb_fields; ++j) {
+		is_uint64[j] = (H5Tequal(types[j], H5T_NATIVE_UINT64) > 0);
+		is_double[j] = (H5Tequal(types[j], H5T_NATIVE_DOUBLE) > 0);
+	}
+
 	/* compute min/max/sum */
-	for (i = 0; i < nrecords; ++i) {
-		H5PTget_next(table_id, 1, data);
-		for (j = 0; j < nb_fields; ++j) {
-			if (H5Tequal(types[j], H5T_NATIVE_UINT64)) {
-				uint64_t v = *(uint64_t *)(data + offsets[j]);
-				uint64_t *a = agg_i + j * 4;
-				if (i == 0 || v < a[0]) /* min */
-					a[0] = v;
-				if (v > a[1]) /* max */
-					a[1] = v;
-				a[2] += v; /* sum */
-			} else if (H5Tequal(types[j], H5T_NATIVE_DOUBLE)) {
-				double v = *(double *)(data + offsets[j]);
-				double *a = agg_d + j * 4;
-				if (i == 0 || v < a[0]) /* min */
-					a[0] = v;
-				if (v > a[1]) /* max */
-					a[1] = v;
-				a[2] += v; /* sum */
+	for (i = 0; i < nrecords; i += cnt) {
+		cnt = MIN(nrecords - i, READ_BATCH_RECORDS);
+		H5PTget_next(table_id, cnt, data);
+		for (k = 0; k < cnt; ++k) {
+			uint8_t *rec = data + (k * type_size);
+
+			for (j = 0; j < nb_fields; ++j) {
+				if (is_uint64[j]) {
+					uint64_t v = *(uint64_t *)
+						(rec + offsets[j]);
+					uint64_t *a = agg_i + j * 4;
+					if (i + k == 0 || v < a[0]) /* min */
+						a[0] = v;
+					if (v > a[1]) /* max */
+						a[1] = v;
+					a[2] += v; /* sum */
+				} else if (is_double[j]) {
+					double v = *(double *)
+						(rec + offsets[j]);
+					double *a = agg_d + j * 4;
+					if (i + k == 0 || v < a[0]) /* min */
+						a[0] = v;
+					if (v > a[1]) /* max */
+						a[1] = v;
+					a[2] += v; /* sum */
+				}
 			}
 		}
+		last = data + ((cnt - 1) * type_size);
 	}
 
 	/* compute avg */
 	if (nrecords) {
 		for (j = 0; j < nb_fields; ++j) {
-			if (H5Tequal(types[j], H5T_NATIVE_UINT64)) {
+			if (is_uint64[j]) {
 				agg_d[j*4+3] = (double)agg_i[j*4+2] / nrecords;
-			} else if (H5Tequal(types[j], H5T_NATIVE_DOUBLE)) {
+			} else if (is_double[j]) {
 				agg_d[j*4+3] = (double)agg_d[j*4+2] / nrecords;
 			}
 		}
@@ -978,17 +996,17 @@ static void _extract_totals(size_t nb_fields, size_t *offsets, hid_t *types,
 		fprintf(output, ",%s", table->name);
 
 	/* elapsed time (first field in the last record) */
-	fprintf(output, ",%"PRIu64, *(uint64_t *)data);
+	fprintf(output, ",%"PRIu64, *(uint64_t *)last);
 
 	/* aggregate values */
 	for (j = 0; j < nb_fields; ++j) {
-		if (H5Tequal(types[j], H5T_NATIVE_UINT64)) {
+		if (is_uint64[j]) {
 			fprintf(output, ",%"PRIu64",%"PRIu64",%"PRIu64",%lf",
 			        agg_i[j * 4 + 0],
 			        agg_i[j * 4 + 1],
 			        agg_i[j * 4 + 2],
 			        agg_d[j * 4 + 3]);
-		} else if (H5Tequal(types[j], H5T_NATIVE_DOUBLE)) {
+		} else if (is_double[j]) {
 			fprintf(output, ",%lf,%lf,%lf,%lf",
 			        agg_d[j * 4 + 0],
 			        agg_d[j * 4 + 1],
@@ -1088,31 +1106,50 @@ static int _extract_series_table(hid_t fid_job, table_t *table, List fields,
 		                table_id, table, output);
 	} else {
 		/* Timeseries level */
+		hsize_t cnt;
+		uint8_t *data;
+		int kinds[nb_fields];
+
+		for (j = 0; j < nb_fields; ++j) {
+			if (H5Tequal(types[j], H5T_NATIVE_UINT64) > 0)
+				kinds[j] = PROFILE_FIELD_UINT64;
+			else if (H5Tequal(types[j], H5T_NATIVE_DOUBLE) > 0)
+				kinds[j] = PROFILE_FIELD_DOUBLE;
+			else {
+				error("Unknown type");
+				goto error;
+			}
+		}
+
 		H5PTget_num_packets(table_id, &nrecords);
-		uint8_t data[type_size];
+		data = xmalloc(type_size * READ_BATCH_RECORDS);
 
 		/* print the expected fields of all the records */
-		for (i = 0; i < nrecords; ++i) {
-			H5PTget_next(table_id, 1, data);
-			fprintf(output, "%s,%s", table->step, table->node);
-			if (group_mode)
-				fprintf(output, ",%s", table->name);
-
-			for (j = 0; j < nb_fields; ++j) {
-				if (H5Tequal(types[j], H5T_NATIVE_UINT64)) {
-					fprintf(output, ",%"PRIu64,
-					        *(uint64_t *)(data+offsets[j]));
-				} else if (H5Tequal(types[j],
-				                    H5T_NATIVE_DOUBLE)) {
-					fprintf(output, ",%lf",
-					        *(double *)(data + offsets[j]));
-				} else {
-					error("Unknown type");
-					goto error;
+		for (i = 0; i < nrecords; i += cnt) {
+			cnt = MIN(nrecords - i, READ_BATCH_RECORDS);
+			H5PTget_next(table_id, cnt, data);
+			for (hsize_t k = 0; k < cnt; ++k) {
+				uint8_t *rec = data + (k * type_size);
+
+				fprintf(output, "%s,%s",
+					table->step, table->node);
+				if (group_mode)
+					fprintf(output, ",%s", table->name);
+
+				for (j = 0; j < nb_fields; ++j) {
+					if (kinds[j] == PROFILE_FIELD_UINT64)
+						fprintf(output, ",%"PRIu64,
+							*(uint64_t *)
+							(rec + offsets[j]));
+					else
+						fprintf(output, ",%lf",
+							*(double *)
+							(rec + offsets[j]));
 				}
+				fputc('\n', output);
 			}
-			fputc('\n', output);
 		}
+		xfree(data);
 	}
 
 	H5PTclose(table_id);
@@ -69,6 +69,14 @@
 #include "src/interfaces/proctrack.h"
 
 #define DEFAULT_INFLUXDB_TIMEOUT 10
+/* Seconds a partially filled buffer may wait before being sent */
+#define INFLUXDB_FLUSH_INTERVAL 30
+/* Seconds to wait before retrying a batch the server failed to accept */
+#define INFLUXDB_RETRY_DELAY 5
+/* Maximum bytes of data held for sending before the oldest is discarded */
+#define INFLUXDB_SPOOL_SIZE (64 * BUF_SIZE)
+/* Failed sends tolerated while flushing at step end before giving up */
+#define INFLUXDB_SHUTDOWN_FAILURES 2
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -134,6 +142,20 @@ static stepd_step_rec_t *g_job = NULL;
 static char *datastr = NULL;
 static int datastrlen = 0;
 
+/* Batches waiting for the sender thread, protected by send_mutex */
+static pthread_mutex_t send_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t send_cond = PTHREAD_COND_INITIALIZER;
+static list_t *send_list = NULL;
+static size_t send_list_bytes = 0;
+static pthread_t sender_tid;
+static bool sender_running = false;
+static bool sender_shutdown = false;
+static int spool_drop_cnt = 0;
+
+/* Only used by the sender thread */
+static CURL *curl_handle = NULL;
+static int error_cnt = 0;
+
 static table_t *tables = NULL;
 static size_t tables_max_len = 0;
 static size_t tables_cur_len = 0;
@@ -193,45 +215,32 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to send data to influxdb */
-static int _send_data(const char *data)
+static void _queue_batch(void);
+
+/* Try to send one batch of line protocol data to influxdb */
+static int _post_batch(const char *batch, bool *retry)
 {
-	CURL *curl_handle = NULL;
 	CURLcode res;
 	struct http_response chunk;
 	int rc = SLURM_SUCCESS;
 	long response_code;
-	static int error_cnt = 0;
 	char *url = NULL;
-	size_t length;
-
-	debug3("%s %s called", plugin_type, __func__);
-
-	/*
-	 * Every compute node which is sampling data will try to establish a
-	 * different connection to the influxdb server. In order to reduce the
-	 * number of connections, every time a new sampled data comes in, it
-	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
-	 * try to open the connection and send this buffer, instead of opening
-	 * one per sample.
-	 */
-	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
-		xstrcat(datastr, data);
-		length = strlen(data);
-		datastrlen += length;
-		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
-			 plugin_type, __func__, length, datastrlen);
-		return rc;
-	}
 
 	DEF_TIMERS;
 	START_TIMER;
 
-	if ((curl_handle = curl_easy_init()) == NULL) {
+	*retry = false;
+
+	/*
+	 * The handle is kept for the life of the sender thread so libcurl can
+	 * keep the connection to the influxdb server alive between batches.
+	 */
+	if (!curl_handle && !(curl_handle = curl_easy_init())) {
 		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+		*retry = true;
+		return SLURM_ERROR;
 	}
+	curl_easy_reset(curl_handle);
 
 	xstrfmtcat(url, "%s/write?db=%s&rp=%s&precision=s", influxdb_conf.host,
 		   influxdb_conf.database, influxdb_conf.rt_policy);
@@ -243,21 +252,24 @@ static int _send_data(const char *data)
 	if (influxdb_conf.password)
 		curl_easy_setopt(curl_handle, CURLOPT_PASSWORD,
 				 influxdb_conf.password);
-	curl_easy_setopt(curl_handle, CURLOPT_POST, 1);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, datastr);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, strlen(datastr));
+	curl_easy_setopt(curl_handle, CURLOPT_POST, 1L);
+	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, batch);
+	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, (long) strlen(batch));
 	if (influxdb_conf.username)
 		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
 				 influxdb_conf.username);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk);
-	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, influxdb_conf.timeout);
+	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT,
+			 (long) influxdb_conf.timeout);
+	curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
 
 	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
 		if ((error_cnt++ % 100) == 0)
-			error("%s %s: curl_easy_perform failed to send data (discarded). Reason: %s",
+			error("%s %s: curl_easy_perform failed to send data. Reason: %s",
 			      plugin_type, __func__, curl_easy_strerror(res));
 		rc = SLURM_ERROR;
+		*retry = true;
 		goto cleanup;
 	}
 
@@ -281,12 +293,15 @@ static int _send_data(const char *data)
 			error_cnt = 0;
 	} else {
 		rc = SLURM_ERROR;
+		/* Only a server side failure is worth retrying */
+		*retry = (response_code >= 500);
 		debug2("%s %s: data write failed, response code: %ld",
 		       plugin_type, __func__, response_code);
 		if (slurm_conf.debug_flags & DEBUG_FLAG_PROFILE) {
 			/* Strip any trailing newlines. */
-			while (chunk.message[strlen(chunk.message) - 1] == '\n')
-				chunk.message[strlen(chunk.message) - 1] = '\0';
+			while (chunk.size &&
+			       (chunk.message[chunk.size - 1] == '\n'))
+				chunk.message[--chunk.size] = '\0';
 			info("%s %s: JSON response body: %s", plugin_type,
 			     __func__, chunk.message);
 		}
@@ -295,22 +310,168 @@ static int _send_data(const char *data)
 cleanup:
 	xfree(chunk.message);
 	xfree(url);
-cleanup_easy_init:
-	curl_easy_cleanup(curl_handle);
 
 	END_TIMER;
 	log_flag(PROFILE, "%s %s: took %s to send data",
 		 plugin_type, __func__, TIME_STR);
 
+	return rc;
+}
+
+/*
+ * Send the queued batches, oldest first. A batch that fails to send for a
+ * reason worth retrying stays at the head of the queue and is retried
+ * after INFLUXDB_RETRY_DELAY seconds, so samples are not lost while the
+ * influxdb server is briefly unavailable. The queue is bounded by
+ * _queue_batch(). Partially filled buffers are sent at least every
+ * INFLUXDB_FLUSH_INTERVAL seconds.
+ */
+static void *_sender_thread(void *arg)
+{
+	struct timespec ts = { 0, 0 };
+	char *batch;
+	bool retry;
+	int rc, shutdown_failures = 0;
+
+	slurm_mutex_lock(&send_mutex);
+	while (true) {
+		if (!list_count(send_list)) {
+			if (sender_shutdown)
+				break;
+			ts.tv_sec = time(NULL) + INFLUXDB_FLUSH_INTERVAL;
+			slurm_cond_timedwait(&send_cond, &send_mutex, &ts);
+			if (!list_count(send_list))
+				_queue_batch();
+			continue;
+		}
+
+		batch = list_peek(send_list);
+		slurm_mutex_unlock(&send_mutex);
+		rc = _post_batch(batch, &retry);
+		slurm_mutex_lock(&send_mutex);
+
+		if (rc && retry && !sender_shutdown) {
+			ts.tv_sec = time(NULL) + INFLUXDB_RETRY_DELAY;
+			slurm_cond_timedwait(&send_cond, &send_mutex, &ts);
+			continue;
+		}
+
+		/*
+		 * Once the step ends every batch gets one more attempt, but do
+		 * not keep waiting on an endpoint that keeps failing.
+		 */
+		if (rc && retry &&
+		    (++shutdown_failures >= INFLUXDB_SHUTDOWN_FAILURES)) {
+			log_flag(PROFILE, "%s %s: discarding %zu bytes of queued data",
+				 plugin_type, __func__, send_list_bytes);
+			list_flush(send_list);
+			send_list_bytes = 0;
+			continue;
+		}
+
+		if (rc)
+			log_flag(PROFILE, "%s %s: discarding %zu bytes of data",
+				 plugin_type, __func__, strlen(batch));
+
+		batch = list_pop(send_list);
+		send_list_bytes -= strlen(batch);
+		xfree(batch);
+	}
+	slurm_mutex_unlock(&send_mutex);
+
+	if (curl_handle) {
+		curl_easy_cleanup(curl_handle);
+		curl_handle = NULL;
+	}
+
+	return NULL;
+}
+
+/*
+ * Hand the current buffer over to the sender thread.
+ * Caller must hold send_mutex.
+ */
+static void _queue_batch(void)
+{
+	if (!datastrlen)
+		return;
+
+	if (!sender_running) {
+		send_list = list_create(xfree_ptr);
+		slurm_thread_create(&sender_tid, _sender_thread, NULL);
+		sender_running = true;
+	}
+
+	/* Bound the data held back for retries, dropping the oldest */
+	while (list_count(send_list) &&
+	       ((send_list_bytes + datastrlen) > INFLUXDB_SPOOL_SIZE)) {
+		char *batch = list_pop(send_list);
+		size_t len = strlen(batch);
+
+		if ((spool_drop_cnt++ % 100) == 0)
+			error("%s %s: influxdb not keeping up, discarding %zu bytes of data",
+			      plugin_type, __func__, len);
+		send_list_bytes -= len;
+		xfree(batch);
+	}
+
+	list_append(send_list, datastr);
+	send_list_bytes += datastrlen;
+	datastr = NULL;
+	datastrlen = 0;
+	slurm_cond_signal(&send_cond);
+}
+
+/*
+ * Buffer data for influxdb, or queue the buffer to be sent if data is NULL
+ *
+ * Every compute node which is sampling data will try to establish a
+ * different connection to the influxdb server. In order to reduce the
+ * number of connections, every time a new sampled data comes in, it
+ * is saved in the 'datastr' buffer. Once this buffer is full, it is queued
+ * for the sender thread which sends it over a persistent connection, so
+ * slurmstepd never waits for the influxdb server.
+ */
+static void _send_data(const char *data)
+{
+	size_t length = data ? strlen(data) : 0;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	slurm_mutex_lock(&send_mutex);
+	if (!data || ((datastrlen + length) > BUF_SIZE))
+		_queue_batch();
+
 	if (data) {
-		datastr = xstrdup(data);
-		datastrlen = strlen(data);
-	} else {
-		datastr[0] = '\0';
-		datastrlen = 0;
+		xstrcat(datastr, data);
+		datastrlen += length;
+		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
+			 plugin_type, __func__, length, datastrlen);
 	}
+	slurm_mutex_unlock(&send_mutex);
+}
 
-	return rc;
+/* Send everything still buffered and stop the sender thread */
+static void _stop_sender(void)
+{
+	slurm_mutex_lock(&send_mutex);
+	_queue_batch();
+	if (!sender_running) {
+		slurm_mutex_unlock(&send_mutex);
+		return;
+	}
+	sender_shutdown = true;
+	slurm_cond_signal(&send_cond);
+	slurm_mutex_unlock(&send_mutex);
+
+	slurm_thread_join(sender_tid);
+
+	slurm_mutex_lock(&send_mutex);
+	FREE_NULL_LIST(send_list);
+	send_list_bytes = 0;
+	sender_running = false;
+	sender_shutdown = false;
+	slurm_mutex_unlock(&send_mutex);
 }
 
 /*
@@ -329,7 +490,6 @@ extern int init(void)
 		return SLURM_ERROR;
 	}
 
-	datastr = xmalloc(BUF_SIZE);
 	return SLURM_SUCCESS;
 }
 
@@ -337,6 +497,7 @@ extern int fini(void)
 {
 	debug3("%s %s called", plugin_type, __func__);
 
+	_stop_sender();
 	curl_global_cleanup();
 
 	_free_tables();
@@ -471,6 +632,8 @@ extern int acct_gather_profile_p_node_step_end(void)
 
 	xassert(running_in_slurmstepd());
 
+	_stop_sender();
+
 	return rc;
 }
 
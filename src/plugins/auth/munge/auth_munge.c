@@ -41,6 +41,7 @@
 
 #include <inttypes.h>
 #include <munge.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -97,6 +98,19 @@ const bool hash_enable = true;
 
 static int bad_cred_test = -1;
 
+/*
+ * Decode context kept per thread, so each credential verified does not
+ * create a MUNGE context and configure its socket from scratch.
+ */
+typedef struct {
+	munge_ctx_t ctx;
+	char *socket;
+} decode_ctx_t;
+
+static pthread_key_t decode_ctx_key;
+static pthread_once_t decode_ctx_once = PTHREAD_ONCE_INIT;
+static bool decode_ctx_key_created = false;
+
 /*
  * The Munge implementation of the slurm AUTH credential
  */
@@ -123,6 +137,60 @@ extern void auth_p_destroy(auth_credential_t *cred);
 static int _decode_cred(auth_credential_t *c, char *socket, bool test);
 static void _print_cred(munge_ctx_t ctx);
 
+static void _decode_ctx_destroy(void *arg)
+{
+	decode_ctx_t *dctx = arg;
+
+	munge_ctx_destroy(dctx->ctx);
+	xfree(dctx->socket);
+	xfree(dctx);
+}
+
+static void _decode_ctx_key_create(void)
+{
+	if (pthread_key_create(&decode_ctx_key, _decode_ctx_destroy))
+		fatal("%s: pthread_key_create failed: %m", __func__);
+	decode_ctx_key_created = true;
+}
+
+/*
+ * Return this thread's MUNGE context for decoding with the given socket,
+ * creating it if needed. NULL on failure.
+ */
+static munge_ctx_t _get_decode_ctx(char *socket)
+{
+	decode_ctx_t *dctx;
+
+	(void) pthread_once(&decode_ctx_once, _decode_ctx_key_create);
+
+	if ((dctx = pthread_getspecific(decode_ctx_key))) {
+		if (!xstrcmp(dctx->socket, socket))
+			return dctx->ctx;
+		(void) pthread_setspecific(decode_ctx_key, NULL);
+		_decode_ctx_destroy(dctx);
+	}
+
+	dctx = xmalloc(sizeof(*dctx));
+	if ((dctx->ctx = munge_ctx_create()) == NULL) {
+		error("munge_ctx_create failure");
+		xfree(dctx);
+		return NULL;
+	}
+	if (socket &&
+	    (munge_ctx_set(dctx->ctx, MUNGE_OPT_SOCKET, socket) !=
+	     EMUNGE_SUCCESS)) {
+		error("munge_ctx_set failure");
+		munge_ctx_destroy(dctx->ctx);
+		xfree(dctx);
+		return NULL;
+	}
+	dctx->socket = xstrdup(socket);
+	if (pthread_setspecific(decode_ctx_key, dctx))
+		fatal("%s: pthread_setspecific failed: %m", __func__);
+
+	return dctx->ctx;
+}
+
 /*
  *  Munge plugin initialization
  */
@@ -163,6 +231,17 @@ int init(void)
 
 extern int fini(void)
 {
+	/*
+	 * Contexts still held by other threads are leaked rather than leave
+	 * a destructor pointing into an unloaded plugin.
+	 */
+	if (decode_ctx_key_created) {
+		decode_ctx_t *dctx = pthread_getspecific(decode_ctx_key);
+
+		if (dctx)
+			_decode_ctx_destroy(dctx);
+		(void) pthread_key_delete(decode_ctx_key);
+	}
 	return SLURM_SUCCESS;
 }
 
@@ -513,16 +592,8 @@ static int _decode_cred(auth_credential_t *c, char *socket, bool test)
 	if (c->verified)
 		return SLURM_SUCCESS;
 
-	if ((ctx = munge_ctx_create()) == NULL) {
-		error("munge_ctx_create failure");
-		return SLURM_ERROR;
-	}
-	if (socket &&
-	    (munge_ctx_set(ctx, MUNGE_OPT_SOCKET, socket) != EMUNGE_SUCCESS)) {
-		error("munge_ctx_set failure");
-		munge_ctx_destroy(ctx);
+	if (!(ctx = _get_decode_ctx(socket)))
 		return SLURM_ERROR;
-	}
 
 again:
 	err = munge_decode(c->m_str, ctx, &c->data, &c->dlen, &c->uid, &c->gid);
@@ -578,7 +649,6 @@ again:
 		c->verified = true;
 
 done:
-	munge_ctx_destroy(ctx);
 	return err ? SLURM_ERROR : SLURM_SUCCESS;
 }
 
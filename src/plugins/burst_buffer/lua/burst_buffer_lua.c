@@ -82,6 +82,9 @@
  */
 #define MAX_BURST_BUFFERS_PER_STAGE 128
 
+/* Most idle Lua states kept for reuse by _start_lua_script() */
+#define MAX_IDLE_LUA_STATES 16
+
 /*
  * These variables are required by the burst buffer plugin interface.  If they
  * are not found in the plugin, the plugin loader will ignore it.
@@ -212,9 +215,18 @@ typedef struct {
 } bb_func_t;
 
 
+typedef struct {
+	lua_State *L;
+	time_t load_time;
+} lua_state_ent_t;
+
 static int lua_thread_cnt = 0;
 pthread_mutex_t lua_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* Loaded Lua states not currently running a function */
+static list_t *lua_state_pool = NULL;
+static pthread_mutex_t lua_state_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* Function prototypes */
 static bb_job_t *_get_bb_job(job_record_t *job_ptr);
 static void _queue_teardown(uint32_t job_id, uint32_t user_id, bool hurry,
@@ -223,6 +235,7 @@ static void _fail_stage(stage_args_t *stage_args, const char *op, int rc,
 			char *resp_msg);
 static void _init_data_in_argv(stage_args_t *stage_args, int *argc_p,
 			       char ***argv_p);
+static void _loadscript_extra(lua_State *st);
 
 static int _get_lua_thread_cnt(void)
 {
@@ -249,6 +262,64 @@ static void _decr_lua_thread_cnt(void)
 	slurm_mutex_unlock(&lua_thread_mutex);
 }
 
+static void _lua_state_ent_free(void *x)
+{
+	lua_state_ent_t *ent = x;
+
+	if (!ent)
+		return;
+	if (ent->L)
+		lua_close(ent->L);
+	xfree(ent);
+}
+
+/*
+ * Get a Lua state with burst_buffer.lua loaded. An idle state is reused if
+ * one is available, and is reloaded first if the script has changed since it
+ * was loaded.
+ * RET state to pass to _put_lua_state(), or NULL on error
+ */
+static lua_state_ent_t *_get_lua_state(void)
+{
+	lua_state_ent_t *ent = NULL;
+
+	slurm_mutex_lock(&lua_state_mutex);
+	if (lua_state_pool)
+		ent = list_pop(lua_state_pool);
+	slurm_mutex_unlock(&lua_state_mutex);
+
+	if (!ent)
+		ent = xmalloc(sizeof(*ent));
+
+	if (slurm_lua_loadscript(&ent->L, "burst_buffer/lua",
+				 lua_script_path, req_fxns,
+				 &ent->load_time, _loadscript_extra) ||
+	    !ent->L) {
+		_lua_state_ent_free(ent);
+		return NULL;
+	}
+
+	return ent;
+}
+
+/*
+ * Return a Lua state from _get_lua_state() for reuse.
+ * IN reuse - false to discard the state instead, e.g. after an error left it
+ *	in an unknown condition
+ */
+static void _put_lua_state(lua_state_ent_t *ent, bool reuse)
+{
+	slurm_mutex_lock(&lua_state_mutex);
+	if (reuse && lua_state_pool &&
+	    (list_count(lua_state_pool) < MAX_IDLE_LUA_STATES)) {
+		list_push(lua_state_pool, ent);
+		ent = NULL;
+	}
+	slurm_mutex_unlock(&lua_state_mutex);
+
+	_lua_state_ent_free(ent);
+}
+
 static int _job_info_to_string(lua_State *L)
 {
 	job_info_t *job_info;
@@ -825,26 +896,19 @@ static int _start_lua_script(const char *func, uint32_t job_id, uint32_t argc,
 			     char **resp_msg)
 {
 	/*
-	 * We don't make lua_State L or lua_script_last_loaded static.
-	 * If they were static, then only 1 thread could use them at a time.
-	 * This would be problematic for performance since these
-	 * calls can possibly last a long time. By not making them static it
-	 * means we can let these calls run in parallel, but it also means
-	 * we don't preserve the previous script. Therefore, we have to
-	 * reload the script every time even if the script hasn't changed.
-	 * Also, if there is ever a problem loading the script then we can't
-	 * fall back to the old script.
+	 * These calls can last a long time, so rather than sharing one
+	 * lua_State each call takes its own from a pool. States are kept
+	 * loaded between calls so the script is only read and compiled again
+	 * when it changes, and a broken update falls back to the old script.
 	 */
-	lua_State *L = NULL;
-	time_t lua_script_last_loaded = (time_t) 0;
+	lua_state_ent_t *ent;
+	lua_State *L;
+	bool reuse = true;
 	int rc, i;
 
-	rc = slurm_lua_loadscript(&L, "burst_buffer/lua",
-				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
-
-	if (rc != SLURM_SUCCESS)
-		return rc;
+	if (!(ent = _get_lua_state()))
+		return SLURM_ERROR;
+	L = ent->L;
 
 	/*
 	 * All lua script functions should have been verified during
@@ -854,7 +918,7 @@ static int _start_lua_script(const char *func, uint32_t job_id, uint32_t argc,
 	if (lua_isnil(L, -1)) {
 		error("%s: Couldn't find function %s",
 		      __func__, func);
-		lua_close(L);
+		_put_lua_state(ent, false);
 		return SLURM_ERROR;
 	}
 
@@ -873,12 +937,13 @@ static int _start_lua_script(const char *func, uint32_t job_id, uint32_t argc,
 		error("%s: %s", lua_script_path, lua_tostring(L, -1));
 		rc = SLURM_ERROR;
 		lua_pop(L, lua_gettop(L));
+		reuse = false;
 	} else {
 		slurm_lua_stack_dump("burst_buffer/lua", "after lua_pcall, before returns have been popped", L);
 		rc = _handle_lua_return(L, func, job_id, resp_msg);
 	}
 	slurm_lua_stack_dump("burst_buffer/lua", "after lua_pcall, after returns have been popped", L);
-	lua_close(L);
+	_put_lua_state(ent, reuse);
 
 	return rc;
 }
@@ -2242,6 +2307,7 @@ extern int init(void)
         if ((rc = slurm_lua_init()) != SLURM_SUCCESS)
                 return rc;
 	lua_script_path = get_extra_conf_path("burst_buffer.lua");
+	lua_state_pool = list_create(_lua_state_ent_free);
 
 	if ((rc = serializer_g_init(MIME_TYPE_JSON_PLUGIN, NULL))) {
 		error("%s: unable to load JSON serializer: %s",
@@ -2319,6 +2385,11 @@ extern int fini(void)
 
 	slurm_mutex_destroy(&lua_thread_mutex);
 
+	/* Lua states must be closed before the Lua library is unloaded */
+	slurm_mutex_lock(&lua_state_mutex);
+	FREE_NULL_LIST(lua_state_pool);
+	slurm_mutex_unlock(&lua_state_mutex);
+
 	slurm_lua_fini();
 	xfree(lua_script_path);
 
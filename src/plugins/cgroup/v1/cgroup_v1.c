@@ -792,6 +792,18 @@ extern int cgroup_p_step_resume(void)
 				       "freezer.state", "THAWED");
 }
 
+/* cgroup v1 has no cgroup.kill, callers must signal each pid themselves */
+extern int cgroup_p_step_kill(void)
+{
+	return SLURM_ERROR;
+}
+
+/* cgroup v1 has no populated notification, callers must poll the pids */
+extern int cgroup_p_step_wait_empty(int timeout_ms)
+{
+	return SLURM_ERROR;
+}
+
 static int _step_destroy_internal(cgroup_ctl_type_t sub, bool root_locked)
 {
 	int rc = SLURM_SUCCESS;
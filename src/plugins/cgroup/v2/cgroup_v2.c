@@ -539,31 +539,50 @@ static int _find_pid_task(void *x, void *key)
 	return found;
 }
 
-static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+/* Return the "populated" value of cg's cgroup.events, or -1 on error. */
+static int _get_cgroup_populated(xcgroup_t *cg)
 {
-	char *cgroup_events = NULL, *events_content = NULL, *ptr;
-	int rc, fd, wd, populated = -1;
+	char *events_content = NULL, *ptr;
+	int populated = -1;
 	size_t sz;
-	struct pollfd pfd[1];
 
-	/* Check if cgroup is empty in the first place. */
 	if (common_cgroup_get_param(
 		    cg, "cgroup.events", &events_content, &sz) != SLURM_SUCCESS)
 		error("Cannot read %s/cgroup.events", cg->path);
 
 	if (events_content) {
 		if ((ptr = xstrstr(events_content, "populated"))) {
-			if (sscanf(ptr, "populated %u", &populated) != 1)
+			if (sscanf(ptr, "populated %d", &populated) != 1)
 				error("Cannot read populated counter from cgroup.events file.");
 		}
 		xfree(events_content);
 	}
 
-	if (populated < 0) {
+	if (populated < 0)
 		error("Cannot determine if %s is empty.", cg->path);
-		return;
-	} else if (populated == 0) //We're done
-		return;
+
+	return populated;
+}
+
+/*
+ * Wait up to timeout_ms for cg to have no processes left in its subtree.
+ *
+ * RET SLURM_SUCCESS if we were able to wait (the cgroup became empty or the
+ * timeout expired), SLURM_ERROR if the cgroup state cannot be monitored.
+ */
+static int _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+{
+	char *cgroup_events = NULL;
+	char ev_buf[sizeof(struct inotify_event) + NAME_MAX + 1];
+	int rc = SLURM_SUCCESS, fd, wd, populated, remaining;
+	struct pollfd pfd[1];
+	struct timeval start, now;
+
+	/* Check if cgroup is empty in the first place. */
+	if ((populated = _get_cgroup_populated(cg)) < 0)
+		return SLURM_ERROR;
+	else if (!populated) //We're done
+		return SLURM_SUCCESS;
 
 	/*
 	 * Cgroup is not empty, so wait for a while just monitoring any change
@@ -573,54 +592,66 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 	xstrfmtcat(cgroup_events, "%s/cgroup.events", cg->path);
 
 	/* Initialize an inotify monitor */
-	fd = inotify_init();
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 	if (fd < 0) {
 		error("Cannot initialize inotify for checking cgroup events: %m");
-		return;
+		xfree(cgroup_events);
+		return SLURM_ERROR;
 	}
 
 	/* Set the file and events we want to monitor. */
 	wd = inotify_add_watch(fd, cgroup_events, IN_MODIFY);
 	if (wd < 0) {
 		error("Cannot add watch events to %s: %m", cgroup_events);
+		rc = SLURM_ERROR;
 		goto end_inotify;
 	}
 
-	/* Wait for new events. */
+	/*
+	 * The file is also modified on other events (e.g. "frozen"), so keep
+	 * waiting until populated drops to 0 or we run out of time.
+	 */
+	gettimeofday(&start, NULL);
 	pfd[0].fd = fd;
 	pfd[0].events = POLLIN;
-	rc = poll(pfd, 1, timeout_ms);
+	while (true) {
+		/* Re-check in case we raced with the last process leaving. */
+		if ((populated = _get_cgroup_populated(cg)) <= 0)
+			break;
 
-	/*
-	 * We don't really care about the event details, just check now if the
-	 * cg event file contains what we're looking for.
-	 */
-	if (rc < 0)
-		error("Error polling for event in %s: %m", cgroup_events);
-	else if (rc == 0)
-		error("Timeout waiting for %s to become empty.", cgroup_events);
-
-	/* Check if cgroup is empty again. */
-	if (common_cgroup_get_param(cg, "cgroup.events",
-				    &events_content, &sz) != SLURM_SUCCESS)
-		error("Cannot read %s/cgroup.events", cg->path);
+		gettimeofday(&now, NULL);
+		remaining = timeout_ms -
+			(((now.tv_sec - start.tv_sec) * 1000) +
+			 ((now.tv_usec - start.tv_usec) / 1000));
+		if (remaining <= 0) {
+			log_flag(CGROUP, "Timeout waiting for %s to become empty.",
+				 cgroup_events);
+			break;
+		}
 
-	if (events_content) {
-		if ((ptr = xstrstr(events_content, "populated"))) {
-			if (sscanf(ptr, "populated %u", &populated) != 1)
-				error("Cannot read populated counter from cgroup.events file.");
+		if (poll(pfd, 1, remaining) < 0) {
+			if (errno == EINTR)
+				continue;
+			error("Error polling for event in %s: %m",
+			      cgroup_events);
+			break;
 		}
-		xfree(events_content);
+
+		/*
+		 * We don't really care about the event details, just drain
+		 * them so the next poll() blocks again.
+		 */
+		while (read(fd, ev_buf, sizeof(ev_buf)) > 0)
+			;
 	}
 
-	if (populated < 0)
-		error("Cannot determine if %s is empty.", cg->path);
-	else if (populated == 1)
+	if (populated == 1)
 		log_flag(CGROUP, "Cgroup %s is not empty.", cg->path);
 
 end_inotify:
 	close(fd);
 	xfree(cgroup_events);
+	return rc;
 }
 
 /*
@@ -1215,6 +1246,7 @@ extern int fini(void)
 	FREE_NULL_LIST(task_list);
 	free_ebpf_prog(&p[CG_LEVEL_JOB]);
 	free_ebpf_prog(&p[CG_LEVEL_STEP_USER]);
+	free_loaded_ebpf_progs();
 	xfree(stepd_scope_path);
 
 	debug("unloading %s", plugin_name);
@@ -1513,6 +1545,52 @@ extern int cgroup_p_step_resume(void)
 				       "cgroup.freeze", "0");
 }
 
+/*
+ * SIGKILL every user process of this step in one go. The kernel walks the
+ * subtree and also catches processes forked while the kill is in progress,
+ * which a pid by pid loop could never keep up with.
+ */
+extern int cgroup_p_step_kill(void)
+{
+	static int kill_avail = -1;
+	char *kill_path = NULL;
+	struct stat st;
+
+	/* This plugin is unloaded. */
+	if (!int_cg[CG_LEVEL_STEP_USER].path)
+		return SLURM_ERROR;
+
+	/* cgroup.kill was added in kernel 5.14 */
+	if (kill_avail == -1) {
+		xstrfmtcat(kill_path, "%s/cgroup.kill",
+			   int_cg[CG_LEVEL_STEP_USER].path);
+		kill_avail = (stat(kill_path, &st) == 0);
+		xfree(kill_path);
+	}
+	if (!kill_avail)
+		return SLURM_ERROR;
+
+	return common_cgroup_set_param(&int_cg[CG_LEVEL_STEP_USER],
+				       "cgroup.kill", "1");
+}
+
+/* Wait for the user processes of this step to be gone */
+extern int cgroup_p_step_wait_empty(int timeout_ms)
+{
+	/* This plugin is unloaded. */
+	if (!int_cg[CG_LEVEL_STEP_USER].path)
+		return SLURM_ERROR;
+
+	/*
+	 * Nothing to block on, whatever the caller still sees lives outside
+	 * of the user cgroup.
+	 */
+	if (_get_cgroup_populated(&int_cg[CG_LEVEL_STEP_USER]) != 1)
+		return SLURM_ERROR;
+
+	return _wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_USER], timeout_ms);
+}
+
 /*
  * Destroy the step cgroup. We need to move out ourselves to the root of
  * the cgroup filesystem first.
@@ -1565,7 +1643,7 @@ extern int cgroup_p_step_destroy(cgroup_ctl_type_t ctl)
 		goto end;
 	}
 	/* Wait for this cgroup to be empty, 1 second */
-	_wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_SLURM], 1000);
+	(void) _wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_SLURM], 1000);
 
 	/* Remove any possible task directories first */
 	_all_tasks_destroy();
@@ -34,8 +34,31 @@
 \*****************************************************************************/
 
 #define _GNU_SOURCE
+#include <pthread.h>
+
+#include "src/common/macros.h"
+#include "src/common/read_config.h"
+
 #include "ebpf.h"
 
+/*
+ * Programs loaded by this process, kept so that cgroups with the same device
+ * rules (typically every task of a step without per task GRES binding)
+ * attach the already loaded program. Every BPF_PROG_LOAD runs the kernel
+ * verifier, attaching a loaded program is cheap.
+ */
+#define EBPF_LOADED_MAX 64
+
+typedef struct {
+	size_t n_inst;
+	struct bpf_insn *program;
+	int fd;
+} ebpf_loaded_t;
+
+static pthread_mutex_t loaded_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ebpf_loaded_t loaded[EBPF_LOADED_MAX];
+static int loaded_cnt = 0;
+
 #define bpf(cmd, attr, size) (int) syscall(__NR_bpf, cmd, attr, size);
 
 /* Macros inspired from libcrun. */
@@ -223,6 +246,34 @@ extern void close_ebpf_prog(bpf_program_t *program, bool def_action)
 	program->program[program->n_inst++] = BPF_EXIT_INSN();
 }
 
+/* Call with loaded_mutex held. RET fd of the loaded program or -1 */
+static int _find_loaded_prog(bpf_program_t *program)
+{
+	for (int i = 0; i < loaded_cnt; i++) {
+		if ((loaded[i].n_inst == program->n_inst) &&
+		    !memcmp(loaded[i].program, program->program,
+			    (program->n_inst * sizeof(struct bpf_insn))))
+			return loaded[i].fd;
+	}
+
+	return -1;
+}
+
+/* Call with loaded_mutex held */
+static void _add_loaded_prog(bpf_program_t *program, int fd)
+{
+	size_t size = program->n_inst * sizeof(struct bpf_insn);
+
+	if (loaded_cnt >= EBPF_LOADED_MAX)
+		return;
+
+	loaded[loaded_cnt].n_inst = program->n_inst;
+	loaded[loaded_cnt].program = xmalloc(size);
+	memcpy(loaded[loaded_cnt].program, program->program, size);
+	loaded[loaded_cnt].fd = fd;
+	loaded_cnt++;
+}
+
 extern int load_ebpf_prog(bpf_program_t *program, const char cgroup_path[],
 			  bool override_flag)
 {
@@ -256,11 +307,21 @@ extern int load_ebpf_prog(bpf_program_t *program, const char cgroup_path[],
 	attr.log_buf = (size_t) NULL;
 	attr.log_size = 0;
 
-	/* Call the load syscall */
-	fd = bpf(BPF_PROG_LOAD, &attr, sizeof(attr));
+	/* Call the load syscall, unless this program is loaded already */
+	slurm_mutex_lock(&loaded_mutex);
+	if ((fd = _find_loaded_prog(program)) >= 0) {
+		log_flag(CGROUP, "EBPF reusing loaded bpf program for %s",
+			 cgroup_path);
+	} else {
+		fd = bpf(BPF_PROG_LOAD, &attr, sizeof(attr));
+		if (fd >= 0)
+			_add_loaded_prog(program, fd);
+	}
+	slurm_mutex_unlock(&loaded_mutex);
 	if (fd < 0) {
 		error("%s: BPF load error (%m). Please check your system limits (MEMLOCK).",
 		      __func__);
+		close(dirfd);
 		return SLURM_ERROR;
 	}
 
@@ -295,3 +356,15 @@ extern void free_ebpf_prog(bpf_program_t *program)
 {
 	xfree(program->program);
 }
+
+extern void free_loaded_ebpf_progs(void)
+{
+	slurm_mutex_lock(&loaded_mutex);
+	for (int i = 0; i < loaded_cnt; i++) {
+		/* Attached programs stay referenced by their cgroups */
+		(void) close(loaded[i].fd);
+		xfree(loaded[i].program);
+	}
+	loaded_cnt = 0;
+	slurm_mutex_unlock(&loaded_mutex);
+}
@@ -89,7 +89,9 @@ extern int add_device_ebpf_prog(bpf_program_t *program, uint32_t dev_type,
 extern void close_ebpf_prog(bpf_program_t *close_ebpf_prog, bool def_action);
 
 /*
- * load_ebpf_prog - Loads the program and attaches it to a cgroup.
+ * load_ebpf_prog - Loads the program and attaches it to a cgroup. A program
+ * identical to one loaded before by this process is attached without loading
+ * it again.
  * OUT program - Pointer to the bpf_program_t to be loaded
  * IN cgroup_path - Path to the cgroup the program needs to be attached to.
  * IN override_flag - true sets BPF_F_ALLOW_OVERRIDE flag to the program, this
@@ -106,4 +108,10 @@ extern int load_ebpf_prog(bpf_program_t *program, const char cgroup_path[],
  */
 extern void free_ebpf_prog(bpf_program_t *program);
 
+/*
+ * free_loaded_ebpf_progs - Close the programs kept by load_ebpf_prog() for
+ * reuse. Cgroups they are attached to keep them in place.
+ */
+extern void free_loaded_ebpf_progs(void);
+
 #endif
@@ -521,7 +521,7 @@ extern sbcast_cred_t *sbcast_cred_unpack(buf_t *buffer, uint32_t *siglen,
 					 uint16_t protocol_version)
 {
 	sbcast_cred_t *sbcast_cred = xmalloc(sizeof(*sbcast_cred));
-	uint32_t cred_start = get_buf_offset(buffer);
+	uint32_t cred_start = get_buf_offset(buffer), cred_len;
 
 	if (protocol_version >= SLURM_23_11_PROTOCOL_VERSION) {
 		if (unpack_identity(&sbcast_cred->arg.id, buffer,
@@ -573,17 +573,14 @@ extern sbcast_cred_t *sbcast_cred_unpack(buf_t *buffer, uint32_t *siglen,
 		goto unpack_error;
 
 	/*
-	 * Preserve a copy of the buffer in srun/sbcast to avoid needing to
-	 * repack it later.
+	 * Preserve a copy of the buffer to avoid needing to repack it later.
+	 * slurmd needs it too, to relay cached blocks to its peers.
 	 */
-	if (!running_in_slurmd()) {
-		uint32_t cred_len = get_buf_offset(buffer) - cred_start;
-		sbcast_cred->buffer = init_buf(cred_len);
-		memcpy(sbcast_cred->buffer->head,
-		       get_buf_data(buffer) + cred_start,
-		       cred_len);
-		sbcast_cred->buffer->processed = cred_len;
-	}
+	cred_len = get_buf_offset(buffer) - cred_start;
+	sbcast_cred->buffer = init_buf(cred_len);
+	memcpy(sbcast_cred->buffer->head, get_buf_data(buffer) + cred_start,
+	       cred_len);
+	sbcast_cred->buffer->processed = cred_len;
 
 	return sbcast_cred;
 
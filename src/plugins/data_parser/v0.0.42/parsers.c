@@ -412,6 +412,9 @@ typedef struct {
 	uint16_t cycle_max;
 	uint64_t time;
 	uint64_t average_time;
+	uint64_t p50;
+	uint64_t p99;
+	uint64_t p999;
 } STATS_MSG_RPC_TYPE_t;
 
 typedef struct {
@@ -419,6 +422,9 @@ typedef struct {
 	uint32_t count;
 	uint64_t time;
 	uint64_t average_time;
+	uint64_t p50;
+	uint64_t p99;
+	uint64_t p999;
 } STATS_MSG_RPC_USER_t;
 
 typedef struct {
@@ -3317,6 +3323,9 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_TYPE)(const parser_t *const parser,
 			.count = stats->rpc_type_cnt[i],
 			.time = stats->rpc_type_time[i],
 			.average_time = NO_VAL64,
+			.p50 = NO_VAL64,
+			.p99 = NO_VAL64,
+			.p999 = NO_VAL64,
 		};
 
 		if (stats->rpc_queue_enabled) {
@@ -3331,6 +3340,19 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_TYPE)(const parser_t *const parser,
 			rpc.average_time = stats->rpc_type_time[i] /
 				stats->rpc_type_cnt[i];
 
+		if (stats->rpc_hist_cnt) {
+			uint32_t *hist = &stats->rpc_type_hist[
+				i * stats->rpc_hist_cnt];
+
+			rpc.p50 = rpc_hist_percentile(hist, stats->rpc_hist_cnt,
+						      50);
+			rpc.p99 = rpc_hist_percentile(hist, stats->rpc_hist_cnt,
+						      99);
+			rpc.p999 = rpc_hist_percentile(hist,
+						       stats->rpc_hist_cnt,
+						       99.9);
+		}
+
 		rc = DUMP(STATS_MSG_RPC_TYPE, rpc, data_list_append(dst), args);
 	}
 
@@ -3357,6 +3379,9 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_USER)(const parser_t *const parser,
 			.count = stats->rpc_user_cnt[i],
 			.time = stats->rpc_user_time[i],
 			.average_time = NO_VAL64,
+			.p50 = NO_VAL64,
+			.p99 = NO_VAL64,
+			.p999 = NO_VAL64,
 		};
 
 		if ((stats->rpc_user_time[i] > 0) &&
@@ -3364,6 +3389,19 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_USER)(const parser_t *const parser,
 			rpc.average_time = stats->rpc_user_time[i] /
 				stats->rpc_user_cnt[i];
 
+		if (stats->rpc_hist_cnt) {
+			uint32_t *hist = &stats->rpc_user_hist[
+				i * stats->rpc_hist_cnt];
+
+			rpc.p50 = rpc_hist_percentile(hist, stats->rpc_hist_cnt,
+						      50);
+			rpc.p99 = rpc_hist_percentile(hist, stats->rpc_hist_cnt,
+						      99);
+			rpc.p999 = rpc_hist_percentile(hist,
+						       stats->rpc_hist_cnt,
+						       99.9);
+		}
+
 		rc = DUMP(STATS_MSG_RPC_USER, rpc, data_list_append(dst), args);
 	}
 
@@ -8815,6 +8853,9 @@ static const parser_t PARSER_ARRAY(OPENAPI_JOB_INFO_DELETE_QUERY)[] = {
 static const parser_t PARSER_ARRAY(OPENAPI_JOB_INFO_QUERY)[] = {
 	add_parse(TIMESTAMP, update_time, "update_time", "Filter jobs since update timestamp"),
 	add_parse_bit_flag_array(openapi_job_info_query_t, JOB_SHOW_FLAGS, false, show_flags, "flags", "Query flags"),
+	add_parse(UINT32, limit, "limit", "Maximum number of jobs to return"),
+	add_parse(UINT32, cursor, "cursor", "Only return jobs with a job_id greater than cursor, ordered by job_id. Use the last job_id of the previous page to get the next page."),
+	add_parse(CSV_STRING_LIST, fields, "fields", "Only return these job fields"),
 };
 #undef add_parse
 
@@ -9190,6 +9231,9 @@ static const parser_t PARSER_ARRAY(STATS_MSG_RPC_TYPE)[] = {
 	add_parse_req(UINT16, cycle_max, "cycle_max", "Maximum number of RPCs processed within a RPC queue cycle since start"),
 	add_parse_req(UINT64, time, "total_time", "Total time spent processing RPC in seconds"),
 	add_parse_req(UINT64_NO_VAL, average_time, "average_time", "Average time spent processing RPC in seconds"),
+	add_parse_req(UINT64_NO_VAL, p50, "p50_time", "Median time spent processing RPC in microseconds (log2 bucket upper bound)"),
+	add_parse_req(UINT64_NO_VAL, p99, "p99_time", "99th percentile time spent processing RPC in microseconds (log2 bucket upper bound)"),
+	add_parse_req(UINT64_NO_VAL, p999, "p999_time", "99.9th percentile time spent processing RPC in microseconds (log2 bucket upper bound)"),
 };
 #undef add_parse_req
 #undef add_parse_req_overload
@@ -9204,6 +9248,9 @@ static const parser_t PARSER_ARRAY(STATS_MSG_RPC_USER)[] = {
 	add_parse_req(UINT32, count, "count", "Number of RPCs received"),
 	add_parse_req(UINT64, time, "total_time", "Total time spent processing RPC in seconds"),
 	add_parse_req(UINT64_NO_VAL, average_time, "average_time", "Average time spent processing RPC in seconds"),
+	add_parse_req(UINT64_NO_VAL, p50, "p50_time", "Median time spent processing RPC in microseconds (log2 bucket upper bound)"),
+	add_parse_req(UINT64_NO_VAL, p99, "p99_time", "99th percentile time spent processing RPC in microseconds (log2 bucket upper bound)"),
+	add_parse_req(UINT64_NO_VAL, p999, "p999_time", "99.9th percentile time spent processing RPC in microseconds (log2 bucket upper bound)"),
 };
 #undef add_parse_req
 #undef add_parse_req_overload
@@ -65,6 +65,9 @@
 
 #include "read_jcconf.h"
 
+/* Prefix of job directories renamed aside for asynchronous removal */
+#define DELETED_PREFIX ".deleted."
+
 static int _create_ns(uint32_t job_id, stepd_step_rec_t *step);
 static int _delete_ns(uint32_t job_id);
 
@@ -106,6 +109,54 @@ static bool _is_plugin_disabled(char *basepath)
 	return ((!basepath) || (!xstrncasecmp(basepath, "none", 4)));
 }
 
+static void _remove_job_dir(const char *path)
+{
+	int failures;
+
+	if ((failures = rmdir_recursive(path, false)))
+		error("%s: failed to remove %d files from %s",
+		      __func__, failures, path);
+	if (rmdir(path))
+		error("rmdir %s failed: %m", path);
+}
+
+/*
+ * Remove a job directory that was renamed aside by _delete_ns() from a
+ * detached grandchild, so the slurmstepd does not wait on it.
+ * RET SLURM_SUCCESS if the removal was handed off, SLURM_ERROR otherwise
+ */
+static int _remove_job_dir_async(const char *path)
+{
+	pid_t cpid;
+	int wstatus;
+
+	if ((cpid = fork()) < 0) {
+		error("%s: fork failed: %m", __func__);
+		return SLURM_ERROR;
+	}
+
+	if (cpid == 0) {
+		pid_t gpid = fork();
+
+		if (gpid < 0)
+			_exit(1);
+		if (gpid > 0)
+			_exit(0);
+
+		(void) setsid();
+		closeall(STDERR_FILENO + 1);
+		(void) rmdir_recursive(path, true);
+		_exit(0);
+	}
+
+	if ((waitpid(cpid, &wstatus, 0) != cpid) || WEXITSTATUS(wstatus)) {
+		error("%s: unable to start removal of %s", __func__, path);
+		return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
 static int _restore_ns(List steps, const char *d_name)
 {
 	char *endptr;
@@ -113,6 +164,17 @@ static int _restore_ns(List steps, const char *d_name)
 	unsigned long job_id;
 	step_loc_t *stepd;
 
+	if (!xstrncmp(d_name, DELETED_PREFIX, strlen(DELETED_PREFIX))) {
+		char *path = NULL;
+
+		/* Left behind by an interrupted asynchronous removal */
+		xstrfmtcat(path, "%s/%s", jc_conf->basepath, d_name);
+		log_flag(JOB_CONT, "removing stale job directory %s", path);
+		_remove_job_dir(path);
+		xfree(path);
+		return SLURM_SUCCESS;
+	}
+
 	errno = 0;
 	job_id = strtoul(d_name, &endptr, 10);
 	if ((errno != 0) || (job_id >= NO_VAL) || (*endptr != '\0')) {
@@ -735,7 +797,7 @@ extern int container_p_join(uint32_t job_id, uid_t uid)
 
 static int _delete_ns(uint32_t job_id)
 {
-	char *job_mount = NULL, *ns_holder = NULL;
+	char *job_mount = NULL, *ns_holder = NULL, *deleted_path = NULL;
 	int rc = 0, failures = 0;
 
 	_create_paths(job_id, &job_mount, &ns_holder, NULL);
@@ -775,14 +837,33 @@ static int _delete_ns(uint32_t job_id)
 		}
 	}
 
-	if ((failures = rmdir_recursive(job_mount, false)))
-		error("%s: failed to remove %d files from %s",
-		      __func__, failures, job_mount);
+	/*
+	 * Removing the job's private directories can take a while for jobs
+	 * leaving many files behind. Unmount the job directory and rename it
+	 * aside, so the job id is free for reuse right away, then remove its
+	 * contents in the background. Fall back to removing it in place if
+	 * any of that fails. Leftovers are cleaned up by container_p_restore().
+	 */
 	if (umount2(job_mount, MNT_DETACH))
 		log_flag(JOB_CONT, "umount2: %s failed: %m", job_mount);
-	if (rmdir(job_mount))
-		error("rmdir %s failed: %m", job_mount);
 
+	xstrfmtcat(deleted_path, "%s/%s%u.%d", jc_conf->basepath,
+		   DELETED_PREFIX, job_id, (int) getpid());
+	if (!rename(job_mount, deleted_path) &&
+	    !_remove_job_dir_async(deleted_path)) {
+		log_flag(JOB_CONT, "job %u directory %s removed in background",
+			 job_id, deleted_path);
+	} else if (!access(deleted_path, F_OK)) {
+		_remove_job_dir(deleted_path);
+	} else {
+		if ((failures = rmdir_recursive(job_mount, false)))
+			error("%s: failed to remove %d files from %s",
+			      __func__, failures, job_mount);
+		if (rmdir(job_mount))
+			error("rmdir %s failed: %m", job_mount);
+	}
+
+	xfree(deleted_path);
 	xfree(job_mount);
 	xfree(ns_holder);
 
@@ -101,6 +101,7 @@ static lua_State *L = NULL;
 static char *user_msg = NULL;
 time_t last_lua_jobs_update = (time_t) 0;
 time_t last_lua_resv_update = (time_t) 0;
+static time_t last_lua_resv_copy = (time_t) 0;
 static const char *req_fxns[] = {
 	"slurm_job_submit",
 	"slurm_job_modify",
@@ -113,10 +114,31 @@ static const char *req_fxns[] = {
 static pthread_mutex_t lua_lock = PTHREAD_MUTEX_INITIALIZER;
 
 typedef struct {
+	bool copy;
 	uint32_t submit_uid;
 	uint32_t user_id;
 } foreach_part_list_args_t;
 
+/*
+ * Record fields copied into plain tables for job_submit_unlocked(), where the
+ * script runs after the slurmctld locks are released.
+ */
+static const char *part_rec_fields[] = {
+	"allow_accounts", "allow_alloc_nodes", "allow_groups", "allow_qos",
+	"alternate", "billing_weights_str", "default_time", "def_mem_per_cpu",
+	"def_mem_per_node", "deny_accounts", "deny_qos", "flag_default",
+	"flags", "max_cpus_per_node", "max_cpus_per_socket", "max_mem_per_cpu",
+	"max_mem_per_node", "max_nodes", "max_nodes_orig", "max_share",
+	"max_oversubscribe", "max_time", "min_nodes", "min_nodes_orig", "name",
+	"nodes", "priority_job_factor", "priority_tier", "qos", "state_up",
+	"total_cpus", "total_nodes", NULL
+};
+static const char *resv_fields[] = {
+	"accounts", "assoc_list", "duration", "end_time", "features", "flags",
+	"full_nodes", "flags_set_node", "licenses", "node_cnt", "node_list",
+	"partition", "start_time", "users", NULL
+};
+
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined.  They will get
  * overwritten when linking with the slurmctld.
@@ -361,11 +383,49 @@ static void _update_resvs_global(lua_State *st)
 
 	list_for_each(resv_list, _foreach_update_resvs_global, st);
 	last_lua_resv_update = last_resv_update;
+	last_lua_resv_copy = 0;
 
 	lua_setfield(st, -2, "reservations");
 	lua_pop(st, 1);
 }
 
+static int _foreach_copy_resvs_global(void *x, void *arg)
+{
+	slurmctld_resv_t *resv_ptr = x;
+	lua_State *st = arg;
+
+	lua_newtable(st);
+	for (int i = 0; resv_fields[i]; i++) {
+		_resv_field(resv_ptr, resv_fields[i]);
+		lua_setfield(st, -2, resv_fields[i]);
+	}
+	lua_setfield(st, -2, resv_ptr->name);
+
+	return 0;
+}
+
+/*
+ * Replace slurm.reservations with copies of the reservation records and
+ * slurm.jobs with an empty table, so nothing in the Lua state refers to
+ * slurmctld records once the locks are released.
+ */
+static void _copy_globals(lua_State *st)
+{
+	lua_getglobal(st, "slurm");
+	lua_newtable(st);
+	lua_setfield(st, -2, "jobs");
+	last_lua_jobs_update = 0;
+
+	if (last_lua_resv_copy < last_resv_update) {
+		lua_newtable(st);
+		list_for_each(resv_list, _foreach_copy_resvs_global, st);
+		lua_setfield(st, -2, "reservations");
+		last_lua_resv_copy = last_resv_update;
+		last_lua_resv_update = 0;
+	}
+	lua_pop(st, 1);
+}
+
 /* Set fields in the job request structure on job submit or modify */
 static int _set_job_env_field(lua_State *L)
 {
@@ -1241,6 +1301,16 @@ static int _foreach_push_partition_list(void *x, void *arg)
 	if (!_user_can_use_part(args->user_id, args->submit_uid, part_ptr))
 		return 0;
 
+	if (args->copy) {
+		lua_newtable(L);
+		for (int i = 0; part_rec_fields[i]; i++) {
+			_part_rec_field(part_ptr, part_rec_fields[i]);
+			lua_setfield(L, -2, part_rec_fields[i]);
+		}
+		lua_setfield(L, -2, part_ptr->name);
+		return 0;
+	}
+
 	/*
 	 * Create an empty table, with a metatable that looks up the
 	 * data for the partition.
@@ -1263,9 +1333,11 @@ static int _foreach_push_partition_list(void *x, void *arg)
 	return 0;
 }
 
-static void _push_partition_list(uint32_t user_id, uint32_t submit_uid)
+static void _push_partition_list(uint32_t user_id, uint32_t submit_uid,
+				 bool copy)
 {
 	foreach_part_list_args_t args = {
+		.copy = copy,
 		.submit_uid = submit_uid,
 		.user_id = user_id,
 	};
@@ -1408,8 +1480,74 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	_update_resvs_global(L);
 
 	_push_job_desc(job_desc);
-	_push_partition_list(job_desc->user_id, submit_uid);
+	_push_partition_list(job_desc->user_id, submit_uid, false);
+	lua_pushnumber(L, submit_uid);
+	slurm_lua_stack_dump(
+		"job_submit/lua", "job_submit, before lua_pcall", L);
+	if (lua_pcall(L, 3, 1, 0) != 0) {
+		error("%s/lua: %s: %s",
+		      __func__, lua_script_path, lua_tostring(L, -1));
+	} else {
+		if (lua_isnumber(L, -1)) {
+			rc = lua_tonumber(L, -1);
+		} else {
+			info("%s/lua: %s: non-numeric return code",
+			     __func__, lua_script_path);
+			rc = SLURM_SUCCESS;
+		}
+		lua_pop(L, 1);
+	}
+	slurm_lua_stack_dump(
+		"job_submit/lua", "job_submit, after lua_pcall", L);
+	if (user_msg) {
+		*err_msg = user_msg;
+		user_msg = NULL;
+	}
+
+out:	slurm_mutex_unlock (&lua_lock);
+	return rc;
+}
+
+/*
+ * Lua script hook called for "submit job" event with
+ * SlurmctldParameters=job_submit_unlocked. The partitions and reservations
+ * are copied into the Lua state under slurmctld read locks, which are then
+ * released before the script runs. slurm.jobs is empty in this mode.
+ */
+extern int job_submit_unlocked(job_desc_msg_t *job_desc, uint32_t submit_uid,
+			       char **err_msg)
+{
+	/* Locks: Read config, read job, read node, read partition */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK, NO_LOCK };
+	int rc;
+
+	/* Take the slurmctld locks before lua_lock, the order job_submit() uses */
+	lock_slurmctld(job_read_lock);
+	slurm_mutex_lock (&lua_lock);
+
+	rc = slurm_lua_loadscript(&L, "job_submit/lua",
+				  lua_script_path, req_fxns,
+				  &lua_script_last_loaded, _loadscript_extra);
+
+	if (rc != SLURM_SUCCESS) {
+		unlock_slurmctld(job_read_lock);
+		goto out;
+	}
+
+	lua_getglobal(L, "slurm_job_submit");
+	if (lua_isnil(L, -1)) {
+		unlock_slurmctld(job_read_lock);
+		goto out;
+	}
+
+	_copy_globals(L);
+
+	_push_job_desc(job_desc);
+	_push_partition_list(job_desc->user_id, submit_uid, true);
 	lua_pushnumber(L, submit_uid);
+	unlock_slurmctld(job_read_lock);
+
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_submit, before lua_pcall", L);
 	if (lua_pcall(L, 3, 1, 0) != 0) {
@@ -1463,7 +1601,7 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 
 	_push_job_desc(job_desc);
 	_push_job_rec(job_ptr);
-	_push_partition_list(job_ptr->user_id, submit_uid);
+	_push_partition_list(job_ptr->user_id, submit_uid, false);
 	lua_pushnumber(L, submit_uid);
 	slurm_lua_stack_dump(
 		"job_submit/lua", "job_modify, before lua_pcall", L);
@@ -70,6 +70,11 @@ char **assoc_mgr_tres_name_array;
 #endif
 
 
+typedef struct {
+	int cnt;
+	pid_t *pids;
+} jag_pids_t;
+
 static int cpunfo_frequency = 0;
 static long conv_units = 0;
 List prec_list = NULL;
@@ -302,6 +307,7 @@ again:
 /* _get_process_data_line() - get line of data from /proc/<pid>/stat
  *
  * IN:	in - input file descriptor
+ * IN:	old - record of this pid from the previous poll, or NULL
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -312,7 +318,7 @@ again:
  * embedded ')'s. Such names confuse %s (see scanf(3)), so the string is split
  * and %39c is used instead. (except for embedded ')' "(%[^)]c)" would work.
  */
-static int _get_process_data_line(int in, jag_prec_t *prec) {
+static int _get_process_data_line(int in, jag_prec_t *prec, jag_prec_t *old) {
 	char sbuf[512], *tmp;
 	int num_read, nvals;
 	char cmd[40], state[1];
@@ -362,13 +368,15 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 	/*
 	 * If current pid corresponds to a Light Weight Process (Thread POSIX)
 	 * or there was an error, skip it, we will only account the original
-	 * process (pid==tgid).
+	 * process (pid==tgid). A process recorded by the previous poll with
+	 * the same start time is known not to be a LWP.
 	 */
-	if (_is_a_lwp(prec->pid))
+	if ((!old || (old->start_time != starttime)) && _is_a_lwp(prec->pid))
 		return 0;
 
 	/* Copy the values that slurm records into our data structure */
 	prec->ppid  = ppid;
+	prec->start_time = starttime;
 
 	prec->tres_data[TRES_ARRAY_PAGES].size_read = majflt;
 	prec->tres_data[TRES_ARRAY_VMEM].size_read = vsize;
@@ -472,8 +480,7 @@ static int _get_process_io_data_line(int in, jag_prec_t *prec) {
 	if (nvals < 4)
 		return 0;
 
-	if (_is_a_lwp(prec->pid))
-		return 0;
+	/* LWPs were already skipped by _get_process_data_line() */
 
 	/* keep real value here since we aren't doubles */
 	prec->tres_data[TRES_ARRAY_FS_DISK].size_read = rchar;
@@ -517,7 +524,8 @@ void _set_smaps_file(char **proc_smaps_file, pid_t pid)
 		xstrfmtcat(*proc_smaps_file, "/proc/%d/smaps", pid);
 }
 
-static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
+static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count,
+			  jag_prec_t *old)
 {
 	static int no_share_data = -1;
 	static int use_pss = -1;
@@ -588,7 +596,7 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 
 	(void)_init_tres(prec, NULL);
 
-	if (!_get_process_data_line(fd, prec)) {
+	if (!_get_process_data_line(fd, prec, old)) {
 		fclose(stat_fp);
 		goto bail_out;
 	}
@@ -627,7 +635,7 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 		fclose(io_fp);
 	}
 
-	destroy_jag_prec(list_remove_first(prec_list, _find_prec, &prec->pid));
+	/* _get_precs() drops the previous record of this pid */
 	list_append(prec_list, prec);
 	xfree(proc_file);
 	return;
@@ -647,12 +655,72 @@ static int _mark_as_completed(void *x, void *empty)
 	return SLURM_SUCCESS;
 }
 
+static int _cmp_pid(const void *a, const void *b)
+{
+	pid_t x = *(pid_t *) a, y = *(pid_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+static int _cmp_prec_pid(const void *a, const void *b)
+{
+	jag_prec_t *x = *(jag_prec_t **) a, *y = *(jag_prec_t **) b;
+
+	return (x->pid > y->pid) - (x->pid < y->pid);
+}
+
+static int _cmp_pid_prec(const void *key, const void *b)
+{
+	jag_prec_t *y = *(jag_prec_t **) b;
+
+	return _cmp_pid(key, &y->pid);
+}
+
+static int _find_prec_in_pids(void *x, void *key)
+{
+	jag_prec_t *prec = x;
+	jag_pids_t *found = key;
+
+	return bsearch(&prec->pid, found->pids, found->cnt, sizeof(pid_t),
+		       _cmp_pid) ? 1 : 0;
+}
+
+/*
+ * Replace the records of the previous poll by the ones just read, keeping the
+ * records of the processes no longer seen so their usage is not lost.
+ * Done in one pass so the cost does not grow with the square of the number of
+ * processes.
+ */
+static void _merge_old_precs(List old_list)
+{
+	jag_pids_t found = { 0 };
+	list_itr_t *itr;
+	jag_prec_t *prec;
+
+	if ((found.cnt = list_count(prec_list))) {
+		found.pids = xcalloc(found.cnt, sizeof(pid_t));
+		itr = list_iterator_create(prec_list);
+		for (int i = 0; (prec = list_next(itr)); i++)
+			found.pids[i] = prec->pid;
+		list_iterator_destroy(itr);
+		qsort(found.pids, found.cnt, sizeof(pid_t), _cmp_pid);
+
+		(void) list_delete_all(old_list, _find_prec_in_pids, &found);
+		xfree(found.pids);
+	}
+
+	list_transfer(prec_list, old_list);
+}
+
 static List _get_precs(List task_list, uint64_t cont_id,
 		       jag_callbacks_t *callbacks)
 {
 	int npids = 0;
 	struct jobacctinfo *jobacct = NULL;
 	pid_t *pids = NULL;
+	List old_list;
+	jag_prec_t **old_precs = NULL, **old;
+	int old_cnt;
 
 	xassert(task_list);
 
@@ -667,13 +735,30 @@ static List _get_precs(List task_list, uint64_t cont_id,
 	 * aggregating it on each iteration.
 	 */
 	list_for_each(prec_list, _mark_as_completed, NULL);
+	old_list = list_create(destroy_jag_prec);
+	list_transfer(old_list, prec_list);
+
+	/* Index the previous records by pid to skip work for known processes */
+	if ((old_cnt = list_count(old_list))) {
+		list_itr_t *itr = list_iterator_create(old_list);
+
+		old_precs = xcalloc(old_cnt + 1, sizeof(*old_precs));
+		for (int i = 0; (old_precs[i] = list_next(itr)); i++)
+			;
+		list_iterator_destroy(itr);
+		qsort(old_precs, old_cnt, sizeof(*old_precs), _cmp_prec_pid);
+	}
 
 	/* get only the processes in the proctrack container */
 	proctrack_g_get_pids(cont_id, &pids, &npids);
 	if (npids) {
 		for (int i = 0; i < npids; i++) {
+			old = old_cnt ? bsearch(&pids[i], old_precs, old_cnt,
+						sizeof(*old_precs),
+						_cmp_pid_prec) : NULL;
 			_handle_stats(pids[i], callbacks,
-				      jobacct ? jobacct->tres_count : 0);
+				      jobacct ? jobacct->tres_count : 0,
+				      old ? *old : NULL);
 		}
 		xfree(pids);
 	} else {
@@ -692,6 +777,10 @@ static List _get_precs(List task_list, uint64_t cont_id,
 		log_flag(JAG, "no pids in this container %"PRIu64, cont_id);
 	}
 
+	xfree(old_precs);
+	_merge_old_precs(old_list);
+	FREE_NULL_LIST(old_list);
+
 	return prec_list;
 }
 
@@ -897,31 +986,40 @@ static void _print_jag_prec(jag_prec_t *prec)
 	log_flag(JAG, "usec \t%f", prec->usec);
 }
 
-static int _list_find_prec_by_pid(void *x, void *key)
+static int _cmp_prec_ppid(const void *a, const void *b)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	jag_prec_t *x = *(jag_prec_t **) a, *y = *(jag_prec_t **) b;
 
-        if (!j->visited && (j->pid == pid))
-                return 1;
-        return 0;
+	return (x->ppid > y->ppid) - (x->ppid < y->ppid);
 }
 
-static int _list_find_prec_by_ppid(void *x, void *key)
+/* Return index of the first prec in the ppid sorted array with ppid == pid */
+static int _first_child(jag_prec_t **precs, int cnt, pid_t pid)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	int lo = 0, hi = cnt;
 
-        if (!j->visited && (j->ppid == pid))
-                return 1;
-        return 0;
+	while (lo < hi) {
+		int mid = lo + ((hi - lo) / 2);
+
+		if (precs[mid]->ppid < pid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
 }
 
-static int _reset_visited(jag_prec_t *prec, void *empty)
+static int _find_completed_offspring(void *x, void *key)
 {
-	prec->visited = false;
+	jag_prec_t *prec = x;
 
-	return SLURM_SUCCESS;
+	if ((prec != key) && prec->visited && prec->completed) {
+		log_flag(JAG, "Removing completed process %d", prec->pid);
+		return 1;
+	}
+
+	return 0;
 }
 
 static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
@@ -1001,26 +1099,47 @@ static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
 static void _get_offspring_data(List prec_list, jag_prec_t *ancestor, pid_t pid,
 				jag_prec_t *permanent_anc)
 {
-	jag_prec_t *prec = NULL;
-	jag_prec_t *prec_tmp = NULL;
-	List tmp_list = NULL;
+	jag_prec_t *prec = NULL, *root = NULL;
+	jag_prec_t **precs, **queue;
+	int cnt, i = 0, head = 0, tail = 0;
+	bool removed = false;
+	list_itr_t *itr;
 
-	/* reset all precs to be not visited */
-	(void)list_for_each(prec_list, (ListForF)_reset_visited, NULL);
+	if (!(cnt = list_count(prec_list)))
+		return;
+
+	/*
+	 * Index the precs by ppid once, rather than scanning the whole list
+	 * for the children of every process of the tree.
+	 */
+	precs = xcalloc(cnt, sizeof(*precs));
+	queue = xcalloc(cnt, sizeof(*queue));
+	itr = list_iterator_create(prec_list);
+	while ((prec = list_next(itr))) {
+		prec->visited = false;
+		if (!root && (prec->pid == pid))
+			root = prec;
+		precs[i++] = prec;
+	}
+	list_iterator_destroy(itr);
 
 	/* See if we can find a prec from the given pid */
-	if (!(prec = list_find_first(prec_list, _list_find_prec_by_pid, &pid)))
-		return;
+	if (!root)
+		goto end;
 
-	prec->visited = true;
+	qsort(precs, cnt, sizeof(*precs), _cmp_prec_ppid);
 
-	tmp_list = list_create(NULL);
-	list_append(tmp_list, prec);
+	root->visited = true;
+	queue[tail++] = root;
 
-	while ((prec_tmp = list_dequeue(tmp_list))) {
-		while ((prec = list_find_first(prec_list,
-					      _list_find_prec_by_ppid,
-					       &(prec_tmp->pid)))) {
+	while (head < tail) {
+		pid_t parent = queue[head++]->pid;
+
+		for (i = _first_child(precs, cnt, parent);
+		     (i < cnt) && (precs[i]->ppid == parent); i++) {
+			prec = precs[i];
+			if (prec->visited)
+				continue;
 			_aggregate_prec(prec, ancestor);
 			/*
 			 * If the prec disappeared (pid is dead) aggregate its
@@ -1029,17 +1148,18 @@ static void _get_offspring_data(List prec_list, jag_prec_t *ancestor, pid_t pid,
 			 */
 			if (prec->completed) {
 				_aggregate_prec(prec, permanent_anc);
-				log_flag(JAG, "Removing completed process %d",
-					 prec->pid);
-				list_remove_first(prec_list, _find_prec,
-						  &prec->pid);
+				removed = true;
 			}
-			list_append(tmp_list, prec);
+			queue[tail++] = prec;
 		}
 	}
-	FREE_NULL_LIST(tmp_list);
 
-	return;
+	if (removed)
+		(void) list_delete_all(prec_list, _find_completed_offspring,
+				       root);
+end:
+	xfree(precs);
+	xfree(queue);
 }
 
 extern void jag_common_poll_data(List task_list, uint64_t cont_id,
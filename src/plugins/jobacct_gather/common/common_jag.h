@@ -48,6 +48,7 @@ typedef struct jag_prec {	/* process record */
 	int	last_cpu;	/* last cpu */
 	pid_t	pid;
 	pid_t	ppid;
+	uint64_t start_time; /* clock ticks after boot, tells pid reuse apart */
 	double  ssec; /* system cpu time: To normalize divide by system hertz */
 	/* Units of tres_[in|out] should be raw numbers (bytes/joules) */
 	int     tres_count; /* count of tres in the tres_data */
@@ -101,6 +101,8 @@ const char plugin_type[] = "jobcomp/elasticsearch";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 #define INDEX_RETRY_INTERVAL 30
+#define DEFAULT_FLUSH_INTERVAL 1
+#define MAX_BULK_SIZE 10000
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined. They will get
@@ -121,6 +123,7 @@ struct http_response {
 };
 
 struct job_node {
+	bool indexed;
 	time_t last_index_retry;
 	char * serialized_job;
 };
@@ -135,6 +138,9 @@ static pthread_mutex_t pend_jobs_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_t job_handler_thread;
 static List jobslist = NULL;
 static bool thread_shutdown = false;
+/* JobCompParams, protected by location_mutex */
+static uint32_t bulk_size = 1;
+static uint32_t flush_interval = DEFAULT_FLUSH_INTERVAL;
 
 /* Load jobcomp data from save state file */
 static int _load_pending_jobs(void)
@@ -285,6 +291,167 @@ cleanup_easy_init:
 	return rc;
 }
 
+typedef struct {
+	struct job_node **jnodes;
+	int cnt;
+	int idx;
+} bulk_items_args_t;
+
+static data_for_each_cmd_t _foreach_bulk_item(data_t *data, void *arg)
+{
+	bulk_items_args_t *args = arg;
+	const data_t *op;
+	int64_t status = 0;
+
+	if (args->idx >= args->cnt)
+		return DATA_FOR_EACH_STOP;
+
+	if ((op = data_key_get_const(data, "index")) &&
+	    (op = data_key_get_const(op, "status")) &&
+	    !data_get_int_converted(op, &status) &&
+	    ((status == 200) || (status == 201)))
+		args->jnodes[args->idx]->indexed = true;
+	else
+		log_flag(JOBCOMP, "bulk item %d failed with status %"PRId64,
+			 args->idx, status);
+
+	args->idx++;
+	return DATA_FOR_EACH_CONT;
+}
+
+/*
+ * Build the _bulk endpoint from JobCompLoc. The usual <target>/_doc form
+ * is typeless since Elasticsearch 8.0, so the trailing /_doc is dropped.
+ * Caller must hold location_mutex.
+ */
+static char *_bulk_url(void)
+{
+	char *url = xstrdup(log_url);
+	int len = strlen(url);
+
+	while (len && (url[len - 1] == '/'))
+		url[--len] = '\0';
+	if ((len >= 5) && !xstrcmp(url + len - 5, "/_doc"))
+		url[len - 5] = '\0';
+	xstrcat(url, "/_bulk");
+
+	return url;
+}
+
+/*
+ * Index a batch of jobs with a single request to the _bulk API. Jobs that
+ * were accepted get their indexed flag set, the rest are retried later.
+ * RET SLURM_SUCCESS if every job in the batch was indexed
+ */
+static int _index_jobs_bulk(struct job_node **jnodes, int cnt)
+{
+	CURL *curl_handle = NULL;
+	CURLcode res;
+	struct http_response chunk = { 0 };
+	struct curl_slist *slist = NULL;
+	char *body = NULL, *pos = NULL, *url = NULL;
+	long response_code = 0;
+	data_t *resp = NULL;
+	const data_t *errors, *items;
+	int rc = SLURM_SUCCESS;
+
+	slurm_mutex_lock(&location_mutex);
+	if (log_url == NULL) {
+		error("%s: JobCompLoc parameter not configured", plugin_type);
+		slurm_mutex_unlock(&location_mutex);
+		return SLURM_ERROR;
+	}
+	url = _bulk_url();
+
+	for (int i = 0; i < cnt; i++) {
+		xstrcatat(body, &pos, "{\"index\":{}}\n");
+		xstrcatat(body, &pos, jnodes[i]->serialized_job);
+		xstrcatat(body, &pos, "\n");
+	}
+
+	if ((curl_handle = curl_easy_init()) == NULL) {
+		error("%s: curl_easy_init: %m", plugin_type);
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if (!(slist = curl_slist_append(slist,
+					"Content-Type: application/x-ndjson"))) {
+		error("%s: curl_slist_append: %m", plugin_type);
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	chunk.message = xmalloc(1);
+
+	if (curl_easy_setopt(curl_handle, CURLOPT_URL, url) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_POST, 1L) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, body) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE,
+			     (long) (pos - body)) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, slist) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION,
+			     _write_callback) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk)) {
+		error("%s: curl_easy_setopt() failed", plugin_type);
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
+		log_flag(JOBCOMP, "Could not connect to: %s , reason: %s",
+			 url, curl_easy_strerror(res));
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if (curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
+			      &response_code) || (response_code != 200)) {
+		log_flag(JOBCOMP, "HTTP status code %ld received from %s",
+			 response_code, url);
+		log_flag(JOBCOMP, "HTTP response:\n%s", chunk.message);
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if (serialize_g_string_to_data(&resp, chunk.message, chunk.size,
+				       MIME_TYPE_JSON) ||
+	    !(errors = data_key_get_const(resp, "errors"))) {
+		error("%s: Unable to parse _bulk response from %s",
+		      plugin_type, url);
+		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if ((data_get_type(errors) == DATA_TYPE_BOOL) &&
+	    !data_get_bool(errors)) {
+		for (int i = 0; i < cnt; i++)
+			jnodes[i]->indexed = true;
+	} else if ((items = data_key_get_const(resp, "items")) &&
+		   (data_get_type(items) == DATA_TYPE_LIST)) {
+		bulk_items_args_t args = { .jnodes = jnodes, .cnt = cnt };
+
+		(void) data_list_for_each((data_t *) items, _foreach_bulk_item,
+					  &args);
+		rc = SLURM_ERROR;
+	} else {
+		rc = SLURM_ERROR;
+	}
+
+	log_flag(JOBCOMP, "%d jobs sent to %s", cnt, url);
+
+cleanup:
+	FREE_NULL_DATA(resp);
+	curl_slist_free_all(slist);
+	xfree(chunk.message);
+	if (curl_handle)
+		curl_easy_cleanup(curl_handle);
+	slurm_mutex_unlock(&location_mutex);
+	xfree(body);
+	xfree(url);
+	return rc;
+}
+
 /* Saves the state of all jobcomp data for further indexing retries */
 static int _save_state(void)
 {
@@ -340,6 +507,70 @@ extern int jobcomp_p_log_record(job_record_t *job_ptr)
 	return rc;
 }
 
+static int _find_indexed(void *x, void *key)
+{
+	return ((struct job_node *) x)->indexed;
+}
+
+static void _send_bulk(struct job_node **batch, int *batch_cnt,
+		       time_t now, int *success_cnt, int *fail_cnt)
+{
+	(void) _index_jobs_bulk(batch, *batch_cnt);
+	for (int i = 0; i < *batch_cnt; i++) {
+		if (batch[i]->indexed) {
+			(*success_cnt)++;
+		} else {
+			batch[i]->last_index_retry = now;
+			(*fail_cnt)++;
+		}
+	}
+	*batch_cnt = 0;
+}
+
+/*
+ * Send the jobs due for indexing through the _bulk API, bulk_size jobs per
+ * request. A partially filled batch waits up to flush_interval seconds for
+ * more jobs to complete.
+ */
+static void _process_jobs_bulk(uint32_t size, uint32_t interval,
+			       int *success_cnt, int *fail_cnt,
+			       int *wait_retry_cnt)
+{
+	static time_t last_flush = 0;
+	struct job_node **batch = xcalloc(size, sizeof(*batch));
+	struct job_node *jnode;
+	list_itr_t *iter;
+	int batch_cnt = 0;
+	time_t now = time(NULL);
+
+	iter = list_iterator_create(jobslist);
+	while ((jnode = list_next(iter)) && !thread_shutdown) {
+		if ((jnode->last_index_retry != 0) &&
+		    (difftime(now, jnode->last_index_retry) <
+		     INDEX_RETRY_INTERVAL)) {
+			(*wait_retry_cnt)++;
+			continue;
+		}
+		batch[batch_cnt++] = jnode;
+		if (batch_cnt == size) {
+			_send_bulk(batch, &batch_cnt, now, success_cnt,
+				   fail_cnt);
+			last_flush = now;
+		}
+	}
+	list_iterator_destroy(iter);
+
+	if (batch_cnt && !thread_shutdown &&
+	    (difftime(now, last_flush) >= interval)) {
+		_send_bulk(batch, &batch_cnt, now, success_cnt, fail_cnt);
+		last_flush = now;
+	}
+	xfree(batch);
+
+	if (*success_cnt)
+		(void) list_delete_all(jobslist, _find_indexed, NULL);
+}
+
 extern void *_process_jobs(void *x)
 {
 	list_itr_t *iter;
@@ -355,7 +586,25 @@ extern void *_process_jobs(void *x)
 
 	while (!thread_shutdown) {
 		int success_cnt = 0, fail_cnt = 0, wait_retry_cnt = 0;
+		uint32_t size, interval;
+
 		sleep(1);
+
+		slurm_mutex_lock(&location_mutex);
+		size = bulk_size;
+		interval = flush_interval;
+		slurm_mutex_unlock(&location_mutex);
+
+		if (size > 1) {
+			_process_jobs_bulk(size, interval, &success_cnt,
+					   &fail_cnt, &wait_retry_cnt);
+			if ((success_cnt || fail_cnt))
+				log_flag(JOBCOMP, "index success:%d fail:%d wait_retry:%d",
+					 success_cnt, fail_cnt,
+					 wait_retry_cnt);
+			continue;
+		}
+
 		iter = list_iterator_create(jobslist);
 		while ((jnode = (struct job_node *)list_next(iter)) &&
 		       !thread_shutdown) {
@@ -432,6 +681,32 @@ extern int fini(void)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Parse bulk_size= and flush_interval= out of JobCompParams.
+ * Caller must hold location_mutex.
+ */
+static void _parse_params(void)
+{
+	char *begin;
+
+	bulk_size = 1;
+	flush_interval = DEFAULT_FLUSH_INTERVAL;
+
+	if ((begin = xstrcasestr(slurm_conf.job_comp_params, "bulk_size="))) {
+		int val = atoi(begin + strlen("bulk_size="));
+
+		if ((val < 1) || (val > MAX_BULK_SIZE))
+			error("%s: Invalid JobCompParams bulk_size=%d, valid range is [1,%d]",
+			      plugin_type, val, MAX_BULK_SIZE);
+		else
+			bulk_size = val;
+	}
+
+	if ((begin = xstrcasestr(slurm_conf.job_comp_params,
+				 "flush_interval=")))
+		flush_interval = atoi(begin + strlen("flush_interval="));
+}
+
 /*
  * The remainder of this file implements the standard Slurm job completion
  * logging API.
@@ -450,6 +725,7 @@ extern int jobcomp_p_set_location(void)
 	if (log_url)
 		xfree(log_url);
 	log_url = xstrdup(location);
+	_parse_params();
 	slurm_cond_broadcast(&location_cond);
 	slurm_mutex_unlock(&location_mutex);
 
@@ -146,7 +146,9 @@ extern int jobcomp_p_log_record(job_record_t *job_ptr)
 		goto end;
 	}
 
+	/* Ownership of the serialized record passes to the message. */
 	jobcomp_kafka_message_produce(job_ptr->job_id, job_record_serialized);
+	job_record_serialized = NULL;
 
 end:
 	xfree(job_record_serialized);
@@ -65,7 +65,7 @@ static bool terminate = false;
  */
 static rd_kafka_t *rk = NULL;
 
-static void _add_kafka_msg_to_state(uint32_t job_id, char *payload);
+static void _add_kafka_msg_to_state(kafka_msg_t *kafka_msg);
 static int _configure_rd_kafka_handle(void);
 static int _create_rd_kafka_handle(rd_kafka_conf_t *conf);
 static void _destroy_kafka_msg(void *arg);
@@ -89,17 +89,12 @@ static int _unpack_jobcomp_kafka_msg(uint16_t protocol_version, buf_t *buffer);
 static void _unpack_jobcomp_kafka_state(buf_t *buffer);
 
 /*
- * Allocate memory for a kafka_msg_t* and initialize it with arguments.
- * Append to state_msg_list.
+ * Append a kafka_msg_t* to state_msg_list. The list takes ownership of it.
  *
- * IN: uint32_t job_id
- * IN: char *payload
+ * IN: kafka_msg_t *kafka_msg
  */
-static void _add_kafka_msg_to_state(uint32_t job_id, char *payload)
+static void _add_kafka_msg_to_state(kafka_msg_t *kafka_msg)
 {
-	kafka_msg_t *kafka_msg = NULL;
-
-	kafka_msg = _init_kafka_msg(job_id, payload);
 	list_append(state_msg_list, kafka_msg);
 }
 
@@ -169,10 +164,10 @@ static void _dr_msg_cb(rd_kafka_t *rk, const rd_kafka_message_t *rkmessage,
 		       void *opaque)
 {
 	bool requeue;
-	uint32_t job_id = *(uint32_t *) rkmessage->_private;
+	kafka_msg_t *kafka_msg = rkmessage->_private;
+	uint32_t job_id = kafka_msg->job_id;
 	char *topic = (char *) rd_kafka_topic_name(rkmessage->rkt);
 	char *err_str = (char *) rd_kafka_err2str(rkmessage->err);
-	char *payload = rkmessage->payload;
 	char *action_str = NULL;
 
 	switch (rkmessage->err) {
@@ -194,12 +189,14 @@ static void _dr_msg_cb(rd_kafka_t *rk, const rd_kafka_message_t *rkmessage,
 
 		if (requeue) {
 			if (!terminate) {
-				jobcomp_kafka_message_produce(job_id, payload);
+				jobcomp_kafka_message_produce(
+					job_id, kafka_msg->payload);
+				kafka_msg->payload = NULL;
 				xstrfmtcat(action_str,
 					"Attempting to produce message again");
 			} else {
-				_add_kafka_msg_to_state(job_id,
-							xstrdup(payload));
+				_add_kafka_msg_to_state(kafka_msg);
+				kafka_msg = NULL;
 				xstrfmtcat(action_str,
 					"Saving message to plugin state file.");
 			}
@@ -217,7 +214,8 @@ static void _dr_msg_cb(rd_kafka_t *rk, const rd_kafka_message_t *rkmessage,
 		/* Purged in-queue. Always requeue in this case. */
 		log_flag(JOBCOMP, "Message delivery for JobId=%u failed: %s. Saving message to plugin state file.",
 			 job_id, err_str);
-		_add_kafka_msg_to_state(job_id, xstrdup(payload));
+		_add_kafka_msg_to_state(kafka_msg);
+		kafka_msg = NULL;
 
 		break;
 	case RD_KAFKA_RESP_ERR__PURGE_INFLIGHT:
@@ -232,8 +230,10 @@ static void _dr_msg_cb(rd_kafka_t *rk, const rd_kafka_message_t *rkmessage,
 		      requeue ?
 		      "Saving message to plugin state file" : "Message discarded");
 
-		if (requeue)
-			_add_kafka_msg_to_state(job_id, xstrdup(payload));
+		if (requeue) {
+			_add_kafka_msg_to_state(kafka_msg);
+			kafka_msg = NULL;
+		}
 
 		break;
 #endif
@@ -243,8 +243,12 @@ static void _dr_msg_cb(rd_kafka_t *rk, const rd_kafka_message_t *rkmessage,
 		break;
 	}
 
-	xfree(rkmessage->_private);
-	/* The rkmessage is destroyed automatically by librdkafka */
+	/*
+	 * The payload was produced without RD_KAFKA_MSG_F_COPY, so it is owned
+	 * by kafka_msg unless it was requeued above.
+	 * The rkmessage is destroyed automatically by librdkafka.
+	 */
+	_destroy_kafka_msg(kafka_msg);
 }
 
 /*
@@ -539,8 +543,8 @@ static int _unpack_jobcomp_kafka_msg(uint16_t protocol_version, buf_t *buffer)
 	safe_unpack32(&job_id, buffer);
 	safe_unpackstr(&payload, buffer);
 
+	/* Ownership of payload passes to the message. */
 	jobcomp_kafka_message_produce(job_id, payload);
-	xfree(payload);
 
 	return SLURM_SUCCESS;
 
@@ -639,19 +643,19 @@ extern void jobcomp_kafka_message_fini(void)
  * Attempt to produce a message in an asynchronous non-blocking way.
  *
  * IN: uint32_t job_id
- * IN: char *payload
+ * IN: char *payload - xmalloc()'d, ownership is taken by this function
  */
 extern void jobcomp_kafka_message_produce(uint32_t job_id, char *payload)
 {
-	uint32_t *opaque = NULL;
+	kafka_msg_t *opaque = NULL;
 	size_t len;
 	rd_kafka_resp_err_t err;
 
 	xassert(rk);
+	xassert(payload);
 
 	len = strlen(payload);
-	opaque = xmalloc(sizeof(*opaque));
-	*opaque = job_id;
+	opaque = _init_kafka_msg(job_id, payload);
 
 	slurm_rwlock_rdlock(&kafka_conf_rwlock);
 	/*
@@ -660,17 +664,19 @@ extern void jobcomp_kafka_message_produce(uint32_t job_id, char *payload)
 	 * 0. Producer handle.
 	 * 1. Topic name. librdkafka makes a copy, so after call it can be
 	 * freed.
-	 * 2. Flag to tell librdkafka to make copy of payload, so after call it
-	 * can be freed.
+	 * 2. No message flags. librdkafka references the payload in place
+	 * instead of copying it (RD_KAFKA_MSG_F_COPY), and does not free it
+	 * since it was allocated with xmalloc() (RD_KAFKA_MSG_F_FREE would
+	 * use free()).
 	 * 3. Message value (payload) and payload length.
 	 * 4. Per-message opaque (see _dr_msg_cb rd_kafka_message_t->_private).
-	 * Make a manual copy since librdkafka doesn't copy it.
-	 * xfree() _private at the end of callback.
+	 * It owns the payload, keeping it alive until the delivery report,
+	 * where it is either requeued or destroyed with _destroy_kafka_msg().
 	 * 5. End sentinel
 	 */
 	err = rd_kafka_producev(rk,
 				RD_KAFKA_V_TOPIC(kafka_conf->topic),
-				RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+				RD_KAFKA_V_MSGFLAGS(0),
 				RD_KAFKA_V_VALUE(payload, len),
 				RD_KAFKA_V_OPAQUE(opaque),
 				RD_KAFKA_V_END);
@@ -678,12 +684,12 @@ extern void jobcomp_kafka_message_produce(uint32_t job_id, char *payload)
 	if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
 		log_flag(JOBCOMP, "Produced JobId=%u message for topic '%s' to librdkafka queue.",
 			 job_id, kafka_conf->topic);
-		/* Do not xfree(opaque). Delivery msg callback will do it. */
+		/* Do not free opaque. Delivery msg callback will do it. */
 	} else {
 		error("%s: Failed to produce JobId=%u message for topic '%s': %s. Message discarded.",
 		      plugin_type, job_id, kafka_conf->topic,
 		      rd_kafka_err2str(err));
-		xfree(opaque);
+		_destroy_kafka_msg(opaque);
 	}
 	slurm_rwlock_unlock(&kafka_conf_rwlock);
 }
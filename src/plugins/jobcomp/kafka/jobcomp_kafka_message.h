@@ -45,6 +45,10 @@ typedef struct {
 
 extern int jobcomp_kafka_message_init(void);
 extern void jobcomp_kafka_message_fini(void);
+/*
+ * Takes ownership of the xmalloc()'d payload, which is handed to librdkafka
+ * without copying and released once its delivery report has been served.
+ */
 extern void jobcomp_kafka_message_produce(uint32_t job_id, char *payload);
 
 #endif
@@ -110,6 +110,7 @@ s_p_options_t pmix_options[] = {
 	{"PMIxDirectSameArch", S_P_BOOLEAN},
 	{"PMIxEnv", S_P_STRING},
 	{"PMIxFenceBarrier", S_P_BOOLEAN},
+	{"PMIxFenceRingMaxNodes", S_P_UINT32},
 	{"PMIxNetDevicesUCX", S_P_STRING},
 	{"PMIxTimeout", S_P_UINT32},
 	{"PMIxTlsUCX", S_P_STRING},
@@ -161,6 +162,8 @@ static void _init_pmix_conf(void)
 	slurm_pmix_conf.direct_samearch = false;
 	slurm_pmix_conf.env = NULL;
 	slurm_pmix_conf.fence_barrier = false;
+	slurm_pmix_conf.fence_ring_max_nodes =
+		PMIXP_FENCE_RING_MAX_NODES_DEFAULT;
 	slurm_pmix_conf.timeout = PMIXP_TIMEOUT_DEFAULT;
 	slurm_pmix_conf.ucx_netdevices = NULL;
 	slurm_pmix_conf.ucx_tls = NULL;
@@ -177,6 +180,8 @@ static void _reset_pmix_conf(void)
 	slurm_pmix_conf.direct_samearch = false;
 	xfree(slurm_pmix_conf.env);
 	slurm_pmix_conf.fence_barrier = false;
+	slurm_pmix_conf.fence_ring_max_nodes =
+		PMIXP_FENCE_RING_MAX_NODES_DEFAULT;
 	slurm_pmix_conf.timeout = PMIXP_TIMEOUT_DEFAULT;
 	xfree(slurm_pmix_conf.ucx_netdevices);
 	xfree(slurm_pmix_conf.ucx_tls);
@@ -340,6 +345,8 @@ extern void mpi_p_conf_set(s_p_hashtbl_t *tbl)
 		s_p_get_string(&slurm_pmix_conf.env, "PMIxEnv", tbl);
 		s_p_get_boolean(&slurm_pmix_conf.fence_barrier,
 				"PMIxFenceBarrier", tbl);
+		s_p_get_uint32(&slurm_pmix_conf.fence_ring_max_nodes,
+			       "PMIxFenceRingMaxNodes", tbl);
 		s_p_get_string(&slurm_pmix_conf.ucx_netdevices,
 			       "PMIxNetDevicesUCX", tbl);
 		s_p_get_uint32(&slurm_pmix_conf.timeout, "PMIxTimeout", tbl);
@@ -382,6 +389,10 @@ extern s_p_hashtbl_t *mpi_p_conf_get(void)
 	s_p_parse_pair(tbl, "PMIxFenceBarrier",
 		       (slurm_pmix_conf.fence_barrier ? "yes" : "no"));
 
+	value = xstrdup_printf("%u", slurm_pmix_conf.fence_ring_max_nodes);
+	s_p_parse_pair(tbl, "PMIxFenceRingMaxNodes", value);
+	xfree(value);
+
 	if (slurm_pmix_conf.ucx_netdevices)
 		s_p_parse_pair(tbl, "PMIxNetDevicesUCX",
 			       slurm_pmix_conf.ucx_netdevices);
@@ -449,6 +460,12 @@ extern List mpi_p_conf_get_printable(void)
 	key_pair->value = xstrdup(slurm_pmix_conf.fence_barrier ? "yes" : "no");
 	list_append(data, key_pair);
 
+	key_pair = xmalloc(sizeof(*key_pair));
+	key_pair->name = xstrdup("PMIxFenceRingMaxNodes");
+	key_pair->value = xstrdup_printf("%u",
+					 slurm_pmix_conf.fence_ring_max_nodes);
+	list_append(data, key_pair);
+
 	key_pair = xmalloc(sizeof(*key_pair));
 	key_pair->name = xstrdup("PMIxNetDevicesUCX");
 	key_pair->value = xstrdup(slurm_pmix_conf.ucx_netdevices);
@@ -750,7 +750,9 @@ extern int pmixp_lib_fence(const pmix_proc_t procs[], size_t nprocs,
 	 * is used the both fence algorithms */
 	pmixp_coll_type_t type = pmixp_info_srv_fence_coll_type();
 
-	if (PMIXP_COLL_TYPE_FENCE_MAX == type) {
+	if (PMIXP_COLL_CPERF_AUTO == type) {
+		type = pmixp_coll_auto_type(procs, nprocs, collect);
+	} else if (PMIXP_COLL_TYPE_FENCE_MAX == type) {
 		type = PMIXP_COLL_TYPE_FENCE_TREE;
 		/*
 		 * Practice shows the Tree algorithm has better performance
@@ -36,6 +36,7 @@
  \*****************************************************************************/
 
 #include "pmixp_common.h"
+#include "src/common/timers.h"
 #include "pmixp_coll.h"
 #include "pmixp_nspaces.h"
 #include "pmixp_client.h"
@@ -142,6 +143,41 @@ err_exit:
 	return SLURM_ERROR;
 }
 
+/*
+ * Pick the fence algorithm for PMIxCollFence=auto. Every node taking part
+ * must make the same choice, so only use what they all agree on: the number
+ * of nodes and whether data is collected, not the local payload size.
+ * The ring moves the least data but takes one step per node, so it only
+ * wins while the node count is small; beyond that the tree's logarithmic
+ * depth matters more.
+ */
+pmixp_coll_type_t pmixp_coll_auto_type(const pmix_proc_t *procs,
+				       size_t nprocs, bool collect)
+{
+	hostlist_t *hl;
+	int node_cnt;
+
+	if (!collect)
+		return PMIXP_COLL_TYPE_FENCE_TREE;
+
+	if (SLURM_SUCCESS != pmixp_hostset_from_ranges(procs, nprocs, &hl))
+		return PMIXP_COLL_TYPE_FENCE_TREE;
+	node_cnt = hostlist_count(hl);
+	hostlist_destroy(hl);
+
+	if (node_cnt <= pmixp_info_srv_fence_ring_max_nodes())
+		return PMIXP_COLL_TYPE_FENCE_RING;
+	return PMIXP_COLL_TYPE_FENCE_TREE;
+}
+
+/* Log how long the collective took since our local contribution */
+void pmixp_coll_log_done(pmixp_coll_t *coll, size_t size)
+{
+	PMIXP_DEBUG("%p: %s seq=%d peers=%d size=%lu completed in %d usec",
+		    coll, pmixp_coll_type2str(coll->type), coll->seq,
+		    coll->peers_cnt, size, slurm_delta_tv(&coll->ts_contrib));
+}
+
 int pmixp_coll_contrib_local(pmixp_coll_t *coll, pmixp_coll_type_t type,
 			     char *data, size_t ndata,
 			     void *cbfunc, void *cbdata) {
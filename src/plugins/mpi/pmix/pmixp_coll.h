@@ -38,6 +38,8 @@
 
 #ifndef PMIXP_COLL_H
 #define PMIXP_COLL_H
+#include <sys/time.h>
+
 #include "pmixp_common.h"
 #include "pmixp_debug.h"
 
@@ -72,7 +74,8 @@ typedef enum {
 	PMIXP_COLL_CPERF_TREE = PMIXP_COLL_TYPE_FENCE_TREE,
 	PMIXP_COLL_CPERF_RING = PMIXP_COLL_TYPE_FENCE_RING,
 	PMIXP_COLL_CPERF_MIXED = PMIXP_COLL_TYPE_FENCE_MAX,
-	PMIXP_COLL_CPERF_BARRIER
+	PMIXP_COLL_CPERF_BARRIER,
+	PMIXP_COLL_CPERF_AUTO
 } pmixp_coll_cperf_mode_t;
 
 inline static char *
@@ -86,6 +89,8 @@ pmixp_coll_cperf_mode2str(pmixp_coll_cperf_mode_t mode) {
 		return "PMIXP_COLL_CPERF_MIXED";
 	case PMIXP_COLL_CPERF_BARRIER:
 		return "PMIXP_COLL_CPERF_BARRIER";
+	case PMIXP_COLL_CPERF_AUTO:
+		return "PMIXP_COLL_CPERF_AUTO";
 	default:
 		return "PMIXP_COLL_CPERF_UNK";
 	}
@@ -93,6 +98,8 @@ pmixp_coll_cperf_mode2str(pmixp_coll_cperf_mode_t mode) {
 
 int pmixp_hostset_from_ranges(const pmix_proc_t *procs, size_t nprocs,
 			      hostlist_t **hl_out);
+pmixp_coll_type_t pmixp_coll_auto_type(const pmix_proc_t *procs,
+				       size_t nprocs, bool collect);
 
 /* PMIx Tree collective */
 typedef enum {
@@ -283,6 +290,9 @@ typedef struct pmixp_coll_s {
 	/* timestamp for stale collectives detection */
 	time_t ts, ts_next;
 
+	/* time of the local contribution, for timing the collective */
+	struct timeval ts_contrib;
+
 	/* coll states */
 	union {
 		pmixp_coll_tree_t tree;
@@ -290,6 +300,8 @@ typedef struct pmixp_coll_s {
 	} state;
 } pmixp_coll_t;
 
+void pmixp_coll_log_done(pmixp_coll_t *coll, size_t size);
+
 /* tree coll functions*/
 int pmixp_coll_tree_init(pmixp_coll_t *coll, hostlist_t **hl);
 void pmixp_coll_tree_free(pmixp_coll_tree_t *tree);
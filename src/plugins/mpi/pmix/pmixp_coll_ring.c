@@ -354,6 +354,7 @@ static void _invoke_callback(pmixp_coll_ring_ctx_t *coll_ctx)
 	cbdata->coll_ctx = coll_ctx;
 	cbdata->buf = coll_ctx->ring_buf;
 	cbdata->seq = coll_ctx->seq;
+	pmixp_coll_log_done(coll, data_sz);
 	pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS,
 			       data, data_sz,
 			       coll->cbdata, _libpmix_cb, (void *)cbdata);
@@ -536,7 +537,7 @@ inline static int _pmixp_coll_contrib(pmixp_coll_ring_ctx_t *coll_ctx,
 	coll->ts = time(NULL);
 
 	/* save contribution */
-	if (try_grow_buf_remaining(coll_ctx->ring_buf, size))
+	if (pmixp_buf_reserve(coll_ctx->ring_buf, size))
 		return SLURM_ERROR;
 
 	data_ptr = get_buf_data(coll_ctx->ring_buf) +
@@ -574,6 +575,7 @@ int pmixp_coll_ring_local(pmixp_coll_t *coll, char *data, size_t size,
 	/* setup callback info */
 	coll->cbfunc = cbfunc;
 	coll->cbdata = cbdata;
+	gettimeofday(&coll->ts_contrib, NULL);
 
 	coll_ctx = pmixp_coll_ring_ctx_new(coll);
 	if (!coll_ctx) {
@@ -526,16 +526,18 @@ static int _progress_collect(pmixp_coll_t *coll)
 		PMIXP_DEBUG("%p: send data to %s:%d",
 			    coll, tree->prnt_host, tree->prnt_peerid);
 	} else {
-		/* move data from input buffer to the output */
-		char *dst, *src = get_buf_data(tree->ufwd_buf) +
-			tree->ufwd_offset;
-		size_t size = get_buf_offset(tree->ufwd_buf) -
-			tree->ufwd_offset;
-		if (try_grow_buf_remaining(tree->dfwd_buf, size))
-			return 0;
-		dst = get_buf_data(tree->dfwd_buf) + tree->dfwd_offset;
-		memcpy(dst, src, size);
-		set_buf_offset(tree->dfwd_buf, tree->dfwd_offset + size);
+		/*
+		 * Move data from input buffer to the output. Both buffers
+		 * carry the same service header, so hand the aggregated blob
+		 * over instead of copying it. The upward buffer is reset for
+		 * the next collective once we leave this state.
+		 */
+		buf_t *dfwd_buf = tree->dfwd_buf;
+
+		xassert(tree->ufwd_offset == tree->dfwd_offset);
+		xassert(get_buf_offset(dfwd_buf) == tree->dfwd_offset);
+		tree->dfwd_buf = tree->ufwd_buf;
+		tree->ufwd_buf = dfwd_buf;
 		/* no need to send */
 		tree->ufwd_status = PMIXP_COLL_TREE_SND_DONE;
 		/* this is root */
@@ -693,6 +695,7 @@ static int _progress_ufwd(pmixp_coll_t *coll)
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
 		tree->dfwd_cb_wait++;
+		pmixp_coll_log_done(coll, size);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS,
 				       data, size, coll->cbdata,
 				       _libpmix_cb, (void*)cbdata);
@@ -783,6 +786,7 @@ static int _progress_ufwd_wpc(pmixp_coll_t *coll)
 		char *data = get_buf_data(tree->dfwd_buf) + tree->dfwd_offset;
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
+		pmixp_coll_log_done(coll, size);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS, data, size,
 				       coll->cbdata, _libpmix_cb,
 				       (void *)cbdata);
@@ -960,7 +964,7 @@ int pmixp_coll_tree_local(pmixp_coll_t *coll, char *data, size_t size,
 
 	/* save & mark local contribution */
 	tree->contrib_local = true;
-	if ((ret = try_grow_buf_remaining(tree->ufwd_buf, size)))
+	if ((ret = pmixp_buf_reserve(tree->ufwd_buf, size)))
 		goto exit;
 	memcpy(get_buf_data(tree->ufwd_buf) + get_buf_offset(tree->ufwd_buf),
 	       data, size);
@@ -969,6 +973,7 @@ int pmixp_coll_tree_local(pmixp_coll_t *coll, char *data, size_t size,
 	/* setup callback info */
 	coll->cbfunc = cbfunc;
 	coll->cbdata = cbdata;
+	gettimeofday(&coll->ts_contrib, NULL);
 
 	/* check if the collective is ready to progress */
 	_progress_coll_tree(coll);
@@ -1117,7 +1122,7 @@ int pmixp_coll_tree_child(pmixp_coll_t *coll, uint32_t peerid, uint32_t seq,
 
 	data_src = get_buf_data(buf) + get_buf_offset(buf);
 	size = remaining_buf(buf);
-	if (try_grow_buf_remaining(tree->ufwd_buf, size))
+	if (pmixp_buf_reserve(tree->ufwd_buf, size))
 		goto error;
 	data_dst = get_buf_data(tree->ufwd_buf) +
 		get_buf_offset(tree->ufwd_buf);
@@ -1272,7 +1277,7 @@ int pmixp_coll_tree_parent(pmixp_coll_t *coll, uint32_t peerid, uint32_t seq,
 
 	data_src = get_buf_data(buf) + get_buf_offset(buf);
 	size = remaining_buf(buf);
-	if (try_grow_buf_remaining(tree->dfwd_buf, size))
+	if (pmixp_buf_reserve(tree->dfwd_buf, size))
 		goto error;
 	data_dst = get_buf_data(tree->dfwd_buf) +
 		get_buf_offset(tree->dfwd_buf);
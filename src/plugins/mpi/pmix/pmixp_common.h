@@ -104,6 +104,7 @@
 /* Setup communication timeout */
 #define PMIXP_TIMEOUT "SLURM_PMIX_TIMEOUT"
 #define PMIXP_TIMEOUT_DEFAULT 300
+#define PMIXP_FENCE_RING_MAX_NODES_DEFAULT 16
 
 /* setup path to the temp directory for usock files for:
  * - inter-stepd comunication;
@@ -164,8 +165,10 @@
 #define PMIXP_CPERF_LITER "SLURM_PMIX_COLL_PERF_ITER_LARGE"
 /* The bound after which message is considered large */
 #define PMIXP_CPERF_BOUND "SLURM_PMIX_COLL_PERF_LARGE_PWR2"
-/* The prefered fence type, values:[auto|tree|ring] */
+/* The prefered fence type, values:[auto|mixed|tree|ring] */
 #define PMIXP_COLL_FENCE "SLURM_PMIX_FENCE"
+/* Largest node count that uses the ring fence with PMIxCollFence=auto */
+#define PMIXP_COLL_FENCE_RING_MAX_NODES "SLURM_PMIX_FENCE_RING_MAX_NODES"
 #define SLURM_PMIXP_FENCE_BARRIER "SLURM_PMIX_FENCE_BARRIER"
 
 typedef enum {
@@ -218,6 +221,7 @@ typedef struct {
 	bool direct_samearch;
 	char *env;
 	bool fence_barrier;
+	uint32_t fence_ring_max_nodes;
 	uint32_t timeout;
 	char *ucx_netdevices;
 	char *ucx_tls;
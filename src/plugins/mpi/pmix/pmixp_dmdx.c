@@ -48,16 +48,20 @@ typedef enum {
 	DMDX_RESPONSE
 } dmdx_type_t;
 
+typedef struct {
+	void *cbfunc;
+	void *cbdata;
+} dmdx_waiter_t;
+
 typedef struct {
 	uint32_t seq_num;
 	time_t ts;
-#ifndef NDEBUG
-	/* we need this only for verification */
 	pmix_nspace_t nspace;
 	int rank;
-#endif
 	void *cbfunc;
 	void *cbdata;
+	/* later lookups of the same rank while this one is in flight */
+	List waiters;
 } dmdx_req_info_t;
 
 typedef struct {
@@ -82,13 +86,22 @@ void _dmdx_free_caddy(dmdx_caddy_t *caddy)
 
 static List _dmdx_requests;
 static uint32_t _dmdx_seq_num = 1;
+static pthread_mutex_t _dmdx_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void _dmdx_free_req(void *x)
+{
+	dmdx_req_info_t *req = x;
+
+	FREE_NULL_LIST(req->waiters);
+	xfree(req);
+}
 
 static void _respond_with_error(int seq_num, int nodeid,
 				char *sender_ns, int status);
 
 int pmixp_dmdx_init(void)
 {
-	_dmdx_requests = list_create(xfree_ptr);
+	_dmdx_requests = list_create(_dmdx_free_req);
 	_dmdx_seq_num = 1;
 	return SLURM_SUCCESS;
 }
@@ -230,15 +243,87 @@ static void _dmdx_pmix_cb(int status, char *data, size_t sz,
 	_dmdx_free_caddy(caddy);
 }
 
+static int _dmdx_req_cmp(void *x, void *key)
+{
+	dmdx_req_info_t *req = (dmdx_req_info_t *)x;
+	uint32_t seq_num = *((uint32_t *)key);
+	return (req->seq_num == seq_num);
+}
+
+/*
+ * Deliver a response to the request and everyone waiting on it, then free
+ * the request. libpmix releases the data of each delivery separately, so
+ * every extra waiter gets its own copy of the blob.
+ */
+static void _dmdx_invoke(dmdx_req_info_t *req, int status, char *data,
+			 uint32_t size, buf_t *buf)
+{
+	dmdx_waiter_t *waiter;
+
+	while (req->waiters && (waiter = list_pop(req->waiters))) {
+		if (data) {
+			buf_t *copy = create_buf(xmalloc(size), size);
+
+			memcpy(get_buf_data(copy), data, size);
+			pmixp_lib_modex_invoke(waiter->cbfunc, status,
+					       get_buf_data(copy), size,
+					       waiter->cbdata, pmixp_free_buf,
+					       (void *)copy);
+		} else {
+			pmixp_lib_modex_invoke(waiter->cbfunc, status, NULL, 0,
+					       waiter->cbdata, NULL, NULL);
+		}
+		xfree(waiter);
+	}
+
+	if (data)
+		pmixp_lib_modex_invoke(req->cbfunc, status, data, size,
+				       req->cbdata, pmixp_free_buf,
+				       (void *)buf);
+	else
+		pmixp_lib_modex_invoke(req->cbfunc, status, NULL, 0,
+				       req->cbdata, NULL, NULL);
+	_dmdx_free_req(req);
+}
+
+static int _dmdx_req_proc_cmp(void *x, void *key)
+{
+	dmdx_req_info_t *req = x, *want = key;
+
+	return ((req->rank == want->rank) &&
+		!xstrcmp(req->nspace, want->nspace));
+}
+
 int pmixp_dmdx_get(const pmix_nspace_t nspace, int rank,
 		   void *cbfunc, void *cbdata)
 {
-	dmdx_req_info_t *req;
+	dmdx_req_info_t *req, key;
 	buf_t *buf;
 	int rc;
 	uint32_t seq;
 	pmixp_ep_t ep;
 
+	/*
+	 * Lazy-connect runtimes can ask for the same remote rank from several
+	 * local clients at once. Piggyback on a request for that rank that is
+	 * already in flight rather than sending another one.
+	 */
+	strlcpy(key.nspace, nspace, sizeof(key.nspace));
+	key.rank = rank;
+	slurm_mutex_lock(&_dmdx_mutex);
+	if ((req = list_find_first(_dmdx_requests, _dmdx_req_proc_cmp,
+				   &key))) {
+		dmdx_waiter_t *waiter = xmalloc(sizeof(*waiter));
+
+		waiter->cbfunc = cbfunc;
+		waiter->cbdata = cbdata;
+		if (!req->waiters)
+			req->waiters = list_create(xfree_ptr);
+		list_append(req->waiters, waiter);
+		slurm_mutex_unlock(&_dmdx_mutex);
+		return SLURM_SUCCESS;
+	}
+
 	/* need to send the request */
 	ep.type = PMIXP_EP_NOIDEID;
 	ep.ep.nodeid = pmixp_nspace_resolve(nspace, rank);
@@ -256,11 +341,10 @@ int pmixp_dmdx_get(const pmix_nspace_t nspace, int rank,
 	req->cbfunc = cbfunc;
 	req->cbdata = cbdata;
 	req->ts = time(NULL);
-#ifndef NDEBUG
 	strlcpy(req->nspace, nspace, sizeof(req->nspace));
 	req->rank = rank;
-#endif
 	list_append(_dmdx_requests, req);
+	slurm_mutex_unlock(&_dmdx_mutex);
 
 	/* send the request */
 	rc = pmixp_server_send_nb(&ep, PMIXP_MSG_DMDX, seq, buf,
@@ -272,8 +356,11 @@ int pmixp_dmdx_get(const pmix_nspace_t nspace, int rank,
 		PMIXP_ERROR("Cannot send direct modex request to %s, size %d",
 			    nodename, get_buf_offset(buf));
 		xfree(nodename);
-		pmixp_lib_modex_invoke(cbfunc, SLURM_ERROR, NULL, 0,
-				       cbdata, NULL, NULL);
+		slurm_mutex_lock(&_dmdx_mutex);
+		req = list_remove_first(_dmdx_requests, _dmdx_req_cmp, &seq);
+		slurm_mutex_unlock(&_dmdx_mutex);
+		if (req)
+			_dmdx_invoke(req, SLURM_ERROR, NULL, 0, NULL);
 		rc = SLURM_ERROR;
 	}
 
@@ -357,13 +444,6 @@ exit:
 	 * anyway. We've notified libpmix, that's enough */
 }
 
-static int _dmdx_req_cmp(void *x, void *key)
-{
-	dmdx_req_info_t *req = (dmdx_req_info_t *)x;
-	uint32_t seq_num = *((uint32_t *)key);
-	return (req->seq_num == seq_num);
-}
-
 static void _dmdx_resp(buf_t *buf, int nodeid, uint32_t seq_num)
 {
 	dmdx_req_info_t *req;
@@ -374,14 +454,14 @@ static void _dmdx_resp(buf_t *buf, int nodeid, uint32_t seq_num)
 	uint32_t size = 0;
 
 	/* find the request tracker */
-	list_itr_t *it = list_iterator_create(_dmdx_requests);
-	req = (dmdx_req_info_t *)list_find(it, _dmdx_req_cmp, &seq_num);
+	slurm_mutex_lock(&_dmdx_mutex);
+	req = list_remove_first(_dmdx_requests, _dmdx_req_cmp, &seq_num);
+	slurm_mutex_unlock(&_dmdx_mutex);
 	if (NULL == req) {
 		char *nodename = pmixp_info_job_host(nodeid);
 		/* We haven't sent this request! */
 		PMIXP_ERROR("Received DMDX response with bad seq_num=%d from %s!",
 			    seq_num, nodename);
-		list_iterator_destroy(it);
 		rc = SLURM_ERROR;
 		xfree(nodename);
 		goto exit;
@@ -391,27 +471,19 @@ static void _dmdx_resp(buf_t *buf, int nodeid, uint32_t seq_num)
 	rc = _read_info(buf, &ns, &rank, &sender_ns, &status);
 	if (SLURM_SUCCESS != rc) {
 		/* notify libpmix about an error */
-		pmixp_lib_modex_invoke(req->cbfunc, SLURM_ERROR, NULL, 0,
-				       req->cbdata, NULL, NULL);
+		_dmdx_invoke(req, SLURM_ERROR, NULL, 0, NULL);
 		goto exit;
 	}
 
 	/* get the modex blob */
 	if (SLURM_SUCCESS != (rc = unpackmem_ptr(&data, &size, buf))) {
 		/* notify libpmix about an error */
-		pmixp_lib_modex_invoke(req->cbfunc, SLURM_ERROR, NULL, 0,
-				       req->cbdata, NULL, NULL);
+		_dmdx_invoke(req, SLURM_ERROR, NULL, 0, NULL);
 		goto exit;
 	}
 
-	/* call back to libpmix-server */
-	pmixp_lib_modex_invoke(req->cbfunc, status, data, size,
-			       req->cbdata, pmixp_free_buf, (void *)buf);
-
-	/* release tracker & list iterator */
-	req = NULL;
-	list_delete_item(it);
-	list_iterator_destroy(it);
+	/* call back to libpmix-server, this releases the tracker */
+	_dmdx_invoke(req, status, data, size, buf);
 exit:
 	if (SLURM_SUCCESS != rc) {
 		/* we are not expect libpmix to call the callback
@@ -443,35 +515,45 @@ void pmixp_dmdx_process(buf_t *buf, int nodeid, uint32_t seq)
 	}
 }
 
+static int _dmdx_req_stale(void *x, void *key)
+{
+	dmdx_req_info_t *req = x;
+	time_t ts = *(time_t *) key;
+
+	return ((ts - req->ts) > pmixp_info_timeout());
+}
+
 void pmixp_dmdx_timeout_cleanup(void)
 {
-	list_itr_t *it = list_iterator_create(_dmdx_requests);
+	List stale = list_create(NULL);
 	dmdx_req_info_t *req = NULL;
 	time_t ts = time(NULL);
 
+	/*
+	 * Pull stale requests out under the lock, libpmix callbacks may call
+	 * back into pmixp_dmdx_get().
+	 */
+	slurm_mutex_lock(&_dmdx_mutex);
+	while ((req = list_remove_first(_dmdx_requests, _dmdx_req_stale, &ts)))
+		list_append(stale, req);
+	slurm_mutex_unlock(&_dmdx_mutex);
+
 	/* run through all requests and discard stale one's */
-	while ((req = list_next(it))) {
-		if ((ts - req->ts) > pmixp_info_timeout()) {
+	while ((req = list_pop(stale))) {
 #ifndef NDEBUG
-			/* respond with the timeout to libpmix */
-			int nodeid = pmixp_nspace_resolve(req->nspace,
-							  req->rank);
-			char *nodename = pmixp_info_job_host(nodeid);
-			xassert(NULL != nodename);
-			PMIXP_ERROR("timeout: ns=%s, rank=%d, host=%s, ts=%lu",
-				    req->nspace, req->rank,
-				    (NULL != nodename) ? nodename : "unknown",
-				    ts);
-			if (NULL != nodename) {
-				xfree(nodename);
-			}
-#endif
-			/* PMIX_ERR_TIMEOUT */
-			pmixp_lib_modex_invoke(req->cbfunc, SLURM_ERROR, NULL, 0,
-					       req->cbdata, NULL, NULL);
-			/* release tracker & list iterator */
-			list_delete_item(it);
+		/* respond with the timeout to libpmix */
+		int nodeid = pmixp_nspace_resolve(req->nspace, req->rank);
+		char *nodename = pmixp_info_job_host(nodeid);
+		xassert(NULL != nodename);
+		PMIXP_ERROR("timeout: ns=%s, rank=%d, host=%s, ts=%lu",
+			    req->nspace, req->rank,
+			    (NULL != nodename) ? nodename : "unknown", ts);
+		if (NULL != nodename) {
+			xfree(nodename);
 		}
+#endif
+		/* PMIX_ERR_TIMEOUT */
+		_dmdx_invoke(req, SLURM_ERROR, NULL, 0, NULL);
 	}
-	list_iterator_destroy(it);
+	FREE_NULL_LIST(stale);
 }
@@ -57,6 +57,7 @@ static bool _srv_use_direct_conn_ucx = true;
 #endif
 static int _srv_fence_coll_type = PMIXP_COLL_TYPE_FENCE_MAX;
 static bool _srv_fence_coll_barrier = false;
+static int _srv_fence_ring_max_nodes = PMIXP_FENCE_RING_MAX_NODES_DEFAULT;
 
 pmix_jobinfo_t _pmixp_job_info;
 
@@ -122,6 +123,11 @@ bool pmixp_info_srv_fence_coll_barrier(void)
 	return _srv_fence_coll_barrier;
 }
 
+int pmixp_info_srv_fence_ring_max_nodes(void)
+{
+	return _srv_fence_ring_max_nodes;
+}
+
 /* Job information */
 int pmixp_info_set(const stepd_step_rec_t *step, char ***env)
 {
@@ -558,7 +564,9 @@ static int _env_set(const stepd_step_rec_t *step, char ***env)
 	if (!p)
 		p = slurm_pmix_conf.coll_fence;
 	if (p) {
-		if (!xstrcmp("mixed", p)) {
+		if (!xstrcmp("auto", p)) {
+			_srv_fence_coll_type = PMIXP_COLL_CPERF_AUTO;
+		} else if (!xstrcmp("mixed", p)) {
 			_srv_fence_coll_type = PMIXP_COLL_CPERF_MIXED;
 		} else if (!xstrcmp("tree", p)) {
 			_srv_fence_coll_type = PMIXP_COLL_CPERF_TREE;
@@ -567,6 +575,12 @@ static int _env_set(const stepd_step_rec_t *step, char ***env)
 		}
 	}
 
+	p = getenvp(*env, PMIXP_COLL_FENCE_RING_MAX_NODES);
+	if (p)
+		_srv_fence_ring_max_nodes = atoi(p);
+	else
+		_srv_fence_ring_max_nodes = slurm_pmix_conf.fence_ring_max_nodes;
+
 	p = getenvp(*env, SLURM_PMIXP_FENCE_BARRIER);
 	if (p) {
 		if (!xstrcmp("1",p) || !xstrcasecmp("true", p) ||
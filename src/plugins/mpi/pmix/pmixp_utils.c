@@ -80,6 +80,26 @@ void pmixp_free_buf(void *x)
 	FREE_NULL_BUFFER(buf);
 }
 
+/*
+ * Make room for size more bytes at the current offset of buf.
+ * Collective buffers are appended to once per contribution, so grow them
+ * geometrically: growing by exactly size would realloc and copy the whole
+ * accumulated blob for every node.
+ */
+int pmixp_buf_reserve(buf_t *buf, uint32_t size)
+{
+	uint32_t grow;
+
+	if (remaining_buf(buf) >= size)
+		return SLURM_SUCCESS;
+
+	grow = MAX(size - remaining_buf(buf), size_buf(buf));
+	if ((((uint64_t) size_buf(buf)) + grow) > MAX_BUF_SIZE)
+		grow = size - remaining_buf(buf);
+
+	return try_grow_buf(buf, grow);
+}
+
 int pmixp_usock_create_srv(char *path)
 {
 	static struct sockaddr_un sa;
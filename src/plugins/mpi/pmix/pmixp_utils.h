@@ -43,6 +43,7 @@
 extern int pmixp_count_digits_base10(uint32_t val);
 
 void pmixp_free_buf(void *x);
+int pmixp_buf_reserve(buf_t *buf, uint32_t size);
 int pmixp_usock_create_srv(char *path);
 size_t pmixp_read_buf(int fd, void *buf, size_t count, int *shutdown,
 		      bool blocking);
@@ -40,16 +40,42 @@
 #endif
 
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
 
+#include "src/common/timers.h"
+#include "src/common/xhash.h"
+
 #include "fair_tree.h"
 
+/* Accounts handed to a _calc_levels_worker() at a time */
+#define FT_LEVEL_CHUNK 16
+/* Smallest association count computed by more than one thread */
+#define FT_PARALLEL_MIN 1024
+
+/* Children of one account, with level_fs computed and sorted by it */
+typedef struct {
+	slurmdb_assoc_rec_t *assoc;
+	slurmdb_assoc_rec_t **children;	/* NULL terminated */
+	size_t child_cnt;
+} ft_level_t;
+
+typedef struct {
+	ft_level_t *levels;
+	size_t level_cnt;
+	pthread_mutex_t mutex;
+	size_t next_level;
+} ft_level_args_t;
+
+int fair_tree_threads = 0;
+
 static int  _ft_decay_apply_new_usage(job_record_t *job, time_t *start);
 static void _apply_priority_fs(void);
 
 /* Fair Tree code called from the decay thread loop */
 extern void fair_tree_decay(List jobs, time_t start)
 {
+	DEF_TIMERS;
 	slurmctld_lock_t job_write_lock =
 		{ NO_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK, NO_LOCK };
 	assoc_mgr_lock_t locks =
@@ -63,9 +89,17 @@ extern void fair_tree_decay(List jobs, time_t start)
 
 	/* calculate fs factor for associations */
 	assoc_mgr_lock(&locks);
+	START_TIMER;
 	_apply_priority_fs();
+	END_TIMER;
 	assoc_mgr_unlock(&locks);
 
+	slurmctld_diag_stats.fair_tree_cycle_counter++;
+	slurmctld_diag_stats.fair_tree_cycle_last = DELTA_TIMER;
+	slurmctld_diag_stats.fair_tree_cycle_sum += DELTA_TIMER;
+	if (DELTA_TIMER > slurmctld_diag_stats.fair_tree_cycle_max)
+		slurmctld_diag_stats.fair_tree_cycle_max = DELTA_TIMER;
+
 	/* assign job priorities */
 	lock_slurmctld(job_write_lock);
 	list_for_each(jobs, (ListForF) decay_apply_weighted_factors, &start);
@@ -323,10 +357,13 @@ static slurmdb_assoc_rec_t** _merge_accounts(
  * IN/OUT rank - current user ranking, starting at g_user_assoc_count
  * IN/OUT rnt - rank, no ties (what rank would be if no tie exists)
  * IN account_tied - is this account tied with the previous user
+ * IN levels - presorted children of each account, NULL to sort here
+ * IN sorted - siblings already have level_fs set and are sorted by it
  */
 static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 			  uint16_t assoc_level, uint32_t *rank,
-			  uint32_t *rnt, bool account_tied)
+			  uint32_t *rnt, bool account_tied,
+			  xhash_t *levels, bool sorted)
 {
 	slurmdb_assoc_rec_t *assoc = NULL;
 	long double prev_level_fs = (long double) NO_VAL;
@@ -339,12 +376,15 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 		return;
 	}
 
-	/* Calculate level_fs for each child */
-	for (i = 0; (assoc = siblings[i]); i++)
-		_calc_assoc_fs(assoc);
+	if (!sorted) {
+		/* Calculate level_fs for each child */
+		for (i = 0; (assoc = siblings[i]); i++)
+			_calc_assoc_fs(assoc);
 
-	/* Sort children by level_fs */
-	qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
+		/* Sort children by level_fs */
+		qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *),
+		      _cmp_level_fs);
+	}
 
 	/* Iterate through children in sorted order. If it's a user, calculate
 	 * fs_factor, otherwise recurse. */
@@ -376,6 +416,19 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 		} else {
 			slurmdb_assoc_rec_t** children;
 			size_t merge_count = _count_tied_accounts(siblings, i);
+			ft_level_t *level = NULL;
+
+			/* An account that is not merged with any other can use
+			 * its presorted children */
+			if (levels && !merge_count)
+				level = xhash_get(levels, (char *) &assoc,
+						  sizeof(assoc));
+			if (level) {
+				_calc_tree_fs(level->children, assoc_level+1,
+					      rank, rnt, tied, levels, true);
+				prev_level_fs = assoc->usage->level_fs;
+				continue;
+			}
 
 			/* Merging does not affect child level_fs calculations
 			 * since the necessary information is stored on each
@@ -385,7 +438,7 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 						   assoc_level);
 
 			_calc_tree_fs(children, assoc_level+1,
-				      rank, rnt, tied);
+				      rank, rnt, tied, levels, false);
 
 			/* Skip over any merged accounts */
 			i += merge_count;
@@ -398,6 +451,106 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 }
 
 
+static void _ft_level_id(void *item, const char **key, uint32_t *key_len)
+{
+	ft_level_t *level = item;
+
+	*key = (const char *) &level->assoc;
+	*key_len = sizeof(level->assoc);
+}
+
+/*
+ * Calculate level_fs for the children of chunks of accounts and sort them
+ * until no accounts are left. Each association is the child of exactly one
+ * account, so every thread only writes the usage of its own children.
+ */
+static void *_calc_levels_worker(void *arg)
+{
+	ft_level_args_t *args = arg;
+	size_t i, i_end;
+
+	while (true) {
+		slurm_mutex_lock(&args->mutex);
+		i = args->next_level;
+		args->next_level += FT_LEVEL_CHUNK;
+		slurm_mutex_unlock(&args->mutex);
+		if (i >= args->level_cnt)
+			break;
+
+		i_end = MIN(i + FT_LEVEL_CHUNK, args->level_cnt);
+		for (; i < i_end; i++) {
+			ft_level_t *level = &args->levels[i];
+
+			for (size_t j = 0; j < level->child_cnt; j++)
+				_calc_assoc_fs(level->children[j]);
+			qsort(level->children, level->child_cnt,
+			      sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Collect the children of every account, starting at root, then calculate
+ * and sort every level with up to fair_tree_threads threads.
+ * OUT level_cnt - number of accounts with children
+ * RET array of levels, the first one being root. Must be freed.
+ */
+static ft_level_t *_calc_levels(size_t *level_cnt)
+{
+	ft_level_args_t args = { 0 };
+	pthread_t threads[FAIR_TREE_THREADS_MAX];
+	size_t level_size = 16, assoc_cnt = 0;
+	int thread_cnt = 1;
+
+	args.levels = xcalloc(level_size, sizeof(ft_level_t));
+	args.levels[0].assoc = assoc_mgr_root_assoc;
+	args.level_cnt = 1;
+
+	/* Breadth first, so levels only grows behind the current index */
+	for (size_t i = 0; i < args.level_cnt; i++) {
+		slurmdb_assoc_rec_t **children = NULL;
+		size_t child_cnt = 0;
+
+		children = _append_list_to_array(
+			args.levels[i].assoc->usage->children_list,
+			children, &child_cnt);
+		args.levels[i].children = children;
+		args.levels[i].child_cnt = child_cnt;
+		assoc_cnt += child_cnt;
+
+		for (size_t j = 0; j < child_cnt; j++) {
+			List grandchildren = children[j]->usage->children_list;
+
+			if (children[j]->user || !grandchildren ||
+			    list_is_empty(grandchildren))
+				continue;
+			if (args.level_cnt == level_size) {
+				level_size *= 2;
+				xrecalloc(args.levels, level_size,
+					  sizeof(ft_level_t));
+			}
+			args.levels[args.level_cnt++].assoc = children[j];
+		}
+	}
+
+	if (assoc_cnt >= FT_PARALLEL_MIN)
+		thread_cnt = MIN(fair_tree_threads, args.level_cnt);
+
+	slurm_mutex_init(&args.mutex);
+	/* The calling thread is one of the workers */
+	for (int t = 1; t < thread_cnt; t++)
+		slurm_thread_create(&threads[t], _calc_levels_worker, &args);
+	_calc_levels_worker(&args);
+	for (int t = 1; t < thread_cnt; t++)
+		slurm_thread_join(threads[t]);
+	slurm_mutex_destroy(&args.mutex);
+
+	*level_cnt = args.level_cnt;
+	return args.levels;
+}
+
 /* Start fairshare calculations at root. Call assoc_mgr_lock before this. */
 static void _apply_priority_fs(void)
 {
@@ -405,6 +558,9 @@ static void _apply_priority_fs(void)
 	uint32_t rank = g_user_assoc_count;
 	uint32_t rnt = rank;
 	size_t child_count = 0;
+	ft_level_t *levels;
+	size_t level_cnt = 0;
+	xhash_t *level_table;
 
 	log_flag(PRIO, "Fair Tree fairshare algorithm, starting at root:");
 
@@ -413,13 +569,33 @@ static void _apply_priority_fs(void)
 
 	assoc_mgr_root_assoc->usage->level_fs = (long double) NO_VAL;
 
-	/* _calc_tree_fs requires an array instead of List */
-	children = _append_list_to_array(
-		assoc_mgr_root_assoc->usage->children_list,
-		children,
-		&child_count);
+	if (fair_tree_threads <= 1) {
+		/* _calc_tree_fs requires an array instead of List */
+		children = _append_list_to_array(
+			assoc_mgr_root_assoc->usage->children_list,
+			children,
+			&child_count);
 
-	_calc_tree_fs(children, 0, &rank, &rnt, false);
+		_calc_tree_fs(children, 0, &rank, &rnt, false, NULL, false);
 
-	xfree(children);
+		xfree(children);
+		return;
+	}
+
+	/*
+	 * Every level is calculated and sorted up front, only the ranking
+	 * walk below has to be done in tree order.
+	 */
+	levels = _calc_levels(&level_cnt);
+	level_table = xhash_init(_ft_level_id, NULL);
+	for (size_t i = 1; i < level_cnt; i++)
+		xhash_add(level_table, &levels[i]);
+
+	_calc_tree_fs(levels[0].children, 0, &rank, &rnt, false, level_table,
+		      true);
+
+	xhash_free(level_table);
+	for (size_t i = 0; i < level_cnt; i++)
+		xfree(levels[i].children);
+	xfree(levels);
 }
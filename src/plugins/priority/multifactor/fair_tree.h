@@ -40,6 +40,12 @@
 
 #include "priority_multifactor.h"
 
+/* Maximum value of PriorityParameters=fair_tree_threads */
+#define FAIR_TREE_THREADS_MAX 64
+
+/* Threads used to calculate the Fair Tree levels, set by _internal_setup() */
+extern int fair_tree_threads;
+
 /* Fair Tree code called from the decay thread loop */
 extern void fair_tree_decay(List jobs, time_t start);
 
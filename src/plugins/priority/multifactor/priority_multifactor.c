@@ -90,6 +90,7 @@ extern slurm_conf_t slurm_conf __attribute__((weak_import));
 extern int slurmctld_tres_cnt __attribute__((weak_import));
 extern uint16_t accounting_enforce __attribute__((weak_import));
 extern int active_node_record_count __attribute__((weak_import));
+extern diag_stats_t slurmctld_diag_stats __attribute__((weak_import));
 #else
 void *acct_db_conn = NULL;
 uint32_t cluster_cpus = NO_VAL;
@@ -100,6 +101,7 @@ slurm_conf_t slurm_conf;
 int slurmctld_tres_cnt = 0;
 uint16_t accounting_enforce = 0;
 int active_node_record_count;
+diag_stats_t slurmctld_diag_stats;
 #endif
 
 /*
@@ -151,22 +153,22 @@ static time_t g_last_ran = 0; /* when the last poll ran */
 static time_t g_last_reset = 0; /* when the last reset was done */
 static double decay_factor = 1; /* The decay factor when decaying time. */
 
+/*
+ * State used to decide whether a decay pass may reuse the job size, partition
+ * and TRES factors computed during the previous pass.
+ */
+static bool prio_recalc_all = true;	/* force full recalculation */
+static bool prio_full_pass = true;	/* current pass is a full one */
+static time_t prio_pass_start = 0;	/* start_time of current pass */
+static time_t prio_part_update = 0;	/* last_part_update of last pass */
+static uint32_t prio_cluster_cpus = 0;	/* cluster_cpus of last pass */
+static int prio_node_cnt = 0;		/* active_node_record_count */
+
 /* variables defined in priority_multifactor.h */
 
 static void _priority_p_set_assoc_usage_debug(slurmdb_assoc_rec_t *assoc);
 static void _set_assoc_usage_efctv(slurmdb_assoc_rec_t *assoc);
 
-static void _destroy_priority_factors_obj_light(void *object)
-{
-	priority_factors_object_t *obj_ptr = object;
-
-	if (!obj_ptr)
-		return;
-
-	slurm_destroy_priority_factors(obj_ptr->prio_factors);
-	xfree(obj_ptr);
-}
-
 /*
  * apply decay factor to all associations usage_raw
  * IN: real_decay - decay to be applied to each associations' used
@@ -431,25 +433,21 @@ static int _set_children_usage_efctv(List children_list)
 
 
 /* job_ptr should already have the partition priority and such added here
- * before had we will be adding to it
+ * before had we will be adding to it.
+ * Call with assoc_mgr assoc read lock held.
  */
-static double _get_fairshare_priority(job_record_t *job_ptr)
+static double _get_fairshare_priority_locked(job_record_t *job_ptr)
 {
 	slurmdb_assoc_rec_t *job_assoc;
 	slurmdb_assoc_rec_t *fs_assoc = NULL;
 	double priority_fs = 0.0;
-	assoc_mgr_lock_t locks = { READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
-				   NO_LOCK, NO_LOCK, NO_LOCK };
 
 	if (!calc_fairshare)
 		return 0;
 
-	assoc_mgr_lock(&locks);
-
 	job_assoc = job_ptr->assoc_ptr;
 
 	if (!job_assoc) {
-		assoc_mgr_unlock(&locks);
 		error("Job %u has no association.  Unable to "
 		      "compute fairshare.", job_ptr->job_id);
 		return 0;
@@ -479,11 +477,63 @@ static double _get_fairshare_priority(job_record_t *job_ptr)
 			 fs_assoc->usage->usage_efctv,
 			 fs_assoc->usage->shares_norm, priority_fs);
 	}
+
+	return priority_fs;
+}
+
+static double _get_fairshare_priority(job_record_t *job_ptr)
+{
+	double priority_fs;
+	assoc_mgr_lock_t locks = { READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
+				   NO_LOCK, NO_LOCK, NO_LOCK };
+
+	if (!calc_fairshare)
+		return 0;
+
+	assoc_mgr_lock(&locks);
+	priority_fs = _get_fairshare_priority_locked(job_ptr);
 	assoc_mgr_unlock(&locks);
 
 	return priority_fs;
 }
 
+static double _get_age_factor(time_t start_time, job_record_t *job_ptr)
+{
+	uint32_t diff = 0;
+
+	if (!weight_age || !job_ptr->details->accrue_time)
+		return 0.0;
+
+	/*
+	 * Only really add an age priority if the
+	 * job_ptr->details->accrue_time is past the start_time.
+	 */
+	if (start_time > job_ptr->details->accrue_time)
+		diff = start_time - job_ptr->details->accrue_time;
+
+	if (diff < max_age)
+		return (double)diff / (double)max_age;
+	return 1.0;
+}
+
+/* Call with assoc_mgr assoc and qos read locks held */
+static void _set_assoc_qos_factors(job_record_t *job_ptr,
+				   priority_factors_t *factors)
+{
+	if (job_ptr->assoc_ptr && weight_assoc)
+		factors->priority_assoc =
+			(flags & PRIORITY_FLAGS_NO_NORMAL_ASSOC) ?
+			job_ptr->assoc_ptr->priority :
+			job_ptr->assoc_ptr->usage->priority_norm;
+
+	if (job_ptr->qos_ptr && job_ptr->qos_ptr->priority && weight_qos) {
+		factors->priority_qos =
+			(flags & PRIORITY_FLAGS_NO_NORMAL_QOS) ?
+			job_ptr->qos_ptr->priority :
+			job_ptr->qos_ptr->usage->norm_priority;
+	}
+}
+
 static void _get_tres_factors(job_record_t *job_ptr, part_record_t *part_ptr,
 			      double *tres_factors)
 {
@@ -600,15 +650,63 @@ static int _priority_each_partition(void *object, void *arg)
 }
 
 
+/* Sum the weighted factors of a job, clamped to the valid priority range */
+static double _sum_priority_factors(job_record_t *job_ptr, double tmp_tres)
+{
+	double priority;
+	uint64_t tmp_64;
+
+	priority = job_ptr->prio_factors->priority_age
+		+ job_ptr->prio_factors->priority_assoc
+		+ job_ptr->prio_factors->priority_fs
+		+ job_ptr->prio_factors->priority_js
+		+ job_ptr->prio_factors->priority_part
+		+ job_ptr->prio_factors->priority_qos
+		+ tmp_tres
+		+ (double)(((int64_t)job_ptr->prio_factors->priority_site)
+			   - NICE_OFFSET)
+		- (double)(((int64_t)job_ptr->prio_factors->nice)
+			   - NICE_OFFSET);
+
+	/* Priority 0 is reserved for held jobs */
+	if (priority < 1)
+		priority = 1;
+
+	tmp_64 = (uint64_t) priority;
+	if (tmp_64 > 0xffffffff) {
+		error("%pJ priority '%"PRIu64"' exceeds 32 bits. Reducing it to 4294967295 (2^32 - 1)",
+		      job_ptr, tmp_64);
+		tmp_64 = 0xffffffff;
+		priority = (double) tmp_64;
+	}
+
+	return priority;
+}
+
+/* Refresh the per-partition priorities of a multi-partition job */
+static void _set_part_priorities(job_record_t *job_ptr)
+{
+	int i = 0;
+	char *multi_part_str = NULL;
+	part_prio_args_t arg;
+
+	arg.job_ptr = job_ptr,
+	arg.multi_part_str = multi_part_str,
+	arg.counter = &i,
+	list_for_each(job_ptr->part_ptr_list, _priority_each_partition, &arg);
+
+	log_flag(PRIO, "%pJ multi-partition priorities: %s",
+		 job_ptr, multi_part_str);
+	xfree(multi_part_str);
+}
+
 /* Returns the priority after applying the weight factors */
 static uint32_t _get_priority_internal(time_t start_time,
 				       job_record_t *job_ptr)
 {
 	double priority	= 0.0;
 	priority_factors_t pre_factors;
-	uint64_t tmp_64;
 	double tmp_tres = 0.0;
-	char *multi_part_str = NULL;
 
 	if (job_ptr->direct_set_prio && (job_ptr->priority > 0)) {
 		if (job_ptr->prio_factors) {
@@ -661,29 +759,7 @@ static uint32_t _get_priority_internal(time_t start_time,
 		tmp_tres = _get_tres_prio_weighted(tres_factors);
 	}
 
-	priority = job_ptr->prio_factors->priority_age
-		+ job_ptr->prio_factors->priority_assoc
-		+ job_ptr->prio_factors->priority_fs
-		+ job_ptr->prio_factors->priority_js
-		+ job_ptr->prio_factors->priority_part
-		+ job_ptr->prio_factors->priority_qos
-		+ tmp_tres
-		+ (double)(((int64_t)job_ptr->prio_factors->priority_site)
-			   - NICE_OFFSET)
-		- (double)(((int64_t)job_ptr->prio_factors->nice)
-			   - NICE_OFFSET);
-
-	/* Priority 0 is reserved for held jobs */
-	if (priority < 1)
-		priority = 1;
-
-	tmp_64 = (uint64_t) priority;
-	if (tmp_64 > 0xffffffff) {
-		error("%pJ priority '%"PRIu64"' exceeds 32 bits. Reducing it to 4294967295 (2^32 - 1)",
-		      job_ptr, tmp_64);
-		tmp_64 = 0xffffffff;
-		priority = (double) tmp_64;
-	}
+	priority = _sum_priority_factors(job_ptr, tmp_tres);
 
 	/* Free after transitioning from multi-part job to single part job. */
 	if (!job_ptr->part_ptr_list && job_ptr->part_prio) {
@@ -694,7 +770,6 @@ static uint32_t _get_priority_internal(time_t start_time,
 
 	if (job_ptr->part_ptr_list) {
 		int i = 0;
-		part_prio_args_t arg;
 
 		if (!job_ptr->part_prio)
 			job_ptr->part_prio = xmalloc(sizeof(priority_parts_t));
@@ -717,16 +792,7 @@ static uint32_t _get_priority_internal(time_t start_time,
 			job_ptr->part_prio->last_update = time(NULL);
 		}
 
-		i = 0;
-		arg.job_ptr = job_ptr,
-		arg.multi_part_str = multi_part_str,
-		arg.counter = &i,
-		list_for_each(job_ptr->part_ptr_list, _priority_each_partition,
-			      &arg);
-
-		log_flag(PRIO, "%pJ multi-partition priorities: %s",
-			 job_ptr, multi_part_str);
-		xfree(multi_part_str);
+		_set_part_priorities(job_ptr);
 	}
 
 	if (slurm_conf.debug_flags & DEBUG_FLAG_PRIO) {
@@ -791,6 +857,103 @@ static uint32_t _get_priority_internal(time_t start_time,
 	return (uint32_t)priority;
 }
 
+/*
+ * Refresh only the factors which can change without the job being updated
+ * (age, fairshare, association, QOS, site and nice) and reuse the weighted
+ * job size, partition and TRES factors from the previous calculation. Those
+ * only change when the job is updated, which recalculates its priority, or
+ * when a partition, the node count or the weights change, which forces a full
+ * pass.
+ *
+ * RET true if new_prio was set, false if a full recalculation is needed
+ */
+static bool _get_priority_incr(time_t start_time, job_record_t *job_ptr,
+			       uint32_t *new_prio)
+{
+	priority_factors_t *factors = job_ptr->prio_factors;
+	priority_factors_t fresh = { 0 };
+	double tmp_tres = 0.0;
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .qos = READ_LOCK };
+
+	if (prio_full_pass || !factors || !job_ptr->details ||
+	    !IS_JOB_PENDING(job_ptr) || job_ptr->direct_set_prio ||
+	    (slurm_conf.debug_flags & DEBUG_FLAG_PRIO))
+		return false;
+
+	if (weight_tres && (!factors->priority_tres ||
+			    (factors->tres_cnt != slurmctld_tres_cnt)))
+		return false;
+
+	if (job_ptr->part_ptr_list &&
+	    (!job_ptr->part_prio || !job_ptr->part_prio->priority_array ||
+	     (job_ptr->part_prio->last_update < last_part_update)))
+		return false;
+
+	fresh.priority_age = _get_age_factor(start_time, job_ptr) *
+			     (double)weight_age;
+	fresh.priority_site = job_ptr->site_factor;
+	fresh.nice = job_ptr->details->nice;
+
+	assoc_mgr_lock(&locks);
+	if (job_ptr->assoc_ptr && weight_fs)
+		fresh.priority_fs = _get_fairshare_priority_locked(job_ptr);
+	_set_assoc_qos_factors(job_ptr, &fresh);
+	assoc_mgr_unlock(&locks);
+
+	fresh.priority_fs *= (double)weight_fs;
+	fresh.priority_assoc *= (double)weight_assoc;
+	fresh.priority_qos *= (double)weight_qos;
+
+	if ((fresh.priority_age == factors->priority_age) &&
+	    (fresh.priority_fs == factors->priority_fs) &&
+	    (fresh.priority_assoc == factors->priority_assoc) &&
+	    (fresh.priority_qos == factors->priority_qos) &&
+	    (fresh.priority_site == factors->priority_site) &&
+	    (fresh.nice == factors->nice)) {
+		*new_prio = job_ptr->priority;
+		return true;
+	}
+
+	factors->priority_age = fresh.priority_age;
+	factors->priority_fs = fresh.priority_fs;
+	factors->priority_assoc = fresh.priority_assoc;
+	factors->priority_qos = fresh.priority_qos;
+	factors->priority_site = fresh.priority_site;
+	factors->nice = fresh.nice;
+
+	/* priority_tres already holds the weighted TRES factors */
+	if (weight_tres) {
+		for (int i = 0; i < slurmctld_tres_cnt; i++)
+			tmp_tres += factors->priority_tres[i];
+	}
+
+	*new_prio = (uint32_t) _sum_priority_factors(job_ptr, tmp_tres);
+
+	if (job_ptr->part_ptr_list)
+		_set_part_priorities(job_ptr);
+
+	return true;
+}
+
+/*
+ * Decide at the start of each pass whether the factors kept from the previous
+ * pass may be reused.
+ */
+static void _check_prio_pass(time_t start_time)
+{
+	if (start_time == prio_pass_start)
+		return;
+
+	prio_pass_start = start_time;
+	prio_full_pass = (prio_recalc_all ||
+			  (prio_part_update != last_part_update) ||
+			  (prio_cluster_cpus != cluster_cpus) ||
+			  (prio_node_cnt != active_node_record_count));
+	prio_recalc_all = false;
+	prio_part_update = last_part_update;
+	prio_cluster_cpus = cluster_cpus;
+	prio_node_cnt = active_node_record_count;
+}
 
 /* based upon the last reset time, compute when the next reset should be */
 static time_t _next_reset(uint16_t reset_period, time_t last_reset)
@@ -1464,14 +1627,14 @@ static priority_factors_object_t *_create_prio_factors_obj(
 		xmalloc(sizeof(priority_factors_object_t));
 
 	/*
-	 * Don't xstrdup dup anything here, the list is freed
-	 * with _destroy_priority_factors_obj_light.
+	 * The object must not reference the job record, the response is sent
+	 * after the job and partition locks have been released.
 	 */
-	obj->account = job_ptr->account;
+	obj->account = xstrdup(job_ptr->account);
 	obj->job_id = job_ptr->job_id;
-	obj->partition = job_part_ptr ?
-		job_part_ptr->name : job_ptr->part_ptr->name;
-	obj->qos = job_ptr->qos_ptr ? job_ptr->qos_ptr->name : NULL;
+	obj->partition = xstrdup(job_part_ptr ?
+				 job_part_ptr->name : job_ptr->part_ptr->name);
+	obj->qos = job_ptr->qos_ptr ? xstrdup(job_ptr->qos_ptr->name) : NULL;
 	obj->user_id = job_ptr->user_id;
 
 	if (job_ptr->direct_set_prio) {
@@ -1503,6 +1666,8 @@ static priority_factors_object_t *_create_prio_factors_obj(
 
 static void _internal_setup(void)
 {
+	char *tmp_ptr;
+
 	damp_factor = (long double) slurm_conf.fs_dampening_factor;
 	max_age = slurm_conf.priority_max_age;
 	weight_age = slurm_conf.priority_weight_age;
@@ -1516,6 +1681,18 @@ static void _internal_setup(void)
 		slurm_conf.priority_weight_tres, slurmctld_tres_cnt, true);
 	flags = slurm_conf.priority_flags;
 
+	fair_tree_threads = 0;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.priority_params,
+				   "fair_tree_threads="))) {
+		fair_tree_threads = atoi(tmp_ptr + 18);
+		if ((fair_tree_threads < 0) ||
+		    (fair_tree_threads > FAIR_TREE_THREADS_MAX)) {
+			error("Invalid PriorityParameters fair_tree_threads: %d",
+			      fair_tree_threads);
+			fair_tree_threads = 0;	/* Use default value */
+		}
+	}
+
 	log_flag(PRIO, "priority: Damp Factor is %u", damp_factor);
 	log_flag(PRIO, "priority: AccountingStorageEnforce is %u",
 		 slurm_conf.accounting_storage_enforce);
@@ -1527,6 +1704,7 @@ static void _internal_setup(void)
 	log_flag(PRIO, "priority: Weight Part is %u", weight_part);
 	log_flag(PRIO, "priority: Weight QOS is %u", weight_qos);
 	log_flag(PRIO, "priority: Flags is %u", flags);
+	log_flag(PRIO, "priority: Fair Tree threads is %d", fair_tree_threads);
 }
 
 
@@ -1820,6 +1998,7 @@ extern void priority_p_reconfig(bool assoc_clear)
 				   NO_LOCK, NO_LOCK, NO_LOCK };
 
 	reconfig = 1;
+	prio_recalc_all = true;
 	_internal_setup();
 
 	/* Since Fair Tree uses a different shares calculation method, we
@@ -1915,7 +2094,7 @@ extern List priority_p_get_priority_factors_list(uid_t uid)
 	if (job_list && list_count(job_list)) {
 		time_t use_time;
 
-		ret_list = list_create(_destroy_priority_factors_obj_light);
+		ret_list = list_create(slurm_destroy_priority_factors_object);
 		itr = list_iterator_create(job_list);
 		while ((job_ptr = list_next(itr))) {
 			if (!(flags & PRIORITY_FLAGS_CALCULATE_RUNNING) &&
@@ -2037,9 +2216,12 @@ extern int decay_apply_weighted_factors(job_record_t *job_ptr,
 	     !(flags & PRIORITY_FLAGS_CALCULATE_RUNNING)))
 		return SLURM_SUCCESS;
 
-	new_prio = _get_priority_internal(*start_time_ptr, job_ptr);
-	if (((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
-	    (job_ptr->priority < new_prio)) {
+	_check_prio_pass(*start_time_ptr);
+	if (!_get_priority_incr(*start_time_ptr, job_ptr, &new_prio))
+		new_prio = _get_priority_internal(*start_time_ptr, job_ptr);
+	if ((job_ptr->priority != new_prio) &&
+	    (((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
+	     (job_ptr->priority < new_prio))) {
 		job_ptr->priority = new_prio;
 		last_job_update = time(NULL);
 	}
@@ -2088,22 +2270,8 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 		memset(job_ptr->prio_factors, 0, sizeof(priority_factors_t));
 	}
 
-	if (weight_age && job_ptr->details->accrue_time) {
-		uint32_t diff = 0;
-
-		/*
-		 * Only really add an age priority if the
-		 * job_ptr->details->accrue_time is past the start_time.
-		 */
-		if (start_time > job_ptr->details->accrue_time)
-			diff = start_time - job_ptr->details->accrue_time;
-
-		if (diff < max_age)
-			job_ptr->prio_factors->priority_age =
-				(double)diff / (double)max_age;
-		else
-			job_ptr->prio_factors->priority_age = 1.0;
-	}
+	job_ptr->prio_factors->priority_age =
+		_get_age_factor(start_time, job_ptr);
 
 	if (job_ptr->assoc_ptr && weight_fs) {
 		job_ptr->prio_factors->priority_fs =
@@ -2192,18 +2360,7 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 	job_ptr->prio_factors->priority_site = job_ptr->site_factor;
 
 	assoc_mgr_lock(&locks);
-	if (job_ptr->assoc_ptr && weight_assoc)
-		job_ptr->prio_factors->priority_assoc =
-			(flags & PRIORITY_FLAGS_NO_NORMAL_ASSOC) ?
-			job_ptr->assoc_ptr->priority :
-			job_ptr->assoc_ptr->usage->priority_norm;
-
-	if (job_ptr->qos_ptr && job_ptr->qos_ptr->priority && weight_qos) {
-		job_ptr->prio_factors->priority_qos =
-			(flags & PRIORITY_FLAGS_NO_NORMAL_QOS) ?
-			job_ptr->qos_ptr->priority :
-			job_ptr->qos_ptr->usage->norm_priority;
-	}
+	_set_assoc_qos_factors(job_ptr, job_ptr->prio_factors);
 	assoc_mgr_unlock(&locks);
 
 	if (job_ptr->details)
@@ -180,6 +180,16 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 	int i;
 	int slurm_task;
 
+	/*
+	 * Start by resuming in case of SIGKILL. When supported, kill the whole
+	 * step atomically first, so the pid list below only holds stragglers
+	 * (e.g. processes not yet moved out of the slurm cgroup).
+	 */
+	if (signal == SIGKILL) {
+		cgroup_g_step_resume();
+		cgroup_g_step_kill();
+	}
+
 	/* get all the pids associated with the step */
 	if (cgroup_g_step_get_pids(&pids, &npids) != SLURM_SUCCESS) {
 		debug3("unable to get pids list for cont_id=%"PRIu64"", id);
@@ -194,11 +204,6 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 		return cgroup_g_step_suspend();
 	}
 
-	/* start by resuming in case of SIGKILL */
-	if (signal == SIGKILL) {
-		cgroup_g_step_resume();
-	}
-
 	for (i = 0 ; i<npids ; i++) {
 		/*
 		 * Be on the safe side and do not kill slurmstepd (ourselves),
@@ -283,7 +288,8 @@ extern int proctrack_p_wait(uint64_t cont_id)
 		 * not killing slurmstepd processes (ourselves).
 		 */
 		proctrack_p_signal(cont_id, SIGKILL);
-		sleep(delay);
+		if (cgroup_g_step_wait_empty(delay * 1000) != SLURM_SUCCESS)
+			sleep(delay);
 		if (delay < 32)
 			delay *= 2;
 		xfree(pids);
@@ -73,7 +73,9 @@
 #include "src/common/macros.h"
 #include "src/common/parse_time.h"
 #include "src/common/read_config.h"
+#include "src/common/sched_trace.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/usdt.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -94,6 +96,7 @@
 #include "src/slurmctld/licenses.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/node_scheduler.h"
+#include "src/slurmctld/numa_placement.h"
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/slurmctld.h"
@@ -145,6 +148,22 @@ typedef struct {
 	int *node_space_recs;
 } node_space_handler_t;
 
+/*
+ * node_space table built from running jobs and reservation licenses, kept
+ * across backfill cycles. It is reused as long as the initial record and
+ * the set of running jobs which need a reservation are unchanged.
+ */
+typedef struct {
+	bitstr_t *avail_bitmap;		/* initial node_space[0] nodes */
+	time_t begin_time;		/* initial node_space[0] begin_time */
+	time_t end_time;		/* initial node_space[0] end_time */
+	bf_licenses_t *licenses;	/* initial node_space[0] licenses */
+	node_space_map_t *node_space;	/* records in time order */
+	int node_space_recs;
+	time_t resv_update;		/* last_resv_update when built */
+	uint64_t running_sig;		/* signature of running jobs */
+} node_space_cache_t;
+
 /*
  * HetJob scheduling structures
  * NOTE: An individial hetjob component can be submitted to multiple
@@ -222,6 +241,9 @@ static List het_job_list = NULL;
 static xhash_t *user_usage_map = NULL; /* look up user usage when no assoc */
 static bitstr_t *planned_bitmap = NULL;
 static bool soft_time_limit = false;
+static node_space_cache_t node_space_cache = { 0 };
+static int *node_space_order = NULL;	/* node_space indexes by time */
+static int node_space_order_cnt = 0;
 
 /*********************** local functions *********************/
 static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
@@ -246,6 +268,7 @@ static void _load_config(void);
 static bool _many_pending_rpcs(void);
 static bool _more_work(time_t last_backfill_time);
 static uint32_t _my_sleep(int64_t usec);
+static void _node_space_cache_clear(void);
 static int  _num_feature_count(job_record_t *job_ptr, bool *has_xand,
 			       bool *has_mor);
 static int  _het_job_find_map(void *x, void *key);
@@ -309,6 +332,7 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 	char begin_buf[256], end_buf[256], *node_list, *licenses;
 
 	info("=========================================");
+	info("node_space table: %d records", node_space_order_cnt);
 	while (1) {
 		slurm_make_time_str(&node_space_ptr[i].begin_time,
 				    begin_buf, sizeof(begin_buf));
@@ -326,6 +350,72 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 	info("=========================================");
 }
 
+/* Rebuild node_space_order by walking the node_space records */
+static void _node_space_order_reset(node_space_map_t *node_space)
+{
+	int j = 0;
+
+	node_space_order_cnt = 0;
+	while (1) {
+		node_space_order[node_space_order_cnt++] = j;
+		if ((j = node_space[j].next) == 0)
+			break;
+	}
+}
+
+/* Add node_space record "rec" at position "pos" of node_space_order */
+static void _node_space_order_insert(int pos, int rec)
+{
+	memmove(&node_space_order[pos + 1], &node_space_order[pos],
+		(node_space_order_cnt - pos) * sizeof(int));
+	node_space_order[pos] = rec;
+	node_space_order_cnt++;
+}
+
+/* Remove the node_space record at position "pos" of node_space_order */
+static void _node_space_order_remove(int pos)
+{
+	node_space_order_cnt--;
+	memmove(&node_space_order[pos], &node_space_order[pos + 1],
+		(node_space_order_cnt - pos) * sizeof(int));
+}
+
+/*
+ * Binary search of node_space_order
+ * RET position of the first record with end_time after "when", or
+ *     node_space_order_cnt if there is none
+ */
+static int _node_space_order_find(node_space_map_t *node_space, time_t when)
+{
+	int lo = 0, hi = node_space_order_cnt;
+
+	while (lo < hi) {
+		int mid = lo + ((hi - lo) / 2);
+
+		if (node_space[node_space_order[mid]].end_time > when)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
+/*
+ * Find where to start walking node_space for resources used after "when".
+ * Records ending at or before "when" are skipped. If every record does, the
+ * last record is returned so the caller's walk terminates on it.
+ */
+static int _node_space_first(node_space_map_t *node_space, time_t when)
+{
+	int pos = _node_space_order_find(node_space, when);
+
+	if (pos >= node_space_order_cnt)
+		pos = node_space_order_cnt - 1;
+
+	return node_space_order[pos];
+}
+
 static void _set_job_time_limit(job_record_t *job_ptr, uint32_t new_limit)
 {
 	job_ptr->time_limit = new_limit;
@@ -690,6 +780,9 @@ static void _load_config(void)
 {
 	char *sched_params = slurm_conf.sched_params, *tmp_ptr;
 
+	/* Resolution and table size may change, rebuild from scratch */
+	_node_space_cache_clear();
+
 	if ((tmp_ptr = xstrcasestr(sched_params, "bf_interval="))) {
 		backfill_interval = atoi(tmp_ptr + 12);
 		if (((backfill_interval != -1) && (backfill_interval < 1)) ||
@@ -1060,6 +1153,7 @@ extern void *backfill_agent(void *args)
 		error("cannot set my name to %s %m", "backfill");
 	}
 #endif
+	numa_placement_sched_thread();
 	_load_config();
 	last_backfill_time = time(NULL);
 	_init_planned_bitmap();
@@ -1123,6 +1217,7 @@ extern void *backfill_agent(void *args)
 	FREE_NULL_LIST(het_job_list);
 	xhash_free(user_usage_map); /* May have been init'ed if used */
 	FREE_NULL_BITMAP(planned_bitmap);
+	_node_space_cache_clear();
 
 	return NULL;
 }
@@ -1440,33 +1535,34 @@ static int _bf_reserve_resv_licenses(void *x, void *arg)
 	return 0;
 }
 
-static int _bf_reserve_running(void *x, void *arg)
+/*
+ * Determine if a running job needs a backfill reservation
+ * IN job_ptr - job to test
+ * OUT end_time - end of the reservation, aligned to bf_resolution
+ * OUT reserve_nodes - true if the job's nodes must be reserved, false if
+ *	the reservation is only needed for licenses
+ * RET true if a reservation is needed
+ */
+static bool _bf_running_need_resv(job_record_t *job_ptr, time_t *end_time,
+				  bool *reserve_nodes)
 {
-	job_record_t *job_ptr = (job_record_t *) x;
-	node_space_handler_t *ns_h = (node_space_handler_t *) arg;
-	node_space_map_t *node_space = ns_h->node_space;
-	int *ns_recs_ptr = ns_h->node_space_recs;
-	time_t end_time = job_ptr->end_time;
 	bool licenses, whole, preemptable;
-	bitstr_t *tmp_bitmap;
 
 	if (!job_ptr || !IS_JOB_RUNNING(job_ptr) || !job_ptr->job_resrcs)
-		return SLURM_SUCCESS;
+		return false;
 
 	whole = (job_ptr->job_resrcs->whole_node & WHOLE_NODE_REQUIRED);
 	licenses = (job_ptr->license_list);
 
 	if (!whole && !licenses)
-		return SLURM_SUCCESS;
+		return false;
 
 	preemptable = (slurm_job_preempt_mode(job_ptr) != PREEMPT_MODE_OFF);
 
 	if (preemptable && !licenses)
-		return SLURM_SUCCESS;
-
-	if (*ns_recs_ptr >= bf_node_space_size)
-		return SLURM_ERROR;
+		return false;
 
+	*end_time = job_ptr->end_time;
 	if (soft_time_limit && job_ptr->time_min) {
 		time_t now = time(NULL);
 		time_t soft_end = job_ptr->start_time + job_ptr->time_min * 60;
@@ -1475,13 +1571,33 @@ static int _bf_reserve_running(void *x, void *arg)
 		 * remaining time until the hard limit.
 		 */
 		if (soft_end < now)
-			soft_end = now + (end_time - now) / 2;
-		end_time = soft_end;
+			soft_end = now + (*end_time - now) / 2;
+		*end_time = soft_end;
 	}
 
-	end_time = (end_time / backfill_resolution) * backfill_resolution;
+	*end_time = (*end_time / backfill_resolution) * backfill_resolution;
+	*reserve_nodes = (!preemptable && whole);
+
+	return true;
+}
+
+static int _bf_reserve_running(void *x, void *arg)
+{
+	job_record_t *job_ptr = (job_record_t *) x;
+	node_space_handler_t *ns_h = (node_space_handler_t *) arg;
+	node_space_map_t *node_space = ns_h->node_space;
+	int *ns_recs_ptr = ns_h->node_space_recs;
+	time_t end_time;
+	bool reserve_nodes;
+	bitstr_t *tmp_bitmap;
+
+	if (!_bf_running_need_resv(job_ptr, &end_time, &reserve_nodes))
+		return SLURM_SUCCESS;
+
+	if (*ns_recs_ptr >= bf_node_space_size)
+		return SLURM_ERROR;
 
-	if (preemptable || !whole) {
+	if (!reserve_nodes) {
 		/* Reservation only needed for licenses. */
 		tmp_bitmap = bit_alloc(node_record_count);
 	} else {
@@ -1505,6 +1621,129 @@ static int _bf_reserve_running(void *x, void *arg)
 	return SLURM_SUCCESS;
 }
 
+/* Fold the reservation a running job needs into a signature */
+static int _bf_running_sig(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	uint64_t *sig = arg;
+	uint64_t val;
+	time_t end_time;
+	bool reserve_nodes;
+
+	if (!_bf_running_need_resv(job_ptr, &end_time, &reserve_nodes))
+		return SLURM_SUCCESS;
+
+	/* splitmix64 finalizer, summed so job_list order does not matter */
+	val = ((uint64_t) job_ptr->job_id << 32) ^ (uint64_t) end_time;
+	val ^= ((uint64_t) job_ptr->node_cnt << 1) | reserve_nodes;
+	val += 0x9e3779b97f4a7c15;
+	val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9;
+	val = (val ^ (val >> 27)) * 0x94d049bb133111eb;
+	val ^= (val >> 31);
+	*sig += val;
+
+	return SLURM_SUCCESS;
+}
+
+static void _node_space_cache_clear(void)
+{
+	node_space_cache_t *cache = &node_space_cache;
+
+	for (int i = 0; i < cache->node_space_recs; i++) {
+		FREE_NULL_BITMAP(cache->node_space[i].avail_bitmap);
+		FREE_NULL_BF_LICENSES(cache->node_space[i].licenses);
+	}
+	xfree(cache->node_space);
+	FREE_NULL_BITMAP(cache->avail_bitmap);
+	FREE_NULL_BF_LICENSES(cache->licenses);
+	memset(cache, 0, sizeof(*cache));
+}
+
+static bool _bf_licenses_same(bf_licenses_t *a, bf_licenses_t *b)
+{
+	if (!a || !b)
+		return (a == b);
+	if (a->cnt != b->cnt)
+		return false;
+	return bf_licenses_equal(a, b);
+}
+
+/*
+ * Record the initial node_space[0] record and running job signature that
+ * the table about to be built from running jobs depends upon.
+ */
+static void _node_space_cache_set_key(node_space_map_t *node_space,
+				      uint64_t running_sig)
+{
+	node_space_cache_t *cache = &node_space_cache;
+
+	_node_space_cache_clear();
+	cache->avail_bitmap = bit_copy(node_space[0].avail_bitmap);
+	cache->begin_time = node_space[0].begin_time;
+	cache->end_time = node_space[0].end_time;
+	cache->licenses = bf_licenses_copy(node_space[0].licenses);
+	cache->resv_update = last_resv_update;
+	cache->running_sig = running_sig;
+}
+
+/* Save the table built from running jobs, compacted into time order */
+static void _node_space_cache_save(node_space_map_t *node_space,
+				   int node_space_recs)
+{
+	node_space_cache_t *cache = &node_space_cache;
+	int i = 0, j = 0;
+
+	cache->node_space = xcalloc(node_space_recs, sizeof(node_space_map_t));
+	while (1) {
+		cache->node_space[i].begin_time = node_space[j].begin_time;
+		cache->node_space[i].end_time = node_space[j].end_time;
+		cache->node_space[i].avail_bitmap =
+			bit_copy(node_space[j].avail_bitmap);
+		cache->node_space[i].licenses =
+			bf_licenses_copy(node_space[j].licenses);
+		i++;
+		if ((j = node_space[j].next) == 0)
+			break;
+		cache->node_space[i - 1].next = i;
+	}
+	cache->node_space_recs = i;
+}
+
+/*
+ * Replace node_space with the cached table if it was built from an
+ * identical initial record and set of running jobs.
+ * RET true if node_space was loaded from the cache
+ */
+static bool _node_space_cache_load(node_space_map_t *node_space,
+				   int *node_space_recs, uint64_t running_sig)
+{
+	node_space_cache_t *cache = &node_space_cache;
+
+	if (!cache->node_space ||
+	    (cache->running_sig != running_sig) ||
+	    (cache->resv_update != last_resv_update) ||
+	    (cache->begin_time != node_space[0].begin_time) ||
+	    (cache->end_time != node_space[0].end_time) ||
+	    !bit_equal(cache->avail_bitmap, node_space[0].avail_bitmap) ||
+	    !_bf_licenses_same(cache->licenses, node_space[0].licenses))
+		return false;
+
+	FREE_NULL_BITMAP(node_space[0].avail_bitmap);
+	FREE_NULL_BF_LICENSES(node_space[0].licenses);
+	for (int i = 0; i < cache->node_space_recs; i++) {
+		node_space[i].begin_time = cache->node_space[i].begin_time;
+		node_space[i].end_time = cache->node_space[i].end_time;
+		node_space[i].avail_bitmap =
+			bit_copy(cache->node_space[i].avail_bitmap);
+		node_space[i].licenses =
+			bf_licenses_copy(cache->node_space[i].licenses);
+		node_space[i].next = cache->node_space[i].next;
+	}
+	*node_space_recs = cache->node_space_recs;
+
+	return true;
+}
+
 static int _set_hetjob_details(void *x, void *arg)
 {
 	job_record_t *job_ptr = (job_record_t *) x;
@@ -1782,6 +2021,8 @@ static void _attempt_backfill(void)
 	time_t tmp_preempt_start_time = 0;
 	bool tmp_preempt_in_progress = false;
 	bitstr_t *tmp_bitmap = NULL;
+	/* Scratch bitmaps reused for each node_space record tested */
+	bitstr_t *next_bitmap = NULL, *current_bitmap = NULL;
 	bool state_changed_break = false;
 	resv_exc_t resv_exc = { 0 };
 	/* QOS Read lock */
@@ -1856,18 +2097,35 @@ static void _attempt_backfill(void)
 
 	node_space[0].next = 0;
 	node_space_recs = 1;
+	node_space_order = xcalloc((bf_node_space_size + 1), sizeof(int));
+	_node_space_order_reset(node_space);
 
 	if (bf_running_job_reserve) {
 		node_space_handler_t node_space_handler;
+		uint64_t running_sig = 0;
+
 		node_space_handler.node_space = node_space;
 		node_space_handler.node_space_recs = &node_space_recs;
 
-		if (bf_licenses)
-			list_for_each(resv_list, _bf_reserve_resv_licenses,
+		list_for_each(job_list, _bf_running_sig, &running_sig);
+		if (_node_space_cache_load(node_space, &node_space_recs,
+					   running_sig)) {
+			_node_space_order_reset(node_space);
+			log_flag(BACKFILL, "reusing %d node_space records from previous cycle",
+				 node_space_recs);
+		} else {
+			_node_space_cache_set_key(node_space, running_sig);
+
+			if (bf_licenses)
+				list_for_each(resv_list,
+					      _bf_reserve_resv_licenses,
+					      &node_space_handler);
+
+			list_for_each(job_list, _bf_reserve_running,
 				      &node_space_handler);
 
-		list_for_each(job_list, _bf_reserve_running,
-			      &node_space_handler);
+			_node_space_cache_save(node_space, node_space_recs);
+		}
 	}
 
 	if (slurm_conf.debug_flags & DEBUG_FLAG_BACKFILL_MAP)
@@ -2176,6 +2434,9 @@ next_task:
 			already_counted = false;
 		}
 
+		SLURM_PROBE2(bf_job_start, job_ptr->job_id,
+			     job_ptr->array_task_id);
+
 		if (!IS_JOB_PENDING(job_ptr) ||	/* Started in other partition */
 		    (job_ptr->priority == 0))	/* Job has been held */
 			continue;
@@ -2463,13 +2724,19 @@ next_task:
 		filter_by_node_owner(job_ptr, avail_bitmap);
 		filter_by_node_mcs(job_ptr, mcs_select, avail_bitmap);
 		tmp_bitmap = bit_copy(avail_bitmap);
-		for (j = 0; ; ) {
+		if (!next_bitmap ||
+		    (bit_size(next_bitmap) != bit_size(avail_bitmap))) {
+			FREE_NULL_BITMAP(next_bitmap);
+			FREE_NULL_BITMAP(current_bitmap);
+			next_bitmap = bit_alloc(bit_size(avail_bitmap));
+			current_bitmap = bit_alloc(bit_size(avail_bitmap));
+		}
+		for (j = _node_space_first(node_space, start_res); ; ) {
 			if ((node_space[j].end_time > start_res) &&
 			     node_space[j].next && (later_start == 0)) {
 				int tmp = node_space[j].next;
-				bitstr_t *next_bitmap = bit_copy(tmp_bitmap);
-				bitstr_t *current_bitmap =
-					bit_copy(avail_bitmap);
+				bit_copybits(next_bitmap, tmp_bitmap);
+				bit_copybits(current_bitmap, avail_bitmap);
 				bit_and(next_bitmap,
 					node_space[tmp].avail_bitmap);
 				bit_and(current_bitmap,
@@ -2487,8 +2754,6 @@ next_task:
 				 */
 				if (!bit_super_set(next_bitmap, current_bitmap))
 					later_start = node_space[j].end_time;
-				FREE_NULL_BITMAP(next_bitmap);
-				FREE_NULL_BITMAP(current_bitmap);
 			}
 			if (node_space[j].end_time <= start_res)
 				;
@@ -2633,7 +2898,7 @@ next_task:
 			orig_end_time = end_time;
 			end_time += boot_time;
 
-			for (j = 0; ; ) {
+			for (j = _node_space_first(node_space, start_res); ; ) {
 				if (node_space[j].end_time <= start_res)
 					;
 				else if (node_space[j].begin_time <= end_time) {
@@ -2661,6 +2926,12 @@ next_task:
 		job_ptr->bit_flags &= ~BF_WHOLE_NODE_TEST;
 		job_ptr->bit_flags &= ~TEST_NOW_ONLY;
 
+		if (sched_trace_active)
+			sched_trace_add(SCHED_TRACE_BACKFILL, 0,
+					job_ptr->job_id,
+					job_ptr->part_ptr->name, j,
+					bit_clear_count(resv_bitmap));
+
 		now = time(NULL);
 		if (j != SLURM_SUCCESS) {
 			_set_job_time_limit(job_ptr, orig_time_limit);
@@ -2757,6 +3028,7 @@ next_task:
 			}
 
 			rc = _start_job(job_ptr, resv_bitmap);
+			SLURM_PROBE2(bf_job_started, job_ptr->job_id, rc);
 
 			if (rc == SLURM_SUCCESS) {
 				/*
@@ -3195,6 +3467,8 @@ skip_start:
 	FREE_NULL_BITMAP(avail_bitmap);
 	reservation_delete_resv_exc_parts(&resv_exc);
 	FREE_NULL_BITMAP(resv_bitmap);
+	FREE_NULL_BITMAP(next_bitmap);
+	FREE_NULL_BITMAP(current_bitmap);
 
 	for (i = 0; ; ) {
 		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
@@ -3203,6 +3477,8 @@ skip_start:
 			break;
 	}
 	xfree(node_space);
+	xfree(node_space_order);
+	node_space_order_cnt = 0;
 	FREE_NULL_LIST(job_queue);
 
 	gettimeofday(&bf_time2, NULL);
@@ -3395,7 +3671,7 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 			     int *node_space_recs)
 {
 	bool placed = false;
-	int i, j, one_before = 0, one_after = -1;
+	int i, j = 0, pos, before_pos, one_before = 0, one_after = -1;
 
 #if 0
 	info("add job start:%u end:%u", start_time, end_reserve);
@@ -3417,7 +3693,13 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 	 */
 	if (end_reserve < (start_time + backfill_resolution))
 		end_reserve = start_time + backfill_resolution;
-	for (j = 0; ; ) {
+
+	/* First record ending at or after start_time */
+	pos = _node_space_order_find(node_space, start_time - 1);
+	before_pos = (pos > 0) ? (pos - 1) : 0;
+	one_before = node_space_order[before_pos];
+	if (pos < node_space_order_cnt) {
+		j = node_space_order[pos];
 		if (node_space[j].end_time > start_time) {
 			/* insert start entry record */
 			i = *node_space_recs;
@@ -3430,21 +3712,15 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 				bf_licenses_copy(node_space[j].licenses);
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
+			_node_space_order_insert(pos + 1, i);
 			(*node_space_recs)++;
-			placed = true;
-			break;
-		}
-		if (node_space[j].end_time == start_time) {
-			/* no need to insert new start entry record */
-			placed = true;
-			break;
 		}
-		one_before = j;
-		if ((j = node_space[j].next) == 0)
-			break;
+		/* else no need to insert new start entry record */
+		placed = true;
 	}
 
 	while (placed && (j = node_space[j].next)) {
+		pos++;
 		if (end_reserve < node_space[j].end_time) {
 			/* insert end entry record */
 			i = *node_space_recs;
@@ -3457,6 +3733,7 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 				bf_licenses_copy(node_space[j].licenses);
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
+			_node_space_order_insert(pos + 1, i);
 			(*node_space_recs)++;
 		}
 
@@ -3478,23 +3755,27 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 
 	/* Drop records with identical bitmaps (up to one record).
 	 * This can significantly improve performance of the backfill tests. */
+	pos = before_pos;
 	for (i = one_before; i != one_after; ) {
 		if ((j = node_space[i].next) == 0)
 			break;
 		if (!bf_licenses_equal(node_space[i].licenses,
 				       node_space[j].licenses)) {
 			i = j;
+			pos++;
 			continue;
 		}
 		if (!bit_equal(node_space[i].avail_bitmap,
 			       node_space[j].avail_bitmap)) {
 			i = j;
+			pos++;
 			continue;
 		}
 		node_space[i].end_time = node_space[j].end_time;
 		node_space[i].next = node_space[j].next;
 		FREE_NULL_BITMAP(node_space[j].avail_bitmap);
 		FREE_NULL_BF_LICENSES(node_space[j].licenses);
+		_node_space_order_remove(pos + 1);
 		break;
 	}
 }
@@ -3513,7 +3794,7 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 			       uint32_t start_time, uint32_t end_reserve)
 {
 	bool overlap = false;
-	int j = 0;
+	int j = _node_space_first(node_space, start_time);
 	bitstr_t *use_bitmap_efctv = NULL;
 
 	if (IS_JOB_WHOLE_TOPO(job_ptr)) {
@@ -143,12 +143,29 @@ static inline void _log_select_maps(char *loc, job_record_t *job_ptr)
 	}
 }
 
+/*
+ * Return the first core set in core_map within [start, end), or end if there
+ * is none. Skips whole words of unavailable cores instead of testing each bit.
+ */
+static uint32_t _next_avail_core(bitstr_t *core_map, uint32_t start,
+				 uint32_t end)
+{
+	bitoff_t next;
+
+	if (start >= end)
+		return end;
+	next = bit_ffs_from_bit(core_map, start);
+	if ((next < 0) || (next >= end))
+		return end;
+	return next;
+}
+
 /* Remove any specialized cores from those allocated to the job */
 static void _clear_spec_cores(job_record_t *job_ptr,
 			      bitstr_t **core_array)
 {
-	int first_core, last_core;
-	int alloc_node = -1, alloc_core = -1, c;
+	int last_core, prev_core;
+	int alloc_node = -1, alloc_core = 0, c;
 	job_resources_t *job_res = job_ptr->job_resrcs;
 	multi_core_data_t *mc_ptr = NULL;
 	bitstr_t *use_core_array = NULL;
@@ -161,26 +178,34 @@ static void _clear_spec_cores(job_record_t *job_ptr,
 
 	for (int i = 0;
 	     (node_ptr = next_node_bitmap(job_res->node_bitmap, &i)); i++) {
-		job_res->cpus[++alloc_node] = 0;
+		uint16_t tpc = node_ptr->tpc;
+
+		if (mc_ptr && (mc_ptr->threads_per_core != NO_VAL16) &&
+		    (mc_ptr->threads_per_core < tpc))
+			tpc = mc_ptr->threads_per_core;
 
-		first_core = 0;
 		last_core = node_ptr->tot_cores;
 		use_core_array = core_array[i];
 
-		for (c = first_core; c < last_core; c++) {
-			alloc_core++;
-			if (bit_test(use_core_array, c)) {
-				uint16_t tpc = node_ptr->tpc;
-				if (mc_ptr &&
-				    (mc_ptr->threads_per_core != NO_VAL16) &&
-				    (mc_ptr->threads_per_core < tpc))
-					tpc = mc_ptr->threads_per_core;
-
-				job_res->cpus[alloc_node] += tpc;
-			} else {
-				bit_clear(job_res->core_bitmap, alloc_core);
-			}
+		job_res->cpus[++alloc_node] = tpc *
+			bit_set_count_range(use_core_array, 0, last_core);
+
+		/* Clear the gaps between the usable cores of this node */
+		prev_core = 0;
+		for (c = _next_avail_core(use_core_array, 0, last_core);
+		     c < last_core;
+		     c = _next_avail_core(use_core_array, c + 1, last_core)) {
+			if (c > prev_core)
+				bit_nclear(job_res->core_bitmap,
+					   alloc_core + prev_core,
+					   alloc_core + c - 1);
+			prev_core = c + 1;
 		}
+		if (prev_core < last_core)
+			bit_nclear(job_res->core_bitmap,
+				   alloc_core + prev_core,
+				   alloc_core + last_core - 1);
+		alloc_core += last_core;
 	}
 }
 
@@ -437,7 +462,7 @@ static int _compute_plane_dist(job_record_t *job_ptr,
 static void _block_sync_core_bitmap(job_record_t *job_ptr,
 				    const uint16_t cr_type)
 {
-	uint32_t c, s, i, j, b, z, csize, core_cnt;
+	uint32_t c, s, i, j, b, z, csize, core_cnt, sock_end;
 	int n, n_first, n_last;
 	uint16_t cpus, num_bits, vpus = 1;
 	uint16_t cpus_per_task = job_ptr->details->cpus_per_task;
@@ -568,17 +593,13 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 			sort_brds_core_cnt[b] = 0;
 		}
 		for (s = 0; s < nsockets_nb; s++) {
-			sockets_core_cnt[s] = 0;
+			sockets_core_cnt[s] = bit_set_count_range(
+				job_res->core_bitmap, c + (s * ncores_nb),
+				c + ((s + 1) * ncores_nb));
 			sockets_used[s] = false;
 			b = s / sock_per_brd;
-			for (j = c + (s * ncores_nb);
-			     j < c + ((s+1) * ncores_nb); j++) {
-				if (bit_test(job_res->core_bitmap, j)) {
-					sockets_core_cnt[s]++;
-					boards_core_cnt[b]++;
-					sort_brds_core_cnt[b]++;
-				}
-			}
+			boards_core_cnt[b] += sockets_core_cnt[s];
+			sort_brds_core_cnt[b] += sockets_core_cnt[s];
 		}
 
 		/* Sort boards in descending order of available core count */
@@ -748,26 +769,9 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 			         sockets_core_cnt[best_fit_location]);
 
 			sockets_used[best_fit_location] = true;
+			sock_end = c + ((best_fit_location + 1) * ncores_nb);
 			for (j = (c + (best_fit_location * ncores_nb));
-			     j < (c + ((best_fit_location + 1) * ncores_nb));
-			     j++ ) {
-				/*
-				 * if no more CPUs to select
-				 * release remaining cores unless
-				 * we are allocating whole sockets
-				 */
-				if (cpus == 0) {
-					if (alloc_sockets) {
-						bit_set(job_res->core_bitmap,
-							j);
-						core_cnt++;
-					} else {
-						bit_clear(job_res->core_bitmap,
-							  j);
-					}
-					continue;
-				}
-
+			     (j < sock_end) && (cpus > 0); j++) {
 				/*
 				 * remove cores from socket count and
 				 * cpus count using hyperthreading requirement
@@ -799,6 +803,21 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 				}
 			}
 
+			/*
+			 * if no more CPUs to select release remaining cores
+			 * unless we are allocating whole sockets
+			 */
+			if (j < sock_end) {
+				if (alloc_sockets) {
+					bit_nset(job_res->core_bitmap, j,
+						 sock_end - 1);
+					core_cnt += sock_end - j;
+				} else {
+					bit_nclear(job_res->core_bitmap, j,
+						   sock_end - 1);
+				}
+			}
+
 			/* loop again if more CPUs required */
 			if (cpus > 0)
 				continue;
@@ -938,10 +957,10 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 					  job_ptr->details->cpus_per_task;
 			cpus_cnt = xmalloc(sizeof(uint32_t) * sockets);
 			for (s = 0; s < sockets; s++) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					if (bit_test(core_map, j))
-						cpus_cnt[s] += vpus;
-				}
+				cpus_cnt[s] = vpus *
+					bit_set_count_range(core_map,
+							    sock_start[s],
+							    sock_end[s]);
 				total_cpus += cpus_cnt[s];
 			}
 			for (s = 0; s < sockets && total_cpus > cpus; s++) {
@@ -966,41 +985,45 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 			cpus_per_task = job_ptr->details->cpus_per_task;
 			cpus_cnt = xmalloc(sizeof(uint32_t) * sockets);
 			for (s = 0; s < sockets; s++) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					if (bit_test(core_map, j))
-						cpus_cnt[s] += vpus;
-				}
+				cpus_cnt[s] = vpus *
+					bit_set_count_range(core_map,
+							    sock_start[s],
+							    sock_end[s]);
 				cpus_cnt[s] -= (cpus_cnt[s] % cpus_per_task);
 			}
 			tmp_cpt = cpus_per_task;
 			for (s = 0; ((s < sockets) && (cpus > 0)); s++) {
 				while ((sock_start[s] < sock_end[s]) &&
 				       (cpus_cnt[s] > 0) && (cpus > 0)) {
-					if (bit_test(core_map, sock_start[s])) {
-						int used;
-						sock_used[s] = true;
-						core_cnt++;
-
-						if ((ntasks_per_core == 1) &&
-						    (cpus_per_task > vpus)) {
-							used = MIN(tmp_cpt,
-								   vpus);
-							if (tmp_cpt <= used)
-								tmp_cpt = cpus_per_task;
-							else
-								tmp_cpt -= used;
-						} else
-							used = vpus;
-
-						if (cpus_cnt[s] < vpus)
-							cpus_cnt[s] = 0;
-						else
-							cpus_cnt[s] -= used;
-						if (cpus < vpus)
-							cpus = 0;
+					int used;
+
+					sock_start[s] = _next_avail_core(
+						core_map, sock_start[s],
+						sock_end[s]);
+					if (sock_start[s] == sock_end[s])
+						break;
+
+					sock_used[s] = true;
+					core_cnt++;
+
+					if ((ntasks_per_core == 1) &&
+					    (cpus_per_task > vpus)) {
+						used = MIN(tmp_cpt, vpus);
+						if (tmp_cpt <= used)
+							tmp_cpt = cpus_per_task;
 						else
-							cpus -= used;
-					}
+							tmp_cpt -= used;
+					} else
+						used = vpus;
+
+					if (cpus_cnt[s] < vpus)
+						cpus_cnt[s] = 0;
+					else
+						cpus_cnt[s] -= used;
+					if (cpus < vpus)
+						cpus = 0;
+					else
+						cpus -= used;
 					sock_start[s]++;
 				}
 			}
@@ -1013,17 +1036,14 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 			for (s = 0; s < sockets && cpus > 0; s++) {
 				if (sock_avoid[s])
 					continue;
-				while (sock_start[s] < sock_end[s]) {
-					if (bit_test(core_map, sock_start[s])) {
-						sock_used[s] = true;
-						core_cnt++;
-						break;
-					} else
-						sock_start[s]++;
-				}
+				sock_start[s] = _next_avail_core(core_map,
+								 sock_start[s],
+								 sock_end[s]);
 				if (sock_start[s] == sock_end[s])
 					/* this socket is unusable */
 					continue;
+				sock_used[s] = true;
+				core_cnt++;
 				if (cpus < vpus)
 					cpus = 0;
 				else
@@ -1087,15 +1107,16 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 				bit_nclear(core_map, sock_start[s],
 					   sock_end[s]-1);
 			}
-			if ((node_ptr->tpc >= 1) &&
-			    (alloc_sockets || alloc_cores) && sock_used[s]) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					/* Mark all cores as used */
-					if (alloc_sockets)
-						bit_set(core_map, j);
-					if (bit_test(core_map, j))
-						core_cnt++;
-				}
+			/*
+			 * Mark all cores as used when allocating whole sockets.
+			 * Otherwise the rest of the socket was just cleared and
+			 * there is nothing left to count.
+			 */
+			if ((node_ptr->tpc >= 1) && alloc_sockets &&
+			    sock_used[s]) {
+				bit_nset(core_map, sock_start[s],
+					 sock_end[s] - 1);
+				core_cnt += sock_end[s] - sock_start[s];
 			}
 		}
 		if ((alloc_cores || alloc_sockets) && (node_ptr->tpc >= 1)) {
@@ -41,6 +41,7 @@
 #include "src/common/slurm_xlator.h"
 
 #include "gres_select_filter.h"
+#include "gres_select_util.h"
 
 /* Used to indicate when sock_gres->bits_any_sock should be tested */
 #define ANY_SOCK_TEST -1
@@ -72,22 +73,12 @@ static bool *_build_avail_cores_by_sock(bitstr_t *core_bitmap,
 					uint16_t cores_per_sock)
 {
 	bool *avail_cores_by_sock = xcalloc(sockets, sizeof(bool));
-	int s, c, i, lim = 0;
-
-	lim = bit_size(core_bitmap);
-	for (s = 0; s < sockets; s++) {
-		for (c = 0; c < cores_per_sock; c++) {
-			i = (s * cores_per_sock) + c;
-			if (i >= lim)
-				goto fini;	/* should never happen */
-			if (bit_test(core_bitmap, i)) {
-				avail_cores_by_sock[s] = true;
-				break;
-			}
-		}
-	}
 
-fini:	return avail_cores_by_sock;
+	for (int s = 0; s < sockets; s++)
+		avail_cores_by_sock[s] = gres_select_util_sock_has_core(
+			core_bitmap, s, cores_per_sock);
+
+	return avail_cores_by_sock;
 }
 
 /* Set max_node_gres if it is unset or greater than val */
@@ -721,6 +712,25 @@ static uint64_t _pick_gres_topo(sock_gres_t *sock_gres, int gres_needed,
 	gres_still_needed = gres_needed;
 	gres_cnt = bit_size(gres_js->gres_bit_select[node_inx]);
 
+	if (!sorted_gres && (bit_size(sock_bits) == gres_cnt) &&
+	    (bit_size(gres_ns->gres_bit_alloc) == gres_cnt)) {
+		/* Only visit GRES on this socket which are still free */
+		bitstr_t *free_bits = bit_copy(sock_bits);
+
+		bit_and_not(free_bits, gres_js->gres_bit_select[node_inx]);
+		bit_and_not(free_bits, gres_ns->gres_bit_alloc);
+		for (bitoff_t g = bit_ffs(free_bits);
+		     (g >= 0) && gres_still_needed;
+		     g = bit_ffs_from_bit(free_bits, g + 1)) {
+			bit_set(gres_js->gres_bit_select[node_inx], g);
+			gres_js->gres_cnt_node_select[node_inx]++;
+			gres_still_needed--;
+		}
+		FREE_NULL_BITMAP(free_bits);
+
+		return gres_needed - gres_still_needed;
+	}
+
 	for (int i = 0; i < gres_cnt && gres_still_needed; i++) {
 		int g = sorted_gres ? sorted_gres[i] : i;
 		if (!bit_test(sock_bits, g))
@@ -482,3 +482,16 @@ extern List gres_select_util_create_list_req_accum(List gres_list)
 
 	return new_gres_list;
 }
+
+extern bool gres_select_util_sock_has_core(bitstr_t *core_bitmap, int sock,
+					   uint16_t cores_per_sock)
+{
+	bitoff_t first = sock * cores_per_sock;
+	bitoff_t next;
+
+	if (first >= bit_size(core_bitmap))
+		return false;
+	next = bit_ffs_from_bit(core_bitmap, first);
+
+	return ((next != -1) && (next < (first + cores_per_sock)));
+}
@@ -135,4 +135,14 @@ extern uint32_t gres_select_util_get_task_limit(List sock_gres_list);
  */
 extern List gres_select_util_create_list_req_accum(List gres_list);
 
+/*
+ * Test if any core of a socket is set in a core bitmap
+ * IN core_bitmap - bitmap of all cores on the node
+ * IN sock - socket index
+ * IN cores_per_sock - count of cores on each socket
+ * RET TRUE if at least one of the socket's cores is set
+ */
+extern bool gres_select_util_sock_has_core(bitstr_t *core_bitmap, int sock,
+					   uint16_t cores_per_sock);
+
 #endif /* _GRES_SELECT_UTIL_H */
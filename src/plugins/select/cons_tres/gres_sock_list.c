@@ -36,6 +36,7 @@
 
 #include "src/common/slurm_xlator.h"
 
+#include "gres_select_util.h"
 #include "gres_sock_list.h"
 
 #include "src/common/xstring.h"
@@ -169,7 +170,7 @@ static sock_gres_t *_build_sock_gres_by_topo(
 	gres_job_state_t *gres_js = gres_state_job->gres_data;
 	gres_node_state_t *gres_ns = gres_state_node->gres_data;
 	gres_node_state_t *alt_gres_ns = NULL;
-	int i, j, s, c;
+	int i, s, c;
 	uint32_t tot_cores;
 	sock_gres_t *sock_gres;
 	int64_t add_gres;
@@ -270,16 +271,9 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		    !res_cores_per_gpu) {
 			use_all_sockets = true;
 			for (s = 0; s < sockets; s++) {
-				bool use_this_socket = false;
-				for (c = 0; c < cores_per_sock; c++) {
-					j = (s * cores_per_sock) + c;
-					if (bit_test(gres_ns->
-						     topo_core_bitmap[i], j)) {
-						use_this_socket = true;
-						break;
-					}
-				}
-				if (!use_this_socket) {
+				if (!gres_select_util_sock_has_core(
+					    gres_ns->topo_core_bitmap[i], s,
+					    cores_per_sock)) {
 					use_all_sockets = false;
 					break;
 				}
@@ -309,42 +303,32 @@ static sock_gres_t *_build_sock_gres_by_topo(
 
 		/* Constrained by core */
 		for (s = 0; ((s < sockets) && avail_gres); s++) {
-			if (enforce_binding && core_bitmap) {
-				for (c = 0; c < cores_per_sock; c++) {
-					j = (s * cores_per_sock) + c;
-					if (bit_test(core_bitmap, j))
-						break;
-				}
-				if (c >= cores_per_sock) {
-					/* No available cores on this socket */
-					continue;
-				}
+			if (enforce_binding && core_bitmap &&
+			    !gres_select_util_sock_has_core(core_bitmap, s,
+							    cores_per_sock)) {
+				/* No available cores on this socket */
+				continue;
 			}
-			for (c = 0; c < cores_per_sock; c++) {
-				j = (s * cores_per_sock) + c;
-				if (gres_ns->topo_core_bitmap[i] &&
-				    !bit_test(gres_ns->topo_core_bitmap[i],
-					      j))
-					continue;
-				if (!gres_ns->topo_gres_bitmap[i]) {
-					error("%s: topo_gres_bitmap NULL on node %s",
-					      __func__, node_name);
-					continue;
-				}
-				if (!sock_gres->bits_by_sock[s]) {
-					sock_gres->bits_by_sock[s] =
-						bit_copy(gres_ns->
-							 topo_gres_bitmap[i]);
-				} else {
-					bit_or(sock_gres->bits_by_sock[s],
-					       gres_ns->topo_gres_bitmap[i]);
-				}
-				sock_gres->cnt_by_sock[s] += avail_gres;
-				sock_gres->total_cnt += avail_gres;
-				avail_gres = 0;
-				match = true;
-				break;
+			if (!gres_select_util_sock_has_core(
+				    gres_ns->topo_core_bitmap[i], s,
+				    cores_per_sock))
+				continue;
+			if (!gres_ns->topo_gres_bitmap[i]) {
+				error("%s: topo_gres_bitmap NULL on node %s",
+				      __func__, node_name);
+				continue;
+			}
+			if (!sock_gres->bits_by_sock[s]) {
+				sock_gres->bits_by_sock[s] =
+					bit_copy(gres_ns->topo_gres_bitmap[i]);
+			} else {
+				bit_or(sock_gres->bits_by_sock[s],
+				       gres_ns->topo_gres_bitmap[i]);
 			}
+			sock_gres->cnt_by_sock[s] += avail_gres;
+			sock_gres->total_cnt += avail_gres;
+			avail_gres = 0;
+			match = true;
 		}
 	}
 
@@ -390,14 +374,11 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		for (s = 0; s < sockets; s++) {
 			if (sock_gres->cnt_by_sock[s] == 0)
 				continue;
-			for (c = 0; c < cores_per_sock; c++) {
-				i = (s * cores_per_sock) + c;
-				if (!bit_test(core_bitmap, i))
-					continue;
-				avail_sock++;
-				avail_sock_flag[s] = true;
-				break;
-			}
+			if (!gres_select_util_sock_has_core(core_bitmap, s,
+							    cores_per_sock))
+				continue;
+			avail_sock++;
+			avail_sock_flag[s] = true;
 		}
 		while (avail_sock > s_p_n) {
 			int low_gres_sock_inx = -1;
@@ -444,17 +425,14 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		for (s = 0; s < sockets; s++) {
 			if (sock_gres->cnt_by_sock[s] == 0)
 				continue;
-			for (c = 0; c < cores_per_sock; c++) {
-				i = (s * cores_per_sock) + c;
-				if (!bit_test(core_bitmap, i))
-					continue;
-				avail_sock_flag[s] = true;
-				if ((best_sock_inx == -1) ||
-				    (sock_gres->cnt_by_sock[s] >
-				     sock_gres->cnt_by_sock[best_sock_inx])) {
-					best_sock_inx = s;
-				}
-				break;
+			if (!gres_select_util_sock_has_core(core_bitmap, s,
+							    cores_per_sock))
+				continue;
+			avail_sock_flag[s] = true;
+			if ((best_sock_inx == -1) ||
+			    (sock_gres->cnt_by_sock[s] >
+			     sock_gres->cnt_by_sock[best_sock_inx])) {
+				best_sock_inx = s;
 			}
 		}
 		while ((best_sock_inx != -1) && (add_gres > 0)) {
@@ -81,15 +81,17 @@ static int _handle_job_res(job_resources_t *job_resrcs_ptr,
 	if (!job_resrcs_ptr->core_bitmap)
 		return 1;
 
-	/* create row_bitmap data structure as needed */
+	/*
+	 * Create row_bitmap data structure as needed. Per-node bitmaps are
+	 * only created for nodes with cores allocated in this row, a NULL
+	 * bitmap means that no cores of the node are allocated.
+	 */
 	if (!r_ptr->row_bitmap) {
 		if (type == HANDLE_JOB_RES_TEST)
 			return 1;
 		core_array = build_core_array();
 		r_ptr->row_bitmap = core_array;
 		r_ptr->row_set_count = 0;
-		for (int i = 0; i < node_record_count; i++)
-			core_array[i] = _create_core_bitmap(i);
 	} else
 		core_array = r_ptr->row_bitmap;
 
@@ -98,6 +100,9 @@ static int _handle_job_res(job_resources_t *job_resrcs_ptr,
 	     i++) {
 		cores_per_node = node_ptr->tot_cores;
 
+		if (!core_array[i] && (type == HANDLE_JOB_RES_ADD))
+			core_array[i] = _create_core_bitmap(i);
+
 		/*
 		 * This segment properly handles the core counts when whole
 		 * nodes are allocated, including when explicitly requesting
@@ -105,7 +110,7 @@ static int _handle_job_res(job_resources_t *job_resrcs_ptr,
 		 */
 		if (job_resrcs_ptr->whole_node == 1) {
 			if (!core_array[i]) {
-				if (type != HANDLE_JOB_RES_TEST)
+				if (type == HANDLE_JOB_RES_REM)
 					error("core_array for node %d is NULL %d",
 					      i, type);
 				continue;	/* Move to next node */
@@ -132,7 +137,7 @@ static int _handle_job_res(job_resources_t *job_resrcs_ptr,
 			if (!bit_test(job_resrcs_ptr->core_bitmap, c_off + c))
 				continue;
 			if (!core_array[i]) {
-				if (type != HANDLE_JOB_RES_TEST)
+				if (type == HANDLE_JOB_RES_REM)
 					error("core_array for node %d is NULL %d",
 					      i, type);
 				continue;	/* Move to next node */
@@ -294,6 +299,7 @@ extern int job_res_add_job(job_record_t *job_ptr, job_res_job_action_t action)
 		if (job->cpus[n] == 0)
 			continue;  /* node removed by job resize */
 
+		node_data_touch(&select_node_usage[i]);
 		if (action != JOB_RES_ACTION_RESUME) {
 			if (select_node_usage[i].gres_list)
 				node_gres_list = select_node_usage[i].gres_list;
@@ -378,6 +384,23 @@ extern int job_res_add_job(job_record_t *job_ptr, job_res_job_action_t action)
 			part_data_add_job_to_row(job, &(p_ptr->row[i]));
 			break;
 		}
+		if ((i >= p_ptr->num_rows) && (p_ptr->num_rows > 1)) {
+			/*
+			 * Rows are only patched as jobs end, a full repack
+			 * may free a row for this job
+			 */
+			part_data_build_row_bitmaps(p_ptr, NULL);
+			for (i = 0; i < p_ptr->num_rows; i++) {
+				if (!job_res_fit_in_row(job,
+							&(p_ptr->row[i])))
+					continue;
+				debug3("adding %pJ to part %s row %u after repack",
+				       job_ptr, p_ptr->part_ptr->name, i);
+				part_data_add_job_to_row(job,
+							 &(p_ptr->row[i]));
+				break;
+			}
+		}
 		if (i >= p_ptr->num_rows) {
 			/*
 			 * Job started or resumed and it's allocated resources
@@ -475,6 +498,7 @@ extern int job_res_rm_job(part_res_record_t *part_record_ptr,
 		if (job->cpus[n] == 0)
 			continue;  /* node lost by job resize */
 
+		node_data_touch(&node_usage[i]);
 		if (action != JOB_RES_ACTION_RESUME) {
 			List node_gres_list;
 
@@ -553,16 +577,14 @@ extern int job_res_rm_job(part_res_record_t *part_record_ptr,
 				p_ptr->row[i].num_jobs--;
 				/* found job - we're done */
 				n = 1;
-				i = p_ptr->num_rows;
 				break;
 			}
+			if (n)
+				break;
 		}
 		if (n) {
-			/* job was found and removed, so bitmaps need be rebuild */
-			if (p_ptr->num_rows == 1)
-				part_data_build_row_bitmaps(p_ptr, job_ptr);
-			else
-				p_ptr->rebuild_rows = true;
+			/* job was found and removed, so patch its row */
+			part_data_rm_job_from_row(p_ptr, job, i);
 			/*
 			 * Adjust the node_state of all nodes affected by
 			 * the removal of this job. If all cores are now
@@ -69,11 +69,62 @@ typedef struct {
 	uint32_t *sum_cpus;
 } gres_cpus_foreach_args_t;
 
+/* Inputs of a failed _can_job_run_on_node() test of one node */
+typedef struct {
+	bitstr_t *core_map;		/* available cores, may be NULL */
+	bitstr_t *part_core_map;	/* partition cores, may be NULL */
+	uint32_t s_p_n;
+	uint32_t state_gen;		/* node_use_record_t state_gen,
+					 * 0 if no failure recorded */
+} avail_res_fail_t;
+
+/*
+ * Per-node record of failed tests for the job currently being evaluated by
+ * job_test(). A node whose inputs match a recorded failure is not tested
+ * again, which avoids rebuilding the GRES socket lists of nodes that can not
+ * be used while job_test() iterates over rows and preemption candidates.
+ */
+typedef struct {
+	uint16_t cr_type;
+	avail_res_fail_t *fail;		/* indexed by node_i */
+	uint32_t hits;
+	resv_exc_t *resv_exc_ptr;
+	bool test_only;
+	bool will_run;
+} avail_res_cache_t;
+
+/* Nodes handed to a _get_res_avail() worker at a time */
+#define RES_AVAIL_CHUNK 64
+/* Smallest candidate node count tested by more than one thread */
+#define RES_AVAIL_PARALLEL_MIN 1024
+
+typedef struct {
+	avail_res_t **avail_res_array;
+	avail_res_cache_t *cache;
+	bitstr_t **core_map;
+	uint16_t cr_type;
+	uint32_t hits;
+	int i_last;
+	job_record_t *job_ptr;
+	pthread_mutex_t mutex;
+	int next_node;
+	bitstr_t *node_map;
+	node_use_record_t *node_usage;
+	bitstr_t **part_core_map;
+	resv_exc_t *resv_exc_ptr;
+	uint32_t s_p_n;
+	bool test_only;
+	bool will_run;
+} res_avail_args_t;
+
 uint64_t def_cpu_per_gpu = 0;
 uint64_t def_mem_per_gpu = 0;
 bool preempt_strict_order = false;
 bool preempt_for_licenses = false;
 int preempt_reorder_cnt	= 1;
+int select_test_threads = 0;
+
+static __thread avail_res_cache_t *avail_res_cache = NULL;
 
 /* Local functions */
 static avail_res_t *_allocate(job_record_t *job_ptr,
@@ -510,8 +561,12 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
 		return NULL;
 	}
 
-	if (part_core_map)
+	if (part_core_map) {
+		/* Partition rows only hold bitmaps for nodes in use */
+		if (!part_core_map[node_i])
+			part_core_map[node_i] = bit_alloc(node_ptr->tot_cores);
 		part_core_map_ptr = part_core_map[node_i];
+	}
 	if (node_usage[node_i].gres_list)
 		node_gres_list = node_usage[node_i].gres_list;
 	else
@@ -703,6 +758,162 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
  *
  * RET array of avail_res_t pointers, free using _free_avail_res_array()
  */
+static void _avail_res_cache_clear(avail_res_cache_t *cache)
+{
+	if (!cache->fail)
+		return;
+
+	for (int i = 0; i < node_record_count; i++) {
+		FREE_NULL_BITMAP(cache->fail[i].core_map);
+		FREE_NULL_BITMAP(cache->fail[i].part_core_map);
+		cache->fail[i].state_gen = 0;
+	}
+}
+
+static void _avail_res_cache_fini(job_record_t *job_ptr)
+{
+	if (!avail_res_cache)
+		return;
+
+	if (avail_res_cache->hits)
+		log_flag(SELECT_TYPE, "%pJ skipped %u node tests with unchanged resources",
+			 job_ptr, avail_res_cache->hits);
+	_avail_res_cache_clear(avail_res_cache);
+	xfree(avail_res_cache->fail);
+	xfree(avail_res_cache);
+}
+
+/*
+ * Compare two core bitmaps. A NULL core_map entry means all cores are
+ * available while a NULL part_core_map entry means no cores are in use.
+ */
+static bool _avail_res_cores_match(bitstr_t *b1, bitstr_t *b2,
+				   bool null_is_empty)
+{
+	if (b1 && b2)
+		return (bit_equal(b1, b2) == 1);
+	if (!b1 && !b2)
+		return true;
+	if (!null_is_empty)
+		return false;
+	return (bit_set_count(b1 ? b1 : b2) == 0);
+}
+
+/* Reset the cache if the test parameters differ from the recorded ones */
+static void _avail_res_cache_prep(avail_res_cache_t *cache, uint16_t cr_type,
+				  bool test_only, bool will_run,
+				  resv_exc_t *resv_exc_ptr)
+{
+	if ((cache->cr_type != cr_type) ||
+	    (cache->test_only != test_only) ||
+	    (cache->will_run != will_run) ||
+	    (cache->resv_exc_ptr != resv_exc_ptr)) {
+		_avail_res_cache_clear(cache);
+		cache->cr_type = cr_type;
+		cache->test_only = test_only;
+		cache->will_run = will_run;
+		cache->resv_exc_ptr = resv_exc_ptr;
+	}
+	if (!cache->fail)
+		cache->fail = xcalloc(node_record_count,
+				      sizeof(avail_res_fail_t));
+}
+
+/*
+ * Wrapper for _can_job_run_on_node() which skips nodes that already failed
+ * the test with identical inputs during this job_test() call.
+ * Only the cache record of node_i is used, so different nodes can be tested
+ * concurrently.
+ */
+static avail_res_t *_can_job_run_on_node_cached(res_avail_args_t *args,
+						const uint32_t node_i,
+						uint32_t *hits)
+{
+	avail_res_cache_t *cache = args->cache;
+	avail_res_fail_t *fail;
+	avail_res_t *avail_res;
+	bitstr_t **core_map = args->core_map;
+	bitstr_t *part_cores = NULL;
+	uint32_t state_gen = args->node_usage[node_i].state_gen;
+
+	if (!cache || !state_gen)
+		return _can_job_run_on_node(args->job_ptr, core_map, node_i,
+					    args->s_p_n, args->node_usage,
+					    args->cr_type, args->test_only,
+					    args->will_run,
+					    args->part_core_map,
+					    args->resv_exc_ptr);
+
+	if (args->part_core_map)
+		part_cores = args->part_core_map[node_i];
+	fail = &cache->fail[node_i];
+	if ((fail->state_gen == state_gen) && (fail->s_p_n == args->s_p_n) &&
+	    _avail_res_cores_match(fail->core_map, core_map[node_i], false) &&
+	    _avail_res_cores_match(fail->part_core_map, part_cores, true)) {
+		(*hits)++;
+		return NULL;
+	}
+
+	/* _can_job_run_on_node() may modify core_map, save the inputs */
+	FREE_NULL_BITMAP(fail->core_map);
+	FREE_NULL_BITMAP(fail->part_core_map);
+	fail->state_gen = 0;
+	if (core_map[node_i])
+		fail->core_map = bit_copy(core_map[node_i]);
+	if (part_cores)
+		fail->part_core_map = bit_copy(part_cores);
+
+	avail_res = _can_job_run_on_node(args->job_ptr, core_map, node_i,
+					 args->s_p_n, args->node_usage,
+					 args->cr_type, args->test_only,
+					 args->will_run, args->part_core_map,
+					 args->resv_exc_ptr);
+	if (avail_res) {
+		FREE_NULL_BITMAP(fail->core_map);
+		FREE_NULL_BITMAP(fail->part_core_map);
+	} else {
+		fail->s_p_n = args->s_p_n;
+		fail->state_gen = state_gen;
+	}
+
+	return avail_res;
+}
+
+/*
+ * Test chunks of the candidate nodes until none are left. Every node is
+ * tested by exactly one thread and only touches its own entries of the
+ * avail_res_array, core_map and part_core_map arrays.
+ */
+static void *_res_avail_worker(void *arg)
+{
+	res_avail_args_t *args = arg;
+	uint32_t hits = 0;
+	int i, i_end;
+
+	while (true) {
+		slurm_mutex_lock(&args->mutex);
+		i = args->next_node;
+		args->next_node += RES_AVAIL_CHUNK;
+		slurm_mutex_unlock(&args->mutex);
+		if (i > args->i_last)
+			break;
+
+		i_end = MIN(i + RES_AVAIL_CHUNK - 1, args->i_last);
+		for (; i <= i_end; i++) {
+			if (!bit_test(args->node_map, i))
+				continue;
+			args->avail_res_array[i] =
+				_can_job_run_on_node_cached(args, i, &hits);
+		}
+	}
+
+	slurm_mutex_lock(&args->mutex);
+	args->hits += hits;
+	slurm_mutex_unlock(&args->mutex);
+
+	return NULL;
+}
+
 static avail_res_t **_get_res_avail(job_record_t *job_ptr,
 				    bitstr_t *node_map, bitstr_t **core_map,
 				    node_use_record_t *node_usage,
@@ -710,27 +921,51 @@ static avail_res_t **_get_res_avail(job_record_t *job_ptr,
 				    bool will_run, bitstr_t **part_core_map,
 				    resv_exc_t *resv_exc_ptr)
 {
-	int i, i_first, i_last;
-	avail_res_t **avail_res_array = NULL;
-	uint32_t s_p_n = _socks_per_node(job_ptr);
+	int i_first, thread_cnt = 1;
+	pthread_t threads[RES_AVAIL_THREADS_MAX];
+	res_avail_args_t args = {
+		.cache = avail_res_cache,
+		.core_map = core_map,
+		.cr_type = cr_type,
+		.job_ptr = job_ptr,
+		.node_map = node_map,
+		.node_usage = node_usage,
+		.part_core_map = part_core_map,
+		.resv_exc_ptr = resv_exc_ptr,
+		.s_p_n = _socks_per_node(job_ptr),
+		.test_only = test_only,
+		.will_run = will_run,
+	};
 
-	avail_res_array = xcalloc(node_record_count, sizeof(avail_res_t *));
+	args.avail_res_array = xcalloc(node_record_count,
+				       sizeof(avail_res_t *));
 	i_first = bit_ffs(node_map);
-	if (i_first != -1)
-		i_last = bit_fls(node_map);
-	else
-		i_last = -2;
-	for (i = i_first; i <= i_last; i++) {
-		if (bit_test(node_map, i))
-			avail_res_array[i] =
-				_can_job_run_on_node(
-					job_ptr, core_map, i,
-					s_p_n, node_usage,
-					cr_type, test_only, will_run,
-					part_core_map, resv_exc_ptr);
-	}
-
-	return avail_res_array;
+	if (i_first == -1)
+		return args.avail_res_array;
+	args.next_node = i_first;
+	args.i_last = bit_fls(node_map);
+
+	if (args.cache)
+		_avail_res_cache_prep(args.cache, cr_type, test_only, will_run,
+				      resv_exc_ptr);
+
+	if ((select_test_threads > 1) &&
+	    (bit_set_count(node_map) >= RES_AVAIL_PARALLEL_MIN))
+		thread_cnt = select_test_threads;
+
+	slurm_mutex_init(&args.mutex);
+	/* The calling thread is one of the workers */
+	for (int t = 1; t < thread_cnt; t++)
+		slurm_thread_create(&threads[t], _res_avail_worker, &args);
+	_res_avail_worker(&args);
+	for (int t = 1; t < thread_cnt; t++)
+		slurm_thread_join(threads[t]);
+	slurm_mutex_destroy(&args.mutex);
+
+	if (args.cache)
+		args.cache->hits += args.hits;
+
+	return args.avail_res_array;
 }
 
 /* For a given job already past it's end time, guess when it will actually end.
@@ -794,9 +1029,6 @@ static int _is_node_busy(part_res_record_t *p_ptr, uint32_t node_i,
 			if (!p_ptr->row[r].row_bitmap)
 				continue;
 
-			if (!p_ptr->row[r].row_bitmap[node_i])
-				continue;
-
 			if (jobs &&
 			    list_find_first(jobs, _is_job_sharing, NULL))
 				return 1;
@@ -3382,6 +3614,13 @@ extern int job_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 		node_data_dump();
 	}
 
+	/*
+	 * Building the GRES socket lists dominates the node tests of jobs
+	 * requesting GRES, remember nodes which failed them
+	 */
+	if (job_ptr->gres_list_req)
+		avail_res_cache = xmalloc(sizeof(avail_res_cache_t));
+
 	if (mode == SELECT_MODE_WILL_RUN) {
 		rc = _will_run_test(job_ptr, node_bitmap, min_nodes,
 				    max_nodes,
@@ -3401,8 +3640,10 @@ extern int job_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 		/* Should never get here */
 		error("Mode %d is invalid",
 		      mode);
+		_avail_res_cache_fini(job_ptr);
 		return EINVAL;
 	}
+	_avail_res_cache_fini(job_ptr);
 
 	if ((slurm_conf.debug_flags & DEBUG_FLAG_CPU_BIND) ||
 	    (slurm_conf.debug_flags & DEBUG_FLAG_SELECT_TYPE)) {
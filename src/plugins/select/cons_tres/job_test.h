@@ -38,11 +38,15 @@
 
 #include "select_cons_tres.h"
 
+/* Maximum value of SchedulerParameters=select_test_threads */
+#define RES_AVAIL_THREADS_MAX 64
+
 extern uint64_t def_cpu_per_gpu;
 extern uint64_t def_mem_per_gpu;
 extern bool preempt_strict_order;
 extern bool preempt_for_licenses;
 extern int preempt_reorder_cnt;
+extern int select_test_threads;
 
 /*
  * job_test - Given a specification of scheduling requirements,
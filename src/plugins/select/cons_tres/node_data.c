@@ -62,6 +62,16 @@ extern void node_data_destroy(node_use_record_t *node_usage)
 	}
 }
 
+extern void node_data_touch(node_use_record_t *node_usage)
+{
+	/* Protected by the node write lock held by all callers */
+	static uint32_t state_gen = 0;
+
+	if (++state_gen == 0)
+		state_gen = 1;
+	node_usage->state_gen = state_gen;
+}
+
 extern void node_data_dump(void)
 {
 	node_record_t *node_ptr;
@@ -118,6 +128,7 @@ extern node_use_record_t *node_data_dup_use(
 	     i++) {
 		new_ptr[i].node_state   = orig_ptr[i].node_state;
 		new_ptr[i].alloc_memory = orig_ptr[i].alloc_memory;
+		new_ptr[i].state_gen    = orig_ptr[i].state_gen;
 		if (orig_ptr[i].gres_list)
 			gres_list = orig_ptr[i].gres_list;
 		else
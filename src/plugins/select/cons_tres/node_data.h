@@ -48,6 +48,8 @@ typedef struct {
 				       * to emulate future node state */
 	List jobs; /* List of jobs running on node */
 	uint16_t node_state;	      /* see node_cr_state comments */
+	uint32_t state_gen;	      /* changed whenever memory or GRES use
+				       * of this node changes, 0 if unknown */
 } node_use_record_t;
 
 extern node_use_record_t *select_node_usage;
@@ -57,6 +59,9 @@ extern void node_data_destroy(node_use_record_t *node_usage);
 
 extern void node_data_dump(void);
 
+/* Note that the memory or GRES use of this node record has changed */
+extern void node_data_touch(node_use_record_t *node_usage);
+
 extern node_use_record_t *node_data_dup_use(node_use_record_t *orig_ptr,
 					    bitstr_t *node_map);
 
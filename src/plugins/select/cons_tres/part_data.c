@@ -88,9 +88,13 @@ static void _swap_rows(part_row_data_t *a, part_row_data_t *b)
 	memcpy(b, &tmprow, sizeof(part_row_data_t));
 }
 
+/*
+ * Release the row's per-node bitmaps rather than clearing them, so the row
+ * only holds bitmaps for the nodes used by the jobs added back to it.
+ */
 static void _reset_part_row_bitmap(part_row_data_t *r_ptr)
 {
-	clear_core_array(r_ptr->row_bitmap);
+	free_core_array(&r_ptr->row_bitmap);
 	r_ptr->row_set_count = 0;
 }
 
@@ -319,6 +323,63 @@ extern void part_data_build_row_bitmaps(part_res_record_t *p_ptr,
 	 */
 }
 
+/*
+ * part_data_rm_job_from_row: Patch the row which held a removed job, then
+ *                     pull jobs of less allocated rows down into the cores
+ *                     it freed. Only part_data_build_row_bitmaps() repacks
+ *                     all rows.
+ */
+extern void part_data_rm_job_from_row(part_res_record_t *p_ptr,
+				      struct job_resources *job,
+				      uint32_t r_inx)
+{
+	part_row_data_t *r_ptr = &p_ptr->row[r_inx], *src_ptr;
+	struct job_resources *tmp_job;
+	uint32_t i, j;
+	bool moved = false;
+
+	if (r_ptr->num_jobs == 0)
+		_reset_part_row_bitmap(r_ptr);
+	else
+		job_res_rm_cores(job, r_ptr);
+
+	/* A pending full rebuild will repack the rows anyway */
+	if ((p_ptr->num_rows == 1) || p_ptr->rebuild_rows)
+		return;
+
+	/* Rows are sorted from most to least allocated */
+	for (i = r_inx + 1; i < p_ptr->num_rows; i++) {
+		src_ptr = &p_ptr->row[i];
+		for (j = 0; j < src_ptr->num_jobs; ) {
+			tmp_job = src_ptr->job_list[j];
+			if (!bit_overlap_any(tmp_job->node_bitmap,
+					     job->node_bitmap) ||
+			    !job_res_fit_in_row(tmp_job, r_ptr)) {
+				j++;
+				continue;
+			}
+			src_ptr->num_jobs--;
+			memmove(&src_ptr->job_list[j],
+				&src_ptr->job_list[j + 1],
+				(src_ptr->num_jobs - j) *
+				sizeof(struct job_resources *));
+			src_ptr->job_list[src_ptr->num_jobs] = NULL;
+			if (src_ptr->num_jobs == 0)
+				_reset_part_row_bitmap(src_ptr);
+			else
+				job_res_rm_cores(tmp_job, src_ptr);
+			part_data_add_job_to_row(tmp_job, r_ptr);
+			moved = true;
+		}
+	}
+
+	if (moved) {
+		debug3("moved jobs into part %s row %u",
+		       p_ptr->part_ptr->name, r_inx);
+		part_data_sort_res(p_ptr);
+	}
+}
+
 /* (re)create the global select_part_record array */
 extern void part_data_create_array(void)
 {
@@ -46,6 +46,8 @@ typedef struct {
 					 * job_list array */
 	bitstr_t **row_bitmap;		/* contains core bitmap for all jobs in
 					 * this row, one bitstr_t for each node
+					 * with cores allocated in this row,
+					 * NULL for other nodes.
 					 * In cons_res only the first ptr is
 					 * used.
 					 */
@@ -81,6 +83,20 @@ extern void part_data_add_job_to_row(struct job_resources *job,
 extern void part_data_build_row_bitmaps(part_res_record_t *p_ptr,
 					job_record_t *job_ptr);
 
+/*
+ * part_data_rm_job_from_row: A job has been removed from the job_list of the
+ *                     given row. Clear its cores from that row and move jobs
+ *                     of less allocated rows sharing nodes with it into the
+ *                     freed cores, rather than repacking every row.
+ *
+ * IN p_ptr - the partition the job was removed from
+ * IN job - resources of the removed job
+ * IN r_inx - index of the row which held the job
+ */
+extern void part_data_rm_job_from_row(part_res_record_t *p_ptr,
+				      struct job_resources *job,
+				      uint32_t r_inx);
+
 /* (re)create the global select_part_record array */
 extern void part_data_create_array(void);
 
@@ -311,6 +311,18 @@ extern int select_p_node_init(void)
 	} else
 		bf_window_scale = 0;
 
+	select_test_threads = 0;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+				   "select_test_threads="))) {
+		select_test_threads = atoi(tmp_ptr + 20);
+		if ((select_test_threads < 0) ||
+		    (select_test_threads > RES_AVAIL_THREADS_MAX)) {
+			error("Invalid SchedulerParameters select_test_threads: %d",
+			      select_test_threads);
+			select_test_threads = 0;	/* Use default value */
+		}
+	}
+
 	if (xstrcasestr(slurm_conf.sched_params, "spec_cores_first"))
 		spec_cores_first = true;
 	else
@@ -348,6 +360,7 @@ extern int select_p_node_init(void)
 		select_node_usage[node_ptr->index].node_state =
 			NODE_CR_AVAILABLE;
 		gres_node_state_dealloc_all(node_ptr->gres_list);
+		node_data_touch(&select_node_usage[node_ptr->index]);
 	}
 
 	part_data_create_array();
@@ -695,6 +708,7 @@ extern int select_p_job_resized(job_record_t *job_ptr, node_record_t *node_ptr)
 			return SLURM_SUCCESS;
 		}
 
+		node_data_touch(&node_usage[i]);
 		if (node_usage[i].gres_list)
 			gres_list = node_usage[i].gres_list;
 		else
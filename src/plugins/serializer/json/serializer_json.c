@@ -35,11 +35,9 @@
 
 #include "config.h"
 
-#if HAVE_JSON_C_INC
-#include <json-c/json.h>
-#else
-#include <json/json.h>
-#endif
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
 
 #include "slurm/slurm.h"
 #include "src/common/slurm_xlator.h"
@@ -48,6 +46,7 @@
 #include "src/common/log.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/serializer.h"
 
@@ -85,7 +84,29 @@ const char *mime_types[] = {
 	NULL
 };
 
-static json_object *_data_to_json(const data_t *d);
+#define JSON_OUT_MIN_SIZE 4096
+/* same nesting limit as the default json-c tokener */
+#define JSON_MAX_DEPTH 32
+
+/*
+ * JSON text being written directly from a data_t tree, without building the
+ * equivalent json-c object tree first. The layout is the one json-c uses for
+ * JSON_C_TO_STRING_PLAIN and JSON_C_TO_STRING_SPACED|JSON_C_TO_STRING_PRETTY.
+ */
+typedef struct {
+	char *buf;
+	size_t len;
+	size_t size;
+	bool pretty;
+} json_out_t;
+
+typedef struct {
+	json_out_t *out;
+	int level;
+	bool had_children;
+} json_dump_args_t;
+
+static void _dump_data(json_out_t *out, const data_t *d, int level);
 
 extern int serializer_p_init(void)
 {
@@ -101,130 +122,665 @@ extern int serializer_p_fini(void)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * JSON text being parsed directly into a data_t tree. Accepts the same
+ * relaxed input as the json-c tokener in its default (non-strict) mode:
+ * comments, trailing commas, single quoted strings and NaN/Infinity.
+ */
+typedef struct {
+	const char *src;
+	const char *pos;
+	const char *end;
+	int depth;
+	const char *err;
+} json_parse_t;
+
+static int _parse_value(json_parse_t *p, data_t *d);
 
-static json_object *_try_parse(const char *src, size_t stringlen,
-			       struct json_tokener *tok)
+static int _parse_fail(json_parse_t *p, const char *err)
 {
-	json_object *jobj = json_tokener_parse_ex(tok, src, stringlen);
+	if (!p->err)
+		p->err = err;
 
-	if (jobj == NULL) {
-		enum json_tokener_error jerr = json_tokener_get_error(tok);
-		error("%s: JSON parsing error %zu bytes: %s",
-		      __func__, stringlen, json_tokener_error_desc(jerr));
-		return NULL;
+	return ESLURM_REST_FAIL_PARSING;
+}
+
+/* Skip whitespace and C/C++ style comments */
+static void _skip_ws(json_parse_t *p)
+{
+	while (p->pos < p->end) {
+		const char c = *p->pos;
+
+		if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r')) {
+			p->pos++;
+		} else if ((c == '/') && ((p->end - p->pos) >= 2) &&
+			   (p->pos[1] == '*')) {
+			const char *close = NULL;
+
+			for (const char *s = p->pos + 2; s < (p->end - 1); s++) {
+				if ((s[0] == '*') && (s[1] == '/')) {
+					close = s;
+					break;
+				}
+			}
+
+			p->pos = (close ? (close + 2) : p->end);
+		} else if ((c == '/') && ((p->end - p->pos) >= 2) &&
+			   (p->pos[1] == '/')) {
+			const char *nl = memchr(p->pos, '\n', (p->end - p->pos));
+
+			p->pos = (nl ? (nl + 1) : p->end);
+		} else {
+			return;
+		}
 	}
-	if (tok->char_offset < stringlen)
-		log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
-		     __func__, (stringlen - tok->char_offset));
+}
 
-	return jobj;
+static bool _match(json_parse_t *p, const char *literal, size_t len)
+{
+	if (((p->end - p->pos) < len) || memcmp(p->pos, literal, len))
+		return false;
+
+	p->pos += len;
+	return true;
 }
 
-static data_t *_json_to_data(json_object *jobj, data_t *d)
+static int _parse_hex4(json_parse_t *p, const char *s, uint32_t *cp)
 {
-	size_t arraylen = 0;
+	uint32_t v = 0;
 
-	if (!d)
-		d = data_new();
+	if ((p->end - s) < 4)
+		return _parse_fail(p, "truncated unicode escape");
 
-	switch (json_object_get_type(jobj)) {
-	case json_type_null:
-		data_set_null(d);
-		break;
-	case json_type_boolean:
-		data_set_bool(d, json_object_get_boolean(jobj));
-		break;
-	case json_type_double:
-		data_set_float(d, json_object_get_double(jobj));
+	for (int i = 0; i < 4; i++) {
+		const char c = s[i];
+
+		v <<= 4;
+		if ((c >= '0') && (c <= '9'))
+			v |= c - '0';
+		else if ((c >= 'a') && (c <= 'f'))
+			v |= c - 'a' + 10;
+		else if ((c >= 'A') && (c <= 'F'))
+			v |= c - 'A' + 10;
+		else
+			return _parse_fail(p, "invalid unicode escape");
+	}
+
+	*cp = v;
+	return SLURM_SUCCESS;
+}
+
+static char *_put_utf8(char *dst, uint32_t cp)
+{
+	if (cp < 0x80) {
+		*dst++ = cp;
+	} else if (cp < 0x800) {
+		*dst++ = 0xc0 | (cp >> 6);
+		*dst++ = 0x80 | (cp & 0x3f);
+	} else if (cp < 0x10000) {
+		*dst++ = 0xe0 | (cp >> 12);
+		*dst++ = 0x80 | ((cp >> 6) & 0x3f);
+		*dst++ = 0x80 | (cp & 0x3f);
+	} else {
+		*dst++ = 0xf0 | (cp >> 18);
+		*dst++ = 0x80 | ((cp >> 12) & 0x3f);
+		*dst++ = 0x80 | ((cp >> 6) & 0x3f);
+		*dst++ = 0x80 | (cp & 0x3f);
+	}
+
+	return dst;
+}
+
+/* Decode escaped string body [s, end) into dst which is large enough */
+static int _unescape(json_parse_t *p, const char *s, const char *end,
+		     char *dst)
+{
+	while (s < end) {
+		uint32_t cp, low;
+
+		if (*s != '\\') {
+			*dst++ = *s++;
+			continue;
+		}
+
+		s++;
+		switch (*s++) {
+		case '"':
+			*dst++ = '"';
+			break;
+		case '\'':
+			*dst++ = '\'';
+			break;
+		case '\\':
+			*dst++ = '\\';
+			break;
+		case '/':
+			*dst++ = '/';
+			break;
+		case 'b':
+			*dst++ = '\b';
+			break;
+		case 'f':
+			*dst++ = '\f';
+			break;
+		case 'n':
+			*dst++ = '\n';
+			break;
+		case 'r':
+			*dst++ = '\r';
+			break;
+		case 't':
+			*dst++ = '\t';
+			break;
+		case 'u':
+			if (_parse_hex4(p, s, &cp))
+				return ESLURM_REST_FAIL_PARSING;
+			s += 4;
+
+			if ((cp >= 0xd800) && (cp <= 0xdbff) &&
+			    ((end - s) >= 6) && (s[0] == '\\') &&
+			    (s[1] == 'u') && !_parse_hex4(p, (s + 2), &low) &&
+			    (low >= 0xdc00) && (low <= 0xdfff)) {
+				cp = 0x10000 + ((cp - 0xd800) << 10) +
+				     (low - 0xdc00);
+				s += 6;
+			} else if ((cp >= 0xd800) && (cp <= 0xdfff)) {
+				/* unpaired surrogate */
+				cp = 0xfffd;
+			}
+
+			dst = _put_utf8(dst, cp);
+			break;
+		default:
+			return _parse_fail(p, "invalid escape sequence");
+		}
+	}
+
+	*dst = '\0';
+	return SLURM_SUCCESS;
+}
+
+/* Parse quoted string at p->pos into a new xmalloc()ed string */
+static int _parse_string(json_parse_t *p, char **str_ptr)
+{
+	const char quote = *p->pos;
+	const char *start = p->pos + 1;
+	const char *s = start;
+	bool escaped = false;
+
+	while ((s < p->end) && (*s != quote)) {
+		if (*s == '\\') {
+			escaped = true;
+			s++;
+		}
+		s++;
+	}
+
+	if (s >= p->end)
+		return _parse_fail(p, "unterminated string");
+
+	p->pos = s + 1;
+
+	if (!escaped) {
+		*str_ptr = xstrndup(start, (s - start));
+		return SLURM_SUCCESS;
+	}
+
+	/* unescaped text is never longer than the escaped text */
+	*str_ptr = xmalloc_nz((s - start) + 1);
+	if (_unescape(p, start, s, *str_ptr)) {
+		xfree(*str_ptr);
+		return ESLURM_REST_FAIL_PARSING;
+	}
+
+	return SLURM_SUCCESS;
+}
+
+static int _parse_number(json_parse_t *p, data_t *d)
+{
+	const char *start = p->pos, *s = p->pos;
+	bool is_float = false;
+	char buf[64], *num = buf;
+	size_t len;
+
+	if ((s < p->end) && (*s == '-'))
+		s++;
+	if ((s >= p->end) || !isdigit((unsigned char) *s))
+		return _parse_fail(p, "invalid number");
+	while ((s < p->end) && isdigit((unsigned char) *s))
+		s++;
+
+	if ((s < p->end) && (*s == '.')) {
+		is_float = true;
+		s++;
+		if ((s >= p->end) || !isdigit((unsigned char) *s))
+			return _parse_fail(p, "invalid number fraction");
+		while ((s < p->end) && isdigit((unsigned char) *s))
+			s++;
+	}
+
+	if ((s < p->end) && ((*s == 'e') || (*s == 'E'))) {
+		is_float = true;
+		s++;
+		if ((s < p->end) && ((*s == '+') || (*s == '-')))
+			s++;
+		if ((s >= p->end) || !isdigit((unsigned char) *s))
+			return _parse_fail(p, "invalid number exponent");
+		while ((s < p->end) && isdigit((unsigned char) *s))
+			s++;
+	}
+
+	/* source is not required to be \0 terminated */
+	len = s - start;
+	if (len < sizeof(buf)) {
+		memcpy(buf, start, len);
+		buf[len] = '\0';
+	} else {
+		num = xstrndup(start, len);
+	}
+
+	if (!is_float) {
+		int64_t value;
+
+		errno = 0;
+		value = strtoll(num, NULL, 10);
+
+		/* too large for an integer: keep it as a double */
+		if (errno == ERANGE)
+			is_float = true;
+		else
+			data_set_int(d, value);
+	}
+
+	if (is_float)
+		data_set_float(d, strtod(num, NULL));
+
+	if (num != buf)
+		xfree(num);
+
+	p->pos = s;
+	return SLURM_SUCCESS;
+}
+
+static int _parse_list(json_parse_t *p, data_t *d)
+{
+	int rc;
+
+	data_set_list(d);
+	p->pos++;
+	_skip_ws(p);
+
+	if ((p->pos < p->end) && (*p->pos == ']')) {
+		p->pos++;
+		return SLURM_SUCCESS;
+	}
+
+	while (true) {
+		if ((rc = _parse_value(p, data_list_append(d))))
+			return rc;
+
+		_skip_ws(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated array");
+
+		if (*p->pos == ']') {
+			p->pos++;
+			return SLURM_SUCCESS;
+		} else if (*p->pos != ',') {
+			return _parse_fail(p, "expected ',' or ']' in array");
+		}
+
+		p->pos++;
+		_skip_ws(p);
+
+		/* allow trailing comma */
+		if ((p->pos < p->end) && (*p->pos == ']')) {
+			p->pos++;
+			return SLURM_SUCCESS;
+		}
+	}
+}
+
+static int _parse_dict(json_parse_t *p, data_t *d)
+{
+	int rc;
+
+	data_set_dict(d);
+	p->pos++;
+	_skip_ws(p);
+
+	if ((p->pos < p->end) && (*p->pos == '}')) {
+		p->pos++;
+		return SLURM_SUCCESS;
+	}
+
+	while (true) {
+		char *key = NULL;
+
+		if ((p->pos >= p->end) || ((*p->pos != '"') &&
+					   (*p->pos != '\'')))
+			return _parse_fail(p, "expected object key string");
+
+		if ((rc = _parse_string(p, &key)))
+			return rc;
+
+		_skip_ws(p);
+		if ((p->pos >= p->end) || (*p->pos != ':')) {
+			xfree(key);
+			return _parse_fail(p, "expected ':' after object key");
+		}
+		p->pos++;
+
+		rc = _parse_value(p, data_key_set(d, key));
+		xfree(key);
+		if (rc)
+			return rc;
+
+		_skip_ws(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated object");
+
+		if (*p->pos == '}') {
+			p->pos++;
+			return SLURM_SUCCESS;
+		} else if (*p->pos != ',') {
+			return _parse_fail(p, "expected ',' or '}' in object");
+		}
+
+		p->pos++;
+		_skip_ws(p);
+
+		/* allow trailing comma */
+		if ((p->pos < p->end) && (*p->pos == '}')) {
+			p->pos++;
+			return SLURM_SUCCESS;
+		}
+	}
+}
+
+static int _parse_value(json_parse_t *p, data_t *d)
+{
+	int rc;
+
+	_skip_ws(p);
+
+	if (p->pos >= p->end)
+		return _parse_fail(p, "unexpected end of input");
+
+	switch (*p->pos) {
+	case '{':
+	case '[':
+		if (++p->depth > JSON_MAX_DEPTH)
+			return _parse_fail(p, "nesting too deep");
+
+		if (*p->pos == '{')
+			rc = _parse_dict(p, d);
+		else
+			rc = _parse_list(p, d);
+
+		p->depth--;
+		return rc;
+	case '"':
+	case '\'':
+	{
+		char *str = NULL;
+
+		if ((rc = _parse_string(p, &str)))
+			return rc;
+
+		data_set_string_own(d, str);
+		return SLURM_SUCCESS;
+	}
+	case 't':
+		if (_match(p, "true", 4)) {
+			data_set_bool(d, true);
+			return SLURM_SUCCESS;
+		}
 		break;
-	case json_type_int:
-		data_set_int(d, json_object_get_int64(jobj));
+	case 'f':
+		if (_match(p, "false", 5)) {
+			data_set_bool(d, false);
+			return SLURM_SUCCESS;
+		}
 		break;
-	case json_type_object:
-		data_set_dict(d);
-		/* warning: json_object_object_foreach is an evil macro */
-		json_object_object_foreach(jobj, key, val) {
-			_json_to_data(val, data_key_set(d, key));
+	case 'n':
+		if (_match(p, "null", 4)) {
+			data_set_null(d);
+			return SLURM_SUCCESS;
 		}
 		break;
-	case json_type_array:
-		arraylen = json_object_array_length(jobj);
-		data_set_list(d);
-		for (size_t i = 0; i < arraylen; i++)
-			_json_to_data(json_object_array_get_idx(jobj, i),
-				      data_list_append(d));
+	case 'N':
+		if (_match(p, "NaN", 3)) {
+			data_set_float(d, NAN);
+			return SLURM_SUCCESS;
+		}
 		break;
-	case json_type_string:
-		data_set_string(d, json_object_get_string(jobj));
+	case 'I':
+		if (_match(p, "Infinity", 8)) {
+			data_set_float(d, INFINITY);
+			return SLURM_SUCCESS;
+		}
 		break;
+	case '-':
+		if (_match(p, "-Infinity", 9)) {
+			data_set_float(d, -INFINITY);
+			return SLURM_SUCCESS;
+		}
+		return _parse_number(p, d);
 	default:
-		fatal_abort("%s: unknown JSON type", __func__);
-	};
+		if (isdigit((unsigned char) *p->pos))
+			return _parse_number(p, d);
+	}
+
+	return _parse_fail(p, "unexpected character");
+}
 
-	return d;
+static void _append(json_out_t *out, const char *str, size_t len)
+{
+	if ((out->len + len + 1) > out->size) {
+		out->size = MAX(out->size * 2, out->len + len + 1);
+		out->size = MAX(out->size, JSON_OUT_MIN_SIZE);
+		xrealloc_nz(out->buf, out->size);
+	}
+
+	memcpy(out->buf + out->len, str, len);
+	out->len += len;
+	out->buf[out->len] = '\0';
 }
 
-static data_for_each_cmd_t _convert_dict_json(const char *key,
-					      const data_t *data,
-					      void *arg)
+#define _append_str(out, str) _append(out, str, strlen(str))
+
+static void _indent(json_out_t *out, int level)
 {
-	json_object *jobj = arg;
-	json_object *jobject = _data_to_json(data);
+	static const char spaces[] = "                                ";
+
+	if (!out->pretty)
+		return;
+
+	for (int cnt = level * 2; cnt > 0; cnt -= (sizeof(spaces) - 1))
+		_append(out, spaces, MIN(cnt, (sizeof(spaces) - 1)));
+}
+
+/* Same escaping as json-c without JSON_C_TO_STRING_NOSLASHESCAPE */
+static void _dump_string(json_out_t *out, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char *start = str;
+
+	_append(out, "\"", 1);
+	for (; *str; str++) {
+		const unsigned char c = *str;
+		const char *esc = NULL;
+		char uesc[7];
+
+		switch (c) {
+		case '\b':
+			esc = "\\b";
+			break;
+		case '\n':
+			esc = "\\n";
+			break;
+		case '\r':
+			esc = "\\r";
+			break;
+		case '\t':
+			esc = "\\t";
+			break;
+		case '\f':
+			esc = "\\f";
+			break;
+		case '"':
+			esc = "\\\"";
+			break;
+		case '\\':
+			esc = "\\\\";
+			break;
+		case '/':
+			esc = "\\/";
+			break;
+		default:
+			if (c >= ' ')
+				continue;
+			snprintf(uesc, sizeof(uesc), "\\u00%c%c",
+				 hex[c >> 4], hex[c & 0xf]);
+			esc = uesc;
+		}
+
+		_append(out, start, (str - start));
+		_append_str(out, esc);
+		start = str + 1;
+	}
+	_append(out, start, (str - start));
+	_append(out, "\"", 1);
+}
+
+static void _dump_float(json_out_t *out, double value)
+{
+	char buf[64];
+
+	if (isnan(value)) {
+		_append_str(out, "NaN");
+	} else if (isinf(value)) {
+		_append_str(out, ((value > 0) ? "Infinity" : "-Infinity"));
+	} else {
+		int len = snprintf(buf, sizeof(buf), "%.17g", value);
+
+		/* keep the value a double when parsed again */
+		if (!strpbrk(buf, ".eE") && (len < (sizeof(buf) - 2)))
+			strcat(buf, ".0");
+		_append_str(out, buf);
+	}
+}
+
+/* Write the separator and indentation before the next child */
+static void _dump_child_start(json_dump_args_t *args)
+{
+	if (args->had_children) {
+		_append(args->out, ",", 1);
+		if (args->out->pretty)
+			_append(args->out, "\n", 1);
+	}
+	args->had_children = true;
+	_indent(args->out, args->level + 1);
+}
+
+static void _dump_end(json_dump_args_t *args, const char *close)
+{
+	if (args->out->pretty) {
+		if (args->had_children)
+			_append(args->out, "\n", 1);
+		_indent(args->out, args->level);
+	}
+	_append_str(args->out, close);
+}
+
+static data_for_each_cmd_t _dump_dict_entry(const char *key,
+					    const data_t *data,
+					    void *arg)
+{
+	json_dump_args_t *args = arg;
+
+	_dump_child_start(args);
+	_dump_string(args->out, key);
+	if (args->out->pretty)
+		_append(args->out, ": ", 2);
+	else
+		_append(args->out, ":", 1);
+	_dump_data(args->out, data, (args->level + 1));
 
-	json_object_object_add(jobj, key, jobject);
 	return DATA_FOR_EACH_CONT;
 }
 
-static data_for_each_cmd_t _convert_list_json(const data_t *data, void *arg)
+static data_for_each_cmd_t _dump_list_entry(const data_t *data, void *arg)
 {
-	json_object *jobj = arg;
-	json_object *jarray = _data_to_json(data);
+	json_dump_args_t *args = arg;
+
+	_dump_child_start(args);
+	_dump_data(args->out, data, (args->level + 1));
 
-	json_object_array_add(jobj, jarray);
 	return DATA_FOR_EACH_CONT;
 }
 
-static json_object *_data_to_json(const data_t *d)
+static void _dump_data(json_out_t *out, const data_t *d, int level)
 {
-	if (!d)
-		return NULL;
+	char buf[32];
+
+	if (!d) {
+		_append_str(out, "null");
+		return;
+	}
 
 	switch (data_get_type(d)) {
 	case DATA_TYPE_NULL:
-		return NULL;
+		_append_str(out, "null");
 		break;
 	case DATA_TYPE_BOOL:
-		return json_object_new_boolean(data_get_bool(d));
+		_append_str(out, (data_get_bool(d) ? "true" : "false"));
 		break;
 	case DATA_TYPE_FLOAT:
-		return json_object_new_double(data_get_float(d));
+		_dump_float(out, data_get_float(d));
 		break;
 	case DATA_TYPE_INT_64:
-		return json_object_new_int64(data_get_int(d));
+		snprintf(buf, sizeof(buf), "%"PRId64, data_get_int(d));
+		_append_str(out, buf);
 		break;
 	case DATA_TYPE_DICT:
 	{
-		json_object *jobj = json_object_new_object();
-		if (data_dict_for_each_const(d, _convert_dict_json, jobj) < 0)
-			error("%s: unexpected error calling _convert_dict_json()",
+		json_dump_args_t args = {
+			.out = out,
+			.level = level,
+		};
+
+		_append(out, "{", 1);
+		if (out->pretty)
+			_append(out, "\n", 1);
+		if (data_dict_for_each_const(d, _dump_dict_entry, &args) < 0)
+			error("%s: unexpected error calling _dump_dict_entry()",
 			      __func__);
-		return jobj;
+		_dump_end(&args, "}");
+		break;
 	}
 	case DATA_TYPE_LIST:
 	{
-		json_object *jobj = json_object_new_array();
-		if (data_list_for_each_const(d, _convert_list_json, jobj) < 0)
-			error("%s: unexpected error calling _convert_list_json()",
+		json_dump_args_t args = {
+			.out = out,
+			.level = level,
+		};
+
+		_append(out, "[", 1);
+		if (out->pretty)
+			_append(out, "\n", 1);
+		if (data_list_for_each_const(d, _dump_list_entry, &args) < 0)
+			error("%s: unexpected error calling _dump_list_entry()",
 			      __func__);
-		return jobj;
+		_dump_end(&args, "]");
+		break;
 	}
 	case DATA_TYPE_STRING:
 	{
 		const char *str = data_get_string(d);
-		if (str)
-			return json_object_new_string(str);
-		else
-			return json_object_new_string("");
+
+		_dump_string(out, (str ? str : ""));
 		break;
 	}
 	default:
@@ -236,66 +792,59 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
-	struct json_object *jobj = _data_to_json(src);
-	int jflags = 0;
+	json_out_t out = {
+		.pretty = (flags == SER_FLAGS_PRETTY),
+	};
 
 	/* can't be pretty and compact at the same time! */
 	xassert((flags & (SER_FLAGS_PRETTY | SER_FLAGS_COMPACT)) !=
 		(SER_FLAGS_PRETTY | SER_FLAGS_COMPACT));
 
-	switch (flags) {
-	case SER_FLAGS_PRETTY:
-		jflags = JSON_C_TO_STRING_SPACED | JSON_C_TO_STRING_PRETTY;
-		break;
-	case SER_FLAGS_COMPACT: /* fallthrough */
-	default:
-		jflags = JSON_C_TO_STRING_PLAIN;
-	}
+	/*
+	 * Write the text straight from the data_t tree. Converting to a json-c
+	 * tree first would hold a third copy of large responses in memory.
+	 */
+	_dump_data(&out, src, 0);
 
-	/* string will die with jobj */
-	*dest = xstrdup(json_object_to_json_string_ext(jobj, jflags));
+	*dest = out.buf;
 	if (length) {
 		/* add 1 for \0 */
-		*length = strlen(*dest) + 1;
+		*length = out.len + 1;
 	}
 
-	/* put is equiv to free() */
-	json_object_put(jobj);
-
 	return SLURM_SUCCESS;
 }
 
 extern int serialize_p_string_to_data(data_t **dest, const char *src,
 				      size_t length)
 {
-	json_object *jobj = NULL;
+	json_parse_t p;
 	data_t *data = NULL;
-	struct json_tokener *tok = json_tokener_new();
-	int rc;
-
-	if (!tok)
-		return ENOMEM;
 
 	if (!src)
 		return ESLURM_DATA_PTR_NULL;
 
-	/* json-c has hard limit of 32 bits */
-	if (length >= INT32_MAX) {
-		error("%s: unable to parse JSON: too large",
-		      __func__);
-		return ESLURM_DATA_TOO_LARGE;
-	}
+	/* callers may include the \0 terminator in length */
+	p = (json_parse_t) {
+		.src = src,
+		.pos = src,
+		.end = src + strnlen(src, length),
+	};
 
-	jobj = _try_parse(src, length, tok);
-	if (jobj) {
-		data = _json_to_data(jobj, NULL);
-		json_object_put(jobj);
-		rc = SLURM_SUCCESS;
-	} else
-		rc = ESLURM_REST_FAIL_PARSING;
+	data = data_new();
+	if (_parse_value(&p, data)) {
+		error("%s: JSON parsing error at byte %zu of %zu: %s",
+		      __func__, (p.pos - p.src), length, p.err);
+		FREE_NULL_DATA(data);
+		*dest = NULL;
+		return ESLURM_REST_FAIL_PARSING;
+	}
 
-	json_tokener_free(tok);
+	_skip_ws(&p);
+	if (p.pos < p.end)
+		log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
+			 __func__, (p.end - p.pos));
 
 	*dest = data;
-	return rc;
+	return SLURM_SUCCESS;
 }
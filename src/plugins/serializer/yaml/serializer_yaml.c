@@ -35,6 +35,7 @@
 
 #include "config.h"
 
+#include <limits.h>
 #include <yaml.h>
 
 #include "slurm/slurm.h"
@@ -80,6 +81,8 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 #define YAML_MAX_DEPTH 64
 #define LOG_LENGTH 16
+/* Large enough for "%lf" of any double (DBL_MAX has 309 digits) */
+#define NUMBER_BUFFER_SIZE 320
 
 const char *mime_types[] = {
 	"application/yaml", /* RFC9512 */
@@ -148,22 +151,6 @@ static const struct {
 	}
 };
 
-typedef enum {
-	PARSE_INVALID = 0,
-	/* inital state before parsing started */
-	PARSE_NOT_STARTED,
-
-	/* parsing states */
-	PARSE_CONTINUE,
-	PARSE_POP,
-
-	/* completion states */
-	PARSE_DONE,
-	PARSE_FAIL,
-
-	PARSE_INVALID_MAX
-} parse_state_t;
-
 #define T(X) { X, XSTRINGIFY(X) }
 static const struct {
 	yaml_event_type_t type;
@@ -183,12 +170,35 @@ static const struct {
 };
 #undef T
 
+/*
+ * YAML text written directly from a data_t tree, byte for byte identical to
+ * what the libyaml emitter produces for the same tree. Only scalars that
+ * libyaml would write plain or single quoted are handled. Anything else sets
+ * unsupported and the whole tree is dumped again via libyaml.
+ */
+typedef struct {
+	char *buf;
+	size_t len;
+	size_t size;
+	int column;
+	int width; /* libyaml best_width */
+	bool unsupported;
+} yaml_out_t;
+
+typedef enum {
+	YAML_CTXT_ROOT = 0,
+	YAML_CTXT_MAP_VALUE,
+	YAML_CTXT_SEQ_ITEM,
+} yaml_ctxt_t;
+
+typedef struct {
+	yaml_out_t *out;
+	int indent;
+} yaml_dump_args_t;
+
 static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter);
-static parse_state_t _yaml_to_data(int depth, yaml_parser_t *parser,
-				   data_t *dst, int *rc);
-static parse_state_t _on_parse_event(int depth, yaml_parser_t *parser,
-				     yaml_event_t *event, data_t *dst, int *rc,
-				     parse_state_t state);
+static void _fast_dump_node(yaml_out_t *out, const data_t *d, int indent,
+			    yaml_ctxt_t ctxt);
 
 extern int serializer_p_init(void)
 {
@@ -229,155 +239,173 @@ static data_type_t _yaml_tag_to_type(yaml_event_t *event, const char *source)
 	return DATA_TYPE_NONE;
 }
 
-static parse_state_t _on_parse_scalar(int depth, yaml_parser_t *parser,
-				      yaml_event_t *event, data_t *dst, int *rc,
-				      parse_state_t state)
+/*
+ * Get the data_t the next value event will be parsed into
+ * IN stack - containers currently being parsed
+ * IN depth - number of containers in stack
+ * IN/OUT key - dictionary entry waiting for its value (or NULL)
+ * IN event - scalar event to use as key if stack top is a dict
+ * RET data_t ptr for value, or NULL if event was consumed as dict key
+ */
+static data_t *_get_value_dst(data_t **stack, int depth, data_t **key,
+			      yaml_event_t *event, int *rc)
 {
-	data_type_t tag;
-	const char *value = (const char *) event->data.scalar.value;
+	data_t *dst, *top = stack[depth - 1];
 
-	if (data_get_type(dst) == DATA_TYPE_DICT) {
-		data_t *child = data_key_set(dst, value);
-		log_flag(DATA, "PUSH %pD[%s]=%pD", dst, value, child);
-		return _yaml_to_data((depth + 1), parser, child, rc);
+	if (data_get_type(top) == DATA_TYPE_LIST) {
+		dst = data_list_append(top);
+		log_flag(DATA, "PUSH %pD[]=%pD", top, dst);
+		return dst;
 	}
 
-	xassert(data_get_type(dst) == DATA_TYPE_NULL);
-	tag = _yaml_tag_to_type(event, __func__);
-	data_set_string(dst, value);
+	if (data_get_type(top) != DATA_TYPE_DICT) {
+		/* only root is not a container */
+		xassert(depth == 1);
+
+		if (data_get_type(top) != DATA_TYPE_NULL) {
+			error("%s: YAML parser does not support multiple documents",
+			      __func__);
+			*rc = ESLURM_NOT_SUPPORTED;
+		}
+
+		return (*rc ? NULL : top);
+	}
 
-	if ((tag != DATA_TYPE_NONE) &&
-	    (data_convert_type(dst, tag) != tag)) {
-		*rc = ESLURM_DATA_CONV_FAILED;
-		return PARSE_FAIL;
+	if ((dst = *key)) {
+		*key = NULL;
+		return dst;
 	}
 
-	return PARSE_POP;
+	if (event->type != YAML_SCALAR_EVENT) {
+		error("%s: YAML parser only supports scalars as mapping keys",
+		      __func__);
+		*rc = ESLURM_NOT_SUPPORTED;
+		return NULL;
+	}
+
+	*key = data_key_set(top, (const char *) event->data.scalar.value);
+	log_flag(DATA, "PUSH %pD[%s]=%pD",
+		 top, event->data.scalar.value, *key);
+	return NULL;
 }
 
-static parse_state_t _on_parse_event(int depth, yaml_parser_t *parser,
-				     yaml_event_t *event, data_t *dst, int *rc,
-				     parse_state_t state)
+static int _on_parse_scalar(yaml_event_t *event, data_t *dst)
 {
-	if ((data_get_type(dst) == DATA_TYPE_LIST) &&
-	    ((event->type == YAML_SCALAR_EVENT) ||
-	     (event->type == YAML_SEQUENCE_START_EVENT) ||
-	     (event->type == YAML_MAPPING_START_EVENT))) {
-		data_t *child = data_list_append(dst);
-		log_flag(DATA, "PUSH %pD[]=%pD", dst, child);
-		state = _on_parse_event((depth + 1), parser, event, child, rc,
-					 state);
-		return (state == PARSE_POP) ? PARSE_CONTINUE : state;
-	}
+	data_type_t tag = _yaml_tag_to_type(event, __func__);
+
+	xassert(data_get_type(dst) == DATA_TYPE_NULL);
+	data_set_string(dst, (const char *) event->data.scalar.value);
+
+	if ((tag != DATA_TYPE_NONE) && (data_convert_type(dst, tag) != tag))
+		return ESLURM_DATA_CONV_FAILED;
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Handle a single parser event
+ * IN/OUT stack - containers currently being parsed
+ * IN/OUT depth - number of containers in stack
+ * IN/OUT key - dictionary entry waiting for its value
+ * IN event - event to apply
+ * IN/OUT done - set to true once stream has ended
+ * RET SLURM_SUCCESS or error
+ */
+static int _on_parse_event(data_t **stack, int *depth, data_t **key,
+			   yaml_event_t *event, bool *done)
+{
+	int rc = SLURM_SUCCESS;
+	data_t *dst;
 
 	switch (event->type) {
 	case YAML_NO_EVENT:
-		xassert(state == PARSE_CONTINUE);
-		return PARSE_DONE;
-
-	case YAML_DOCUMENT_START_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_NULL);
-		xassert(state == PARSE_CONTINUE);
-		return PARSE_CONTINUE;
+	case YAML_STREAM_END_EVENT:
+		*done = true;
+		return SLURM_SUCCESS;
 	case YAML_STREAM_START_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_NULL);
-		xassert(state == PARSE_NOT_STARTED);
-		return PARSE_CONTINUE;
+	case YAML_DOCUMENT_START_EVENT:
 	case YAML_DOCUMENT_END_EVENT:
-		xassert(state == PARSE_CONTINUE);
-		return PARSE_CONTINUE;
-	case YAML_STREAM_END_EVENT:
-		xassert(state == PARSE_CONTINUE);
-		return PARSE_DONE;
-
+		return SLURM_SUCCESS;
 	case YAML_ALIAS_EVENT:
 		error("%s: YAML parser does not support aliases", __func__);
-		*rc = ESLURM_NOT_SUPPORTED;
-		return PARSE_FAIL;
-
+		return ESLURM_NOT_SUPPORTED;
+	case YAML_SEQUENCE_END_EVENT:
+	case YAML_MAPPING_END_EVENT:
+		/* libyaml only emits balanced end events */
+		xassert(*depth > 1);
+		xassert(!*key);
+		(*depth)--;
+		log_flag(DATA, "%pD{%d} -> POP", stack[*depth], *depth);
+		return SLURM_SUCCESS;
 	case YAML_SCALAR_EVENT:
-		return _on_parse_scalar(depth, parser, event, dst, rc, state);
-
 	case YAML_SEQUENCE_START_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_NULL);
-		data_set_list(dst);
-		state = _yaml_to_data((depth + 1), parser, dst, rc);
-		return (state == PARSE_CONTINUE) ? PARSE_POP : state;
-	case YAML_SEQUENCE_END_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_LIST);
-		return PARSE_POP;
-
 	case YAML_MAPPING_START_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_NULL);
-		data_set_dict(dst);
-		state = _yaml_to_data((depth + 1), parser, dst, rc);
-		return (state == PARSE_CONTINUE) ? PARSE_POP : state;
-	case YAML_MAPPING_END_EVENT:
-		xassert(data_get_type(dst) == DATA_TYPE_DICT);
-		return PARSE_POP;
+		break;
 	}
 
-	fatal_abort("should never execute");
-}
+	if (!(dst = _get_value_dst(stack, *depth, key, event, &rc)))
+		return rc;
 
-/*
- * parse yaml stream into data_t recursively
- * IN depth current parsing depth
- * IN parser yaml stream parser
- * IN dst data object to populate
- * IN rc ptr to return code
- * RET parsing state
- */
-static parse_state_t _yaml_to_data(int depth, yaml_parser_t *parser,
-				   data_t *dst, int *rc)
-{
-	parse_state_t state = PARSE_NOT_STARTED;
+	if (event->type == YAML_SCALAR_EVENT)
+		return _on_parse_scalar(event, dst);
 
 	/* sanity check nesting depth */
-	if (depth > YAML_MAX_DEPTH) {
+	if (*depth > YAML_MAX_DEPTH) {
 		error("%s: YAML nested too deep (%d layers) at %pD",
-		      __func__, depth, dst);
-		*rc = ESLURM_DATA_PARSING_DEPTH;
-		return PARSE_FAIL;
+		      __func__, *depth, dst);
+		return ESLURM_DATA_PARSING_DEPTH;
 	}
 
-	while (state < PARSE_DONE) {
-		yaml_event_t event;
+	if (event->type == YAML_SEQUENCE_START_EVENT)
+		data_set_list(dst);
+	else
+		data_set_dict(dst);
 
-		xassert(state > PARSE_INVALID);
-		xassert(state < PARSE_INVALID_MAX);
+	stack[(*depth)++] = dst;
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Parse yaml stream into data_t without recursion. Nested sequences and
+ * mappings are tracked on an explicit stack instead.
+ * IN parser - yaml stream parser
+ * IN data - data object to populate
+ * RET SLURM_SUCCESS or error
+ */
+static int _yaml_to_data(yaml_parser_t *parser, data_t *data)
+{
+	data_t *stack[YAML_MAX_DEPTH + 2] = { data };
+	data_t *key = NULL;
+	int depth = 1, rc = SLURM_SUCCESS;
+	bool done = false;
+
+	while (!rc && !done) {
+		yaml_event_t event;
 
 		if (!yaml_parser_parse(parser, &event)) {
-			yaml_event_delete(&event);
 			error("%s: YAML parser error: %s",
 			      __func__, (char *) parser->problem);
-			*rc = ESLURM_DATA_PARSER_INVALID_STATE;
-			return PARSE_FAIL;
+			return ESLURM_DATA_PARSER_INVALID_STATE;
 		}
 
 		log_flag_hex_range(DATA, parser->buffer.start,
 				   (parser->buffer.last - parser->buffer.start),
 				   event.start_mark.index,
 				   (event.start_mark.index + LOG_LENGTH),
-				   "%s: %pD{%d} -> %s", __func__, dst, depth,
+				   "%s: %pD{%d} -> %s", __func__,
+				   stack[depth - 1], depth,
 				   _yaml_event_type_string(event.type));
 
-		state = _on_parse_event(depth, parser, &event, dst, rc, state);
-
-		if (state == PARSE_POP) {
-			log_flag(DATA, "%pD{%d} -> POP", dst, depth);
-			state = PARSE_CONTINUE;
-			break;
-		}
+		rc = _on_parse_event(stack, &depth, &key, &event, &done);
+		yaml_event_delete(&event);
 	}
 
-	return PARSE_CONTINUE;
+	return rc;
 }
 
 static int _parse_yaml(const char *buffer, yaml_parser_t *parser, data_t *data)
 {
 	const unsigned char *buf = (const unsigned char *) buffer;
-	int rc = SLURM_SUCCESS;
 
 	xassert(data);
 	if (!data)
@@ -391,9 +419,7 @@ static int _parse_yaml(const char *buffer, yaml_parser_t *parser, data_t *data)
 
 	yaml_parser_set_input_string(parser, buf, strlen(buffer));
 
-	(void) _yaml_to_data(0, parser, data, &rc);
-
-	return rc;
+	return _yaml_to_data(parser, data);
 }
 
 /*
@@ -513,8 +539,11 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 		return SLURM_SUCCESS;
 	case DATA_TYPE_FLOAT:
 	{
-		char *buffer = xstrdup_printf("%lf", data_get_float(d));
-		if (buffer == NULL) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		int len = snprintf(buffer, sizeof(buffer), "%lf",
+				   data_get_float(d));
+
+		if ((len < 0) || (len >= sizeof(buffer))) {
 			error("%s: unable to print double to string: %m",
 			      __func__);
 			return SLURM_ERROR;
@@ -522,13 +551,9 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 
 		if (!yaml_scalar_event_initialize(
 			    &event, NULL, (yaml_char_t *)YAML_FLOAT_TAG,
-			    (yaml_char_t *)buffer, strlen(buffer), 0, 0,
-			    YAML_ANY_SCALAR_STYLE)) {
-			xfree(buffer);
+			    (yaml_char_t *)buffer, len, 0, 0,
+			    YAML_ANY_SCALAR_STYLE))
 			_yaml_emitter_error;
-		}
-
-		xfree(buffer);
 
 		if (!yaml_emitter_emit(emitter, &event))
 			_yaml_emitter_error;
@@ -537,8 +562,11 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 	}
 	case DATA_TYPE_INT_64:
 	{
-		char *buffer = xstrdup_printf("%"PRId64, data_get_int(d));
-		if (buffer == NULL) {
+		char buffer[NUMBER_BUFFER_SIZE];
+		int len = snprintf(buffer, sizeof(buffer), "%"PRId64,
+				   data_get_int(d));
+
+		if ((len < 0) || (len >= sizeof(buffer))) {
 			error("%s: unable to print int to string: %m",
 			      __func__);
 			return SLURM_ERROR;
@@ -546,13 +574,9 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 
 		if (!yaml_scalar_event_initialize(
 			    &event, NULL, (yaml_char_t *)YAML_INT_TAG,
-			    (yaml_char_t *)buffer, strlen(buffer), 0, 0,
-			    YAML_ANY_SCALAR_STYLE)) {
-			xfree(buffer);
+			    (yaml_char_t *)buffer, len, 0, 0,
+			    YAML_ANY_SCALAR_STYLE))
 			_yaml_emitter_error;
-		}
-
-		xfree(buffer);
 
 		if (!yaml_emitter_emit(emitter, &event))
 			_yaml_emitter_error;
@@ -627,9 +651,17 @@ static int _yaml_write_handler(void *data, unsigned char *buffer, size_t size)
 	 * If the remaining buffer size equals the required argument size, we
 	 * still want to grow to allocate space for an extra '\0'. That's why in
 	 * this case we compare with '<=' instead of '<'.
+	 *
+	 * Grow by at least the current size to avoid reallocating (and
+	 * copying) the whole output for every chunk libyaml flushes.
 	 */
-	if ((rc = try_grow_buf_remaining(buf, (size + 1))))
-		return rc;
+	if ((remaining_buf(buf) < (size + 1)) &&
+	    (rc = try_grow_buf(buf, MAX((size + 1), size_buf(buf))))) {
+		error("%s: unable to grow output buffer: %s",
+		      __func__, slurm_strerror(rc));
+		/* libyaml expects 0 on failure */
+		return 0;
+	}
 
 	memcpy(buf->head + buf->processed, buffer, size);
 
@@ -702,12 +734,332 @@ yaml_fail:
 
 #undef _yaml_emitter_error
 
+#define YAML_OUT_MIN_SIZE 4096
+/* libyaml default best_width */
+#define YAML_WIDTH 80
+/*
+ * libyaml writes keys longer than 128 characters (including the tag) as
+ * complex keys which are not handled here
+ */
+#define YAML_SIMPLE_KEY_MAX 120
+
+static void _fast_append(yaml_out_t *out, const char *str, size_t len)
+{
+	if ((out->len + len + 1) > out->size) {
+		out->size = MAX(out->size * 2, out->len + len + 1);
+		out->size = MAX(out->size, YAML_OUT_MIN_SIZE);
+		xrealloc_nz(out->buf, out->size);
+	}
+
+	memcpy(out->buf + out->len, str, len);
+	out->len += len;
+	out->buf[out->len] = '\0';
+	out->column += len;
+}
+
+#define _fast_append_str(out, str) _fast_append(out, str, strlen(str))
+
+/* Start new line at indent as yaml_emitter_write_indent() would */
+static void _fast_indent(yaml_out_t *out, int indent)
+{
+	static const char spaces[] = "                                ";
+
+	_fast_append(out, "\n", 1);
+	out->column = 0;
+
+	for (int cnt = indent; cnt > 0; cnt -= (sizeof(spaces) - 1))
+		_fast_append(out, spaces, MIN(cnt, (sizeof(spaces) - 1)));
+}
+
+/*
+ * Mirror yaml_emitter_analyze_scalar() for block context
+ * IN str - string to check
+ * IN len - strlen(str)
+ * RET true if libyaml would write string plain or false for single quoted
+ *	Sets out->unsupported for anything needing double quotes.
+ */
+static bool _fast_is_plain(yaml_out_t *out, const char *str, size_t len)
+{
+	bool block_indicators = false;
+
+	if (!len)
+		return true;
+
+	if ((len >= 3) &&
+	    (!strncmp(str, "---", 3) || !strncmp(str, "...", 3)))
+		block_indicators = true;
+
+	for (size_t i = 0; i < len; i++) {
+		const char c = str[i];
+		const bool followed_by_ws =
+			((i + 1) >= len) || (str[i + 1] == ' ');
+
+		/* libyaml escapes everything else in double quotes */
+		if ((c < 0x20) || (c > 0x7e)) {
+			out->unsupported = true;
+			return false;
+		}
+
+		if (!i) {
+			if (strchr("#,[]{}&*!|>'\"%@`", c))
+				block_indicators = true;
+			else if (((c == '?') || (c == ':') || (c == '-')) &&
+				 followed_by_ws)
+				block_indicators = true;
+		} else if ((c == ':') && followed_by_ws) {
+			block_indicators = true;
+		} else if ((c == '#') && (str[i - 1] == ' ')) {
+			block_indicators = true;
+		}
+	}
+
+	/* leading or trailing spaces can't be plain */
+	if ((str[0] == ' ') || (str[len - 1] == ' '))
+		return false;
+
+	return !block_indicators;
+}
+
+/*
+ * Write string as yaml_emitter_write_plain() or
+ * yaml_emitter_write_single_quoted() would, including folding lines at
+ * spaces past the width when allowed.
+ */
+static void _fast_dump_text(yaml_out_t *out, const char *str, size_t len,
+			    bool quoted, bool allow_breaks, int indent)
+{
+	bool spaces = false;
+	size_t start = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		if (str[i] == ' ') {
+			/* column before writing this space */
+			const int column = out->column + (i - start);
+
+			if (allow_breaks && !spaces && (column > out->width) &&
+			    (!quoted || (i && (i != (len - 1)))) &&
+			    (str[i + 1] != ' ')) {
+				_fast_append(out, (str + start), (i - start));
+				_fast_indent(out, indent);
+				start = i + 1;
+			}
+
+			spaces = true;
+		} else {
+			if (quoted && (str[i] == '\'')) {
+				/* include quote twice */
+				_fast_append(out, (str + start), (i - start));
+				start = i;
+				_fast_append(out, "'", 1);
+			}
+
+			spaces = false;
+		}
+	}
+
+	_fast_append(out, (str + start), (len - start));
+}
+
+/* Write tagged scalar that follows an indicator or the tag of a key */
+static void _fast_dump_scalar(yaml_out_t *out, const char *tag,
+			      const char *str, bool key, int indent)
+{
+	const size_t len = strlen(str);
+	bool plain;
+
+	if (key && (len > YAML_SIMPLE_KEY_MAX)) {
+		out->unsupported = true;
+		return;
+	}
+
+	plain = _fast_is_plain(out, str, len);
+
+	/* empty keys are always quoted */
+	if (key && !len)
+		plain = false;
+
+	if (out->unsupported)
+		return;
+
+	/* keys always start a new line */
+	if (!key)
+		_fast_append(out, " ", 1);
+	_fast_append_str(out, tag);
+
+	if (plain) {
+		if (!len)
+			return;
+
+		_fast_append(out, " ", 1);
+		_fast_dump_text(out, str, len, false, !key, indent);
+	} else {
+		_fast_append(out, " '", 2);
+		_fast_dump_text(out, str, len, true, !key, indent);
+		_fast_append(out, "'", 1);
+	}
+}
+
+static data_for_each_cmd_t _fast_dump_dict_entry(const char *key,
+						 const data_t *data,
+						 void *arg)
+{
+	yaml_dump_args_t *args = arg;
+
+	_fast_indent(args->out, args->indent);
+	_fast_dump_scalar(args->out, "!!str", key, true, args->indent);
+	_fast_append(args->out, ":", 1);
+	_fast_dump_node(args->out, data, args->indent, YAML_CTXT_MAP_VALUE);
+
+	return (args->out->unsupported ? DATA_FOR_EACH_STOP :
+		DATA_FOR_EACH_CONT);
+}
+
+static data_for_each_cmd_t _fast_dump_list_entry(const data_t *data,
+						 void *arg)
+{
+	yaml_dump_args_t *args = arg;
+
+	_fast_indent(args->out, args->indent);
+	_fast_append(args->out, "-", 1);
+	_fast_dump_node(args->out, data, args->indent, YAML_CTXT_SEQ_ITEM);
+
+	return (args->out->unsupported ? DATA_FOR_EACH_STOP :
+		DATA_FOR_EACH_CONT);
+}
+
+/*
+ * Write node following "---", ":" or "-"
+ * IN indent - indent of containing mapping or sequence (-1 for root)
+ * IN ctxt - where node is being written
+ */
+static void _fast_dump_node(yaml_out_t *out, const data_t *d, int indent,
+			    yaml_ctxt_t ctxt)
+{
+	/* libyaml indents scalars as flow nodes */
+	const int scalar_indent = (indent < 0) ? 2 : (indent + 2);
+	char buffer[NUMBER_BUFFER_SIZE];
+
+	switch (data_get_type(d)) {
+	case DATA_TYPE_NULL:
+		_fast_dump_scalar(out, "!!null", YAML_NULL, false,
+				  scalar_indent);
+		break;
+	case DATA_TYPE_BOOL:
+		_fast_dump_scalar(out, "!!bool",
+				  (data_get_bool(d) ? YAML_TRUE : YAML_FALSE),
+				  false, scalar_indent);
+		break;
+	case DATA_TYPE_FLOAT:
+		snprintf(buffer, sizeof(buffer), "%lf", data_get_float(d));
+		_fast_dump_scalar(out, "!!float", buffer, false,
+				  scalar_indent);
+		break;
+	case DATA_TYPE_INT_64:
+		snprintf(buffer, sizeof(buffer), "%"PRId64, data_get_int(d));
+		_fast_dump_scalar(out, "!!int", buffer, false, scalar_indent);
+		break;
+	case DATA_TYPE_STRING:
+	{
+		const char *str = data_get_string(d);
+
+		if (!str) {
+			_fast_dump_scalar(out, "!!null", YAML_NULL, false,
+					  scalar_indent);
+			break;
+		}
+
+		_fast_dump_scalar(out, "!!str", str, false, scalar_indent);
+		break;
+	}
+	case DATA_TYPE_DICT:
+	{
+		yaml_dump_args_t args = {
+			.out = out,
+			.indent = ((indent < 0) ? 0 : (indent + 2)),
+		};
+
+		if (!data_get_dict_length(d)) {
+			_fast_append_str(out, " !!map {}");
+			break;
+		}
+
+		_fast_append_str(out, " !!map");
+		(void) data_dict_for_each_const(d, _fast_dump_dict_entry,
+						&args);
+		break;
+	}
+	case DATA_TYPE_LIST:
+	{
+		yaml_dump_args_t args = {
+			.out = out,
+			.indent = indent,
+		};
+
+		/* sequences in mappings are not indented */
+		if (indent < 0)
+			args.indent = 0;
+		else if (ctxt != YAML_CTXT_MAP_VALUE)
+			args.indent += 2;
+
+		if (!data_get_list_length(d)) {
+			_fast_append_str(out, " !!seq []");
+			break;
+		}
+
+		_fast_append_str(out, " !!seq");
+		(void) data_list_for_each_const(d, _fast_dump_list_entry,
+						&args);
+		break;
+	}
+	default:
+		xassert(false);
+		out->unsupported = true;
+	}
+}
+
+/*
+ * Dump data without libyaml
+ * RET SLURM_SUCCESS or ESLURM_NOT_SUPPORTED if libyaml must be used instead
+ */
+static int _fast_dump_yaml(const data_t *data, char **dest, size_t *length,
+			   serializer_flags_t flags)
+{
+	yaml_out_t out = {
+		.width = ((flags == SER_FLAGS_COMPACT) ? INT_MAX : YAML_WIDTH),
+	};
+
+	_fast_append_str(&out, "%YAML 1.1");
+	_fast_indent(&out, 0);
+	_fast_append_str(&out, "---");
+	_fast_dump_node(&out, data, -1, YAML_CTXT_ROOT);
+	_fast_append_str(&out, "\n...\n");
+
+	if (out.unsupported) {
+		xfree(out.buf);
+		return ESLURM_NOT_SUPPORTED;
+	}
+
+	*dest = out.buf;
+	if (length)
+		*length = out.len;
+
+	return SLURM_SUCCESS;
+}
+
 extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
 	yaml_emitter_t emitter;
-	buf_t *buf = init_buf(0);
+	buf_t *buf;
+
+	if (!_fast_dump_yaml(src, dest, length, flags))
+		return SLURM_SUCCESS;
+
+	log_flag(DATA, "%s: falling back to libyaml emitter for %pD",
+		 __func__, src);
+
+	buf = init_buf(0);
 
 	if (_dump_yaml(src, &emitter, buf, flags)) {
 		error("%s: dump yaml failed", __func__);
@@ -742,6 +1094,7 @@ extern int serialize_p_string_to_data(data_t **dest, const char *src,
 	data = data_new();
 
 	if (_parse_yaml(src, &parser, data)) {
+		yaml_parser_delete(&parser);
 		FREE_NULL_DATA(data);
 		return ESLURM_DATA_CONV_FAILED;
 	}
@@ -107,6 +107,11 @@ static void _task_layout_display_masks(launch_tasks_request_msg_t *req,
 {
 	int i;
 	char *str = NULL;
+
+	/* Formatting every mask is not free on large nodes, skip if unseen */
+	if (get_log_level() < LOG_LEVEL_DEBUG3)
+		return;
+
 	for(i = 0; i < maxtasks; i++) {
 		str = (char *)bit_fmt_hexmask(masks[i]);
 		debug3("_task_layout_display_masks jobid [%u:%d] %s",
@@ -1349,17 +1354,16 @@ static bitstr_t *_lllp_map_abstract_mask(bitstr_t *bitmask)
 	bitstr_t *newmask = NULL;
 	newmask = (bitstr_t *) bit_alloc(num_bits);
 
-	/* remap to physical machine */
-	for (i = 0; i < num_bits; i++) {
-		if (bit_test(bitmask,i)) {
-			bit = BLOCK_MAP(i);
-			if (bit < bit_size(newmask))
-				bit_set(newmask, bit);
-			else
-				error("can't go from %d -> %d since we "
-				      "only have %"BITSTR_FMT" bits",
-				      i, bit, bit_size(newmask));
-		}
+	/* remap to physical machine, only visiting the bits that are set */
+	for (i = bit_ffs(bitmask); i >= 0;
+	     i = bit_ffs_from_bit(bitmask, i + 1)) {
+		bit = BLOCK_MAP(i);
+		if (bit < num_bits)
+			bit_set(newmask, bit);
+		else
+			error("can't go from %d -> %d since we "
+			      "only have %d bits",
+			      i, bit, num_bits);
 	}
 	return newmask;
 }
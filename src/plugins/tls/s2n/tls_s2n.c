@@ -269,6 +269,17 @@ extern void *tls_p_create_conn(int fd, tls_conn_mode_t tls_mode)
 		goto fail;
 	}
 
+	/*
+	 * Use full sized TLS records from the start. Slurm messages are
+	 * written in one piece, so the small initial records of dynamic
+	 * record sizing only add framing and encryption overhead.
+	 */
+	if (s2n_connection_prefer_throughput(conn->s2n_conn) < 0) {
+		error("%s: s2n_connection_prefer_throughput: %s",
+		      __func__, s2n_strerror(s2n_errno, NULL));
+		goto fail;
+	}
+
 	if (s2n_connection_append_psk(conn->s2n_conn, psk) < 0) {
 		error("%s: s2n_connection_append_psk: %s",
 		      __func__, s2n_strerror(s2n_errno, NULL));
@@ -400,7 +411,15 @@ extern ssize_t tls_p_recv(tls_conn_t *conn, void *buf, size_t n)
 			/* connection closed */
 			break;
 		} else if (s2n_error_get_type(s2n_errno) == S2N_ERR_T_BLOCKED) {
-			/* busy wait until we get further data */
+			/* wait for further data instead of spinning on it */
+			if ((blocked == S2N_BLOCKED_ON_READ) &&
+			    wait_fd_readable(conn->fd,
+					     slurm_conf.msg_timeout)) {
+				error("%s: Problem reading socket, couldn't receive data",
+				      __func__);
+				slurm_mutex_unlock(&conn->lock);
+				return SLURM_ERROR;
+			}
 			continue;
 		} else {
 			error("%s: s2n_recv: %s",
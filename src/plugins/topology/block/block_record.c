@@ -44,6 +44,7 @@ typedef struct slurm_conf_block {
 } slurm_conf_block_t;
 
 bitstr_t *blocks_nodes_bitmap = NULL;	/* nodes on any bblock */
+bool bblocks_disjoint = false;		/* no node is on two bblocks */
 block_record_t *block_record_table = NULL;
 uint16_t bblock_node_cnt = 0;
 bitstr_t *block_levels = NULL;
@@ -314,6 +315,14 @@ extern void block_record_validate(void)
 	}
 
 	if (blocks_nodes_bitmap) {
+		int bblock_nodes = 0;
+
+		for (i = 0; i < block_record_cnt; i++)
+			bblock_nodes +=
+				bit_set_count(block_record_table[i].node_bitmap);
+		bblocks_disjoint =
+			(bblock_nodes == bit_set_count(blocks_nodes_bitmap));
+
 		i = bit_clear_count(blocks_nodes_bitmap);
 		if (i > 0) {
 			char *tmp_nodes;
@@ -48,6 +48,7 @@ typedef struct {
 } block_record_t;
 
 extern bitstr_t *blocks_nodes_bitmap;	/* nodes on any bblock */
+extern bool bblocks_disjoint;		/* no node is on two bblocks */
 extern block_record_t *block_record_table;  /* ptr to block records */
 extern uint16_t bblock_node_cnt;
 extern bitstr_t *block_levels;
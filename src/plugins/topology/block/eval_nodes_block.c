@@ -171,6 +171,27 @@ static void _choose_best_bblock(bitstr_t *bblock_required,
 	}
 }
 
+/*
+ * Count the nodes of base block i which are in node_map, and their
+ * available CPUs.
+ */
+static void _count_bblock(topology_eval_t *topo_eval, int i,
+			  uint32_t *bblock_avail_nodes,
+			  uint32_t *bblock_avail_cpus)
+{
+	bitstr_t *node_bitmap = block_record_table[i].node_bitmap;
+
+	bblock_avail_nodes[i] = 0;
+	bblock_avail_cpus[i] = 0;
+	for (int n = 0; next_node_bitmap(node_bitmap, &n); n++) {
+		if (!bit_test(topo_eval->node_map, n))
+			continue;
+		bblock_avail_nodes[i]++;
+		bblock_avail_cpus[i] +=
+			topo_eval->avail_res_array[n]->avail_cpus;
+	}
+}
+
 extern int eval_nodes_block(topology_eval_t *topo_eval)
 {
 	bitstr_t **block_node_bitmap = NULL;	/* nodes on this block */
@@ -210,6 +231,8 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 	int llblock_size;
 	int llblock_cnt = 0;
 	uint32_t *nodes_on_llblock = NULL;
+	uint32_t *bblock_avail_nodes = NULL;	/* node_map nodes on bblock */
+	uint32_t *bblock_avail_cpus = NULL;	/* their available CPUs */
 	int block_level;
 	int bblock_per_llblock;
 	uint64_t maxtasks;
@@ -433,15 +456,46 @@ next_segment:
 		}
 	}
 
+	/*
+	 * With disjoint base blocks, per-bblock counts are built once and
+	 * only the bblocks of the block used by a segment are recounted
+	 * before the next segment.
+	 */
+	if (bblocks_disjoint && !bblock_avail_cpus) {
+		bblock_avail_nodes = xcalloc(block_record_cnt,
+					     sizeof(uint32_t));
+		bblock_avail_cpus = xcalloc(block_record_cnt,
+					    sizeof(uint32_t));
+		for (i = 0; i < block_record_cnt; i++)
+			_count_bblock(topo_eval, i, bblock_avail_nodes,
+				      bblock_avail_cpus);
+	}
+
 	block_inx = -1;
 	for (i = 0; i < block_cnt; i++) {
 		uint32_t block_cpus = 0;
 		uint32_t avail_bnc = 0;
-		uint32_t bnc;
+		uint32_t bnc = 0;
 
 		bit_and(block_node_bitmap[i], topo_eval->node_map);
 
-		bnc = bit_set_count(block_node_bitmap[i]);
+		if (bblock_avail_cpus) {
+			int last = MIN((i + 1) * bblock_per_block,
+				       block_record_cnt);
+			for (j = i * bblock_per_block; j < last; j++) {
+				bnc += bblock_avail_nodes[j];
+				block_cpus += bblock_avail_cpus[j];
+			}
+		} else {
+			bnc = bit_set_count(block_node_bitmap[i]);
+			/*
+			 * Count total CPUs of the intersection of
+			 * topo_eval->node_map and block_node_bitmap.
+			 */
+			for (j = 0; next_node_bitmap(block_node_bitmap[i], &j);
+			     j++)
+				block_cpus += avail_res_array[j]->avail_cpus;
+		}
 		if (!nodes_on_llblock) {
 			avail_bnc = bnc;
 		} else {
@@ -457,14 +511,6 @@ next_segment:
 			for (j = 0; j < tmp_max_llblock; j++)
 				avail_bnc += nodes_on_llblock[offset + j];
 		}
-		/*
-		 * Count total CPUs of the intersection of topo_eval->node_map
-		 * and block_node_bitmap.
-		 */
-		for (j = 0; (node_ptr = next_node_bitmap(block_node_bitmap[i],
-							 &j));
-		     j++)
-			block_cpus += avail_res_array[j]->avail_cpus;
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, block_node_bitmap[i])) {
 			if (block_inx == -1) {
@@ -891,6 +937,13 @@ fini:
 			FREE_NULL_LIST(node_weight_list);
 			bit_copybits(topo_eval->node_map, orig_node_map);
 			bit_and_not(topo_eval->node_map, alloc_node_map);
+			for (i = 0; bblock_avail_cpus && (i < block_record_cnt);
+			     i++) {
+				if (bblock_block_inx[i] != block_inx)
+					continue;
+				_count_bblock(topo_eval, i, bblock_avail_nodes,
+					      bblock_avail_cpus);
+			}
 			log_flag(SELECT_TYPE, "%s: rem_segment_cnt:%d",
 				 __func__, rem_segment_cnt);
 			goto next_segment;
@@ -923,6 +976,8 @@ fini:
 	}
 	xfree(nodes_on_bblock);
 	xfree(nodes_on_llblock);
+	xfree(bblock_avail_nodes);
+	xfree(bblock_avail_cpus);
 	FREE_NULL_BITMAP(bblock_required);
 	return rc;
 }
@@ -82,13 +82,16 @@ static List _build_node_weight_list(bitstr_t *node_bitmap)
 {
 	List node_list;
 	node_record_t *node_ptr;
-	node_weight_type *nwt;
+	node_weight_type *nwt = NULL;
 
 	xassert(node_bitmap);
 	/* Build list of node_weight_type records, one per node weight */
 	node_list = list_create(_node_weight_free);
 	for (int i = 0; (node_ptr = next_node_bitmap(node_bitmap, &i)); i++) {
-		nwt = list_find_first(node_list, _node_weight_find, node_ptr);
+		/* Nodes of a given weight are usually defined together */
+		if (!nwt || (nwt->weight != node_ptr->sched_weight))
+			nwt = list_find_first(node_list, _node_weight_find,
+					      node_ptr);
 		if (!nwt) {
 			nwt = xmalloc(sizeof(node_weight_type));
 			nwt->node_bitmap = bit_alloc(node_record_count);
@@ -511,13 +514,14 @@ static int _eval_nodes_busy(topology_eval_t *topo_eval)
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
 		for (idle_test = 0; idle_test < 2; idle_test++) {
-			for (i = i_start; i <= i_end; i++) {
+			/* Only visit the nodes of this weight */
+			for (i = bit_ffs(nwt->node_bitmap); i >= 0;
+			     i = bit_ffs_from_bit(nwt->node_bitmap, i + 1)) {
 				if (!avail_res_array[i] ||
 				    !avail_res_array[i]->avail_cpus)
 					continue;
-				/* Node not available or already selected */
-				if (!bit_test(nwt->node_bitmap, i) ||
-				    bit_test(topo_eval->node_map, i))
+				/* Node already selected */
+				if (bit_test(topo_eval->node_map, i))
 					continue;
 				if (((idle_test == 0) &&
 				     bit_test(idle_node_bitmap, i)) ||
@@ -1240,10 +1244,11 @@ static int _eval_nodes_lln(topology_eval_t *topo_eval)
 		while (!all_done) {
 			int max_cpu_idx = -1;
 			uint16_t max_cpu_avail_cpus = 0;
-			for (i = i_start; i <= i_end; i++) {
-				/* Node not available or already selected */
-				if (!bit_test(nwt->node_bitmap, i) ||
-				    bit_test(topo_eval->node_map, i))
+			/* Only visit the nodes of this weight */
+			for (i = bit_ffs(nwt->node_bitmap); i >= 0;
+			     i = bit_ffs_from_bit(nwt->node_bitmap, i + 1)) {
+				/* Node already selected */
+				if (bit_test(topo_eval->node_map, i))
 					continue;
 				if (!avail_res_array[i] ||
 				    !avail_res_array[i]->avail_cpus)
@@ -1441,15 +1446,16 @@ static int _eval_nodes_serial(topology_eval_t *topo_eval)
 	node_weight_list = _build_node_weight_list(orig_node_map);
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
-		for (i = i_end;
-		     ((i >= i_start) && (topo_eval->max_nodes > 0));
-		     i--) {
+		/* Only visit the nodes of this weight, from the end */
+		for (i = bit_fls(nwt->node_bitmap);
+		     ((i >= 0) && (topo_eval->max_nodes > 0));
+		     i = (i > 0) ? bit_fls_from_bit(nwt->node_bitmap, i - 1) :
+				   -1) {
 			if (!avail_res_array[i] ||
 			    !avail_res_array[i]->avail_cpus)
 				continue;
-			/* Node not available or already selected */
-			if (!bit_test(nwt->node_bitmap, i) ||
-			    bit_test(topo_eval->node_map, i))
+			/* Node already selected */
+			if (bit_test(topo_eval->node_map, i))
 				continue;
 			eval_nodes_select_cores(topo_eval, i, min_rem_nodes);
 			(void) eval_nodes_cpus_to_use(topo_eval, i,
@@ -1607,13 +1613,14 @@ static int _eval_nodes_spread(topology_eval_t *topo_eval)
 	node_weight_list = _build_node_weight_list(orig_node_map);
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
-		for (i = i_start; i <= i_end; i++) {
+		/* Only visit the nodes of this weight */
+		for (i = bit_ffs(nwt->node_bitmap); i >= 0;
+		     i = bit_ffs_from_bit(nwt->node_bitmap, i + 1)) {
 			if (!avail_res_array[i] ||
 			    !avail_res_array[i]->avail_cpus)
 				continue;
-			/* Node not available or already selected */
-			if (!bit_test(nwt->node_bitmap, i) ||
-			    bit_test(topo_eval->node_map, i))
+			/* Node already selected */
+			if (bit_test(topo_eval->node_map, i))
 				continue;
 			eval_nodes_select_cores(topo_eval, i, min_rem_nodes);
 			eval_nodes_cpus_to_use(topo_eval, i,
@@ -738,6 +738,41 @@ fini:
 	return rc;
 }
 
+/*
+ * Set the available nodes of switch i and count them and their CPUs.
+ * Switches of lower levels must already be counted.
+ */
+static void _topo_count_switch(topology_eval_t *topo_eval, int i,
+			       bitstr_t **switch_node_bitmap,
+			       int *switch_node_cnt, uint32_t *switch_cpu_cnt)
+{
+	switch_record_t *switch_ptr = &switch_record_table[i];
+	uint32_t switch_cpus = 0;
+
+	switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
+	bit_and(switch_node_bitmap[i], topo_eval->node_map);
+
+	if (switch_ptr->children_disjoint) {
+		switch_node_cnt[i] = 0;
+		for (int c = 0; c < switch_ptr->num_switches; c++) {
+			int child = switch_ptr->switch_index[c];
+			switch_node_cnt[i] += switch_node_cnt[child];
+			switch_cpus += switch_cpu_cnt[child];
+		}
+		switch_cpu_cnt[i] = switch_cpus;
+		return;
+	}
+
+	switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
+	/*
+	 * Count total CPUs of the intersection of node_map and
+	 * switch_node_bitmap.
+	 */
+	for (int j = 0; next_node_bitmap(switch_node_bitmap[i], &j); j++)
+		switch_cpus += topo_eval->avail_res_array[j]->avail_cpus;
+	switch_cpu_cnt[i] = switch_cpus;
+}
+
 /* Allocate resources to job using a minimal leaf switch count */
 static int _eval_nodes_topo(topology_eval_t *topo_eval)
 {
@@ -892,21 +927,23 @@ static int _eval_nodes_topo(topology_eval_t *topo_eval)
 	switch_required    = xcalloc(switch_record_cnt, sizeof(int));
 	req_switch_required = xcalloc(switch_record_cnt, sizeof(int));
 
+	/*
+	 * Count available nodes and CPUs from the leaves up, so that a switch
+	 * whose children share no nodes sums its children rather than
+	 * walking every node below it.
+	 */
+	for (int level = 0; level <= switch_levels; level++) {
+		for (i = 0, switch_ptr = switch_record_table;
+		     i < switch_record_cnt; i++, switch_ptr++) {
+			if (switch_ptr->level != level)
+				continue;
+			_topo_count_switch(topo_eval, i, switch_node_bitmap,
+					   switch_node_cnt, switch_cpu_cnt);
+		}
+	}
+
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
-		uint32_t switch_cpus = 0;
-		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
-		bit_and(switch_node_bitmap[i], topo_eval->node_map);
-		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
-		/*
-		 * Count total CPUs of the intersection of node_map and
-		 * switch_node_bitmap.
-		 */
-		for (j = 0; (node_ptr = next_node_bitmap(switch_node_bitmap[i],
-							 &j));
-		     j++)
-			switch_cpus += avail_res_array[j]->avail_cpus;
-		switch_cpu_cnt[i] = switch_cpus;
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, switch_node_bitmap[i])) {
 			switch_required[i] = 1;
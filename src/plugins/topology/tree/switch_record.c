@@ -345,6 +345,30 @@ static void _find_child_switches(int sw)
 	hostlist_destroy(swlist);
 }
 
+/*
+ * Note if no node is reachable through more than one direct descendant of
+ * switch sw, so per-switch node counts can be summed up the tree.
+ */
+static void _check_children_disjoint(int sw)
+{
+	switch_record_t *switch_ptr = &switch_record_table[sw];
+	int child_nodes = 0;
+
+	if (!switch_ptr->num_switches || !switch_ptr->node_bitmap)
+		return;
+
+	for (int i = 0; i < switch_ptr->num_switches; i++) {
+		switch_record_t *child_ptr =
+			&switch_record_table[switch_ptr->switch_index[i]];
+		if (!child_ptr->node_bitmap)
+			return;
+		child_nodes += bit_set_count(child_ptr->node_bitmap);
+	}
+
+	switch_ptr->children_disjoint =
+		(child_nodes == bit_set_count(switch_ptr->node_bitmap));
+}
+
 static void _check_better_path(int i, int j ,int k)
 {
 	int tmp;
@@ -523,6 +547,7 @@ extern void switch_record_validate(void)
 	for (i = 0; i < switch_record_cnt; i++) {
 		if (switch_record_table[i].level != 0) {
 			_find_child_switches(i);
+			_check_children_disjoint(i);
 		}
 		if (node_count ==
 			bit_set_count(switch_record_table[i].node_bitmap)) {
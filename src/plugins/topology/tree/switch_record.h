@@ -49,6 +49,8 @@ typedef struct {
 	bitstr_t *node_bitmap;		/* bitmap of all nodes descended from
 					 * this switch */
 	char *nodes;			/* name if direct descendant nodes */
+	bool children_disjoint;		/* direct descendant switches share no
+					 * nodes */
 	uint16_t  num_desc_switches;	/* number of descendant switches */
 	uint16_t  num_switches;		/* number of direct descendant
 					   switches */
@@ -105,6 +105,97 @@ typedef struct topoinfo_tree {
 	topoinfo_switch_t *topo_array;	/* the switch topology records */
 } topoinfo_tree_t;
 
+/*
+ * The same node sets (a job's allocation) are messaged over and over for
+ * launch, signal, terminate and epilog. Remember the last few RouteTree
+ * splits so those messages skip rebuilding the switch walk. Only the switch
+ * configuration feeds the split, so reconfiguring is the only invalidation.
+ */
+#define ROUTE_CACHE_SIZE 16
+
+typedef struct {
+	int count;		/* number of sublists, -1 if a leaf switch */
+	char *hl_str;		/* ranged hostlist the plan was built for */
+	hostlist_t **sp_hl;	/* the sublists to forward to */
+} route_plan_t;
+
+static route_plan_t route_cache[ROUTE_CACHE_SIZE];
+static int route_cache_next = 0;
+static pthread_mutex_t route_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void _route_plan_clear(route_plan_t *plan)
+{
+	for (int i = 0; i < plan->count; i++)
+		FREE_NULL_HOSTLIST(plan->sp_hl[i]);
+	xfree(plan->sp_hl);
+	xfree(plan->hl_str);
+	plan->count = 0;
+}
+
+static void _route_cache_flush(void)
+{
+	slurm_mutex_lock(&route_cache_lock);
+	for (int i = 0; i < ROUTE_CACHE_SIZE; i++)
+		_route_plan_clear(&route_cache[i]);
+	route_cache_next = 0;
+	slurm_mutex_unlock(&route_cache_lock);
+}
+
+/*
+ * Look up a plan for hl_str. On a hit fill sp_hl and count with copies of
+ * the cached sublists, or set leaf if the nodes all sit on one leaf switch.
+ * RET true on hit
+ */
+static bool _route_cache_get(char *hl_str, hostlist_t ***sp_hl, int *count,
+			     bool *leaf)
+{
+	bool hit = false;
+
+	slurm_mutex_lock(&route_cache_lock);
+	for (int i = 0; i < ROUTE_CACHE_SIZE; i++) {
+		route_plan_t *plan = &route_cache[i];
+
+		if (!plan->hl_str || xstrcmp(plan->hl_str, hl_str))
+			continue;
+
+		hit = true;
+		if (plan->count < 0) {
+			*leaf = true;
+			break;
+		}
+		*sp_hl = xcalloc(plan->count, sizeof(hostlist_t *));
+		for (int j = 0; j < plan->count; j++)
+			(*sp_hl)[j] = hostlist_copy(plan->sp_hl[j]);
+		*count = plan->count;
+		break;
+	}
+	slurm_mutex_unlock(&route_cache_lock);
+
+	return hit;
+}
+
+/* Remember the split of hl_str, sp_hl == NULL records a leaf switch */
+static void _route_cache_set(char *hl_str, hostlist_t **sp_hl, int count)
+{
+	route_plan_t *plan;
+
+	slurm_mutex_lock(&route_cache_lock);
+	plan = &route_cache[route_cache_next];
+	route_cache_next = (route_cache_next + 1) % ROUTE_CACHE_SIZE;
+	_route_plan_clear(plan);
+
+	plan->hl_str = xstrdup(hl_str);
+	if (!sp_hl) {
+		plan->count = -1;
+	} else {
+		plan->sp_hl = xcalloc(count, sizeof(hostlist_t *));
+		for (int j = 0; j < count; j++)
+			plan->sp_hl[j] = hostlist_copy(sp_hl[j]);
+		plan->count = count;
+	}
+	slurm_mutex_unlock(&route_cache_lock);
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  *	are called.  Put global initialization here.
@@ -121,6 +212,7 @@ extern int init(void)
  */
 extern int fini(void)
 {
+	_route_cache_flush();
 	switch_record_table_destroy();
 	return SLURM_SUCCESS;
 }
@@ -131,6 +223,7 @@ extern int fini(void)
  */
 extern int topology_p_build_config(void)
 {
+	_route_cache_flush();
 	if (node_record_count)
 		switch_record_validate();
 	return SLURM_SUCCESS;
@@ -319,7 +412,8 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 {
 	int i, j, k, msg_count, switch_count;
 	int s_first, s_last;
-	char *buf;
+	char *buf, *hl_str = NULL;
+	bool leaf = false;
 	bitstr_t *nodes_bitmap = NULL;		/* nodes in message list */
 	bitstr_t *switch_bitmap = NULL;		/* switches  */
 	slurmctld_lock_t node_read_lock = { .node = READ_LOCK };
@@ -345,6 +439,16 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 	}
 	slurm_mutex_unlock(&init_lock);
 
+	hl_str = hostlist_ranged_string_xmalloc(hl);
+	if (_route_cache_get(hl_str, sp_hl, count, &leaf)) {
+		log_flag(ROUTE, "using cached split for %s", hl_str);
+		xfree(hl_str);
+		if (leaf)
+			return common_topo_split_hostlist_treewidth(
+				hl, sp_hl, count, tree_width);
+		return SLURM_SUCCESS;
+	}
+
 	/* Only acquire the slurmctld lock if running as the slurmctld. */
 	if (running_in_slurmctld())
 		lock_slurmctld(node_read_lock);
@@ -414,6 +518,8 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 			unlock_slurmctld(node_read_lock);
 		FREE_NULL_BITMAP(nodes_bitmap);
 		FREE_NULL_BITMAP(switch_bitmap);
+		_route_cache_set(hl_str, NULL, 0);
+		xfree(hl_str);
 		return common_topo_split_hostlist_treewidth(hl, sp_hl, count,
 							    tree_width);
 	}
@@ -455,6 +561,9 @@ extern int topology_p_split_hostlist(hostlist_t *hl, hostlist_t ***sp_hl,
 	FREE_NULL_BITMAP(nodes_bitmap);
 	FREE_NULL_BITMAP(switch_bitmap);
 
+	_route_cache_set(hl_str, *sp_hl, *count);
+	xfree(hl_str);
+
 	return SLURM_SUCCESS;
 }
 
@@ -0,0 +1,746 @@
+/*****************************************************************************\
+ *  archive.c - read job records straight from accounting archive files
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "src/common/pack.h"
+#include "src/common/slurm_protocol_common.h"
+#include "src/common/slurmdbd_defs.h"
+#include "src/common/xstring.h"
+
+#include "sacct.h"
+
+/*
+ * Column order of the job and step records in archive files. This must follow
+ * _pack_local_job() and _pack_local_step() in
+ * src/plugins/accounting_storage/mysql/as_mysql_archive.c.
+ */
+enum {
+	ARCH_JOB_ACCOUNT,
+	ARCH_JOB_ADMIN_COMMENT,
+	ARCH_JOB_ALLOC_NODES,
+	ARCH_JOB_ASSOCID,
+	ARCH_JOB_ARRAYJOBID,
+	ARCH_JOB_ARRAY_MAX,
+	ARCH_JOB_ARRAYTASKID,
+	ARCH_JOB_ARRAY_TASK_PENDING,
+	ARCH_JOB_ARRAY_TASK_STR,
+	ARCH_JOB_SCRIPT_HASH_INX,
+	ARCH_JOB_BLOCKID,
+	ARCH_JOB_CONSTRAINTS,
+	ARCH_JOB_CONTAINER,
+	ARCH_JOB_DELETED,
+	ARCH_JOB_DERIVED_EC,
+	ARCH_JOB_DERIVED_ES,
+	ARCH_JOB_ENV_HASH_INX,
+	ARCH_JOB_EXIT_CODE,
+	ARCH_JOB_EXTRA,
+	ARCH_JOB_FLAGS,
+	ARCH_JOB_TIMELIMIT,
+	ARCH_JOB_ELIGIBLE,
+	ARCH_JOB_END,
+	ARCH_JOB_GID,
+	ARCH_JOB_GRES_USED,
+	ARCH_JOB_DB_INX,
+	ARCH_JOB_JOBID,
+	ARCH_JOB_KILL_REQUID,
+	ARCH_JOB_LICENSES,
+	ARCH_JOB_MCS_LABEL,
+	ARCH_JOB_MOD_TIME,
+	ARCH_JOB_NAME,
+	ARCH_JOB_NODELIST,
+	ARCH_JOB_NODE_INX,
+	ARCH_JOB_HET_JOB_ID,
+	ARCH_JOB_HET_JOB_OFFSET,
+	ARCH_JOB_PARTITION,
+	ARCH_JOB_PRIORITY,
+	ARCH_JOB_QOS,
+	ARCH_JOB_REQ_CPUS,
+	ARCH_JOB_REQ_MEM,
+	ARCH_JOB_RESVID,
+	ARCH_JOB_START,
+	ARCH_JOB_STATE,
+	ARCH_JOB_STATE_REASON,
+	ARCH_JOB_STDERR,
+	ARCH_JOB_STDIN,
+	ARCH_JOB_STDOUT,
+	ARCH_JOB_SUBMIT,
+	ARCH_JOB_SUSPENDED,
+	ARCH_JOB_SUBMIT_LINE,
+	ARCH_JOB_SYSTEM_COMMENT,
+	ARCH_JOB_TRESA,
+	ARCH_JOB_TRESR,
+	ARCH_JOB_UID,
+	ARCH_JOB_WCKEY,
+	ARCH_JOB_WCKEYID,
+	ARCH_JOB_WORK_DIR,
+	ARCH_JOB_COUNT
+};
+
+enum {
+	ARCH_STEP_ACT_CPUFREQ,
+	ARCH_STEP_DELETED,
+	ARCH_STEP_EXIT_CODE,
+	ARCH_STEP_CONSUMED_ENERGY,
+	ARCH_STEP_CONTAINER,
+	ARCH_STEP_DB_INX,
+	ARCH_STEP_KILL_REQUID,
+	ARCH_STEP_NAME,
+	ARCH_STEP_NODELIST,
+	ARCH_STEP_NODES,
+	ARCH_STEP_NODE_INX,
+	ARCH_STEP_END,
+	ARCH_STEP_START,
+	ARCH_STEP_SUSPENDED,
+	ARCH_STEP_REQ_CPUFREQ_MIN,
+	ARCH_STEP_REQ_CPUFREQ_MAX,
+	ARCH_STEP_REQ_CPUFREQ_GOV,
+	ARCH_STEP_STATE,
+	ARCH_STEP_STEPID,
+	ARCH_STEP_STEP_HET_COMP,
+	ARCH_STEP_SUBMIT_LINE,
+	ARCH_STEP_SYS_SEC,
+	ARCH_STEP_SYS_USEC,
+	ARCH_STEP_TASKS,
+	ARCH_STEP_TASKDIST,
+	ARCH_STEP_TRES,
+	ARCH_STEP_TRES_USAGE_IN_AVE,
+	ARCH_STEP_TRES_USAGE_IN_MAX,
+	ARCH_STEP_TRES_USAGE_IN_MAX_NODEID,
+	ARCH_STEP_TRES_USAGE_IN_MAX_TASKID,
+	ARCH_STEP_TRES_USAGE_IN_MIN,
+	ARCH_STEP_TRES_USAGE_IN_MIN_NODEID,
+	ARCH_STEP_TRES_USAGE_IN_MIN_TASKID,
+	ARCH_STEP_TRES_USAGE_IN_TOT,
+	ARCH_STEP_TRES_USAGE_OUT_AVE,
+	ARCH_STEP_TRES_USAGE_OUT_MAX,
+	ARCH_STEP_TRES_USAGE_OUT_MAX_NODEID,
+	ARCH_STEP_TRES_USAGE_OUT_MAX_TASKID,
+	ARCH_STEP_TRES_USAGE_OUT_MIN,
+	ARCH_STEP_TRES_USAGE_OUT_MIN_NODEID,
+	ARCH_STEP_TRES_USAGE_OUT_MIN_TASKID,
+	ARCH_STEP_TRES_USAGE_OUT_TOT,
+	ARCH_STEP_USER_SEC,
+	ARCH_STEP_USER_USEC,
+	ARCH_STEP_COUNT
+};
+
+/* Archive columns are NULL for SQL NULL */
+#define _atoul(str) ((str) ? slurm_atoul(str) : 0)
+#define _atoull(str) ((str) ? slurm_atoull(str) : 0)
+
+/*
+ * Point row[] at the columns of the next record. Strings are left in the
+ * mmap()'d file, so filtering a record never copies anything.
+ */
+static int _unpack_row(char **row, int cnt, buf_t *buffer)
+{
+	uint32_t len;
+
+	for (int i = 0; i < cnt; i++) {
+		if (unpackmem_ptr(&row[i], &len, buffer))
+			return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
+static int _find_str(void *x, void *key)
+{
+	return !xstrcmp(x, key);
+}
+
+static int _find_str_case(void *x, void *key)
+{
+	return !xstrcasecmp(x, key);
+}
+
+static bool _match_list(list_t *list, char *val, bool ignore_case)
+{
+	if (!list || !list_count(list))
+		return true;
+	if (!val)
+		return false;
+	return list_find_first(list, ignore_case ? _find_str_case : _find_str,
+			       val);
+}
+
+static int _find_selected_job(void *x, void *key)
+{
+	slurm_selected_step_t *sel = x;
+	char **row = key;
+	uint32_t job_id = sel->step_id.job_id;
+
+	if (sel->array_task_id != NO_VAL)
+		return ((_atoul(row[ARCH_JOB_ARRAYJOBID]) == job_id) &&
+			(_atoul(row[ARCH_JOB_ARRAYTASKID]) ==
+			 sel->array_task_id));
+	if (sel->het_job_offset != NO_VAL)
+		return ((_atoul(row[ARCH_JOB_HET_JOB_ID]) == job_id) &&
+			(_atoul(row[ARCH_JOB_HET_JOB_OFFSET]) ==
+			 sel->het_job_offset));
+
+	return ((_atoul(row[ARCH_JOB_JOBID]) == job_id) ||
+		(_atoul(row[ARCH_JOB_ARRAYJOBID]) == job_id) ||
+		(_atoul(row[ARCH_JOB_HET_JOB_ID]) == job_id));
+}
+
+/* Same per-state time rules as _state_time_string() in as_mysql */
+static bool _match_state_time(char **row, uint32_t state,
+			      slurmdb_job_cond_t *job_cond)
+{
+	uint32_t job_state = _atoul(row[ARCH_JOB_STATE]);
+	time_t eligible = _atoul(row[ARCH_JOB_ELIGIBLE]);
+	time_t start = _atoul(row[ARCH_JOB_START]);
+	time_t end = _atoul(row[ARCH_JOB_END]);
+
+	if (!job_cond->usage_start && !job_cond->usage_end)
+		return (job_state == state);
+
+	switch (state) {
+	case JOB_PENDING:
+		return (eligible &&
+			((start && (job_cond->usage_start < start)) ||
+			 (!start && end && (job_cond->usage_start < end)) ||
+			 (!start && !end && (job_state == state))) &&
+			(job_cond->usage_end > eligible));
+	case JOB_SUSPENDED:
+		/* The suspend periods live in a separate archive table */
+		return (job_state == state);
+	case JOB_RUNNING:
+		return (start &&
+			((job_cond->usage_start < end) ||
+			 (!end && (job_state == state))) &&
+			(job_cond->usage_end > start));
+	default:
+		return ((job_state == state) && end &&
+			(end >= job_cond->usage_start) &&
+			(end <= job_cond->usage_end));
+	}
+}
+
+/* Same time window setup_job_cond_limits() builds for the database query */
+static bool _match_time(char **row, slurmdb_job_cond_t *job_cond)
+{
+	time_t eligible = _atoul(row[ARCH_JOB_ELIGIBLE]);
+	time_t end = _atoul(row[ARCH_JOB_END]);
+
+	if (job_cond->state_list && list_count(job_cond->state_list)) {
+		list_itr_t *itr = list_iterator_create(job_cond->state_list);
+		char *state;
+		bool match = false;
+
+		while (!match && (state = list_next(itr)))
+			match = _match_state_time(row, slurm_atoul(state),
+						  job_cond);
+		list_iterator_destroy(itr);
+		return match;
+	}
+
+	if (job_cond->step_list && list_count(job_cond->step_list)) {
+		if (job_cond->flags & JOBCOND_FLAG_NO_DEFAULT_USAGE)
+			return true;
+		return ((_atoul(row[ARCH_JOB_SUBMIT]) < job_cond->usage_end) &&
+			((end >= job_cond->usage_start) || !end));
+	}
+
+	if (job_cond->usage_start) {
+		if (!job_cond->usage_end)
+			return ((end >= job_cond->usage_start) || !end);
+		return (eligible && (eligible < job_cond->usage_end) &&
+			((end >= job_cond->usage_start) || !end));
+	}
+
+	if (job_cond->usage_end)
+		return (eligible && (eligible < job_cond->usage_end));
+
+	return true;
+}
+
+/* Check a record against job_cond before building anything for it */
+static bool _match_job_row(char **row, slurmdb_job_cond_t *job_cond)
+{
+	if (_atoul(row[ARCH_JOB_DELETED]))
+		return false;
+
+	if (job_cond->step_list && list_count(job_cond->step_list) &&
+	    !list_find_first(job_cond->step_list, _find_selected_job, row))
+		return false;
+
+	if (!_match_list(job_cond->userid_list, row[ARCH_JOB_UID], false) ||
+	    !_match_list(job_cond->groupid_list, row[ARCH_JOB_GID], false) ||
+	    !_match_list(job_cond->acct_list, row[ARCH_JOB_ACCOUNT], true) ||
+	    !_match_list(job_cond->partition_list, row[ARCH_JOB_PARTITION],
+			 false) ||
+	    !_match_list(job_cond->jobname_list, row[ARCH_JOB_NAME], false) ||
+	    !_match_list(job_cond->qos_list, row[ARCH_JOB_QOS], false) ||
+	    !_match_list(job_cond->wckey_list, row[ARCH_JOB_WCKEY], false))
+		return false;
+
+	return _match_time(row, job_cond);
+}
+
+/* Mirrors the job record setup in as_mysql_jobacct_process.c */
+static slurmdb_job_rec_t *_row_to_job(char **row, char *cluster_name,
+				      slurmdb_job_cond_t *job_cond, time_t now)
+{
+	slurmdb_job_rec_t *job = slurmdb_create_job_rec();
+
+	job->state = _atoul(row[ARCH_JOB_STATE]);
+	job->alloc_nodes = _atoul(row[ARCH_JOB_ALLOC_NODES]);
+	job->associd = _atoul(row[ARCH_JOB_ASSOCID]);
+	job->array_job_id = _atoul(row[ARCH_JOB_ARRAYJOBID]);
+	job->array_task_id = _atoul(row[ARCH_JOB_ARRAYTASKID]);
+	job->het_job_id = _atoul(row[ARCH_JOB_HET_JOB_ID]);
+	job->het_job_offset = _atoul(row[ARCH_JOB_HET_JOB_OFFSET]);
+	job->resvid = _atoul(row[ARCH_JOB_RESVID]);
+
+	if (!job->array_job_id && !job->array_task_id)
+		job->array_task_id = NO_VAL;
+	if (!job->het_job_id && !job->het_job_offset)
+		job->het_job_offset = NO_VAL;
+
+	job->cluster = xstrdup(cluster_name);
+	job->wckey = xstrdup(row[ARCH_JOB_WCKEY] ? row[ARCH_JOB_WCKEY] : "");
+	job->wckeyid = _atoul(row[ARCH_JOB_WCKEYID]);
+	job->mcs_label = xstrdup(row[ARCH_JOB_MCS_LABEL] ?
+				 row[ARCH_JOB_MCS_LABEL] : "");
+	if (row[ARCH_JOB_UID])
+		job->uid = slurm_atoul(row[ARCH_JOB_UID]);
+	if (row[ARCH_JOB_ACCOUNT] && row[ARCH_JOB_ACCOUNT][0])
+		job->account = xstrdup(row[ARCH_JOB_ACCOUNT]);
+	if (row[ARCH_JOB_ARRAY_TASK_STR] && row[ARCH_JOB_ARRAY_TASK_STR][0])
+		job->array_task_str = xstrdup(row[ARCH_JOB_ARRAY_TASK_STR]);
+	if (row[ARCH_JOB_ARRAY_MAX])
+		job->array_max_tasks = slurm_atoul(row[ARCH_JOB_ARRAY_MAX]);
+	job->blockid = xstrdup(row[ARCH_JOB_BLOCKID]);
+	job->work_dir = xstrdup(row[ARCH_JOB_WORK_DIR]);
+
+	job->eligible = _atoul(row[ARCH_JOB_ELIGIBLE]);
+	job->submit = _atoul(row[ARCH_JOB_SUBMIT]);
+	job->start = _atoul(row[ARCH_JOB_START]);
+	job->end = _atoul(row[ARCH_JOB_END]);
+	job->timelimit = _atoul(row[ARCH_JOB_TIMELIMIT]);
+
+	job->std_err = xstrdup(row[ARCH_JOB_STDERR]);
+	job->std_in = xstrdup(row[ARCH_JOB_STDIN]);
+	job->std_out = xstrdup(row[ARCH_JOB_STDOUT]);
+	job->submit_line = xstrdup(row[ARCH_JOB_SUBMIT_LINE]);
+
+	if (job->end && (job->start > job->end))
+		job->start = job->end;
+
+	/*
+	 * Suspend periods are archived apart from the jobs, so use the
+	 * suspended total from the job record even when truncating.
+	 */
+	job->suspended = _atoul(row[ARCH_JOB_SUSPENDED]);
+	if (!(job_cond->flags & JOBCOND_FLAG_NO_TRUNC)) {
+		if (!job_cond->usage_end || (job_cond->usage_end > now))
+			job_cond->usage_end = now;
+		if (job->start && (job->start < job_cond->usage_start))
+			job->start = job_cond->usage_start;
+		if (!job->end || (job->end > job_cond->usage_end))
+			job->end = job_cond->usage_end;
+		if (!job->start)
+			job->start = job->end;
+		job->elapsed = job->end - job->start;
+	} else {
+		if (job->state == JOB_SUSPENDED)
+			job->suspended = now - job->suspended;
+		if (!job->start)
+			job->elapsed = 0;
+		else if (!job->end)
+			job->elapsed = now - job->start;
+		else
+			job->elapsed = job->end - job->start;
+	}
+	job->elapsed -= job->suspended;
+	if ((int) job->elapsed < 0)
+		job->elapsed = 0;
+
+	job->db_index = _atoull(row[ARCH_JOB_DB_INX]);
+	job->jobid = _atoul(row[ARCH_JOB_JOBID]);
+	job->jobname = xstrdup(row[ARCH_JOB_NAME]);
+	job->gid = _atoul(row[ARCH_JOB_GID]);
+	job->exitcode = _atoul(row[ARCH_JOB_EXIT_CODE]);
+	job->derived_ec = _atoul(row[ARCH_JOB_DERIVED_EC]);
+	job->derived_es = xstrdup(row[ARCH_JOB_DERIVED_ES]);
+	job->admin_comment = xstrdup(row[ARCH_JOB_ADMIN_COMMENT]);
+	job->system_comment = xstrdup(row[ARCH_JOB_SYSTEM_COMMENT]);
+	job->constraints = xstrdup(row[ARCH_JOB_CONSTRAINTS]);
+	job->container = xstrdup(row[ARCH_JOB_CONTAINER]);
+	job->extra = xstrdup(row[ARCH_JOB_EXTRA]);
+	job->licenses = xstrdup(row[ARCH_JOB_LICENSES]);
+	job->flags = _atoul(row[ARCH_JOB_FLAGS]);
+
+	if (!job->start && job->end && (job->flags & SLURMDB_JOB_FLAG_START_R))
+		job->start = NO_VAL;
+
+	job->state_reason_prev = _atoul(row[ARCH_JOB_STATE_REASON]);
+	job->partition = xstrdup(row[ARCH_JOB_PARTITION]);
+	if (row[ARCH_JOB_NODELIST] && xstrcmp(row[ARCH_JOB_NODELIST], "(null)"))
+		job->nodes = xstrdup(row[ARCH_JOB_NODELIST]);
+	else
+		job->nodes = xstrdup("(unknown)");
+
+	job->priority = _atoul(row[ARCH_JOB_PRIORITY]);
+	job->req_cpus = _atoul(row[ARCH_JOB_REQ_CPUS]);
+	job->req_mem = _atoull(row[ARCH_JOB_REQ_MEM]);
+	if (!row[ARCH_JOB_KILL_REQUID])
+		job->requid = INFINITE;
+	else
+		job->requid = slurm_atoul(row[ARCH_JOB_KILL_REQUID]);
+	job->qosid = _atoul(row[ARCH_JOB_QOS]);
+	job->show_full = 1;
+	job->tres_alloc_str = xstrdup(row[ARCH_JOB_TRESA]);
+	job->tres_req_str = xstrdup(row[ARCH_JOB_TRESR]);
+
+	return job;
+}
+
+static int _find_selected_step(void *x, void *key)
+{
+	slurm_selected_step_t *sel = x;
+	slurmdb_step_rec_t *step = key;
+
+	if (sel->step_id.job_id != step->job_ptr->jobid)
+		return 0;
+	return ((sel->step_id.step_id == NO_VAL) ||
+		((sel->step_id.step_id == step->step_id.step_id) &&
+		 ((sel->step_id.step_het_comp == NO_VAL) ||
+		  (sel->step_id.step_het_comp ==
+		   step->step_id.step_het_comp))));
+}
+
+/* Mirrors the step record setup in as_mysql_jobacct_process.c */
+static void _add_step(char **row, slurmdb_job_rec_t *job,
+		      slurmdb_job_cond_t *job_cond, time_t now)
+{
+	slurmdb_step_rec_t *step = slurmdb_create_step_rec();
+
+	step->job_ptr = job;
+	step->step_id.job_id = job->jobid;
+	step->step_id.step_id = _atoul(row[ARCH_STEP_STEPID]);
+	step->step_id.step_het_comp = _atoul(row[ARCH_STEP_STEP_HET_COMP]);
+
+	if (job_cond->step_list && list_count(job_cond->step_list) &&
+	    !list_find_first(job_cond->step_list, _find_selected_step, step)) {
+		slurmdb_destroy_step_rec(step);
+		return;
+	}
+
+	if (!job->first_step_ptr)
+		job->first_step_ptr = step;
+	list_append(job->steps, step);
+
+	step->state = _atoul(row[ARCH_STEP_STATE]);
+	step->exitcode = _atoul(row[ARCH_STEP_EXIT_CODE]);
+	step->nnodes = _atoul(row[ARCH_STEP_NODES]);
+	step->ntasks = _atoul(row[ARCH_STEP_TASKS]);
+	step->task_dist = _atoul(row[ARCH_STEP_TASKDIST]);
+	step->start = _atoul(row[ARCH_STEP_START]);
+	step->end = _atoul(row[ARCH_STEP_END]);
+	/* job->end was already truncated, so check the state */
+	if (!step->end && ((job->state & JOB_STATE_BASE) >= JOB_COMPLETE)) {
+		step->end = job->end;
+		step->state = job->state;
+	}
+
+	if (!(job_cond->flags & JOBCOND_FLAG_NO_TRUNC) &&
+	    job_cond->usage_start) {
+		if (step->start && (step->start < job_cond->usage_start))
+			step->start = job_cond->usage_start;
+		if (!step->start && step->end)
+			step->start = step->end;
+		if (!step->end || (step->end > job_cond->usage_end))
+			step->end = job_cond->usage_end;
+		if (step->start && step->end && (step->start > step->end))
+			step->start = step->end = 0;
+	}
+
+	step->suspended = _atoul(row[ARCH_STEP_SUSPENDED]);
+	if (step->state == JOB_SUSPENDED)
+		step->suspended = now - step->suspended;
+	if (!step->start)
+		step->elapsed = 0;
+	else if (!step->end)
+		step->elapsed = now - step->start;
+	else
+		step->elapsed = step->end - step->start;
+	step->elapsed -= step->suspended;
+	if ((int) step->elapsed < 0)
+		step->elapsed = 0;
+
+	step->req_cpufreq_min = _atoul(row[ARCH_STEP_REQ_CPUFREQ_MIN]);
+	step->req_cpufreq_max = _atoul(row[ARCH_STEP_REQ_CPUFREQ_MAX]);
+	step->req_cpufreq_gov = _atoul(row[ARCH_STEP_REQ_CPUFREQ_GOV]);
+	step->stepname = xstrdup(row[ARCH_STEP_NAME]);
+	step->nodes = xstrdup(row[ARCH_STEP_NODELIST]);
+	if (!row[ARCH_STEP_KILL_REQUID])
+		step->requid = INFINITE;
+	else
+		step->requid = slurm_atoul(row[ARCH_STEP_KILL_REQUID]);
+	step->submit_line = xstrdup(row[ARCH_STEP_SUBMIT_LINE]);
+
+	step->user_cpu_sec = _atoull(row[ARCH_STEP_USER_SEC]);
+	step->user_cpu_usec = _atoul(row[ARCH_STEP_USER_USEC]);
+	step->sys_cpu_sec = _atoull(row[ARCH_STEP_SYS_SEC]);
+	step->sys_cpu_usec = _atoul(row[ARCH_STEP_SYS_USEC]);
+	step->tot_cpu_sec = step->user_cpu_sec + step->sys_cpu_sec;
+	step->tot_cpu_usec = step->user_cpu_usec + step->sys_cpu_usec;
+
+	step->stats.tres_usage_in_ave =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_AVE]);
+	step->stats.tres_usage_in_max =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MAX]);
+	step->stats.tres_usage_in_max_nodeid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MAX_NODEID]);
+	step->stats.tres_usage_in_max_taskid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MAX_TASKID]);
+	step->stats.tres_usage_in_min =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MIN]);
+	step->stats.tres_usage_in_min_nodeid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MIN_NODEID]);
+	step->stats.tres_usage_in_min_taskid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_MIN_TASKID]);
+	step->stats.tres_usage_in_tot =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_IN_TOT]);
+	step->stats.tres_usage_out_ave =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_AVE]);
+	step->stats.tres_usage_out_max =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MAX]);
+	step->stats.tres_usage_out_max_nodeid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MAX_NODEID]);
+	step->stats.tres_usage_out_max_taskid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MAX_TASKID]);
+	step->stats.tres_usage_out_min =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MIN]);
+	step->stats.tres_usage_out_min_nodeid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MIN_NODEID]);
+	step->stats.tres_usage_out_min_taskid =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_MIN_TASKID]);
+	step->stats.tres_usage_out_tot =
+		xstrdup(row[ARCH_STEP_TRES_USAGE_OUT_TOT]);
+	if (row[ARCH_STEP_ACT_CPUFREQ])
+		step->stats.act_cpufreq = atof(row[ARCH_STEP_ACT_CPUFREQ]);
+	step->stats.consumed_energy = _atoull(row[ARCH_STEP_CONSUMED_ENERGY]);
+	step->container = xstrdup(row[ARCH_STEP_CONTAINER]);
+	step->tres_alloc_str = xstrdup(row[ARCH_STEP_TRES]);
+}
+
+/* db_index is only unique within a cluster */
+static int _cmp_job_db_index(const void *a, const void *b)
+{
+	slurmdb_job_rec_t *x = *(slurmdb_job_rec_t **) a;
+	slurmdb_job_rec_t *y = *(slurmdb_job_rec_t **) b;
+
+	if (x->db_index != y->db_index)
+		return (x->db_index > y->db_index) ? 1 : -1;
+	return xstrcmp(x->cluster, y->cluster);
+}
+
+static slurmdb_job_rec_t *_find_job(slurmdb_job_rec_t **jobs,
+				    uint32_t job_cnt, uint64_t db_index,
+				    char *cluster_name)
+{
+	slurmdb_job_rec_t key = {
+		.db_index = db_index,
+		.cluster = cluster_name,
+	};
+	slurmdb_job_rec_t *key_ptr = &key;
+	slurmdb_job_rec_t **found;
+
+	found = bsearch(&key_ptr, jobs, job_cnt, sizeof(*jobs),
+			_cmp_job_db_index);
+
+	return found ? *found : NULL;
+}
+
+/*
+ * Open an archive file and read its header.
+ * RET the buffer positioned at the first record, or NULL on error
+ */
+static buf_t *_open_archive(char *file, uint16_t *type, char **cluster_name,
+			    uint32_t *rec_cnt)
+{
+	buf_t *buffer;
+	uint16_t ver = 0;
+	time_t buf_time;
+
+	if (!(buffer = create_mmap_buf(file))) {
+		error("Unable to read archive file %s: %m", file);
+		return NULL;
+	}
+
+	safe_unpack16(&ver, buffer);
+	/*
+	 * Only the record layouts written by this release are understood
+	 * here. Older files still load with "sacctmgr archive load".
+	 */
+	if ((ver > SLURM_PROTOCOL_VERSION) ||
+	    (ver < SLURM_24_05_PROTOCOL_VERSION)) {
+		error("Archive file %s has unsupported version %u, load it with 'sacctmgr archive load' instead",
+		      file, ver);
+		FREE_NULL_BUFFER(buffer);
+		return NULL;
+	}
+	safe_unpack_time(&buf_time, buffer);
+	safe_unpack16(type, buffer);
+	safe_unpackstr(cluster_name, buffer);
+	safe_unpack32(rec_cnt, buffer);
+
+	return buffer;
+
+unpack_error:
+	error("Archive file %s has a corrupt header", file);
+	xfree(*cluster_name);
+	FREE_NULL_BUFFER(buffer);
+	return NULL;
+}
+
+static int _read_jobs(char *file, slurmdb_job_cond_t *job_cond,
+		      list_t *job_list, time_t now)
+{
+	buf_t *buffer;
+	uint16_t type = 0;
+	uint32_t rec_cnt = 0;
+	char *cluster_name = NULL, *row[ARCH_JOB_COUNT];
+	int rc = SLURM_SUCCESS;
+
+	if (!(buffer = _open_archive(file, &type, &cluster_name, &rec_cnt)))
+		return SLURM_ERROR;
+
+	if (type != DBD_GOT_JOBS)
+		goto end_it;
+
+	if (!_match_list(job_cond->cluster_list, cluster_name, false)) {
+		debug("%s: skipping %s, archive is for cluster %s",
+		      __func__, file, cluster_name);
+		goto end_it;
+	}
+
+	for (uint32_t i = 0; i < rec_cnt; i++) {
+		if (_unpack_row(row, ARCH_JOB_COUNT, buffer)) {
+			error("Archive file %s is truncated after %u of %u records",
+			      file, i, rec_cnt);
+			rc = SLURM_ERROR;
+			break;
+		}
+		if (_match_job_row(row, job_cond))
+			list_append(job_list, _row_to_job(row, cluster_name,
+							  job_cond, now));
+	}
+
+end_it:
+	xfree(cluster_name);
+	FREE_NULL_BUFFER(buffer);
+	return rc;
+}
+
+static int _read_steps(char *file, slurmdb_job_cond_t *job_cond,
+		       slurmdb_job_rec_t **jobs, uint32_t job_cnt, time_t now)
+{
+	buf_t *buffer;
+	uint16_t type = 0;
+	uint32_t rec_cnt = 0;
+	char *cluster_name = NULL, *row[ARCH_STEP_COUNT];
+	slurmdb_job_rec_t *job;
+	int rc = SLURM_SUCCESS;
+
+	if (!(buffer = _open_archive(file, &type, &cluster_name, &rec_cnt)))
+		return SLURM_ERROR;
+
+	if ((type != DBD_STEP_START) ||
+	    !_match_list(job_cond->cluster_list, cluster_name, false))
+		goto end_it;
+
+	for (uint32_t i = 0; i < rec_cnt; i++) {
+		if (_unpack_row(row, ARCH_STEP_COUNT, buffer)) {
+			error("Archive file %s is truncated after %u of %u records",
+			      file, i, rec_cnt);
+			rc = SLURM_ERROR;
+			break;
+		}
+		if (_atoul(row[ARCH_STEP_DELETED]))
+			continue;
+		if (!(job = _find_job(jobs, job_cnt,
+				      _atoull(row[ARCH_STEP_DB_INX]),
+				      cluster_name)))
+			continue;
+		_add_step(row, job, job_cond, now);
+	}
+
+end_it:
+	xfree(cluster_name);
+	FREE_NULL_BUFFER(buffer);
+	return rc;
+}
+
+extern list_t *archive_jobs_get(list_t *files, slurmdb_job_cond_t *job_cond)
+{
+	list_t *job_list = list_create(slurmdb_destroy_job_rec);
+	slurmdb_job_rec_t **jobs = NULL, *job;
+	list_itr_t *itr;
+	uint32_t job_cnt, i = 0;
+	time_t now = time(NULL);
+	char *file;
+	int rc = SLURM_SUCCESS;
+
+	/* Jobs first, their steps may be in any of the files */
+	itr = list_iterator_create(files);
+	while ((rc == SLURM_SUCCESS) && (file = list_next(itr)))
+		rc = _read_jobs(file, job_cond, job_list, now);
+
+	if ((rc == SLURM_SUCCESS) && (job_cnt = list_count(job_list)) &&
+	    !(job_cond->flags & JOBCOND_FLAG_NO_STEP)) {
+		list_itr_t *job_itr = list_iterator_create(job_list);
+
+		jobs = xcalloc(job_cnt, sizeof(*jobs));
+		while ((job = list_next(job_itr)))
+			jobs[i++] = job;
+		list_iterator_destroy(job_itr);
+		qsort(jobs, job_cnt, sizeof(*jobs), _cmp_job_db_index);
+
+		list_iterator_reset(itr);
+		while ((rc == SLURM_SUCCESS) && (file = list_next(itr)))
+			rc = _read_steps(file, job_cond, jobs, job_cnt, now);
+		xfree(jobs);
+	}
+	list_iterator_destroy(itr);
+
+	if (rc != SLURM_SUCCESS)
+		FREE_NULL_LIST(job_list);
+
+	return job_list;
+}
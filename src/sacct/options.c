@@ -66,6 +66,7 @@
 #define OPT_LONG_HELPSTATE 0x113
 #define OPT_LONG_HELPREASON 0x114
 #define OPT_LONG_EXPAND_PATTERNS 0x115
+#define OPT_LONG_ARCHIVE_FILE 0x116
 
 #define JOB_HASH_SIZE 1000
 
@@ -245,6 +246,10 @@ sacct [<OPTION>]                                                            \n \
      -A, --accounts:                                                        \n\
 	           Use this comma separated list of accounts to select jobs \n\
                    to display.  By default, all accounts are selected.      \n\
+     --archive-file:                                                        \n\
+                   Read jobs from this comma separated list of files        \n\
+                   written by ArchiveJobs/ArchiveSteps instead of the       \n\
+                   database.                                                \n\
      --array:                                                               \n\
                    Expand job arrays. Display array tasks on separate lines \n\
                    instead of consolidating them to a single line.          \n\
@@ -551,6 +556,8 @@ extern int get_data(void)
 	if (params.opt_completion) {
 		jobs = slurmdb_jobcomp_jobs_get(job_cond);
 		return SLURM_SUCCESS;
+	} else if (params.archive_files) {
+		jobs = archive_jobs_get(params.archive_files, job_cond);
 	} else {
 		jobs = slurmdb_jobs_get(acct_db_conn, job_cond);
 	}
@@ -623,6 +630,7 @@ extern void parse_command_line(int argc, char **argv)
 	static struct option long_options[] = {
 		{"autocomplete", required_argument, 0, OPT_LONG_AUTOCOMP},
                 {"allusers",       no_argument,       0,    'a'},
+		{"archive-file",   required_argument, 0,    OPT_LONG_ARCHIVE_FILE},
                 {"accounts",       required_argument, 0,    'A'},
                 {"allocations",    no_argument,       0,    'X'},
                 {"array",          no_argument,       0,    OPT_LONG_ARRAY},
@@ -766,6 +774,11 @@ extern void parse_command_line(int argc, char **argv)
 		case OPT_LONG_EXPAND_PATTERNS:
 			params.expand_patterns = true;
 			break;
+		case OPT_LONG_ARCHIVE_FILE:
+			if (!params.archive_files)
+				params.archive_files = list_create(xfree_ptr);
+			slurm_addto_char_list(params.archive_files, optarg);
+			break;
 		case 'f':
 			xfree(slurm_conf.job_comp_loc);
 			if ((stat(optarg, &stat_buf) != 0) ||
@@ -1548,6 +1561,7 @@ extern void sacct_fini(void)
 	FREE_NULL_LIST(jobs);
 	FREE_NULL_LIST(g_qos_list);
 	FREE_NULL_LIST(g_tres_list);
+	FREE_NULL_LIST(params.archive_files);
 
 	if (params.opt_completion)
 		slurmdb_jobcomp_fini();
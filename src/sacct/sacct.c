@@ -190,6 +190,12 @@ int main(int argc, char **argv)
 
 	switch (op) {
 	case SACCT_LIST:
+		/*
+		 * Parsable output sent to a file or a pipe usually feeds an
+		 * export, so write it in large blocks.
+		 */
+		if (print_fields_parsable_print && !isatty(STDOUT_FILENO))
+			setvbuf(stdout, NULL, _IOFBF, PARSABLE_OUT_BUF_SIZE);
 		if (!params.mimetype &&
 		    !(params.job_cond->flags & JOBCOND_FLAG_SCRIPT) &&
 		    !(params.job_cond->flags & JOBCOND_FLAG_ENV))
@@ -72,6 +72,7 @@
 #define LONG_COMP_FIELDS "jobid,uid,jobname,partition,nnodes,nodelist,state,start,end,timelimit"
 
 #define MAX_PRINTFIELDS 100
+#define PARSABLE_OUT_BUF_SIZE (1024 * 1024)
 #define FORMAT_STRING_SIZE 34
 
 #define SECONDS_IN_MINUTE 60
@@ -204,6 +205,7 @@ typedef enum {
 } sacct_print_types_t;
 
 typedef struct {
+	List archive_files;	/* --archive-file= */
 	char *cluster_name;	/* Set if in federated cluster */
 	uint32_t convert_flags;	/* --noconvert */
 	slurmdb_job_cond_t *job_cond;
@@ -233,6 +235,9 @@ extern int field_count;
 extern List g_qos_list;
 extern List g_tres_list;
 
+/* archive.c */
+extern List archive_jobs_get(List files, slurmdb_job_cond_t *job_cond);
+
 /* process.c */
 void aggregate_stats(slurmdb_stats_t *dest, slurmdb_stats_t *from);
 
@@ -61,6 +61,7 @@
 #define OPT_LONG_SEND_LIBS 0x103
 #define OPT_LONG_AUTOCOMP  0x104
 #define OPT_LONG_TREE_WIDTH 0x105
+#define OPT_LONG_PIPELINE  0x106
 
 
 /* getopt_long options, integers but not characters */
@@ -87,6 +88,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"treewidth",    required_argument, 0, OPT_LONG_TREE_WIDTH},
 		{"force",     no_argument,       0, 'f'},
 		{"jobid",     required_argument, 0, 'j'},
+		{"pipeline",  required_argument, 0, OPT_LONG_PIPELINE},
 		{"send-libs", optional_argument, 0, OPT_LONG_SEND_LIBS},
 		{"preserve",  no_argument,       0, 'p'},
 		{"size",      required_argument, 0, 's'},
@@ -120,6 +122,8 @@ extern void parse_command_line(int argc, char **argv)
 		else
 			params.tree_width = atoi(env_val);
 	}
+	if ((env_val = getenv("SBCAST_PIPELINE")))
+		params.pipeline_depth = atoi(env_val);
 	if (getenv("SBCAST_FORCE"))
 		params.flags |= BCAST_FLAG_FORCE;
 
@@ -179,6 +183,9 @@ extern void parse_command_line(int argc, char **argv)
 		case (int)'p':
 			params.flags |= BCAST_FLAG_PRESERVE;
 			break;
+		case OPT_LONG_PIPELINE:
+			params.pipeline_depth = atoi(optarg);
+			break;
 		case (int) OPT_LONG_SEND_LIBS:
 			ret = parse_send_libs(optarg);
 			if (ret == -1)
@@ -294,6 +301,7 @@ static void _print_options( void )
 	info("force      = %s",
 	     (params.flags & BCAST_FLAG_FORCE) ? "true" : "false");
 	info("treewidth     = %d", params.tree_width);
+	info("pipeline   = %u", params.pipeline_depth);
 	info("preserve   = %s",
 	     (params.flags & BCAST_FLAG_PRESERVE) ? "true" : "false");
 	info("send_libs  = %s",
@@ -321,6 +329,7 @@ Usage: sbcast [OPTIONS] SOURCE DEST\n\
   --treewidth=num       specify message treewidth\n\
   -j, --jobid=#[+#][.#] specify job ID with optional hetjob offset and/or step ID\n\
   -p, --preserve        preserve modes and times of source file\n\
+  --pipeline=num        number of blocks to transfer concurrently\n\
   --send-libs[=yes|no]  autodetect and broadcast executable's shared objects\n\
   -s, --size=num        block size in bytes (rounded off)\n\
   -t, --timeout=secs    specify message timeout (seconds)\n\
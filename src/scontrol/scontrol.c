@@ -47,6 +47,7 @@
 #include "src/common/data.h"
 #include "src/common/proc_args.h"
 #include "src/common/ref.h"
+#include "src/common/sched_trace.h"
 #include "src/common/strlcpy.h"
 #include "src/common/uid.h"
 #include "src/interfaces/data_parser.h"
@@ -97,6 +98,7 @@ static void _print_config(char *config_param, int argc, char **argv);
 static void     _print_daemons(void);
 static void     _print_aliases(char* node_hostname);
 static void _print_ping(int argc, char **argv);
+static void	_print_sched_trace(char *file_name);
 static void	_print_slurmd(char *hostlist);
 static void     _print_version(void);
 static int	_process_command(int argc, char **argv);
@@ -697,6 +699,50 @@ _print_aliases (char* node_hostname)
 
 }
 
+/*
+ * _print_sched_trace - decode a file written by "scontrol write sched_trace"
+ */
+static void _print_sched_trace(char *file_name)
+{
+	sched_trace_rec_t *recs = NULL;
+	uint32_t rec_cnt = 0;
+	time_t dump_time = 0;
+	char time_str[64];
+
+	if (!file_name) {
+		exit_code = 1;
+		fprintf(stderr, "sched_trace requires a file name\n");
+		return;
+	}
+	if (sched_trace_load(file_name, &recs, &rec_cnt, &dump_time)) {
+		exit_code = 1;
+		fprintf(stderr, "unable to read scheduler trace %s\n",
+			file_name);
+		return;
+	}
+
+	slurm_make_time_str(&dump_time, time_str, sizeof(time_str));
+	if (quiet_flag != 1)
+		fprintf(stdout, "SchedTrace written %s with %u records\n",
+			time_str, rec_cnt);
+
+	for (uint32_t i = 0; i < rec_cnt; i++) {
+		sched_trace_rec_t *rec = &recs[i];
+		time_t t = rec->usec / USEC_IN_SEC;
+
+		slurm_make_time_str(&t, time_str, sizeof(time_str));
+		fprintf(stdout,
+			"Time=%s.%06"PRIu64" Phase=%s JobId=%u Partition=%s NodesTested=%u Result=%s%s\n",
+			time_str, rec->usec % USEC_IN_SEC,
+			sched_trace_phase_str(rec->phase), rec->job_id,
+			rec->part[0] ? rec->part : "(null)", rec->nodes_tested,
+			(rec->result ? slurm_strerror(rec->result) : "Success"),
+			((rec->flags & SCHED_TRACE_FLAG_TEST_ONLY) ?
+			 " TestOnly=yes" : ""));
+	}
+	xfree(recs);
+}
+
 void _process_reboot_command(const char *tag, int argc, char **argv)
 {
 	int error_code = SLURM_SUCCESS;
@@ -1533,6 +1579,21 @@ static int _process_command (int argc, char **argv)
 			} else {
 				_write_config(argv[2]);
 			}
+		} else if (!xstrncasecmp(argv[1], "sched_trace",
+					 MAX(strlen(argv[1]), 5))) {
+			/* write sched_trace */
+			if (argc > 2) {
+				exit_code = 1;
+				fprintf(stderr,
+					"too many arguments for keyword:%s\n",
+					tag);
+			} else if (slurm_sched_trace_dump()) {
+				exit_code = 1;
+				if (quiet_flag != 1)
+					slurm_perror("slurm_sched_trace_dump error");
+			} else if (quiet_flag != 1) {
+				fprintf(stdout, "Scheduler trace written to sched_trace in StateSaveLocation\n");
+			}
 		} else {
 			exit_code = 1;
 			fprintf(stderr,
@@ -1901,6 +1962,8 @@ static void _show_it(int argc, char **argv)
 	} else if (xstrncasecmp(tag, "reservations", MAX(tag_len, 1)) == 0 ||
 		   xstrncasecmp(tag, "reservationname", MAX(tag_len, 1)) == 0) {
 		scontrol_print_res(val, argc, argv);
+	} else if (xstrncasecmp(tag, "sched_trace", MAX(tag_len, 2)) == 0) {
+		_print_sched_trace(val);
 	} else if (xstrncasecmp(tag, "slurmd", MAX(tag_len, 2)) == 0) {
 		_print_slurmd (val);
 	} else if (xstrncasecmp(tag, "steps", MAX(tag_len, 2)) == 0) {
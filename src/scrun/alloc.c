@@ -55,6 +55,12 @@
 
 /* max number of seconds to delay while waiting for job */
 #define MAX_DELAY 60
+/*
+ * Initial number of nanoseconds to delay while waiting for job nodes to be
+ * ready. Short lived containers generally only wait on the prolog, which
+ * should not cost them full seconds of polling.
+ */
+#define MIN_DELAY_NS (50 * NSEC_IN_MSEC)
 
 typedef struct {
 	const char *var;
@@ -402,7 +408,7 @@ static void _pending_callback(uint32_t job_id)
 extern void check_allocation(conmgr_callback_args_t conmgr_args, void *arg)
 {
 	/* there must be only 1 thread that will call this at any one time */
-	static long delay = 1;
+	static int64_t delay_ns = 0;
 	bool bail = false;
 	int rc, job_id;
 
@@ -439,17 +445,23 @@ extern void check_allocation(conmgr_callback_args_t conmgr_args, void *arg)
 	}
 	rc = slurm_job_node_ready(job_id);
 	if ((rc == READY_JOB_ERROR) || (rc == EAGAIN)) {
-		delay *= 2;
-		if ((delay < 0) || (delay > MAX_DELAY))
-			delay = MAX_DELAY;
+		if (!delay_ns)
+			delay_ns = MIN_DELAY_NS;
+		else
+			delay_ns *= 2;
+		if ((delay_ns < 0) ||
+		    (delay_ns > (((int64_t) MAX_DELAY) * NSEC_IN_SEC)))
+			delay_ns = ((int64_t) MAX_DELAY) * NSEC_IN_SEC;
 
 		if (get_log_level() >= LOG_LEVEL_DEBUG) {
 			read_lock_state();
-			debug("%s: rechecking JobId=%d for nodes ready in %ld ns",
-			      __func__, state.jobid, delay);
+			debug("%s: rechecking JobId=%d for nodes ready in %"PRId64" ns",
+			      __func__, state.jobid, delay_ns);
 			unlock_state();
 		}
-		conmgr_add_work_delayed_fifo(check_allocation, NULL, delay, 0);
+		conmgr_add_work_delayed_fifo(check_allocation, NULL,
+					     (delay_ns / NSEC_IN_SEC),
+					     (delay_ns % NSEC_IN_SEC));
 	} else if ((rc == READY_JOB_FATAL) || !(rc & READY_JOB_STATE)) {
 		/* job failed! */
 		if (get_log_level() >= LOG_LEVEL_DEBUG) {
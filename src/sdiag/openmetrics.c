@@ -0,0 +1,357 @@
+/****************************************************************************\
+ *  openmetrics.c - print slurmctld statistics in OpenMetrics text format
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <slurm/slurm.h>
+#include "src/common/macros.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/uid.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "sdiag.h"
+
+#define PREFIX "slurmctld_"
+
+static const char *lock_names[] = {
+	"conf", "job", "node", "part", "fed"
+};
+
+/* Print a label value, escaping as required by the exposition format */
+static void _print_label(const char *value)
+{
+	for (const char *p = value; p && *p; p++) {
+		if ((*p == '\\') || (*p == '"'))
+			printf("\\%c", *p);
+		else if (*p == '\n')
+			printf("\\n");
+		else
+			putchar(*p);
+	}
+}
+
+static void _print_family(const char *name, const char *type,
+			  const char *unit, const char *help)
+{
+	printf("# TYPE "PREFIX"%s %s\n", name, type);
+	if (unit)
+		printf("# UNIT "PREFIX"%s %s\n", name, unit);
+	printf("# HELP "PREFIX"%s %s\n", name, help);
+}
+
+static void _print_gauge(const char *name, uint64_t value, const char *help)
+{
+	_print_family(name, "gauge", NULL, help);
+	printf(PREFIX"%s %"PRIu64"\n", name, value);
+}
+
+static void _print_counter(const char *name, uint64_t value, const char *help)
+{
+	_print_family(name, "counter", NULL, help);
+	printf(PREFIX"%s_total %"PRIu64"\n", name, value);
+}
+
+/* name must end in _seconds, value is in usec */
+static void _print_seconds(const char *name, const char *type, uint64_t usec,
+			   const char *help)
+{
+	_print_family(name, type, "seconds", help);
+	printf(PREFIX"%s%s %f\n", name, xstrcmp(type, "counter") ? "" : "_total",
+	       usec / (double) USEC_IN_SEC);
+}
+
+/*
+ * Print one histogram sample set from a log2 usec histogram, see
+ * rpc_hist_percentile() for the bucket layout.
+ */
+static void _print_rpc_hist(const char *name, const char *label,
+			    const char *value, const uint32_t *hist,
+			    uint64_t usec)
+{
+	uint64_t cumulative = 0;
+
+	for (int i = 0; i < (buf->rpc_hist_cnt - 1); i++) {
+		uint64_t le = i ? (((uint64_t) 1) << i) : 0;
+
+		cumulative += hist[i];
+		printf(PREFIX"%s_bucket{%s=\"", name, label);
+		_print_label(value);
+		printf("\",le=\"%f\"} %"PRIu64"\n",
+		       le / (double) USEC_IN_SEC, cumulative);
+	}
+	cumulative += hist[buf->rpc_hist_cnt - 1];
+	printf(PREFIX"%s_bucket{%s=\"", name, label);
+	_print_label(value);
+	printf("\",le=\"+Inf\"} %"PRIu64"\n", cumulative);
+
+	printf(PREFIX"%s_count{%s=\"", name, label);
+	_print_label(value);
+	printf("\"} %"PRIu64"\n", cumulative);
+
+	printf(PREFIX"%s_sum{%s=\"", name, label);
+	_print_label(value);
+	printf("\"} %f\n", usec / (double) USEC_IN_SEC);
+}
+
+static void _print_rpc_types(void)
+{
+	_print_family("rpc_requests", "counter", NULL,
+		      "RPCs processed by message type");
+	for (int i = 0; i < buf->rpc_type_size; i++) {
+		printf(PREFIX"rpc_requests_total{type=\"%s\"} %u\n",
+		       rpc_num2string(buf->rpc_type_id[i]),
+		       buf->rpc_type_cnt[i]);
+	}
+
+	if (buf->rpc_hist_cnt) {
+		_print_family("rpc_duration_seconds", "histogram", "seconds",
+			      "RPC processing time by message type");
+		for (int i = 0; i < buf->rpc_type_size; i++)
+			_print_rpc_hist("rpc_duration_seconds", "type",
+					rpc_num2string(buf->rpc_type_id[i]),
+					&buf->rpc_type_hist[i *
+							    buf->rpc_hist_cnt],
+					buf->rpc_type_time[i]);
+	} else {
+		_print_family("rpc_duration_seconds", "counter", "seconds",
+			      "RPC processing time by message type");
+		for (int i = 0; i < buf->rpc_type_size; i++)
+			printf(PREFIX"rpc_duration_seconds_total{type=\"%s\"} %f\n",
+			       rpc_num2string(buf->rpc_type_id[i]),
+			       buf->rpc_type_time[i] / (double) USEC_IN_SEC);
+	}
+
+	if (!buf->rpc_queue_enabled)
+		return;
+
+	_print_family("rpc_queued", "gauge", NULL,
+		      "RPCs waiting in the rpc_queue by message type");
+	for (int i = 0; i < buf->rpc_type_size; i++)
+		printf(PREFIX"rpc_queued{type=\"%s\"} %u\n",
+		       rpc_num2string(buf->rpc_type_id[i]),
+		       buf->rpc_type_queued[i]);
+
+	_print_family("rpc_dropped", "counter", NULL,
+		      "RPCs dropped by the rpc_queue by message type");
+	for (int i = 0; i < buf->rpc_type_size; i++)
+		printf(PREFIX"rpc_dropped_total{type=\"%s\"} %"PRIu64"\n",
+		       rpc_num2string(buf->rpc_type_id[i]),
+		       buf->rpc_type_dropped[i]);
+}
+
+static void _print_rpc_users(void)
+{
+	char **names = xcalloc(buf->rpc_user_size, sizeof(*names));
+
+	for (int i = 0; i < buf->rpc_user_size; i++)
+		names[i] = uid_to_string(buf->rpc_user_id[i]);
+
+	_print_family("rpc_user_requests", "counter", NULL,
+		      "RPCs processed by user");
+	for (int i = 0; i < buf->rpc_user_size; i++) {
+		printf(PREFIX"rpc_user_requests_total{user=\"");
+		_print_label(names[i]);
+		printf("\"} %u\n", buf->rpc_user_cnt[i]);
+	}
+
+	if (buf->rpc_hist_cnt) {
+		_print_family("rpc_user_duration_seconds", "histogram",
+			      "seconds", "RPC processing time by user");
+		for (int i = 0; i < buf->rpc_user_size; i++)
+			_print_rpc_hist("rpc_user_duration_seconds", "user",
+					names[i],
+					&buf->rpc_user_hist[i *
+							    buf->rpc_hist_cnt],
+					buf->rpc_user_time[i]);
+	}
+
+	for (int i = 0; i < buf->rpc_user_size; i++)
+		xfree(names[i]);
+	xfree(names);
+}
+
+static void _print_lock_stats(void)
+{
+	static const struct {
+		const char *name;
+		const char *help;
+		bool wait;
+	} families[] = {
+		{ "lock_wait_seconds", "Time spent waiting for slurmctld locks",
+		  true },
+		{ "lock_hold_seconds", "Time slurmctld locks were held",
+		  false },
+	};
+
+	_print_family("lock_acquisitions", "counter", NULL,
+		      "slurmctld lock acquisitions");
+	for (int i = 0; i < buf->lock_stats_cnt; i++) {
+		const char *name = "unknown";
+
+		if ((i / 2) < ARRAY_SIZE(lock_names))
+			name = lock_names[i / 2];
+		printf(PREFIX"lock_acquisitions_total{lock=\"%s\",mode=\"%s\"} %u\n",
+		       name, (i % 2) ? "write" : "read", buf->lock_cnt[i]);
+	}
+
+	for (int f = 0; f < ARRAY_SIZE(families); f++) {
+		_print_family(families[f].name, "counter", "seconds",
+			      families[f].help);
+		for (int i = 0; i < buf->lock_stats_cnt; i++) {
+			const char *name = "unknown";
+			uint64_t usec = families[f].wait ?
+				buf->lock_wait_time[i] : buf->lock_hold_time[i];
+
+			if ((i / 2) < ARRAY_SIZE(lock_names))
+				name = lock_names[i / 2];
+			printf(PREFIX"%s_total{lock=\"%s\",mode=\"%s\"} %f\n",
+			       families[f].name, name,
+			       (i % 2) ? "write" : "read",
+			       usec / (double) USEC_IN_SEC);
+		}
+	}
+}
+
+static void _print_plugin_stats(void)
+{
+	_print_family("plugin_calls", "counter", NULL,
+		      "Plugin operation calls by plugin and dispatch function");
+	for (int i = 0; i < buf->plugin_stats_cnt; i++)
+		printf(PREFIX"plugin_calls_total{plugin=\"%s\",op=\"%s\"} %u\n",
+		       buf->plugin_stats_name[i], buf->plugin_stats_op[i],
+		       buf->plugin_stats_calls[i]);
+
+	_print_family("plugin_duration_seconds", "counter", "seconds",
+		      "Time spent in plugin operations");
+	for (int i = 0; i < buf->plugin_stats_cnt; i++)
+		printf(PREFIX"plugin_duration_seconds_total{plugin=\"%s\",op=\"%s\"} %f\n",
+		       buf->plugin_stats_name[i], buf->plugin_stats_op[i],
+		       buf->plugin_stats_time[i] / (double) USEC_IN_SEC);
+}
+
+extern int print_openmetrics(void)
+{
+	_print_gauge("server_threads", buf->server_thread_count,
+		     "Server threads handling RPCs");
+	_print_gauge("agent_queue_size", buf->agent_queue_size,
+		     "Outgoing RPCs waiting in the agent retry queue");
+	_print_gauge("agent_count", buf->agent_count,
+		     "Active agents sending outgoing RPCs");
+	_print_gauge("agent_threads", buf->agent_thread_count,
+		     "Threads used by active agents");
+	_print_gauge("dbd_agent_queue_size", buf->dbd_agent_queue_size,
+		     "Messages waiting to be sent to slurmdbd");
+
+	_print_counter("jobs_submitted", buf->jobs_submitted,
+		       "Jobs submitted since the last reset");
+	_print_counter("jobs_started", buf->jobs_started,
+		       "Jobs started since the last reset");
+	_print_counter("jobs_completed", buf->jobs_completed,
+		       "Jobs completed since the last reset");
+	_print_counter("jobs_canceled", buf->jobs_canceled,
+		       "Jobs canceled since the last reset");
+	_print_counter("jobs_failed", buf->jobs_failed,
+		       "Jobs failed since the last reset");
+	_print_gauge("jobs_pending", buf->jobs_pending,
+		     "Pending jobs at the last job state snapshot");
+	_print_gauge("jobs_running", buf->jobs_running,
+		     "Running jobs at the last job state snapshot");
+
+	_print_counter("schedule_cycles", buf->schedule_cycle_counter,
+		       "Main scheduler cycles");
+	_print_seconds("schedule_cycle_last_seconds", "gauge",
+		       buf->schedule_cycle_last,
+		       "Duration of the last main scheduler cycle");
+	_print_seconds("schedule_cycle_max_seconds", "gauge",
+		       buf->schedule_cycle_max,
+		       "Longest main scheduler cycle");
+	_print_seconds("schedule_cycle_seconds", "counter",
+		       buf->schedule_cycle_sum,
+		       "Time spent in main scheduler cycles");
+	_print_gauge("schedule_queue_length", buf->schedule_queue_len,
+		     "Jobs in the last main scheduler queue");
+
+	_print_counter("bf_backfilled_jobs", buf->bf_backfilled_jobs,
+		       "Jobs started by the backfill scheduler");
+	_print_counter("bf_backfilled_het_jobs", buf->bf_backfilled_het_jobs,
+		       "Heterogeneous job components started by backfill");
+	_print_counter("bf_cycles", buf->bf_cycle_counter,
+		       "Backfill scheduler cycles");
+	_print_seconds("bf_cycle_last_seconds", "gauge", buf->bf_cycle_last,
+		       "Duration of the last backfill cycle");
+	_print_seconds("bf_cycle_max_seconds", "gauge", buf->bf_cycle_max,
+		       "Longest backfill cycle");
+	_print_seconds("bf_cycle_seconds", "counter", buf->bf_cycle_sum,
+		       "Time spent in backfill cycles");
+	_print_gauge("bf_last_depth", buf->bf_last_depth,
+		     "Jobs considered in the last backfill cycle");
+	_print_gauge("bf_last_depth_try", buf->bf_last_depth_try,
+		     "Jobs tested for start in the last backfill cycle");
+	_print_gauge("bf_queue_length", buf->bf_queue_len,
+		     "Jobs in the last backfill queue");
+	_print_gauge("bf_table_size", buf->bf_table_size,
+		     "Time slots in the last backfill table");
+	_print_gauge("bf_active", buf->bf_active,
+		     "Whether the backfill scheduler is running");
+
+	_print_rpc_types();
+	_print_rpc_users();
+
+	_print_family("rpc_pending", "gauge", NULL,
+		      "Outgoing RPCs pending in the agent queue by type");
+	for (int i = 0; i < buf->rpc_queue_type_count; i++)
+		printf(PREFIX"rpc_pending{type=\"%s\"} %u\n",
+		       rpc_num2string(buf->rpc_queue_type_id[i]),
+		       buf->rpc_queue_count[i]);
+
+	if (buf->lock_stats_enabled)
+		_print_lock_stats();
+
+	if (buf->plugin_stats_cnt)
+		_print_plugin_stats();
+
+	_print_counter("bitmap_cache_hits", buf->bitmap_cache_hits,
+		       "Bitmap allocations served from the cache");
+	_print_counter("bitmap_cache_misses", buf->bitmap_cache_misses,
+		       "Bitmap allocations not served from the cache");
+
+	printf("# EOF\n");
+
+	return 0;
+}
@@ -52,6 +52,7 @@
 #define OPT_LONG_JSON 0x102
 #define OPT_LONG_YAML 0x103
 #define OPT_LONG_AUTOCOMP 0x104
+#define OPT_LONG_OPENMETRICS 0x105
 
 static void  _help( void );
 static void  _usage( void );
@@ -87,6 +88,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"version",     no_argument,	0,	'V'},
 		{"json", optional_argument, 0, OPT_LONG_JSON},
 		{"yaml", optional_argument, 0, OPT_LONG_YAML},
+		{"openmetrics", no_argument, 0, OPT_LONG_OPENMETRICS},
 		{NULL,		0,		0,	0}
 	};
 
@@ -150,6 +152,9 @@ extern void parse_command_line(int argc, char **argv)
 						      NULL))
 					fatal("YAML plugin load failure");
 				break;
+			case OPT_LONG_OPENMETRICS:
+				params.openmetrics = true;
+				break;
 			case OPT_LONG_AUTOCOMP:
 				suggest_completion(long_options, optarg);
 				exit(0);
@@ -195,6 +200,7 @@ Usage: sdiag [OPTIONS]\n\
   -V, --version       display current version number\n\
   --json[=data_parser] Produce JSON output\n\
   --yaml[=data_parser] Produce YAML output\n\
+  --openmetrics       Produce OpenMetrics text output\n\
 \nHelp options:\n\
   --help          show this help message\n\
   --usage         display brief usage message\n");
@@ -69,6 +69,7 @@ typedef struct {
 	uint64_t dropped;
 	uint16_t cycle_last;
 	uint16_t cycle_max;
+	uint32_t *hist;
 } rpc_stat_t;
 
 static rpc_stat_t *types = NULL, *users = NULL;
@@ -77,6 +78,9 @@ struct sdiag_parameters params = {0};
 
 stats_info_response_msg_t *buf;
 
+static void _print_lock_stats(void);
+static void _print_rpc_percentiles(const char *name, uint32_t id,
+				   rpc_stat_t *stat);
 static int  _print_stats(void);
 static void _sort_rpc(void);
 
@@ -109,6 +113,8 @@ int main(int argc, char **argv)
 						     argc, argv, NULL,
 						     params.mimetype,
 						     params.data_parser, rc);
+			} else if (params.openmetrics) {
+				rc = print_openmetrics();
 			} else {
 				rc = _print_stats();
 			}
@@ -122,6 +128,21 @@ int main(int argc, char **argv)
 	exit(rc);
 }
 
+/* Percentiles are the upper bound of a log2 bucket, so within a factor of 2 */
+static void _print_rpc_percentiles(const char *name, uint32_t id,
+				   rpc_stat_t *stat)
+{
+	uint32_t cnt = buf->rpc_hist_cnt;
+
+	if (!stat->hist || !stat->count)
+		return;
+
+	printf("\t%-40s(%8u) p50:%-10"PRIu64" p99:%-10"PRIu64" p999:%"PRIu64"\n",
+	       name, id, rpc_hist_percentile(stat->hist, cnt, 50),
+	       rpc_hist_percentile(stat->hist, cnt, 99),
+	       rpc_hist_percentile(stat->hist, cnt, 99.9));
+}
+
 static int _print_stats(void)
 {
 	int i;
@@ -231,6 +252,16 @@ static int _print_stats(void)
 		       buf->bf_exit[i]);
 	}
 
+	if (buf->fair_tree_cycle_counter) {
+		printf("\nFair Tree stats\n");
+		printf("\tTotal cycles: %u\n", buf->fair_tree_cycle_counter);
+		printf("\tLast cycle: %u\n", buf->fair_tree_cycle_last);
+		printf("\tMax cycle:  %u\n", buf->fair_tree_cycle_max);
+		printf("\tMean cycle: %"PRIu64"\n",
+		       buf->fair_tree_cycle_sum /
+		       buf->fair_tree_cycle_counter);
+	}
+
 	printf("\nLatency for 1000 calls to gettimeofday(): %d microseconds\n",
 	       buf->gettimeofday_latency);
 
@@ -261,6 +292,21 @@ static int _print_stats(void)
 		xfree(user);
 	}
 
+	if (buf->rpc_hist_cnt) {
+		printf("\nRemote Procedure Call latency by message type (microseconds)\n");
+		for (i = 0; i < buf->rpc_type_size; i++)
+			_print_rpc_percentiles(rpc_num2string(types[i].id),
+					       types[i].id, &types[i]);
+
+		printf("\nRemote Procedure Call latency by user (microseconds)\n");
+		for (i = 0; i < buf->rpc_user_size; i++) {
+			char *user = uid_to_string(users[i].id);
+
+			_print_rpc_percentiles(user, users[i].id, &users[i]);
+			xfree(user);
+		}
+	}
+
 	printf("\nPending RPC statistics\n");
 	if (buf->rpc_queue_type_count == 0)
 		printf("\tNo pending RPCs\n");
@@ -282,9 +328,119 @@ static int _print_stats(void)
 		       buf->rpc_dump_hostlist[i]);
 	}
 
+	if (buf->bitmap_cache_hits || buf->bitmap_cache_misses) {
+		printf("\nBitmap cache statistics\n");
+		printf("\tAllocations from cache:   %"PRIu64"\n",
+		       buf->bitmap_cache_hits);
+		printf("\tAllocations not in cache: %"PRIu64"\n",
+		       buf->bitmap_cache_misses);
+		printf("\tHit rate:                 %.1f%%\n",
+		       (100.0 * buf->bitmap_cache_hits) /
+		       (buf->bitmap_cache_hits + buf->bitmap_cache_misses));
+	}
+
+	if (buf->xmalloc_stats_cnt) {
+		printf("\nMemory allocation statistics by subsystem\n");
+		for (i = 0; i < buf->xmalloc_stats_cnt; i++)
+			printf("\t%-24s allocs:%-10"PRIu64" frees:%-10"PRIu64" live_bytes:%"PRIu64"\n",
+			       buf->xmalloc_stats_name[i],
+			       buf->xmalloc_stats_allocs[i],
+			       buf->xmalloc_stats_frees[i],
+			       buf->xmalloc_stats_bytes[i]);
+	}
+
+	if (buf->plugin_stats_cnt) {
+		printf("\nPlugin operation statistics (microseconds)\n");
+		for (i = 0; i < buf->plugin_stats_cnt; i++) {
+			uint32_t *hist = &buf->plugin_stats_hist[
+				i * buf->rpc_hist_cnt];
+			uint64_t ave = 0;
+
+			if (!buf->plugin_stats_calls[i])
+				continue;
+			ave = buf->plugin_stats_time[i] /
+			      buf->plugin_stats_calls[i];
+			printf("\t%-24s %-28s count:%-8u ave_time:%-8"PRIu64" max_time:%-8"PRIu64" p99:%-8"PRIu64" total_time:%"PRIu64"\n",
+			       buf->plugin_stats_name[i],
+			       buf->plugin_stats_op[i],
+			       buf->plugin_stats_calls[i], ave,
+			       buf->plugin_stats_max[i],
+			       rpc_hist_percentile(hist, buf->rpc_hist_cnt, 99),
+			       buf->plugin_stats_time[i]);
+		}
+	}
+
+	if (buf->lock_stats_enabled)
+		_print_lock_stats();
+
 	return 0;
 }
 
+/* highest to lowest lock wait time */
+static int _sort_lock_caller(const void *p1, const void *p2)
+{
+	uint64_t t1 = buf->lock_caller_wait_time[*(const int *) p1];
+	uint64_t t2 = buf->lock_caller_wait_time[*(const int *) p2];
+
+	if (t1 < t2)
+		return 1;
+	else if (t1 > t2)
+		return -1;
+	return 0;
+}
+
+static void _print_lock_stats(void)
+{
+	static const char *lock_names[] = {
+		"conf", "job", "node", "part", "fed"
+	};
+	static const char *hist_names[] = {
+		"<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+	};
+	int *order;
+
+	printf("\nLock statistics (microseconds)\n");
+	for (int i = 0; i < buf->lock_stats_cnt; i++) {
+		const char *name = "unknown";
+
+		if ((i / 2) < ARRAY_SIZE(lock_names))
+			name = lock_names[i / 2];
+		printf("\t%-4s %-5s count:%-8u wait_time:%-12"PRIu64" wait_max:%-10"PRIu64" hold_time:%-12"PRIu64" hold_max:%"PRIu64"\n",
+		       name, (i % 2) ? "write" : "read", buf->lock_cnt[i],
+		       buf->lock_wait_time[i], buf->lock_wait_max[i],
+		       buf->lock_hold_time[i], buf->lock_hold_max[i]);
+		if (!buf->lock_cnt[i])
+			continue;
+		printf("\t\twait:");
+		for (int j = 0; j < buf->lock_wait_hist_cnt; j++) {
+			const char *hist = "?";
+
+			if (j < ARRAY_SIZE(hist_names))
+				hist = hist_names[j];
+			printf(" %s:%u", hist,
+			       buf->lock_wait_hist[(i * buf->lock_wait_hist_cnt)
+						   + j]);
+		}
+		printf("\n");
+	}
+
+	printf("\nLock statistics by caller (microseconds)\n");
+	order = xcalloc(buf->lock_caller_size, sizeof(*order));
+	for (int i = 0; i < buf->lock_caller_size; i++)
+		order[i] = i;
+	qsort(order, buf->lock_caller_size, sizeof(*order), _sort_lock_caller);
+	for (int i = 0; i < buf->lock_caller_size; i++) {
+		int j = order[i];
+
+		printf("\t%-40s count:%-8u wait_time:%-12"PRIu64" wait_max:%-10"PRIu64" hold_time:%"PRIu64"\n",
+		       buf->lock_caller_name[j], buf->lock_caller_cnt[j],
+		       buf->lock_caller_wait_time[j],
+		       buf->lock_caller_wait_max[j],
+		       buf->lock_caller_hold_time[j]);
+	}
+	xfree(order);
+}
+
 /* lowest to highest */
 static int _sort_id(const void *p1, const void *p2)
 {
@@ -351,6 +507,9 @@ static void _sort_rpc(void)
 			types[i].cycle_last = buf->rpc_type_cycle_last[i];
 			types[i].cycle_max = buf->rpc_type_cycle_max[i];
 		}
+		if (buf->rpc_hist_cnt)
+			types[i].hist = &buf->rpc_type_hist[i *
+							    buf->rpc_hist_cnt];
 	}
 
 	users = xcalloc(buf->rpc_user_size, sizeof(rpc_stat_t));
@@ -361,6 +520,9 @@ static void _sort_rpc(void)
 		if (buf->rpc_user_cnt[i])
 			users[i].average_time = buf->rpc_user_time[i] /
 						buf->rpc_user_cnt[i];
+		if (buf->rpc_hist_cnt)
+			users[i].hist = &buf->rpc_user_hist[i *
+							    buf->rpc_hist_cnt];
 	}
 
 	if (params.sort == SORT_ID)
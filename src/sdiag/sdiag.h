@@ -45,6 +45,7 @@ struct sdiag_parameters {
 	char *cluster_names;
 	char *mimetype; /* --yaml or --json */
 	char *data_parser; /* data_parser args */
+	bool openmetrics; /* --openmetrics */
 };
 
 typedef enum {
@@ -58,5 +59,9 @@ typedef enum {
  * Global Variables *
  ********************/
 extern struct sdiag_parameters params;
+extern stats_info_response_msg_t *buf;
+
+/* Print buf in OpenMetrics text exposition format */
+extern int print_openmetrics(void);
 
 #endif
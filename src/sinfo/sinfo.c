@@ -73,6 +73,29 @@ static pthread_mutex_t sinfo_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  sinfo_cnt_cond  = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t sinfo_list_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * sinfo records indexed by a hash of the fields _match_part_data() and
+ * _match_node_data() compare for the current output format, so that adding a
+ * node only checks records that can possibly match rather than the whole
+ * sinfo_list. Records created for empty partitions have no node data yet and
+ * are indexed by their partition hash only until the first node is added.
+ */
+typedef struct sinfo_hash_ent {
+	uint32_t key;
+	bool empty;		/* record created without a node */
+	uint32_t seq;		/* position in sinfo_list */
+	sinfo_data_t *sinfo_ptr;
+	struct sinfo_hash_ent *next;
+} sinfo_hash_ent_t;
+
+#define SINFO_HASH_INIT_SIZE 1024
+
+static sinfo_hash_ent_t **sinfo_hash = NULL;
+static uint32_t sinfo_hash_size = 0;
+static uint32_t sinfo_hash_cnt = 0;
+static uint32_t sinfo_hash_seq = 0;
+static pthread_mutex_t sinfo_hash_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /*************
  * Functions *
  *************/
@@ -91,6 +114,8 @@ static int _get_info(bool clear_old, slurmdb_federation_rec_t *fed,
 static int  _insert_node_ptr(List sinfo_list, uint16_t part_num,
 			     partition_info_t *part_ptr,
 			     node_info_t *node_ptr);
+static void _insert_part_ptr(List sinfo_list, uint16_t part_num,
+			     partition_info_t *part_ptr);
 static int  _load_resv(reserve_info_msg_t ** reserv_pptr, bool clear_old);
 static bool _match_node_data(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr);
 static bool _match_part_data(sinfo_data_t *sinfo_ptr,
@@ -104,6 +129,7 @@ static List _query_fed_servers(slurmdb_federation_rec_t *fed,
 static List _query_server(bool clear_old);
 static int  _reservation_report(reserve_info_msg_t *resv_ptr);
 static bool _serial_part_data(void);
+static void _sinfo_hash_fini(void);
 static void _sinfo_list_delete(void *data);
 static void _sort_hostlist(List sinfo_list);
 static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr);
@@ -587,9 +613,8 @@ static int _build_sinfo_data(List sinfo_list,
 			    (list_find_first(params.part_list,
 					     _find_part_list,
 					     part_ptr->name))) {
-				list_append(sinfo_list, _create_sinfo(
-						    part_ptr, (uint16_t) j,
-						    NULL));
+				_insert_part_ptr(sinfo_list, (uint16_t) j,
+						 part_ptr);
 			}
 		}
 	}
@@ -650,6 +675,7 @@ static int _build_sinfo_data(List sinfo_list,
 	}
 	slurm_mutex_unlock(&sinfo_cnt_mutex);
 
+	_sinfo_hash_fini();
 	_sort_hostlist(sinfo_list);
 	return SLURM_SUCCESS;
 }
@@ -1119,31 +1145,272 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 		sinfo_ptr->cpus_idle += total_cpus;
 }
 
+static uint32_t _hash_int(uint32_t hash, uint64_t val)
+{
+	hash = (hash ^ (uint32_t) val) * 16777619;
+	hash = (hash ^ (uint32_t) (val >> 32)) * 16777619;
+	return hash;
+}
+
+static uint32_t _hash_str(uint32_t hash, const char *str)
+{
+	/* xstrcmp() tells NULL apart from "" */
+	if (!str)
+		return _hash_int(hash, 1);
+	for (; *str; str++)
+		hash = (hash ^ (unsigned char) *str) * 16777619;
+	return _hash_int(hash, 0);
+}
+
+/* Hash the fields compared by _match_part_data() */
+static uint32_t _hash_part_data(partition_info_t *part_ptr)
+{
+	uint32_t hash = 2166136261U;
+
+	if (params.list_reasons || !part_ptr)
+		return hash;
+
+	if (params.match_flags & MATCH_FLAG_PARTITION)
+		hash = _hash_str(hash, part_ptr->name);
+	if (params.match_flags & MATCH_FLAG_AVAIL)
+		hash = _hash_int(hash, part_ptr->state_up);
+	if (params.match_flags & MATCH_FLAG_GROUPS)
+		hash = _hash_str(hash, part_ptr->allow_groups);
+	if (params.match_flags & MATCH_FLAG_JOB_SIZE) {
+		hash = _hash_int(hash, part_ptr->min_nodes);
+		hash = _hash_int(hash, part_ptr->max_nodes);
+	}
+	if (params.match_flags & MATCH_FLAG_DEFAULT_TIME)
+		hash = _hash_int(hash, part_ptr->default_time);
+	if (params.match_flags & MATCH_FLAG_MAX_TIME)
+		hash = _hash_int(hash, part_ptr->max_time);
+	if (params.match_flags & MATCH_FLAG_ROOT)
+		hash = _hash_int(hash, part_ptr->flags & PART_FLAG_ROOT_ONLY);
+	if (params.match_flags & MATCH_FLAG_OVERSUBSCRIBE)
+		hash = _hash_int(hash, part_ptr->max_share);
+	if (params.match_flags & MATCH_FLAG_PREEMPT_MODE)
+		hash = _hash_int(hash, part_ptr->preempt_mode);
+	if (params.match_flags & MATCH_FLAG_PRIORITY_TIER)
+		hash = _hash_int(hash, part_ptr->priority_tier);
+	if (params.match_flags & MATCH_FLAG_PRIORITY_JOB_FACTOR)
+		hash = _hash_int(hash, part_ptr->priority_job_factor);
+	if (params.match_flags & MATCH_FLAG_MAX_CPUS_PER_NODE)
+		hash = _hash_int(hash, part_ptr->max_cpus_per_node);
+
+	return hash;
+}
+
+/* Hash the fields compared by _match_node_data() */
+static uint32_t _hash_node_data(uint32_t hash, node_info_t *node_ptr)
+{
+	uint64_t tmp = 0;
+
+	if (params.match_flags & MATCH_FLAG_HOSTNAMES)
+		hash = _hash_str(hash, node_ptr->node_hostname);
+	if (params.match_flags & MATCH_FLAG_NODE_ADDR)
+		hash = _hash_str(hash, node_ptr->node_addr);
+	if (params.match_flags & MATCH_FLAG_EXTRA)
+		hash = _hash_str(hash, node_ptr->extra);
+	if (params.match_flags & MATCH_FLAG_FEATURES)
+		hash = _hash_str(hash, node_ptr->features);
+	if (params.match_flags & MATCH_FLAG_FEATURES_ACT)
+		hash = _hash_str(hash, node_ptr->features_act);
+	if (params.match_flags & MATCH_FLAG_GRES)
+		hash = _hash_str(hash, node_ptr->gres);
+	if (params.match_flags & MATCH_FLAG_GRES_USED)
+		hash = _hash_str(hash, node_ptr->gres_used);
+	if (params.match_flags & MATCH_FLAG_COMMENT)
+		hash = _hash_str(hash, node_ptr->comment);
+	if (params.match_flags & MATCH_FLAG_REASON)
+		hash = _hash_str(hash, node_ptr->reason);
+	if (params.match_flags & MATCH_FLAG_REASON_TIMESTAMP)
+		hash = _hash_int(hash, node_ptr->reason_time);
+	if (params.match_flags & MATCH_FLAG_REASON_USER)
+		hash = _hash_int(hash, node_ptr->reason_uid);
+	if (params.match_flags & MATCH_FLAG_RESV_NAME)
+		hash = _hash_str(hash, node_ptr->resv_name);
+	if (params.match_flags & MATCH_FLAG_STATE)
+		hash = _hash_str(hash, node_state_string(node_ptr->node_state));
+	if (params.match_flags & MATCH_FLAG_STATE_COMPLETE) {
+		char *state = node_state_string_complete(node_ptr->node_state);
+		hash = _hash_str(hash, state);
+		xfree(state);
+	}
+	if (params.match_flags & MATCH_FLAG_ALLOC_MEM) {
+		select_g_select_nodeinfo_get(node_ptr->select_nodeinfo,
+					     SELECT_NODEDATA_MEM_ALLOC,
+					     NODE_STATE_ALLOCATED,
+					     &tmp);
+		hash = _hash_int(hash, tmp);
+	}
+
+	if (!params.exact_match)
+		return hash;
+
+	if (params.match_flags & MATCH_FLAG_CPUS)
+		hash = _hash_int(hash, node_ptr->cpus);
+	if (params.match_flags & (MATCH_FLAG_SOCKETS | MATCH_FLAG_SCT))
+		hash = _hash_int(hash, node_ptr->sockets);
+	if (params.match_flags & (MATCH_FLAG_CORES | MATCH_FLAG_SCT))
+		hash = _hash_int(hash, node_ptr->cores);
+	if (params.match_flags & (MATCH_FLAG_THREADS | MATCH_FLAG_SCT))
+		hash = _hash_int(hash, node_ptr->threads);
+	if (params.match_flags & MATCH_FLAG_DISK)
+		hash = _hash_int(hash, node_ptr->tmp_disk);
+	if (params.match_flags & MATCH_FLAG_MEMORY)
+		hash = _hash_int(hash, node_ptr->real_memory);
+	if (params.match_flags & MATCH_FLAG_WEIGHT)
+		hash = _hash_int(hash, node_ptr->weight);
+	if (params.match_flags & MATCH_FLAG_CPU_LOAD)
+		hash = _hash_int(hash, node_ptr->cpu_load);
+	if (params.match_flags & MATCH_FLAG_FREE_MEM)
+		hash = _hash_int(hash, node_ptr->free_mem);
+	if (params.match_flags & MATCH_FLAG_PORT)
+		hash = _hash_int(hash, node_ptr->port);
+	if (params.match_flags & MATCH_FLAG_VERSION)
+		hash = _hash_int(hash, (uintptr_t) node_ptr->version);
+
+	return hash;
+}
+
+static void _sinfo_hash_link(sinfo_hash_ent_t *ent)
+{
+	uint32_t inx = ent->key & (sinfo_hash_size - 1);
+
+	ent->next = sinfo_hash[inx];
+	sinfo_hash[inx] = ent;
+}
+
+static void _sinfo_hash_add(sinfo_data_t *sinfo_ptr, uint32_t key, bool empty)
+{
+	sinfo_hash_ent_t *ent;
+
+	if (sinfo_hash_cnt >= (sinfo_hash_size * 2)) {
+		sinfo_hash_ent_t **old_hash = sinfo_hash, *next;
+		uint32_t i, old_size = sinfo_hash_size;
+
+		sinfo_hash_size = old_size ? (old_size * 2) :
+					     SINFO_HASH_INIT_SIZE;
+		sinfo_hash = xcalloc(sinfo_hash_size, sizeof(*sinfo_hash));
+		for (i = 0; i < old_size; i++) {
+			for (ent = old_hash[i]; ent; ent = next) {
+				next = ent->next;
+				_sinfo_hash_link(ent);
+			}
+		}
+		xfree(old_hash);
+	}
+
+	ent = xmalloc(sizeof(*ent));
+	ent->key = key;
+	ent->empty = empty;
+	ent->seq = sinfo_hash_seq++;
+	ent->sinfo_ptr = sinfo_ptr;
+	_sinfo_hash_link(ent);
+	sinfo_hash_cnt++;
+}
+
+/*
+ * Find the record _insert_node_ptr() used to pick by walking sinfo_list: the
+ * first one, in list order, that matches the partition and either is still
+ * empty or matches the node data.
+ */
+static sinfo_hash_ent_t *_sinfo_hash_find(uint32_t part_key, uint32_t key,
+					  partition_info_t *part_ptr,
+					  node_info_t *node_ptr,
+					  sinfo_hash_ent_t ***prev_pptr)
+{
+	sinfo_hash_ent_t *ent, **prev, *found = NULL;
+
+	if (!sinfo_hash_size)
+		return NULL;
+
+	for (prev = &sinfo_hash[key & (sinfo_hash_size - 1)];
+	     (ent = *prev); prev = &ent->next) {
+		if (ent->empty || (ent->key != key) ||
+		    (found && (found->seq < ent->seq)))
+			continue;
+		if (!_match_part_data(ent->sinfo_ptr, part_ptr) ||
+		    !_match_node_data(ent->sinfo_ptr, node_ptr))
+			continue;
+		found = ent;
+		*prev_pptr = prev;
+	}
+
+	for (prev = &sinfo_hash[part_key & (sinfo_hash_size - 1)];
+	     (ent = *prev); prev = &ent->next) {
+		if (!ent->empty || (ent->key != part_key) ||
+		    (found && (found->seq < ent->seq)))
+			continue;
+		if (!_match_part_data(ent->sinfo_ptr, part_ptr))
+			continue;
+		found = ent;
+		*prev_pptr = prev;
+	}
+
+	return found;
+}
+
+static void _sinfo_hash_fini(void)
+{
+	sinfo_hash_ent_t *ent, *next;
+
+	for (uint32_t i = 0; i < sinfo_hash_size; i++) {
+		for (ent = sinfo_hash[i]; ent; ent = next) {
+			next = ent->next;
+			xfree(ent);
+		}
+	}
+	xfree(sinfo_hash);
+	sinfo_hash_size = 0;
+	sinfo_hash_cnt = 0;
+	sinfo_hash_seq = 0;
+}
+
+static void _insert_part_ptr(List sinfo_list, uint16_t part_num,
+			     partition_info_t *part_ptr)
+{
+	sinfo_data_t *sinfo_ptr = _create_sinfo(part_ptr, part_num, NULL);
+
+	slurm_mutex_lock(&sinfo_hash_mutex);
+	list_append(sinfo_list, sinfo_ptr);
+	_sinfo_hash_add(sinfo_ptr, _hash_part_data(part_ptr), true);
+	slurm_mutex_unlock(&sinfo_hash_mutex);
+}
+
 static int _insert_node_ptr(List sinfo_list, uint16_t part_num,
 			    partition_info_t *part_ptr,
 			    node_info_t *node_ptr)
 {
 	int rc = SLURM_SUCCESS;
 	sinfo_data_t *sinfo_ptr = NULL;
-	list_itr_t *itr = NULL;
-
-	itr = list_iterator_create(sinfo_list);
-	while ((sinfo_ptr = list_next(itr))) {
-		if (!_match_part_data(sinfo_ptr, part_ptr))
-			continue;
-		if (sinfo_ptr->nodes_total &&
-		    (!_match_node_data(sinfo_ptr, node_ptr)))
-			continue;
+	sinfo_hash_ent_t *ent = NULL, **prev = NULL;
+	uint32_t part_key, key;
+
+	part_key = _hash_part_data(part_ptr);
+	key = _hash_node_data(part_key, node_ptr);
+
+	slurm_mutex_lock(&sinfo_hash_mutex);
+	if (!params.node_flag)
+		ent = _sinfo_hash_find(part_key, key, part_ptr, node_ptr,
+				       &prev);
+	if (ent) {
+		sinfo_ptr = ent->sinfo_ptr;
 		_update_sinfo(sinfo_ptr, node_ptr);
-		break;
-	}
-	list_iterator_destroy(itr);
-
-	/* if no match, create new sinfo_data entry */
-	if (!sinfo_ptr) {
-		list_append(sinfo_list,
-			    _create_sinfo(part_ptr, part_num, node_ptr));
+		if (ent->empty) {
+			/* Now keyed by its node data */
+			*prev = ent->next;
+			ent->key = key;
+			ent->empty = false;
+			_sinfo_hash_link(ent);
+		}
+	} else {
+		/* if no match, create new sinfo_data entry */
+		sinfo_ptr = _create_sinfo(part_ptr, part_num, node_ptr);
+		list_append(sinfo_list, sinfo_ptr);
+		_sinfo_hash_add(sinfo_ptr, key, false);
 	}
+	slurm_mutex_unlock(&sinfo_hash_mutex);
 
 	return rc;
 }
@@ -49,6 +49,9 @@
 
 #define _DEBUG 0
 
+/* Number of *_ctld TRES arrays in the qos_rec built by _init_qos_rec_tres() */
+#define QOS_REC_TRES_ARRAYS 11
+
 enum {
 	ACCT_POLICY_ADD_SUBMIT,
 	ACCT_POLICY_REM_SUBMIT,
@@ -100,6 +103,74 @@ static void _apply_limit_factor(uint64_t *limit, double limit_factor)
 	}
 }
 
+/*
+ * Copy an association's TRES limit array, scaled by the QOS LimitFactor.
+ * Without a factor this is a plain copy, so skip the per TRES checks.
+ */
+static void _copy_factored_limits(uint64_t *dst, uint64_t *src,
+				  double limit_factor)
+{
+	memcpy(dst, src, sizeof(uint64_t) * slurmctld_tres_cnt);
+
+	if (limit_factor <= 0.0)
+		return;
+
+	for (int i = 0; i < slurmctld_tres_cnt; i++)
+		_apply_limit_factor(&dst[i], limit_factor);
+}
+
+/*
+ * The qos_rec used to collect the limits already imposed by a job's QOS never
+ * has TRES strings of its own, so every one of its *_ctld arrays starts out
+ * as INFINITE64. Carve them all out of one caller provided block of
+ * QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt counters instead of allocating
+ * and filling each of them separately on every limit check.
+ */
+static void _init_qos_rec_tres(slurmdb_qos_rec_t *qos_rec,
+			       uint64_t *tres_block)
+{
+	uint64_t **tres_arrays[] = {
+		&qos_rec->grp_tres_ctld,
+		&qos_rec->grp_tres_mins_ctld,
+		&qos_rec->grp_tres_run_mins_ctld,
+		&qos_rec->max_tres_pa_ctld,
+		&qos_rec->max_tres_pj_ctld,
+		&qos_rec->max_tres_pn_ctld,
+		&qos_rec->max_tres_pu_ctld,
+		&qos_rec->max_tres_mins_pj_ctld,
+		&qos_rec->max_tres_run_mins_pa_ctld,
+		&qos_rec->max_tres_run_mins_pu_ctld,
+		&qos_rec->min_tres_pj_ctld,
+	};
+	int i;
+
+	xassert(ARRAY_SIZE(tres_arrays) == QOS_REC_TRES_ARRAYS);
+
+	for (i = 0; i < (QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt); i++)
+		tres_block[i] = INFINITE64;
+
+	for (i = 0; i < QOS_REC_TRES_ARRAYS; i++)
+		*tres_arrays[i] = tres_block + (i * slurmctld_tres_cnt);
+}
+
+/* Release a qos_rec set up with _init_qos_rec_tres() */
+static void _fini_qos_rec_tres(slurmdb_qos_rec_t *qos_rec)
+{
+	qos_rec->grp_tres_ctld = NULL;
+	qos_rec->grp_tres_mins_ctld = NULL;
+	qos_rec->grp_tres_run_mins_ctld = NULL;
+	qos_rec->max_tres_pa_ctld = NULL;
+	qos_rec->max_tres_pj_ctld = NULL;
+	qos_rec->max_tres_pn_ctld = NULL;
+	qos_rec->max_tres_pu_ctld = NULL;
+	qos_rec->max_tres_mins_pj_ctld = NULL;
+	qos_rec->max_tres_run_mins_pa_ctld = NULL;
+	qos_rec->max_tres_run_mins_pu_ctld = NULL;
+	qos_rec->min_tres_pj_ctld = NULL;
+
+	slurmdb_free_qos_rec_members(qos_rec);
+}
+
 /*
  * Update a job's allocated node count to reflect only nodes that are not
  * already allocated to this association.  Needed to enforce GrpNode limit.
@@ -1495,11 +1566,12 @@ static acct_policy_tres_usage_t _validate_tres_usage_limits(
 	for (i = 0; i < g_tres_count; i++) {
 		(*tres_pos) = i;
 
-		if ((admin_limit_set &&
+		/* Most TRES have no limit, so test for that first */
+		if ((tres_limit_array[i] == INFINITE64) ||
+		    (admin_limit_set &&
 		     admin_limit_set[i] == ADMIN_SET_LIMIT) ||
 		    (out_tres_limit_array &&
-		     out_tres_limit_array[i] != INFINITE64) ||
-		    (tres_limit_array[i] == INFINITE64))
+		     out_tres_limit_array[i] != INFINITE64))
 			continue;
 
 		if (out_tres_limit_set && out_tres_limit_array)
@@ -3119,6 +3191,7 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 				  bool update_call, bool locked)
 {
 	slurmdb_qos_rec_t qos_rec;
+	uint64_t qos_rec_tres[QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt];
 	slurmdb_assoc_rec_t *assoc_ptr = assoc_in;
 	int parent = 0, job_cnt = 1;
 	char *user_name = NULL;
@@ -3150,7 +3223,7 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 	xassert(verify_assoc_lock(QOS_LOCK, WRITE_LOCK));
 	xassert(verify_assoc_lock(TRES_LOCK, READ_LOCK));
 
-	assoc_mgr_set_qos_tres_cnt(&qos_rec);
+	_init_qos_rec_tres(&qos_rec, qos_rec_tres);
 
 	if (qos_ptr_1) {
 		strict_checking = (qos_ptr_1->flags & QOS_FLAG_DENY_LIMIT);
@@ -3184,12 +3257,11 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 
 	while (assoc_ptr) {
 		int tres_pos = 0;
-		for (int i = 0; i < slurmctld_tres_cnt; i++) {
-			grp_tres_ctld[i] = assoc_ptr->grp_tres_ctld[i];
-			max_tres_ctld[i] = assoc_ptr->max_tres_ctld[i];
-			_apply_limit_factor(&grp_tres_ctld[i], limit_factor);
-			_apply_limit_factor(&max_tres_ctld[i], limit_factor);
-		}
+
+		_copy_factored_limits(grp_tres_ctld, assoc_ptr->grp_tres_ctld,
+				      limit_factor);
+		_copy_factored_limits(max_tres_ctld, assoc_ptr->max_tres_ctld,
+				      limit_factor);
 
 		if (!_validate_tres_limits_for_assoc(
 			    &tres_pos, job_desc->tres_req_cnt, 0,
@@ -3458,7 +3530,7 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 end_it:
 	if (!locked)
 		assoc_mgr_unlock(&locks);
-	slurmdb_free_qos_rec_members(&qos_rec);
+	_fini_qos_rec_tres(&qos_rec);
 
 	return rc;
 }
@@ -3656,6 +3728,7 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 {
 	slurmdb_qos_rec_t *qos_ptr_1, *qos_ptr_2;
 	slurmdb_qos_rec_t qos_rec;
+	uint64_t qos_rec_tres[QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt];
 	slurmdb_assoc_rec_t *assoc_ptr;
 	uint32_t time_limit = NO_VAL;
 	bool rc = true;
@@ -3692,7 +3765,7 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 	if (!assoc_mgr_locked)
 		assoc_mgr_lock(&locks);
 
-	assoc_mgr_set_qos_tres_cnt(&qos_rec);
+	_init_qos_rec_tres(&qos_rec, qos_rec_tres);
 
 	acct_policy_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
@@ -3872,7 +3945,7 @@ extern bool acct_policy_job_runnable_pre_select(job_record_t *job_ptr,
 end_it:
 	if (!assoc_mgr_locked)
 		assoc_mgr_unlock(&locks);
-	slurmdb_free_qos_rec_members(&qos_rec);
+	_fini_qos_rec_tres(&qos_rec);
 
 	return rc;
 }
@@ -3887,6 +3960,7 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 {
 	slurmdb_qos_rec_t *qos_ptr_1, *qos_ptr_2;
 	slurmdb_qos_rec_t qos_rec;
+	uint64_t qos_rec_tres[QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt];
 	slurmdb_assoc_rec_t *assoc_ptr;
 	uint64_t grp_tres_ctld[slurmctld_tres_cnt];
 	uint64_t max_tres_ctld[slurmctld_tres_cnt];
@@ -3966,7 +4040,7 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 	if (!assoc_mgr_locked)
 		assoc_mgr_lock(&locks);
 
-	assoc_mgr_set_qos_tres_cnt(&qos_rec);
+	_init_qos_rec_tres(&qos_rec, qos_rec_tres);
 
 	acct_policy_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
@@ -3991,31 +4065,29 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 
 	assoc_ptr = job_ptr->assoc_ptr;
 	while (assoc_ptr) {
-		for (i = 0; i < slurmctld_tres_cnt; i++) {
-			tres_usage_mins[i] =
-				(uint64_t)(assoc_ptr->usage->usage_tres_raw[i]
-					   / 60);
-			tres_run_mins[i] =
-				assoc_ptr->usage->grp_used_tres_run_secs[i] /
-				60;
-
-			/*
-			 * Clear usage if factor is 0 so that jobs can run.
-			 * Otherwise multiplying can cause more jobs to be run
-			 * than the limit allows (e.g. usagefactor=.5).
-			 */
-			if (usage_factor == 0.0) {
-				tres_usage_mins[i] *= usage_factor;
-				tres_run_mins[i] *= usage_factor;
+		/*
+		 * Clear usage if factor is 0 so that jobs can run.
+		 * Otherwise multiplying can cause more jobs to be run
+		 * than the limit allows (e.g. usagefactor=.5).
+		 */
+		if (usage_factor == 0.0) {
+			memset(tres_usage_mins, 0, sizeof(tres_usage_mins));
+			memset(tres_run_mins, 0, sizeof(tres_run_mins));
+		} else {
+			for (i = 0; i < slurmctld_tres_cnt; i++) {
+				tres_usage_mins[i] = (uint64_t)
+					(assoc_ptr->usage->usage_tres_raw[i] /
+					 60);
+				tres_run_mins[i] = assoc_ptr->usage->
+					grp_used_tres_run_secs[i] / 60;
 			}
-
-			grp_tres_ctld[i] = assoc_ptr->grp_tres_ctld[i];
-			max_tres_ctld[i] = assoc_ptr->max_tres_ctld[i];
-
-			_apply_limit_factor(&grp_tres_ctld[i], limit_factor);
-			_apply_limit_factor(&max_tres_ctld[i], limit_factor);
 		}
 
+		_copy_factored_limits(grp_tres_ctld, assoc_ptr->grp_tres_ctld,
+				      limit_factor);
+		_copy_factored_limits(max_tres_ctld, assoc_ptr->max_tres_ctld,
+				      limit_factor);
+
 #if _DEBUG
 		info("acct_job_limits: %u of %u",
 		     assoc_ptr->usage->used_jobs, assoc_ptr->max_jobs);
@@ -4258,7 +4330,7 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 end_it:
 	if (!assoc_mgr_locked)
 		assoc_mgr_unlock(&locks);
-	slurmdb_free_qos_rec_members(&qos_rec);
+	_fini_qos_rec_tres(&qos_rec);
 
 	return rc;
 }
@@ -4480,6 +4552,7 @@ extern bool acct_policy_job_time_out(job_record_t *job_ptr)
 	uint32_t wall_mins, orig_node_cnt;
 	slurmdb_qos_rec_t *qos_ptr_1, *qos_ptr_2;
 	slurmdb_qos_rec_t qos_rec;
+	uint64_t qos_rec_tres[QOS_REC_TRES_ARRAYS * slurmctld_tres_cnt];
 	slurmdb_assoc_rec_t *assoc = NULL;
 	assoc_mgr_lock_t locks =
 		{ .assoc = READ_LOCK, .qos = WRITE_LOCK, .tres = READ_LOCK };
@@ -4499,7 +4572,7 @@ extern bool acct_policy_job_time_out(job_record_t *job_ptr)
 	slurmdb_init_qos_rec(&qos_rec, 0, INFINITE);
 	assoc_mgr_lock(&locks);
 
-	assoc_mgr_set_qos_tres_cnt(&qos_rec);
+	_init_qos_rec_tres(&qos_rec, qos_rec_tres);
 
 	acct_policy_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
@@ -4636,7 +4709,7 @@ extern bool acct_policy_job_time_out(job_record_t *job_ptr)
 	}
 job_failed:
 	assoc_mgr_unlock(&locks);
-	slurmdb_free_qos_rec_members(&qos_rec);
+	_fini_qos_rec_tres(&qos_rec);
 
 	if (job_ptr->state_reason == FAIL_TIMEOUT)
 		return true;
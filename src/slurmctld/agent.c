@@ -89,6 +89,7 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_socket.h"
 #include "src/common/uid.h"
+#include "src/common/usdt.h"
 #include "src/common/xsignal.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
@@ -115,6 +116,7 @@
 #define HOSTLIST_MAX_SIZE 	80
 #define MAIL_PROG_TIMEOUT 120 /* Timeout in seconds */
 #define AGENT_SHUTDOWN_WAIT 3
+#define COALESCE_MAX_NODES 1024	/* Cap on nodes merged into one request */
 
 typedef enum {
 	DSH_NEW,        /* Request not yet started */
@@ -152,6 +154,7 @@ typedef struct {
 	pthread_cond_t thread_cond;	/* agent specific condition */
 	uint32_t thread_count;		/* number of threads records */
 	uint32_t threads_active;	/* currently active threads */
+	uint32_t threads_done;		/* threads which have completed */
 	uint16_t retry;			/* if set, keep trying */
 	thd_t *thread_struct;		/* thread structures */
 	bool get_reply;			/* flag if reply expected */
@@ -168,6 +171,7 @@ typedef struct {
 	pthread_cond_t *thread_cond_ptr;/* pointer to agent specific
 					 * condition */
 	uint32_t *threads_active_ptr;	/* currently active thread ptr */
+	uint32_t *threads_done_ptr;	/* completed thread count ptr */
 	thd_t *thread_struct_ptr;	/* thread structures ptr */
 	bool get_reply;			/* flag if reply expected */
 	uid_t r_uid;			/* receiver UID */
@@ -565,6 +569,7 @@ static task_info_t *_make_task_data(agent_info_t *agent_info_ptr, int inx)
 	task_info_ptr->thread_mutex_ptr  = &agent_info_ptr->thread_mutex;
 	task_info_ptr->thread_cond_ptr   = &agent_info_ptr->thread_cond;
 	task_info_ptr->threads_active_ptr= &agent_info_ptr->threads_active;
+	task_info_ptr->threads_done_ptr  = &agent_info_ptr->threads_done;
 	task_info_ptr->thread_struct_ptr = &agent_info_ptr->thread_struct[inx];
 	task_info_ptr->get_reply         = agent_info_ptr->get_reply;
 	task_info_ptr->r_uid = agent_info_ptr->r_uid;
@@ -612,7 +617,9 @@ static void _update_wdog_state(thd_t *thread_ptr,
  * _wdog - Watchdog thread. Send SIGUSR1 to threads which have been active
  *	for too long.
  * IN args - pointer to agent_info_t with info on threads to watch
- * Sleep between polls with exponential times (from 0.005 to 1.0 second)
+ * Sleep between polls with exponential times (from 0.005 to 1.0 second),
+ * but wake as soon as every thread has completed so the agent does not
+ * linger once its RPCs are done.
  */
 static void *_wdog(void *args)
 {
@@ -624,6 +631,7 @@ static void *_wdog(void *args)
 	list_itr_t *itr;
 	thd_complete_t thd_comp;
 	ret_data_info_t *ret_data_info = NULL;
+	struct timespec ts = {0, 0};
 
 	if ( (agent_ptr->msg_type == SRUN_JOB_COMPLETE)			||
 	     (agent_ptr->msg_type == SRUN_REQUEST_SUSPEND)		||
@@ -641,17 +649,27 @@ static void *_wdog(void *args)
 
 	thd_comp.max_delay = 0;
 
+	slurm_mutex_lock(&agent_ptr->thread_mutex);
 	while (1) {
 		thd_comp.work_done   = true;/* assume all threads complete */
 		thd_comp.fail_cnt    = 0;   /* assume no threads failures */
 		thd_comp.no_resp_cnt = 0;   /* assume all threads respond */
 		thd_comp.retry_cnt   = 0;   /* assume no required retries */
-		thd_comp.now         = time(NULL);
 
-		usleep(usec);
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += usec / USEC_IN_SEC;
+		ts.tv_nsec += (usec % USEC_IN_SEC) * NSEC_IN_USEC;
+		if (ts.tv_nsec >= NSEC_IN_SEC) {
+			ts.tv_sec++;
+			ts.tv_nsec -= NSEC_IN_SEC;
+		}
 		usec = MIN((usec * 2), 1000000);
 
-		slurm_mutex_lock(&agent_ptr->thread_mutex);
+		if (agent_ptr->threads_done < agent_ptr->thread_count)
+			slurm_cond_timedwait(&agent_ptr->thread_cond,
+					     &agent_ptr->thread_mutex, &ts);
+		thd_comp.now = time(NULL);
+
 		for (i = 0; i < agent_ptr->thread_count; i++) {
 			//info("thread name %s",thread_ptr[i].node_name);
 			if (!thread_ptr[i].ret_list) {
@@ -671,8 +689,6 @@ static void *_wdog(void *args)
 		}
 		if (thd_comp.work_done)
 			break;
-
-		slurm_mutex_unlock(&agent_ptr->thread_mutex);
 	}
 
 	if (sack_agent) {
@@ -934,6 +950,7 @@ static void *_thread_per_group_rpc(void *args)
 	pthread_mutex_t *thread_mutex_ptr   = task_ptr->thread_mutex_ptr;
 	pthread_cond_t  *thread_cond_ptr    = task_ptr->thread_cond_ptr;
 	uint32_t        *threads_active_ptr = task_ptr->threads_active_ptr;
+	uint32_t        *threads_done_ptr   = task_ptr->threads_done_ptr;
 	thd_t           *thread_ptr         = task_ptr->thread_struct_ptr;
 	state_t thread_state = DSH_NO_RESP;
 	slurm_msg_type_t msg_type = task_ptr->msg_type;
@@ -998,6 +1015,8 @@ static void *_thread_per_group_rpc(void *args)
 		xfree(tmp_str);
 	}
 
+	SLURM_PROBE2(agent_send, msg_type, thread_ptr->nodename);
+
 	if (task_ptr->get_reply) {
 		if (thread_ptr->addr) {
 			msg.address = *thread_ptr->addr;
@@ -1068,6 +1087,8 @@ static void *_thread_per_group_rpc(void *args)
 	while ((ret_data_info = list_next(itr))) {
 		rc = slurm_get_return_code(ret_data_info->type,
 					   ret_data_info->data);
+		SLURM_PROBE3(agent_response, msg_type,
+			     ret_data_info->node_name, rc);
 		/* SPECIAL CASE: Record node's CPU load */
 		if (ret_data_info->type == RESPONSE_PING_SLURMD) {
 			ping_slurmd_resp_msg_t *ping_resp;
@@ -1282,9 +1303,13 @@ cleanup:
 	thread_ptr->state = thread_state;
 	thread_ptr->end_time = (time_t) difftime(time(NULL),
 						 thread_ptr->start_time);
-	/* Signal completion so another thread can replace us */
+	/*
+	 * Signal completion so another thread can replace us. Both agent()
+	 * and _wdog() wait on this condition, so wake all waiters.
+	 */
 	(*threads_active_ptr)--;
-	slurm_cond_signal(thread_cond_ptr);
+	(*threads_done_ptr)++;
+	slurm_cond_broadcast(thread_cond_ptr);
 	slurm_mutex_unlock(thread_mutex_ptr);
 	return NULL;
 }
@@ -1804,6 +1829,91 @@ static int _find_request(void *x, void *key)
 	return 0;
 }
 
+static bool _coalesce_msg_type(slurm_msg_type_t msg_type)
+{
+	return ((msg_type == REQUEST_TERMINATE_JOB) ||
+		(msg_type == REQUEST_KILL_TIMELIMIT) ||
+		(msg_type == REQUEST_ABORT_JOB));
+}
+
+static int _find_coalesce_request(void *x, void *key)
+{
+	queued_request_t *queued_req_ptr = x;
+	agent_arg_t *queued = queued_req_ptr->agent_arg_ptr;
+	agent_arg_t *agent_arg_ptr = key;
+	kill_job_msg_t *queued_kill, *kill_req;
+
+	/* Only merge into requests which have not been sent yet */
+	if (queued_req_ptr->last_attempt || !queued || queued->addr ||
+	    !queued->hostlist)
+		return 0;
+	if ((queued->msg_type != agent_arg_ptr->msg_type) ||
+	    (queued->protocol_version != agent_arg_ptr->protocol_version) ||
+	    (queued->r_uid != agent_arg_ptr->r_uid) ||
+	    (queued->retry != agent_arg_ptr->retry) ||
+	    (queued->msg_flags != agent_arg_ptr->msg_flags))
+		return 0;
+	if ((queued->node_count + agent_arg_ptr->node_count) >
+	    COALESCE_MAX_NODES)
+		return 0;
+
+	queued_kill = queued->msg_args;
+	kill_req = agent_arg_ptr->msg_args;
+	if ((queued_kill->step_id.job_id != kill_req->step_id.job_id) ||
+	    (queued_kill->step_id.step_id != kill_req->step_id.step_id) ||
+	    (queued_kill->step_id.step_het_comp !=
+	     kill_req->step_id.step_het_comp) ||
+	    (queued_kill->start_time != kill_req->start_time) ||
+	    (queued_kill->job_state != kill_req->job_state))
+		return 0;
+
+	return 1;
+}
+
+/*
+ * Merge a job termination request into an identical request for the same
+ * job which is still waiting in retry_list, so that nodes reporting the same
+ * job share one fan-out instead of spawning an agent each.
+ * Call with retry_mutex locked.
+ * RET true if agent_arg_ptr was merged and purged
+ */
+static bool _coalesce_request(agent_arg_t *agent_arg_ptr)
+{
+	queued_request_t *queued_req_ptr;
+	agent_arg_t *queued;
+	kill_job_msg_t *queued_kill;
+
+	if (!retry_list || !_coalesce_msg_type(agent_arg_ptr->msg_type) ||
+	    agent_arg_ptr->addr || !agent_arg_ptr->hostlist ||
+	    !agent_arg_ptr->msg_args)
+		return false;
+
+	if (!(queued_req_ptr = list_find_first(retry_list,
+					       _find_coalesce_request,
+					       agent_arg_ptr)))
+		return false;
+
+	queued = queued_req_ptr->agent_arg_ptr;
+	hostlist_push_list(queued->hostlist, agent_arg_ptr->hostlist);
+	hostlist_uniq(queued->hostlist);
+	queued->node_count = hostlist_count(queued->hostlist);
+
+	/* Keep the node list in the message consistent with the fan-out */
+	queued_kill = queued->msg_args;
+	if (queued_kill->nodes) {
+		xfree(queued_kill->nodes);
+		queued_kill->nodes = hostlist_ranged_string_xmalloc(
+			queued->hostlist);
+	}
+
+	log_flag(AGENT, "%s: merged %s for %ps into queued request for %u nodes",
+		 __func__, rpc_num2string(agent_arg_ptr->msg_type),
+		 &queued_kill->step_id, queued->node_count);
+
+	purge_agent_args(agent_arg_ptr);
+	return true;
+}
+
 /* Do the work requested by agent_retry (retry pending RPCs).
  * This is a separate thread so the job records can be locked */
 static void _agent_retry(int min_wait, bool mail_too)
@@ -1942,9 +2052,13 @@ void agent_queue_request(agent_arg_t *agent_arg_ptr)
 		slurm_mutex_unlock(&defer_mutex);
 	} else {
 		slurm_mutex_lock(&retry_mutex);
-		if (retry_list == NULL)
-			retry_list = list_create(_list_delete_retry);
-		list_append(retry_list, (void *)queued_req_ptr);
+		if (_coalesce_request(agent_arg_ptr)) {
+			xfree(queued_req_ptr);
+		} else {
+			if (retry_list == NULL)
+				retry_list = list_create(_list_delete_retry);
+			list_append(retry_list, (void *)queued_req_ptr);
+		}
 		slurm_mutex_unlock(&retry_mutex);
 	}
 	/* now process the request in a separate pthread
@@ -79,6 +79,7 @@ static void *       _background_rpc_mgr(void *no_data);
 static void *       _background_signal_hand(void *no_data);
 static void         _backup_reconfig(void);
 static int          _shutdown_primary_controller(int wait_time);
+static void         _standby_prefetch(void);
 static void *       _trigger_slurmctld_event(void *arg);
 
 typedef struct ping_struct {
@@ -178,9 +179,10 @@ void run_backup(void)
 			continue;
 
 		last_ping = time(NULL);
-		if (ping_controllers(false) == SLURM_SUCCESS)
+		if (ping_controllers(false) == SLURM_SUCCESS) {
 			last_controller_response = time(NULL);
-		else if (takeover) {
+			_standby_prefetch();
+		} else if (takeover) {
 			/*
 			 * in takeover mode, take control as soon as
 			 * primary no longer respond
@@ -313,6 +315,9 @@ void run_backup(void)
 	 */
 	agent_init();
 
+	/* Warm the page cache for the state recovered below */
+	prefetch_state_files();
+
 	/* Calls assoc_mgr_init() */
 	ctld_assoc_mgr_init();
 
@@ -346,6 +351,29 @@ void run_backup(void)
 	unlock_slurmctld(config_write_lock);
 }
 
+/*
+ * With SlurmctldParameters=standby_state_prefetch, re-read the state files
+ * each time the primary saves new job state, so they are already in this
+ * host's page cache when it has to take over.
+ */
+static void _standby_prefetch(void)
+{
+	static time_t last_mtime = 0;
+	struct stat stat_buf;
+	char *file_name;
+
+	if (!xstrcasestr(slurm_conf.slurmctld_params, "standby_state_prefetch"))
+		return;
+
+	file_name = xstrdup_printf("%s/job_state",
+				   slurm_conf.state_save_location);
+	if (!stat(file_name, &stat_buf) && (stat_buf.st_mtime != last_mtime)) {
+		last_mtime = stat_buf.st_mtime;
+		prefetch_state_files();
+	}
+	xfree(file_name);
+}
+
 /*
  * _background_signal_hand - Process daemon-wide signals for the
  *	backup controller
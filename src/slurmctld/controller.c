@@ -68,11 +68,13 @@
 #include "src/common/log.h"
 #include "src/common/macros.h"
 #include "src/common/pack.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/port_mgr.h"
 #include "src/common/proc_args.h"
 #include "src/common/read_config.h"
 #include "src/common/ref.h"
 #include "src/common/run_command.h"
+#include "src/common/sched_trace.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_socket.h"
 #include "src/common/slurm_rlimits_info.h"
@@ -119,6 +121,7 @@
 #include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/licenses.h"
 #include "src/slurmctld/locks.h"
+#include "src/slurmctld/numa_placement.h"
 #include "src/slurmctld/ping_nodes.h"
 #include "src/slurmctld/power_save.h"
 #include "src/slurmctld/proc_req.h"
@@ -168,6 +171,18 @@ decl_static_data(usage_txt);
  *    controller use).
 \**************************************************************************/
 
+#ifdef HAVE_JEMALLOC
+/*
+ * Read by jemalloc before main(). Purge unused pages from a background thread
+ * rather than inline in the RPC and scheduler threads, and hold on to dirty
+ * pages long enough to absorb the allocation bursts of a scheduling cycle.
+ * MALLOC_CONF in the environment still overrides these.
+ */
+const char *malloc_conf = "background_thread:true,"
+			  "dirty_decay_ms:30000,"
+			  "muzzy_decay_ms:30000";
+#endif
+
 /* Log to stderr and syslog until becomes a daemon */
 log_options_t log_opts = LOG_OPTS_INITIALIZER;
 /* Scheduler Log options */
@@ -237,9 +252,11 @@ static pthread_cond_t reconfig_cond = PTHREAD_COND_INITIALIZER;
 static int reconfig_threads = 0;
 static int reconfig_rc = SLURM_SUCCESS;
 static bool reconfig = false;
+static bool reconfig_full = false;
 static pthread_mutex_t shutdown_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t shutdown_cond = PTHREAD_COND_INITIALIZER;
 static bool under_systemd = false;
+static bool log_async_ready = false;
 
 /*
  * Static list of signals to block in this process
@@ -288,6 +305,7 @@ static void         _test_thread_limit(void);
 static int _try_to_reconfig(void);
 static void         _update_assoc(slurmdb_assoc_rec_t *rec);
 static void         _update_diag_job_state_counts(void);
+static void _update_log_async(void);
 static void         _update_cluster_tres(void);
 static void         _update_nice(void);
 static void _update_pidfile(void);
@@ -327,6 +345,13 @@ int main(int argc, char **argv)
 	main_argc = argc;
 	main_argv = argv;
 
+	/*
+	 * Recycle the node and core bitmaps and the list nodes of scheduling
+	 * temporaries
+	 */
+	bit_cache_init();
+	list_cache_init();
+
 	if (getenv("SLURMCTLD_RECONF"))
 		original = false;
 
@@ -353,6 +378,12 @@ int main(int argc, char **argv)
 		if (!(conf_file = getenv("SLURM_CONF")))
 			conf_file = default_slurm_config_file;
 	slurm_conf_init(conf_file);
+	if (xstrcasestr(slurm_conf.slurmctld_params, "xmalloc_stats"))
+		xmalloc_stats_enable();
+	if (xstrcasestr(slurm_conf.slurmctld_params, "plugin_stats"))
+		plugin_stats_enable();
+	/* Before any thread is created so every thread inherits it */
+	numa_placement_init();
 
 	lock_slurmctld(config_write_lock);
 	update_logging();
@@ -396,6 +427,10 @@ int main(int argc, char **argv)
 		sched_debug("slurmctld starting");
 	}
 
+	/* The log writer thread does not survive xdaemon() */
+	log_async_ready = true;
+	_update_log_async();
+
 	/*
 	 * This must happen before we spawn any threads
 	* which are not designed to handle them
@@ -581,6 +616,8 @@ int main(int argc, char **argv)
 				fatal("failed to initialize accounting_storage plugin");
 			(void) _shutdown_backup_controller();
 			trigger_primary_ctld_res_ctrl();
+			if (!reconfiguring)
+				prefetch_state_files();
 			ctld_assoc_mgr_init();
 			/*
 			 * read_slurm_conf() will load the burst buffer state,
@@ -855,6 +892,7 @@ int main(int argc, char **argv)
 	/* Purge our local data structures */
 	configless_clear();
 	job_fini();
+	sched_trace_fini();
 	part_fini();	/* part_fini() must precede node_fini() */
 	node_fini();
 	mpi_fini();
@@ -1180,6 +1218,17 @@ extern void reconfigure_slurm(slurm_msg_t *msg)
 {
 	xassert(msg);
 
+	if (!reconfig_in_place()) {
+		slurm_send_rc_msg(msg, SLURM_SUCCESS);
+		_post_reconfig();
+		return;
+	}
+
+	/* In-place was already ruled out, have SIGHUP go straight to exec */
+	slurm_mutex_lock(&reconfig_mutex);
+	reconfig_full = true;
+	slurm_mutex_unlock(&reconfig_mutex);
+
 	if (slurmctld_config.thread_id_sig)
 		pthread_kill(slurmctld_config.thread_id_sig, SIGHUP);
 
@@ -1227,6 +1276,7 @@ static void *_slurmctld_signal_hand(void *no_data)
 	int i, rc;
 	int sig_array[] = {SIGINT, SIGTERM, SIGHUP, SIGABRT, SIGUSR2, 0};
 	sigset_t set;
+	bool full;
 	slurmctld_lock_t conf_write_lock = { .conf = WRITE_LOCK };
 
 #if HAVE_SYS_PRCTL_H
@@ -1257,6 +1307,14 @@ static void *_slurmctld_signal_hand(void *no_data)
 			break;
 		case SIGHUP:	/* kill -1 */
 			info("Reconfigure signal (SIGHUP) received");
+			slurm_mutex_lock(&reconfig_mutex);
+			full = reconfig_full;
+			reconfig_full = false;
+			slurm_mutex_unlock(&reconfig_mutex);
+			if (!full && !reconfig_in_place()) {
+				_post_reconfig();
+				break;
+			}
 			reconfig = true;
 			slurmctld_config.shutdown_time = time(NULL);
 			slurmctld_shutdown();
@@ -3046,6 +3104,13 @@ void update_log_levels(int req_slurmctld_debug, int req_syslog_debug)
 	      log_num2string(log_opts.syslog_level));
 }
 
+static void _update_log_async(void)
+{
+	if (log_async_ready)
+		log_set_async(xstrcasestr(slurm_conf.slurmctld_params,
+					  "log_async"));
+}
+
 /*
  * Reset slurmctld logging based upon configuration parameters uses common
  * slurm_conf data structure
@@ -3076,6 +3141,7 @@ void update_logging(void)
 
 	update_log_levels(slurm_conf.slurmctld_debug,
 			  slurm_conf.slurmctld_syslog_debug);
+	_update_log_async();
 
 	debug("Log file re-opened");
 
@@ -3617,6 +3683,7 @@ static void *_purge_files_thread(void *no_data)
 			delete_job_desc_files(*job_id);
 			xfree(job_id);
 		}
+		purge_batch_files();
 	}
 	slurm_mutex_unlock(&purge_thread_lock);
 	return NULL;
@@ -155,6 +155,7 @@ static pthread_mutex_t data_mutex = PTHREAD_MUTEX_INITIALIZER;
 static uint32_t num_sorted_part = 0;
 
 /* function declarations */
+static int _sort_partitions(void *part1, void *part2);
 static void *_timeslicer_thread(void *arg);
 
 static char *_print_flag(int flag)
@@ -303,6 +304,11 @@ static void _build_parts(void)
 		list_append(gs_part_list, gs_part_ptr);
 	}
 	list_iterator_destroy(part_iterator);
+
+	/* Partition priorities only change here, so sort them just once.
+	 * This way the shadows of any high-priority jobs are appropriately
+	 * adjusted before the lower priority partitions are updated */
+	list_sort(gs_part_list, _sort_partitions);
 }
 
 /* Find the gs_part entity with the given name */
@@ -784,27 +790,34 @@ static void _update_active_row(struct gs_part *p_ptr, int add_new_jobs)
 	}
 }
 
-/* rebuild all active rows without reordering jobs:
+/* rebuild the active rows of all partitions with the given priority or
+ * lower, without reordering jobs:
  * - attempt to preserve running jobs
  * - suspend any jobs that have been "shadowed" (preempted)
  * - resume any "filler" jobs that can be found
+ * A job starting or ending in a partition only casts or clears shadows in
+ * lower priority partitions, so higher priority rows are left alone.
+ * gs_part_list is sorted by descending priority.
  */
-static void _update_all_active_rows(void)
+static void _update_active_rows(uint16_t priority)
 {
 	list_itr_t *part_iterator;
  	struct gs_part *p_ptr;
 
-	/* Sort the partitions. This way the shadows of any high-priority
-	 * jobs are appropriately adjusted before the lower priority
-	 * partitions are updated */
-	list_sort(gs_part_list, _sort_partitions);
-
 	part_iterator = list_iterator_create(gs_part_list);
-	while ((p_ptr = list_next(part_iterator)))
+	while ((p_ptr = list_next(part_iterator))) {
+		if (p_ptr->priority > priority)
+			continue;
 		_update_active_row(p_ptr, 1);
+	}
 	list_iterator_destroy(part_iterator);
 }
 
+static void _update_all_active_rows(void)
+{
+	_update_active_rows(INFINITE16);
+}
+
 /* remove the given job from the given partition
  * IN job_id - job to remove
  * IN p_ptr  - GS partition structure
@@ -1132,7 +1145,7 @@ extern void gs_job_start(job_record_t *job_ptr)
 		job_sig_state = _add_job_to_part(p_ptr, job_ptr);
 		/* if this job is running then check for preemption */
 		if (job_sig_state == GS_RESUME)
-			_update_all_active_rows();
+			_update_active_rows(p_ptr->priority);
 	}
 	slurm_mutex_unlock(&data_mutex);
 
@@ -1203,8 +1216,8 @@ extern void gs_job_fini(job_record_t *job_ptr)
 	/* remove job from the partition */
 	_remove_job_from_part(job_ptr->job_id, p_ptr, true);
 	/* this job may have preempted other jobs, so
-	 * check by updating all active rows */
-	_update_all_active_rows();
+	 * check by updating the rows it may have shadowed */
+	_update_active_rows(p_ptr->priority);
 	slurm_mutex_unlock(&data_mutex);
 	log_flag(GANG, "gang: leaving gs_job_fini");
 }
@@ -1371,26 +1384,25 @@ static void _build_active_row(struct gs_part *p_ptr)
  */
 static void _cycle_job_list(struct gs_part *p_ptr)
 {
-	int i, j;
-	struct gs_job *j_ptr;
+	int i, j, k;
+	struct gs_job *j_ptr, **active_list;
 	uint16_t preempt_mode;
 
 	log_flag(GANG, "gang: entering %s", __func__);
-	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE */
-	for (i = 0; i < p_ptr->num_jobs; i++) {
-		while (p_ptr->job_list[i]->row_state == GS_ACTIVE) {
-			/* move this job to the back row and "deactivate" it */
-			j_ptr = p_ptr->job_list[i];
-			j_ptr->row_state = GS_NO_ACTIVE;
-			for (j = i; j+1 < p_ptr->num_jobs; j++) {
-				p_ptr->job_list[j] = p_ptr->job_list[j+1];
-			}
-			p_ptr->job_list[j] = j_ptr;
-		}
-		if (p_ptr->job_list[i]->row_state == GS_FILLER)
-			p_ptr->job_list[i]->row_state = GS_NO_ACTIVE;
-
+	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE:
+	 * move the active jobs to the back row, keeping their order, in one
+	 * pass rather than shifting the list down for each one */
+	active_list = xcalloc(p_ptr->num_jobs, sizeof(struct gs_job *));
+	for (i = 0, j = 0, k = 0; i < p_ptr->num_jobs; i++) {
+		j_ptr = p_ptr->job_list[i];
+		if (j_ptr->row_state == GS_ACTIVE)
+			active_list[k++] = j_ptr;
+		else
+			p_ptr->job_list[j++] = j_ptr;
+		j_ptr->row_state = GS_NO_ACTIVE;
 	}
+	memcpy(&p_ptr->job_list[j], active_list, k * sizeof(struct gs_job *));
+	xfree(active_list);
 	log_flag(GANG, "gang: %s reordered job list:", __func__);
 	/* Rebuild the active row. */
 	_build_active_row(p_ptr);
@@ -1463,7 +1475,6 @@ static void *_timeslicer_thread(void *arg)
 
 		lock_slurmctld(job_write_lock);
 		slurm_mutex_lock(&data_mutex);
-		list_sort(gs_part_list, _sort_partitions);
 
 		/* scan each partition... */
 		log_flag(GANG, "gang: %s: scanning partitions", __func__);
@@ -134,6 +134,20 @@ static void _remove_duplicate_uids(uid_t **u, int *u_cnt)
 	*u_cnt = j;
 }
 
+extern void sort_uid_list(uid_t *uids, int uid_cnt)
+{
+	if (uids && (uid_cnt > 1))
+		qsort(uids, uid_cnt, sizeof(uid_t), _uid_cmp);
+}
+
+extern bool uid_in_list(uid_t uid, uid_t *uids, int uid_cnt)
+{
+	if (!uids || (uid_cnt <= 0))
+		return false;
+
+	return bsearch(&uid, uids, uid_cnt, sizeof(uid_t), _uid_cmp);
+}
+
 extern uid_t *get_groups_members(char *group_names, int *user_cnt)
 {
 	uid_t *group_uids = NULL;
@@ -55,6 +55,19 @@ extern void clear_group_cache(void);
  */
 extern uid_t *get_groups_members(char *group_names, int *user_cnt);
 
+/* sort_uid_list - sort a uid array in increasing order for uid_in_list() */
+extern void sort_uid_list(uid_t *uids, int uid_cnt);
+
+/*
+ * uid_in_list - binary search for a uid
+ * IN uid - user to look for
+ * IN uids - array sorted in increasing order, as returned by
+ *	get_groups_members() or sort_uid_list()
+ * IN uid_cnt - size of array
+ * RET true if uid is in the array
+ */
+extern bool uid_in_list(uid_t uid, uid_t *uids, int uid_cnt);
+
 /* get_group_tlm - return the time of last modification for the GROUP_FILE */
 extern time_t get_group_tlm(void);
 
@@ -75,6 +75,7 @@
 #include "src/common/tres_bind.h"
 #include "src/common/tres_frequency.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/accounting_storage.h"
@@ -128,6 +129,15 @@
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define JOB_STATE_VERSION     "PROTOCOL_VERSION"
 
+/*
+ * Directory in StateSaveLocation holding the content addressed batch scripts
+ * and environments hard linked into job directories with
+ * SlurmctldParameters=dedup_batch_files.
+ */
+#define BATCH_FILES_DIR "batch_files"
+/* Minimum seconds between sweeps for unreferenced batch files */
+#define BATCH_FILES_SWEEP_INTERVAL 60
+
 typedef enum {
 	JOB_HASH_JOB,
 	JOB_HASH_ARRAY_JOB,
@@ -144,9 +154,14 @@ typedef struct {
 
 typedef struct {
 	buf_t *buffer;
+	bool delta;		/* only pack jobs changed since last_update */
 	uint32_t  filter_uid;
 	bool has_qos_lock;
+	uint32_t *job_ids;	/* with delta, IDs of all visible jobs */
+	uint32_t  job_id_cnt;
 	uint32_t  jobs_packed;
+	time_t    last_update;
+	time_t    pack_time;
 	uint16_t  protocol_version;
 	uint16_t  show_flags;
 	uid_t     uid;
@@ -220,8 +235,38 @@ static time_t   last_file_write_time = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
 static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
+static bitstr_t *purge_node_bitmap = NULL; /* see purge_missing_jobs_batch */
+/* job_id of every job job_time_limit() must test, see _time_limit_tracked() */
+static xhash_t  *time_limit_index = NULL;
 static bool     validate_cfgd_licenses = true;
 
+/* Shared responses to REQUEST_JOB_INFO, see job_info_snapshot_get() */
+#define JOB_INFO_SNAPSHOT_CNT 8
+typedef struct {
+	buf_t *buffer;
+	time_t pack_time;
+	uint16_t protocol_version;
+	bool public;		/* packed for unprivileged users */
+	uint16_t show_flags;
+} job_info_snapshot_t;
+static int job_info_max_age = 0;
+static job_info_snapshot_t job_info_snapshot[JOB_INFO_SNAPSHOT_CNT];
+static pthread_mutex_t job_info_snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Job state save shards, see SlurmctldParameters=job_state_shards */
+#define JOB_STATE_SHARD_MAX 1024
+typedef struct {
+	uint64_t hash;		/* hash of the last shard saved */
+	uint32_t size;		/* size of the last shard saved */
+} job_state_shard_t;
+typedef struct {
+	buf_t **buffers;
+	int shard_cnt;
+} foreach_dump_job_shard_t;
+static int job_state_shards = 0;	/* configured shard count */
+static int job_state_shards_saved = 0;	/* shard count in job_state file */
+static job_state_shard_t *job_state_shard = NULL;
+
 /* Local functions */
 static void _signal_pending_job_array_tasks(job_record_t *job_ptr, bitstr_t
 					    **array_bitmap, uint16_t signal,
@@ -807,6 +852,169 @@ static slurmdb_qos_rec_t *_determine_and_validate_qos(
 	return qos_ptr;
 }
 
+/*
+ * Write buffer to the state save file reg_file, keeping the previous version
+ * of the file as reg_file.old. Call with lock_state_files() held.
+ * RET 0 or error code
+ */
+static int _write_job_state_file(char *reg_file, buf_t *buffer)
+{
+	int error_code = SLURM_SUCCESS, log_fd;
+	char *old_file = xstrdup_printf("%s.old", reg_file);
+	char *new_file = xstrdup_printf("%s.new", reg_file);
+
+	log_fd = open(new_file, O_CREAT|O_WRONLY|O_TRUNC|O_CLOEXEC, 0600);
+	if (log_fd < 0) {
+		error("Can't save state, create file %s error %m",
+		      new_file);
+		error_code = errno;
+	} else {
+		int pos = 0, amount, rc;
+		char *data;
+		uint32_t nwrite = get_buf_offset(buffer);
+
+		data = (char *)get_buf_data(buffer);
+		while (nwrite > 0) {
+			amount = write(log_fd, &data[pos], nwrite);
+			if ((amount < 0) && (errno != EINTR)) {
+				error("Error writing file %s, %m", new_file);
+				error_code = errno;
+				break;
+			}
+			nwrite -= amount;
+			pos    += amount;
+		}
+
+		rc = fsync_and_close(log_fd, "job");
+		if (rc && !error_code)
+			error_code = rc;
+	}
+	if (error_code)
+		(void) unlink(new_file);
+	else {			/* file shuffle */
+		(void) unlink(old_file);
+		if (link(reg_file, old_file))
+			debug4("unable to create link for %s -> %s: %m",
+			       reg_file, old_file);
+		(void) unlink(reg_file);
+		if (link(new_file, reg_file))
+			debug4("unable to create link for %s -> %s: %m",
+			       new_file, reg_file);
+		(void) unlink(new_file);
+	}
+	xfree(old_file);
+	xfree(new_file);
+
+	return error_code;
+}
+
+static int _foreach_dump_job_shard(void *object, void *arg)
+{
+	job_record_t *job_ptr = object;
+	foreach_dump_job_shard_t *args = arg;
+
+	return job_mgr_dump_job_state(
+		job_ptr, args->buffers[job_ptr->job_id % args->shard_cnt]);
+}
+
+/*
+ * Shard file names include the shard count, so changing the count never
+ * overwrites shards still referenced by the job_state file.
+ */
+static char *_job_state_shard_file(int shard, int shard_cnt)
+{
+	return xstrdup_printf("%s/job_state.shard.%d.%d",
+			      slurm_conf.state_save_location, shard, shard_cnt);
+}
+
+static buf_t *_init_job_state_shard(int shard, int shard_cnt)
+{
+	buf_t *buffer = init_buf(BUF_SIZE);
+
+	/* write header: version, shard index and count */
+	packstr(JOB_STATE_VERSION, buffer);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack32(shard, buffer);
+	pack32(shard_cnt, buffer);
+
+	return buffer;
+}
+
+static uint64_t _job_state_shard_hash(buf_t *buffer)
+{
+	unsigned char *data = (unsigned char *) get_buf_data(buffer);
+	uint32_t size = get_buf_offset(buffer);
+	uint64_t hash = 0xcbf29ce484222325; /* FNV-1a */
+
+	for (uint32_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+/*
+ * Write the job state shards whose contents changed since they were last
+ * saved. Call with lock_state_files() held.
+ * RET 0 or error code
+ */
+static int _write_job_state_shards(buf_t **buffers, int shard_cnt)
+{
+	int error_code = SLURM_SUCCESS, rc, write_cnt = 0;
+	char *shard_file;
+
+	if (shard_cnt != job_state_shards_saved) {
+		/* Shards are rebuilt, force all of them to be written */
+		xfree(job_state_shard);
+		job_state_shard = xcalloc(shard_cnt, sizeof(*job_state_shard));
+	} else if (!job_state_shard) {
+		job_state_shard = xcalloc(shard_cnt, sizeof(*job_state_shard));
+	}
+
+	for (int i = 0; i < shard_cnt; i++) {
+		uint64_t hash = _job_state_shard_hash(buffers[i]);
+		uint32_t size = get_buf_offset(buffers[i]);
+
+		if ((job_state_shard[i].hash == hash) &&
+		    (job_state_shard[i].size == size))
+			continue;
+
+		shard_file = _job_state_shard_file(i, shard_cnt);
+		rc = _write_job_state_file(shard_file, buffers[i]);
+		xfree(shard_file);
+		if (rc) {
+			/* Retry on the next save */
+			job_state_shard[i].hash = 0;
+			job_state_shard[i].size = 0;
+			if (!error_code)
+				error_code = rc;
+			continue;
+		}
+		job_state_shard[i].hash = hash;
+		job_state_shard[i].size = size;
+		write_cnt++;
+	}
+	debug3("%s: wrote %d of %d job state shards",
+	       __func__, write_cnt, shard_cnt);
+
+	return error_code;
+}
+
+/* Remove shard files no longer referenced by the job_state file */
+static void _purge_job_state_shards(int shard_cnt)
+{
+	char *shard_file;
+
+	for (int i = 0; i < shard_cnt; i++) {
+		shard_file = _job_state_shard_file(i, shard_cnt);
+		(void) unlink(shard_file);
+		xstrcat(shard_file, ".old");
+		(void) unlink(shard_file);
+		xfree(shard_file);
+	}
+}
+
 /*
  * dump_all_job_state - save the state of all jobs to file for checkpoint
  *	Changes here should be reflected in load_last_job_id() and
@@ -817,13 +1025,15 @@ int dump_all_job_state(void)
 {
 	/* Save high-water mark to avoid buffer growth with copies */
 	static int high_buffer_size = (1024 * 1024);
-	int error_code = SLURM_SUCCESS, log_fd;
-	char *old_file, *new_file, *reg_file;
+	int error_code = SLURM_SUCCESS;
+	char *reg_file;
 	struct stat stat_buf;
 	/* Locks: Read config and job */
 	slurmctld_lock_t job_read_lock =
 		{ READ_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
-	buf_t *buffer = init_buf(high_buffer_size);
+	int shard_cnt = job_state_shards;
+	buf_t *buffer = init_buf(shard_cnt ? BUF_SIZE : high_buffer_size);
+	buf_t **shard_buffers = NULL;
 	time_t now = time(NULL);
 	time_t last_state_file_time;
 	static time_t last_job_state_size_check = 0;
@@ -872,9 +1082,33 @@ int dump_all_job_state(void)
 
 	pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
 
-	jobs_start = get_buf_offset(buffer);
-	list_for_each_ro(job_list, job_mgr_dump_job_state, buffer);
-	jobs_end = get_buf_offset(buffer);
+	/*
+	 * write header: shard count
+	 * With shards the job records are written to job_state.shard.* files
+	 * instead of this one, and only shards that changed are written.
+	 */
+	pack32(shard_cnt, buffer);
+
+	if (shard_cnt) {
+		foreach_dump_job_shard_t args = {
+			.shard_cnt = shard_cnt,
+		};
+
+		shard_buffers = xcalloc(shard_cnt, sizeof(*shard_buffers));
+		for (int i = 0; i < shard_cnt; i++)
+			shard_buffers[i] = _init_job_state_shard(i, shard_cnt);
+		args.buffers = shard_buffers;
+
+		jobs_start = 0;
+		list_for_each_ro(job_list, _foreach_dump_job_shard, &args);
+		jobs_end = 0;
+		for (int i = 0; i < shard_cnt; i++)
+			jobs_end += get_buf_offset(shard_buffers[i]);
+	} else {
+		jobs_start = get_buf_offset(buffer);
+		list_for_each_ro(job_list, job_mgr_dump_job_state, buffer);
+		jobs_end = get_buf_offset(buffer);
+	}
 	if ((difftime(now, last_job_state_size_check) > 60) &&
 	    (jobs_count = list_count(job_list))) {
 		uint64_t ave_job_size = jobs_end - jobs_start;
@@ -887,22 +1121,20 @@ int dump_all_job_state(void)
 		 * errors.
 		 */
 		estimated_job_state_size /= jobs_count;
+		if (shard_cnt)
+			estimated_job_state_size /= shard_cnt;
 		estimated_job_state_size += jobs_start;
 		ave_job_size /= jobs_count;
 		if (estimated_job_state_size > MAX_BUF_SIZE)
 			error("Configured MaxJobCount may lead to job_state being larger then maximum buffer size and not saved, based on the average job state size(%.2f KiB) we can save state of %"PRIu64" jobs.",
 			      (float)ave_job_size / 1024,
 			      ((uint64_t)(MAX_BUF_SIZE - jobs_start)) /
-			      ave_job_size);
+			      ave_job_size * MAX(shard_cnt, 1));
 	}
 
 	/* write the buffer to file */
-	old_file = xstrdup(slurm_conf.state_save_location);
-	xstrcat(old_file, "/job_state.old");
 	reg_file = xstrdup(slurm_conf.state_save_location);
 	xstrcat(reg_file, "/job_state");
-	new_file = xstrdup(slurm_conf.state_save_location);
-	xstrcat(new_file, "/job_state.new");
 	unlock_slurmctld(job_read_lock);
 
 	if (stat(reg_file, &stat_buf) == 0) {
@@ -921,52 +1153,31 @@ int dump_all_job_state(void)
 	}
 
 	lock_state_files();
-	log_fd = open(new_file, O_CREAT|O_WRONLY|O_TRUNC|O_CLOEXEC, 0600);
-	if (log_fd < 0) {
-		error("Can't save state, create file %s error %m",
-		      new_file);
-		error_code = errno;
-	} else {
-		int pos = 0, amount, rc;
-		char *data;
-		uint32_t nwrite = get_buf_offset(buffer);
-
-		data = (char *)get_buf_data(buffer);
-		high_buffer_size = MAX(nwrite, high_buffer_size);
-		while (nwrite > 0) {
-			amount = write(log_fd, &data[pos], nwrite);
-			if ((amount < 0) && (errno != EINTR)) {
-				error("Error writing file %s, %m", new_file);
-				error_code = errno;
-				break;
-			}
-			nwrite -= amount;
-			pos    += amount;
-		}
-
-		rc = fsync_and_close(log_fd, "job");
-		if (rc && !error_code)
-			error_code = rc;
-	}
-	if (error_code)
-		(void) unlink(new_file);
-	else {			/* file shuffle */
-		(void) unlink(old_file);
-		if (link(reg_file, old_file))
-			debug4("unable to create link for %s -> %s: %m",
-			       reg_file, old_file);
-		(void) unlink(reg_file);
-		if (link(new_file, reg_file))
-			debug4("unable to create link for %s -> %s: %m",
-			       new_file, reg_file);
-		(void) unlink(new_file);
+	/*
+	 * Shards are written before the job_state file that references them,
+	 * so the job_state file never references shards that were not saved.
+	 */
+	if (shard_cnt)
+		error_code = _write_job_state_shards(shard_buffers, shard_cnt);
+	else
+		high_buffer_size = MAX(get_buf_offset(buffer),
+				       high_buffer_size);
+	if (!error_code)
+		error_code = _write_job_state_file(reg_file, buffer);
+	if (!error_code) {
+		if (job_state_shards_saved != shard_cnt)
+			_purge_job_state_shards(job_state_shards_saved);
+		if (!shard_cnt)
+			xfree(job_state_shard);
+		job_state_shards_saved = shard_cnt;
 		last_file_write_time = now;
 	}
-	xfree(old_file);
 	xfree(reg_file);
-	xfree(new_file);
 	unlock_state_files();
 
+	for (int i = 0; i < shard_cnt; i++)
+		FREE_NULL_BUFFER(shard_buffers[i]);
+	xfree(shard_buffers);
 	FREE_NULL_BUFFER(buffer);
 	END_TIMER2(__func__);
 	return error_code;
@@ -1156,6 +1367,75 @@ unpack_error:
 	return buf_time;
 }
 
+/*
+ * Load the job records from one job state shard, see dump_all_job_state()
+ * IN shard - index of the shard to load
+ * IN shard_cnt - shard count recorded in the job_state file
+ * IN/OUT job_cnt - incremented for every job recovered
+ * RET 0 or error code
+ */
+static int _load_job_state_shard(int shard, int shard_cnt, int *job_cnt)
+{
+	int error_code = SLURM_SUCCESS;
+	char *state_file = _job_state_shard_file(shard, shard_cnt);
+	buf_t *buffer;
+	char *ver_str = NULL;
+	uint16_t protocol_version = NO_VAL16;
+	uint32_t saved_shard = NO_VAL, saved_shard_cnt = NO_VAL;
+
+	lock_state_files();
+	if (!(buffer = create_mmap_buf(state_file))) {
+		error("Could not open job state file %s: %m", state_file);
+		error("NOTE: Trying backup state save file. Jobs may be lost!");
+		xstrcat(state_file, ".old");
+		buffer = create_mmap_buf(state_file);
+	}
+	unlock_state_files();
+	if (!buffer) {
+		error("No job state file (%s) to recover", state_file);
+		xfree(state_file);
+		return ENOENT;
+	}
+
+	safe_unpackstr(&ver_str, buffer);
+	if (ver_str && !xstrcmp(ver_str, JOB_STATE_VERSION))
+		safe_unpack16(&protocol_version, buffer);
+	xfree(ver_str);
+	if (protocol_version == NO_VAL16) {
+		error("Can not recover job state file %s, incompatible version",
+		      state_file);
+		error_code = EFAULT;
+		goto fini;
+	}
+
+	safe_unpack32(&saved_shard, buffer);
+	safe_unpack32(&saved_shard_cnt, buffer);
+	if ((saved_shard != shard) || (saved_shard_cnt != shard_cnt)) {
+		error("Job state file %s contains shard %u of %u",
+		      state_file, saved_shard, saved_shard_cnt);
+		error_code = EFAULT;
+		goto fini;
+	}
+
+	while (remaining_buf(buffer) > 0) {
+		error_code = job_mgr_load_job_state(buffer, protocol_version);
+		if (error_code != SLURM_SUCCESS)
+			goto fini;
+		(*job_cnt)++;
+	}
+
+fini:
+	xfree(state_file);
+	FREE_NULL_BUFFER(buffer);
+	return error_code;
+
+unpack_error:
+	error("Incomplete job state file %s", state_file);
+	xfree(ver_str);
+	error_code = SLURM_ERROR;
+	goto fini;
+}
+
 /*
  * load_all_job_state - load the job state from file, recover from last
  *	checkpoint. Execute this after loading the configuration file data.
@@ -1169,7 +1449,7 @@ extern int load_all_job_state(void)
 	char *state_file = NULL;
 	buf_t *buffer;
 	time_t buf_time;
-	uint32_t saved_job_id;
+	uint32_t saved_job_id, shard_cnt = 0;
 	char *ver_str = NULL;
 	uint16_t protocol_version = NO_VAL16;
 
@@ -1212,6 +1492,14 @@ extern int load_all_job_state(void)
 	if (!slurmctld_diag_stats.bf_when_last_cycle)
 		slurmctld_diag_stats.bf_when_last_cycle = buf_time;
 
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		safe_unpack32(&shard_cnt, buffer);
+		if (shard_cnt > JOB_STATE_SHARD_MAX)
+			goto unpack_error;
+		debug3("Job state shard count in job_state header is %u",
+		       shard_cnt);
+	}
+
 	/*
 	 * Previously we locked the tres read lock before this loop.  It turned
 	 * out that created a double lock when steps were being loaded during
@@ -1225,6 +1513,12 @@ extern int load_all_job_state(void)
 			goto unpack_error;
 		job_cnt++;
 	}
+	for (int i = 0; i < shard_cnt; i++) {
+		error_code = _load_job_state_shard(i, shard_cnt, &job_cnt);
+		if (error_code != SLURM_SUCCESS)
+			goto unpack_error;
+	}
+	job_state_shards_saved = shard_cnt;
 	debug3("Set job_id_sequence to %u", job_id_sequence);
 
 	FREE_NULL_BUFFER(buffer);
@@ -1413,7 +1707,15 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 	if (job_ptr->array_recs && (job_ptr->array_recs->task_cnt > 1))
 		job_count += (job_ptr->array_recs->task_cnt - 1);
 
-	xstrtolower(job_ptr->account);
+	if (job_ptr->account) {
+		/* Interned strings are shared, lower a private copy */
+		char *account = xstrdup(job_ptr->account);
+
+		xstrtolower(account);
+		job_record_str_release(&job_ptr->account);
+		job_ptr->account = job_record_str_intern(account);
+		xfree(account);
+	}
 	job_state_set(job_ptr, job_ptr->job_state);
 	job_ptr->time_last_active = now;
 
@@ -3281,6 +3583,55 @@ void init_job_conf(void)
 		purge_jobs_list = list_create(job_record_delete);
 }
 
+/*
+ * Move every record of the job hash tables into new tables with
+ * new_size entries. Records are moved from the old hash chains rather than
+ * rebuilt from job_list, so a table's membership is unchanged.
+ */
+static void _resize_job_hash(int new_size)
+{
+	job_record_t **old_job_hash = job_hash;
+	job_record_t **old_array_hash_j = job_array_hash_j;
+	job_record_t **old_array_hash_t = job_array_hash_t;
+	job_record_t *job_ptr, *next_ptr;
+	int inx, old_size = hash_table_size;
+
+	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
+
+	hash_table_size = new_size;
+	job_hash = xcalloc(hash_table_size, sizeof(job_record_t *));
+	job_array_hash_j = xcalloc(hash_table_size, sizeof(job_record_t *));
+	job_array_hash_t = xcalloc(hash_table_size, sizeof(job_record_t *));
+
+	for (int i = 0; i < old_size; i++) {
+		for (job_ptr = old_job_hash[i]; job_ptr; job_ptr = next_ptr) {
+			next_ptr = job_ptr->job_next;
+			_add_job_hash(job_ptr);
+		}
+
+		for (job_ptr = old_array_hash_j[i]; job_ptr;
+		     job_ptr = next_ptr) {
+			next_ptr = job_ptr->job_array_next_j;
+			inx = JOB_HASH_INX(job_ptr->array_job_id);
+			job_ptr->job_array_next_j = job_array_hash_j[inx];
+			job_array_hash_j[inx] = job_ptr;
+		}
+
+		for (job_ptr = old_array_hash_t[i]; job_ptr;
+		     job_ptr = next_ptr) {
+			next_ptr = job_ptr->job_array_next_t;
+			inx = JOB_ARRAY_HASH_INX(job_ptr->array_job_id,
+						 job_ptr->array_task_id);
+			job_ptr->job_array_next_t = job_array_hash_t[inx];
+			job_array_hash_t[inx] = job_ptr;
+		}
+	}
+
+	xfree(old_job_hash);
+	xfree(old_array_hash_j);
+	xfree(old_array_hash_t);
+}
+
 /*
  * rehash_jobs - Create or rebuild the job hash table.
  */
@@ -3300,12 +3651,13 @@ extern void rehash_jobs(void)
 				"enable_job_state_cache"))
 			setup_job_state_hash(hash_table_size);
 	} else if (hash_table_size < (slurm_conf.max_job_cnt / 2)) {
-		/* If the MaxJobCount grows by too much, the hash table will
-		 * be ineffective without rebuilding. We don't presently bother
-		 * to rebuild the hash table, but cut MaxJobCount back as
-		 * needed. */
-		error ("MaxJobCount reset too high, restart slurmctld");
-		slurm_conf.max_job_cnt = hash_table_size;
+		/*
+		 * If the MaxJobCount grows by too much, the hash table will
+		 * be ineffective without rebuilding.
+		 */
+		info("MaxJobCount increased to %u, resizing job hash tables from %d entries",
+		     slurm_conf.max_job_cnt, hash_table_size);
+		_resize_job_hash(slurm_conf.max_job_cnt);
 	}
 }
 
@@ -3355,7 +3707,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	slurm_copy_priority_factors(job_ptr_pend->prio_factors,
 				    job_ptr->prio_factors);
 
-	job_ptr_pend->account = xstrdup(job_ptr->account);
+	job_ptr_pend->account = job_record_str_intern(job_ptr->account);
 	job_ptr_pend->admin_comment = xstrdup(job_ptr->admin_comment);
 	job_ptr_pend->alias_list = NULL;
 	job_ptr_pend->alloc_node = xstrdup(job_ptr->alloc_node);
@@ -3507,8 +3859,8 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	job_ptr_pend->tres_per_socket = xstrdup(job_ptr->tres_per_socket);
 	job_ptr_pend->tres_per_task = xstrdup(job_ptr->tres_per_task);
 
-	job_ptr_pend->user_name = xstrdup(job_ptr->user_name);
-	job_ptr_pend->wckey = xstrdup(job_ptr->wckey);
+	job_ptr_pend->user_name = job_record_str_intern(job_ptr->user_name);
+	job_ptr_pend->wckey = job_record_str_intern(job_ptr->wckey);
 	job_ptr_pend->deadline = job_ptr->deadline;
 
 	job_details = job_ptr->details;
@@ -3520,15 +3872,11 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	 * for a period before preempting more jobs.
 	 */
 	details_new->preempt_start_time = 0;
+	/* The new record is not in the dependency index yet */
+	details_new->depend_settled = false;
 
 	details_new->acctg_freq = xstrdup(job_details->acctg_freq);
-	if (job_details->argc) {
-		details_new->argv =
-			xcalloc((job_details->argc + 1), sizeof(char *));
-		for (i = 0; i < job_details->argc; i++) {
-			details_new->argv[i] = xstrdup(job_details->argv[i]);
-		}
-	}
+	job_details_share_args(details_new, job_details);
 	details_new->cpu_bind = xstrdup(job_details->cpu_bind);
 	details_new->cpu_bind_type = job_details->cpu_bind_type;
 	details_new->cpu_freq_min = job_details->cpu_freq_min;
@@ -3537,14 +3885,6 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	details_new->depend_list = depended_list_copy(job_details->depend_list);
 	details_new->dependency = xstrdup(job_details->dependency);
 	details_new->orig_dependency = xstrdup(job_details->orig_dependency);
-	if (job_details->env_cnt) {
-		details_new->env_sup =
-			xcalloc((job_details->env_cnt + 1), sizeof(char *));
-		for (i = 0; i < job_details->env_cnt; i++) {
-			details_new->env_sup[i] =
-				xstrdup(job_details->env_sup[i]);
-		}
-	}
 	if (job_details->exc_node_bitmap) {
 		details_new->exc_node_bitmap =
 			bit_copy(job_details->exc_node_bitmap);
@@ -3578,7 +3918,6 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	details_new->std_err = xstrdup(job_details->std_err);
 	details_new->std_in = xstrdup(job_details->std_in);
 	details_new->std_out = xstrdup(job_details->std_out);
-	details_new->submit_line = xstrdup(job_details->submit_line);
 	details_new->work_dir = xstrdup(job_details->work_dir);
 	details_new->x11_magic_cookie = xstrdup(job_details->x11_magic_cookie);
 	details_new->env_hash = xstrdup(job_details->env_hash);
@@ -6913,14 +7252,38 @@ static void _enable_stepmgr(job_record_t *job_ptr, job_desc_msg_t *job_desc)
 #ifndef HAVE_FRONT_END
 	static bool first_time = true;
 	static bool stepmgr_enabled = false;
+	static uint32_t stepmgr_min_nodes = 0;
+	bool large_job = false;
 
 	if (first_time) {
+		char *tmp_ptr;
+
 		first_time = false;
 		stepmgr_enabled = xstrstr(slurm_conf.slurmctld_params,
 					  "enable_stepmgr");
+		if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+					   "stepmgr_min_nodes="))) {
+			long param = strtol(tmp_ptr + 18, NULL, 10);
+
+			if ((param >= 1) && (param < INFINITE))
+				stepmgr_min_nodes = param;
+			else
+				error("Invalid SlurmctldParameters stepmgr_min_nodes: %s",
+				      tmp_ptr);
+		}
 	}
 
-	if ((stepmgr_enabled || (job_desc->bitflags & STEPMGR_ENABLED)) &&
+	/*
+	 * Large jobs tend to create the most steps, hand their step
+	 * management to the extern slurmstepd automatically.
+	 */
+	if (stepmgr_min_nodes && job_ptr->details &&
+	    (job_ptr->details->min_nodes != NO_VAL) &&
+	    (job_ptr->details->min_nodes >= stepmgr_min_nodes))
+		large_job = true;
+
+	if ((stepmgr_enabled || large_job ||
+	     (job_desc->bitflags & STEPMGR_ENABLED)) &&
 	    (job_desc->het_job_offset == NO_VAL) &&
 	    (job_ptr->start_protocol_ver >= SLURM_24_05_PROTOCOL_VERSION)) {
 		job_ptr->bit_flags |= STEPMGR_ENABLED;
@@ -7630,23 +7993,14 @@ static void _figure_out_num_tasks(
 	}
 }
 
-/* Perform some size checks on strings we store to prevent
- * malicious user filling slurmctld's memory
- * IN job_desc   - user job submit request
- * IN submit_uid - UID making job submit request
- * OUT err_msg   - custom error message to return
- * RET 0 or error code */
-extern int validate_job_create_req(job_desc_msg_t * job_desc, uid_t submit_uid,
-				   char **err_msg)
+/*
+ * Check user permission for negative 'nice' and non-0 priority values
+ * (restricted to root, SlurmUser, or SLURMDB_ADMIN_OPERATOR) _before_
+ * running the job_submit plugin.
+ */
+static int _validate_job_create_perms(job_desc_msg_t *job_desc,
+				      uid_t submit_uid, char **err_msg)
 {
-	job_record_t *job_ptr = NULL;
-	int rc;
-
-	/*
-	 * Check user permission for negative 'nice' and non-0 priority values
-	 * (restricted to root, SlurmUser, or SLURMDB_ADMIN_OPERATOR) _before_
-	 * running the job_submit plugin.
-	 */
 	if (!validate_operator(submit_uid)) {
 		if (job_desc->priority != 0)
 			job_desc->priority = NO_VAL;
@@ -7665,7 +8019,41 @@ extern int validate_job_create_req(job_desc_msg_t * job_desc, uid_t submit_uid,
 		}
 	}
 
-	rc = job_submit_g_submit(job_desc, submit_uid, err_msg);
+	return SLURM_SUCCESS;
+}
+
+extern int validate_job_create_req_unlocked(job_desc_msg_t *job_desc,
+					    uid_t submit_uid, char **err_msg)
+{
+	int rc;
+
+	if ((rc = _validate_job_create_perms(job_desc, submit_uid, err_msg)))
+		return rc;
+
+	return job_submit_g_submit_unlocked(job_desc, submit_uid, err_msg);
+}
+
+/* Perform some size checks on strings we store to prevent
+ * malicious user filling slurmctld's memory
+ * IN job_desc   - user job submit request
+ * IN submit_uid - UID making job submit request
+ * OUT err_msg   - custom error message to return
+ * RET 0 or error code */
+extern int validate_job_create_req(job_desc_msg_t * job_desc, uid_t submit_uid,
+				   char **err_msg)
+{
+	job_record_t *job_ptr = NULL;
+	int rc;
+
+	/*
+	 * Already checked by validate_job_create_req_unlocked(), and checking
+	 * again would reset a priority set by the job_submit plugin.
+	 */
+	if (!job_desc->job_submit_done &&
+	    (rc = _validate_job_create_perms(job_desc, submit_uid, err_msg)))
+		return rc;
+
+	rc = job_submit_g_submit(job_desc, submit_uid, err_msg);
 	if (rc != SLURM_SUCCESS)
 		return rc;
 
@@ -7771,6 +8159,184 @@ fini:
 	return rc;
 }
 
+static bool _dedup_batch_files(void)
+{
+	static time_t conf_update = 0;
+	static bool dedup = false;
+
+	if (conf_update != slurm_conf.last_update) {
+		dedup = xstrcasestr(slurm_conf.slurmctld_params,
+				    "dedup_batch_files");
+		conf_update = slurm_conf.last_update;
+	}
+
+	return dedup;
+}
+
+static int _write_whole_file(const char *file_name, const char *data,
+			     int len, mode_t mode)
+{
+	int fd, amount, pos = 0;
+
+	if ((fd = open(file_name, (O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC),
+		       mode)) < 0) {
+		error("Error creating file %s, %m", file_name);
+		return SLURM_ERROR;
+	}
+
+	while (len > 0) {
+		amount = write(fd, &data[pos], len);
+		if (amount < 0) {
+			if (errno == EINTR)
+				continue;
+			error("Error writing file %s, %m", file_name);
+			close(fd);
+			(void) unlink(file_name);
+			return SLURM_ERROR;
+		}
+		len -= amount;
+		pos += amount;
+	}
+
+	close(fd);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Hard link file_name to the copy of data kept in BATCH_FILES_DIR, named after
+ * its K12 hash, writing that copy first if no other job has the same content.
+ * Identical scripts and environments are then stored (and cached by the page
+ * cache) only once. The copies are removed by purge_batch_files() once no
+ * job directory links to them anymore.
+ * IN file_name - job file to create
+ * IN type - "script" or "environment"
+ * IN data - exact contents of the file
+ * IN len - length of data
+ * IN mode - permissions used if the shared copy is created
+ * RET SLURM_SUCCESS or SLURM_ERROR if the caller must write its own file
+ */
+static int _link_batch_file(const char *file_name, const char *type,
+			    const char *data, int len, mode_t mode)
+{
+	slurm_hash_t hash = { .type = HASH_PLUGIN_K12 };
+	char *hex, *shared_name, *tmp_name = NULL;
+	int rc = SLURM_ERROR;
+
+	if (hash_g_compute((char *) data, len, NULL, 0, &hash) <= 0)
+		return SLURM_ERROR;
+
+	hex = xstring_bytes2hex(hash.hash, sizeof(hash.hash), NULL);
+	shared_name = xstrdup_printf("%s/%s/%s.%s",
+				     slurm_conf.state_save_location,
+				     BATCH_FILES_DIR, type, hex);
+	xfree(hex);
+
+	if (!link(shared_name, file_name)) {
+		rc = SLURM_SUCCESS;
+		goto fini;
+	}
+	if (errno != ENOENT) {
+		debug("%s: link(%s, %s): %m", __func__, shared_name, file_name);
+		goto fini;
+	}
+
+	tmp_name = xstrdup_printf("%s/%s", slurm_conf.state_save_location,
+				  BATCH_FILES_DIR);
+	(void) mkdir(tmp_name, 0700);
+	xfree(tmp_name);
+
+	tmp_name = xstrdup_printf("%s.new", shared_name);
+	if (_write_whole_file(tmp_name, data, len, mode))
+		goto fini;
+	if (rename(tmp_name, shared_name)) {
+		error("%s: rename(%s, %s): %m",
+		      __func__, tmp_name, shared_name);
+		(void) unlink(tmp_name);
+		goto fini;
+	}
+
+	/* May race with purge_batch_files(), the caller will write a copy */
+	if (!link(shared_name, file_name))
+		rc = SLURM_SUCCESS;
+	else
+		debug("%s: link(%s, %s): %m", __func__, shared_name, file_name);
+
+fini:
+	xfree(shared_name);
+	xfree(tmp_name);
+	return rc;
+}
+
+/* Same as _link_batch_file() with the format of _write_data_array_to_file() */
+static int _link_batch_env_file(const char *file_name, char **data,
+				uint32_t size)
+{
+	int rc, len = sizeof(uint32_t), pos;
+	char *buf;
+
+	for (int i = 0; data && (i < size); i++)
+		len += strlen(data[i]) + 1;
+
+	buf = xmalloc(len);
+	memcpy(buf, &size, sizeof(uint32_t));
+	pos = sizeof(uint32_t);
+	for (int i = 0; data && (i < size); i++) {
+		int str_len = strlen(data[i]) + 1;
+		memcpy(&buf[pos], data[i], str_len);
+		pos += str_len;
+	}
+
+	rc = _link_batch_file(file_name, "environment", buf, len, 0600);
+	xfree(buf);
+	return rc;
+}
+
+extern void purge_batch_files(void)
+{
+	static time_t last_sweep = 0;
+	time_t now = time(NULL);
+	char *dir_name, *file_name = NULL;
+	struct dirent *dir_ent;
+	struct stat stat_buf;
+	DIR *f_dir;
+
+	if ((now - last_sweep) < BATCH_FILES_SWEEP_INTERVAL)
+		return;
+	last_sweep = now;
+
+	dir_name = xstrdup_printf("%s/%s", slurm_conf.state_save_location,
+				  BATCH_FILES_DIR);
+	if (!(f_dir = opendir(dir_name))) {
+		if (errno != ENOENT)
+			error("opendir(%s): %m", dir_name);
+		xfree(dir_name);
+		return;
+	}
+
+	while ((dir_ent = readdir(f_dir))) {
+		if (dir_ent->d_name[0] == '.')
+			continue;
+		xstrfmtcat(file_name, "%s/%s", dir_name, dir_ent->d_name);
+		if (stat(file_name, &stat_buf)) {
+			xfree(file_name);
+			continue;
+		}
+		if (xstrstr(dir_ent->d_name, ".new")) {
+			/* Leftover of an interrupted _link_batch_file() */
+			if ((now - stat_buf.st_mtime) >
+			    BATCH_FILES_SWEEP_INTERVAL)
+				(void) unlink(file_name);
+		} else if (stat_buf.st_nlink <= 1) {
+			/* Only the copy itself is left, no job needs it */
+			debug2("%s: removing %s", __func__, file_name);
+			(void) unlink(file_name);
+		}
+		xfree(file_name);
+	}
+	closedir(f_dir);
+	xfree(dir_name);
+}
+
 /* _copy_job_desc_to_file - copy the job script and environment from the RPC
  *	structure into a file */
 static int
@@ -7811,15 +8377,22 @@ _copy_job_desc_to_file(job_desc_msg_t * job_desc, uint32_t job_id)
 
 	/* Create environment file, and write data to it */
 	file_name = xstrdup_printf("%s/environment", dir_name);
-	error_code = _write_data_array_to_file(file_name,
-					       job_desc->environment,
-					       job_desc->env_size);
+	if (!_dedup_batch_files() ||
+	    _link_batch_env_file(file_name, job_desc->environment,
+				 job_desc->env_size))
+		error_code = _write_data_array_to_file(file_name,
+						       job_desc->environment,
+						       job_desc->env_size);
 	xfree(file_name);
 
 	if (error_code == 0) {
 		/* Create script file */
 		file_name = xstrdup_printf("%s/script", dir_name);
-		error_code = write_data_to_file(file_name, job_desc->script);
+		if (!_dedup_batch_files() || !job_desc->script ||
+		    _link_batch_file(file_name, "script", job_desc->script,
+				     (strlen(job_desc->script) + 1), 0700))
+			error_code = write_data_to_file(file_name,
+							job_desc->script);
 		xfree(file_name);
 	}
 
@@ -8279,7 +8852,7 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 	}
 
 	job_ptr->name = xstrdup(job_desc->name);
-	job_ptr->wckey = xstrdup(job_desc->wckey);
+	job_ptr->wckey = job_record_str_intern(job_desc->wckey);
 
 	/* Since this is only used in the slurmctld, copy it now. */
 	job_ptr->tres_req_cnt = job_desc->tres_req_cnt;
@@ -8304,7 +8877,7 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 		job_ptr->time_min = job_desc->time_min;
 	job_ptr->alloc_sid  = job_desc->alloc_sid;
 	job_ptr->alloc_node = xstrdup(job_desc->alloc_node);
-	job_ptr->account    = xstrdup(job_desc->account);
+	job_ptr->account    = job_record_str_intern(job_desc->account);
 	job_ptr->batch_features = xstrdup(job_desc->batch_features);
 	job_ptr->burst_buffer = xstrdup(job_desc->burst_buffer);
 	job_ptr->network    = xstrdup(job_desc->network);
@@ -8890,6 +9463,62 @@ static bool _het_job_configuring_test(job_record_t *job_ptr)
 	return result;
 }
 
+static bool _time_limit_tracked(uint32_t state)
+{
+	return ((state & JOB_CONFIGURING) ||
+		((state & JOB_STATE_BASE) == JOB_RUNNING) ||
+		((state & JOB_STATE_BASE) == JOB_SUSPENDED));
+}
+
+static void _time_limit_index_id(void *item, const char **key,
+				 uint32_t *key_len)
+{
+	*key = item;
+	*key_len = sizeof(uint32_t);
+}
+
+extern void time_limit_index_notify(job_record_t *job_ptr, uint32_t new_state)
+{
+	uint32_t *job_id;
+
+	if (!_time_limit_tracked(new_state) || !job_ptr->job_id ||
+	    (job_ptr->job_id == NO_VAL))
+		return;
+
+	if (!time_limit_index)
+		time_limit_index = xhash_init(_time_limit_index_id, xfree_ptr);
+	else if (xhash_get(time_limit_index, (char *) &job_ptr->job_id,
+			   sizeof(job_ptr->job_id)))
+		return;
+
+	job_id = xmalloc(sizeof(*job_id));
+	*job_id = job_ptr->job_id;
+	xhash_add(time_limit_index, job_id);
+}
+
+static void _time_limit_index_copy(void *item, void *arg)
+{
+	uint32_t **job_id_pptr = arg;
+
+	**job_id_pptr = *(uint32_t *) item;
+	(*job_id_pptr)++;
+}
+
+static int _reset_bad_constraints(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	time_t *now = arg;
+
+	if ((job_ptr->state_reason == FAIL_BAD_CONSTRAINTS) &&
+	    IS_JOB_PENDING(job_ptr) && (job_ptr->priority == 0)) {
+		job_ptr->state_reason = WAIT_NO_REASON;
+		set_job_prio(job_ptr);
+		last_job_update = *now;
+	}
+
+	return 0;
+}
+
 /*
  * job_time_limit - terminate jobs which have exceeded their time limit
  * global: job_list - pointer global job list
@@ -8897,8 +9526,8 @@ static bool _het_job_configuring_test(job_record_t *job_ptr)
  */
 void job_time_limit(void)
 {
-	list_itr_t *job_iterator;
 	job_record_t *job_ptr;
+	uint32_t *job_ids, *job_id_ptr, job_cnt;
 	time_t now = time(NULL);
 	time_t old = now - ((slurm_conf.inactive_limit * 4 / 3) +
 	                    slurm_conf.msg_timeout + 1);
@@ -8923,9 +9552,34 @@ void job_time_limit(void)
 		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
 	DEF_TIMERS;
 
-	job_iterator = list_iterator_create(job_list);
+	/*
+	 * Features have been changed on some node, make job eligiable
+	 * to run and test to see if it can run now
+	 */
+	if (node_features_updated) {
+		(void) list_for_each(job_list, _reset_bad_constraints, &now);
+		node_features_updated = false;
+	}
+
+	/*
+	 * Only visit the jobs which were running, suspended or configuring
+	 * when this pass started, rather than every pending and finished job.
+	 * Job IDs are copied out as the locks may be released below.
+	 */
+	if (!(job_cnt = xhash_count(time_limit_index)))
+		return;
+	job_id_ptr = job_ids = xcalloc(job_cnt, sizeof(*job_ids));
+	xhash_walk(time_limit_index, _time_limit_index_copy, &job_id_ptr);
+
 	START_TIMER;
-	while ((job_ptr = list_next(job_iterator))) {
+	for (int i = 0; i < job_cnt; i++) {
+		if (!(job_ptr = find_job_record(job_ids[i])) ||
+		    !_time_limit_tracked(job_ptr->job_state)) {
+			/* time_limit_index_notify() adds it back if needed */
+			xhash_delete(time_limit_index, (char *) &job_ids[i],
+				     sizeof(job_ids[i]));
+			continue;
+		}
 		xassert (job_ptr->magic == JOB_MAGIC);
 		job_test_count++;
 
@@ -8942,18 +9596,6 @@ void job_time_limit(void)
 				launch_job(job_ptr);
 		}
 
-		/*
-		 * Features have been changed on some node, make job eligiable
-		 * to run and test to see if it can run now
-		 */
-		if (node_features_updated &&
-		    (job_ptr->state_reason == FAIL_BAD_CONSTRAINTS) &&
-		    IS_JOB_PENDING(job_ptr) && (job_ptr->priority == 0)) {
-			job_ptr->state_reason = WAIT_NO_REASON;
-			set_job_prio(job_ptr);
-			last_job_update = now;
-		}
-
 		/* Don't enforce time limits for configuring hetjobs */
 		if (_het_job_configuring_test(job_ptr))
 			continue;
@@ -9081,15 +9723,14 @@ void job_time_limit(void)
 		 *
 		 * This test happens last, as job_ptr may be pointing to a job
 		 * that would be deleted by a separate thread when the job_write
-		 * lock is released. However, list_next itself is thread safe,
-		 * and can be used again once the locks are reacquired.
-		 * list_peek_next is used in the unlikely event the timer has
-		 * expired just as the end of the job_list is reached.
+		 * lock is released. Every job is looked up again by its job ID
+		 * once the locks are reacquired. The last job is excluded in
+		 * the unlikely event the timer has expired just as the end of
+		 * the job ID array is reached.
 		 */
 	time_check:
 		/* Use a hard-coded 3 second timeout, with a 1 second sleep. */
-		if (slurm_delta_tv(&tv1) >= 3000000 &&
-		    list_peek_next(job_iterator)) {
+		if (slurm_delta_tv(&tv1) >= 3000000 && (i < (job_cnt - 1))) {
 			END_TIMER;
 			debug("%s: yielding locks after testing %d jobs, %s",
 			      __func__, job_test_count, TIME_STR);
@@ -9100,8 +9741,7 @@ void job_time_limit(void)
 			job_test_count = 0;
 		}
 	}
-	list_iterator_destroy(job_iterator);
-	node_features_updated = false;
+	xfree(job_ids);
 }
 
 extern void job_set_req_tres(job_record_t *job_ptr, bool assoc_mgr_locked)
@@ -9532,6 +10172,9 @@ static void _delete_job_common(job_record_t *job_ptr)
 	/* Remove record from fed_job_list */
 	fed_mgr_remove_fed_job_info(job_ptr->job_id);
 
+	/* Jobs depending on this one must see that it is gone */
+	depend_index_purge(job_ptr);
+
 	/* Remove the record from job hash table */
 	_remove_job_hash(job_ptr, JOB_HASH_JOB);
 
@@ -9735,6 +10378,36 @@ static bool _hide_job_user_rec(job_record_t *job_ptr, slurmdb_user_rec_t *user,
 	return false;
 }
 
+/*
+ * Hash the job record just packed at offset and note when it last changed
+ * RET true if the record changed since pack_info->last_update
+ */
+static bool _job_info_changed(job_record_t *job_ptr,
+			      _foreach_pack_job_info_t *pack_info,
+			      uint32_t offset)
+{
+	int inx = (pack_info->show_flags & SHOW_DETAIL) ? 1 : 0;
+	uint8_t *data = (uint8_t *) get_buf_data(pack_info->buffer);
+	uint32_t end = get_buf_offset(pack_info->buffer);
+	uint64_t hash = 0xcbf29ce484222325; /* FNV-1a */
+
+	for (uint32_t i = offset; i < end; i++) {
+		hash ^= data[i];
+		hash *= 0x100000001b3;
+	}
+
+	if (job_ptr->info_hash[inx] != hash) {
+		job_ptr->info_hash[inx] = hash;
+		job_ptr->info_change[inx] = pack_info->pack_time;
+	}
+
+	/*
+	 * Records that changed in the same second as the client's last
+	 * response are sent again, the client replaces them by job ID.
+	 */
+	return (job_ptr->info_change[inx] >= pack_info->last_update);
+}
+
 static int _pack_job(void *object, void *arg)
 {
 	job_record_t *job_ptr = (job_record_t *)object;
@@ -9749,6 +10422,12 @@ static int _pack_job(void *object, void *arg)
 	if (!(pack_info->show_flags & SHOW_ALL) && IS_JOB_REVOKED(job_ptr))
 		return SLURM_SUCCESS;
 
+	if ((pack_info->show_flags & SHOW_ACTIVE) &&
+	    !IS_JOB_PENDING(job_ptr) && !IS_JOB_RUNNING(job_ptr) &&
+	    !IS_JOB_STAGE_OUT(job_ptr) && !IS_JOB_SUSPENDED(job_ptr) &&
+	    !IS_JOB_COMPLETING(job_ptr))
+		return SLURM_SUCCESS;
+
 	if (!pack_info->privileged) {
 		if (((pack_info->show_flags & SHOW_ALL) == 0) &&
 		    _all_parts_hidden(job_ptr, pack_info->visible_parts))
@@ -9759,9 +10438,22 @@ static int _pack_job(void *object, void *arg)
 			return SLURM_SUCCESS;
 	}
 
-	pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
-		 pack_info->protocol_version, pack_info->uid,
-		 pack_info->has_qos_lock);
+	if (pack_info->delta) {
+		uint32_t offset = get_buf_offset(pack_info->buffer);
+
+		pack_info->job_ids[pack_info->job_id_cnt++] = job_ptr->job_id;
+		pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
+			 pack_info->protocol_version, pack_info->uid,
+			 pack_info->has_qos_lock);
+		if (!_job_info_changed(job_ptr, pack_info, offset)) {
+			set_buf_offset(pack_info->buffer, offset);
+			return SLURM_SUCCESS;
+		}
+	} else {
+		pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
+			 pack_info->protocol_version, pack_info->uid,
+			 pack_info->has_qos_lock);
+	}
 
 	pack_info->jobs_packed++;
 
@@ -9786,21 +10478,66 @@ static int _foreach_pack_jobid(void *object, void *arg)
  * NOTE: change _unpack_job_info_msg() in common/slurm_protocol_pack.c
  *	whenever the data format changes
  */
-static buf_t *_pack_init_job_info(uint16_t protocol_version)
+static buf_t *_pack_init_job_info(uint16_t protocol_version, time_t now,
+				  bool delta)
 {
 	buf_t *buffer = init_buf(BUF_SIZE);
 
 	/* write message body header : size and time */
 	/* put in a place holder job record count of 0 for now */
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		pack32(0, buffer);
+		pack_time(now, buffer);
+		pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
+		packbool(delta, buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack32(0, buffer);
-		pack_time(time(NULL), buffer);
+		pack_time(now, buffer);
 		pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
 	}
 
 	return buffer;
 }
 
+static buf_t *_pack_all_jobs(_foreach_pack_job_info_t *pack_info)
+{
+	uint32_t tmp_offset;
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .user = READ_LOCK,
+				   .qos = READ_LOCK };
+
+	pack_info->pack_time = time(NULL);
+	pack_info->buffer = _pack_init_job_info(pack_info->protocol_version,
+						pack_info->pack_time,
+						pack_info->delta);
+	pack_info->has_qos_lock = true;
+	pack_info->user_rec.uid = pack_info->uid;
+
+	assoc_mgr_lock(&locks);
+	assoc_mgr_fill_in_user(acct_db_conn, &pack_info->user_rec,
+			       accounting_enforce, NULL, true);
+	pack_info->privileged =
+		validate_operator_user_rec(&pack_info->user_rec);
+	pack_info->visible_parts = build_visible_parts(
+		pack_info->uid,
+		(pack_info->privileged || (pack_info->show_flags & SHOW_ALL)));
+	list_for_each_ro(job_list, _pack_job, pack_info);
+	assoc_mgr_unlock(&locks);
+
+	if (pack_info->delta)
+		pack32_array(pack_info->job_ids, pack_info->job_id_cnt,
+			     pack_info->buffer);
+
+	/* put the real record count in the message body header */
+	tmp_offset = get_buf_offset(pack_info->buffer);
+	set_buf_offset(pack_info->buffer, 0);
+	pack32(pack_info->jobs_packed, pack_info->buffer);
+	set_buf_offset(pack_info->buffer, tmp_offset);
+
+	xfree(pack_info->visible_parts);
+
+	return pack_info->buffer;
+}
+
 /*
  * pack_all_jobs - dump all job information for all jobs in
  *	machine independent form (for network transmission)
@@ -9814,38 +10551,54 @@ static buf_t *_pack_init_job_info(uint16_t protocol_version)
 extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 			    uint16_t protocol_version)
 {
-	uint32_t tmp_offset;
 	_foreach_pack_job_info_t pack_info = {
-		.buffer = _pack_init_job_info(protocol_version),
 		.filter_uid = filter_uid,
-		.jobs_packed = 0,
 		.protocol_version = protocol_version,
 		.show_flags = show_flags,
 		.uid = uid,
-		.has_qos_lock = true,
-		.user_rec.uid = uid,
 	};
-	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .user = READ_LOCK,
-				   .qos = READ_LOCK };
 
-	assoc_mgr_lock(&locks);
-	assoc_mgr_fill_in_user(acct_db_conn, &pack_info.user_rec,
-			       accounting_enforce, NULL, true);
-	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
-	pack_info.visible_parts = build_visible_parts(
-		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
-	list_for_each_ro(job_list, _pack_job, &pack_info);
-	assoc_mgr_unlock(&locks);
+	return _pack_all_jobs(&pack_info);
+}
 
-	/* put the real record count in the message body header */
-	tmp_offset = get_buf_offset(pack_info.buffer);
-	set_buf_offset(pack_info.buffer, 0);
-	pack32(pack_info.jobs_packed, pack_info.buffer);
-	set_buf_offset(pack_info.buffer, tmp_offset);
+/*
+ * pack_delta_jobs - dump job information for all jobs, but only include the
+ *	records of jobs that changed since last_update
+ * IN last_update - time of the client's previous job information
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * OUT buffer
+ * global: job_list - global list of job records
+ * NOTE: the buffer at *buffer_ptr must be xfreed by the caller
+ */
+extern buf_t *pack_delta_jobs(time_t last_update, uint16_t show_flags,
+			      uid_t uid, uint16_t protocol_version)
+{
+	static pthread_mutex_t delta_mutex = PTHREAD_MUTEX_INITIALIZER;
+	_foreach_pack_job_info_t pack_info = {
+		.delta = true,
+		.filter_uid = NO_VAL,
+		.last_update = last_update,
+		.protocol_version = protocol_version,
+		.show_flags = show_flags,
+		.uid = uid,
+	};
+	buf_t *buffer;
 
-	xfree(pack_info.visible_parts);
+	xassert(protocol_version >= SLURM_24_11_PROTOCOL_VERSION);
 
-	return pack_info.buffer;
+	pack_info.job_ids = xcalloc(list_count(job_list) + 1,
+				    sizeof(*pack_info.job_ids));
+
+	/* Serialize updates of info_hash with only the job read lock held */
+	slurm_mutex_lock(&delta_mutex);
+	buffer = _pack_all_jobs(&pack_info);
+	slurm_mutex_unlock(&delta_mutex);
+
+	xfree(pack_info.job_ids);
+
+	return buffer;
 }
 
 /*
@@ -9864,7 +10617,8 @@ extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
 {
 	uint32_t tmp_offset;
 	_foreach_pack_job_info_t pack_info = {
-		.buffer = _pack_init_job_info(protocol_version),
+		.buffer = _pack_init_job_info(protocol_version, time(NULL),
+					      false),
 		.filter_uid = filter_uid,
 		.jobs_packed = 0,
 		.protocol_version = protocol_version,
@@ -9898,6 +10652,180 @@ extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
 	return pack_info.buffer;
 }
 
+static int _find_restricted_part(void *x, void *arg)
+{
+	part_record_t *part_ptr = x;
+
+	if ((part_ptr->flags & PART_FLAG_HIDDEN) || part_ptr->allow_groups)
+		return 1;
+	return 0;
+}
+
+/*
+ * Test if a REQUEST_JOB_INFO response for all jobs can be shared with other
+ * users making the same request.
+ * OUT public - response is the one any unprivileged user would get
+ * RET true if the response does not depend upon who requested it
+ */
+static bool _job_info_snapshot_shared(uint16_t show_flags, uid_t uid,
+				      bool *public)
+{
+	if (!job_info_max_age)
+		return false;
+	if (slurm_conf.private_data & PRIVATE_DATA_JOBS)
+		return false;
+	if (show_flags & SHOW_DELTA)
+		return false;
+
+	*public = !(show_flags & SHOW_ALL) && !validate_operator(uid);
+
+	return true;
+}
+
+/*
+ * job_info_snapshot_get - get a copy of a recently packed response to
+ *	REQUEST_JOB_INFO for all jobs, without taking any slurmctld locks
+ * IN last_update - time of the data the client already has
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request
+ * IN protocol_version - slurm protocol version of client
+ * RET buffer to send or NULL if no usable snapshot is available
+ */
+extern buf_t *job_info_snapshot_get(time_t last_update, uint16_t show_flags,
+				    uid_t uid, uint16_t protocol_version)
+{
+	buf_t *buffer = NULL;
+	time_t now;
+	bool public;
+
+	if (!_job_info_snapshot_shared(show_flags, uid, &public))
+		return NULL;
+
+	now = time(NULL);
+	slurm_mutex_lock(&job_info_snapshot_mutex);
+	for (int i = 0; i < JOB_INFO_SNAPSHOT_CNT; i++) {
+		job_info_snapshot_t *snap = &job_info_snapshot[i];
+		uint32_t size;
+
+		if (!snap->buffer ||
+		    (snap->protocol_version != protocol_version) ||
+		    (snap->show_flags != show_flags) ||
+		    (snap->public != public))
+			continue;
+		if (((now - snap->pack_time) > job_info_max_age) ||
+		    (snap->pack_time < last_update))
+			break;
+
+		size = get_buf_offset(snap->buffer);
+		buffer = init_buf(size);
+		memcpy(get_buf_data(buffer), get_buf_data(snap->buffer), size);
+		set_buf_offset(buffer, size);
+		break;
+	}
+	slurm_mutex_unlock(&job_info_snapshot_mutex);
+
+	return buffer;
+}
+
+/*
+ * job_info_snapshot_save - save a copy of the response from pack_all_jobs()
+ *	for job_info_snapshot_get()
+ * IN buffer - response packed by pack_all_jobs() with filter_uid of NO_VAL
+ * IN show_flags, uid, protocol_version - as passed to pack_all_jobs()
+ * NOTE: Call with the job and part read locks still held
+ */
+extern void job_info_snapshot_save(buf_t *buffer, uint16_t show_flags,
+				   uid_t uid, uint16_t protocol_version)
+{
+	job_info_snapshot_t *snap = NULL;
+	uint32_t size;
+	bool public;
+
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+	xassert(verify_lock(PART_LOCK, READ_LOCK));
+
+	if (!_job_info_snapshot_shared(show_flags, uid, &public))
+		return;
+
+	/*
+	 * An unprivileged user's view without SHOW_ALL depends on which
+	 * partitions are visible to them, which is only the same for all
+	 * users if no partition is hidden or restricted to some groups.
+	 */
+	if (public && list_find_first_ro(part_list, _find_restricted_part,
+					 NULL))
+		return;
+
+	slurm_mutex_lock(&job_info_snapshot_mutex);
+	for (int i = 0; i < JOB_INFO_SNAPSHOT_CNT; i++) {
+		job_info_snapshot_t *tmp = &job_info_snapshot[i];
+
+		if (tmp->buffer &&
+		    (tmp->protocol_version == protocol_version) &&
+		    (tmp->show_flags == show_flags) &&
+		    (tmp->public == public)) {
+			snap = tmp;
+			break;
+		}
+		if (!snap || (tmp->pack_time < snap->pack_time))
+			snap = tmp;
+	}
+
+	size = get_buf_offset(buffer);
+	FREE_NULL_BUFFER(snap->buffer);
+	snap->buffer = init_buf(size);
+	memcpy(get_buf_data(snap->buffer), get_buf_data(buffer), size);
+	set_buf_offset(snap->buffer, size);
+	snap->pack_time = time(NULL);
+	snap->protocol_version = protocol_version;
+	snap->public = public;
+	snap->show_flags = show_flags;
+	slurm_mutex_unlock(&job_info_snapshot_mutex);
+}
+
+/*
+ * job_state_shard_config - read SlurmctldParameters=job_state_shards
+ */
+extern void job_state_shard_config(void)
+{
+	char *tmp_ptr;
+	int shards = 0;
+
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "job_state_shards=")))
+		shards = atoi(tmp_ptr + strlen("job_state_shards="));
+	if ((shards < 0) || (shards > JOB_STATE_SHARD_MAX)) {
+		error("Invalid SlurmctldParameters job_state_shards=%d, ignored",
+		      shards);
+		shards = 0;
+	}
+	job_state_shards = shards;
+}
+
+/*
+ * job_info_snapshot_config - read SlurmctldParameters=job_info_max_age and
+ *	discard any saved snapshots
+ */
+extern void job_info_snapshot_config(void)
+{
+	char *tmp_ptr;
+
+	slurm_mutex_lock(&job_info_snapshot_mutex);
+	job_info_max_age = 0;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "job_info_max_age=")))
+		job_info_max_age = atoi(tmp_ptr + strlen("job_info_max_age="));
+	if (job_info_max_age < 0) {
+		error("Invalid SlurmctldParameters job_info_max_age=%d, ignored",
+		      job_info_max_age);
+		job_info_max_age = 0;
+	}
+
+	for (int i = 0; i < JOB_INFO_SNAPSHOT_CNT; i++)
+		FREE_NULL_BUFFER(job_info_snapshot[i].buffer);
+	slurm_mutex_unlock(&job_info_snapshot_mutex);
+}
+
 static int _pack_het_job(job_record_t *job_ptr, uint16_t show_flags,
 			 buf_t *buffer, uint16_t protocol_version, uid_t uid)
 {
@@ -9942,7 +10870,7 @@ extern buf_t *pack_one_job(uint32_t job_id, uint16_t show_flags, uid_t uid,
 	bool hide_job = false;
 	bool valid_operator;
 
-	buffer = _pack_init_job_info(protocol_version);
+	buffer = _pack_init_job_info(protocol_version, time(NULL), false);
 
 	assoc_mgr_lock(&locks);
 	user_rec.uid = uid;
@@ -12483,8 +13411,8 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 
 	if (new_assoc_ptr) {
 		/* Change account/association */
-		xfree(job_ptr->account);
-		job_ptr->account = xstrdup(new_assoc_ptr->acct);
+		job_record_str_release(&job_ptr->account);
+		job_ptr->account = job_record_str_intern(new_assoc_ptr->acct);
 		job_ptr->assoc_id = new_assoc_ptr->id;
 		job_ptr->assoc_ptr = new_assoc_ptr;
 
@@ -14808,8 +15736,16 @@ extern void validate_jobs_on_node(slurm_msg_t *slurm_msg)
 	}
 
 	jobs_on_node = node_ptr->run_job_cnt + node_ptr->comp_job_cnt;
-	if (jobs_on_node)
+	if (jobs_on_node && (slurm_msg->flags & CTLD_QUEUE_PROCESSING)) {
+		/* Registrations queued in a batch, see rpc_queue.c */
+		if (!purge_node_bitmap)
+			purge_node_bitmap = bit_alloc(node_record_count);
+		else if (bit_size(purge_node_bitmap) < node_record_count)
+			bit_realloc(purge_node_bitmap, node_record_count);
+		bit_set(purge_node_bitmap, node_ptr->index);
+	} else if (jobs_on_node) {
 		_purge_missing_jobs(node_ptr->index, now);
+	}
 
 	if (jobs_on_node != reg_msg->job_count) {
 		/* slurmd will not know of a job unless the job has
@@ -14822,6 +15758,75 @@ extern void validate_jobs_on_node(slurm_msg_t *slurm_msg)
 	}
 }
 
+/*
+ * Purge job_ptr if its batch script should be running on node node_inx but
+ * is not, otherwise notify srun of its steps missing from the node.
+ * RET false if job_ptr is no longer running on the node
+ */
+static bool _purge_missing_job_on_node(job_record_t *job_ptr, int node_inx,
+				       time_t now, bool power_save_on)
+{
+	node_record_t *node_ptr = node_record_table_ptr[node_inx];
+	time_t batch_startup_time, node_boot_time = (time_t) 0, startup_time;
+
+	if ((IS_JOB_CONFIGURING(job_ptr) ||
+	     (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr))) ||
+	    (!bit_test(job_ptr->node_bitmap, node_inx)))
+		return false;
+
+	if (node_ptr->boot_time > (slurm_conf.msg_timeout + 5)) {
+		/* allow for message timeout and other delays */
+		node_boot_time = node_ptr->boot_time -
+			(slurm_conf.msg_timeout + 5);
+	}
+	batch_startup_time  = now - slurm_conf.batch_start_timeout;
+	batch_startup_time -= MIN(DEFAULT_MSG_TIMEOUT, slurm_conf.msg_timeout);
+
+	if ((job_ptr->batch_flag != 0) && power_save_on &&
+	    (job_ptr->start_time < node_boot_time)) {
+		startup_time = batch_startup_time -
+			slurm_conf.resume_timeout;
+	} else
+		startup_time = batch_startup_time;
+
+	if ((job_ptr->batch_flag != 0)			&&
+	    (job_ptr->het_job_offset == 0)		&&
+	    (job_ptr->time_last_active < startup_time)	&&
+	    (job_ptr->start_time       < startup_time)	&&
+	    (node_ptr == find_node_record(job_ptr->batch_host))) {
+		bool requeue = false;
+		char *requeue_msg = "";
+		if (job_ptr->details && job_ptr->details->requeue) {
+			requeue = true;
+			requeue_msg = ", Requeuing job";
+		}
+		info("Batch %pJ missing from batch node %s (not found BatchStartTime after startup)%s",
+		     job_ptr, job_ptr->batch_host, requeue_msg);
+		xfree(job_ptr->failed_node);
+		job_ptr->failed_node = xstrdup(job_ptr->batch_host);
+		job_ptr->exit_code = 1;
+		job_complete(job_ptr->job_id, slurm_conf.slurm_user_id,
+			     requeue, true, NO_VAL);
+		return false;
+	}
+
+	_notify_srun_missing_step(job_ptr, node_inx, now, node_boot_time);
+	return true;
+}
+
+static bool _power_save_on(void)
+{
+	static bool power_save_on = false;
+	static time_t sched_update = 0;
+
+	if (sched_update != slurm_conf.last_update) {
+		power_save_on = power_save_test();
+		sched_update = slurm_conf.last_update;
+	}
+
+	return power_save_on;
+}
+
 /* Purge any batch job that should have its script running on node
  * node_inx, but is not. Allow BatchStartTimeout + ResumeTimeout seconds
  * for startup.
@@ -14834,62 +15839,60 @@ static void _purge_missing_jobs(int node_inx, time_t now)
 {
 	list_itr_t *job_iterator;
 	job_record_t *job_ptr;
-	node_record_t *node_ptr = node_record_table_ptr[node_inx];
-	time_t batch_startup_time, node_boot_time = (time_t) 0, startup_time;
-	static bool power_save_on = false;
-	static time_t sched_update = 0;
+	bool power_save_on = _power_save_on();
 
-	if (sched_update != slurm_conf.last_update) {
-		power_save_on = power_save_test();
-		sched_update = slurm_conf.last_update;
-	}
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator)))
+		(void) _purge_missing_job_on_node(job_ptr, node_inx, now,
+						  power_save_on);
+	list_iterator_destroy(job_iterator);
+}
 
-	if (node_ptr->boot_time > (slurm_conf.msg_timeout + 5)) {
-		/* allow for message timeout and other delays */
-		node_boot_time = node_ptr->boot_time -
-			(slurm_conf.msg_timeout + 5);
-	}
-	batch_startup_time  = now - slurm_conf.batch_start_timeout;
-	batch_startup_time -= MIN(DEFAULT_MSG_TIMEOUT, slurm_conf.msg_timeout);
+/*
+ * Run _purge_missing_jobs() for every node recorded in purge_node_bitmap,
+ * walking the job list once for the whole batch of registrations.
+ */
+extern void purge_missing_jobs_batch(void)
+{
+	list_itr_t *job_iterator;
+	job_record_t *job_ptr;
+	time_t now = time(NULL);
+	bool power_save_on;
+	int first, last;
+
+	if (!purge_node_bitmap ||
+	    ((first = bit_ffs(purge_node_bitmap)) < 0))
+		return;
+	last = bit_fls(purge_node_bitmap);
+	last = MIN(last, (node_record_count - 1));
+	power_save_on = _power_save_on();
 
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
-		if ((IS_JOB_CONFIGURING(job_ptr) ||
-		     (!IS_JOB_RUNNING(job_ptr) &&
-		      !IS_JOB_SUSPENDED(job_ptr))) ||
-		    (!bit_test(job_ptr->node_bitmap, node_inx)))
+		int job_first, job_last;
+
+		if (!job_ptr->node_bitmap ||
+		    (IS_JOB_CONFIGURING(job_ptr) ||
+		     (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr))))
 			continue;
-		if ((job_ptr->batch_flag != 0) && power_save_on &&
-		    (job_ptr->start_time < node_boot_time)) {
-			startup_time = batch_startup_time -
-				slurm_conf.resume_timeout;
-		} else
-			startup_time = batch_startup_time;
-
-		if ((job_ptr->batch_flag != 0)			&&
-		    (job_ptr->het_job_offset == 0)		&&
-		    (job_ptr->time_last_active < startup_time)	&&
-		    (job_ptr->start_time       < startup_time)	&&
-		    (node_ptr == find_node_record(job_ptr->batch_host))) {
-			bool requeue = false;
-			char *requeue_msg = "";
-			if (job_ptr->details && job_ptr->details->requeue) {
-				requeue = true;
-				requeue_msg = ", Requeuing job";
-			}
-			info("Batch %pJ missing from batch node %s (not found BatchStartTime after startup)%s",
-			     job_ptr, job_ptr->batch_host, requeue_msg);
-			xfree(job_ptr->failed_node);
-			job_ptr->failed_node = xstrdup(job_ptr->batch_host);
-			job_ptr->exit_code = 1;
-			job_complete(job_ptr->job_id, slurm_conf.slurm_user_id,
-			             requeue, true, NO_VAL);
-		} else {
-			_notify_srun_missing_step(job_ptr, node_inx,
-						  now, node_boot_time);
+		if ((job_first = bit_ffs(job_ptr->node_bitmap)) < 0)
+			continue;
+		job_last = MIN(bit_fls(job_ptr->node_bitmap), last);
+
+		for (int i = MAX(first, job_first); i <= job_last; i++) {
+			if (!bit_test(purge_node_bitmap, i) ||
+			    !node_record_table_ptr[i])
+				continue;
+			if (!_purge_missing_job_on_node(job_ptr, i, now,
+							power_save_on) &&
+			    !IS_JOB_RUNNING(job_ptr) &&
+			    !IS_JOB_SUSPENDED(job_ptr))
+				break;
 		}
 	}
 	list_iterator_destroy(job_iterator);
+
+	bit_clear_all(purge_node_bitmap);
 }
 
 static void _notify_srun_missing_step(job_record_t *job_ptr, int node_inx,
@@ -15713,6 +16716,7 @@ void batch_requeue_fini(job_record_t *job_ptr)
 void job_fini (void)
 {
 	FREE_NULL_LIST(job_list);
+	xhash_free_ptr(&time_limit_index);
 	xfree(job_hash);
 	xfree(job_array_hash_j);
 	xfree(job_array_hash_t);
@@ -15720,6 +16724,9 @@ void job_fini (void)
 	FREE_NULL_LIST(purge_files_list);
 	FREE_NULL_BITMAP(requeue_exit);
 	FREE_NULL_BITMAP(requeue_exit_hold);
+	FREE_NULL_BITMAP(purge_node_bitmap);
+	for (int i = 0; i < JOB_INFO_SNAPSHOT_CNT; i++)
+		FREE_NULL_BUFFER(job_info_snapshot[i].buffer);
 }
 
 /* Record the start of one job array task */
@@ -17538,9 +18545,9 @@ extern int update_job_wckey(char *module, job_record_t *job_ptr,
 		}
 	}
 
-	xfree(job_ptr->wckey);
+	job_record_str_release(&job_ptr->wckey);
 	if (wckey_rec.name && wckey_rec.name[0] != '\0') {
-		job_ptr->wckey = xstrdup(wckey_rec.name);
+		job_ptr->wckey = job_record_str_intern(wckey_rec.name);
 		info("%s: setting wckey to %s for %pJ",
 		     module, wckey_rec.name, job_ptr);
 	} else {
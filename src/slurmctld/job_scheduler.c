@@ -62,10 +62,12 @@
 #include "src/common/macros.h"
 #include "src/common/strlcpy.h"
 #include "src/common/parse_time.h"
+#include "src/common/sched_trace.h"
 #include "src/common/timers.h"
 #include "src/common/track_script.h"
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/accounting_storage.h"
@@ -87,6 +89,7 @@
 #include "src/slurmctld/licenses.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/node_scheduler.h"
+#include "src/slurmctld/numa_placement.h"
 #include "src/slurmctld/power_save.h"
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/reservation.h"
@@ -140,6 +143,13 @@ typedef struct {
 	bitstr_t *eff_cg_bitmap;
 } part_reduce_frag_t;
 
+/* Jobs waiting on job_id, an entry of depend_index */
+typedef struct {
+	uint32_t job_id;
+	uint32_t dependent_cnt;
+	uint32_t *dependent_ids;
+} depend_rev_t;
+
 static batch_job_launch_msg_t *_build_launch_job_msg(job_record_t *job_ptr,
 						     uint16_t protocol_version);
 static void _job_queue_append(list_t *job_queue, job_record_t *job_ptr,
@@ -174,6 +184,12 @@ static int sched_min_interval = 2;
 static int bb_array_stage_cnt = 10;
 extern diag_stats_t slurmctld_diag_stats;
 
+/*
+ * Reverse dependency index: job ID (or array job ID) -> IDs of the jobs whose
+ * settled dependencies wait on it. Protected by the job write lock.
+ */
+static xhash_t *depend_index = NULL;
+
 static int _find_singleton_job (void *x, void *key)
 {
 	job_record_t *qjob_ptr = (job_record_t *) x;
@@ -745,6 +761,18 @@ extern list_t *build_job_queue(bool clear_start, bool backfill)
 	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
+		/*
+		 * scrontab jobs spend nearly all of their life pending until
+		 * their next start time. Once job_independent() has set
+		 * WAIT_TIME there is nothing to re-evaluate until then.
+		 */
+		if ((job_ptr->bit_flags & CRON_JOB) &&
+		    IS_JOB_PENDING(job_ptr) &&
+		    (job_ptr->state_reason == WAIT_TIME) &&
+		    job_ptr->details && !job_ptr->details->depend_list &&
+		    (job_ptr->details->begin_time > now))
+			continue;
+
 		if (IS_JOB_PENDING(job_ptr)) {
 			/* Remove backfill flag */
 			job_ptr->bit_flags &= ~BACKFILL_SCHED;
@@ -949,6 +977,7 @@ static void *_sched_agent(void *args)
 		error("cannot set my name to _sched_agent %m");
 	}
 #endif
+	numa_placement_sched_thread();
 
 	while (true) {
 		slurm_mutex_lock(&sched_mutex);
@@ -1413,6 +1442,18 @@ static int _schedule(bool full_queue)
 			sched_max_job_start = 0;
 		}
 
+		if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+					   "sched_trace="))) {
+			i = atoi(tmp_ptr + 12);
+			if (i < 0) {
+				error("Invalid sched_trace: %d", i);
+				i = 0;
+			}
+		} else {
+			i = 0;
+		}
+		sched_trace_init(i);
+
 		sched_update = slurm_conf.last_update;
 		if (slurm_conf.sched_params && strlen(slurm_conf.sched_params))
 			info("SchedulerParameters=%s", slurm_conf.sched_params);
@@ -1890,6 +1931,11 @@ next_task:
 
 skip_start:
 
+		sched_trace_add(SCHED_TRACE_MAIN, 0, job_ptr->job_id,
+				(job_ptr->part_ptr ?
+				 job_ptr->part_ptr->name : NULL),
+				error_code, 0);
+
 		fail_by_part = false;
 		if ((error_code != SLURM_SUCCESS) && deadline_time_limit)
 			job_ptr->time_limit = save_time_limit;
@@ -2151,13 +2197,97 @@ out:
 	return job_cnt;
 }
 
+/*
+ * Merge the sorted runs v[lo, mid) and v[mid, hi) through tmp, keeping
+ * records that compare equal in their current order.
+ */
+static void _merge_job_queue(job_queue_rec_t **v, job_queue_rec_t **tmp,
+			     int lo, int mid, int hi)
+{
+	int i = lo, j = mid, k = lo;
+
+	/* Runs already in order, as when little changed since the last pass */
+	if (sort_job_queue2(&v[mid - 1], &v[mid]) <= 0)
+		return;
+
+	while ((i < mid) && (j < hi)) {
+		if (sort_job_queue2(&v[j], &v[i]) < 0)
+			tmp[k++] = v[j++];
+		else
+			tmp[k++] = v[i++];
+	}
+	while (i < mid)
+		tmp[k++] = v[i++];
+	while (j < hi)
+		tmp[k++] = v[j++];
+	memcpy(&v[lo], &tmp[lo], (hi - lo) * sizeof(job_queue_rec_t *));
+}
+
 /*
  * sort_job_queue - sort job_queue in descending priority order
  * IN/OUT job_queue - sorted job queue
+ *
+ * Job priorities and partition tiers rarely change much between scheduling
+ * passes, so the records are first placed in the order their jobs had in the
+ * last sorted queue (job_ptr->queue_rank), then sorted by merging the runs
+ * that are already in order. For an unchanged queue this takes one
+ * comparison per record rather than the n*log(n) of a full sort.
  */
 extern void sort_job_queue(list_t *job_queue)
 {
-	list_sort(job_queue, sort_job_queue2);
+	job_queue_rec_t **v, **tmp, *job_queue_rec;
+	int *run, *cnt, n, rank, run_cnt;
+
+	if ((n = list_count(job_queue)) <= 1)
+		return;
+
+	/* Stable counting sort on each job's rank from the last pass */
+	tmp = xcalloc(n, sizeof(job_queue_rec_t *));
+	cnt = xcalloc(n + 2, sizeof(int));
+	for (int i = 0; (job_queue_rec = list_pop(job_queue)); i++) {
+		tmp[i] = job_queue_rec;
+		rank = MIN(job_queue_rec->job_ptr->queue_rank, n);
+		cnt[rank + 1]++;
+	}
+	for (int i = 1; i <= n; i++)
+		cnt[i] += cnt[i - 1];
+	v = xcalloc(n, sizeof(job_queue_rec_t *));
+	for (int i = 0; i < n; i++) {
+		rank = MIN(tmp[i]->job_ptr->queue_rank, n);
+		v[cnt[rank]++] = tmp[i];
+	}
+
+	/* Find the runs already in order, then merge them pairwise */
+	run = cnt;
+	run_cnt = 0;
+	run[run_cnt++] = 0;
+	for (int i = 1; i < n; i++) {
+		if (sort_job_queue2(&v[i - 1], &v[i]) > 0)
+			run[run_cnt++] = i;
+	}
+	run[run_cnt] = n;
+	while (run_cnt > 1) {
+		int out = 0;
+
+		for (int i = 0; i < run_cnt; i += 2) {
+			if ((i + 1) < run_cnt)
+				_merge_job_queue(v, tmp, run[i], run[i + 1],
+						 run[i + 2]);
+			run[out++] = run[i];
+		}
+		run[out] = n;
+		run_cnt = out;
+	}
+
+	/* Walk backwards so each job keeps the rank of its first record */
+	for (int i = n - 1; i >= 0; i--)
+		v[i]->job_ptr->queue_rank = i + 1;
+	for (int i = 0; i < n; i++)
+		list_append(job_queue, v[i]);
+
+	xfree(cnt);
+	xfree(tmp);
+	xfree(v);
 }
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
@@ -3109,6 +3239,134 @@ static void _test_dependency_state(depend_spec_t *dep_ptr, bool *or_satisfied,
 	}
 }
 
+static void _depend_rev_id(void *item, const char **key, uint32_t *key_len)
+{
+	depend_rev_t *rev = item;
+
+	*key = (const char *) &rev->job_id;
+	*key_len = sizeof(rev->job_id);
+}
+
+static void _depend_rev_free(void *item)
+{
+	depend_rev_t *rev = item;
+
+	xfree(rev->dependent_ids);
+	xfree(rev);
+}
+
+static void _depend_index_add(uint32_t job_id, uint32_t dependent_id)
+{
+	depend_rev_t *rev;
+
+	if (!depend_index)
+		depend_index = xhash_init(_depend_rev_id, _depend_rev_free);
+
+	if (!(rev = xhash_get(depend_index, (char *) &job_id,
+			      sizeof(job_id)))) {
+		rev = xmalloc(sizeof(*rev));
+		rev->job_id = job_id;
+		xhash_add(depend_index, rev);
+	} else if (rev->dependent_cnt &&
+		   (rev->dependent_ids[rev->dependent_cnt - 1] ==
+		    dependent_id)) {
+		return;
+	}
+
+	xrecalloc(rev->dependent_ids, rev->dependent_cnt + 1,
+		  sizeof(uint32_t));
+	rev->dependent_ids[rev->dependent_cnt++] = dependent_id;
+}
+
+static void _depend_index_unsettle(uint32_t job_id)
+{
+	depend_rev_t *rev;
+	job_record_t *job_ptr;
+
+	if (!depend_index ||
+	    !(rev = xhash_get(depend_index, (char *) &job_id, sizeof(job_id))))
+		return;
+
+	/* Each dependent adds itself again when it next settles */
+	for (int i = 0; i < rev->dependent_cnt; i++) {
+		if ((job_ptr = find_job_record(rev->dependent_ids[i])) &&
+		    job_ptr->details)
+			job_ptr->details->depend_settled = false;
+	}
+	rev->dependent_cnt = 0;
+	xfree(rev->dependent_ids);
+}
+
+extern void depend_index_notify(job_record_t *job_ptr)
+{
+	if (!depend_index)
+		return;
+
+	_depend_index_unsettle(job_ptr->job_id);
+	if (job_ptr->array_job_id && (job_ptr->array_job_id != job_ptr->job_id))
+		_depend_index_unsettle(job_ptr->array_job_id);
+}
+
+extern void depend_index_purge(job_record_t *job_ptr)
+{
+	if (!depend_index)
+		return;
+
+	depend_index_notify(job_ptr);
+	xhash_delete(depend_index, (char *) &job_ptr->job_id,
+		     sizeof(job_ptr->job_id));
+}
+
+/*
+ * Return true if an unfulfilled dependency can change without the job it
+ * names changing state, so it must be tested on every pass
+ */
+static bool _depend_volatile(depend_spec_t *dep_ptr)
+{
+	if (dep_ptr->depend_flags & SLURM_FLAGS_REMOTE)
+		return true;
+
+	switch (dep_ptr->depend_type) {
+	case SLURM_DEPEND_AFTER:
+		return (dep_ptr->depend_time || fed_mgr_fed_rec);
+	case SLURM_DEPEND_AFTER_CORRESPOND:
+	case SLURM_DEPEND_BURST_BUFFER:
+	case SLURM_DEPEND_SINGLETON:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Once a job's remaining dependencies only change when the jobs they name
+ * change state, add the job to the reverse index and skip further tests until
+ * depend_index_notify() is called for one of those jobs.
+ */
+static void _depend_settle(job_record_t *job_ptr)
+{
+	list_itr_t *depend_iter;
+	depend_spec_t *dep_ptr;
+
+	depend_iter = list_iterator_create(job_ptr->details->depend_list);
+	while ((dep_ptr = list_next(depend_iter))) {
+		if ((dep_ptr->depend_state == DEPEND_NOT_FULFILLED) &&
+		    (_depend_volatile(dep_ptr) || !dep_ptr->job_ptr))
+			break;
+	}
+	list_iterator_destroy(depend_iter);
+	if (dep_ptr)
+		return;
+
+	depend_iter = list_iterator_create(job_ptr->details->depend_list);
+	while ((dep_ptr = list_next(depend_iter))) {
+		if (dep_ptr->depend_state == DEPEND_NOT_FULFILLED)
+			_depend_index_add(dep_ptr->job_id, job_ptr->job_id);
+	}
+	list_iterator_destroy(depend_iter);
+	job_ptr->details->depend_settled = true;
+}
+
 /*
  * Determine if a job's dependencies are met
  * Inputs: job_ptr
@@ -3141,6 +3399,14 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 		return NO_DEPEND;
 	}
 
+	/* Nothing this job waits on has changed state since the last test */
+	if (job_ptr->details->depend_settled &&
+	    (job_ptr->bit_flags & JOB_DEPENDENT)) {
+		if (was_changed)
+			*was_changed = changed;
+		return LOCAL_DEPEND;
+	}
+
 	depend_iter = list_iterator_create(job_ptr->details->depend_list);
 	while ((dep_ptr = list_next(depend_iter))) {
 		bool clear_dep = false, failure = false;
@@ -3272,6 +3538,8 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 			/* Still dependent */
 			results = has_local_depend ? LOCAL_DEPEND :
 				REMOTE_DEPEND;
+		if (results == LOCAL_DEPEND)
+			_depend_settle(job_ptr);
 	}
 
 	if (was_changed)
@@ -3792,6 +4060,8 @@ extern bool update_job_dependency_list(job_record_t *job_ptr,
 		was_changed = true;
 	}
 	list_iterator_destroy(itr);
+	if (was_changed)
+		job_ptr->details->depend_settled = false;
 	return was_changed;
 }
 
@@ -3894,6 +4164,7 @@ extern int update_job_dependency(job_record_t *job_ptr, char *new_depend)
 
 	/* Clear dependencies on NULL, "0", or empty dependency input */
 	job_ptr->details->expanding_jobid = 0;
+	job_ptr->details->depend_settled = false;
 	if ((new_depend == NULL) || (new_depend[0] == '\0') ||
 	    ((new_depend[0] == '0') && (new_depend[1] == '\0'))) {
 		xfree(job_ptr->details->dependency);
@@ -250,6 +250,15 @@ extern int sort_job_queue2(void *x, void *y);
  */
 extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed);
 
+/*
+ * Mark the jobs that depend on job_ptr (or on its job array) for a retest by
+ * test_job_dependency(). Call when job_ptr changes state.
+ */
+extern void depend_index_notify(job_record_t *job_ptr);
+
+/* As depend_index_notify(), then forget job_ptr. Call when it is purged. */
+extern void depend_index_purge(job_record_t *job_ptr);
+
 /*
  * Parse a job dependency string and use it to establish a "depend_spec"
  * list of dependencies. We accept both old format (a single job ID) and
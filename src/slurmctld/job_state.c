@@ -37,6 +37,7 @@
 #include "src/common/xahash.h"
 #include "src/common/xstring.h"
 
+#include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
@@ -299,6 +300,8 @@ extern void job_state_set(job_record_t *job_ptr, uint32_t state)
 	_log_job_state_change(job_ptr, state);
 
 	on_job_state_change(job_ptr, state);
+	depend_index_notify(job_ptr);
+	time_limit_index_notify(job_ptr, state);
 
 	job_ptr->job_state = state;
 }
@@ -324,6 +327,10 @@ extern void job_state_set_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	on_job_state_change(job_ptr, job_state);
+	if (flag != JOB_UPDATE_DB) {
+		depend_index_notify(job_ptr);
+		time_limit_index_notify(job_ptr, job_state);
+	}
 
 	job_ptr->job_state = job_state;
 }
@@ -341,6 +348,7 @@ extern void job_state_unset_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	on_job_state_change(job_ptr, job_state);
+	depend_index_notify(job_ptr);
 
 	job_ptr->job_state = job_state;
 }
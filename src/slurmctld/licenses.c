@@ -48,6 +48,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -64,9 +65,71 @@ static void _pack_license(licenses_t *lic, buf_t *buffer,
 			  uint16_t protocol_version);
 
 typedef struct {
+	uint32_t id;
 	char *name;
-	slurmctld_resv_t *resv_ptr;
-} bf_licenses_find_resv_t;
+} license_id_t;
+
+/*
+ * Dense ids for license names. An id is handed out the first time a name is
+ * seen and never reused, so the ids held by job and reservation license
+ * lists stay valid across reconfiguration.
+ */
+static pthread_mutex_t license_id_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *license_id_hash = NULL;
+static char **license_id_names = NULL;
+static uint32_t license_id_cnt = 0;
+
+static void _license_id_key(void *item, const char **key, uint32_t *key_len)
+{
+	license_id_t *lic_id = item;
+
+	*key = lic_id->name;
+	*key_len = strlen(lic_id->name);
+}
+
+static void _license_id_free(void *item)
+{
+	license_id_t *lic_id = item;
+
+	xfree(lic_id->name);
+	xfree(lic_id);
+}
+
+/* Get the id of a license name, assigning a new one if needed */
+static uint32_t _license_get_id(char *name)
+{
+	license_id_t *lic_id;
+	uint32_t id;
+
+	slurm_mutex_lock(&license_id_mutex);
+	if (!license_id_hash)
+		license_id_hash = xhash_init(_license_id_key,
+					     _license_id_free);
+	if (!(lic_id = xhash_get_str(license_id_hash, name))) {
+		lic_id = xmalloc(sizeof(*lic_id));
+		lic_id->id = license_id_cnt++;
+		lic_id->name = xstrdup(name);
+		xhash_add(license_id_hash, lic_id);
+		xrecalloc(license_id_names, license_id_cnt, sizeof(char *));
+		license_id_names[lic_id->id] = lic_id->name;
+	}
+	id = lic_id->id;
+	slurm_mutex_unlock(&license_id_mutex);
+
+	return id;
+}
+
+static char *_license_id_name(uint32_t id)
+{
+	char *name = NULL;
+
+	slurm_mutex_lock(&license_id_mutex);
+	if (id < license_id_cnt)
+		name = license_id_names[id];
+	slurm_mutex_unlock(&license_id_mutex);
+
+	return name;
+}
 
 /* Print all licenses on a list */
 static void _licenses_print(char *header, list_t *licenses,
@@ -119,6 +182,15 @@ static int _license_find_rec(void *x, void *key)
 	return 1;
 }
 
+/* Find a license_t record by license id (for use by list_find_first) */
+static int _license_find_id(void *x, void *key)
+{
+	licenses_t *license_entry = x;
+	uint32_t *id = key;
+
+	return (license_entry->id == *id);
+}
+
 /* Find a license_t record by license name (for use by list_find_first) */
 static int _license_find_remote_rec(void *x, void *key)
 {
@@ -173,6 +245,7 @@ static list_t *_build_license_list(char *licenses, bool *valid)
 		} else {
 			license_entry = xmalloc(sizeof(licenses_t));
 			license_entry->name = xstrdup(token);
+			license_entry->id = _license_get_id(token);
 			license_entry->total = num;
 			list_push(lic_list, license_entry);
 		}
@@ -261,6 +334,7 @@ static void _add_res_rec_2_lic_list(slurmdb_res_rec_t *rec, bool sync)
 	licenses_t *license_entry = xmalloc(sizeof(licenses_t));
 
 	license_entry->name = xstrdup_printf("%s@%s", rec->name, rec->server);
+	license_entry->id = _license_get_id(license_entry->name);
 	license_entry->remote = sync ? 2 : 1;
 	_handle_consumed(license_entry, rec);
 
@@ -522,6 +596,12 @@ extern void license_free(void)
 	slurm_mutex_lock(&license_mutex);
 	FREE_NULL_LIST(cluster_license_list);
 	slurm_mutex_unlock(&license_mutex);
+
+	slurm_mutex_lock(&license_id_mutex);
+	xhash_free(license_id_hash);
+	xfree(license_id_names);
+	license_id_cnt = 0;
+	slurm_mutex_unlock(&license_id_mutex);
 }
 
 /*
@@ -663,8 +743,8 @@ extern int license_job_test_with_list(job_record_t *job_ptr, time_t when,
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-					license_entry->name);
+		match = list_find_first(license_list, _license_find_id,
+					&license_entry->id);
 		if (!match) {
 			error("could not find license %s for job %u",
 			      license_entry->name, job_ptr->job_id);
@@ -730,6 +810,7 @@ extern list_t *license_copy(list_t *license_list_src)
 	while ((license_entry_src = list_next(iter))) {
 		license_entry_dest = xmalloc(sizeof(licenses_t));
 		license_entry_dest->name = xstrdup(license_entry_src->name);
+		license_entry_dest->id = license_entry_src->id;
 		license_entry_dest->total = license_entry_src->total;
 		license_entry_dest->used = license_entry_src->used;
 		license_entry_dest->last_deficit =
@@ -759,8 +840,8 @@ extern int license_job_get(job_record_t *job_ptr, bool restore)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(cluster_license_list, _license_find_rec,
-			license_entry->name);
+		match = list_find_first(cluster_license_list, _license_find_id,
+					&license_entry->id);
 		if (match) {
 			match->used += license_entry->total;
 			license_entry->used += license_entry->total;
@@ -803,8 +884,8 @@ extern int license_job_return_to_list(job_record_t *job_ptr, list_t *license_lis
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = list_find_first(license_list, _license_find_id,
+					&license_entry->id);
 		if (match) {
 			if (match->used >= license_entry->total)
 				match->used -= license_entry->total;
@@ -856,8 +937,8 @@ extern bool license_list_overlap(list_t *list_1, list_t *list_2)
 
 	iter = list_iterator_create(list_1);
 	while ((license_entry = list_next(iter))) {
-		if (list_find_first(list_2, _license_find_rec,
-				    license_entry->name)) {
+		if (list_find_first(list_2, _license_find_id,
+				    &license_entry->id)) {
 			match = true;
 			break;
 		}
@@ -1037,54 +1118,27 @@ static void _pack_license(licenses_t *lic, buf_t *buffer,
 	}
 }
 
-static void _bf_license_free_rec(void *x)
-{
-	bf_license_t *entry = x;
-
-	if (!entry)
-		return;
-
-	xfree(entry->name);
-	xfree(entry);
-}
-
 /*
- * Will never match on a reserved license.
+ * Find the entry for a license in a backfill license array. Entries locked to
+ * a reservation are only matched when looking for that reservation, the
+ * newest one wins as they are appended by slurm_bf_licenses_transfer().
  */
-static int _bf_licenses_find_rec(void *x, void *key)
+static bf_license_t *_bf_licenses_find(bf_licenses_t *licenses, uint32_t id,
+				       slurmctld_resv_t *resv_ptr)
 {
-	bf_license_t *license_entry = x;
-	char *name = key;
+	for (int i = licenses->cnt - 1; i >= 0; i--) {
+		bf_license_t *entry = &licenses->entries[i];
 
-	xassert(license_entry->name);
-	xassert(name);
-
-	if (license_entry->resv_ptr)
-		return 0;
-
-	if (!xstrcmp(license_entry->name, name))
-		return 1;
-
-	return 0;
-}
-
-static int _bf_licenses_find_resv(void *x, void *key)
-{
-	bf_license_t *license_entry = x;
-	bf_licenses_find_resv_t *target = key;
-
-	if (license_entry->resv_ptr != target->resv_ptr)
-		return 0;
-
-	if (xstrcmp(license_entry->name, target->name))
-		return 0;
+		if ((entry->id == id) && (entry->resv_ptr == resv_ptr))
+			return entry;
+	}
 
-	return 1;
+	return NULL;
 }
 
-extern list_t *bf_licenses_initial(bool bf_running_job_reserve)
+extern bf_licenses_t *bf_licenses_initial(bool bf_running_job_reserve)
 {
-	list_t *bf_list;
+	bf_licenses_t *bf_licenses;
 	list_itr_t *iter;
 	licenses_t *license_entry;
 	bf_license_t *bf_entry;
@@ -1092,68 +1146,70 @@ extern list_t *bf_licenses_initial(bool bf_running_job_reserve)
 	if (!cluster_license_list || !list_count(cluster_license_list))
 		return NULL;
 
-	bf_list = list_create(_bf_license_free_rec);
+	bf_licenses = xmalloc(sizeof(*bf_licenses));
+	bf_licenses->entries = xcalloc(list_count(cluster_license_list),
+				       sizeof(bf_license_t));
 
 	iter = list_iterator_create(cluster_license_list);
 	while ((license_entry = list_next(iter))) {
-		bf_entry = xmalloc(sizeof(*bf_entry));
-		bf_entry->name = xstrdup(license_entry->name);
+		bf_entry = &bf_licenses->entries[bf_licenses->cnt++];
+		bf_entry->id = license_entry->id;
 		bf_entry->remaining = license_entry->total;
 
 		if (!bf_running_job_reserve)
 			bf_entry->remaining -= license_entry->used;
-
-		list_push(bf_list, bf_entry);
 	}
 	list_iterator_destroy(iter);
 
-	return bf_list;
+	return bf_licenses;
 }
 
 extern char *bf_licenses_to_string(bf_licenses_t *licenses_list)
 {
 	char *sep = "";
 	char *licenses = NULL;
-	list_itr_t *iter;
-	bf_license_t *entry;
 
 	if (!licenses_list)
 		return NULL;
 
-	iter = list_iterator_create(licenses_list);
-	while ((entry = list_next(iter))) {
+	for (int i = 0; i < licenses_list->cnt; i++) {
+		bf_license_t *entry = &licenses_list->entries[i];
+
 		xstrfmtcat(licenses, "%s%s%s%s%s:%u",
 			   (entry->resv_ptr ? "resv=" : ""),
 			   (entry->resv_ptr ? entry->resv_ptr->name : ""),
 			   (entry->resv_ptr ? ":" : ""),
-			   sep, entry->name, entry->remaining);
+			   sep, _license_id_name(entry->id), entry->remaining);
 		sep = ",";
 	}
-	list_iterator_destroy(iter);
 
 	return licenses;
 }
 
+extern void bf_licenses_free(bf_licenses_t *licenses)
+{
+	if (!licenses)
+		return;
+
+	xfree(licenses->entries);
+	xfree(licenses);
+}
+
 extern bf_licenses_t *slurm_bf_licenses_copy(bf_licenses_t *licenses_src)
 {
-	bf_license_t *entry_src, *entry_dest;
-	list_itr_t *iter;
-	bf_licenses_t *licenses_dest = NULL;
+	bf_licenses_t *licenses_dest;
 
 	if (!licenses_src)
 		return NULL;
 
-	licenses_dest = list_create(_bf_license_free_rec);
-
-	iter = list_iterator_create(licenses_src);
-	while ((entry_src = list_next(iter))) {
-		entry_dest = xmalloc(sizeof(*entry_dest));
-		entry_dest->name = xstrdup(entry_src->name);
-		entry_dest->remaining = entry_src->remaining;
-		entry_dest->resv_ptr = entry_src->resv_ptr;
-		list_append(licenses_dest, entry_dest);
+	licenses_dest = xmalloc(sizeof(*licenses_dest));
+	licenses_dest->cnt = licenses_src->cnt;
+	if (licenses_src->cnt) {
+		licenses_dest->entries = xmalloc_nz(sizeof(bf_license_t) *
+						    licenses_src->cnt);
+		memcpy(licenses_dest->entries, licenses_src->entries,
+		       sizeof(bf_license_t) * licenses_src->cnt);
 	}
-	list_iterator_destroy(iter);
 
 	return licenses_dest;
 }
@@ -1180,14 +1236,8 @@ extern void slurm_bf_licenses_deduct(bf_licenses_t *licenses,
 		 * reservation first, then global as needed.
 		 */
 		if (job_ptr->resv_ptr) {
-			bf_licenses_find_resv_t target_record = {
-				.name = job_entry->name,
-				.resv_ptr = job_ptr->resv_ptr,
-			};
-
-			resv_entry = list_find_first(licenses,
-						     _bf_licenses_find_resv,
-						     &target_record);
+			resv_entry = _bf_licenses_find(licenses, job_entry->id,
+						       job_ptr->resv_ptr);
 			if (resv_entry && (needed <= resv_entry->remaining)) {
 				resv_entry->remaining -= needed;
 				continue;
@@ -1197,14 +1247,13 @@ extern void slurm_bf_licenses_deduct(bf_licenses_t *licenses,
 			}
 		}
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   job_entry->name);
+		bf_entry = _bf_licenses_find(licenses, job_entry->id, NULL);
 
 		if (!bf_entry) {
 			error("%s: missing license %s",
 			      __func__, job_entry->name);
 		} else if (bf_entry->remaining < needed) {
-			error("%s: underflow on %s", __func__, bf_entry->name);
+			error("%s: underflow on %s", __func__, job_entry->name);
 			bf_entry->remaining = 0;
 		} else {
 			bf_entry->remaining -= needed;
@@ -1235,14 +1284,13 @@ extern void slurm_bf_licenses_transfer(bf_licenses_t *licenses,
 		int needed = resv_entry->total;
 		int reservable = resv_entry->total;
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   resv_entry->name);
+		bf_entry = _bf_licenses_find(licenses, resv_entry->id, NULL);
 
 		if (!bf_entry) {
 			error("%s: missing license %s",
 			      __func__, resv_entry->name);
 		} else if (bf_entry->remaining < needed) {
-			error("%s: underflow on %s", __func__, bf_entry->name);
+			error("%s: underflow on %s", __func__, resv_entry->name);
 			reservable = bf_entry->remaining;
 			bf_entry->remaining = 0;
 		} else {
@@ -1250,12 +1298,12 @@ extern void slurm_bf_licenses_transfer(bf_licenses_t *licenses,
 			reservable = needed;
 		}
 
-		new_entry = xmalloc(sizeof(*new_entry));
-		new_entry->name = xstrdup(resv_entry->name);
+		xrecalloc(licenses->entries, licenses->cnt + 1,
+			  sizeof(bf_license_t));
+		new_entry = &licenses->entries[licenses->cnt++];
+		new_entry->id = resv_entry->id;
 		new_entry->remaining = reservable;
 		new_entry->resv_ptr = job_ptr->resv_ptr;
-
-		list_push(licenses, new_entry);
 	}
 	list_iterator_destroy(iter);
 }
@@ -1281,14 +1329,8 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 		 * reservation first, then global as needed.
 		 */
 		if (job_ptr->resv_ptr) {
-			bf_licenses_find_resv_t target_record = {
-				.name = need->name,
-				.resv_ptr = job_ptr->resv_ptr,
-			};
-
-			resv_entry = list_find_first(licenses,
-						     _bf_licenses_find_resv,
-						     &target_record);
+			resv_entry = _bf_licenses_find(licenses, need->id,
+						       job_ptr->resv_ptr);
 
 			if (resv_entry && (needed <= resv_entry->remaining))
 				continue;
@@ -1296,8 +1338,7 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 				needed -= resv_entry->remaining;
 		}
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   need->name);
+		bf_entry = _bf_licenses_find(licenses, need->id, NULL);
 
 		if (!bf_entry || (bf_entry->remaining < needed)) {
 			avail = false;
@@ -1311,22 +1352,15 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 
 extern bool slurm_bf_licenses_equal(bf_licenses_t *a, bf_licenses_t *b)
 {
-	bf_license_t *entry_a, *entry_b;
-	list_itr_t *iter;
-	bool equivalent = true;
+	for (int i = 0; i < a->cnt; i++) {
+		bf_license_t *entry_a = &a->entries[i], *entry_b;
 
-	iter = list_iterator_create(a);
-	while ((entry_a = list_next(iter))) {
-		entry_b = list_find_first(b, _bf_licenses_find_rec,
-					  entry_a->name);
+		entry_b = _bf_licenses_find(b, entry_a->id, NULL);
 
 		if (!entry_b || (entry_a->remaining != entry_b->remaining) ||
-		    (entry_a->resv_ptr != entry_b->resv_ptr)) {
-			equivalent = false;
-			break;
-		}
+		    (entry_a->resv_ptr != entry_b->resv_ptr))
+			return false;
 	}
-	list_iterator_destroy(iter);
 
-	return equivalent;
+	return true;
 }
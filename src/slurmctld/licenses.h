@@ -44,6 +44,7 @@
 
 typedef struct {
 	char *		name;		/* name associated with a license */
+	uint32_t	id;		/* dense id of name, for lookups */
 	uint32_t	total;		/* total license configued */
 	uint32_t	used;		/* used licenses */
 	uint32_t	reserved;	/* currently reserved licenses */
@@ -56,14 +57,21 @@ typedef struct {
 /*
  * In the future this should change to a more performant data structure.
  */
-typedef struct xlist bf_licenses_t;
-
 typedef struct {
-	char *name;
+	uint32_t id;			/* licenses_t id */
 	uint32_t remaining;
 	slurmctld_resv_t *resv_ptr;
 } bf_license_t;
 
+/*
+ * Licenses available in a backfill node_space record, kept as a flat array
+ * so that splitting a record is a single copy.
+ */
+typedef struct {
+	uint32_t cnt;
+	bf_license_t *entries;
+} bf_licenses_t;
+
 extern list_t *cluster_license_list;
 extern time_t last_license_update;
 
@@ -209,6 +217,8 @@ extern bf_licenses_t *bf_licenses_initial(bool bf_running_job_reserve);
 
 extern char *bf_licenses_to_string(bf_licenses_t *licenses_list);
 
+extern void bf_licenses_free(bf_licenses_t *licenses);
+
 /*
  * A NULL licenses argument to these functions indicates that backfill
  * license tracking support has been disabled, or that the system has no
@@ -236,6 +246,10 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 #define bf_licenses_equal(_x, _y) (_x ? slurm_bf_licenses_equal(_x, _y) : true)
 extern bool slurm_bf_licenses_equal(bf_licenses_t *a, bf_licenses_t *b);
 
-#define FREE_NULL_BF_LICENSES(_x) FREE_NULL_LIST(_x)
+#define FREE_NULL_BF_LICENSES(_x)		\
+	do {					\
+		bf_licenses_free(_x);		\
+		_x = NULL;			\
+	} while (0)
 
 #endif /* !_LICENSES_H */
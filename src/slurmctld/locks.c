@@ -41,12 +41,55 @@
 #include <pthread.h>
 #include <string.h>
 #include <sys/types.h>
+#include <time.h>
+
+#include "src/common/usdt.h"
+#include "src/common/xstring.h"
 
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
+/* read and write counters for each lock_datatype_t */
+#define LOCK_STATS_CNT		(LOCK_DATATYPE_CNT * 2)
+/* <10us, <100us, <1ms, <10ms, <100ms, <1s, >=1s */
+#define LOCK_STATS_HIST_CNT	7
+/* must be a power of 2 */
+#define LOCK_STATS_CALLER_SIZE	256
+/* lock_level_t of conf, job, node, part and fed, one per byte */
+#define LOCK_PROBE_LEVELS(l) \
+	((uint64_t) (l).conf | ((uint64_t) (l).job << 8) | \
+	 ((uint64_t) (l).node << 16) | ((uint64_t) (l).part << 24) | \
+	 ((uint64_t) (l).fed << 32))
+
+typedef struct {
+	const char *caller;	/* __func__ of lock_slurmctld() caller */
+	uint32_t cnt;
+	uint64_t wait_time;	/* usec */
+	uint64_t wait_max;	/* usec */
+	uint64_t hold_time;	/* usec */
+} lock_caller_stats_t;
+
 static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static bool lock_stats_enabled = false;
+static pthread_mutex_t lock_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t lock_cnt[LOCK_STATS_CNT];
+static uint64_t lock_wait_time[LOCK_STATS_CNT];
+static uint64_t lock_wait_max[LOCK_STATS_CNT];
+static uint64_t lock_hold_time[LOCK_STATS_CNT];
+static uint64_t lock_hold_max[LOCK_STATS_CNT];
+static uint32_t lock_wait_hist[LOCK_STATS_CNT * LOCK_STATS_HIST_CNT];
+static lock_caller_stats_t lock_caller[LOCK_STATS_CALLER_SIZE];
+
+/*
+ * State of the locks held by this thread, used to compute hold times in
+ * unlock_slurmctld(). lock_slurmctld() can not be nested within a thread.
+ */
+static __thread bool lock_stats_active = false;
+static __thread const char *lock_stats_caller = NULL;
+static __thread uint64_t lock_stats_locked = 0;
+static __thread uint64_t lock_stats_acquired[LOCK_DATATYPE_CNT];
+
 static pthread_rwlock_t slurmctld_locks[5] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
@@ -108,57 +151,164 @@ extern bool verify_lock(lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+static uint64_t _lock_stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * USEC_IN_SEC) + (ts.tv_nsec / NSEC_IN_USEC);
+}
+
+static int _lock_stats_inx(lock_datatype_t datatype, lock_level_t level)
+{
+	return ((datatype * 2) + ((level == WRITE_LOCK) ? 1 : 0));
+}
+
+static lock_caller_stats_t *_lock_stats_caller(const char *caller)
+{
+	uint32_t inx = ((uintptr_t) caller >> 3) & (LOCK_STATS_CALLER_SIZE - 1);
+
+	for (int i = 0; i < LOCK_STATS_CALLER_SIZE; i++) {
+		lock_caller_stats_t *stats = &lock_caller[inx];
+
+		if (stats->caller == caller)
+			return stats;
+		if (!stats->caller) {
+			stats->caller = caller;
+			return stats;
+		}
+		inx = (inx + 1) & (LOCK_STATS_CALLER_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+/* Acquire one lock, return time spent waiting for it in usec */
+static uint64_t _lock_one(lock_datatype_t datatype, lock_level_t level)
+{
+	uint64_t begin = 0, end;
+	int inx, hist;
+
+	if (level == NO_LOCK)
+		return 0;
+
+	if (lock_stats_active)
+		begin = _lock_stats_now();
+
+	if (level == READ_LOCK)
+		slurm_rwlock_rdlock(&slurmctld_locks[datatype]);
+	else
+		slurm_rwlock_wrlock(&slurmctld_locks[datatype]);
+
+	if (!lock_stats_active)
+		return 0;
+
+	end = _lock_stats_now();
+	lock_stats_acquired[datatype] = end;
+
+	inx = _lock_stats_inx(datatype, level);
+	for (hist = 0; hist < (LOCK_STATS_HIST_CNT - 1); hist++) {
+		static const uint64_t limit[LOCK_STATS_HIST_CNT - 1] = {
+			10, 100, 1000, 10000, 100000, 1000000
+		};
+		if ((end - begin) < limit[hist])
+			break;
+	}
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	lock_cnt[inx]++;
+	lock_wait_time[inx] += end - begin;
+	lock_wait_max[inx] = MAX(lock_wait_max[inx], end - begin);
+	lock_wait_hist[(inx * LOCK_STATS_HIST_CNT) + hist]++;
+	slurm_mutex_unlock(&lock_stats_mutex);
+
+	return (end - begin);
+}
+
+/* Release one lock, record time it was held */
+static void _unlock_one(lock_datatype_t datatype, lock_level_t level,
+			uint64_t now)
+{
+	if (level == NO_LOCK)
+		return;
+
+	slurm_rwlock_unlock(&slurmctld_locks[datatype]);
+
+	if (lock_stats_active) {
+		int inx = _lock_stats_inx(datatype, level);
+		uint64_t hold = now - lock_stats_acquired[datatype];
+
+		slurm_mutex_lock(&lock_stats_mutex);
+		lock_hold_time[inx] += hold;
+		lock_hold_max[inx] = MAX(lock_hold_max[inx], hold);
+		slurm_mutex_unlock(&lock_stats_mutex);
+	}
+}
+
 /* lock_slurmctld - Issue the required lock requests in a well defined order */
-extern void lock_slurmctld(slurmctld_lock_t lock_levels)
+extern void lock_slurmctld_caller(slurmctld_lock_t lock_levels,
+				  const char *caller)
 {
+	uint64_t wait = 0;
+
 	xassert(_store_locks(lock_levels));
 
-	if (lock_levels.conf == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[CONF_LOCK]);
-	else if (lock_levels.conf == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[CONF_LOCK]);
+	SLURM_PROBE2(lock_acquire, LOCK_PROBE_LEVELS(lock_levels), caller);
+
+	lock_stats_active = lock_stats_enabled;
 
-	if (lock_levels.job == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[JOB_LOCK]);
-	else if (lock_levels.job == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[JOB_LOCK]);
+	wait += _lock_one(CONF_LOCK, lock_levels.conf);
+	wait += _lock_one(JOB_LOCK, lock_levels.job);
+	wait += _lock_one(NODE_LOCK, lock_levels.node);
+	wait += _lock_one(PART_LOCK, lock_levels.part);
+	wait += _lock_one(FED_LOCK, lock_levels.fed);
 
-	if (lock_levels.node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[NODE_LOCK]);
-	else if (lock_levels.node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[NODE_LOCK]);
+	SLURM_PROBE2(lock_acquired, LOCK_PROBE_LEVELS(lock_levels), caller);
 
-	if (lock_levels.part == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[PART_LOCK]);
-	else if (lock_levels.part == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[PART_LOCK]);
+	if (lock_stats_active) {
+		lock_caller_stats_t *stats;
 
-	if (lock_levels.fed == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[FED_LOCK]);
-	else if (lock_levels.fed == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[FED_LOCK]);
+		lock_stats_caller = caller;
+		lock_stats_locked = _lock_stats_now();
+
+		slurm_mutex_lock(&lock_stats_mutex);
+		if ((stats = _lock_stats_caller(caller))) {
+			stats->cnt++;
+			stats->wait_time += wait;
+			stats->wait_max = MAX(stats->wait_max, wait);
+		}
+		slurm_mutex_unlock(&lock_stats_mutex);
+	}
 }
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
  *	defined order */
 extern void unlock_slurmctld(slurmctld_lock_t lock_levels)
 {
+	uint64_t now = 0;
+
 	xassert(_clear_locks(lock_levels));
 
-	if (lock_levels.fed)
-		slurm_rwlock_unlock(&slurmctld_locks[FED_LOCK]);
+	SLURM_PROBE1(lock_release, LOCK_PROBE_LEVELS(lock_levels));
 
-	if (lock_levels.part)
-		slurm_rwlock_unlock(&slurmctld_locks[PART_LOCK]);
+	if (lock_stats_active) {
+		lock_caller_stats_t *stats;
 
-	if (lock_levels.node)
-		slurm_rwlock_unlock(&slurmctld_locks[NODE_LOCK]);
+		now = _lock_stats_now();
 
-	if (lock_levels.job)
-		slurm_rwlock_unlock(&slurmctld_locks[JOB_LOCK]);
+		slurm_mutex_lock(&lock_stats_mutex);
+		if ((stats = _lock_stats_caller(lock_stats_caller)))
+			stats->hold_time += now - lock_stats_locked;
+		slurm_mutex_unlock(&lock_stats_mutex);
+	}
+
+	_unlock_one(FED_LOCK, lock_levels.fed, now);
+	_unlock_one(PART_LOCK, lock_levels.part, now);
+	_unlock_one(NODE_LOCK, lock_levels.node, now);
+	_unlock_one(JOB_LOCK, lock_levels.job, now);
+	_unlock_one(CONF_LOCK, lock_levels.conf, now);
 
-	if (lock_levels.conf)
-		slurm_rwlock_unlock(&slurmctld_locks[CONF_LOCK]);
+	lock_stats_active = false;
 }
 
 /*
@@ -215,3 +365,67 @@ extern void unlock_state_files(void)
 {
 	slurm_mutex_unlock(&state_mutex);
 }
+
+extern void lock_stats_config(void)
+{
+	bool enabled = xstrcasestr(slurm_conf.slurmctld_params,
+				   "enable_lock_stats");
+
+	if (enabled && !lock_stats_enabled)
+		lock_stats_reset();
+	lock_stats_enabled = enabled;
+}
+
+extern void lock_stats_pack(buf_t *buffer)
+{
+	char *caller_name[LOCK_STATS_CALLER_SIZE];
+	uint32_t caller_cnt[LOCK_STATS_CALLER_SIZE];
+	uint64_t caller_wait_time[LOCK_STATS_CALLER_SIZE];
+	uint64_t caller_wait_max[LOCK_STATS_CALLER_SIZE];
+	uint64_t caller_hold_time[LOCK_STATS_CALLER_SIZE];
+	uint32_t callers = 0;
+
+	pack8(lock_stats_enabled, buffer);
+	if (!lock_stats_enabled)
+		return;
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	pack32_array(lock_cnt, LOCK_STATS_CNT, buffer);
+	pack64_array(lock_wait_time, LOCK_STATS_CNT, buffer);
+	pack64_array(lock_wait_max, LOCK_STATS_CNT, buffer);
+	pack64_array(lock_hold_time, LOCK_STATS_CNT, buffer);
+	pack64_array(lock_hold_max, LOCK_STATS_CNT, buffer);
+	pack32_array(lock_wait_hist, LOCK_STATS_CNT * LOCK_STATS_HIST_CNT,
+		     buffer);
+
+	for (int i = 0; i < LOCK_STATS_CALLER_SIZE; i++) {
+		if (!lock_caller[i].caller)
+			continue;
+		caller_name[callers] = (char *) lock_caller[i].caller;
+		caller_cnt[callers] = lock_caller[i].cnt;
+		caller_wait_time[callers] = lock_caller[i].wait_time;
+		caller_wait_max[callers] = lock_caller[i].wait_max;
+		caller_hold_time[callers] = lock_caller[i].hold_time;
+		callers++;
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+
+	packstr_array(caller_name, callers, buffer);
+	pack32_array(caller_cnt, callers, buffer);
+	pack64_array(caller_wait_time, callers, buffer);
+	pack64_array(caller_wait_max, callers, buffer);
+	pack64_array(caller_hold_time, callers, buffer);
+}
+
+extern void lock_stats_reset(void)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	memset(lock_cnt, 0, sizeof(lock_cnt));
+	memset(lock_wait_time, 0, sizeof(lock_wait_time));
+	memset(lock_wait_max, 0, sizeof(lock_wait_max));
+	memset(lock_hold_time, 0, sizeof(lock_hold_time));
+	memset(lock_hold_max, 0, sizeof(lock_hold_max));
+	memset(lock_wait_hist, 0, sizeof(lock_wait_hist));
+	memset(lock_caller, 0, sizeof(lock_caller));
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
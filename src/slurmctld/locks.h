@@ -93,6 +93,8 @@
 
 #include <stdbool.h>
 
+#include "src/common/pack.h"
+
 /* levels of locking required for each data structure */
 typedef enum {
 	NO_LOCK,
@@ -115,6 +117,7 @@ typedef enum {
 	NODE_LOCK,
 	PART_LOCK,
 	FED_LOCK,
+	LOCK_DATATYPE_CNT
 }	lock_datatype_t;
 
 #ifndef NDEBUG
@@ -122,7 +125,10 @@ extern bool verify_lock(lock_datatype_t datatype, lock_level_t level);
 #endif
 
 /* lock_slurmctld - Issue the required lock requests in a well defined order */
-extern void lock_slurmctld (slurmctld_lock_t lock_levels);
+#define lock_slurmctld(lock_levels) \
+	lock_slurmctld_caller(lock_levels, __func__)
+extern void lock_slurmctld_caller(slurmctld_lock_t lock_levels,
+				  const char *caller);
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
  *	defined order */
@@ -130,6 +136,18 @@ extern void unlock_slurmctld (slurmctld_lock_t lock_levels);
 
 extern int report_locks_set(void);
 
+/*
+ * Enable or disable collection of lock wait and hold times
+ * (SlurmctldParameters=enable_lock_stats)
+ */
+extern void lock_stats_config(void);
+
+/* Pack lock wait and hold time statistics for sdiag */
+extern void lock_stats_pack(buf_t *buffer);
+
+/* Reset lock wait and hold time statistics */
+extern void lock_stats_reset(void);
+
 /* un/lock semaphore used for saving state of slurmctld */
 extern void lock_state_files ( void );
 extern void unlock_state_files ( void );
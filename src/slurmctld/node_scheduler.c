@@ -59,6 +59,7 @@
 #include "src/common/job_features.h"
 #include "src/common/list.h"
 #include "src/common/port_mgr.h"
+#include "src/common/sched_trace.h"
 #include "src/common/slurm_protocol_pack.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
@@ -533,6 +534,9 @@ static void _log_feature_nodes(job_feature_t  *job_feat_ptr)
  * For every element in the feature_list, identify the nodes with that feature
  * either active or available and set the feature_list's node_bitmap_active and
  * node_bitmap_avail fields accordingly.
+ *
+ * The bitmaps are kept on the job's feature_list between scheduling passes and
+ * only rebuilt once the node feature lists change (see feature_list_gen).
  */
 extern void find_feature_nodes(list_t *feature_list, bool can_reboot)
 {
@@ -544,6 +548,14 @@ extern void find_feature_nodes(list_t *feature_list, bool can_reboot)
 		return;
 	feat_iter = list_iterator_create(feature_list);
 	while ((job_feat_ptr = list_next(feat_iter))) {
+		bool use_avail = can_reboot && job_feat_ptr->changeable;
+
+		if ((job_feat_ptr->node_bitmap_gen == feature_list_gen) &&
+		    (job_feat_ptr->node_bitmap_reboot == use_avail) &&
+		    job_feat_ptr->node_bitmap_active &&
+		    job_feat_ptr->node_bitmap_avail)
+			continue;
+
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_active);
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_avail);
 		node_feat_ptr = list_find_first(active_feature_list,
@@ -556,7 +568,7 @@ extern void find_feature_nodes(list_t *feature_list, bool can_reboot)
 			job_feat_ptr->node_bitmap_active =
 				bit_alloc(node_record_count);
 		}
-		if (can_reboot && job_feat_ptr->changeable) {
+		if (use_avail) {
 			node_feat_ptr = list_find_first(avail_feature_list,
 							list_find_feature,
 							job_feat_ptr->name);
@@ -571,6 +583,8 @@ extern void find_feature_nodes(list_t *feature_list, bool can_reboot)
 			job_feat_ptr->node_bitmap_avail =
 				bit_copy(job_feat_ptr->node_bitmap_active);
 		}
+		job_feat_ptr->node_bitmap_gen = feature_list_gen;
+		job_feat_ptr->node_bitmap_reboot = use_avail;
 
 		_log_feature_nodes(job_feat_ptr);
 	}
@@ -3076,6 +3090,17 @@ extern int select_nodes(job_record_t *job_ptr, bool test_only,
 	}
 
 cleanup:
+	if (sched_trace_active) {
+		uint32_t nodes_tested = 0;
+
+		for (i = 0; i < node_set_size; i++)
+			nodes_tested += node_set_ptr[i].node_cnt;
+		sched_trace_add(SCHED_TRACE_SELECT,
+				(test_only ? SCHED_TRACE_FLAG_TEST_ONLY : 0),
+				job_ptr->job_id, part_ptr->name, error_code,
+				nodes_tested);
+	}
+
 	if (job_ptr->array_recs && job_ptr->array_recs->task_id_bitmap &&
 	    !IS_JOB_STARTED(job_ptr) &&
 	    (bit_ffs(job_ptr->array_recs->task_id_bitmap) != -1)) {
@@ -3271,8 +3296,11 @@ extern void launch_prolog(job_record_t *job_ptr)
 	prolog_msg_ptr->het_job_id = job_ptr->het_job_id;
 	prolog_msg_ptr->uid = job_ptr->user_id;
 	prolog_msg_ptr->gid = job_ptr->group_id;
-	if (!job_ptr->user_name)
-		job_ptr->user_name = user_from_job(job_ptr);
+	if (!job_ptr->user_name) {
+		char *user_name = user_from_job(job_ptr);
+		job_ptr->user_name = job_record_str_intern(user_name);
+		xfree(user_name);
+	}
 	prolog_msg_ptr->user_name_deprecated = xstrdup(job_ptr->user_name);
 	prolog_msg_ptr->alias_list = xstrdup(job_ptr->alias_list);
 	prolog_msg_ptr->nodes = xstrdup(job_ptr->nodes);
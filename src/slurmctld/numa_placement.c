@@ -0,0 +1,135 @@
+/*****************************************************************************\
+ *  numa_placement.c - NUMA placement of slurmctld threads
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#ifdef HAVE_NUMA
+#  include <numa.h>
+#endif
+
+#include "src/common/log.h"
+#include "src/common/read_config.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/slurmctld/numa_placement.h"
+
+#ifdef HAVE_NUMA
+static nodemask_t sched_mask;
+static bool sched_mask_set = false;
+
+static bool _parse_nodes(const char *option, const char *str,
+			 nodemask_t *mask)
+{
+	struct bitmask *bitmask;
+
+	if (!(bitmask = numa_parse_nodestring(str))) {
+		error("Invalid SlurmctldParameters %s%s", option, str);
+		return false;
+	}
+
+	copy_bitmask_to_nodemask(bitmask, mask);
+	numa_bitmask_free(bitmask);
+	return true;
+}
+#endif
+
+extern void numa_placement_init(void)
+{
+	char *rpc_nodes, *sched_nodes;
+	bool interleave;
+
+	rpc_nodes = conf_get_opt_str(slurm_conf.slurmctld_params,
+				     "numa_rpc_nodes=");
+	sched_nodes = conf_get_opt_str(slurm_conf.slurmctld_params,
+				       "numa_sched_nodes=");
+	interleave = xstrcasestr(slurm_conf.slurmctld_params,
+				 "numa_interleave");
+
+	if (!rpc_nodes && !sched_nodes && !interleave)
+		return;
+
+#ifdef HAVE_NUMA
+	if (numa_available() < 0) {
+		error("SlurmctldParameters NUMA placement ignored, NUMA is not available on this host");
+		goto fini;
+	}
+
+	if (rpc_nodes) {
+		nodemask_t mask;
+
+		if (_parse_nodes("numa_rpc_nodes=", rpc_nodes, &mask)) {
+			if (numa_run_on_node_mask(&mask))
+				error("Unable to run on NUMA nodes %s: %m",
+				      rpc_nodes);
+			else
+				info("NUMA placement: threads run on NUMA nodes %s",
+				     rpc_nodes);
+		}
+	}
+
+	if (interleave) {
+		numa_set_interleave_mask(&numa_all_nodes);
+		info("NUMA placement: interleaving memory across all NUMA nodes");
+	}
+
+	if (sched_nodes &&
+	    (sched_mask_set = _parse_nodes("numa_sched_nodes=", sched_nodes,
+					   &sched_mask)))
+		info("NUMA placement: scheduler threads run on NUMA nodes %s",
+		     sched_nodes);
+
+fini:
+#else
+	error("SlurmctldParameters NUMA placement ignored, slurmctld was built without libnuma");
+#endif
+	xfree(rpc_nodes);
+	xfree(sched_nodes);
+}
+
+extern void numa_placement_sched_thread(void)
+{
+#ifdef HAVE_NUMA
+	if (!sched_mask_set)
+		return;
+
+	if (numa_run_on_node_mask(&sched_mask))
+		error("%s: Unable to run on scheduler NUMA nodes: %m",
+		      __func__);
+
+	/* Allocate on the node the thread now runs on, even if interleaving */
+	numa_set_localalloc();
+#endif
+}
@@ -0,0 +1,60 @@
+/*****************************************************************************\
+ *  numa_placement.h - NUMA placement of slurmctld threads
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SLURMCTLD_NUMA_PLACEMENT_H
+#define _SLURMCTLD_NUMA_PLACEMENT_H
+
+/*
+ * Optional NUMA placement configured with SlurmctldParameters:
+ *	numa_rpc_nodes=<nodes>   - NUMA nodes for every thread other than the
+ *				   schedulers (RPC, agent, state save, ...)
+ *	numa_sched_nodes=<nodes> - NUMA nodes for the main scheduler and
+ *				   backfill threads and their allocations
+ *	numa_interleave		 - interleave the memory allocated by threads
+ *				   other than the schedulers across all nodes
+ *
+ * Linux threads inherit the CPU affinity and memory policy of the thread that
+ * creates them, so numa_placement_init() must be called from the main thread
+ * before any other thread is started.
+ */
+extern void numa_placement_init(void);
+
+/*
+ * Move the calling scheduler thread onto numa_sched_nodes and use local
+ * allocation for it. Does nothing if numa_sched_nodes is not configured.
+ */
+extern void numa_placement_sched_thread(void);
+
+#endif
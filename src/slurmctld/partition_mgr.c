@@ -79,6 +79,9 @@
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define PART_STATE_VERSION        "PROTOCOL_VERSION"
 
+/* Number of packed partition dumps kept for reuse by pack_all_part() */
+#define PART_DUMP_CACHE_SIZE 8
+
 typedef struct {
 	buf_t *buffer;
 	uint32_t parts_packed;
@@ -89,6 +92,13 @@ typedef struct {
 	part_record_t **visible_parts;
 } _foreach_pack_part_info_t;
 
+typedef struct {
+	buf_t *buffer;
+	time_t pack_time;
+	uint16_t protocol_version;
+	part_record_t **visible_parts; /* NULL if no partitions filtered */
+} part_dump_cache_t;
+
 /* Global variables */
 list_t *part_list = NULL;		/* partition list */
 char *default_part_name = NULL;		/* name of default partition */
@@ -96,6 +106,14 @@ part_record_t *default_part_loc = NULL;	/* default partition location */
 time_t last_part_update = (time_t) 0;	/* time of last update to partition records */
 uint16_t part_max_priority = DEF_PART_MAX_PRIORITY;
 
+/*
+ * Partition dumps are requested under the partition read lock, so several
+ * RPCs may use the cache at once.
+ */
+static pthread_mutex_t part_dump_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static part_dump_cache_t part_dump_cache[PART_DUMP_CACHE_SIZE];
+static int part_dump_cache_next = 0;
+
 static int    _dump_part_state(void *x, void *arg);
 static void   _list_delete_part(void *part_entry);
 static int    _match_part_ptr(void *part_ptr, void *key);
@@ -977,6 +995,95 @@ static int _pack_part(void *object, void *arg)
 	return SLURM_SUCCESS;
 }
 
+static bool _same_visible_parts(part_record_t **x, part_record_t **y)
+{
+	if (!x || !y)
+		return (x == y);
+
+	for (int i = 0; x[i] || y[i]; i++) {
+		if (x[i] != y[i])
+			return false;
+	}
+
+	return true;
+}
+
+static void _free_part_dump_cache_entry(part_dump_cache_t *entry)
+{
+	FREE_NULL_BUFFER(entry->buffer);
+	xfree(entry->visible_parts);
+	entry->pack_time = 0;
+	entry->protocol_version = 0;
+}
+
+/*
+ * Return a copy of a cached dump matching the request or NULL.
+ * A dump is only reused if it was packed in a later second than the last
+ * partition update, so an update within the same second as the pack can
+ * never be missed.
+ */
+static buf_t *_get_cached_part_dump(part_record_t **visible_parts,
+				    uint16_t protocol_version)
+{
+	buf_t *buffer = NULL;
+
+	slurm_mutex_lock(&part_dump_cache_mutex);
+	for (int i = 0; i < PART_DUMP_CACHE_SIZE; i++) {
+		part_dump_cache_t *entry = &part_dump_cache[i];
+		uint32_t size;
+
+		if (!entry->buffer)
+			continue;
+		if (entry->pack_time <= last_part_update) {
+			_free_part_dump_cache_entry(entry);
+			continue;
+		}
+		if ((entry->protocol_version != protocol_version) ||
+		    !_same_visible_parts(entry->visible_parts, visible_parts))
+			continue;
+
+		size = get_buf_offset(entry->buffer);
+		buffer = init_buf(size);
+		memcpy(get_buf_data(buffer), get_buf_data(entry->buffer), size);
+		set_buf_offset(buffer, size);
+		break;
+	}
+	slurm_mutex_unlock(&part_dump_cache_mutex);
+
+	return buffer;
+}
+
+/* Save a copy of a freshly packed dump, taking ownership of visible_parts */
+static void _cache_part_dump(buf_t *buffer, time_t pack_time,
+			     part_record_t **visible_parts,
+			     uint16_t protocol_version)
+{
+	part_dump_cache_t *entry;
+	uint32_t size = get_buf_offset(buffer);
+
+	slurm_mutex_lock(&part_dump_cache_mutex);
+	entry = &part_dump_cache[part_dump_cache_next];
+	part_dump_cache_next = (part_dump_cache_next + 1) % PART_DUMP_CACHE_SIZE;
+
+	_free_part_dump_cache_entry(entry);
+	entry->buffer = init_buf(size);
+	memcpy(get_buf_data(entry->buffer), get_buf_data(buffer), size);
+	set_buf_offset(entry->buffer, size);
+	entry->pack_time = pack_time;
+	entry->protocol_version = protocol_version;
+	entry->visible_parts = visible_parts;
+	slurm_mutex_unlock(&part_dump_cache_mutex);
+}
+
+static void _purge_part_dump_cache(void)
+{
+	slurm_mutex_lock(&part_dump_cache_mutex);
+	for (int i = 0; i < PART_DUMP_CACHE_SIZE; i++)
+		_free_part_dump_cache_entry(&part_dump_cache[i]);
+	part_dump_cache_next = 0;
+	slurm_mutex_unlock(&part_dump_cache_mutex);
+}
+
 /*
  * pack_all_part - dump all partition information for all partitions in
  *	machine independent form (for network transmission)
@@ -985,6 +1092,9 @@ static int _pack_part(void *object, void *arg)
  * global: part_list - global list of partition records
  * OUT buffer
  * NOTE: change slurm_load_part() in api/part_info.c if data format changes
+ * NOTE: the dump only depends upon the set of partitions visible to the user,
+ *	so users sharing that set are served copies of the same cached dump
+ *	until the next partition update.
  */
 extern buf_t *pack_all_part(uint16_t show_flags, uid_t uid,
 			    uint16_t protocol_version)
@@ -993,15 +1103,23 @@ extern buf_t *pack_all_part(uint16_t show_flags, uid_t uid,
 	time_t now = time(NULL);
 	bool privileged = validate_operator(uid);
 	_foreach_pack_part_info_t pack_info = {
-		.buffer = init_buf(BUF_SIZE),
 		.parts_packed = 0,
 		.privileged = privileged,
 		.protocol_version = protocol_version,
 		.show_flags = show_flags,
 		.uid = uid,
-		.visible_parts = build_visible_parts(uid, privileged),
+		.visible_parts = build_visible_parts(
+			uid, (privileged || (show_flags & SHOW_ALL))),
 	};
 
+	if ((pack_info.buffer = _get_cached_part_dump(pack_info.visible_parts,
+						      protocol_version))) {
+		xfree(pack_info.visible_parts);
+		return pack_info.buffer;
+	}
+
+	pack_info.buffer = init_buf(BUF_SIZE);
+
 	/* write header: version and time */
 	pack32(0, pack_info.buffer);
 	pack_time(now, pack_info.buffer);
@@ -1014,7 +1132,8 @@ extern buf_t *pack_all_part(uint16_t show_flags, uid_t uid,
 	pack32(pack_info.parts_packed, pack_info.buffer);
 	set_buf_offset(pack_info.buffer, tmp_offset);
 
-	xfree(pack_info.visible_parts);
+	_cache_part_dump(pack_info.buffer, now, pack_info.visible_parts,
+			 protocol_version);
 	return pack_info.buffer;
 }
 
@@ -1859,10 +1978,9 @@ extern int validate_group(part_record_t *part_ptr, uid_t run_uid)
 	if (!part_ptr->allow_uids_cnt)
 		return 0;
 
-	for (int i = 0; i < part_ptr->allow_uids_cnt; i++) {
-		if (part_ptr->allow_uids[i] == run_uid)
-			return 1;
-	}
+	if (uid_in_list(run_uid, part_ptr->allow_uids,
+			part_ptr->allow_uids_cnt))
+		return 1;
 
 	/* If this user has failed AllowGroups permission check on this
 	 * partition in past 5 seconds, then do not test again for performance
@@ -1929,6 +2047,8 @@ extern int validate_group(part_record_t *part_ptr, uid_t run_uid)
 				 (sizeof(uid_t) *
 				  (part_ptr->allow_uids_cnt + 1)));
 		part_ptr->allow_uids[part_ptr->allow_uids_cnt++] = run_uid;
+		/* Keep allow_uids sorted for uid_in_list() */
+		sort_uid_list(part_ptr->allow_uids, part_ptr->allow_uids_cnt);
 	}
 
 fini:	if (ret == 0) {
@@ -2050,6 +2170,7 @@ void part_fini (void)
 {
 	FREE_NULL_LIST(part_list);
 	default_part_loc = NULL;
+	_purge_part_dump_cache();
 }
 
 extern int delete_partition(delete_part_msg_t *part_desc_ptr)
@@ -417,6 +417,7 @@ static void _do_power_work(time_t now)
 	uint32_t susp_state;
 	bitstr_t *avoid_node_bitmap = NULL, *failed_node_bitmap = NULL;
 	bitstr_t *wake_node_bitmap = NULL, *sleep_node_bitmap = NULL;
+	bitstr_t *scan_node_bitmap;
 	node_record_t *node_ptr;
 	data_t *resume_json_data = NULL;
 	data_t *jobs_data = NULL;
@@ -547,8 +548,21 @@ static void _do_power_work(time_t now)
 		FREE_NULL_BITMAP(to_resume_bitmap);
 	}
 
+	/*
+	 * Only nodes that are idle, unavailable (down, drained or changing
+	 * power state), powered down or booting can change state below.
+	 * Allocated nodes make up most of a busy cluster, so skip them with
+	 * bitmap operations rather than testing every node record.
+	 */
+	scan_node_bitmap = bit_copy(avail_node_bitmap);
+	bit_not(scan_node_bitmap);
+	bit_or(scan_node_bitmap, idle_node_bitmap);
+	bit_or(scan_node_bitmap, power_down_node_bitmap);
+	bit_or(scan_node_bitmap, booting_node_bitmap);
+	bit_or(scan_node_bitmap, job_power_node_bitmap);
+
 	/* Build bitmaps identifying each node which should change state */
-	for (i = 0; (node_ptr = next_node(&i)); i++) {
+	for (i = 0; (node_ptr = next_node_bitmap(scan_node_bitmap, &i)); i++) {
 		susp_state = IS_NODE_POWERED_DOWN(node_ptr);
 
 		if (susp_state)
@@ -717,6 +731,7 @@ static void _do_power_work(time_t now)
 			nodes_updated = true;
 		}
 	}
+	FREE_NULL_BITMAP(scan_node_bitmap);
 	FREE_NULL_BITMAP(avoid_node_bitmap);
 	if (power_save_debug && ((now - last_log) > 600) && (susp_total > 0)) {
 		log_flag(POWER, "Power save mode: %d nodes", susp_total);
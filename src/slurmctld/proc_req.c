@@ -64,10 +64,13 @@
 #include "src/common/macros.h"
 #include "src/common/pack.h"
 #include "src/common/persist_conn.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/read_config.h"
+#include "src/common/sched_trace.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_pack.h"
 #include "src/common/slurm_protocol_socket.h"
+#include "src/common/usdt.h"
 #include "src/common/xstring.h"
 
 #include "src/interfaces/acct_gather.h"
@@ -125,6 +128,9 @@ static uint16_t rpc_type_cycle_max[RPC_TYPE_SIZE] = { 0 };
 static uint32_t rpc_user_id[RPC_USER_SIZE] = { 0 };
 static uint32_t rpc_user_cnt[RPC_USER_SIZE] = { 0 };
 static uint64_t rpc_user_time[RPC_USER_SIZE] = { 0 };
+/* Processing time histograms, see rpc_hist_percentile() for the layout */
+static uint32_t rpc_type_hist[RPC_TYPE_SIZE * RPC_HIST_CNT] = { 0 };
+static uint32_t rpc_user_hist[RPC_USER_SIZE * RPC_HIST_CNT] = { 0 };
 
 static bool do_post_rpc_node_registration = false;
 
@@ -158,6 +164,8 @@ typedef struct {
 
 extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 {
+	int bucket = rpc_hist_bucket((delta > 0) ? delta : 0);
+
 	slurm_mutex_lock(&rpc_mutex);
 	for (int i = 0; i < RPC_TYPE_SIZE; i++) {
 		if (rpc_type_id[i] == 0)
@@ -166,6 +174,7 @@ extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 			continue;
 		rpc_type_cnt[i]++;
 		rpc_type_time[i] += delta;
+		rpc_type_hist[(i * RPC_HIST_CNT) + bucket]++;
 		break;
 	}
 	for (int i = 0; i < RPC_USER_SIZE; i++) {
@@ -175,6 +184,7 @@ extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 			continue;
 		rpc_user_cnt[i]++;
 		rpc_user_time[i] += delta;
+		rpc_user_hist[(i * RPC_HIST_CNT) + bucket]++;
 		break;
 	}
 	slurm_mutex_unlock(&rpc_mutex);
@@ -665,6 +675,20 @@ static int _valid_id(char *caller, job_desc_msg_t *msg, uid_t uid, gid_t gid,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Pack the response once so each REQUEST_CONFIG from a peer running the
+ * current protocol version is a copy of these bytes rather than a walk over
+ * every config file.
+ */
+static void _pre_pack_config(config_response_msg_t *config)
+{
+	buf_t *buffer = init_buf(BUF_SIZE);
+
+	pack_config_response_msg(config, buffer, SLURM_PROTOCOL_VERSION);
+	config->packed = buffer;
+	config->packed_version = SLURM_PROTOCOL_VERSION;
+}
+
 extern void configless_update(void)
 {
 	if (!xstrcasestr(slurm_conf.slurmctld_params, "enable_configless"))
@@ -678,7 +702,9 @@ extern void configless_update(void)
 
 	config_for_slurmd = new_config_response(true);
 	config_for_slurmd->slurmd_spooldir = xstrdup(slurm_conf.slurmd_spooldir);
+	_pre_pack_config(config_for_slurmd);
 	config_for_clients = new_config_response(false);
+	_pre_pack_config(config_for_clients);
 	slurm_rwlock_unlock(&configless_lock);
 }
 
@@ -1239,6 +1265,13 @@ static void _slurm_rpc_allocate_resources(slurm_msg_t *msg)
 		      msg->auth_uid);
 	}
 
+	if (error_code == SLURM_SUCCESS) {
+		job_desc_msg->het_job_offset = NO_VAL;
+		error_code = validate_job_create_req_unlocked(job_desc_msg,
+							      msg->auth_uid,
+							      &err_msg);
+	}
+
 	if (error_code == SLURM_SUCCESS) {
 		/* Locks are for job_submit plugin use */
 		lock_slurmctld(job_read_lock);
@@ -1421,6 +1454,31 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 		READ_LOCK, READ_LOCK, NO_LOCK, READ_LOCK, READ_LOCK };
 
 	START_TIMER;
+	/*
+	 * Polls for unchanged data (e.g. "squeue -i") do not need to queue on
+	 * the job lock behind pending writers. last_job_update only moves
+	 * forward, so reading it unlocked at worst answers as if the request
+	 * had arrived a moment earlier.
+	 */
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING) &&
+	    ((job_info_request_msg->last_update - 1) >= last_job_update)) {
+		debug3("%s, no change", __func__);
+		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
+		return;
+	}
+
+	if (!job_info_request_msg->job_ids &&
+	    (buffer = job_info_snapshot_get(job_info_request_msg->last_update,
+					    job_info_request_msg->show_flags,
+					    msg->auth_uid,
+					    msg->protocol_version))) {
+		END_TIMER2(__func__);
+		response_init(&response_msg, msg, RESPONSE_JOB_INFO, buffer);
+		slurm_send_node_msg(msg->conn_fd, &response_msg);
+		FREE_NULL_BUFFER(buffer);
+		return;
+	}
+
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 		lock_slurmctld(job_read_lock);
 
@@ -1435,10 +1493,21 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 						job_info_request_msg->show_flags,
 						msg->auth_uid, NO_VAL,
 						msg->protocol_version);
+		} else if ((job_info_request_msg->show_flags & SHOW_DELTA) &&
+			   (msg->protocol_version >=
+			    SLURM_24_11_PROTOCOL_VERSION)) {
+			buffer = pack_delta_jobs(
+				job_info_request_msg->last_update,
+				job_info_request_msg->show_flags,
+				msg->auth_uid, msg->protocol_version);
 		} else {
 			buffer = pack_all_jobs(job_info_request_msg->show_flags,
 					       msg->auth_uid, NO_VAL,
 					       msg->protocol_version);
+			job_info_snapshot_save(buffer,
+					       job_info_request_msg->show_flags,
+					       msg->auth_uid,
+					       msg->protocol_version);
 		}
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(job_read_lock);
@@ -1586,10 +1655,12 @@ static void _slurm_rpc_get_priority_factors(slurm_msg_t *msg)
 
 	resp_msg.priority_factors_list = priority_g_get_priority_factors_list(
 		msg->auth_uid);
-	response_init(&response_msg, msg, RESPONSE_PRIORITY_FACTORS, &resp_msg);
-	slurm_send_node_msg(msg->conn_fd, &response_msg);
 	assoc_mgr_unlock(&qos_read_locks);
 	unlock_slurmctld(job_read_lock);
+
+	/* The list owns its data, don't hold up the scheduler sending it */
+	response_init(&response_msg, msg, RESPONSE_PRIORITY_FACTORS, &resp_msg);
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
 	FREE_NULL_LIST(resp_msg.priority_factors_list);
 	END_TIMER2(__func__);
 	debug2("%s %s", __func__, TIME_STR);
@@ -1784,6 +1855,14 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t *msg)
 		return;
 	}
 
+	/* See _slurm_rpc_dump_jobs() */
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING) &&
+	    ((part_req_msg->last_update - 1) >= last_part_update)) {
+		debug2("%s, no change", __func__);
+		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
+		return;
+	}
+
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 		lock_slurmctld(part_read_lock);
 
@@ -1894,6 +1973,46 @@ static void _slurm_rpc_epilog_complete(slurm_msg_t *msg)
 		slurm_send_rc_msg(msg, SLURM_SUCCESS);
 }
 
+/*
+ * _slurm_rpc_node_heartbeat - process a heartbeat pushed by a slurmd running
+ * with SlurmdParameters=push_heartbeat. This records the same information as
+ * a RESPONSE_PING_SLURMD, so ping_nodes() will skip nodes that keep their
+ * heartbeat current.
+ */
+static void _slurm_rpc_node_heartbeat(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	/* Locks: Write node */
+	slurmctld_lock_t node_write_lock = {
+		NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
+	node_heartbeat_msg_t *hb_msg = msg->data;
+
+	if (!validate_slurm_user(msg->auth_uid)) {
+		error("Security violation, NODE_HEARTBEAT RPC from uid=%u",
+		      msg->auth_uid);
+		slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
+		return;
+	}
+
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING)) {
+		_throttle_start(&active_rpc_cnt);
+		lock_slurmctld(node_write_lock);
+	}
+
+	log_flag(ROUTE, "%s: node_name = %s", __func__, hb_msg->node_name);
+
+	node_did_resp(hb_msg->node_name);
+	reset_node_load(hb_msg->node_name, hb_msg->cpu_load);
+	reset_node_free_mem(hb_msg->node_name, hb_msg->free_mem);
+
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING)) {
+		unlock_slurmctld(node_write_lock);
+		_throttle_fini(&active_rpc_cnt);
+	}
+
+	slurm_send_rc_msg(msg, SLURM_SUCCESS);
+}
+
 /* _slurm_rpc_job_step_kill - process RPC to cancel an entire job or
  * an individual job step */
 static void _slurm_rpc_job_step_kill(slurm_msg_t *msg)
@@ -3567,6 +3686,14 @@ static void _slurm_rpc_submit_batch_job(slurm_msg_t *msg)
 
 	dump_job_desc(job_desc_msg);
 
+	if ((error_code == SLURM_SUCCESS) &&
+	    !(msg->flags & CTLD_QUEUE_PROCESSING)) {
+		job_desc_msg->het_job_offset = NO_VAL;
+		error_code = validate_job_create_req_unlocked(job_desc_msg,
+							      msg->auth_uid,
+							      &err_msg);
+	}
+
 	if (error_code == SLURM_SUCCESS) {
 		/* Locks are for job_submit plugin use */
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
@@ -3679,6 +3806,186 @@ send_msg:
 	xfree(job_submit_user_msg);
 }
 
+/*
+ * _slurm_rpc_submit_batch_jobs - process RPC to submit many independent batch
+ *	jobs. Each job is validated and allocated like REQUEST_SUBMIT_BATCH_JOB,
+ *	but all of them share one pass through the job locks.
+ */
+static void _slurm_rpc_submit_batch_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	list_itr_t *iter;
+	int i, job_cnt, accept_cnt = 0;
+	DEF_TIMERS;
+	job_record_t *job_ptr;
+	slurm_msg_t response_msg;
+	submit_jobs_response_msg_t resp_msg;
+	job_desc_msg_t *job_desc_msg;
+	char *err_msg;
+	list_t *job_req_list = msg->data;
+	/* Locks: Read config, read job, read node, read partition */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK };
+	/* Locks: Read config, write job, write node, read partition, read
+	 * federation */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+
+	START_TIMER;
+	if (slurmctld_config.submissions_disabled) {
+		info("Submissions disabled on system");
+		slurm_send_rc_msg(msg, ESLURM_SUBMISSIONS_DISABLED);
+		return;
+	}
+	job_cnt = job_req_list ? list_count(job_req_list) : 0;
+	if (!job_cnt || (job_cnt > SUBMIT_BATCH_JOBS_MAX)) {
+		info("REQUEST_SUBMIT_BATCH_JOBS from uid=%u with invalid job count %d",
+		     msg->auth_uid, job_cnt);
+		slurm_send_rc_msg(msg, SLURM_ERROR);
+		return;
+	}
+
+	memset(&resp_msg, 0, sizeof(resp_msg));
+	resp_msg.job_cnt = job_cnt;
+	resp_msg.error_code = xcalloc(job_cnt, sizeof(uint32_t));
+	resp_msg.job_id = xcalloc(job_cnt, sizeof(uint32_t));
+	resp_msg.job_submit_user_msg = xcalloc(job_cnt, sizeof(char *));
+
+	/* Validate every request, as for a lone REQUEST_SUBMIT_BATCH_JOB */
+	i = 0;
+	iter = list_iterator_create(job_req_list);
+	while ((job_desc_msg = list_next(iter))) {
+		int error_code;
+
+		if ((error_code = _valid_id("REQUEST_SUBMIT_BATCH_JOBS",
+					    job_desc_msg, msg->auth_uid,
+					    msg->auth_gid,
+					    msg->protocol_version))) {
+			resp_msg.error_code[i++] = error_code;
+			continue;
+		}
+
+		_set_hostname(msg, &job_desc_msg->alloc_node);
+		_set_identity(msg, &job_desc_msg->id);
+
+		if ((job_desc_msg->alloc_node == NULL) ||
+		    (job_desc_msg->alloc_node[0] == '\0')) {
+			error("REQUEST_SUBMIT_BATCH_JOBS lacks alloc_node from uid=%u",
+			      msg->auth_uid);
+			resp_msg.error_code[i++] = ESLURM_INVALID_NODE_NAME;
+			continue;
+		}
+
+		dump_job_desc(job_desc_msg);
+
+		err_msg = NULL;
+		job_desc_msg->het_job_offset = NO_VAL;
+		if (!(msg->flags & CTLD_QUEUE_PROCESSING) &&
+		    (error_code = validate_job_create_req_unlocked(
+			    job_desc_msg, msg->auth_uid, &err_msg))) {
+			resp_msg.error_code[i] = error_code;
+			resp_msg.job_submit_user_msg[i++] = err_msg;
+			continue;
+		}
+
+		/* Locks are for job_submit plugin use */
+		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
+			lock_slurmctld(job_read_lock);
+		resp_msg.error_code[i] =
+			validate_job_create_req(job_desc_msg, msg->auth_uid,
+						&err_msg);
+		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
+			unlock_slurmctld(job_read_lock);
+		resp_msg.job_submit_user_msg[i++] = err_msg;
+	}
+	list_iterator_reset(iter);
+
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING)) {
+		_throttle_start(&active_rpc_cnt);
+		lock_slurmctld(job_write_lock);
+	}
+	START_TIMER;	/* Restart after we have locks */
+
+	i = 0;
+	while ((job_desc_msg = list_next(iter))) {
+		uint32_t job_id = 0;
+		int error_code = SLURM_SUCCESS;
+
+		if (resp_msg.error_code[i]) {
+			i++;
+			continue;
+		}
+
+		err_msg = NULL;
+		job_ptr = NULL;
+		if (fed_mgr_fed_rec) {
+			if (fed_mgr_job_allocate(msg, job_desc_msg, false,
+						 &job_id, &error_code,
+						 &err_msg) && !error_code)
+				error_code = SLURM_ERROR;
+		} else {
+			error_code = job_allocate(job_desc_msg,
+						  job_desc_msg->immediate,
+						  false, NULL, 0,
+						  msg->auth_uid, false,
+						  &job_ptr, &err_msg,
+						  msg->protocol_version);
+			if (!job_ptr ||
+			    (error_code && job_ptr->job_state == JOB_FAILED)) {
+				if (!error_code)
+					error_code = SLURM_ERROR;
+			} else {
+				job_id = job_ptr->job_id;
+				if (job_desc_msg->immediate && error_code)
+					error_code =
+						ESLURM_CAN_NOT_START_IMMEDIATELY;
+				else
+					error_code = SLURM_SUCCESS;
+			}
+		}
+
+		resp_msg.error_code[i] = error_code;
+		if (!error_code) {
+			resp_msg.job_id[i] = job_id;
+			accept_cnt++;
+		}
+		/* Keep the job_submit plugin message, as the lone RPC does */
+		if (err_msg && resp_msg.job_submit_user_msg[i]) {
+			xstrfmtcat(resp_msg.job_submit_user_msg[i], "\n%s",
+				   err_msg);
+			xfree(err_msg);
+		} else if (err_msg) {
+			resp_msg.job_submit_user_msg[i] = err_msg;
+		}
+		i++;
+	}
+	list_iterator_destroy(iter);
+
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING)) {
+		unlock_slurmctld(job_write_lock);
+		_throttle_fini(&active_rpc_cnt);
+	}
+	END_TIMER2(__func__);
+
+	info("%s: accepted %d of %d jobs %s",
+	     __func__, accept_cnt, job_cnt, TIME_STR);
+	response_init(&response_msg, msg, RESPONSE_SUBMIT_BATCH_JOBS,
+		      &resp_msg);
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+
+	if (accept_cnt) {
+		schedule_job_save();	/* Has own locks */
+		schedule_node_save();	/* Has own locks */
+		queue_job_scheduler();
+	}
+
+	for (i = 0; i < job_cnt; i++)
+		xfree(resp_msg.job_submit_user_msg[i]);
+	xfree(resp_msg.job_submit_user_msg);
+	xfree(resp_msg.job_id);
+	xfree(resp_msg.error_code);
+}
+
 /* _slurm_rpc_submit_batch_het_job - process RPC to submit a batch hetjob */
 static void _slurm_rpc_submit_batch_het_job(slurm_msg_t *msg)
 {
@@ -5376,6 +5683,32 @@ static void _slurm_rpc_set_schedlog_level(slurm_msg_t *msg)
 	slurm_send_rc_msg(msg, SLURM_SUCCESS);
 }
 
+static void _slurm_rpc_sched_trace_dump(slurm_msg_t *msg)
+{
+	int rc;
+	char *path;
+	slurmctld_lock_t config_read_lock =
+		{ READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
+
+	if (!validate_super_user(msg->auth_uid)) {
+		error("scheduler trace dump request from non-super user uid=%u",
+		      msg->auth_uid);
+		slurm_send_rc_msg(msg, EACCES);
+		return;
+	}
+
+	lock_slurmctld(config_read_lock);
+	path = xstrdup_printf("%s/sched_trace",
+			      slurm_conf.state_save_location);
+	unlock_slurmctld(config_read_lock);
+
+	if ((rc = sched_trace_dump(path)) == SLURM_SUCCESS)
+		info("Scheduler trace written to %s", path);
+	xfree(path);
+
+	slurm_send_rc_msg(msg, rc);
+}
+
 static void _slurm_rpc_accounting_update_msg(slurm_msg_t *msg)
 {
 	int rc = SLURM_SUCCESS;
@@ -5598,6 +5931,8 @@ static void _clear_rpc_stats(void)
 	memset(rpc_user_cnt, 0, sizeof(rpc_user_cnt));
 	memset(rpc_user_id, 0, sizeof(rpc_user_id));
 	memset(rpc_user_time, 0, sizeof(rpc_user_time));
+	memset(rpc_type_hist, 0, sizeof(rpc_type_hist));
+	memset(rpc_user_hist, 0, sizeof(rpc_user_hist));
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
@@ -5605,7 +5940,84 @@ static void _pack_rpc_stats(buf_t *buffer, uint16_t protocol_version)
 {
 	slurm_mutex_lock(&rpc_mutex);
 
-	if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_24_11_PROTOCOL_VERSION) {
+		uint32_t rpc_count = 0, user_count = 1;
+		uint8_t queue_enabled = rpc_queue_enabled();
+		uint64_t bitmap_cache_hits, bitmap_cache_misses;
+		uint32_t xmalloc_cnt;
+		char **xmalloc_name;
+		uint64_t *xmalloc_allocs, *xmalloc_frees, *xmalloc_bytes;
+		uint32_t plugin_cnt, *plugin_calls, *plugin_hist;
+		char **plugin_name, **plugin_op;
+		uint64_t *plugin_time, *plugin_max;
+
+		while (rpc_type_id[rpc_count])
+			rpc_count++;
+		pack32(rpc_count, buffer);
+		pack16_array(rpc_type_id, rpc_count, buffer);
+		pack32_array(rpc_type_cnt, rpc_count, buffer);
+		pack64_array(rpc_type_time, rpc_count, buffer);
+
+		pack8(queue_enabled, buffer);
+		if (queue_enabled) {
+			pack16_array(rpc_type_queued, rpc_count, buffer);
+			pack64_array(rpc_type_dropped, rpc_count, buffer);
+			pack16_array(rpc_type_cycle_last, rpc_count, buffer);
+			pack16_array(rpc_type_cycle_max, rpc_count, buffer);
+		}
+
+		/* user_count starts at 1 as root is in index 0 */
+		while (rpc_user_id[user_count])
+			user_count++;
+		pack32(user_count, buffer);
+		pack32_array(rpc_user_id, user_count, buffer);
+		pack32_array(rpc_user_cnt, user_count, buffer);
+		pack64_array(rpc_user_time, user_count, buffer);
+
+		agent_pack_pending_rpc_stats(buffer);
+
+		lock_stats_pack(buffer);
+
+		bit_cache_stats(&bitmap_cache_hits, &bitmap_cache_misses);
+		pack64(bitmap_cache_hits, buffer);
+		pack64(bitmap_cache_misses, buffer);
+
+		pack32(slurmctld_diag_stats.fair_tree_cycle_counter, buffer);
+		pack32(slurmctld_diag_stats.fair_tree_cycle_last, buffer);
+		pack32(slurmctld_diag_stats.fair_tree_cycle_max, buffer);
+		pack64(slurmctld_diag_stats.fair_tree_cycle_sum, buffer);
+
+		xmalloc_cnt = xmalloc_stats_get(&xmalloc_name, &xmalloc_allocs,
+						&xmalloc_frees, &xmalloc_bytes);
+		packstr_array(xmalloc_name, xmalloc_cnt, buffer);
+		pack64_array(xmalloc_allocs, xmalloc_cnt, buffer);
+		pack64_array(xmalloc_frees, xmalloc_cnt, buffer);
+		pack64_array(xmalloc_bytes, xmalloc_cnt, buffer);
+		xfree(xmalloc_name);
+		xfree(xmalloc_allocs);
+		xfree(xmalloc_frees);
+		xfree(xmalloc_bytes);
+
+		pack32(RPC_HIST_CNT, buffer);
+		pack32_array(rpc_type_hist, rpc_count * RPC_HIST_CNT, buffer);
+		pack32_array(rpc_user_hist, user_count * RPC_HIST_CNT, buffer);
+
+		plugin_cnt = plugin_stats_get(&plugin_name, &plugin_op,
+					      &plugin_calls, &plugin_time,
+					      &plugin_max, &plugin_hist);
+		packstr_array(plugin_name, plugin_cnt, buffer);
+		packstr_array(plugin_op, plugin_cnt, buffer);
+		pack32_array(plugin_calls, plugin_cnt, buffer);
+		pack64_array(plugin_time, plugin_cnt, buffer);
+		pack64_array(plugin_max, plugin_cnt, buffer);
+		pack32_array(plugin_hist, plugin_cnt * RPC_HIST_CNT, buffer);
+		xfree(plugin_name);
+		xfree(plugin_op);
+		xfree(plugin_calls);
+		xfree(plugin_time);
+		xfree(plugin_max);
+		xfree(plugin_hist);
+	} else if (protocol_version >= SLURM_24_05_PROTOCOL_VERSION) {
 		uint32_t rpc_count = 0, user_count = 1;
 		uint8_t queue_enabled = rpc_queue_enabled();
 
@@ -6616,6 +7028,14 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 			.job = WRITE_LOCK,
 			.node = WRITE_LOCK,
 		},
+	},{
+		.msg_type = MESSAGE_NODE_HEARTBEAT,
+		.max_per_cycle = 256,
+		.func = _slurm_rpc_node_heartbeat,
+		.queue_enabled = true,
+		.locks = {
+			.node = WRITE_LOCK,
+		},
 	},{
 		.msg_type = REQUEST_CANCEL_JOB_STEP,
 		.func = _slurm_rpc_job_step_kill,
@@ -6667,6 +7087,7 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 		.msg_type = MESSAGE_NODE_REGISTRATION_STATUS,
 		.func = _slurm_rpc_node_registration,
 		.post_func = _slurm_post_rpc_node_registration,
+		.locked_post_func = purge_missing_jobs_batch,
 		.queue_enabled = true,
 		.locks = {
 			.conf = READ_LOCK,
@@ -6719,6 +7140,9 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 			.part = READ_LOCK,
 			.fed = READ_LOCK,
 		},
+	},{
+		.msg_type = REQUEST_SUBMIT_BATCH_JOBS,
+		.func = _slurm_rpc_submit_batch_jobs,
 	},{
 		.msg_type = REQUEST_SUBMIT_BATCH_HET_JOB,
 		.func = _slurm_rpc_submit_batch_het_job,
@@ -6825,6 +7249,9 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 	},{
 		.msg_type = REQUEST_SET_SCHEDLOG_LEVEL,
 		.func = _slurm_rpc_set_schedlog_level,
+	},{
+		.msg_type = REQUEST_SCHED_TRACE_DUMP,
+		.func = _slurm_rpc_sched_trace_dump,
 	},{
 		.msg_type = REQUEST_SET_SUSPEND_EXC_NODES,
 		.func = _slurm_rpc_set_suspend_exc_nodes,
@@ -6964,8 +7391,11 @@ void slurmctld_req(slurm_msg_t *msg)
 			/* do not record RPC stats, we didn't process this */
 			return;
 		}
+		SLURM_PROBE2(rpc_start, msg->msg_type, msg->auth_uid);
 		(*(this_rpc->func))(msg);
 		END_TIMER;
+		SLURM_PROBE3(rpc_done, msg->msg_type, msg->auth_uid,
+			     DELTA_TIMER);
 		record_rpc_stats(msg, DELTA_TIMER);
 	} else {
 		error("invalid RPC msg_type=%s", rpc_num2string(msg->msg_type));
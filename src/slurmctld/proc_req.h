@@ -41,6 +41,7 @@
 
 #include <sys/time.h>
 
+#include "src/common/mpsc_queue.h"
 #include "src/common/slurm_protocol_api.h"
 
 #include "src/slurmctld/locks.h"
@@ -49,6 +50,7 @@ typedef struct {
 	uint16_t msg_type;
 	void (*func)(slurm_msg_t *msg);
 	void (*post_func)();
+	void (*locked_post_func)(); /* end of cycle, before locks released */
 	slurmctld_lock_t locks;
 
 	/* Queue structual elements */
@@ -65,12 +67,13 @@ typedef struct {
 	uint16_t max_queued;
 	uint16_t max_per_cycle;
 	uint32_t max_usec_per_cycle;
+	uint16_t max_per_user_per_cycle; /* fair share of a cycle per user */
 
 	pthread_t thread;
 	pthread_cond_t cond;
 	pthread_mutex_t mutex;
 
-	list_t *work;
+	mpsc_queue_t *work; /* only dequeued by the worker thread */
 
 	/* Queue processing statistics */
 	uint16_t queued;
@@ -41,7 +41,9 @@
 #include "config.h"
 
 #include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -89,19 +91,46 @@
 #include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/slurmctld.h"
+#include "src/slurmctld/state_save.h"
 #include "src/slurmctld/trigger_mgr.h"
 
 #include "src/stepmgr/srun_comm.h"
 #include "src/stepmgr/stepmgr.h"
 
 #define FEATURE_MAGIC	0x34dfd8b5
+#define PREFETCH_STATE_THREADS 8
+
+typedef struct {
+	char *name;
+	time_t mtime;
+	off_t size;
+} conf_stamp_t;
+
+typedef struct {
+	uint64_t bytes;		/* bytes read by all threads */
+	int file_cnt;
+	list_t *files;		/* names of files not yet read */
+	pthread_mutex_t mutex;
+	struct timeval start;
+	int threads;		/* threads still running */
+} prefetch_state_t;
+
+/* Set while prefetch_state_files() threads are still reading */
+static bool prefetch_running = false;
+static pthread_mutex_t prefetch_running_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* Global variables */
 list_t *active_feature_list;	/* list of currently active features_records */
 list_t *avail_feature_list;	/* list of available features_records */
+uint64_t feature_list_gen = 1;
 bool node_features_updated = true;
 bool slurmctld_init_db = true;
 
+/* slurm.conf as of the last full load, see reconfig_in_place() */
+static char *loaded_conf = NULL;
+static list_t *loaded_conf_stamps = NULL;
+static pthread_mutex_t in_place_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void _acct_restore_active_jobs(void);
 static void _add_config_feature(list_t *feature_list, char *feature,
 				bitstr_t *node_bitmap);
@@ -115,6 +144,7 @@ static int _preserve_select_type_param(slurm_conf_t *ctl_conf_ptr,
                                        uint16_t old_select_type_p);
 static int  _reset_node_bitmaps(void *x, void *arg);
 static void _restore_job_accounting();
+static void _save_loaded_conf(void);
 
 static void _set_features(node_record_t **old_node_table_ptr,
 			  int old_node_record_count, int recover);
@@ -1529,10 +1559,15 @@ extern int read_slurm_conf(int recover)
 	if (topology_g_init() != SLURM_SUCCESS)
 		fatal("Failed to initialize topology plugin");
 
-	if (xstrcasestr(slurm_conf.slurmctld_params, "enable_stepmgr") &&
+	if ((xstrcasestr(slurm_conf.slurmctld_params, "enable_stepmgr") ||
+	     xstrcasestr(slurm_conf.slurmctld_params, "stepmgr_min_nodes=")) &&
 	    !(slurm_conf.prolog_flags & PROLOG_FLAG_CONTAIN))
 		fatal("STEP_MGR not supported without PrologFlags=contain");
 
+	lock_stats_config();
+	job_info_snapshot_config();
+	job_state_shard_config();
+
 	/* Build node and partition information based upon slurm.conf file */
 	build_all_nodeline_info(false, slurmctld_tres_cnt);
 	/* Increase node table to handle dynamic nodes. */
@@ -1814,6 +1849,7 @@ extern int read_slurm_conf(int recover)
 	}
 
 	slurm_conf.last_update = time(NULL);
+	_save_loaded_conf();
 end_it:
 	xfree(old_auth_type);
 	xfree(old_bb_type);
@@ -1924,6 +1960,7 @@ extern void build_feature_list_eq(void)
 	FREE_NULL_LIST(avail_feature_list);
 	active_feature_list = list_create(_list_delete_feature);
 	avail_feature_list = list_create(_list_delete_feature);
+	feature_list_gen++;
 
 	config_iterator = list_iterator_create(config_list);
 	while ((config_ptr = list_next(config_iterator))) {
@@ -1993,6 +2030,7 @@ extern void build_feature_list_ne(void)
 	FREE_NULL_LIST(avail_feature_list);
 	active_feature_list = list_create(_list_delete_feature);
 	avail_feature_list = list_create(_list_delete_feature);
+	feature_list_gen++;
 
 	for (i = 0; (node_ptr = next_node(&i)); i++) {
 		if (node_ptr->features_act) {
@@ -2051,6 +2089,7 @@ extern void update_feature_list(list_t *feature_list, char *new_features,
 		xfree(tmp_str);
 	}
 	node_features_updated = true;
+	feature_list_gen++;
 }
 
 static void _gres_reconfig(void)
@@ -2743,3 +2782,605 @@ unpack_error:
 
 	return SLURM_ERROR;
 }
+
+/* Read one state file to bring it into the page cache */
+static uint64_t _prefetch_state_file(char *file_name)
+{
+	static const int chunk_size = (1024 * 1024);
+	char *data = xmalloc_nz(chunk_size);
+	uint64_t total = 0;
+	ssize_t amount;
+	int fd;
+
+	if ((fd = open(file_name, O_RDONLY | O_CLOEXEC)) < 0) {
+		debug2("%s: unable to open %s: %m", __func__, file_name);
+		xfree(data);
+		return 0;
+	}
+	while ((amount = read(fd, data, chunk_size))) {
+		if (amount < 0) {
+			if (errno == EINTR)
+				continue;
+			debug2("%s: unable to read %s: %m",
+			       __func__, file_name);
+			break;
+		}
+		total += amount;
+	}
+	(void) close(fd);
+	xfree(data);
+
+	return total;
+}
+
+static void *_prefetch_state_thread(void *arg)
+{
+	prefetch_state_t *prefetch = arg;
+	char *file_name;
+	uint64_t bytes;
+	bool last;
+	DEF_TIMERS;
+
+	while (true) {
+		slurm_mutex_lock(&prefetch->mutex);
+		file_name = list_pop(prefetch->files);
+		slurm_mutex_unlock(&prefetch->mutex);
+		if (!file_name)
+			break;
+		bytes = _prefetch_state_file(file_name);
+		xfree(file_name);
+
+		slurm_mutex_lock(&prefetch->mutex);
+		prefetch->bytes += bytes;
+		slurm_mutex_unlock(&prefetch->mutex);
+	}
+
+	slurm_mutex_lock(&prefetch->mutex);
+	last = !--prefetch->threads;
+	slurm_mutex_unlock(&prefetch->mutex);
+	if (last) {
+		tv1 = prefetch->start;
+		END_TIMER;
+		debug("%s: read %d state files (%"PRIu64" bytes) %s",
+		      __func__, prefetch->file_cnt, prefetch->bytes,
+		      TIME_STR);
+		FREE_NULL_LIST(prefetch->files);
+		slurm_mutex_destroy(&prefetch->mutex);
+		xfree(prefetch);
+
+		slurm_mutex_lock(&prefetch_running_mutex);
+		prefetch_running = false;
+		slurm_mutex_unlock(&prefetch_running_mutex);
+	}
+
+	return NULL;
+}
+
+/*
+ * prefetch_state_files - read the state save files in parallel threads.
+ *	Recovering state parses the files one after the other, so with a slow
+ *	StateSaveLocation (e.g. NFS) most of the time is spent waiting on
+ *	reads. Reading all of the files concurrently ahead of time lets the
+ *	loads that follow find them in the page cache. Returns without waiting
+ *	for the reads to complete.
+ */
+extern void prefetch_state_files(void)
+{
+	prefetch_state_t *prefetch;
+	struct dirent *ent;
+	char *file_name;
+	struct stat stat_buf;
+	DIR *dir;
+	int len;
+
+	slurm_mutex_lock(&prefetch_running_mutex);
+	if (prefetch_running) {
+		slurm_mutex_unlock(&prefetch_running_mutex);
+		debug2("%s: previous prefetch still running", __func__);
+		return;
+	}
+	prefetch_running = true;
+	slurm_mutex_unlock(&prefetch_running_mutex);
+
+	if (!(dir = opendir(slurm_conf.state_save_location))) {
+		debug("%s: unable to open %s: %m",
+		      __func__, slurm_conf.state_save_location);
+		slurm_mutex_lock(&prefetch_running_mutex);
+		prefetch_running = false;
+		slurm_mutex_unlock(&prefetch_running_mutex);
+		return;
+	}
+
+	prefetch = xmalloc(sizeof(*prefetch));
+	gettimeofday(&prefetch->start, NULL);
+	prefetch->files = list_create(xfree_ptr);
+	slurm_mutex_init(&prefetch->mutex);
+
+	while ((ent = readdir(dir))) {
+		/* Backup and partially written copies are not loaded */
+		len = strlen(ent->d_name);
+		if ((ent->d_name[0] == '.') ||
+		    ((len > 4) && (!xstrcmp(ent->d_name + len - 4, ".old") ||
+				   !xstrcmp(ent->d_name + len - 4, ".new"))))
+			continue;
+		file_name = xstrdup_printf("%s/%s",
+					   slurm_conf.state_save_location,
+					   ent->d_name);
+		/* Skip the hash.# directories of batch scripts */
+		if (stat(file_name, &stat_buf) || !S_ISREG(stat_buf.st_mode)) {
+			xfree(file_name);
+			continue;
+		}
+		list_append(prefetch->files, file_name);
+	}
+	closedir(dir);
+
+	if (!(prefetch->file_cnt = list_count(prefetch->files))) {
+		FREE_NULL_LIST(prefetch->files);
+		slurm_mutex_destroy(&prefetch->mutex);
+		xfree(prefetch);
+		slurm_mutex_lock(&prefetch_running_mutex);
+		prefetch_running = false;
+		slurm_mutex_unlock(&prefetch_running_mutex);
+		return;
+	}
+
+	prefetch->threads = MIN(prefetch->file_cnt, PREFETCH_STATE_THREADS);
+	for (int i = 0, cnt = prefetch->threads; i < cnt; i++)
+		slurm_thread_create_detached(_prefetch_state_thread, prefetch);
+}
+
+static char *_read_conf_file(const char *path)
+{
+	buf_t *buf;
+	char *data;
+
+	if (!(buf = create_mmap_buf(path)))
+		return NULL;
+	data = xstrndup(get_buf_data(buf), size_buf(buf));
+	FREE_NULL_BUFFER(buf);
+
+	return data;
+}
+
+static void _free_conf_stamp(void *x)
+{
+	conf_stamp_t *stamp = x;
+
+	xfree(stamp->name);
+	xfree(stamp);
+}
+
+/*
+ * Record the size and mtime of every other file in the slurm.conf directory,
+ * so reconfig_in_place() can tell when gres.conf, topology.conf, etc. were
+ * modified along with slurm.conf.
+ */
+static list_t *_stat_conf_dir(void)
+{
+	char *dir_name = xdirname(slurm_conf.slurm_conf);
+	char *conf_name = xbasename(slurm_conf.slurm_conf);
+	list_t *stamps;
+	struct dirent *ent;
+	DIR *dir;
+
+	if (!(dir = opendir(dir_name))) {
+		xfree(dir_name);
+		return NULL;
+	}
+
+	stamps = list_create(_free_conf_stamp);
+	while ((ent = readdir(dir))) {
+		conf_stamp_t *stamp;
+		struct stat st;
+		char *path;
+
+		if (!xstrcmp(ent->d_name, conf_name))
+			continue;
+		path = xstrdup_printf("%s/%s", dir_name, ent->d_name);
+		if (stat(path, &st) || !S_ISREG(st.st_mode)) {
+			xfree(path);
+			continue;
+		}
+		stamp = xmalloc(sizeof(*stamp));
+		stamp->name = path;
+		stamp->mtime = st.st_mtime;
+		stamp->size = st.st_size;
+		list_append(stamps, stamp);
+	}
+	closedir(dir);
+	xfree(dir_name);
+
+	return stamps;
+}
+
+static int _match_conf_stamp(void *x, void *key)
+{
+	conf_stamp_t *stamp = x;
+	struct stat st;
+
+	if (stat(stamp->name, &st) || (st.st_mtime != stamp->mtime) ||
+	    (st.st_size != stamp->size))
+		return 1;
+	return 0;
+}
+
+static bool _conf_dir_changed(void)
+{
+	list_t *stamps;
+	bool changed;
+
+	if (!loaded_conf_stamps || !(stamps = _stat_conf_dir()))
+		return true;
+
+	changed = (list_count(stamps) != list_count(loaded_conf_stamps)) ||
+		  list_find_first(loaded_conf_stamps, _match_conf_stamp, NULL);
+	FREE_NULL_LIST(stamps);
+
+	return changed;
+}
+
+static void _save_loaded_conf(void)
+{
+	if (!xstrcasestr(slurm_conf.slurmctld_params, "reconfig_in_place"))
+		return;
+
+	slurm_mutex_lock(&in_place_mutex);
+	xfree(loaded_conf);
+	FREE_NULL_LIST(loaded_conf_stamps);
+	loaded_conf = _read_conf_file(slurm_conf.slurm_conf);
+	loaded_conf_stamps = _stat_conf_dir();
+	slurm_mutex_unlock(&in_place_mutex);
+}
+
+/*
+ * Split slurm.conf contents into its non-empty lines with comments and
+ * surrounding whitespace removed. Continued and escaped lines are kept
+ * as-is and will never be treated as an in-place change.
+ */
+static list_t *_split_conf_lines(char *conf)
+{
+	list_t *lines = list_create(xfree_ptr);
+	char *line, *save_ptr = NULL, *copy = xstrdup(conf);
+
+	for (line = strtok_r(copy, "\n", &save_ptr); line;
+	     line = strtok_r(NULL, "\n", &save_ptr)) {
+		char *end;
+
+		for (end = line; *end; end++) {
+			if ((*end == '#') && ((end == line) || (end[-1] != '\\')))
+				break;
+		}
+		*end = '\0';
+		xstrtrim(line);
+		if (line[0])
+			list_append(lines, xstrdup(line));
+	}
+	xfree(copy);
+
+	return lines;
+}
+
+/* Split a line into its key=value tokens, allowing quoted values */
+static list_t *_split_conf_tokens(const char *line)
+{
+	list_t *tokens = list_create(xfree_ptr);
+	const char *start, *ptr = line;
+
+	while (*ptr) {
+		bool quoted = false;
+
+		while (isspace((int) *ptr))
+			ptr++;
+		if (!*ptr)
+			break;
+		start = ptr;
+		for (; *ptr && (quoted || !isspace((int) *ptr)); ptr++) {
+			if (*ptr == '"')
+				quoted = !quoted;
+		}
+		list_append(tokens, xstrndup(start, ptr - start));
+	}
+
+	return tokens;
+}
+
+static int _parse_conf_uint(const char *val, uint32_t max, uint32_t *out)
+{
+	unsigned long num;
+	char *end = NULL;
+
+	if (!xstrcasecmp(val, "INFINITE") || !xstrcasecmp(val, "UNLIMITED")) {
+		*out = (max == UINT16_MAX) ? INFINITE16 : INFINITE;
+		return SLURM_SUCCESS;
+	}
+
+	errno = 0;
+	num = strtoul(val, &end, 10);
+	if (errno || (end == val) || *end || (num > max))
+		return SLURM_ERROR;
+	*out = num;
+
+	return SLURM_SUCCESS;
+}
+
+static int _set_part_field(update_part_msg_t *part_desc, const char *key,
+			   const char *val)
+{
+	uint32_t num;
+	int mins;
+
+	if (!xstrcasecmp(key, "MaxTime") || !xstrcasecmp(key, "DefaultTime")) {
+		mins = time_str2mins(val);
+		if ((mins < 0) && (mins != INFINITE))
+			return SLURM_ERROR;
+		if (!xstrcasecmp(key, "MaxTime"))
+			part_desc->max_time = mins;
+		else
+			part_desc->default_time = mins;
+	} else if (!xstrcasecmp(key, "MaxNodes")) {
+		if (_parse_conf_uint(val, UINT32_MAX, &part_desc->max_nodes))
+			return SLURM_ERROR;
+	} else if (!xstrcasecmp(key, "MinNodes")) {
+		if (_parse_conf_uint(val, UINT32_MAX, &part_desc->min_nodes))
+			return SLURM_ERROR;
+	} else if (!xstrcasecmp(key, "PriorityJobFactor")) {
+		if (_parse_conf_uint(val, UINT16_MAX, &num))
+			return SLURM_ERROR;
+		part_desc->priority_job_factor = num;
+	} else if (!xstrcasecmp(key, "PriorityTier")) {
+		if (_parse_conf_uint(val, UINT16_MAX, &num))
+			return SLURM_ERROR;
+		part_desc->priority_tier = num;
+	} else if (!xstrcasecmp(key, "State")) {
+		if (!xstrncasecmp(val, "DOWN", 4))
+			part_desc->state_up = PARTITION_DOWN;
+		else if (!xstrncasecmp(val, "UP", 2))
+			part_desc->state_up = PARTITION_UP;
+		else if (!xstrncasecmp(val, "DRAIN", 5))
+			part_desc->state_up = PARTITION_DRAIN;
+		else if (!xstrncasecmp(val, "INACTIVE", 8))
+			part_desc->state_up = PARTITION_INACTIVE;
+		else
+			return SLURM_ERROR;
+	} else {
+		return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
+static int _set_node_field(update_node_msg_t *node_msg, const char *key,
+			   const char *val)
+{
+	if (xstrcasecmp(key, "Weight") ||
+	    _parse_conf_uint(val, UINT32_MAX, &node_msg->weight))
+		return SLURM_ERROR;
+
+	/* Match the slurm.conf parsing of Weight=INFINITE */
+	if (node_msg->weight == INFINITE)
+		node_msg->weight -= 1;
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Compare one changed line of slurm.conf against its old version and turn
+ * the difference into a partition or node update message.
+ * RET SLURM_SUCCESS if the change can be applied in place
+ */
+static int _diff_conf_line(char *old_line, char *new_line,
+			   list_t *part_updates, list_t *node_updates)
+{
+	list_t *old_tokens = _split_conf_tokens(old_line);
+	list_t *new_tokens = _split_conf_tokens(new_line);
+	update_part_msg_t *part_desc = NULL;
+	update_node_msg_t *node_msg = NULL;
+	char *old_tok, *new_tok, *name;
+	list_itr_t *old_itr, *new_itr;
+	int rc = SLURM_ERROR;
+
+	if (strchr(old_line, '\\') || strchr(new_line, '\\') ||
+	    (list_count(old_tokens) != list_count(new_tokens)) ||
+	    (list_count(new_tokens) < 2))
+		goto fini;
+
+	/* The record name must not change, nor be a DEFAULT line */
+	old_tok = list_peek(old_tokens);
+	new_tok = list_peek(new_tokens);
+	if (xstrcmp(old_tok, new_tok) || !(name = strchr(new_tok, '=')) ||
+	    !xstrcasecmp(++name, "DEFAULT"))
+		goto fini;
+
+	if (!xstrncasecmp(new_tok, "PartitionName=", 14)) {
+		part_desc = xmalloc(sizeof(*part_desc));
+		slurm_init_part_desc_msg(part_desc);
+		part_desc->name = xstrdup(name);
+	} else if (!xstrncasecmp(new_tok, "NodeName=", 9)) {
+		node_msg = xmalloc(sizeof(*node_msg));
+		slurm_init_update_node_msg(node_msg);
+		node_msg->node_names = xstrdup(name);
+	} else {
+		goto fini;
+	}
+
+	rc = SLURM_SUCCESS;
+	old_itr = list_iterator_create(old_tokens);
+	new_itr = list_iterator_create(new_tokens);
+	(void) list_next(old_itr);
+	(void) list_next(new_itr);
+	while (!rc && (old_tok = list_next(old_itr)) &&
+	       (new_tok = list_next(new_itr))) {
+		char *old_val = strchr(old_tok, '=');
+		char *new_val = strchr(new_tok, '=');
+
+		if (!old_val || !new_val ||
+		    ((old_val - old_tok) != (new_val - new_tok)) ||
+		    xstrncasecmp(old_tok, new_tok, new_val - new_tok)) {
+			rc = SLURM_ERROR;
+			break;
+		}
+		if (!xstrcmp(old_val, new_val))
+			continue;
+
+		*new_val++ = '\0';
+		if (part_desc)
+			rc = _set_part_field(part_desc, new_tok, new_val);
+		else
+			rc = _set_node_field(node_msg, new_tok, new_val);
+		if (rc)
+			debug("%s: change to %s on \"%s\" requires a full reconfigure",
+			      __func__, new_tok, (char *) list_peek(old_tokens));
+	}
+	list_iterator_destroy(old_itr);
+	list_iterator_destroy(new_itr);
+
+	if (!rc && part_desc) {
+		list_append(part_updates, part_desc);
+		part_desc = NULL;
+	} else if (!rc && node_msg) {
+		list_append(node_updates, node_msg);
+		node_msg = NULL;
+	}
+
+fini:
+	slurm_free_update_part_msg(part_desc);
+	slurm_free_update_node_msg(node_msg);
+	FREE_NULL_LIST(old_tokens);
+	FREE_NULL_LIST(new_tokens);
+	return rc;
+}
+
+/* Find which lines of slurm.conf changed and build their updates */
+static int _diff_conf(char *old_conf, char *new_conf, list_t *part_updates,
+		      list_t *node_updates)
+{
+	list_t *old_lines = _split_conf_lines(old_conf);
+	list_t *new_lines = _split_conf_lines(new_conf);
+	list_itr_t *old_itr, *new_itr;
+	char *old_line, *new_line;
+	int rc = SLURM_SUCCESS;
+
+	if (list_count(old_lines) != list_count(new_lines)) {
+		debug("%s: lines were added or removed", __func__);
+		rc = SLURM_ERROR;
+		goto fini;
+	}
+
+	old_itr = list_iterator_create(old_lines);
+	new_itr = list_iterator_create(new_lines);
+	while (!rc && (old_line = list_next(old_itr)) &&
+	       (new_line = list_next(new_itr))) {
+		if (!xstrncasecmp(new_line, "Include", 7)) {
+			debug("%s: Include found", __func__);
+			rc = SLURM_ERROR;
+		} else if (xstrcmp(old_line, new_line)) {
+			rc = _diff_conf_line(old_line, new_line, part_updates,
+					     node_updates);
+		}
+	}
+	list_iterator_destroy(old_itr);
+	list_iterator_destroy(new_itr);
+
+fini:
+	FREE_NULL_LIST(old_lines);
+	FREE_NULL_LIST(new_lines);
+	return rc;
+}
+
+static int _apply_part_update(void *x, void *arg)
+{
+	update_part_msg_t *part_desc = x;
+	int *rc = arg;
+
+	if ((*rc = update_part(part_desc, false))) {
+		error("%s: update of partition %s failed: %s",
+		      __func__, part_desc->name, slurm_strerror(*rc));
+		return -1;
+	}
+
+	return 0;
+}
+
+static int _apply_node_update(void *x, void *arg)
+{
+	update_node_msg_t *node_msg = x;
+	int *rc = arg;
+
+	if ((*rc = update_node(node_msg, slurm_conf.slurm_user_id))) {
+		error("%s: update of nodes %s failed: %s",
+		      __func__, node_msg->node_names, slurm_strerror(*rc));
+		return -1;
+	}
+
+	return 0;
+}
+
+extern int reconfig_in_place(void)
+{
+	/* Locks: Read config, write job, write node, write partition */
+	slurmctld_lock_t config_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK };
+	list_t *part_updates = NULL, *node_updates = NULL;
+	char *new_conf = NULL;
+	int rc = SLURM_ERROR;
+	DEF_TIMERS;
+
+	if (!xstrcasestr(slurm_conf.slurmctld_params, "reconfig_in_place"))
+		return SLURM_ERROR;
+
+	START_TIMER;
+	slurm_mutex_lock(&in_place_mutex);
+	if (!loaded_conf ||
+	    !(new_conf = _read_conf_file(slurm_conf.slurm_conf))) {
+		debug("%s: slurm.conf not available", __func__);
+		goto fini;
+	}
+	if (!xstrcmp(loaded_conf, new_conf)) {
+		debug("%s: slurm.conf unchanged", __func__);
+		goto fini;
+	}
+	if (_conf_dir_changed()) {
+		debug("%s: other configuration files changed", __func__);
+		goto fini;
+	}
+
+	part_updates = list_create((ListDelF) slurm_free_update_part_msg);
+	node_updates = list_create((ListDelF) slurm_free_update_node_msg);
+	if (_diff_conf(loaded_conf, new_conf, part_updates, node_updates))
+		goto fini;
+
+	lock_slurmctld(config_write_lock);
+	rc = SLURM_SUCCESS;
+	(void) list_find_first(part_updates, _apply_part_update, &rc);
+	if (!rc)
+		(void) list_find_first(node_updates, _apply_node_update, &rc);
+	unlock_slurmctld(config_write_lock);
+
+	/* Below functions provide their own locks */
+	if (list_count(part_updates))
+		schedule_part_save();
+	if (list_count(node_updates)) {
+		schedule_node_save();
+		validate_all_reservations(false);
+		trigger_reconfig();
+	}
+	queue_job_scheduler();
+
+	if (!rc) {
+		xfree(loaded_conf);
+		loaded_conf = new_conf;
+		new_conf = NULL;
+		END_TIMER2(__func__);
+		info("%s: applied %d partition and %d node updates %s",
+		     __func__, list_count(part_updates),
+		     list_count(node_updates), TIME_STR);
+	}
+
+fini:
+	slurm_mutex_unlock(&in_place_mutex);
+	FREE_NULL_LIST(part_updates);
+	FREE_NULL_LIST(node_updates);
+	xfree(new_conf);
+	return rc;
+}
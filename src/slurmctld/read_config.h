@@ -66,6 +66,26 @@ extern void cluster_rec_free(void);
  */
 extern int read_slurm_conf(int recover);
 
+/*
+ * prefetch_state_files - read all state save files in parallel threads so
+ *	the loads in read_slurm_conf() and assoc_mgr find them in the page
+ *	cache. Returns without waiting for the reads to complete. Does nothing
+ *	while the reads of a previous call are still running.
+ */
+extern void prefetch_state_files(void);
+
+/*
+ * reconfig_in_place - apply a slurm.conf change without a full reconfigure
+ *	when the only differences since the last load are partition limits
+ *	(MaxTime, DefaultTime, MaxNodes, MinNodes, PriorityJobFactor,
+ *	PriorityTier, State) or node Weight values.
+ *	Requires SlurmctldParameters=reconfig_in_place.
+ * RET SLURM_SUCCESS if the changes were applied, otherwise a full
+ *	reconfigure is required
+ * NOTE: Acquires its own locks
+ */
+extern int reconfig_in_place(void);
+
 extern int dump_config_state_lite(void);
 extern int load_config_state_lite(void);
 
@@ -142,7 +142,32 @@ typedef struct {
 	bitstr_t *node_bitmap;
 } resv_select_t;
 
+typedef struct {
+	int list_inx;		/* position in resv_list */
+	slurmctld_resv_t *resv_ptr;
+	time_t start_time;	/* start_time_first when indexed */
+} resv_index_ent_t;
+
+/*
+ * Time index over resv_list used by job_test_resv() so that it only looks
+ * at reservations which can overlap the job's time window. The first
+ * sorted_cnt entries are sorted by start time, TIME_FLOAT reservations move
+ * with the clock and follow them unsorted. Rebuilt on first use after any
+ * reservation change.
+ */
+static struct {
+	time_t advance_time;	/* last time expired entries were advanced */
+	int ent_alloc;
+	int ent_cnt;
+	resv_index_ent_t *ents;
+	uint32_t max_boot_time;
+	time_t min_end_time;	/* earliest end_time of sorted entries */
+	int sorted_cnt;
+	bool valid;
+} resv_index;
+
 static int _advance_resv_time(slurmctld_resv_t *resv_ptr);
+static void _set_last_resv_update(time_t when);
 static void _advance_time(time_t *res_time, int day_cnt, int hour_cnt);
 static int  _build_account_list(char *accounts, int *account_cnt,
 				char ***account_list, bool *account_not);
@@ -384,6 +409,7 @@ static bitstr_t *_resv_select(resv_desc_msg_t *resv_desc_ptr,
 
 static void _set_boot_time(slurmctld_resv_t *resv_ptr)
 {
+	resv_index.valid = false;
 	resv_ptr->boot_time = 0;
 	if (!resv_ptr->node_bitmap)
 		return;
@@ -424,6 +450,7 @@ static list_t *_list_dup(list_t *license_list)
 	while ((license_src = list_next(iter))) {
 		license_dest = xmalloc(sizeof(licenses_t));
 		license_dest->name = xstrdup(license_src->name);
+		license_dest->id = license_src->id;
 		license_dest->used = license_src->used;
 		list_push(lic_list, license_dest);
 	}
@@ -611,6 +638,8 @@ static void _del_resv_rec(void *x)
 	slurmctld_resv_t *resv_ptr = (slurmctld_resv_t *) x;
 
 	if (resv_ptr) {
+		resv_index.valid = false;
+
 		/*
 		 * If shutting down magnetic_resv_list is already freed, meaning
 		 * we don't need to remove anything from it.
@@ -674,6 +703,7 @@ static void _add_resv_to_lists(slurmctld_resv_t *resv_ptr)
 	xassert(magnetic_resv_list);
 
 	list_append(resv_list, resv_ptr);
+	resv_index.valid = false;
 	if (resv_ptr->flags & RESERVE_FLAG_MAGNETIC)
 		list_append(magnetic_resv_list, resv_ptr);
 }
@@ -1561,6 +1591,8 @@ static int _build_uid_list(char *users, int *user_cnt, uid_t **user_list,
 		tok = strtok_r(NULL, ",", &last);
 	}
 	if (u_cnt > 0) {
+		/* Keep user_list sorted for uid_in_list() */
+		sort_uid_list(u_list, u_cnt);
 		*user_cnt  = u_cnt;
 		*user_list = u_list;
 		xfree(tmp);
@@ -1634,6 +1666,7 @@ static int _update_uid_list(slurmctld_resv_t *resv_ptr, char *users)
 		xfree(resv_ptr->user_list);
 		if (users[0] != '\0')
 			resv_ptr->users = xstrdup(users);
+		sort_uid_list(u_list, u_cnt);
 		resv_ptr->user_cnt  = u_cnt;
 		resv_ptr->user_list = u_list;
 		resv_ptr->ctld_flags &= (~RESV_CTLD_USER_NOT);
@@ -1722,14 +1755,8 @@ static int _update_uid_list(slurmctld_resv_t *resv_ptr, char *users)
 		for (i=0; i<u_cnt; i++) {
 			if (u_type[i] != 2)	/* not plus */
 				continue;
-			found_it = false;
-			for (j=0; j<resv_ptr->user_cnt; j++) {
-				if (resv_ptr->user_list[j] != u_list[i])
-					continue;
-				found_it = true;
-				break;
-			}
-			if (found_it)
+			if (uid_in_list(u_list[i], resv_ptr->user_list,
+					resv_ptr->user_cnt))
 				continue;	/* duplicate entry */
 			if (resv_ptr->users && resv_ptr->users[0])
 				xstrcat(resv_ptr->users, ",");
@@ -1740,6 +1767,7 @@ static int _update_uid_list(slurmctld_resv_t *resv_ptr, char *users)
 				 sizeof(uid_t) * (resv_ptr->user_cnt + 1));
 			resv_ptr->user_list[resv_ptr->user_cnt++] =
 				u_list[i];
+			sort_uid_list(resv_ptr->user_list, resv_ptr->user_cnt);
 		}
 	}
 	xfree(u_cpy);
@@ -3266,7 +3294,7 @@ extern int create_resv(resv_desc_msg_t *resv_desc_ptr, char **err_msg)
 	_set_tres_cnt(resv_ptr, NULL);
 
 	_add_resv_to_lists(resv_ptr);
-	last_resv_update = now;
+	_set_last_resv_update(now);
 	schedule_resv_save();
 
 	return SLURM_SUCCESS;
@@ -3288,6 +3316,8 @@ extern void resv_fini(void)
 {
 	FREE_NULL_LIST(magnetic_resv_list);
 	FREE_NULL_LIST(resv_list);
+	xfree(resv_index.ents);
+	resv_index.ent_alloc = 0;
 }
 
 static int _validate_reservation_access_update(void *x, void *y)
@@ -3931,7 +3961,7 @@ extern int update_resv(resv_desc_msg_t *resv_desc_ptr, char **err_msg)
 	_del_resv_rec(resv_backup);
 	(void) set_node_maint_mode(true);
 
-	last_resv_update = now;
+	_set_last_resv_update(now);
 	schedule_resv_save();
 	return error_code;
 
@@ -4016,7 +4046,7 @@ extern int delete_resv(reservation_name_msg_t *resv_desc_ptr)
 		return ESLURM_RESERVATION_INVALID;
 	}
 
-	last_resv_update = time(NULL);
+	_set_last_resv_update(time(NULL));
 	schedule_resv_save();
 	return rc;
 }
@@ -4316,7 +4346,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 		old_resv_ptr.assoc_list = NULL;
 		xfree(old_resv_ptr.tres_str);
 		xfree(old_resv_ptr.node_list);
-		last_resv_update = time(NULL);
+		_set_last_resv_update(time(NULL));
 	} else if (resv_ptr->flags & RESERVE_FLAG_ALL_NODES) {
 		memset(&old_resv_ptr, 0, sizeof(slurmctld_resv_t));
 		old_resv_ptr.assoc_list = resv_ptr->assoc_list;
@@ -4333,7 +4363,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 		old_resv_ptr.assoc_list = NULL;
 		xfree(old_resv_ptr.tres_str);
 		xfree(old_resv_ptr.node_list);
-		last_resv_update = time(NULL);
+		_set_last_resv_update(time(NULL));
 	} else if (resv_ptr->node_list) {	/* Change bitmap last */
 		/*
 		 * Node bitmap must be recreated in any case, i.e. when
@@ -4368,7 +4398,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 			old_resv_ptr.assoc_list = NULL;
 			xfree(old_resv_ptr.tres_str);
 			xfree(old_resv_ptr.node_list);
-			last_resv_update = time(NULL);
+			_set_last_resv_update(time(NULL));
 			schedule_resv_save();
 		}
 	}
@@ -4617,7 +4647,7 @@ static void _resv_node_replace(slurmctld_resv_t *resv_ptr)
 		_free_resv_select_members(&resv_select);
 	}
 	FREE_NULL_BITMAP(preserve_bitmap);
-	last_resv_update = time(NULL);
+	_set_last_resv_update(time(NULL));
 	schedule_resv_save();
 }
 
@@ -4745,11 +4775,8 @@ static bool _validate_user_access(slurmctld_resv_t *resv_ptr,
 				return 0;
 		}
 	} else {
-		for (int i = 0; i < resv_ptr->user_cnt; i++) {
-			if (resv_ptr->user_list[i] == uid)
-				return 1;
-		}
-		return 0;
+		return uid_in_list(uid, resv_ptr->user_list,
+				   resv_ptr->user_cnt);
 	}
 
 	return 1;
@@ -4795,7 +4822,7 @@ extern int load_all_resv_state(int recover)
 	slurmctld_resv_t *resv_ptr = NULL;
 	uint16_t protocol_version = NO_VAL16;
 
-	last_resv_update = time(NULL);
+	_set_last_resv_update(time(NULL));
 	if ((recover == 0) && resv_list) {
 		_validate_all_reservations();
 		return SLURM_SUCCESS;
@@ -6242,14 +6269,12 @@ static int _valid_job_access_resv(job_record_t *job_ptr,
 no_assocs:	if ((resv_ptr->user_cnt == 0) ||
 		    (resv_ptr->ctld_flags & RESV_CTLD_USER_NOT))
 			user_good = true;
-		for (i = 0; i < resv_ptr->user_cnt; i++) {
-			if (job_ptr->user_id == resv_ptr->user_list[i]) {
-				if (resv_ptr->ctld_flags & RESV_CTLD_USER_NOT)
-					user_good = false;
-				else
-					user_good = true;
-				break;
-			}
+		if (uid_in_list(job_ptr->user_id, resv_ptr->user_list,
+				resv_ptr->user_cnt)) {
+			if (resv_ptr->ctld_flags & RESV_CTLD_USER_NOT)
+				user_good = false;
+			else
+				user_good = true;
 		}
 		if (!user_good)
 			goto end_it;
@@ -6673,6 +6698,140 @@ static void _get_rel_start_end(slurmctld_resv_t *resv_ptr, time_t now,
 	}
 }
 
+/* Record a reservation change, any cached view of resv_list is now stale */
+static void _set_last_resv_update(time_t when)
+{
+	last_resv_update = when;
+	resv_index.valid = false;
+}
+
+static int _cmp_resv_index_start(const void *x, const void *y)
+{
+	const resv_index_ent_t *ent1 = x, *ent2 = y;
+
+	if (ent1->start_time < ent2->start_time)
+		return -1;
+	if (ent1->start_time > ent2->start_time)
+		return 1;
+	return 0;
+}
+
+static int _cmp_resv_index_inx(const void *x, const void *y)
+{
+	const resv_index_ent_t *ent1 = x, *ent2 = y;
+
+	return ent1->list_inx - ent2->list_inx;
+}
+
+static void _build_resv_index(void)
+{
+	slurmctld_resv_t *resv_ptr;
+	list_itr_t *iter;
+	int inx = 0, cnt = list_count(resv_list), float_cnt = 0;
+
+	if (cnt > resv_index.ent_alloc) {
+		resv_index.ent_alloc = cnt;
+		xrecalloc(resv_index.ents, resv_index.ent_alloc,
+			  sizeof(resv_index_ent_t));
+	}
+	resv_index.ent_cnt = cnt;
+	resv_index.sorted_cnt = 0;
+	resv_index.max_boot_time = 0;
+	resv_index.min_end_time = 0;
+
+	iter = list_iterator_create(resv_list);
+	while ((resv_ptr = list_next(iter))) {
+		resv_index_ent_t *ent;
+
+		if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
+			ent = &resv_index.ents[cnt - 1 - float_cnt++];
+		} else {
+			ent = &resv_index.ents[resv_index.sorted_cnt++];
+			if (!resv_index.min_end_time ||
+			    (resv_ptr->end_time < resv_index.min_end_time))
+				resv_index.min_end_time = resv_ptr->end_time;
+		}
+		ent->list_inx = inx++;
+		ent->resv_ptr = resv_ptr;
+		ent->start_time = resv_ptr->start_time_first;
+		resv_index.max_boot_time = MAX(resv_index.max_boot_time,
+					       resv_ptr->boot_time);
+	}
+	list_iterator_destroy(iter);
+
+	qsort(resv_index.ents, resv_index.sorted_cnt, sizeof(resv_index_ent_t),
+	      _cmp_resv_index_start);
+	resv_index.valid = true;
+}
+
+/*
+ * Get the reservations which may overlap a job running from start_time to
+ * end_time, in resv_list order. Callers still need to check the exact
+ * reservation times, this only drops those which start too late or have
+ * already ended.
+ * RET number of entries in *ents_out, xfree() it when done
+ */
+static int _get_resv_index_overlap(time_t now, time_t start_time,
+				   time_t end_time, bool reboot,
+				   resv_index_ent_t **ents_out)
+{
+	resv_index_ent_t *ents;
+	int cnt = 0, hi, lo, mid;
+
+	if (resv_index.valid && resv_index.sorted_cnt &&
+	    (resv_index.min_end_time <= now) &&
+	    (resv_index.advance_time != now)) {
+		/*
+		 * Recurring reservations which ended are moved to their next
+		 * time slot, as every walk of resv_list does. That makes the
+		 * index stale if any of them actually moved.
+		 */
+		slurmctld_resv_t *resv_ptr;
+		list_itr_t *iter = list_iterator_create(resv_list);
+
+		while ((resv_ptr = list_next(iter))) {
+			if (resv_ptr->end_time <= now)
+				(void) _advance_resv_time(resv_ptr);
+		}
+		list_iterator_destroy(iter);
+		resv_index.advance_time = now;
+	}
+	if (!resv_index.valid) {
+		_build_resv_index();
+		return _get_resv_index_overlap(now, start_time, end_time,
+					       reboot, ents_out);
+	}
+
+	if (reboot)
+		end_time += resv_index.max_boot_time;
+
+	/* Find the first sorted entry starting at or after end_time */
+	lo = 0;
+	hi = resv_index.sorted_cnt;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (resv_index.ents[mid].start_time < end_time)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	ents = xcalloc(lo + (resv_index.ent_cnt - resv_index.sorted_cnt) + 1,
+		       sizeof(resv_index_ent_t));
+	for (int i = 0; i < lo; i++) {
+		if (resv_index.ents[i].resv_ptr->end_time <= start_time)
+			continue;
+		ents[cnt++] = resv_index.ents[i];
+	}
+	for (int i = resv_index.sorted_cnt; i < resv_index.ent_cnt; i++)
+		ents[cnt++] = resv_index.ents[i];
+
+	qsort(ents, cnt, sizeof(resv_index_ent_t), _cmp_resv_index_inx);
+
+	*ents_out = ents;
+	return cnt;
+}
+
 extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 			 bool move_time, bitstr_t **node_bitmap,
 			 resv_exc_t *resv_exc_ptr, bool *resv_overlap,
@@ -6682,8 +6841,8 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	time_t job_start_time, job_end_time, job_end_time_use, lic_resv_time;
 	time_t start_relative, end_relative;
 	time_t now = time(NULL);
-	list_itr_t *iter;
-	int i, rc = SLURM_SUCCESS, rc2;
+	resv_index_ent_t *ents = NULL;
+	int ent_cnt, i, rc = SLURM_SUCCESS, rc2;
 
 	*resv_overlap = false;	/* initialize to false */
 	job_start_time = *when;
@@ -6765,8 +6924,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 		 * if there are any overlapping reservations, we need to
 		 * prevent the job from using those nodes (e.g. MAINT nodes)
 		 */
-		iter = list_iterator_create(resv_list);
-		while ((res2_ptr = list_next(iter))) {
+		ent_cnt = _get_resv_index_overlap(now, job_start_time,
+						  job_end_time, reboot, &ents);
+		for (int j = 0; j < ent_cnt; j++) {
+			res2_ptr = ents[j].resv_ptr;
+
 			if (reboot)
 				job_end_time_use =
 					job_end_time + res2_ptr->boot_time;
@@ -6796,7 +6958,7 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				bit_and_not(*node_bitmap,res2_ptr->node_bitmap);
 			}
 		}
-		list_iterator_destroy(iter);
+		xfree(ents);
 
 		if (slurm_conf.debug_flags & DEBUG_FLAG_RESERVATION) {
 			char *nodes = bitmap2node_name(*node_bitmap);
@@ -6840,8 +7002,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	for (i = 0; ; i++) {
 		lic_resv_time = (time_t) 0;
 
-		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = list_next(iter))) {
+		ent_cnt = _get_resv_index_overlap(now, job_start_time,
+						  job_end_time, reboot, &ents);
+		for (int j = 0; j < ent_cnt; j++) {
+			resv_ptr = ents[j].resv_ptr;
+
 			_get_rel_start_end(
 				resv_ptr, now, &start_relative, &end_relative);
 
@@ -6949,7 +7114,7 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				continue;
 			}
 		}
-		list_iterator_destroy(iter);
+		xfree(ents);
 
 		if (resv_exc_ptr) {
 			free_core_array(&resv_exc_ptr->exc_cores);
@@ -7231,7 +7396,7 @@ static int _advance_resv_time(slurmctld_resv_t *resv_ptr)
 		resv_ptr->ctld_flags &= (~RESV_CTLD_PROLOG);
 		resv_ptr->ctld_flags &= (~RESV_CTLD_EPILOG);
 		_post_resv_create(resv_ptr);
-		last_resv_update = time(NULL);
+		_set_last_resv_update(time(NULL));
 		schedule_resv_save();
 		rc = SLURM_SUCCESS;
 	} else {
@@ -7347,7 +7512,7 @@ extern void job_resv_check(void)
 				_advance_resv_time(resv_ptr);
 			}
 
-			last_resv_update = now;
+			_set_last_resv_update(now);
 			schedule_resv_save();
 			continue;
 		}
@@ -7374,7 +7539,7 @@ extern void job_resv_check(void)
 			}
 			_clear_job_resv(resv_ptr);
 			list_delete_item(iter);
-			last_resv_update = now;
+			_set_last_resv_update(now);
 			schedule_resv_save();
 		}
 	}
@@ -7585,7 +7750,7 @@ extern void update_part_nodes_in_resv(part_record_t *part_ptr)
 			old_resv_ptr.assoc_list = NULL;
 			xfree(old_resv_ptr.tres_str);
 			xfree(old_resv_ptr.node_list);
-			last_resv_update = time(NULL);
+			_set_last_resv_update(time(NULL));
 			_set_boot_time(resv_ptr);
 		}
 	}
@@ -7783,7 +7948,7 @@ extern void reservation_update_groups(int force)
 	if (updated) {
 		debug2("%s: list updated, resetting last_resv_update time",
 		       __func__);
-		last_resv_update = time(NULL);
+		_set_last_resv_update(time(NULL));
 	}
 
 	END_TIMER2(__func__);
@@ -43,8 +43,10 @@
 
 #include "src/common/list.h"
 #include "src/common/macros.h"
+#include "src/common/mpsc_queue.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -57,11 +59,82 @@
 
 bool enabled = true;
 
+typedef struct {
+	uid_t uid;
+	uint16_t count;
+} rpc_user_cnt_t;
+
+static void _user_cnt_id(void *item, const char **key, uint32_t *key_len)
+{
+	rpc_user_cnt_t *user = item;
+
+	*key = (const char *) &user->uid;
+	*key_len = sizeof(user->uid);
+}
+
+/*
+ * Dequeue the next message to process in this cycle.
+ *
+ * With max_per_user_per_cycle set, messages from a user who has already used
+ * up their share of this cycle are set aside on the deferred list, and are
+ * processed ahead of newly arrived work on the next cycle. This keeps one
+ * user's burst from monopolizing the queue.
+ */
+static slurm_msg_t *_dequeue(slurmctld_rpc_t *q, list_t *carry,
+			     list_t *deferred, xhash_t *users)
+{
+	slurm_msg_t *msg;
+
+	if (!q->max_per_user_per_cycle)
+		return mpsc_queue_dequeue(q->work);
+
+	while ((msg = list_dequeue(carry)) || (msg = mpsc_queue_dequeue(q->work))) {
+		rpc_user_cnt_t *user = xhash_get(users,
+						 (const char *) &msg->auth_uid,
+						 sizeof(msg->auth_uid));
+
+		if (!user) {
+			user = xmalloc(sizeof(*user));
+			user->uid = msg->auth_uid;
+			xhash_add(users, user);
+		}
+
+		if (user->count < q->max_per_user_per_cycle) {
+			user->count++;
+			return msg;
+		}
+
+		list_append(deferred, msg);
+	}
+
+	return NULL;
+}
+
+/*
+ * Close and free messages processed during the last cycle. This is deferred
+ * until after the slurmctld locks are released to keep the lock hold time of
+ * a batch down to the RPC handlers themselves.
+ */
+static void _free_processed(list_t *done)
+{
+	slurm_msg_t *msg;
+
+	while ((msg = list_dequeue(done))) {
+		if ((msg->conn_fd >= 0) && (close(msg->conn_fd) < 0))
+			error("close(%d): %m", msg->conn_fd);
+		slurm_free_msg(msg);
+	}
+}
+
 static void *_rpc_queue_worker(void *arg)
 {
 	slurmctld_rpc_t *q = (slurmctld_rpc_t *) arg;
 	int processed = 0;
 	long processed_usec = 0;
+	list_t *carry = list_create(NULL);
+	list_t *deferred = list_create(NULL);
+	list_t *done = list_create(NULL);
+	xhash_t *users = xhash_init(_user_cnt_id, xfree_ptr);
 
 #if HAVE_SYS_PRCTL_H
 	char *name = xstrdup_printf("rpcq-%u", q->msg_type);
@@ -92,11 +165,19 @@ static void *_rpc_queue_worker(void *arg)
 		     (processed_usec >= q->max_usec_per_cycle)))
 			highload = true;
 		else
-			msg = list_dequeue(q->work);
+			msg = _dequeue(q, carry, deferred, users);
+
+		if (!msg && list_count(deferred))
+			highload = true;
 
 		if (!msg) {
+			if (processed && q->locked_post_func)
+				q->locked_post_func();
+
 			unlock_slurmctld(q->locks);
 
+			_free_processed(done);
+
 			if (processed && q->post_func)
 				q->post_func();
 
@@ -141,21 +222,29 @@ static void *_rpc_queue_worker(void *arg)
 			processed_usec = 0;
 			usleep(sleep_usec);
 
+			/* start the next cycle with the messages set aside */
+			list_transfer(carry, deferred);
+			xhash_clear(users);
+
 			slurm_mutex_lock(&q->mutex);
 
 			if (q->shutdown) {
 				log_flag(PROTOCOL, "%s(%s): shutting down",
 					 __func__, q->msg_name);
 				slurm_mutex_unlock(&q->mutex);
+				FREE_NULL_LIST(carry);
+				FREE_NULL_LIST(deferred);
+				FREE_NULL_LIST(done);
+				xhash_free(users);
 				return NULL;
 			}
 
 			/*
-			 * Verify list is empty. Since list_dequeue() above is
-			 * called without the mutex held, there is a race with
+			 * Verify queue is empty. Since the dequeue above is
+			 * done without the mutex held, there is a race with
 			 * rpc_enqueue() that this check will solve.
 			 */
-			if (!list_count(q->work))
+			if (mpsc_queue_is_empty(q->work) && !list_count(carry))
 				slurm_cond_wait(&q->cond, &q->mutex);
 
 			slurm_mutex_unlock(&q->mutex);
@@ -168,17 +257,14 @@ static void *_rpc_queue_worker(void *arg)
 			if (q->max_queued) {
 				slurm_mutex_lock(&q->mutex);
 				q->queued--;
-				record_rpc_queue_stats(q);
 				slurm_mutex_unlock(&q->mutex);
 			}
 			msg->flags |= CTLD_QUEUE_PROCESSING;
 			q->func(msg);
-			if ((msg->conn_fd >= 0) && (close(msg->conn_fd) < 0))
-				error("close(%d): %m", msg->conn_fd);
 
 			END_TIMER;
 			record_rpc_stats(msg, DELTA_TIMER);
-			slurm_free_msg(msg);
+			list_append(done, msg);
 			processed++;
 			processed_usec += DELTA_TIMER;
 		}
@@ -258,6 +344,10 @@ static void _apply_config(data_t *conf, slurmctld_rpc_t *q)
 		if (!data_get_int_converted(field, &int64_tmp))
 			q->max_usec_per_cycle = int64_tmp;
 
+	if ((field = data_key_get(settings, "max_per_user_per_cycle")))
+		if (!data_get_int_converted(field, &int64_tmp))
+			q->max_per_user_per_cycle = int64_tmp;
+
 	if ((field = data_key_get(settings, "max_queued")))
 		if (!data_get_int_converted(field, &int64_tmp))
 			q->max_queued = int64_tmp;
@@ -298,14 +388,14 @@ extern void rpc_queue_init(void)
 			continue;
 		}
 
-		q->work = list_create(NULL);
+		q->work = mpsc_queue_create();
 		slurm_cond_init(&q->cond, NULL);
 		slurm_mutex_init(&q->mutex);
 		q->shutdown = false;
 
-		verbose("starting rpc_queue for %s: max_per_cycle=%u max_usec_per_cycle=%u max_queued=%d hard_drop=%d yield_sleep=%d interval=%d",
+		verbose("starting rpc_queue for %s: max_per_cycle=%u max_usec_per_cycle=%u max_per_user_per_cycle=%u max_queued=%d hard_drop=%d yield_sleep=%d interval=%d",
 			q->msg_name, q->max_per_cycle, q->max_usec_per_cycle,
-			q->max_queued, q->hard_drop, q->yield_sleep,
+			q->max_per_user_per_cycle, q->max_queued, q->hard_drop, q->yield_sleep,
 			q->interval);
 		slurm_thread_create(&q->thread, _rpc_queue_worker, q);
 	}
@@ -337,7 +427,7 @@ extern void rpc_queue_shutdown(void)
 			continue;
 
 		slurm_thread_join(q->thread);
-		FREE_NULL_LIST(q->work);
+		FREE_NULL_MPSC_QUEUE(q->work);
 	}
 }
 
@@ -372,7 +462,7 @@ extern int rpc_enqueue(slurm_msg_t *msg)
 				slurm_mutex_unlock(&q->mutex);
 			}
 
-			list_enqueue(q->work, msg);
+			mpsc_queue_enqueue(q->work, msg);
 			slurm_mutex_lock(&q->mutex);
 			slurm_cond_signal(&q->cond);
 			slurm_mutex_unlock(&q->mutex);
@@ -220,6 +220,11 @@ typedef struct diag_stats {
 	uint32_t bf_table_size_sum;
 	time_t   bf_when_last_cycle;
 
+	uint32_t fair_tree_cycle_counter;
+	uint32_t fair_tree_cycle_last;
+	uint32_t fair_tree_cycle_max;
+	uint64_t fair_tree_cycle_sum;
+
 	uint32_t latency;
 } diag_stats_t;
 
@@ -289,6 +294,8 @@ typedef struct node_features {
 
 extern list_t *active_feature_list; /* list of currently active node features */
 extern list_t *avail_feature_list;  /* list of available node features */
+extern uint64_t feature_list_gen;    /* incremented on any change to the
+				      * active or available feature lists */
 extern list_t *conf_includes_list;  /* list of conf_includes_map_t */
 
 #define PACK_FANOUT_ADDRS(_X) \
@@ -885,6 +892,12 @@ extern int job_fail_qos(job_record_t *job_ptr, const char *func_name,
  */
 extern void delete_job_desc_files(uint32_t job_id);
 
+/*
+ * purge_batch_files - remove the shared batch scripts and environments
+ * (SlurmctldParameters=dedup_batch_files) no job directory links to anymore
+ */
+extern void purge_batch_files(void);
+
 /*
  * job_alloc_info - get details about an existing job allocation
  * IN uid - job issuing the code
@@ -1202,6 +1215,14 @@ extern int job_set_top(top_job_msg_t *top_ptr, uid_t uid, int conn_fd,
  */
 extern void job_time_limit (void);
 
+/*
+ * Record that job_time_limit() must test this job from now on. Called
+ * whenever the job's state changes, the job is dropped again once it is no
+ * longer running, suspended or configuring.
+ */
+extern void time_limit_index_notify(job_record_t *job_ptr,
+				    uint32_t new_state);
+
 /* Builds the tres_req_cnt and tres_req_str of a job.
  * Only set when job is pending.
  * NOTE: job write lock must be locked before calling this */
@@ -1402,6 +1423,20 @@ extern int dump_job_state(const uint32_t filter_jobs_count,
 extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 			    uint16_t protocol_version);
 
+/*
+ * pack_delta_jobs - dump job information for all jobs, but only include the
+ *	records of jobs that changed since last_update
+ * IN last_update - time of the client's previous job information
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * IN protocol_version - slurm protocol version of client
+ * OUT buffer
+ * global: job_list - global list of job records
+ * NOTE: the IDs of all jobs the user can see are packed after the records
+ */
+extern buf_t *pack_delta_jobs(time_t last_update, uint16_t show_flags,
+			      uid_t uid, uint16_t protocol_version);
+
 /*
  * pack_spec_jobs - dump job information for specified jobs in
  *	machine independent form (for network transmission)
@@ -1418,6 +1453,39 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
 			     uint32_t filter_uid, uint16_t protocol_version);
 
+/*
+ * job_state_shard_config - read SlurmctldParameters=job_state_shards
+ */
+extern void job_state_shard_config(void);
+
+/*
+ * job_info_snapshot_config - read SlurmctldParameters=job_info_max_age and
+ *	discard any saved snapshots
+ */
+extern void job_info_snapshot_config(void);
+
+/*
+ * job_info_snapshot_get - get a copy of a recently packed response to
+ *	REQUEST_JOB_INFO for all jobs, without taking any slurmctld locks
+ * IN last_update - time of the data the client already has
+ * IN show_flags - job filtering options
+ * IN uid - uid of user making request
+ * IN protocol_version - slurm protocol version of client
+ * RET buffer to send or NULL if no usable snapshot is available
+ */
+extern buf_t *job_info_snapshot_get(time_t last_update, uint16_t show_flags,
+				    uid_t uid, uint16_t protocol_version);
+
+/*
+ * job_info_snapshot_save - save a copy of the response from pack_all_jobs()
+ *	for job_info_snapshot_get()
+ * IN buffer - response packed by pack_all_jobs() with filter_uid of NO_VAL
+ * IN show_flags, uid, protocol_version - as passed to pack_all_jobs()
+ * NOTE: Call with the job and part read locks still held
+ */
+extern void job_info_snapshot_save(buf_t *buffer, uint16_t show_flags,
+				   uid_t uid, uint16_t protocol_version);
+
 /*
  * pack_all_nodes - dump all configuration and node information for all nodes
  *	in machine independent form (for network transmission)
@@ -2007,6 +2075,17 @@ extern int validate_group(part_record_t *part_ptr, uid_t run_uid);
 extern int validate_job_create_req(job_desc_msg_t *job_desc, uid_t submit_uid,
 				   char **err_msg);
 
+/*
+ * Run the job_submit plugins able to evaluate a request without slurmctld
+ * locks (SlurmctldParameters=job_submit_unlocked). Call with no locks held,
+ * before validate_job_create_req() for the same job_desc.
+ * IN job_desc   - user job submit request
+ * IN submit_uid - UID making job submit request
+ * OUT err_msg   - custom error message to return
+ * RET 0 or error code */
+extern int validate_job_create_req_unlocked(job_desc_msg_t *job_desc,
+					    uid_t submit_uid, char **err_msg);
+
 /*
  * validate_jobs_on_node - validate that any jobs that should be on the node
  *	are actually running, if not clean up the job records and/or node
@@ -2016,6 +2095,14 @@ extern int validate_job_create_req(job_desc_msg_t *job_desc, uid_t submit_uid,
  */
 extern void validate_jobs_on_node(slurm_msg_t *slurm_msg);
 
+/*
+ * purge_missing_jobs_batch - finish validate_jobs_on_node() for the
+ *	registrations processed from the RPC queue in this cycle, checking
+ *	the job list once for all of their nodes.
+ * NOTE: Call with the node registration RPC locks still held
+ */
+extern void purge_missing_jobs_batch(void);
+
 /*
  * validate_node_specs - validate the node's specifications as valid,
  *	if not set state to down, in any case update last_response
@@ -140,6 +140,18 @@ static pthread_cond_t powersave_script_cond = PTHREAD_COND_INITIALIZER;
 static int powersave_script_count = 0;
 static bool powersave_wait_called = false;
 
+/* SlurmctldParameters=max_script_concurrency */
+typedef struct {
+	bool flushed;
+	uint32_t job_id;
+} script_waiter_t;
+
+static pthread_mutex_t script_limit_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t script_limit_cond = PTHREAD_COND_INITIALIZER;
+static int max_script_concurrency = 0; /* 0 is unlimited */
+static int running_script_cnt[SLURMSCRIPTD_RESV + 1];
+static list_t *waiting_script_list = NULL;
+
 
 /* Function definitions: */
 
@@ -674,10 +686,96 @@ static int _run_script(run_command_args_t *run_command_args,
 	return status;
 }
 
+static bool _script_type_limited(script_type_t script_type)
+{
+	/*
+	 * Power save scripts are already limited by ResumeRate and
+	 * SuspendRate, and shutdown waits for them to finish.
+	 */
+	if (!max_script_concurrency ||
+	    (script_type <= SLURMSCRIPTD_NONE) ||
+	    (script_type > SLURMSCRIPTD_RESV) ||
+	    (script_type == SLURMSCRIPTD_POWER))
+		return false;
+	return true;
+}
+
+/*
+ * Wait until fewer than max_script_concurrency scripts of this type are
+ * running.
+ * RET false if the request was flushed while waiting and must not be run.
+ */
+static bool _script_slot_acquire(script_type_t script_type, uint32_t job_id)
+{
+	script_waiter_t waiter = { .job_id = job_id };
+	bool run = true;
+
+	if (!_script_type_limited(script_type))
+		return true;
+
+	slurm_mutex_lock(&script_limit_mutex);
+	if (running_script_cnt[script_type] >= max_script_concurrency) {
+		log_flag(SCRIPT, "%s: JobId=%u waiting, %d scripts of type %d already running",
+			 __func__, job_id, running_script_cnt[script_type],
+			 script_type);
+		list_append(waiting_script_list, &waiter);
+		while (!waiter.flushed &&
+		       (running_script_cnt[script_type] >=
+			max_script_concurrency))
+			slurm_cond_wait(&script_limit_cond,
+					&script_limit_mutex);
+		list_delete_ptr(waiting_script_list, &waiter);
+		run = !waiter.flushed;
+	}
+	if (run)
+		running_script_cnt[script_type]++;
+	slurm_mutex_unlock(&script_limit_mutex);
+
+	return run;
+}
+
+static void _script_slot_release(script_type_t script_type)
+{
+	if (!_script_type_limited(script_type))
+		return;
+
+	slurm_mutex_lock(&script_limit_mutex);
+	running_script_cnt[script_type]--;
+	slurm_cond_broadcast(&script_limit_cond);
+	slurm_mutex_unlock(&script_limit_mutex);
+}
+
+static int _flush_waiter(void *x, void *arg)
+{
+	script_waiter_t *waiter = x;
+	uint32_t *job_id = arg;
+
+	if (!job_id || (waiter->job_id == *job_id))
+		waiter->flushed = true;
+
+	return 0;
+}
+
+/*
+ * Drop scripts that are still waiting for a slot.
+ * IN job_id - only drop scripts for this job, or all if NULL
+ */
+static void _flush_waiting_scripts(uint32_t *job_id)
+{
+	if (!waiting_script_list)
+		return;
+
+	slurm_mutex_lock(&script_limit_mutex);
+	(void) list_for_each(waiting_script_list, _flush_waiter, job_id);
+	slurm_cond_broadcast(&script_limit_cond);
+	slurm_mutex_unlock(&script_limit_mutex);
+}
+
 static int _handle_flush(slurmscriptd_msg_t *recv_msg)
 {
 	log_flag(SCRIPT, "Handling %s", rpc_num2string(recv_msg->msg_type));
 	/* Kill all running scripts */
+	_flush_waiting_scripts(NULL);
 	track_script_flush();
 	/*
 	 * DO NOT CALL _wait_for_powersave_scripts HERE. That would result in
@@ -700,6 +798,7 @@ static int _handle_flush_job(slurmscriptd_msg_t *recv_msg)
 	log_flag(SCRIPT, "Handling %s for JobId=%u",
 		 rpc_num2string(recv_msg->msg_type), flush_msg->job_id);
 
+	_flush_waiting_scripts(&flush_msg->job_id);
 	track_script_flush_job(flush_msg->job_id);
 
 	return SLURM_SUCCESS;
@@ -710,6 +809,7 @@ static int _handle_shutdown(slurmscriptd_msg_t *recv_msg)
 	log_flag(SCRIPT, "Handling %s", rpc_num2string(recv_msg->msg_type));
 	/* Kill or orphan all running scripts. */
 	_wait_for_powersave_scripts();
+	_flush_waiting_scripts(NULL);
 	track_script_flush();
 
 	eio_signal_shutdown(msg_handle);
@@ -744,6 +844,15 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 		 script_msg->argc,
 		 recv_msg->key);
 
+	if (!_script_slot_acquire(script_msg->script_type,
+				  script_msg->job_id)) {
+		log_flag(SCRIPT, "%s: JobId=%u %s flushed before it started",
+			 __func__, script_msg->job_id, script_msg->script_name);
+		status = SIGKILL; /* report as killed, like a running script */
+		signalled = true;
+		goto send_resp;
+	}
+
 	switch (script_msg->script_type) {
 	case SLURMSCRIPTD_BB_LUA:
 		/* Set SLURM_SCRIPT_CONTEXT in env for slurmctld */
@@ -797,7 +906,9 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 		status = SLURM_ERROR;
 		break;
 	}
+	_script_slot_release(script_msg->script_type);
 
+send_resp:
 	/* Send response */
 	rc = _respond_to_slurmctld(recv_msg->key, script_msg->job_id,
 				   resp_msg, script_msg->script_name,
@@ -1068,11 +1179,25 @@ static void _setup_eio(int fd)
 
 static void _slurmscriptd_mainloop(char *binary_path)
 {
+	char *tmp_ptr;
+
 	if ((run_command_init(0, NULL, binary_path) != SLURM_SUCCESS) &&
 	    binary_path && binary_path[0])
 		fatal("%s: Unable to reliably execute %s",
 		      __func__, binary_path);
 
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "max_script_concurrency="))) {
+		int tmp_val = strtol(tmp_ptr + 23, NULL, 10);
+		if (tmp_val >= 0)
+			max_script_concurrency = tmp_val;
+		else
+			error("SlurmctldParameters option max_script_concurrency=%d out of range, ignored",
+			      tmp_val);
+	}
+	if (max_script_concurrency)
+		waiting_script_list = list_create(NULL);
+
 	_setup_eio(slurmscriptd_readfd);
 
 	debug("%s: started", __func__);
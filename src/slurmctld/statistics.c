@@ -39,9 +39,11 @@
 #include <stdio.h>
 
 #include "src/slurmctld/agent.h"
+#include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/common/list.h"
 #include "src/common/pack.h"
+#include "src/common/plugin_stats.h"
 #include "src/common/xstring.h"
 #include "src/common/slurmdbd_defs.h"
 
@@ -225,5 +227,14 @@ extern void reset_stats(int level)
 	memset(slurmctld_diag_stats.bf_exit, 0,
 	       sizeof(slurmctld_diag_stats.bf_exit));
 
+	slurmctld_diag_stats.fair_tree_cycle_counter = 0;
+	slurmctld_diag_stats.fair_tree_cycle_last = 0;
+	slurmctld_diag_stats.fair_tree_cycle_max = 0;
+	slurmctld_diag_stats.fair_tree_cycle_sum = 0;
+
+	lock_stats_reset();
+	bit_cache_reset_stats();
+	plugin_stats_reset();
+
 	last_proc_req_start = time(NULL);
 }
@@ -97,6 +97,9 @@ static bool trigger_pri_dbd_res_op = false;
 static bool trigger_pri_db_fail = false;
 static bool trigger_pri_db_res_op = false;
 
+/* Idle node bitmaps built during one trigger_process() pass */
+static list_t *idle_bitmap_list = NULL;
+
 /* Current trigger pull states (saved and restored) */
 uint8_t ctld_failure = 0;
 uint8_t bu_ctld_failure = 0;
@@ -124,6 +127,11 @@ typedef struct trig_mgr_info {
 	time_t   orig_time;	/* offset (pending) or time stamp (complete) */
 } trig_mgr_info_t;
 
+typedef struct {
+	bitstr_t *bitmap;	/* nodes idle since min_idle */
+	time_t min_idle;
+} idle_bitmap_t;
+
 static void _trig_del(void *x)
 {
 	trig_mgr_info_t *tmp = x;
@@ -1157,6 +1165,52 @@ static void _trigger_other_event(trig_mgr_info_t *trig_in, time_t now)
 	}
 }
 
+static void _idle_bitmap_del(void *x)
+{
+	idle_bitmap_t *idle = x;
+
+	FREE_NULL_BITMAP(idle->bitmap);
+	xfree(idle);
+}
+
+static int _find_idle_bitmap(void *x, void *key)
+{
+	idle_bitmap_t *idle = x;
+	time_t *min_idle = key;
+
+	return (idle->min_idle == *min_idle);
+}
+
+/*
+ * Return a bitmap of nodes idle since min_idle. Triggers typically share a
+ * handful of offsets, so the bitmaps are kept until the end of the pass
+ * rather than rebuilt by walking every node for each IDLE trigger.
+ */
+static bitstr_t *_get_idle_bitmap(time_t min_idle)
+{
+	idle_bitmap_t *idle;
+	node_record_t *node_ptr;
+
+	if (!idle_bitmap_list)
+		idle_bitmap_list = list_create(_idle_bitmap_del);
+	else if ((idle = list_find_first(idle_bitmap_list, _find_idle_bitmap,
+					 &min_idle)))
+		return idle->bitmap;
+
+	idle = xmalloc(sizeof(*idle));
+	idle->min_idle = min_idle;
+	idle->bitmap = bit_alloc(node_record_count);
+	for (int i = 0; (node_ptr = next_node(&i)); i++) {
+		if (!IS_NODE_IDLE(node_ptr) ||
+		    (node_ptr->last_busy > min_idle))
+			continue;
+		bit_set(idle->bitmap, node_ptr->index);
+	}
+	list_append(idle_bitmap_list, idle);
+
+	return idle->bitmap;
+}
+
 static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 {
 	xassert(verify_lock(NODE_LOCK, READ_LOCK));
@@ -1243,17 +1297,8 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 		/* We need to determine which (if any) of these
 		 * nodes have been idle for at least the offset time */
 		time_t min_idle = now - (trig_in->trig_time - 0x8000);
-		int i;
-		node_record_t *node_ptr;
-		bitstr_t *trigger_idle_node_bitmap;
-
-		trigger_idle_node_bitmap = bit_alloc(node_record_count);
-		for (i = 0; (node_ptr = next_node(&i)); i++) {
-			if (!IS_NODE_IDLE(node_ptr) ||
-			    (node_ptr->last_busy > min_idle))
-				continue;
-			bit_set(trigger_idle_node_bitmap, node_ptr->index);
-		}
+		bitstr_t *trigger_idle_node_bitmap = _get_idle_bitmap(min_idle);
+
 		if (trig_in->nodes_bitmap == NULL) {    /* all nodes */
 			xfree(trig_in->res_id);
 			trig_in->res_id = bitmap2node_name(
@@ -1268,7 +1313,6 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 					  trig_in->nodes_bitmap);
 			trig_in->state = 1;
 		}
-		FREE_NULL_BITMAP(trigger_idle_node_bitmap);
 		if (trig_in->state == 1) {
 			trig_in->trig_time = now;
 			log_flag(TRIGGERS, "trigger[%u] for node %s idle",
@@ -1564,6 +1608,63 @@ static void _trigger_run_program(trig_mgr_info_t *trig_in)
 		xfree(args[i]);
 }
 
+static bool _bitmap_set(bitstr_t *bitmap)
+{
+	return (bitmap && (bit_ffs(bitmap) != -1));
+}
+
+/*
+ * Build a mask of the TRIGGER_TYPE_* events recorded since the last pass.
+ * TRIGGER_TYPE_IDLE is time based and always included.
+ */
+static uint32_t _pending_event_types(void)
+{
+	uint32_t events = TRIGGER_TYPE_IDLE;
+
+	if (_bitmap_set(trigger_down_front_end_bitmap) ||
+	    _bitmap_set(trigger_down_nodes_bitmap))
+		events |= TRIGGER_TYPE_DOWN;
+	if (_bitmap_set(trigger_up_front_end_bitmap) ||
+	    _bitmap_set(trigger_up_nodes_bitmap))
+		events |= TRIGGER_TYPE_UP;
+	if (_bitmap_set(trigger_drained_nodes_bitmap))
+		events |= TRIGGER_TYPE_DRAINED;
+	if (_bitmap_set(trigger_fail_nodes_bitmap))
+		events |= TRIGGER_TYPE_FAIL;
+	if (_bitmap_set(trigger_draining_nodes_bitmap))
+		events |= TRIGGER_TYPE_DRAINING;
+	if (_bitmap_set(trigger_resume_nodes_bitmap))
+		events |= TRIGGER_TYPE_RESUME;
+	if (trigger_node_reconfig)
+		events |= TRIGGER_TYPE_RECONFIG;
+	if (trigger_bb_error)
+		events |= TRIGGER_TYPE_BURST_BUFFER;
+	if (trigger_pri_ctld_fail)
+		events |= TRIGGER_TYPE_PRI_CTLD_FAIL;
+	if (trigger_pri_ctld_res_op)
+		events |= TRIGGER_TYPE_PRI_CTLD_RES_OP;
+	if (trigger_pri_ctld_res_ctrl)
+		events |= TRIGGER_TYPE_PRI_CTLD_RES_CTRL;
+	if (trigger_pri_ctld_acct_buffer_full)
+		events |= TRIGGER_TYPE_PRI_CTLD_ACCT_FULL;
+	if (trigger_bu_ctld_fail)
+		events |= TRIGGER_TYPE_BU_CTLD_FAIL;
+	if (trigger_bu_ctld_res_op)
+		events |= TRIGGER_TYPE_BU_CTLD_RES_OP;
+	if (trigger_bu_ctld_as_ctrl)
+		events |= TRIGGER_TYPE_BU_CTLD_AS_CTRL;
+	if (trigger_pri_dbd_fail)
+		events |= TRIGGER_TYPE_PRI_DBD_FAIL;
+	if (trigger_pri_dbd_res_op)
+		events |= TRIGGER_TYPE_PRI_DBD_RES_OP;
+	if (trigger_pri_db_fail)
+		events |= TRIGGER_TYPE_PRI_DB_FAIL;
+	if (trigger_pri_db_res_op)
+		events |= TRIGGER_TYPE_PRI_DB_RES_OP;
+
+	return events;
+}
+
 static void _clear_event_triggers(void)
 {
 	if (trigger_down_front_end_bitmap)
@@ -1593,6 +1694,7 @@ static void _clear_event_triggers(void)
 	trigger_pri_dbd_res_op = false;
 	trigger_pri_db_fail = false;
 	trigger_pri_db_res_op = false;
+	FREE_NULL_LIST(idle_bitmap_list);
 }
 
 /* Make a copy of a trigger and pre-pend it on our list */
@@ -1628,6 +1730,7 @@ extern void trigger_process(void)
 	trig_mgr_info_t *trig_in;
 	time_t now = time(NULL);
 	bool state_change = false;
+	uint32_t events;
 	pid_t rc;
 	int prog_stat;
 
@@ -1635,9 +1738,18 @@ extern void trigger_process(void)
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 
+	events = _pending_event_types();
 	trig_iter = list_iterator_create(trigger_list);
 	while ((trig_in = list_next(trig_iter))) {
 		if (trig_in->state == 0) {
+			/*
+			 * Nothing this trigger waits on has happened.
+			 * Job triggers depend on job state, not on events.
+			 */
+			if ((trig_in->res_type != TRIGGER_RES_TYPE_JOB) &&
+			    !(trig_in->trig_type & events))
+				continue;
+
 			if (trig_in->res_type == TRIGGER_RES_TYPE_OTHER)
 				_trigger_other_event(trig_in, now);
 			else if (trig_in->res_type == TRIGGER_RES_TYPE_JOB)
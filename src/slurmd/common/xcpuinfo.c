@@ -167,6 +167,83 @@ static inline int _internal_hwloc_topology_export_xml(
 #endif
 }
 
+/*
+ * Describe what the whole system topology file depends on. A file written
+ * during the same boot, with the same online cpus, hwloc version and E-core
+ * handling is reused on slurmd startup instead of discovering the hardware
+ * again. Return NULL if it can not be determined, xfree() the result.
+ */
+static char *_topo_fingerprint(void)
+{
+	char *files[] = { "/proc/sys/kernel/random/boot_id",
+			  "/sys/devices/system/cpu/online" };
+	char *fp = NULL, line[1024];
+
+	xstrfmtcat(fp, "hwloc=0x%x ecore=%d", (unsigned int) HWLOC_API_VERSION,
+		   (slurm_conf.conf_flags & CONF_FLAG_ECORE) ? 1 : 0);
+
+	for (int i = 0; i < ARRAY_SIZE(files); i++) {
+		FILE *f = fopen(files[i], "r");
+
+		if (!f || !fgets(line, sizeof(line), f)) {
+			if (f)
+				fclose(f);
+			xfree(fp);
+			return NULL;
+		}
+		fclose(f);
+		line[strcspn(line, "\n")] = '\0';
+		xstrfmtcat(fp, " %s", line);
+	}
+
+	return fp;
+}
+
+static bool _topo_fingerprint_match(char *topo_file)
+{
+	char *fp_file = xstrdup_printf("%s.fingerprint", topo_file);
+	char *fp = _topo_fingerprint(), line[2048];
+	bool match = false;
+	FILE *f;
+
+	if (fp && (f = fopen(fp_file, "r"))) {
+		if (fgets(line, sizeof(line), f)) {
+			line[strcspn(line, "\n")] = '\0';
+			match = !xstrcmp(line, fp);
+		}
+		fclose(f);
+	}
+
+	xfree(fp);
+	xfree(fp_file);
+	return match;
+}
+
+static void _topo_fingerprint_save(char *topo_file)
+{
+	char *fp_file = xstrdup_printf("%s.fingerprint", topo_file);
+	char *fp = _topo_fingerprint();
+	FILE *f;
+
+	if (fp && (f = fopen(fp_file, "w"))) {
+		int rc = fprintf(f, "%s\n", fp);
+
+		if (fclose(f) || (rc < 0))
+			(void) unlink(fp_file);
+	}
+
+	xfree(fp);
+	xfree(fp_file);
+}
+
+static void _topo_fingerprint_remove(char *topo_file)
+{
+	char *fp_file = xstrdup_printf("%s.fingerprint", topo_file);
+
+	(void) unlink(fp_file);
+	xfree(fp_file);
+}
+
 static void _remove_ecores(hwloc_topology_t *topology)
 {
 #if HWLOC_API_VERSION > 0x00020401
@@ -249,9 +326,17 @@ extern int xcpuinfo_hwloc_topo_load(
 	}
 
 	if (full && first_full) {
-		/* Always regenerate file on slurmd startup */
-		if (refresh_hwloc)
-			check_file = false;
+		/*
+		 * Regenerate file on slurmd startup, unless it was written for
+		 * this same hardware.
+		 */
+		if (refresh_hwloc) {
+			if (_topo_fingerprint_match(topo_file))
+				debug("%s: hardware unchanged, reusing %s",
+				      __func__, topo_file);
+			else
+				check_file = false;
+		}
 		first_full = false;
 	}
 
@@ -309,10 +394,14 @@ handle_write:
 	_remove_ecores(topology);
 
 	if (!conf->def_config) {
+		if (full)
+			_topo_fingerprint_remove(topo_file);
 		debug2("hwloc_topology_export_xml");
 		if (_internal_hwloc_topology_export_xml(*topology, topo_file)) {
 			/* error in export hardware topology */
 			error("%s: failed (load will be required after read failures).", __func__);
+		} else if (full) {
+			_topo_fingerprint_save(topo_file);
 		}
 	}
 
@@ -35,6 +35,7 @@
 
 #include "src/common/pack.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -45,9 +46,12 @@
 /* FIXME: Y2038 problem */
 #define MAX_TIME 0x7fffffff
 
+#define CRED_STATE_KEY_LEN (sizeof(slurm_step_id_t) + sizeof(time_t))
+
 typedef struct {
 	time_t ctime;		/* Time that the cred was created	*/
 	time_t expiration;	/* Time at which cred is no longer good	*/
+	char key[CRED_STATE_KEY_LEN]; /* step_id and ctime, hash key	*/
 	slurm_step_id_t step_id;/* Slurm step id for this credential	*/
 } cred_state_t;
 
@@ -58,10 +62,26 @@ typedef struct {
 	time_t revoked;		/* Time at which credentials were revoked   */
 } job_state_t;
 
+typedef struct {
+	time_t now;
+	time_t next;		/* earliest expiration of the kept entries */
+	xhash_t *hash;
+} expire_args_t;
+
 static pthread_mutex_t cred_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 static list_t *cred_job_list = NULL;
 static list_t *cred_state_list = NULL;
 
+/*
+ * The lists are kept for packing the state, the hash tables index them for
+ * the lookups done on every launch. Nothing can expire until the next
+ * expiration time, so the lists are only swept from then on.
+ */
+static xhash_t *cred_job_hash = NULL;
+static xhash_t *cred_state_hash = NULL;
+static time_t cred_job_next_expire = 0;
+static time_t cred_state_next_expire = 0;
+
 static void _drain_node(char *reason)
 {
 	update_node_msg_t update_node_msg;
@@ -74,6 +94,28 @@ static void _drain_node(char *reason)
 	(void) slurm_update_node(&update_node_msg);
 }
 
+static void _cred_state_key(char *key, slurm_step_id_t *step_id, time_t ctime)
+{
+	memcpy(key, step_id, sizeof(*step_id));
+	memcpy(key + sizeof(*step_id), &ctime, sizeof(ctime));
+}
+
+static void _cred_state_id(void *item, const char **key, uint32_t *key_len)
+{
+	cred_state_t *s = item;
+
+	*key = s->key;
+	*key_len = CRED_STATE_KEY_LEN;
+}
+
+static void _job_state_id(void *item, const char **key, uint32_t *key_len)
+{
+	job_state_t *j = item;
+
+	*key = (const char *) &j->jobid;
+	*key_len = sizeof(j->jobid);
+}
+
 static cred_state_t *_cred_state_create(slurm_cred_t *cred)
 {
 	cred_state_t *s = xmalloc(sizeof(*s));
@@ -81,6 +123,7 @@ static cred_state_t *_cred_state_create(slurm_cred_t *cred)
 	memcpy(&s->step_id, &cred->arg->step_id, sizeof(s->step_id));
 	s->ctime = cred->ctime;
 	s->expiration = cred->ctime + cred_expiration();
+	_cred_state_key(s->key, &s->step_id, s->ctime);
 
 	return s;
 }
@@ -97,51 +140,113 @@ static job_state_t *_job_state_create(uint32_t jobid)
 	return j;
 }
 
-static int _list_find_expired_job_state(void *x, void *key)
+/* Remove item from hash, only if it is the one indexed under its key */
+static void _hash_remove(xhash_t *hash, void *item,
+			 void (*idfunc)(void *, const char **, uint32_t *))
 {
-	job_state_t *j = x;
-	time_t curr_time = *(time_t *) key;
+	const char *key;
+	uint32_t key_len;
 
-	if (j->revoked && (curr_time > j->expiration))
-		return 1;
-	return 0;
+	idfunc(item, &key, &key_len);
+	if (xhash_get(hash, key, key_len) == item)
+		(void) xhash_pop(hash, key, key_len);
 }
 
-static int _list_find_job_state(void *x, void *key)
+static int _list_find_expired_job_state(void *x, void *key)
 {
 	job_state_t *j = x;
-	uint32_t jobid = *(uint32_t *) key;
+	expire_args_t *args = key;
 
-	if (j->jobid == jobid)
+	if (!j->revoked)
+		return 0;
+	if (args->now > j->expiration) {
+		_hash_remove(args->hash, j, _job_state_id);
 		return 1;
+	}
+	args->next = MIN(args->next, j->expiration);
 	return 0;
 }
 
 static job_state_t *_find_job_state(uint32_t jobid)
 {
-	return list_find_first(cred_job_list, _list_find_job_state, &jobid);
+	return xhash_get(cred_job_hash, (char *) &jobid, sizeof(jobid));
+}
+
+static void _add_job_state(job_state_t *j)
+{
+	list_append(cred_job_list, j);
+	xhash_add(cred_job_hash, j);
+}
+
+/* Call after j->revoked or j->expiration changed */
+static void _job_state_expire_update(job_state_t *j)
+{
+	if (j->revoked && (j->expiration < cred_job_next_expire))
+		cred_job_next_expire = j->expiration;
 }
 
 static void _clear_expired_job_states(void)
 {
-	time_t now = time(NULL);
-	list_delete_all(cred_job_list, _list_find_expired_job_state, &now);
+	expire_args_t args = {
+		.now = time(NULL),
+		.next = (time_t) MAX_TIME,
+		.hash = cred_job_hash,
+	};
+
+	if (args.now <= cred_job_next_expire)
+		return;
+
+	list_delete_all(cred_job_list, _list_find_expired_job_state, &args);
+	cred_job_next_expire = args.next;
 }
 
 static int _list_find_expired_cred_state(void *x, void *key)
 {
 	cred_state_t *s = x;
-	time_t curr_time = *(time_t *) key;
+	expire_args_t *args = key;
 
-	if (curr_time > s->expiration)
+	if (args->now > s->expiration) {
+		_hash_remove(args->hash, s, _cred_state_id);
 		return 1;
+	}
+	args->next = MIN(args->next, s->expiration);
 	return 0;
 }
 
 static void _clear_expired_credential_states(void)
 {
-	time_t now = time(NULL);
-	list_delete_all(cred_state_list, _list_find_expired_cred_state, &now);
+	expire_args_t args = {
+		.now = time(NULL),
+		.next = (time_t) MAX_TIME,
+		.hash = cred_state_hash,
+	};
+
+	if (args.now <= cred_state_next_expire)
+		return;
+
+	list_delete_all(cred_state_list, _list_find_expired_cred_state, &args);
+	cred_state_next_expire = args.next;
+}
+
+/* Index an unpacked list entry, dropping it if its key is a duplicate */
+static int _index_job_state(void *x, void *key)
+{
+	job_state_t *j = x;
+
+	if (_find_job_state(j->jobid))
+		return 1;
+	xhash_add(cred_job_hash, j);
+	return 0;
+}
+
+static int _index_cred_state(void *x, void *key)
+{
+	cred_state_t *s = x;
+
+	if (xhash_get(cred_state_hash, s->key, CRED_STATE_KEY_LEN))
+		return 1;
+	xhash_add(cred_state_hash, s);
+	return 0;
 }
 
 static void _job_state_pack(void *x, uint16_t protocol_version, buf_t *buffer)
@@ -201,6 +306,7 @@ static int _cred_state_unpack(void **out, uint16_t protocol_version,
 		goto unpack_error;
 	safe_unpack_time(&s->ctime, buffer);
 	safe_unpack_time(&s->expiration, buffer);
+	_cred_state_key(s->key, &s->step_id, s->ctime);
 
 	*out = s;
 	return SLURM_SUCCESS;
@@ -234,14 +340,12 @@ static void _cred_context_unpack(buf_t *buffer)
 			      xfree_ptr, buffer, version)) {
 		warning("%s: failed to restore job state from file", __func__);
 	}
-	_clear_expired_job_states();
 
 	FREE_NULL_LIST(cred_state_list);
 	if (slurm_unpack_list(&cred_state_list, _cred_state_unpack,
 			      xfree_ptr, buffer, version)) {
 		warning("%s: failed to restore job state from file", __func__);
 	}
-	_clear_expired_credential_states();
 
 	slurm_mutex_unlock(&cred_cache_mutex);
 }
@@ -313,15 +417,29 @@ extern void cred_state_init(void)
 	if (!conf->cleanstart)
 		_restore_cred_state();
 
+	slurm_mutex_lock(&cred_cache_mutex);
 	if (!cred_job_list)
 		cred_job_list = list_create(xfree_ptr);
 	if (!cred_state_list)
 		cred_state_list = list_create(xfree_ptr);
+
+	cred_job_hash = xhash_init(_job_state_id, NULL);
+	cred_state_hash = xhash_init(_cred_state_id, NULL);
+	(void) list_delete_all(cred_job_list, _index_job_state, NULL);
+	(void) list_delete_all(cred_state_list, _index_cred_state, NULL);
+
+	/* Sweep whatever expired while slurmd was down */
+	cred_job_next_expire = cred_state_next_expire = 0;
+	_clear_expired_job_states();
+	_clear_expired_credential_states();
+	slurm_mutex_unlock(&cred_cache_mutex);
 }
 
 extern void cred_state_fini(void)
 {
 	save_cred_state();
+	xhash_free(cred_job_hash);
+	xhash_free(cred_state_hash);
 	FREE_NULL_LIST(cred_job_list);
 	FREE_NULL_LIST(cred_state_list);
 }
@@ -347,7 +465,7 @@ extern int cred_insert_jobid(uint32_t jobid)
 		       __func__, jobid);
 	} else {
 		job_state_t *j = _job_state_create(jobid);
-		list_append(cred_job_list, j);
+		_add_job_state(j);
 	}
 	slurm_mutex_unlock(&cred_cache_mutex);
 
@@ -369,7 +487,7 @@ extern int cred_revoke(uint32_t jobid, time_t time, time_t start_time)
 		 * credentials.
 		 */
 		j = _job_state_create(jobid);
-		list_append(cred_job_list, j);
+		_add_job_state(j);
 	}
 	if (j->revoked) {
 		if (start_time && (j->revoked < start_time)) {
@@ -382,6 +500,7 @@ extern int cred_revoke(uint32_t jobid, time_t time, time_t start_time)
 	}
 
 	j->revoked = time;
+	_job_state_expire_update(j);
 
 	slurm_mutex_unlock(&cred_cache_mutex);
 	return SLURM_SUCCESS;
@@ -427,6 +546,7 @@ extern int cred_begin_expiration(uint32_t jobid)
 	}
 
 	j->expiration = time(NULL) + cred_expiration();
+	_job_state_expire_update(j);
 	debug2("set revoke expiration for jobid %u to %ld UTS",
 	       j->jobid, j->expiration);
 	slurm_mutex_unlock(&cred_cache_mutex);
@@ -451,6 +571,7 @@ extern void cred_handle_reissue(slurm_cred_t *cred, bool locked)
 		 * old record so that "cred" will look like a new
 		 * credential to any ensuing commands. */
 		info("reissued job credential for job %u", j->jobid);
+		_hash_remove(cred_job_hash, j, _job_state_id);
 		list_delete_ptr(cred_job_list, j);
 	}
 
@@ -464,7 +585,7 @@ static bool _credential_revoked(slurm_cred_t *cred)
 
 	if (!(j = _find_job_state(cred->arg->step_id.job_id))) {
 		j = _job_state_create(cred->arg->step_id.job_id);
-		list_append(cred_job_list, j);
+		_add_job_state(j);
 		return false;
 	}
 
@@ -477,23 +598,13 @@ static bool _credential_revoked(slurm_cred_t *cred)
 	return false;
 }
 
-static int _list_find_cred_state(void *x, void *key)
-{
-	cred_state_t *s = x;
-	slurm_cred_t *cred = key;
-
-	if (!memcmp(&s->step_id, &cred->arg->step_id, sizeof(s->step_id)) &&
-	    (s->ctime == cred->ctime))
-		return 1;
-
-	return 0;
-}
-
 static bool _credential_replayed(slurm_cred_t *cred)
 {
 	cred_state_t *s = NULL;
+	char key[CRED_STATE_KEY_LEN];
 
-	s = list_find_first(cred_state_list, _list_find_cred_state, cred);
+	_cred_state_key(key, &cred->arg->step_id, cred->ctime);
+	s = xhash_get(cred_state_hash, key, sizeof(key));
 
 	/*
 	 * If we found a match, this credential is being replayed.
@@ -506,6 +617,8 @@ static bool _credential_replayed(slurm_cred_t *cred)
 	 */
 	s = _cred_state_create(cred);
 	list_append(cred_state_list, s);
+	xhash_add(cred_state_hash, s);
+	cred_state_next_expire = MIN(cred_state_next_expire, s->expiration);
 
 	return false;
 }
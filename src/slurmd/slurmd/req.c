@@ -98,6 +98,7 @@
 #include "src/interfaces/cgroup.h"
 #include "src/interfaces/cred.h"
 #include "src/interfaces/gres.h"
+#include "src/interfaces/hash.h"
 #include "src/interfaces/job_container.h"
 #include "src/interfaces/jobacct_gather.h"
 #include "src/interfaces/mpi.h"
@@ -259,8 +260,37 @@ static pthread_rwlock_t file_bcast_lock = PTHREAD_RWLOCK_INITIALIZER;
 static list_t *file_bcast_list = NULL;
 static list_t *bcast_libdir_list = NULL;
 
+typedef struct {
+	slurm_hash_t hash;	/* K12 of the block data */
+	uint32_t len;		/* length of the block data */
+	uid_t uid;		/* user that sent the block */
+} bcast_block_t;
+
+static pthread_mutex_t bcast_block_mutex = PTHREAD_MUTEX_INITIALIZER;
+static list_t *bcast_block_list = NULL;	/* least recently used first */
+static uint64_t bcast_block_bytes = 0;
+static uint64_t bcast_block_limit = 0;	/* BcastParameters=BlockCache= */
+static char *bcast_block_dir = NULL;
+
 static pthread_mutex_t waiter_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Pool of idle slurmstepd processes for LaunchParameters=slurmstepd_pool.
+ * Each was sent the slurmd configuration when started and has loaded its
+ * plugins, and is blocked reading the rest of a launch request from its
+ * stdin. Idle slurmstepd processes exit on EOF, so closing the pipes (or
+ * slurmd exiting or reconfiguring) cleans them up.
+ */
+typedef struct {
+	int to_stepd;	/* write end of the slurmstepd stdin */
+	int to_slurmd;	/* read end of the slurmstepd stdout */
+} stepd_pool_ent_t;
+
+static pthread_mutex_t stepd_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static list_t *stepd_pool = NULL;
+static int stepd_pool_size = -1;
+static bool stepd_pool_filling = false;
+
 static int _stepmgr_connect(slurm_step_id_t *step_id,
 			    uint16_t *protocol_version)
 {
@@ -418,6 +448,9 @@ slurmd_req(slurm_msg_t *msg)
 			job_limits_loaded = false;
 		}
 		slurm_mutex_unlock(&job_limits_mutex);
+		slurm_mutex_lock(&stepd_pool_mutex);
+		FREE_NULL_LIST(stepd_pool);
+		slurm_mutex_unlock(&stepd_pool_mutex);
 		return;
 	}
 
@@ -626,9 +659,28 @@ rwfail:
 	return (-1);
 }
 
+/* Send the configuration a slurmstepd needs before loading its plugins */
+static int _send_slurmstepd_conf(int fd)
+{
+	/* send conf over to slurmstepd */
+	if (send_slurmd_conf_lite(fd, conf)) {
+		error("%s: send_slurmd_conf_lite(%d) failed: %m", __func__, fd);
+		return SLURM_ERROR;
+	}
+
+	/* send conf_hashtbl */
+	if (read_conf_send_stepd(fd)) {
+		error("%s: read_conf_send_stepd(%d) failed: %m", __func__, fd);
+		return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
 static int
 _send_slurmstepd_init(int fd, int type, void *req, slurm_addr_t *cli,
-		      hostlist_t *step_hset, uint16_t protocol_version)
+		      hostlist_t *step_hset, uint16_t protocol_version,
+		      bool conf_sent)
 {
 	int len = 0;
 	buf_t *buffer = NULL;
@@ -640,17 +692,9 @@ _send_slurmstepd_init(int fd, int type, void *req, slurm_addr_t *cli,
 
 	slurm_msg_t_init(&msg);
 
-	/* send conf over to slurmstepd */
-	if (send_slurmd_conf_lite(fd, conf)) {
-		error("%s: send_slurmd_conf_lite(%d) failed: %m", __func__, fd);
-		goto fail;
-	}
-
-	/* send conf_hashtbl */
-	if (read_conf_send_stepd(fd)) {
-		error("%s: read_conf_send_stepd(%d) failed: %m", __func__, fd);
+	/* A pooled slurmstepd already has the configuration */
+	if (!conf_sent && _send_slurmstepd_conf(fd))
 		goto fail;
-	}
 
 	/* send type over to slurmstepd */
 	safe_write(fd, &type, sizeof(int));
@@ -821,6 +865,319 @@ fail:
 }
 
 
+/*
+ * Exec the slurmstepd in a grandchild of slurmd, with to_stepd as its stdin
+ * and to_slurmd as its stdout. Called in the child of fork(), never returns.
+ */
+static void _exec_slurmstepd(char *const argv[], int to_stepd[2],
+			     int to_slurmd[2])
+{
+	pid_t pid;
+	int i;
+	int failed = 0;
+
+	/*
+	 * Child forks and exits
+	 */
+	if (setsid() < 0) {
+		error("%s: setsid: %m", __func__);
+		failed = 1;
+	}
+	if ((pid = fork()) < 0) {
+		error("%s: Unable to fork grandchild: %m", __func__);
+		failed = 2;
+	} else if (pid > 0) { /* child */
+		_exit(0);
+	}
+
+	/*
+	 * Just in case we (or someone we are linking to)
+	 * opened a file and didn't do a close on exec.  This
+	 * is needed mostly to protect us against libs we link
+	 * to that don't set the flag as we should already be
+	 * setting it for those that we open.  The number 256
+	 * is an arbitrary number based off test7.9.
+	 */
+	for (i=3; i<256; i++) {
+		(void) fcntl(i, F_SETFD, FD_CLOEXEC);
+	}
+
+	/*
+	 * Grandchild exec's the slurmstepd
+	 *
+	 * If the slurmd is being shutdown/restarted before
+	 * the pipe happens the old conf->lfd could be reused
+	 * and if we close it the dup2 below will fail.
+	 */
+	if ((to_stepd[0] != conf->lfd)
+	    && (to_slurmd[1] != conf->lfd))
+		close(conf->lfd);
+
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in grandchild: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+
+	(void) close(STDIN_FILENO); /* ignore return */
+	if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
+		error("dup2 over STDIN_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_close_on_exec(to_stepd[0]);
+	(void) close(STDOUT_FILENO); /* ignore return */
+	if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
+		error("dup2 over STDOUT_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_close_on_exec(to_slurmd[1]);
+	(void) close(STDERR_FILENO); /* ignore return */
+	if (dup2(devnull, STDERR_FILENO) == -1) {
+		error("dup2 /dev/null to STDERR_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_noclose_on_exec(STDERR_FILENO);
+	log_fini();
+	if (!failed) {
+		execvp(argv[0], argv);
+		error("exec of slurmstepd failed: %m");
+	}
+	_exit(2);
+}
+
+static void _stepd_pool_ent_free(void *x)
+{
+	stepd_pool_ent_t *ent = x;
+
+	if (!ent)
+		return;
+
+	(void) close(ent->to_stepd);
+	(void) close(ent->to_slurmd);
+	xfree(ent);
+}
+
+/* Call with stepd_pool_mutex held */
+static int _stepd_pool_size(void)
+{
+	char *tmp_ptr;
+
+	if (stepd_pool_size >= 0)
+		return stepd_pool_size;
+
+	stepd_pool_size = 0;
+#if (SLURMSTEPD_MEMCHECK == 0)
+	if ((tmp_ptr = xstrcasestr(slurm_conf.launch_params,
+				   "slurmstepd_pool="))) {
+		stepd_pool_size = atoi(tmp_ptr + strlen("slurmstepd_pool="));
+		if (stepd_pool_size < 0)
+			stepd_pool_size = 0;
+	}
+#endif
+
+	return stepd_pool_size;
+}
+
+/* Start one slurmstepd for the pool and send it the configuration */
+static stepd_pool_ent_t *_stepd_pool_spawn(void)
+{
+	char *const argv[2] = { (char *) conf->stepd_loc, NULL };
+	stepd_pool_ent_t *ent;
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	pid_t pid;
+
+	/*
+	 * Don't leak the pool into other children of slurmd. dup2() in
+	 * _exec_slurmstepd() clears close-on-exec for the slurmstepd ends.
+	 */
+	if ((pipe2(to_stepd, O_CLOEXEC) < 0) ||
+	    (pipe2(to_slurmd, O_CLOEXEC) < 0)) {
+		error("%s: pipe2 failed: %m", __func__);
+		goto fail;
+	}
+
+	if ((pid = fork()) < 0) {
+		error("%s: fork: %m", __func__);
+		goto fail;
+	} else if (!pid) {
+		_exec_slurmstepd(argv, to_stepd, to_slurmd);
+	}
+
+	(void) close(to_stepd[0]);
+	(void) close(to_slurmd[1]);
+	if (waitpid(pid, NULL, 0) < 0)
+		error("Unable to reap slurmd child process");
+
+	if (_send_slurmstepd_conf(to_stepd[1])) {
+		(void) close(to_stepd[1]);
+		(void) close(to_slurmd[0]);
+		return NULL;
+	}
+
+	ent = xmalloc(sizeof(*ent));
+	ent->to_stepd = to_stepd[1];
+	ent->to_slurmd = to_slurmd[0];
+	return ent;
+
+fail:
+	for (int i = 0; i < 2; i++) {
+		if (to_stepd[i] >= 0)
+			(void) close(to_stepd[i]);
+		if (to_slurmd[i] >= 0)
+			(void) close(to_slurmd[i]);
+	}
+	return NULL;
+}
+
+static void *_stepd_pool_fill(void *arg)
+{
+	while (true) {
+		stepd_pool_ent_t *ent;
+
+		slurm_mutex_lock(&stepd_pool_mutex);
+		if (!stepd_pool ||
+		    (list_count(stepd_pool) >= _stepd_pool_size())) {
+			stepd_pool_filling = false;
+			slurm_mutex_unlock(&stepd_pool_mutex);
+			break;
+		}
+		slurm_mutex_unlock(&stepd_pool_mutex);
+
+		if (!(ent = _stepd_pool_spawn())) {
+			slurm_mutex_lock(&stepd_pool_mutex);
+			stepd_pool_filling = false;
+			slurm_mutex_unlock(&stepd_pool_mutex);
+			break;
+		}
+
+		slurm_mutex_lock(&stepd_pool_mutex);
+		if (stepd_pool)
+			list_append(stepd_pool, ent);
+		else
+			_stepd_pool_ent_free(ent);
+		slurm_mutex_unlock(&stepd_pool_mutex);
+	}
+
+	return NULL;
+}
+
+/*
+ * Take an idle slurmstepd from the pool, and start refilling the pool.
+ * OUT to_stepd - write end of the slurmstepd stdin
+ * OUT to_slurmd - read end of the slurmstepd stdout
+ * RET true if a pooled slurmstepd was found
+ */
+static bool _stepd_pool_get(int *to_stepd, int *to_slurmd)
+{
+	stepd_pool_ent_t *ent;
+	bool found = false;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	if (!_stepd_pool_size()) {
+		slurm_mutex_unlock(&stepd_pool_mutex);
+		return false;
+	}
+
+	if (!stepd_pool)
+		stepd_pool = list_create(_stepd_pool_ent_free);
+
+	while (!found && (ent = list_dequeue(stepd_pool))) {
+		struct pollfd pfd = {
+			.fd = ent->to_slurmd,
+			.events = POLLIN,
+		};
+
+		/* An idle slurmstepd writes nothing, so any event is EOF */
+		if (poll(&pfd, 1, 0) != 0) {
+			debug("%s: discarding exited slurmstepd", __func__);
+			_stepd_pool_ent_free(ent);
+			continue;
+		}
+
+		*to_stepd = ent->to_stepd;
+		*to_slurmd = ent->to_slurmd;
+		xfree(ent);
+		found = true;
+	}
+
+	if (!stepd_pool_filling) {
+		stepd_pool_filling = true;
+		slurm_thread_create_detached(_stepd_pool_fill, NULL);
+	}
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	return found;
+}
+
+/*
+ * Send the launch request to a started slurmstepd, and wait for it to
+ * send an "ok" message. Closes to_stepd and to_slurmd.
+ * IN pid - child of slurmd to reap, or 0 for a pooled slurmstepd
+ */
+static int _handoff_slurmstepd(pid_t pid, int to_stepd, int to_slurmd,
+			       uint16_t type, void *req, slurm_addr_t *cli,
+			       hostlist_t *step_hset,
+			       uint16_t protocol_version)
+{
+	int rc = SLURM_SUCCESS;
+#if (SLURMSTEPD_MEMCHECK != 1)
+	int i;
+	time_t start_time = time(NULL);
+#endif
+
+	if ((rc = _send_slurmstepd_init(to_stepd, type, req, cli, step_hset,
+					protocol_version, !pid)) != 0) {
+		error("Unable to init slurmstepd");
+		goto done;
+	}
+
+	/*
+	 * If running under memcheck, this pipe doesn't work correctly
+	 * so just skip it.
+	 */
+#if (SLURMSTEPD_MEMCHECK != 1)
+	i = read(to_slurmd, &rc, sizeof(int));
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else {
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			warning("slurmstepd startup took %d sec, possible file system problem or full memory",
+				delta_time);
+		}
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d: %s",
+			      rc, slurm_strerror(rc));
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd, &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
+		}
+	}
+#endif
+done:
+	if (_remove_starting_step(type, req))
+		error("Error cleaning up starting_step list");
+
+	/* Reap child */
+	if (pid && (waitpid(pid, NULL, 0) < 0))
+		error("Unable to reap slurmd child process");
+	if (close(to_stepd) < 0)
+		error("close write to_stepd in parent: %m");
+	if (close(to_slurmd) < 0)
+		error("close read to_slurmd in parent: %m");
+	return rc;
+}
+
 /*
  * Fork and exec the slurmstepd, then send the slurmstepd its
  * initialization data.  Then wait for slurmstepd to send an "ok"
@@ -831,6 +1188,9 @@ fail:
  * Note that this code forks twice and it is the grandchild that
  * becomes the slurmstepd process, so the slurmstepd's parent process
  * will be init, not slurmd.
+ *
+ * With LaunchParameters=slurmstepd_pool, an idle slurmstepd started ahead
+ * of time is used instead when available.
  */
 static int
 _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
@@ -840,6 +1200,19 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 	int to_stepd[2] = {-1, -1};
 	int to_slurmd[2] = {-1, -1};
 
+	if (_stepd_pool_get(&to_stepd[1], &to_slurmd[0])) {
+		if (_add_starting_step(type, req)) {
+			error("%s: failed in _add_starting_step: %m",
+			      __func__);
+			(void) close(to_stepd[1]);
+			(void) close(to_slurmd[0]);
+			return SLURM_ERROR;
+		}
+		return _handoff_slurmstepd(0, to_stepd[1], to_slurmd[0], type,
+					   req, cli, step_hset,
+					   protocol_version);
+	}
+
 	if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
 		error("%s: pipe failed: %m", __func__);
 		return SLURM_ERROR;
@@ -859,11 +1232,6 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 		_remove_starting_step(type, req);
 		return SLURM_ERROR;
 	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
-#if (SLURMSTEPD_MEMCHECK != 1)
-		int i;
-		time_t start_time = time(NULL);
-#endif
 		/*
 		 * Parent sends initialization data to the slurmstepd
 		 * over the to_stepd pipe, and waits for the return code
@@ -874,58 +1242,9 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 		if (close(to_slurmd[1]) < 0)
 			error("Unable to close write to_slurmd in parent: %m");
 
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
-		}
-
-		/*
-		 * If running under memcheck, this pipe doesn't work correctly
-		 * so just skip it.
-		 */
-#if (SLURMSTEPD_MEMCHECK != 1)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				warning("slurmstepd startup took %d sec, possible file system problem or full memory",
-					delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d: %s",
-				      rc, slurm_strerror(rc));
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
-#endif
-	done:
-		if (_remove_starting_step(type, req))
-			error("Error cleaning up starting_step list");
-
-		/* Reap child */
-		if (waitpid(pid, NULL, 0) < 0)
-			error("Unable to reap slurmd child process");
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in parent: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-		return rc;
+		return _handoff_slurmstepd(pid, to_stepd[1], to_slurmd[0],
+					   type, req, cli, step_hset,
+					   protocol_version);
 	} else {
 #if (SLURMSTEPD_MEMCHECK == 1)
 		/* memcheck test of slurmstepd, option #1 */
@@ -1001,74 +1320,8 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 		/* no memory checking, default */
 		char *const argv[2] = { (char *)conf->stepd_loc, NULL};
 #endif
-		int i;
-		int failed = 0;
-
-		/*
-		 * Child forks and exits
-		 */
-		if (setsid() < 0) {
-			error("%s: setsid: %m", __func__);
-			failed = 1;
-		}
-		if ((pid = fork()) < 0) {
-			error("%s: Unable to fork grandchild: %m", __func__);
-			failed = 2;
-		} else if (pid > 0) { /* child */
-			_exit(0);
-		}
-
-		/*
-		 * Just in case we (or someone we are linking to)
-		 * opened a file and didn't do a close on exec.  This
-		 * is needed mostly to protect us against libs we link
-		 * to that don't set the flag as we should already be
-		 * setting it for those that we open.  The number 256
-		 * is an arbitrary number based off test7.9.
-		 */
-		for (i=3; i<256; i++) {
-			(void) fcntl(i, F_SETFD, FD_CLOEXEC);
-		}
 
-		/*
-		 * Grandchild exec's the slurmstepd
-		 *
-		 * If the slurmd is being shutdown/restarted before
-		 * the pipe happens the old conf->lfd could be reused
-		 * and if we close it the dup2 below will fail.
-		 */
-		if ((to_stepd[0] != conf->lfd)
-		    && (to_slurmd[1] != conf->lfd))
-			close(conf->lfd);
-
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in grandchild: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-
-		(void) close(STDIN_FILENO); /* ignore return */
-		if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
-			error("dup2 over STDIN_FILENO: %m");
-			_exit(1);
-		}
-		fd_set_close_on_exec(to_stepd[0]);
-		(void) close(STDOUT_FILENO); /* ignore return */
-		if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
-			error("dup2 over STDOUT_FILENO: %m");
-			_exit(1);
-		}
-		fd_set_close_on_exec(to_slurmd[1]);
-		(void) close(STDERR_FILENO); /* ignore return */
-		if (dup2(devnull, STDERR_FILENO) == -1) {
-			error("dup2 /dev/null to STDERR_FILENO: %m");
-			_exit(1);
-		}
-		fd_set_noclose_on_exec(STDERR_FILENO);
-		log_fini();
-		if (!failed) {
-			execvp(argv[0], argv);
-			error("exec of slurmstepd failed: %m");
-		}
+		_exec_slurmstepd(argv, to_stepd, to_slurmd);
 		_exit(2);
 	}
 }
@@ -3373,6 +3626,14 @@ _enforce_job_mem_limit(void)
 	xfree(job_mem_info_ptr);
 }
 
+extern void ping_housekeeping(void)
+{
+	/* Take this opportunity to enforce any job memory limits */
+	_enforce_job_mem_limit();
+	/* Clear up any stalled file transfers as well */
+	_file_bcast_cleanup();
+}
+
 static void _rpc_ping(slurm_msg_t *msg)
 {
 	int        rc = SLURM_SUCCESS;
@@ -3413,10 +3674,7 @@ static void _rpc_ping(slurm_msg_t *msg)
 
 		slurm_send_node_msg(msg->conn_fd, &resp_msg);
 
-		/* Take this opportunity to enforce any job memory limits */
-		_enforce_job_mem_limit();
-		/* Clear up any stalled file transfers as well */
-		_file_bcast_cleanup();
+		ping_housekeeping();
 
 		if (msg->msg_type == REQUEST_NODE_REGISTRATION_STATUS) {
 			get_reg_resp = true;
@@ -3450,10 +3708,7 @@ static void _rpc_health_check(slurm_msg_t *msg)
 	if (rc == SLURM_SUCCESS)
 		rc = run_script_health_check();
 
-	/* Take this opportunity to enforce any job memory limits */
-	_enforce_job_mem_limit();
-	/* Clear up any stalled file transfers as well */
-	_file_bcast_cleanup();
+	ping_housekeeping();
 }
 
 
@@ -4375,16 +4630,268 @@ static void _file_bcast_job_cleanup(uint32_t job_id)
 	slurm_rwlock_unlock(&file_bcast_lock);
 }
 
+/*
+ * Cached blocks live in <SlurmdSpoolDir>/bcast_cache/<uid>_<hash>. Each user
+ * only ever sees their own blocks, so the cache cannot be used to probe the
+ * contents of files sent by someone else.
+ */
+static char *_bcast_block_path(bcast_block_t *block)
+{
+	char *path = NULL, *pos = NULL;
+
+	xstrfmtcatat(path, &pos, "%s/%u_", bcast_block_dir, block->uid);
+	for (int i = 0; i < sizeof(block->hash.hash); i++)
+		xstrfmtcatat(path, &pos, "%02x", block->hash.hash[i]);
+
+	return path;
+}
+
+static int _bcast_block_find(void *x, void *key)
+{
+	bcast_block_t *block = x, *want = key;
+
+	return ((block->uid == want->uid) && (block->len == want->len) &&
+		!memcmp(&block->hash, &want->hash, sizeof(want->hash)));
+}
+
+/* Fill in req->block from the block cache, return false if not cached */
+static bool _bcast_block_load(file_bcast_msg_t *req, uid_t uid)
+{
+	bcast_block_t key = {
+		.hash = req->block_hash,
+		.len = req->uncomp_len,
+		.uid = uid,
+	};
+	bcast_block_t *block;
+	char *path, *data = NULL;
+	int fd;
+
+	if (!bcast_block_limit || (req->block_hash.type != HASH_PLUGIN_K12))
+		return false;
+
+	slurm_mutex_lock(&bcast_block_mutex);
+	/* move it to the tail as the most recently used */
+	if ((block = list_remove_first(bcast_block_list, _bcast_block_find,
+				       &key)))
+		list_append(bcast_block_list, block);
+	slurm_mutex_unlock(&bcast_block_mutex);
+
+	if (!block)
+		return false;
+
+	path = _bcast_block_path(&key);
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	xfree(path);
+	if (fd < 0)
+		return false;	/* evicted since the lookup */
+
+	data = xmalloc(key.len);
+	safe_read(fd, data, key.len);
+	close(fd);
+
+	xfree(req->block);
+	req->block = data;
+	req->block_len = key.len;
+	req->compress = COMPRESS_OFF;
+	return true;
+
+rwfail:
+	close(fd);
+	xfree(data);
+	return false;
+}
+
+/* Add the (uncompressed) data of a received block to the block cache */
+static void _bcast_block_store(file_bcast_msg_t *req, uid_t uid)
+{
+	bcast_block_t *block;
+	char *path = NULL, *tmp_path = NULL;
+	bool cached;
+	int fd = -1;
+
+	if (!bcast_block_limit || !req->block_len ||
+	    (req->block_len > bcast_block_limit))
+		return;
+
+	block = xmalloc(sizeof(*block));
+	block->hash.type = HASH_PLUGIN_K12;
+	block->len = req->block_len;
+	block->uid = uid;
+	if (hash_g_compute(req->block, req->block_len, NULL, 0,
+			   &block->hash) < 0)
+		goto fail;
+
+	slurm_mutex_lock(&bcast_block_mutex);
+	cached = list_find_first(bcast_block_list, _bcast_block_find, block);
+	slurm_mutex_unlock(&bcast_block_mutex);
+	if (cached)
+		goto fail;
+
+	/* write under a temporary name so readers never see a partial block */
+	path = _bcast_block_path(block);
+	tmp_path = xstrdup_printf("%s.XXXXXX", path);
+	if ((fd = mkstemp(tmp_path)) < 0) {
+		error("%s: unable to create %s: %m", __func__, tmp_path);
+		goto fail;
+	}
+	safe_write(fd, req->block, req->block_len);
+	close(fd);
+	fd = -1;
+	if (rename(tmp_path, path)) {
+		error("%s: unable to rename %s: %m", __func__, tmp_path);
+		goto rwfail;
+	}
+	xfree(tmp_path);
+	xfree(path);
+
+	slurm_mutex_lock(&bcast_block_mutex);
+	if (list_find_first(bcast_block_list, _bcast_block_find, block)) {
+		/* another transfer stored the same data meanwhile */
+		xfree(block);
+	} else {
+		list_append(bcast_block_list, block);
+		bcast_block_bytes += block->len;
+	}
+	while ((bcast_block_bytes > bcast_block_limit) &&
+	       (block = list_pop(bcast_block_list))) {
+		path = _bcast_block_path(block);
+		(void) unlink(path);
+		xfree(path);
+		bcast_block_bytes -= block->len;
+		xfree(block);
+	}
+	slurm_mutex_unlock(&bcast_block_mutex);
+	return;
+
+rwfail:
+	if (fd >= 0)
+		close(fd);
+	(void) unlink(tmp_path);
+fail:
+	xfree(tmp_path);
+	xfree(path);
+	xfree(block);
+}
+
+/*
+ * Send a cached block on to req->peer_nodes, so that the nodes missing it are
+ * fed by this node rather than all by sbcast. The data is relayed on behalf
+ * of the user in the credential, which the receivers trust because the
+ * message comes from SlurmUser.
+ */
+static int _file_bcast_peer_send(file_bcast_msg_t *req, uid_t uid)
+{
+	file_bcast_msg_t peer_req;
+	list_t *ret_list;
+	list_itr_t *itr;
+	ret_data_info_t *ret_data_info;
+	slurm_msg_t msg;
+	hostlist_t *peers;
+	hostset_t *hset;
+	char *peer;
+	int rc = SLURM_SUCCESS, msg_rc;
+
+	/* only relay within the job allocation */
+	if (!(hset = hostset_create(req->cred->arg.nodes)))
+		return SLURM_ERROR;
+	peers = hostlist_create(req->peer_nodes);
+	while ((peer = hostlist_shift(peers))) {
+		if (!hostset_within(hset, peer)) {
+			error("Security violation: sbcast peer %s from uid %u not in %s",
+			      peer, uid, req->cred->arg.nodes);
+			rc = ESLURMD_INVALID_JOB_CREDENTIAL;
+		}
+		free(peer);
+		if (rc)
+			break;
+	}
+	FREE_NULL_HOSTLIST(peers);
+	hostset_destroy(hset);
+	if (rc)
+		return rc;
+
+	if (!_bcast_block_load(req, uid))
+		return ESLURMD_BCAST_BLOCK_MISSING;
+
+	peer_req = *req;
+	peer_req.flags &= ~FILE_BCAST_BY_HASH;
+	peer_req.flags |= FILE_BCAST_FROM_PEER;
+	peer_req.block_hash.type = 0;
+	peer_req.peer_nodes = NULL;
+
+	slurm_msg_t_init(&msg);
+	slurm_msg_set_r_uid(&msg, slurm_conf.slurmd_user_id);
+	msg.data = &peer_req;
+	msg.flags = USE_BCAST_NETWORK;
+	msg.msg_type = REQUEST_FILE_BCAST;
+
+	debug2("sbcast: sending block %u of `%s` on to %s",
+	       req->block_no, req->fname, req->peer_nodes);
+	if (!(ret_list = slurm_send_recv_msgs(req->peer_nodes, &msg, 0))) {
+		error("%s: slurm_send_recv_msgs: %m", __func__);
+		return SLURM_ERROR;
+	}
+
+	itr = list_iterator_create(ret_list);
+	while ((ret_data_info = list_next(itr))) {
+		msg_rc = slurm_get_return_code(ret_data_info->type,
+					       ret_data_info->data);
+		if (msg_rc == SLURM_SUCCESS)
+			continue;
+
+		error("sbcast: peer REQUEST_FILE_BCAST(%s): %s",
+		      ret_data_info->node_name, slurm_strerror(msg_rc));
+		rc = msg_rc;
+	}
+	list_iterator_destroy(itr);
+	FREE_NULL_LIST(ret_list);
+
+	return rc;
+}
+
+static void _bcast_block_cache_init(void)
+{
+	char *tmp;
+
+	if (!(tmp = conf_get_opt_str(slurm_conf.bcast_parameters,
+				     "BlockCache=")))
+		return;
+	bcast_block_limit = strtoull(tmp, NULL, 10) * 1024 * 1024;
+	xfree(tmp);
+	if (!bcast_block_limit)
+		return;
+
+	bcast_block_dir = xstrdup_printf("%s/bcast_cache", conf->spooldir);
+	/* the index is not persisted, so start from an empty cache */
+	(void) rmdir_recursive(bcast_block_dir, true);
+	if (mkdir(bcast_block_dir, 0700) && (errno != EEXIST)) {
+		error("%s: unable to create %s: %m",
+		      __func__, bcast_block_dir);
+		bcast_block_limit = 0;
+		xfree(bcast_block_dir);
+		return;
+	}
+	bcast_block_list = list_create(xfree_ptr);
+	debug("file broadcast block cache of %"PRIu64" MB in %s",
+	      bcast_block_limit / (1024 * 1024), bcast_block_dir);
+}
+
 void file_bcast_init(void)
 {
 	/* skip locks during slurmd init */
 	file_bcast_list = list_create(_free_file_bcast_info_t);
 	bcast_libdir_list = list_create(_free_libdir_rec_t);
-
+	_bcast_block_cache_init();
 }
 
 void file_bcast_purge(void)
 {
+	slurm_mutex_lock(&bcast_block_mutex);
+	FREE_NULL_LIST(bcast_block_list);
+	xfree(bcast_block_dir);
+	bcast_block_limit = 0;
+	slurm_mutex_unlock(&bcast_block_mutex);
+
 	slurm_rwlock_wrlock(&file_bcast_lock);
 	FREE_NULL_LIST(file_bcast_list);
 	FREE_NULL_LIST(bcast_libdir_list);
@@ -4403,6 +4910,18 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 	key.uid = msg->auth_uid;
 	key.gid = msg->auth_gid;
 
+	if (req->flags & FILE_BCAST_FROM_PEER) {
+		if (!_slurm_authorized_user(msg->auth_uid)) {
+			error("Security violation: peer file broadcast from uid %u",
+			      msg->auth_uid);
+			rc = ESLURM_USER_ID_MISSING;
+			goto done;
+		}
+		/* another slurmd relaying a block for the credential's user */
+		key.uid = req->cred->arg.id->uid;
+		key.gid = req->cred->arg.id->gid;
+	}
+
 	cred_arg = _valid_sbcast_cred(req, key.uid, key.gid,
 				      msg->protocol_version);
 	if (!cred_arg) {
@@ -4413,6 +4932,12 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 	key.job_id = cred_arg->job_id;
 	key.step_id = cred_arg->step_id;
 
+	/* fname is relayed untouched, so handle this before resolving it */
+	if (req->peer_nodes) {
+		rc = _file_bcast_peer_send(req, key.uid);
+		goto done;
+	}
+
 #if 0
 	info("last_block=%u force=%u modes=%o",
 	     req->last_block, req->force, req->modes);
@@ -4473,6 +4998,18 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 		      key.uid, key.job_id, key.fname, req->block_no);
 	}
 
+	/*
+	 * Look the block up before registering the file, so that a miss on the
+	 * first block can be retried with the data.
+	 */
+	if ((req->flags & FILE_BCAST_BY_HASH) &&
+	    !_bcast_block_load(req, key.uid)) {
+		debug2("sbcast: block %u of `%s` not in block cache",
+		       req->block_no, key.fname);
+		rc = ESLURMD_BCAST_BLOCK_MISSING;
+		goto done;
+	}
+
 	/* first block must register the file and open fd/mmap */
 	if (req->block_no == 1) {
 		if ((rc = _file_bcast_register_file(msg, cred_arg, &key))) {
@@ -4500,8 +5037,13 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 
 	offset = 0;
 	while (req->block_len - offset) {
-		inx = write(file_info->fd, &req->block[offset],
-			    (req->block_len - offset));
+		/*
+		 * Blocks may arrive out of order when sbcast pipelines the
+		 * transfer, so always write at the block's own offset.
+		 */
+		inx = pwrite(file_info->fd, &req->block[offset],
+			     (req->block_len - offset),
+			     (req->block_offset + offset));
 		if (inx == -1) {
 			if ((errno == EINTR) || (errno == EAGAIN))
 				continue;
@@ -4540,6 +5082,9 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 
 	slurm_rwlock_unlock(&file_bcast_lock);
 
+	if (!(req->flags & FILE_BCAST_BY_HASH))
+		_bcast_block_store(req, key.uid);
+
 	if (req->flags & FILE_BCAST_LAST_BLOCK) {
 		_file_bcast_close_file(&key);
 	}
@@ -4890,15 +5435,31 @@ extern int ume_notify(void)
 static void
 _wait_state_completed(uint32_t jobid, int max_delay)
 {
-	int i;
+	/*
+	 * The steps usually get there within a few msec after their processes
+	 * ended. Gradually increase the sleep until we get to a second, so
+	 * that the epilog completion of short jobs is not held back by a full
+	 * second.
+	 */
+	static const int pause_usec[] = { 20000, 50000, 100000, 500000 };
+	int64_t waited_usec = 0, max_usec = max_delay * USEC_IN_SEC;
+	int count = 0;
 
-	for (i=0; i<max_delay; i++) {
-		if (_steps_completed_now(jobid))
-			break;
-		sleep(1);
+	while (!_steps_completed_now(jobid)) {
+		int pause;
+
+		if (waited_usec >= max_usec) {
+			error("timed out waiting for job %u to complete",
+			      jobid);
+			return;
+		}
+		if (count < ARRAY_SIZE(pause_usec))
+			pause = pause_usec[count++];
+		else
+			pause = USEC_IN_SEC;
+		usleep(pause);
+		waited_usec += pause;
 	}
-	if (i >= max_delay)
-		error("timed out waiting for job %u to complete", jobid);
 }
 
 static bool
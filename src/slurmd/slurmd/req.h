@@ -57,6 +57,12 @@ extern int send_slurmd_conf_lite(int fd, slurmd_conf_t *cf);
 /* Add record for every launched job so we know they are ready for suspend */
 extern void record_launched_jobs(void);
 
+/*
+ * Enforce job memory limits and clean up stalled file transfers. This is
+ * normally done when slurmctld pings or health checks the node.
+ */
+extern void ping_housekeeping(void);
+
 void file_bcast_init(void);
 void file_bcast_purge(void);
 
@@ -202,6 +202,7 @@ static void      _fill_registration_msg(slurm_node_registration_status_msg_t *);
 static void      _handle_connection(int fd, slurm_addr_t *client);
 static void      _hup_handler(int);
 static void      _increment_thd_count(void);
+static void     *_heartbeat_engine(void *arg);
 static void      _init_conf(void);
 static int       _memory_spec_init(void);
 static void      _msg_engine(void);
@@ -405,6 +406,9 @@ main (int argc, char **argv)
 
 	record_launched_jobs();
 	slurm_thread_create_detached(_registration_engine, NULL);
+	if ((slurm_conf.conf_flags & CONF_FLAG_PUSH_HB) &&
+	    slurm_conf.slurmd_timeout)
+		slurm_thread_create_detached(_heartbeat_engine, NULL);
 
 	/* main processing loop. when this returns start shutting down */
 	_msg_engine();
@@ -482,6 +486,59 @@ _registration_engine(void *arg)
 	return NULL;
 }
 
+/*
+ * With SlurmdParameters=push_heartbeat, periodically push this node's load
+ * and free memory to slurmctld. slurmctld records these like a ping response,
+ * so its ping cycle skips nodes that are keeping their heartbeat current
+ * instead of fanning out a ping to every node.
+ *
+ * The period is a quarter of SlurmdTimeout, inside the SlurmdTimeout/3 window
+ * in which slurmctld considers a response fresh. The first heartbeat is
+ * delayed by a random fraction of the period so nodes started together do
+ * not all report in the same second.
+ */
+static void *_heartbeat_engine(void *arg)
+{
+	int interval = MAX(slurm_conf.slurmd_timeout / 4, 1);
+	time_t next_send = time(NULL) + (random() % interval);
+
+	while (!_shutdown) {
+		node_heartbeat_msg_t hb_msg;
+		slurm_msg_t req;
+		int rc = SLURM_SUCCESS;
+
+		if (time(NULL) < next_send) {
+			sleep(1);
+			continue;
+		}
+		next_send = time(NULL) + interval;
+
+		/* Registration already carries everything sent here */
+		if (!sent_reg_time)
+			continue;
+
+		memset(&hb_msg, 0, sizeof(hb_msg));
+		get_cpu_load(&hb_msg.cpu_load);
+		get_free_mem(&hb_msg.free_mem);
+		hb_msg.node_name = conf->node_name;
+
+		slurm_msg_t_init(&req);
+		req.msg_type = MESSAGE_NODE_HEARTBEAT;
+		req.data = &hb_msg;
+
+		if (slurm_send_recv_controller_rc_msg(&req, &rc,
+						      working_cluster_rec) < 0)
+			debug("%s: Unable to send heartbeat: %m", __func__);
+		else if (rc)
+			debug("%s: Heartbeat rejected: %s",
+			      __func__, slurm_strerror(rc));
+
+		ping_housekeeping();
+	}
+
+	return NULL;
+}
+
 static void _msg_engine(void)
 {
 	slurm_addr_t *cli;
@@ -56,6 +56,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -84,6 +85,12 @@
 #define STDIO_MAX_FREE_BUF 1024
 #define STDIO_MAX_MSG_CACHE 128
 
+/*
+ * Max number of messages written to an unlabelled local file with a single
+ * writev().
+ */
+#define LOCAL_FILE_WRITE_IOV 64
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -520,6 +527,76 @@ _local_file_writable(eio_obj_t *obj)
 }
 
 
+/*
+ * Without labels the payloads of the queued messages are written as they are,
+ * so write as many of them as possible at once.
+ */
+static int _local_file_write_batch(eio_obj_t *obj,
+				   struct client_io_info *client)
+{
+	struct io_buf *msgs[LOCAL_FILE_WRITE_IOV];
+	struct iovec iov[LOCAL_FILE_WRITE_IOV];
+	struct io_buf *msg;
+	int cnt = 0, i;
+	ssize_t n;
+
+	/* A message partially written by the previous call goes first */
+	if ((msg = client->out_msg)) {
+		msgs[cnt] = msg;
+		iov[cnt].iov_base = msg->data +
+			(msg->length - client->out_remaining);
+		iov[cnt].iov_len = client->out_remaining;
+		cnt++;
+		client->out_msg = NULL;
+	}
+
+	while ((cnt < LOCAL_FILE_WRITE_IOV) &&
+	       (msg = list_dequeue(client->msg_queue))) {
+		/* A zero-length message is the end of a task's stream */
+		if (msg->length == IO_HDR_PACKET_BYTES) {
+			_free_outgoing_msg(msg, client->step);
+			continue;
+		}
+		msgs[cnt] = msg;
+		iov[cnt].iov_base = msg->data + IO_HDR_PACKET_BYTES;
+		iov[cnt].iov_len = msg->length - IO_HDR_PACKET_BYTES;
+		cnt++;
+	}
+
+	if (!cnt)
+		return SLURM_SUCCESS;
+
+again:
+	if ((n = writev(obj->fd, iov, cnt)) < 0) {
+		if (errno == EINTR)
+			goto again;
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+			debug("%s: writev: %m", __func__);
+			for (i = 0; i < cnt; i++)
+				_free_outgoing_msg(msgs[i], client->step);
+			client->out_eof = true;
+			_free_all_outgoing_msgs(client->msg_queue,
+						client->step);
+			return SLURM_ERROR;
+		}
+		n = 0;
+	}
+
+	/* Release what was written, keep the rest for the next call */
+	for (i = 0; (i < cnt) && (n >= (ssize_t) iov[i].iov_len); i++) {
+		n -= iov[i].iov_len;
+		_free_outgoing_msg(msgs[i], client->step);
+	}
+	if (i < cnt) {
+		client->out_msg = msgs[i];
+		client->out_remaining = iov[i].iov_len - n;
+		for (int j = cnt - 1; j > i; j--)
+			list_push(client->msg_queue, msgs[j]);
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * The slurmstepd writes I/O to a file, possibly adding a label.
  */
@@ -532,6 +609,9 @@ static int _local_file_write(eio_obj_t *obj, list_t *objs)
 	buf_t *header_tmp_buf;
 
 	xassert(client->magic == CLIENT_IO_MAGIC);
+
+	if (!client->labelio)
+		return _local_file_write_batch(obj, client);
 	/*
 	 * If we aren't already in the middle of sending a message, get the
 	 * next message from the queue.
@@ -1866,7 +1946,7 @@ static struct io_buf *_alloc_io_buf(void)
 	buf->length = 0;
 	/* The following "+ 1" is just temporary so I can stick a \0 at
 	   the end and do a printf of the data pointer */
-	buf->data = xmalloc(SLURM_IO_MAX_MSG_LEN + IO_HDR_PACKET_BYTES + 1);
+	buf->data = xmalloc_nz(SLURM_IO_MAX_MSG_LEN + IO_HDR_PACKET_BYTES + 1);
 
 	return buf;
 }
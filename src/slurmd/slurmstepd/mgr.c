@@ -88,6 +88,7 @@
 #include "src/common/spank.h"
 #include "src/common/strlcpy.h"
 #include "src/common/tres_frequency.h"
+#include "src/common/usdt.h"
 #include "src/common/util-net.h"
 #include "src/common/x11_util.h"
 #include "src/common/xmalloc.h"
@@ -1896,6 +1897,18 @@ struct exec_wait_info {
 	int childfd;
 };
 
+/*
+ * Steps with at least FORK_TREE_MIN_TASKS tasks on the node fork them from
+ * helper processes of FORK_TREE_TASKS tasks each, see _fork_tasks_tree().
+ */
+#define FORK_TREE_MIN_TASKS 32
+#define FORK_TREE_TASKS 16
+
+typedef struct {
+	int id;		/* task id */
+	pid_t pid;	/* pid of the task, -1 if its fork failed */
+} fork_tree_rec_t;
+
 static struct exec_wait_info * _exec_wait_info_create (int i)
 {
 	int fdpair[2];
@@ -2061,6 +2074,228 @@ static void prepare_stdio (stepd_step_rec_t *step, stepd_step_task_info_t *task)
 	return;
 }
 
+/*
+ * Task side of _fork_all_tasks(), run in the forked task. Never returns.
+ */
+static void _task_child(stepd_step_rec_t *step, int i,
+			struct exec_wait_info *ei, struct priv_state *sprivs)
+{
+	int rc;
+
+	/* jobacctinfo_endpoll();
+	 * closing jobacct files here causes deadlock */
+
+	if (slurm_conf.propagate_prio_process)
+		_set_prio_process(step);
+
+	/*
+	 * Reclaim privileges for the child and call any plugin
+	 * hooks that may require elevated privs
+	 * sprivs->gid_list is already set from the
+	 * drop_privileges call in _fork_all_tasks(), no not reinitialize.
+	 * NOTE: Only put things in here that are self contained
+	 * and belong in the child.
+	 */
+	if ((rc = _pre_task_child_privileged(step, i, sprivs)))
+		fatal("%s: _pre_task_child_privileged() failed: %s",
+		      __func__, slurm_strerror(rc));
+
+	if (_become_user(step, sprivs) < 0) {
+		error("_become_user failed: %m");
+		/* child process, should not return */
+		_exit(1);
+	}
+
+	/* log_fini(); */ /* note: moved into exec_task() */
+
+	/*
+	 *  Need to setup stdio before setpgid() is called
+	 *   in case we are setting up a tty. (login_tty()
+	 *   must be called before setpgid() or it is
+	 *   effectively disabled).
+	 */
+	prepare_stdio(step, step->task[i]);
+
+	/* Close profiling file descriptors */
+	acct_gather_profile_g_child_forked();
+
+	/*
+	 *  Block until parent notifies us that it is ok to
+	 *   proceed. This allows the parent to place all
+	 *   children in any process groups or containers
+	 *   before they make a call to exec(2).
+	 */
+	if (_exec_wait_child_wait_for_parent(ei) < 0)
+		_exit(1);
+
+	exec_task(step, i);
+}
+
+#if defined(HAVE_SYS_PRCTL_H) && defined(PR_SET_CHILD_SUBREAPER)
+/*
+ * Fork tasks lo to hi - 1 in a _fork_tasks_tree() helper, reporting their
+ * pids to the slurmstepd over report_fd. Never returns.
+ */
+static void _fork_tree_helper(stepd_step_rec_t *step,
+			      struct exec_wait_info **eis, int lo, int hi,
+			      int report_fd, struct priv_state *sprivs)
+{
+	for (int i = lo; i < hi; i++) {
+		fork_tree_rec_t rec = { .id = i };
+
+		if (!(rec.pid = fork())) {
+			/* Keep only this task's end of its own pipe */
+			(void) close(report_fd);
+			for (int j = 0; j < step->node_tasks; j++) {
+				if (j != i) {
+					(void) close(eis[j]->childfd);
+					eis[j]->childfd = -1;
+				}
+				(void) close(eis[j]->parentfd);
+				eis[j]->parentfd = -1;
+			}
+			_task_child(step, i, eis[i], sprivs);
+		} else if (rec.pid < 0) {
+			error("child fork: %m");
+		}
+
+		if ((write(report_fd, &rec, sizeof(rec)) != sizeof(rec)) ||
+		    (rec.pid < 0))
+			_exit(1);
+	}
+
+	_exit(0);
+}
+#endif
+
+/*
+ * Fork all tasks of a step with many tasks on this node from helper
+ * processes. Forks of the slurmstepd are serialized on its address space,
+ * while each helper has a copy of its own and the helpers fork in
+ * parallel. Once a helper exits its tasks are reparented to the
+ * slurmstepd, acting as a child subreaper meanwhile, so they are reaped
+ * and signaled like tasks forked directly.
+ * On success the tasks are added to exec_wait_list in order.
+ * RET count of tasks forked, 0 to fork them sequentially instead, or -1
+ *     on error with any tasks forked added to exec_wait_list
+ */
+static int _fork_tasks_tree(stepd_step_rec_t *step, list_t *exec_wait_list,
+			    struct priv_state *sprivs)
+{
+#if defined(HAVE_SYS_PRCTL_H) && defined(PR_SET_CHILD_SUBREAPER)
+	struct exec_wait_info **eis = NULL;
+	int report[2] = {-1, -1};
+	int helper_cnt = 0, rc = 0;
+	pid_t *helpers = NULL;
+	uint32_t task_offset = 0;
+	fork_tree_rec_t rec;
+	ssize_t len;
+
+	if ((step->node_tasks < FORK_TREE_MIN_TASKS) ||
+	    (step->flags & LAUNCH_PTY))
+		return 0;
+
+	if (step->het_job_task_offset != NO_VAL)
+		task_offset = step->het_job_task_offset;
+
+	eis = xcalloc(step->node_tasks, sizeof(*eis));
+	for (int i = 0; i < step->node_tasks; i++) {
+		/* Likely out of file descriptors, fork sequentially */
+		if (!(eis[i] = _exec_wait_info_create(i)))
+			goto fallback;
+	}
+	if (pipe2(report, O_CLOEXEC) < 0) {
+		error("%s: pipe2: %m", __func__);
+		goto fallback;
+	}
+	if (prctl(PR_SET_CHILD_SUBREAPER, 1) < 0) {
+		error("%s: prctl(PR_SET_CHILD_SUBREAPER): %m", __func__);
+		goto fallback;
+	}
+
+	helper_cnt = ROUNDUP(step->node_tasks, FORK_TREE_TASKS);
+	helpers = xcalloc(helper_cnt, sizeof(*helpers));
+	for (int h = 0; h < helper_cnt; h++) {
+		int lo = h * FORK_TREE_TASKS;
+		int hi = MIN((lo + FORK_TREE_TASKS), step->node_tasks);
+
+		for (int i = lo; i < hi; i++)
+			acct_gather_profile_g_task_start(i);
+
+		if ((helpers[h] = fork()) < 0) {
+			error("child fork: %m");
+			rc = -1;
+			break;
+		} else if (!helpers[h]) {
+			(void) close(report[0]);
+			_fork_tree_helper(step, eis, lo, hi, report[1], sprivs);
+		}
+	}
+
+	/* EOF once every helper and task closed its copy of report[1] */
+	(void) close(report[1]);
+	while ((len = read(report[0], &rec, sizeof(rec))) != 0) {
+		if ((len < 0) && (errno == EINTR))
+			continue;
+		if ((len != sizeof(rec)) || (rec.id < 0) ||
+		    (rec.id >= step->node_tasks)) {
+			error("%s: bad report from helper", __func__);
+			rc = -1;
+			break;
+		}
+		if ((eis[rec.id]->pid = rec.pid) < 0)
+			rc = -1;
+	}
+	(void) close(report[0]);
+
+	for (int h = 0; h < helper_cnt; h++) {
+		if ((helpers[h] > 0) && (waitpid(helpers[h], NULL, 0) < 0))
+			error("%s: waitpid(%d): %m", __func__, helpers[h]);
+	}
+	xfree(helpers);
+
+	/* Helpers are reaped, so their tasks are our children now */
+	if (prctl(PR_SET_CHILD_SUBREAPER, 0) < 0)
+		error("%s: prctl(PR_SET_CHILD_SUBREAPER): %m", __func__);
+
+	for (int i = 0; i < step->node_tasks; i++) {
+		char time_stamp[256];
+
+		if (eis[i]->pid <= 0) {
+			_exec_wait_info_destroy(eis[i]);
+			rc = -1;
+			continue;
+		}
+
+		(void) close(eis[i]->childfd);
+		eis[i]->childfd = -1;
+		list_append(exec_wait_list, eis[i]);
+
+		log_timestamp(time_stamp, sizeof(time_stamp));
+		verbose("task %lu (%lu) started %s",
+			(unsigned long) step->task[i]->gtid + task_offset,
+			(unsigned long) eis[i]->pid, time_stamp);
+
+		step->task[i]->pid = eis[i]->pid;
+		if (i == 0)
+			step->pgid = eis[i]->pid;
+	}
+	xfree(eis);
+
+	return rc ? -1 : step->node_tasks;
+
+fallback:
+	if (report[0] >= 0) {
+		(void) close(report[0]);
+		(void) close(report[1]);
+	}
+	for (int i = 0; i < step->node_tasks; i++)
+		_exec_wait_info_destroy(eis[i]);
+	xfree(eis);
+#endif
+	return 0;
+}
+
 /*
  * fork and exec N tasks
  */
@@ -2219,7 +2454,12 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 	 * Fork all of the task processes.
 	 */
 	verbose("starting %u tasks", step->node_tasks);
-	for (i = 0; i < step->node_tasks; i++) {
+	if ((i = _fork_tasks_tree(step, exec_wait_list, &sprivs)) < 0) {
+		exec_wait_kill_children(exec_wait_list);
+		rc = SLURM_ERROR;
+		goto fail4;
+	}
+	for (; i < step->node_tasks; i++) {
 		char time_stamp[256];
 		pid_t pid;
 		struct exec_wait_info *ei;
@@ -2231,8 +2471,6 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 			rc = SLURM_ERROR;
 			goto fail4;
 		} else if ((pid = _exec_wait_get_pid(ei)) == 0) { /* child */
-			int rc;
-
 			/*
 			 *  Destroy exec_wait_list in the child.
 			 *   Only exec_wait_info for previous tasks have been
@@ -2241,53 +2479,7 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 			 */
 			FREE_NULL_LIST(exec_wait_list);
 
-			/* jobacctinfo_endpoll();
-			 * closing jobacct files here causes deadlock */
-
-			if (slurm_conf.propagate_prio_process)
-				_set_prio_process(step);
-
-			/*
-			 * Reclaim privileges for the child and call any plugin
-			 * hooks that may require elevated privs
-			 * sprivs.gid_list is already set from the
-			 * drop_privileges call above, no not reinitialize.
-			 * NOTE: Only put things in here that are self contained
-			 * and belong in the child.
-			 */
-			if ((rc = _pre_task_child_privileged(step, i, &sprivs)))
-				fatal("%s: _pre_task_child_privileged() failed: %s",
-				      __func__, slurm_strerror(rc));
-
- 			if (_become_user(step, &sprivs) < 0) {
- 				error("_become_user failed: %m");
-				/* child process, should not return */
-				_exit(1);
- 			}
-
-			/* log_fini(); */ /* note: moved into exec_task() */
-
-			/*
-			 *  Need to setup stdio before setpgid() is called
-			 *   in case we are setting up a tty. (login_tty()
-			 *   must be called before setpgid() or it is
-			 *   effectively disabled).
-			 */
-			prepare_stdio(step, step->task[i]);
-
-			/* Close profiling file descriptors */
-			acct_gather_profile_g_child_forked();
-
-			/*
-			 *  Block until parent notifies us that it is ok to
-			 *   proceed. This allows the parent to place all
-			 *   children in any process groups or containers
-			 *   before they make a call to exec(2).
-			 */
-			if (_exec_wait_child_wait_for_parent(ei) < 0)
-				_exit(1);
-
-			exec_task(step, i);
+			_task_child(step, i, ei, &sprivs);
 		}
 
 		/*
@@ -2304,6 +2496,9 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 		step->task[i]->pid = pid;
 		if (i == 0)
 			step->pgid = pid;
+		SLURM_PROBE4(task_fork, step->step_id.job_id,
+			     step->step_id.step_id,
+			     step->task[i]->gtid + task_offset, pid);
 	}
 
 	/*
@@ -2578,6 +2773,9 @@ _wait_for_any_task(stepd_step_rec_t *step, bool waitflag)
 		if ((t = job_task_info_by_pid(step, pid))) {
 			completed++;
 			_log_task_exit(t->gtid + task_offset, pid, status);
+			SLURM_PROBE4(task_exit, step->step_id.job_id,
+				     step->step_id.step_id,
+				     t->gtid + task_offset, status);
 			t->exited  = true;
 			t->estatus = status;
 			step->envtp->procid = t->gtid + task_offset;
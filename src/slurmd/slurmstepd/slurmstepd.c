@@ -886,8 +886,37 @@ _init_from_slurmd(int sock, char **argv, slurm_addr_t **_cli,
 	/* receive conf_hashtbl from slurmd */
 	read_conf_recv_stepd(sock);
 
-	/* receive job type from slurmd */
-	safe_read(sock, &step_type, sizeof(int));
+	/*
+	 * Init all plugins after receiving the slurm.conf from the slurmd.
+	 * Done before the rest of the launch request arrives, so an idle
+	 * slurmstepd from the LaunchParameters=slurmstepd_pool pool has them
+	 * loaded already. Init switch before unpack_msg to only init the
+	 * default.
+	 */
+	if ((switch_g_init(true) != SLURM_SUCCESS) ||
+	    (cred_g_init() != SLURM_SUCCESS) ||
+	    (gres_init() != SLURM_SUCCESS) ||
+	    (auth_g_init() != SLURM_SUCCESS) ||
+	    (cgroup_g_init() != SLURM_SUCCESS) ||
+	    (hash_g_init() != SLURM_SUCCESS) ||
+	    (acct_gather_conf_init() != SLURM_SUCCESS) ||
+	    (prep_g_init(NULL) != SLURM_SUCCESS) ||
+	    (proctrack_g_init() != SLURM_SUCCESS) ||
+	    (slurmd_task_init() != SLURM_SUCCESS) ||
+	    (jobacct_gather_init() != SLURM_SUCCESS) ||
+	    (acct_gather_profile_init() != SLURM_SUCCESS) ||
+	    (job_container_init() != SLURM_SUCCESS) ||
+	    (topology_g_init() != SLURM_SUCCESS))
+		fatal("Couldn't load all plugins");
+
+	/* receive job type from slurmd, slurmd may close an idle stepd */
+	if (!(len = read(sock, &step_type, sizeof(int)))) {
+		debug("%s: slurmd closed connection before launch request",
+		      __func__);
+		exit(0);
+	} else if (len != sizeof(int)) {
+		goto rwfail;
+	}
 	debug3("step_type = %d", step_type);
 
 	/* receive reverse-tree info from slurmd */
@@ -953,16 +982,6 @@ _init_from_slurmd(int sock, char **argv, slurm_addr_t **_cli,
 		break;
 	}
 
-	/* Init switch before unpack_msg to only init the default */
-	if (switch_g_init(true) != SLURM_SUCCESS)
-		fatal("failed to initialize switch plugin");
-
-	if (cred_g_init() != SLURM_SUCCESS)
-		fatal("failed to initialize credential plugin");
-
-	if (gres_init() != SLURM_SUCCESS)
-		fatal("failed to initialize gres plugins");
-
 	if (unpack_msg(msg, buffer) == SLURM_ERROR)
 		fatal("slurmstepd: we didn't unpack the request correctly");
 	FREE_NULL_BUFFER(buffer);
@@ -997,22 +1016,6 @@ _init_from_slurmd(int sock, char **argv, slurm_addr_t **_cli,
 
 	_set_job_log_prefix(&step_id);
 
-	/*
-	 * Init all plugins after receiving the slurm.conf from the slurmd.
-	 */
-	if ((auth_g_init() != SLURM_SUCCESS) ||
-	    (cgroup_g_init() != SLURM_SUCCESS) ||
-	    (hash_g_init() != SLURM_SUCCESS) ||
-	    (acct_gather_conf_init() != SLURM_SUCCESS) ||
-	    (prep_g_init(NULL) != SLURM_SUCCESS) ||
-	    (proctrack_g_init() != SLURM_SUCCESS) ||
-	    (slurmd_task_init() != SLURM_SUCCESS) ||
-	    (jobacct_gather_init() != SLURM_SUCCESS) ||
-	    (acct_gather_profile_init() != SLURM_SUCCESS) ||
-	    (job_container_init() != SLURM_SUCCESS) ||
-	    (topology_g_init() != SLURM_SUCCESS))
-		fatal("Couldn't load all plugins");
-
 	/*
 	 * Receive all secondary conf files from the slurmd.
 	 */
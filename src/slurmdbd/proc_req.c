@@ -54,6 +54,7 @@
 #include "src/interfaces/jobacct_gather.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/slurm_protocol_pack.h"
 #include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xstring.h"
@@ -63,6 +64,10 @@
 #include "src/slurmdbd/slurmdbd.h"
 #include "src/slurmctld/slurmctld.h"
 
+static pthread_mutex_t query_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t query_cond = PTHREAD_COND_INITIALIZER;
+static int query_cnt = 0;
+
 /* Local functions */
 static bool _validate_slurm_user(slurmdbd_conn_t *dbd_conn);
 static bool _validate_super_user(slurmdbd_conn_t *dbd_conn);
@@ -1147,8 +1152,19 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			list_msg.my_list = list_create(NULL);
 		*out_buffer = init_buf(1024);
 		pack16((uint16_t) DBD_GOT_JOBS, *out_buffer);
-		slurmdbd_pack_list_msg(&list_msg, slurmdbd_conn->conn->version,
-				       DBD_GOT_JOBS, *out_buffer);
+		/*
+		 * Same layout as slurmdbd_pack_list_msg(), but free the job
+		 * records as they get packed so the whole result is not held
+		 * twice in memory for long queries.
+		 */
+		if ((rc = slurm_pack_list_pop(list_msg.my_list,
+					      slurmdb_pack_job_rec,
+					      slurmdb_destroy_job_rec,
+					      *out_buffer,
+					      slurmdbd_conn->conn->version)))
+			list_msg.return_code = rc;
+		pack32(list_msg.return_code, *out_buffer);
+		rc = SLURM_SUCCESS;
 	} else {
 		*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
 							errno,
@@ -3164,6 +3180,11 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 	}
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
+	/*
+	 * Commit once for the whole bundle instead of once per message, as
+	 * proc_req() for DBD_SEND_MULT_MSG commits after we return.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
 	/* START_TIMER; */
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
@@ -3187,6 +3208,7 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			break;
 	}
 	list_iterator_destroy(itr);
+	slurmdbd_conn->in_mult_msg = false;
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -3443,12 +3465,68 @@ static int _shutdown(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
  * buffer OUT - outgoing response, must be freed by caller
  * uid IN/OUT - user ID who initiated the RPC
  * RET SLURM_SUCCESS or error code */
+/*
+ * Queries that can scan large parts of the database. These are only sent by
+ * clients and reports, never by a slurmctld on its hot path.
+ */
+static bool _is_heavy_query(slurmdbd_msg_type_t msg_type)
+{
+	switch (msg_type) {
+	case DBD_GET_ASSOC_USAGE:
+	case DBD_GET_CLUSTER_USAGE:
+	case DBD_GET_EVENTS:
+	case DBD_GET_INSTANCES:
+	case DBD_GET_JOBS_COND:
+	case DBD_GET_RESVS:
+	case DBD_GET_TXN:
+	case DBD_GET_WCKEY_USAGE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Wait for a slot to run a heavy query so that no more than
+ * Parameters=max_query_threads run at once, leaving the database and the
+ * other connection threads available for the accounting traffic of the
+ * clusters.
+ * RET true if a slot was taken and _query_slot_release() must be called
+ */
+static bool _query_slot_acquire(slurmdbd_conn_t *slurmdbd_conn,
+				persist_msg_t *msg)
+{
+	if (!slurmdbd_conf->max_query_threads || !_is_heavy_query(msg->msg_type))
+		return false;
+
+	slurm_mutex_lock(&query_mutex);
+	if (query_cnt >= slurmdbd_conf->max_query_threads)
+		debug2("CONN:%d %s waiting for one of %d running queries",
+		       slurmdbd_conn->conn->fd,
+		       slurmdbd_msg_type_2_str(msg->msg_type, 1), query_cnt);
+	while (query_cnt >= slurmdbd_conf->max_query_threads)
+		slurm_cond_wait(&query_cond, &query_mutex);
+	query_cnt++;
+	slurm_mutex_unlock(&query_mutex);
+
+	return true;
+}
+
+static void _query_slot_release(void)
+{
+	slurm_mutex_lock(&query_mutex);
+	query_cnt--;
+	slurm_cond_signal(&query_cond);
+	slurm_mutex_unlock(&query_mutex);
+}
+
 extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 {
 	slurmdbd_conn_t *slurmdbd_conn = conn;
 	int rc = SLURM_SUCCESS;
 	char *comment = NULL;
 	slurmdb_rpc_obj_t *rpc_obj;
+	bool query_slot;
 
 	DEF_TIMERS;
 	START_TIMER;
@@ -3480,6 +3558,8 @@ extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 			 &cli_addr, slurmdbd_conn->conn->version);
 	}
 
+	query_slot = _query_slot_acquire(slurmdbd_conn, msg);
+
 	switch (msg->msg_type) {
 	case REQUEST_PERSIST_INIT:
 	case REQUEST_PERSIST_INIT_TLS:
@@ -3717,17 +3797,23 @@ extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 		break;
 	}
 
+	if (query_slot)
+		_query_slot_release();
+
 	if (rc == ESLURM_ACCESS_DENIED)
 		error("CONN:%d Security violation, %s",
 		      slurmdbd_conn->conn->fd,
 		      slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->conn->rem_port &&
-		 (!slurmdbd_conf->commit_delay ||
+		 ((!slurmdbd_conf->commit_delay &&
+		   !slurmdbd_conn->in_mult_msg) ||
 		  (msg->msg_type == DBD_REGISTER_CTLD))) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
+		   Messages of a DBD_SEND_MULT_MSG are committed
+		   together once the whole bundle is processed.
 		*/
 		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
 	}
@@ -48,6 +48,7 @@ typedef struct {
 	persist_conn_t *conn_send;
 	pthread_mutex_t conn_send_lock;
 	void *db_conn; /* database connection */
+	bool in_mult_msg; /* processing the messages of a DBD_SEND_MULT_MSG */
 	char *tres_str;
 } slurmdbd_conn_t;
 
@@ -99,6 +99,7 @@ static void _clear_slurmdbd_conf(void)
 		xfree(slurmdbd_conf->default_qos);
 		slurmdbd_conf->flags = 0;
 		xfree(slurmdbd_conf->log_file);
+		slurmdbd_conf->max_query_threads = 0;
 		slurmdbd_conf->syslog_debug = LOG_LEVEL_END;
 		xfree(slurmdbd_conf->parameters);
 		xfree(slurmdbd_conf->pid_file);
@@ -404,6 +405,12 @@ extern int read_slurmdbd_conf(void)
 					"PreserveCaseUser"))
 				slurmdbd_conf->persist_conn_rc_flags |=
 					PERSIST_FLAG_P_USER_CASE;
+			if ((temp_str = xstrcasestr(slurmdbd_conf->parameters,
+						    "max_query_threads="))) {
+				slurmdbd_conf->max_query_threads =
+					atoi(temp_str + 18);
+				temp_str = NULL;
+			}
 		}
 
 		s_p_get_string(&slurmdbd_conf->pid_file, "PidFile", tbl);
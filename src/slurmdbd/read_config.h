@@ -78,6 +78,8 @@ typedef struct {
 	uint32_t flags;			/* Various flags see DBD_CONF_FLAG_* */
 	char *		log_file;	/* Log file			*/
 	uint32_t	max_time_range;	/* max time range for user queries */
+	uint16_t	max_query_threads; /* max concurrent heavy queries,
+					    * 0 for no limit		*/
 	char *		parameters;	/* parameters to change behavior with
 					 * the slurmdbd directly	*/
 	uint16_t        persist_conn_rc_flags; /* flags to be sent back on any
@@ -429,71 +429,15 @@ no_mem:
 	return _send_reject(parser, HTTP_STATUS_CODE_ERROR_ENTITY_TOO_LARGE);
 }
 
-/*
- * Create rfc2616 formatted header
- * TODO: add more sanity checks
- * IN name header name
- * IN value header value
- * RET formatted string (must xfree)
- * */
-static char *_fmt_header(const char *name, const char *value)
-{
-	return xstrdup_printf("%s: %s"CRLF, name, value);
-}
-
-/*
- * Create and write formatted header
- * IN request HTTP request
- * IN name header name
- * IN value header value
- * RET formatted string (must xfree)
- * */
-static int _write_fmt_header(conmgr_fd_t *con, const char *name,
-			     const char *value)
-{
-	const char *buffer = _fmt_header(name, value);
-	int rc = conmgr_queue_write_data(con, buffer, strlen(buffer));
-	xfree(buffer);
-	return rc;
-}
-
-/*
- * Create rfc2616 formatted numerical header
- * TODO: add sanity checks
- * IN name header name
- * IN value header value
- * RET formatted string (must xfree)
- * */
-static char *_fmt_header_num(const char *name, size_t value)
-{
-	return xstrdup_printf("%s: %zu" CRLF, name, value);
-}
-
-extern int send_http_connection_close(http_context_t *ctxt)
-{
-	return _write_fmt_header(ctxt->con, "Connection", "Close");
-}
-
-/*
- * Create and write formatted numerical header
- * IN request HTTP request
- * IN name header name
- * IN value header value
- * RET formatted string (must xfree)
- * */
-static int _write_fmt_num_header(conmgr_fd_t *con, const char *name,
-				 size_t value)
-{
-	const char *buffer = _fmt_header_num(name, value);
-	int rc = conmgr_queue_write_data(con, buffer, strlen(buffer));
-	xfree(buffer);
-	return rc;
-}
-
 extern int send_http_response(const send_http_response_args_t *args)
 {
-	char *buffer = NULL;
+	char *buffer = NULL, *at = NULL;
 	int rc = SLURM_SUCCESS;
+	/* RFC7230-3.3 responses that never include a message body */
+	const bool no_body = (((args->status_code >= 100) &&
+			       (args->status_code < 200)) ||
+			      (args->status_code == 204) ||
+			      (args->status_code == 304));
 	xassert(args->status_code != HTTP_STATUS_NONE);
 	xassert(args->body_length == 0 || (args->body_length && args->body));
 
@@ -502,70 +446,58 @@ extern int send_http_response(const send_http_response_args_t *args)
 	       args->status_code,
 	       get_http_status_code_string(args->status_code));
 
-	/* send rfc2616 response */
-	xstrfmtcat(buffer, "HTTP/%d.%d %d %s"CRLF,
-		   args->http_major, args->http_minor, args->status_code,
-		   get_http_status_code_string(args->status_code));
-
-	rc = conmgr_queue_write_data(args->con, buffer, strlen(buffer));
-	xfree(buffer);
-
-	if (rc)
-		return rc;
+	/*
+	 * Format the rfc2616 status line and every header into a single
+	 * buffer to only queue one write for all of them.
+	 */
+	xstrfmtcatat(buffer, &at, "HTTP/%d.%d %d %s"CRLF,
+		     args->http_major, args->http_minor, args->status_code,
+		     get_http_status_code_string(args->status_code));
 
 	/* send along any requested headers */
 	if (args->headers) {
 		list_itr_t *itr = list_iterator_create(args->headers);
 		http_header_entry_t *header = NULL;
-		while ((header = list_next(itr))) {
-			if ((rc = _write_fmt_header(args->con, header->name,
-						    header->value)))
-				break;
-		}
+		while ((header = list_next(itr)))
+			xstrfmtcatat(buffer, &at, "%s: %s"CRLF,
+				     header->name, header->value);
 		list_iterator_destroy(itr);
-
-		if (rc)
-			return rc;
 	}
 
-	if (args->body && args->body_length) {
-		/* RFC7230-3.3.2 limits response of Content-Length */
-		if ((args->status_code < 100) ||
-		    ((args->status_code >= 200) &&
-		     (args->status_code != 204))) {
-			if ((rc = _write_fmt_num_header(args->con,
-				"Content-Length", args->body_length))) {
-				return rc;
-			}
-		}
+	/* Warn client that connection will be closed after this response */
+	if (args->connection_close)
+		xstrcatat(buffer, &at, "Connection: Close"CRLF);
 
-		if (args->body_encoding &&
-		    (rc = _write_fmt_header(
-			     args->con, "Content-Type", args->body_encoding)))
-			return rc;
+	/*
+	 * RFC7230-3.3.2 limits response of Content-Length. Always send the
+	 * length otherwise to let client find the end of the response
+	 * without closing the connection.
+	 */
+	if (!no_body)
+		xstrfmtcatat(buffer, &at, "Content-Length: %zu"CRLF,
+			     args->body_length);
 
-		if ((rc = conmgr_queue_write_data(args->con, CRLF,
-						  strlen(CRLF))))
-			return rc;
+	if (args->body && args->body_length && args->body_encoding)
+		xstrfmtcatat(buffer, &at, "Content-Type: %s"CRLF,
+			     args->body_encoding);
 
+	/* RFC2616 requires empty line after headers */
+	xstrcatat(buffer, &at, CRLF);
+
+	rc = conmgr_queue_write_data(args->con, buffer, (at - buffer));
+	xfree(buffer);
+
+	if (rc)
+		return rc;
+
+	if (args->body && args->body_length) {
 		log_flag(NET, "%s: [%s] rc=%s(%u) sending body:\n%s",
 			 __func__, conmgr_fd_get_name(args->con),
 			 get_http_status_code_string(args->status_code),
 			 args->status_code, args->body);
 
-		if ((rc = conmgr_queue_write_data(args->con, args->body,
-						  args->body_length)))
-			return rc;
-	} else if (((args->status_code >= 100) && (args->status_code < 200)) ||
-		   (args->status_code == 204) ||
-		   (args->status_code == 304)) {
-		/*
-		 * RFC2616 requires empty line after headers for return code
-		 * that "MUST NOT" include a message body
-		 */
-		if ((rc = conmgr_queue_write_data(args->con, CRLF,
-						  strlen(CRLF))))
-			return rc;
+		rc = conmgr_queue_write_data(args->con, args->body,
+					     args->body_length);
 	}
 
 	return rc;
@@ -583,7 +515,10 @@ static int _send_reject(const http_parser *parser,
 		.http_minor = parser->http_minor,
 		.status_code = status_code,
 		.body_length = 0,
-		.headers = list_create(_free_http_header),
+		.connection_close = (request->connection_close ||
+				     ((parser->http_major == 1) &&
+				      (parser->http_minor >= 1)) ||
+				     (parser->http_major > 1)),
 	};
 
 	/* If we don't have a requested client version, default to 0.9 */
@@ -592,12 +527,6 @@ static int _send_reject(const http_parser *parser,
 
 	/* Ignore response since this connection is already dead */
 	(void) send_http_response(&args);
-	FREE_NULL_LIST(args.headers);
-
-	if (request->connection_close ||
-	    ((parser->http_major == 1) && (parser->http_minor >= 1)) ||
-	     (parser->http_major > 1))
-		send_http_connection_close(request->context);
 
 	/* ensure connection gets closed */
 	(void) conmgr_queue_close_fd(request->context->con);
@@ -622,7 +551,8 @@ static int _on_message_complete_request(http_parser *parser,
 		.accept = request->accept,
 		.body = request->body,
 		.body_length = request->body_length,
-		.body_encoding = request->body_encoding
+		.body_encoding = request->body_encoding,
+		.connection_close = request->connection_close,
 	};
 
 	xassert(request->magic == MAGIC_REQUEST_T);
@@ -721,10 +651,7 @@ static int _on_message_complete(http_parser *parser)
 		parser->data = nrequest;
 		_free_request_t(request);
 	} else {
-		/* Notify client that this connection will be closed now */
-		if (request->connection_close)
-			send_http_connection_close(request->context);
-
+		/* response already included Connection: Close */
 		conmgr_queue_close_fd(request->context->con);
 
 		request->context->request = NULL;
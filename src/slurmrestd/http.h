@@ -84,6 +84,8 @@ typedef struct on_http_request_args_s {
 	const char *body; /* body sent by client or NULL (do not xfree) */
 	const size_t body_length; /* bytes in body to send or 0 */
 	const char *body_encoding; /* body encoding type or NULL */
+	/* RFC7230-6.1 connection will be closed after response */
+	const bool connection_close;
 } on_http_request_args_t;
 
 typedef struct {
@@ -125,16 +127,9 @@ typedef struct {
 	const char *body; /* body to send or NULL */
 	size_t body_length; /* bytes in body to send or 0 */
 	const char *body_encoding; /* body encoding type or NULL */
+	bool connection_close; /* send "Connection: Close" header */
 } send_http_response_args_t;
 
-/*
- * Send HTTP close notification.
- * 	Warns the client that we are about to close the connection.
- * IN args arguments of response
- * RET SLURM_SUCCESS or error
- */
-extern int send_http_connection_close(http_context_t *ctxt);
-
 /*
  * Send HTTP response
  * IN args arguments of response
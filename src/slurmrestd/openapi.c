@@ -37,6 +37,7 @@
 #include "src/common/plugrack.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -106,6 +107,32 @@ typedef struct {
 	int tag;
 } match_path_from_data_t;
 
+/*
+ * Routing tree of every bound path entry. Each level is one directory of the
+ * URL with literal entries indexed by string and a single child for all
+ * parameter entries. Methods are stored where their path ends.
+ */
+typedef struct route_s route_t;
+struct route_s {
+	char *entry; /* literal entry string or NULL for parameter */
+	xhash_t *literals; /* child routes by literal entry */
+	route_t *param; /* child route for any parameter entry */
+	list_t *targets; /* list of route_target_t ending here */
+};
+
+typedef struct {
+	int order; /* registration order to keep first match wins */
+	path_t *path;
+	entry_method_t *method;
+} route_target_t;
+
+typedef struct {
+	const data_t **entries;
+	int count;
+	http_request_method_t method;
+	list_t *candidates;
+} route_find_t;
+
 #define MAGIC_MERGE_PATH 0x22b2ae44
 typedef struct {
 	int magic; /* MAGIC_MERGE_PATH */
@@ -143,6 +170,10 @@ typedef struct {
 
 static list_t *paths = NULL;
 static int path_tag_counter = 0;
+static route_t *routes = NULL;
+static int route_counter = 0;
+static pthread_mutex_t spec_lock = PTHREAD_MUTEX_INITIALIZER;
+static data_t *spec_cache = NULL; /* generated spec for /openapi/v3 */
 static plugins_t *plugins = NULL;
 static data_parser_t **parsers = NULL; /* symlink to parser array */
 
@@ -577,6 +608,125 @@ static bool _data_parser_supports_method(data_parser_t *parser,
 	return true;
 }
 
+static void _route_id(void *item, const char **key, uint32_t *key_len)
+{
+	route_t *route = item;
+
+	*key = route->entry;
+	*key_len = strlen(route->entry);
+}
+
+static void _free_route(void *x)
+{
+	route_t *route = x;
+
+	if (!route)
+		return;
+
+	if (route->literals)
+		xhash_free(route->literals);
+	_free_route(route->param);
+	FREE_NULL_LIST(route->targets);
+	xfree(route->entry);
+	xfree(route);
+}
+
+static route_t *_get_route_child(route_t *route, const entry_t *entry)
+{
+	route_t *child;
+
+	if (entry->type == OPENAPI_PATH_ENTRY_MATCH_PARAMETER) {
+		if (!route->param)
+			route->param = xmalloc(sizeof(*route->param));
+		return route->param;
+	}
+
+	xassert(entry->type == OPENAPI_PATH_ENTRY_MATCH_STRING);
+
+	if (!route->literals)
+		route->literals = xhash_init(_route_id, _free_route);
+	else if ((child = xhash_get_str(route->literals, entry->entry)))
+		return child;
+
+	child = xmalloc(sizeof(*child));
+	child->entry = xstrdup(entry->entry);
+	xhash_add(route->literals, child);
+
+	return child;
+}
+
+static void _add_route(path_t *path, entry_method_t *method)
+{
+	route_t *route = routes;
+	route_target_t *target;
+
+	for (entry_t *entry = method->entries; entry->type; entry++)
+		route = _get_route_child(route, entry);
+
+	if (!route->targets)
+		route->targets = list_create(xfree_ptr);
+
+	target = xmalloc(sizeof(*target));
+	target->order = route_counter++;
+	target->path = path;
+	target->method = method;
+	list_append(route->targets, target);
+}
+
+static int _foreach_route_candidate(void *x, void *arg)
+{
+	route_target_t *target = x;
+	route_find_t *find = arg;
+
+	if (target->method->method == find->method)
+		list_append(find->candidates, target);
+
+	return SLURM_SUCCESS;
+}
+
+/* Collect every route that could match the remaining entries */
+static void _find_routes(route_t *route, route_find_t *find, int depth)
+{
+	const data_t *entry;
+
+	if (depth == find->count) {
+		if (route->targets)
+			(void) list_for_each(route->targets,
+					     _foreach_route_candidate, find);
+		return;
+	}
+
+	entry = find->entries[depth];
+
+	if (route->literals && (data_get_type(entry) == DATA_TYPE_STRING)) {
+		route_t *child = xhash_get_str(route->literals,
+					       data_get_string(entry));
+
+		if (child)
+			_find_routes(child, find, (depth + 1));
+	}
+
+	if (route->param)
+		_find_routes(route->param, find, (depth + 1));
+}
+
+static data_for_each_cmd_t _foreach_route_entry(const data_t *data, void *arg)
+{
+	route_find_t *find = arg;
+
+	find->entries[find->count++] = data;
+
+	return DATA_FOR_EACH_CONT;
+}
+
+static int _sort_route_target(void *x, void *y)
+{
+	route_target_t *a = *(route_target_t **) x;
+	route_target_t *b = *(route_target_t **) y;
+
+	return (a->order - b->order);
+}
+
 extern int register_path_binding(const char *in_path,
 				 const openapi_path_binding_t *op_path,
 				 const openapi_resp_meta_t *meta,
@@ -669,6 +819,10 @@ extern int register_path_binding(const char *in_path,
 	}
 
 	list_append(paths, p);
+
+	for (entry_method_t *em = p->methods; em->entries; em++)
+		_add_route(p, em);
+
 	*tag_ptr = tag;
 	return SLURM_SUCCESS;
 }
@@ -800,12 +954,12 @@ static char *_entry_to_string(entry_t *entry)
 	return path;
 }
 
-static int _match_path_from_data(void *x, void *key)
+static int _match_route_target(void *x, void *key)
 {
 	char *dst_path = NULL, *src_path = NULL;
 	match_path_from_data_t *args = key;
-	path_t *path = x;
-	entry_method_t *method;
+	route_target_t *target = x;
+	path_t *path = target->path;
 	bool matched = false;
 
 	xassert(path->magic == MAGIC_PATH);
@@ -813,55 +967,19 @@ static int _match_path_from_data(void *x, void *key)
 	if (get_log_level() >= LOG_LEVEL_DEBUG5) {
 		serialize_g_data_to_string(&dst_path, NULL, args->dpath,
 					   MIME_TYPE_JSON, SER_FLAGS_COMPACT);
+		src_path = _entry_to_string(target->method->entries);
 	}
 
 	args->path = path;
-	for (method = path->methods; method->entries; method++) {
-		int entries = 0;
-
-		if (get_log_level() >= LOG_LEVEL_DEBUG5) {
-			xfree(src_path);
-			src_path = _entry_to_string(method->entries);
-		}
-
-		if (args->method != method->method) {
-			debug5("%s: method skip for %s(%d, %s != %s) to %s(0x%"PRIXPTR")",
-			       __func__, src_path, args->path->tag,
-			       get_http_method_string(args->method),
-			       get_http_method_string(method->method),
-			       dst_path, (uintptr_t) args->dpath);
-			continue;
-		}
-
-		for (args->entry = method->entries; args->entry->type;
-		     entries++, args->entry++)
-			/* do nothing */;
-
-		if (data_get_list_length(args->dpath) != entries) {
-			debug5("%s: skip non-matching subdirectories: registered=%u requested=%zu ",
-			       __func__, entries,
-			       data_get_list_length(args->dpath));
-			continue;
-		}
-
-		args->entry = method->entries;
-		if (data_list_for_each_const(args->dpath, _match_path,
-					     args) < 0) {
-			debug5("%s: match failed %s",
-			       __func__, args->entry->entry);
-			continue;
-		}
-
-		/*
-		 * The list is NULL terminated, so if entry->type is not NULL
-		 * we didn't match the whole list, but we already don't have
-		 * anything to compare in request.
-		 */
-		if (!args->entry->type) {
-			args->tag = path->tag;
-			matched = true;
-			break;
-		}
+	args->entry = target->method->entries;
+
+	/* parameters still need to be matched against their types */
+	if (data_list_for_each_const(args->dpath, _match_path, args) < 0) {
+		debug5("%s: match failed %s",
+		       __func__, args->entry->entry);
+	} else if (!args->entry->type) {
+		args->tag = path->tag;
+		matched = true;
 	}
 
 	debug5("%s: match %s for %s(%d, %s) to %s(0x%"PRIXPTR")",
@@ -888,10 +1006,25 @@ extern int find_path_tag(const data_t *dpath, data_t *params,
 		.method = method,
 		.tag = -1,
 	};
+	route_find_t find = {
+		.method = method,
+	};
 
 	xassert(data_get_type(params) == DATA_TYPE_DICT);
 
-	(void) list_find_first(paths, _match_path_from_data, &args);
+	find.entries = xcalloc((data_get_list_length(dpath) + 1),
+			       sizeof(*find.entries));
+	(void) data_list_for_each_const(dpath, _foreach_route_entry, &find);
+	find.candidates = list_create(NULL);
+
+	_find_routes(routes, &find, 0);
+
+	/* same path wins as when checking every path in order */
+	list_sort(find.candidates, _sort_route_target);
+	(void) list_find_first(find.candidates, _match_route_target, &args);
+
+	FREE_NULL_LIST(find.candidates);
+	xfree(find.entries);
 
 	return args.tag;
 }
@@ -926,6 +1059,7 @@ extern int init_openapi(const char *plugin_list, plugrack_foreach_t listf,
 		response_status_codes = default_response_status_codes;
 
 	paths = list_create(_list_delete_path_t);
+	routes = xmalloc(sizeof(*routes));
 
 	/* must have JSON plugin to parse the openapi.json */
 	if ((rc = serializer_g_init(MIME_TYPE_JSON_PLUGIN, NULL)))
@@ -988,7 +1122,10 @@ extern void destroy_openapi(void)
 	}
 
 	FREE_NULL_PLUGINS(plugins);
+	_free_route(routes);
+	routes = NULL;
 	FREE_NULL_LIST(paths);
+	FREE_NULL_DATA(spec_cache);
 }
 
 static data_for_each_cmd_t _merge_operationId_strings(data_t *data, void *arg)
@@ -1444,7 +1581,21 @@ extern int generate_spec(data_t *dst)
 
 static int _op_handler_openapi(openapi_ctxt_t *ctxt)
 {
-	return generate_spec(ctxt->resp);
+	int rc = SLURM_SUCCESS;
+
+	/* paths are only bound at startup so the spec never changes */
+	slurm_mutex_lock(&spec_lock);
+	if (!spec_cache) {
+		spec_cache = data_new();
+
+		if ((rc = generate_spec(spec_cache)))
+			FREE_NULL_DATA(spec_cache);
+	}
+	if (spec_cache)
+		data_copy(ctxt->resp, spec_cache);
+	slurm_mutex_unlock(&spec_lock);
+
+	return rc;
 }
 
 static bool _on_error(void *arg, data_parser_type_t type, int error_code,
@@ -56,6 +56,9 @@ serializer_flags_t yaml_flags = SER_FLAGS_PRETTY;
 serializer_flags_t json_flags = SER_FLAGS_PRETTY;
 
 #define MAGIC_HEADER_ACCEPT 0xDF9EAABE
+/* FNV-1a 64 bit parameters */
+#define ETAG_HASH_OFFSET 0xcbf29ce484222325ULL
+#define ETAG_HASH_PRIME 0x100000001b3ULL
 
 typedef struct {
 #define PATH_MAGIC 0xDFFEA1AE
@@ -234,29 +237,21 @@ static int _operations_router_reject(const on_http_request_args_t *args,
 {
 	send_http_response_args_t send_args = {
 		.con = args->context->con,
-		.headers = list_create(NULL),
 		.http_major = args->http_major,
 		.http_minor = args->http_minor,
 		.status_code = err_code,
 		.body = err,
 		.body_encoding = (body_encoding ? body_encoding : "text/plain"),
 		.body_length = (err ? strlen(err) : 0),
+		/* Always warn that connection will be closed after the body */
+		.connection_close = true,
 	};
-	http_header_entry_t close = {
-		.name = "Connection",
-		.value = "Close",
-	};
-
-	/* Always warn that connection will be closed after the body is sent */
-	list_append(send_args.headers, &close);
 
 	(void) send_http_response(&send_args);
 
 	/* close connection on error */
 	conmgr_queue_close_fd(args->context->con);
 
-	FREE_NULL_LIST(send_args.headers);
-
 	return SLURM_ERROR;
 }
 
@@ -492,6 +487,120 @@ static int _resolve_mime(on_http_request_args_t *args, const char **read_mime,
 	return SLURM_SUCCESS;
 }
 
+static void _etag_hash(uint64_t *hash, const void *ptr, size_t len)
+{
+	const unsigned char *p = ptr;
+
+	for (size_t i = 0; i < len; i++) {
+		*hash ^= p[i];
+		*hash *= ETAG_HASH_PRIME;
+	}
+}
+
+static void _etag_hash_data(uint64_t *hash, const data_t *data);
+
+static data_for_each_cmd_t _etag_hash_list(const data_t *data, void *arg)
+{
+	_etag_hash_data(arg, data);
+	return DATA_FOR_EACH_CONT;
+}
+
+static data_for_each_cmd_t _etag_hash_dict(const char *key, const data_t *data,
+					   void *arg)
+{
+	_etag_hash(arg, key, (strlen(key) + 1));
+	_etag_hash_data(arg, data);
+	return DATA_FOR_EACH_CONT;
+}
+
+static void _etag_hash_data(uint64_t *hash, const data_t *data)
+{
+	const data_type_t type = data_get_type(data);
+
+	_etag_hash(hash, &type, sizeof(type));
+
+	switch (type) {
+	case DATA_TYPE_LIST:
+		(void) data_list_for_each_const(data, _etag_hash_list, hash);
+		break;
+	case DATA_TYPE_DICT:
+		(void) data_dict_for_each_const(data, _etag_hash_dict, hash);
+		break;
+	case DATA_TYPE_STRING:
+	{
+		const char *str = data_get_string(data);
+
+		_etag_hash(hash, str, (strlen(str) + 1));
+		break;
+	}
+	case DATA_TYPE_INT_64:
+	{
+		const int64_t i = data_get_int(data);
+
+		_etag_hash(hash, &i, sizeof(i));
+		break;
+	}
+	case DATA_TYPE_FLOAT:
+	{
+		const double f = data_get_float(data);
+
+		_etag_hash(hash, &f, sizeof(f));
+		break;
+	}
+	case DATA_TYPE_BOOL:
+	{
+		const bool b = data_get_bool(data);
+
+		_etag_hash(hash, &b, sizeof(b));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static data_for_each_cmd_t _etag_hash_resp(const char *key, const data_t *data,
+					   void *arg)
+{
+	/* meta describes the request and client, not the resource */
+	if (!xstrcmp(key, XSTRINGIFY(OPENAPI_RESP_STRUCT_META_FIELD_NAME)))
+		return DATA_FOR_EACH_CONT;
+
+	return _etag_hash_dict(key, data, arg);
+}
+
+/*
+ * Generate entity tag for response (RFC#7232 Section:2.3) from the response
+ * contents before it is serialized.
+ */
+static char *_get_etag(const data_t *resp, const char *write_mime)
+{
+	uint64_t hash = ETAG_HASH_OFFSET;
+
+	_etag_hash(&hash, write_mime, strlen(write_mime));
+
+	if (data_get_type(resp) == DATA_TYPE_DICT)
+		(void) data_dict_for_each_const(resp, _etag_hash_resp, &hash);
+	else
+		_etag_hash_data(&hash, resp);
+
+	return xstrdup_printf("\"%016"PRIx64"\"", hash);
+}
+
+/* RFC#7232 Section:3.2 - weak comparison of If-None-Match */
+static bool _etag_matches(on_http_request_args_t *args, const char *etag)
+{
+	const char *match = find_http_header(args->headers, "If-None-Match");
+
+	if (!match)
+		return false;
+
+	if (!xstrcmp(match, "*"))
+		return true;
+
+	return (xstrstr(match, etag) != NULL);
+}
+
 static int _call_handler(on_http_request_args_t *args, data_t *params,
 			 data_t *query, const openapi_path_binding_t *op_path,
 			 int callback_tag, const char *write_mime,
@@ -500,8 +609,12 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 {
 	int rc;
 	data_t *resp = data_new();
-	char *body = NULL;
+	char *body = NULL, *etag = NULL;
 	http_status_code_t e;
+	list_t *headers = list_create(NULL);
+	http_header_entry_t etag_header = {
+		.name = "ETag",
+	};
 
 	xassert(op_path);
 	debug3("%s: [%s] BEGIN: calling ctxt handler: 0x%"PRIXPTR"[%d] for path: %s",
@@ -519,7 +632,22 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	 */
 	FREE_NULL_REST_AUTH(args->context->auth);
 
-	if (data_get_type(resp) != DATA_TYPE_NULL) {
+	if (!rc && (args->method == HTTP_REQUEST_GET) &&
+	    (data_get_type(resp) != DATA_TYPE_NULL)) {
+		etag = _get_etag(resp, write_mime);
+		etag_header.value = etag;
+		list_append(headers, &etag_header);
+
+		/* client already has this response: skip serializing it */
+		if (_etag_matches(args, etag)) {
+			debug3("%s: [%s] ETag %s matched If-None-Match",
+			       __func__, _name(args), etag);
+			rc = SLURM_NO_CHANGE_IN_DATA;
+		}
+	}
+
+	if ((rc != SLURM_NO_CHANGE_IN_DATA) &&
+	    (data_get_type(resp) != DATA_TYPE_NULL)) {
 		int rc2;
 		serializer_flags_t sflags = SER_FLAGS_PRETTY;
 
@@ -547,6 +675,8 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 			.http_major = args->http_major,
 			.http_minor = args->http_minor,
 			.status_code = HTTP_STATUS_CODE_REDIRECT_NOT_MODIFIED,
+			.headers = headers,
+			.connection_close = args->connection_close,
 		};
 		e = send_args.status_code;
 		rc = send_http_response(&send_args);
@@ -571,8 +701,10 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 			.http_major = args->http_major,
 			.http_minor = args->http_minor,
 			.status_code = HTTP_STATUS_CODE_SUCCESS_OK,
+			.headers = headers,
 			.body = NULL,
 			.body_length = 0,
+			.connection_close = args->connection_close,
 		};
 
 		if (body) {
@@ -591,6 +723,8 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	       get_http_status_code_string(e));
 
 	xfree(body);
+	xfree(etag);
+	FREE_NULL_LIST(headers);
 	FREE_NULL_DATA(resp);
 
 	return rc;
@@ -87,6 +87,16 @@ typedef struct {
 	void *db_conn;
 } plugin_data_t;
 
+/* Key for slurmdbd connections in the shared pool. Caller must xfree(). */
+static char *_db_conn_key(rest_auth_context_t *context)
+{
+	plugin_data_t *data = context->plugin_data;
+
+	return xstrdup_printf("%s:%s:%s", plugin_type,
+			      (context->user_name ? context->user_name : ""),
+			      data->token);
+}
+
 extern int slurm_rest_auth_p_authenticate(on_http_request_args_t *args,
 					  rest_auth_context_t *ctxt)
 {
@@ -166,8 +176,11 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 	xassert(context->plugin_id == plugin_id);
 	data->magic = ~MAGIC;
 
-	if (data->db_conn)
-		slurmdb_connection_close(&data->db_conn);
+	if (data->db_conn) {
+		char *key = _db_conn_key(context);
+		rest_auth_db_conn_pool_put(key, &data->db_conn);
+		xfree(key);
+	}
 
 	xfree(data->token);
 	xfree(context->plugin_data);
@@ -176,12 +189,20 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 {
 	plugin_data_t *data = context->plugin_data;
+	char *key;
 	xassert(context->plugin_id == plugin_id);
 	xassert(data->magic == MAGIC);
 
 	if (slurm_rest_auth_p_apply(context))
 		return NULL;
 
+	if (data->db_conn)
+		return data->db_conn;
+
+	key = _db_conn_key(context);
+	data->db_conn = rest_auth_db_conn_pool_get(key);
+	xfree(key);
+
 	if (data->db_conn)
 		return data->db_conn;
 
@@ -104,15 +104,29 @@ typedef struct {
 	void *db_conn;
 } plugin_data_t;
 
+/* Key for slurmdbd connections in the shared pool. Caller must xfree(). */
+static char *_db_conn_key(rest_auth_context_t *context)
+{
+	return xstrdup_printf("%s:%s", plugin_type, context->user_name);
+}
+
 extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 {
 	plugin_data_t *data = context->plugin_data;
+	char *key;
 	xassert(data->magic == MAGIC);
 	xassert(context->plugin_id == plugin_id);
 
 	if (slurm_rest_auth_p_apply(context))
 		return NULL;
 
+	if (data->db_conn)
+		return data->db_conn;
+
+	key = _db_conn_key(context);
+	data->db_conn = rest_auth_db_conn_pool_get(key);
+	xfree(key);
+
 	if (data->db_conn)
 		return data->db_conn;
 
@@ -350,8 +364,11 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 	xassert(context->plugin_id == plugin_id);
 	data->magic = ~MAGIC;
 
-	if (data->db_conn)
-		slurmdb_connection_close(&data->db_conn);
+	if (data->db_conn) {
+		char *key = _db_conn_key(context);
+		rest_auth_db_conn_pool_put(key, &data->db_conn);
+		xfree(key);
+	}
 
 	xfree(context->plugin_data);
 }
@@ -101,10 +101,82 @@ static int _signal_jobs(openapi_ctxt_t *ctxt)
 	return rc;
 }
 
+static int _sort_job_by_id(const void *a, const void *b)
+{
+	const slurm_job_info_t *ja = a, *jb = b;
+
+	if (ja->job_id < jb->job_id)
+		return -1;
+	if (ja->job_id > jb->job_id)
+		return 1;
+	return 0;
+}
+
+/*
+ * Point page at the jobs with job_id > cursor, at most limit of them.
+ * Records are sorted in place but remain owned by job_info_ptr.
+ */
+static void _page_jobs(job_info_msg_t *job_info_ptr, job_info_msg_t *page,
+		       openapi_job_info_query_t *query)
+{
+	uint32_t start = 0;
+
+	*page = *job_info_ptr;
+
+	if (!query->cursor && !query->limit)
+		return;
+
+	qsort(job_info_ptr->job_array, job_info_ptr->record_count,
+	      sizeof(*job_info_ptr->job_array), _sort_job_by_id);
+
+	while ((start < job_info_ptr->record_count) &&
+	       (job_info_ptr->job_array[start].job_id <= query->cursor))
+		start++;
+
+	page->job_array = job_info_ptr->job_array + start;
+	page->record_count = job_info_ptr->record_count - start;
+
+	if (query->limit && (page->record_count > query->limit))
+		page->record_count = query->limit;
+}
+
+static data_for_each_cmd_t _select_job_field(const char *key, data_t *data,
+					     void *arg)
+{
+	list_t *fields = arg;
+
+	if (list_find_first_ro(fields, slurm_find_char_exact_in_list,
+			       (void *) key))
+		return DATA_FOR_EACH_CONT;
+
+	return DATA_FOR_EACH_DELETE;
+}
+
+static data_for_each_cmd_t _select_job_fields(data_t *data, void *arg)
+{
+	if (data_get_type(data) == DATA_TYPE_DICT)
+		(void) data_dict_for_each(data, _select_job_field, arg);
+
+	return DATA_FOR_EACH_CONT;
+}
+
+/* Remove every job field not requested in fields from the response */
+static void _select_fields(ctxt_t *ctxt, list_t *fields)
+{
+	data_t *jobs;
+
+	if (!fields || !list_count(fields))
+		return;
+
+	if ((jobs = data_key_get(ctxt->resp, "jobs")) &&
+	    (data_get_type(jobs) == DATA_TYPE_LIST))
+		(void) data_list_for_each(jobs, _select_job_fields, fields);
+}
+
 extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 {
 	openapi_job_info_query_t query = {0};
-	job_info_msg_t *job_info_ptr = NULL;
+	job_info_msg_t *job_info_ptr = NULL, page;
 	openapi_resp_job_info_msg_t resp = {0};
 	int rc;
 
@@ -120,6 +192,7 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 
 	if (DATA_PARSE(ctxt->parser, OPENAPI_JOB_INFO_QUERY, query, ctxt->query,
 		       ctxt->parent_path)) {
+		FREE_NULL_LIST(query.fields);
 		return resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
 				  "Rejecting request. Failure parsing query.");
 	}
@@ -141,13 +214,18 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 		resp_error(ctxt, rc, "slurm_load_jobs()",
 			   "Unable to query jobs");
 	} else if (job_info_ptr) {
+		/* only dump the requested page of jobs */
+		_page_jobs(job_info_ptr, &page, &query);
+
 		resp.last_backfill = job_info_ptr->last_backfill;
 		resp.last_update = job_info_ptr->last_update;
-		resp.jobs = job_info_ptr;
+		resp.jobs = &page;
 	}
 
 	DATA_DUMP(ctxt->parser, OPENAPI_JOB_INFO_RESP, resp, ctxt->resp);
+	_select_fields(ctxt, query.fields);
 
+	FREE_NULL_LIST(query.fields);
 	slurm_free_job_info_msg(job_info_ptr);
 	return rc;
 }
@@ -164,6 +242,7 @@ static void _handle_job_get(ctxt_t *ctxt, slurm_selected_step_t *job_id)
 		       ctxt->parent_path)) {
 		resp_error(ctxt, ESLURM_REST_INVALID_QUERY, __func__,
 			   "Rejecting request. Failure parsing query.");
+		FREE_NULL_LIST(query.fields);
 		return;
 	}
 
@@ -198,7 +277,9 @@ static void _handle_job_get(ctxt_t *ctxt, slurm_selected_step_t *job_id)
 	}
 
 	DATA_DUMP(ctxt->parser, OPENAPI_JOB_INFO_RESP, resp, ctxt->resp);
+	_select_fields(ctxt, query.fields);
 
+	FREE_NULL_LIST(query.fields);
 	slurm_free_job_info_msg(job_info_ptr);
 }
 
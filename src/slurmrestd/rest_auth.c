@@ -38,6 +38,7 @@
 #include <unistd.h>
 
 #include "slurm/slurm.h"
+#include "slurm/slurmdb.h"
 
 #include "src/common/list.h"
 #include "src/common/log.h"
@@ -80,6 +81,22 @@ static int g_context_cnt = -1;
 static plugin_context_t **g_context = NULL;
 
 #define MAGIC 0xDEDEDEDE
+#define DB_CONN_MAGIC 0xDBC0DBC0
+
+/* Max number of idle slurmdbd connections kept open */
+#define DB_CONN_POOL_MAX 32
+/* Seconds an idle slurmdbd connection is kept before being closed */
+#define DB_CONN_POOL_IDLE 60
+
+typedef struct {
+	int magic; /* DB_CONN_MAGIC */
+	char *key; /* identity connection was authenticated as */
+	void *db_conn;
+	time_t idle_since;
+} db_conn_entry_t;
+
+static pthread_mutex_t db_conn_lock = PTHREAD_MUTEX_INITIALIZER;
+static list_t *db_conns = NULL;
 
 static void _check_magic(rest_auth_context_t *ctx)
 {
@@ -92,8 +109,136 @@ static void _check_magic(rest_auth_context_t *ctx)
 	}
 }
 
+static void _free_db_conn_entry(void *x)
+{
+	db_conn_entry_t *entry = x;
+
+	if (!entry)
+		return;
+
+	xassert(entry->magic == DB_CONN_MAGIC);
+	entry->magic = ~DB_CONN_MAGIC;
+
+	if (entry->db_conn)
+		slurmdb_connection_close(&entry->db_conn);
+
+	xfree(entry->key);
+	xfree(entry);
+}
+
+static int _find_db_conn_entry(void *x, void *key)
+{
+	db_conn_entry_t *entry = x;
+
+	xassert(entry->magic == DB_CONN_MAGIC);
+
+	return !xstrcmp(entry->key, key);
+}
+
+static int _find_db_conn_expired(void *x, void *arg)
+{
+	db_conn_entry_t *entry = x;
+	time_t *now = arg;
+
+	xassert(entry->magic == DB_CONN_MAGIC);
+
+	return ((*now - entry->idle_since) >= DB_CONN_POOL_IDLE);
+}
+
+/* Pull expired entries out of the pool. Caller must hold db_conn_lock. */
+static void _pop_expired_db_conns(list_t *expired)
+{
+	time_t now = time(NULL);
+	db_conn_entry_t *entry;
+
+	while ((entry = list_remove_first(db_conns, _find_db_conn_expired,
+					  &now)))
+		list_append(expired, entry);
+}
+
+extern void *rest_auth_db_conn_pool_get(const char *key)
+{
+	db_conn_entry_t *entry = NULL;
+	list_t *expired = list_create(_free_db_conn_entry);
+	void *db_conn = NULL;
+
+	slurm_mutex_lock(&db_conn_lock);
+	if (db_conns) {
+		_pop_expired_db_conns(expired);
+		entry = list_remove_first(db_conns, _find_db_conn_entry,
+					  (void *) key);
+	}
+	slurm_mutex_unlock(&db_conn_lock);
+
+	/* close connections outside of the lock */
+	FREE_NULL_LIST(expired);
+
+	if (entry) {
+		db_conn = entry->db_conn;
+		entry->db_conn = NULL;
+		_free_db_conn_entry(entry);
+
+		debug4("%s: reusing slurmdbd connection 0x%"PRIxPTR,
+		       __func__, (uintptr_t) db_conn);
+	}
+
+	return db_conn;
+}
+
+extern void rest_auth_db_conn_pool_put(const char *key, void **db_conn_ptr)
+{
+	db_conn_entry_t *entry;
+	list_t *expired;
+
+	if (!*db_conn_ptr)
+		return;
+
+	/*
+	 * Discard anything the request left uncommitted so the next request
+	 * starts from a clean state. Connections that fail here are closed.
+	 */
+	if (!key || slurmdb_connection_commit(*db_conn_ptr, false)) {
+		slurmdb_connection_close(db_conn_ptr);
+		return;
+	}
+
+	entry = xmalloc(sizeof(*entry));
+	entry->magic = DB_CONN_MAGIC;
+	entry->key = xstrdup(key);
+	entry->db_conn = *db_conn_ptr;
+	entry->idle_since = time(NULL);
+	*db_conn_ptr = NULL;
+
+	expired = list_create(_free_db_conn_entry);
+
+	slurm_mutex_lock(&db_conn_lock);
+	if (db_conns) {
+		_pop_expired_db_conns(expired);
+
+		/* drop the least recently used connection when full */
+		if (list_count(db_conns) >= DB_CONN_POOL_MAX)
+			list_append(expired, list_pop(db_conns));
+
+		list_append(db_conns, entry);
+		entry = NULL;
+	}
+	slurm_mutex_unlock(&db_conn_lock);
+
+	/* pool already destroyed */
+	_free_db_conn_entry(entry);
+	FREE_NULL_LIST(expired);
+}
+
 extern void destroy_rest_auth(void)
 {
+	list_t *pool;
+
+	slurm_mutex_lock(&db_conn_lock);
+	pool = db_conns;
+	db_conns = NULL;
+	slurm_mutex_unlock(&db_conn_lock);
+	FREE_NULL_LIST(pool);
+
 	slurm_mutex_lock(&init_lock);
 
 	for (int i = 0; (g_context_cnt > 0) && (i < g_context_cnt); i++) {
@@ -117,6 +262,11 @@ extern int init_rest_auth(bool become_user,
 {
 	int rc = SLURM_SUCCESS;
 
+	slurm_mutex_lock(&db_conn_lock);
+	xassert(!db_conns);
+	db_conns = list_create(_free_db_conn_entry);
+	slurm_mutex_unlock(&db_conn_lock);
+
 	slurm_mutex_lock(&init_lock);
 
 	/* Load OpenAPI plugins */
@@ -255,8 +405,6 @@ extern void rest_auth_g_free(rest_auth_context_t *context)
 		return;
 	_check_magic(context);
 
-	auth_g_thread_clear();
-
 	if (context->plugin_id) {
 		for (int i = 0;
 		     (g_context_cnt > 0) && (i < g_context_cnt);
@@ -275,6 +423,12 @@ extern void rest_auth_g_free(rest_auth_context_t *context)
 				    __func__, context->plugin_id);
 	}
 
+	/*
+	 * Cleared after the plugin has released its slurmdbd connection as any
+	 * reconnect while doing so must still happen as the request's user.
+	 */
+	auth_g_thread_clear();
+
 	xfree(context->user_name);
 	context->plugin_id = 0;
 	context->magic = ~MAGIC;
@@ -90,6 +90,22 @@ extern int rest_auth_g_apply(rest_auth_context_t *context);
  */
 extern void *rest_auth_g_get_db_conn(rest_auth_context_t *context);
 
+/*
+ * Take an idle slurmdbd connection out of the shared pool.
+ * IN key - identity the connection must have been authenticated as
+ * RET db_conn or NULL if none is idle for key
+ */
+extern void *rest_auth_db_conn_pool_get(const char *key);
+
+/*
+ * Return slurmdbd connection to the shared pool for reuse by later requests
+ * with the same key. Any uncommitted changes are rolled back first. The
+ * connection is closed instead if that fails or the pool is full.
+ * IN key - identity the connection was authenticated as
+ * IN/OUT db_conn_ptr - ptr to db_conn (will be set to NULL)
+ */
+extern void rest_auth_db_conn_pool_put(const char *key, void **db_conn_ptr);
+
 #define FREE_NULL_REST_AUTH(_X)			\
 	do {					\
 		if (_X)				\
@@ -39,11 +39,14 @@
 \*****************************************************************************/
 
 #include <grp.h>
+#include <pthread.h>
 #include <pwd.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include "src/common/cpu_frequency.h"
 #include "src/common/hostlist.h"
@@ -75,6 +78,27 @@ static int _print_step_from_format(void *x, void *arg);
 
 static partition_info_msg_t *part_info_msg = NULL;
 
+/*
+ * Large job lists are rendered by worker threads, each formatting a chunk of
+ * consecutive rows into its own buffer. The chunks are written out in order so
+ * the output is identical to printing serially.
+ */
+#define PRINT_CHUNK_ROWS	1024
+#define PRINT_MAX_THREADS	8
+#define PRINT_PARALLEL_MIN	4096
+#define PRINT_ROW_SIZE_HINT	128
+
+typedef struct {
+	squeue_job_rec_t **recs;
+	int cnt;
+	list_t *format;
+	char *buf;
+	char *pos;
+} print_chunk_t;
+
+/* Set while a worker thread renders a chunk, where _out() appends to */
+static __thread print_chunk_t *thread_chunk = NULL;
+
 /*****************************************************************************
  * Global Print Functions
  *****************************************************************************/
@@ -138,6 +162,73 @@ static void _create_priority_list(list_t *l,
 	list_for_each(part_names, _foreach_create_prio_job_req, &arg);
 }
 
+static void *_print_chunk(void *arg)
+{
+	print_chunk_t *chunk = arg;
+
+	thread_chunk = chunk;
+	for (int i = 0; i < chunk->cnt; i++)
+		_print_job_from_format(chunk->recs[i], chunk->format);
+	thread_chunk = NULL;
+
+	return NULL;
+}
+
+static void _print_jobs(list_t *l, list_t *format)
+{
+	int cnt = list_count(l), nthreads, i = 0, start = 0;
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	squeue_job_rec_t **recs;
+	print_chunk_t *chunks;
+	pthread_t *tids;
+	list_itr_t *itr;
+
+	nthreads = MIN(ncpus, PRINT_MAX_THREADS);
+	if ((nthreads < 2) || (cnt < PRINT_PARALLEL_MIN)) {
+		list_for_each(l, _print_job_from_format, format);
+		return;
+	}
+
+	recs = xcalloc(cnt, sizeof(*recs));
+	itr = list_iterator_create(l);
+	while ((recs[i] = list_next(itr)))
+		i++;
+	list_iterator_destroy(itr);
+
+	chunks = xcalloc(nthreads, sizeof(*chunks));
+	tids = xcalloc(nthreads, sizeof(*tids));
+	for (i = 0; i < nthreads; i++) {
+		chunks[i].format = format;
+		chunks[i].buf = xmalloc(PRINT_CHUNK_ROWS * PRINT_ROW_SIZE_HINT);
+		chunks[i].pos = chunks[i].buf;
+	}
+
+	while (start < cnt) {
+		int t;
+
+		for (t = 0; (t < nthreads) && (start < cnt); t++) {
+			chunks[t].recs = recs + start;
+			chunks[t].cnt = MIN(PRINT_CHUNK_ROWS, cnt - start);
+			start += chunks[t].cnt;
+			slurm_thread_create(&tids[t], _print_chunk, &chunks[t]);
+		}
+
+		/* Buffers are reused, only the bytes before pos are valid */
+		for (i = 0; i < t; i++) {
+			slurm_thread_join(tids[i]);
+			fwrite(chunks[i].buf, 1, chunks[i].pos - chunks[i].buf,
+			       stdout);
+			chunks[i].pos = chunks[i].buf;
+		}
+	}
+
+	for (i = 0; i < nthreads; i++)
+		xfree(chunks[i].buf);
+	xfree(chunks);
+	xfree(tids);
+	xfree(recs);
+}
+
 extern void print_jobs_array(job_info_t *jobs, int size, list_t *format)
 {
 	squeue_job_rec_t *job_rec_ptr;
@@ -180,7 +271,7 @@ extern void print_jobs_array(job_info_t *jobs, int size, list_t *format)
 	sort_job_list (l);
 
 	/* Print the jobs of interest */
-	list_for_each(l, _print_job_from_format, format);
+	_print_jobs(l, format);
 	FREE_NULL_LIST(l);
 }
 
@@ -234,26 +325,31 @@ extern void squeue_filter_jobs_for_json(job_info_msg_t *job_info)
 
 /* Combine a job array's task "reason" into the master job array record
  * reason as needed */
-static void _merge_job_reason(job_info_t *job_ptr, job_info_t *task_ptr)
+static void _merge_job_reason(squeue_job_rec_t *job_rec_ptr,
+			      job_info_t *task_ptr)
 {
+	job_info_t *job_ptr = job_rec_ptr->job_ptr;
 	const char *task_desc;
 
 	if (job_ptr->state_reason == task_ptr->state_reason)
 		return;
 
-	if (!job_ptr->state_desc) {
-		job_ptr->state_desc =
+	if (!job_rec_ptr->state_desc) {
+		job_rec_ptr->state_desc = job_ptr->state_desc ?
+			xstrdup(job_ptr->state_desc) :
 			xstrdup(job_state_reason_string(job_ptr->state_reason));
 	}
 	task_desc = job_state_reason_string(task_ptr->state_reason);
-	if (strstr(job_ptr->state_desc, task_desc))
+	if (strstr(job_rec_ptr->state_desc, task_desc))
 		return;
-	xstrfmtcat(job_ptr->state_desc, ",%s", task_desc);
+	xstrfmtcat(job_rec_ptr->state_desc, ",%s", task_desc);
 }
 
 /* Combine pending tasks of a job array into a single record.
  * The tasks may have been split into separate job records because they were
- * modified or started, but the records can be re-combined if pending. */
+ * modified or started, but the records can be re-combined if pending.
+ * The job_info_t records are left unchanged as they may be reused by
+ * slurm_load_jobs_delta(). */
 static void _combine_pending_array_tasks(List job_list)
 {
 	squeue_job_rec_t *job_rec_ptr, *task_rec_ptr;
@@ -271,8 +367,8 @@ static void _combine_pending_array_tasks(List job_list)
 		    !job_rec_ptr->job_ptr->array_bitmap)
 			continue;
 		update_cnt = 0;
-		task_bitmap = job_rec_ptr->job_ptr->array_bitmap;
-		bitmap_size = bit_size(task_bitmap);
+		task_bitmap = NULL;
+		bitmap_size = bit_size(job_rec_ptr->job_ptr->array_bitmap);
 		task_iterator = list_iterator_create(job_list);
 		while ((task_rec_ptr = list_next(task_iterator))) {
 			if (!IS_JOB_PENDING(task_rec_ptr->job_ptr))
@@ -291,8 +387,12 @@ static void _combine_pending_array_tasks(List job_list)
 				continue;	/* Different partition */
 			/* Combine this task into master job array record */
 			update_cnt++;
-			_merge_job_reason(job_rec_ptr->job_ptr,
-					  task_rec_ptr->job_ptr);
+			_merge_job_reason(job_rec_ptr, task_rec_ptr->job_ptr);
+			if (!task_bitmap) {
+				task_bitmap = bit_copy(
+					job_rec_ptr->job_ptr->array_bitmap);
+				job_rec_ptr->array_bitmap = task_bitmap;
+			}
 			bit_set(task_bitmap,
 				task_rec_ptr->job_ptr->array_task_id);
 			list_delete_item(task_iterator);
@@ -305,18 +405,17 @@ static void _combine_pending_array_tasks(List job_list)
 				bitstr_len = atoi(bitstr_len_str);
 			if (bitstr_len < 0)
 				bitstr_len = 64;
-			xfree(job_rec_ptr->job_ptr->array_task_str);
-			job_rec_ptr->job_ptr->array_task_str =
-				xmalloc(bitstr_len);
-			if (bitstr_len > 0)
-				bit_fmt(job_rec_ptr->job_ptr->array_task_str,
+			if (bitstr_len > 0) {
+				job_rec_ptr->array_task_str =
+					xmalloc(bitstr_len);
+				bit_fmt(job_rec_ptr->array_task_str,
 					bitstr_len, task_bitmap);
-			else {
+			} else {
 				/* Print the full bitmap's string
 				 * representation.  For huge bitmaps this can
 				 * take roughly one minute, so let the client do
 				 * the work */
-				job_rec_ptr->job_ptr->array_task_str =
+				job_rec_ptr->array_task_str =
 					bit_fmt_full(task_bitmap);
 			}
 		}
@@ -327,7 +426,10 @@ static void _combine_pending_array_tasks(List job_list)
 static void _job_list_del(void *x)
 {
 	squeue_job_rec_t *job_rec_ptr = (squeue_job_rec_t *) x;
+	FREE_NULL_BITMAP(job_rec_ptr->array_bitmap);
+	xfree(job_rec_ptr->array_task_str);
 	xfree(job_rec_ptr->part_name);
+	xfree(job_rec_ptr->state_desc);
 	xfree(job_rec_ptr);
 }
 
@@ -364,6 +466,39 @@ static void _part_state_load(void)
 		slurm_perror ("slurm_load_partitions");
 }
 
+/*
+ * printf() to stdout, or to the current thread's chunk buffer.
+ * RET number of characters written
+ */
+__attribute__((format(printf, 1, 2)))
+static int _out(const char *fmt, ...)
+{
+	char tmp[256], *p = tmp;
+	va_list ap;
+	int n;
+
+	va_start(ap, fmt);
+	if (!thread_chunk) {
+		n = vprintf(fmt, ap);
+		va_end(ap);
+		return n;
+	}
+	n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+	va_end(ap);
+
+	if (n >= (int) sizeof(tmp)) {
+		va_start(ap, fmt);
+		_xstrdup_vprintf(&p, fmt, ap);
+		va_end(ap);
+	}
+	if (n > 0)
+		xstrcatat(thread_chunk->buf, &thread_chunk->pos, p);
+	if (p != tmp)
+		xfree(p);
+
+	return n;
+}
+
 static int _print_str(char *str, int width, bool right, bool cut_output)
 {
 	char format[64];
@@ -385,17 +520,17 @@ static int _print_str(char *str, int width, bool right, bool cut_output)
 	}
 
 	if ((width <= 0) || (cut_output == false) ) {
-		if ((printed = printf(format, str)) < 0)
+		if ((printed = _out(format, str)) < 0)
 			return printed;
 	} else {
 		char temp[width + 1];
 		snprintf(temp, width + 1, format, str);
-		if ((printed = printf("%s",temp)) < 0)
+		if ((printed = _out("%s",temp)) < 0)
 			return printed;
 	}
 
 	while (printed++ < width)
-		printf(" ");
+		_out(" ");
 
 	return printed;
 }
@@ -478,7 +613,7 @@ static int _print_one_job_from_format(job_info_t * job, List list)
 	}
 	list_iterator_destroy(iter);
 
-	printf("\n");
+	_out("\n");
 	return SLURM_SUCCESS;
 }
 
@@ -488,29 +623,44 @@ static int _print_job_from_format(void *x, void *arg)
 	bitstr_t *bitmap;
 	squeue_job_rec_t *job_rec_ptr = (squeue_job_rec_t *) x;
 	List list = (List) arg;
+	job_info_t *job_ptr, job_copy;
 
 	if (!job_rec_ptr) {
 		_print_one_job_from_format(NULL, list);
 		return SLURM_SUCCESS;
 	}
 
-	if (job_rec_ptr->part_name) {
-		xfree(job_rec_ptr->job_ptr->partition);
-		job_rec_ptr->job_ptr->partition = xstrdup(job_rec_ptr->
-							  part_name);
-	}
+	/*
+	 * Apply this record's view of the job to a copy, the job_info_t may
+	 * be reused by slurm_load_jobs_delta() and several records of a
+	 * priority listing may be printed by different threads at once.
+	 */
+	job_copy = *job_rec_ptr->job_ptr;
+	job_ptr = &job_copy;
+
+	if (job_rec_ptr->part_name)
+		job_ptr->partition = job_rec_ptr->part_name;
 
 	if (job_rec_ptr->job_prio)
-		job_rec_ptr->job_ptr->priority = job_rec_ptr->job_prio;
+		job_ptr->priority = job_rec_ptr->job_prio;
 
-	if (job_rec_ptr->job_ptr->array_task_str && params.array_flag) {
-		char *p;
+	if (job_rec_ptr->array_task_str) {
+		job_ptr->array_bitmap = job_rec_ptr->array_bitmap;
+		job_ptr->array_task_str = job_rec_ptr->array_task_str;
+	}
 
-		if ((p = strchr(job_rec_ptr->job_ptr->array_task_str, '%')))
+	if (job_rec_ptr->state_desc)
+		job_ptr->state_desc = job_rec_ptr->state_desc;
+
+	if (job_ptr->array_task_str && params.array_flag) {
+		char *task_str = xstrdup(job_ptr->array_task_str), *p;
+
+		if ((p = strchr(task_str, '%')))
 			*p = 0;
 		bitmap = bit_alloc(slurm_conf.max_array_sz);
-		bit_unfmt(bitmap, job_rec_ptr->job_ptr->array_task_str);
-		xfree(job_rec_ptr->job_ptr->array_task_str);
+		bit_unfmt(bitmap, task_str);
+		xfree(task_str);
+		job_ptr->array_task_str = NULL;
 		i_first = bit_ffs(bitmap);
 		if (i_first == -1)
 			i_last = -2;
@@ -519,12 +669,12 @@ static int _print_job_from_format(void *x, void *arg)
 		for (i = i_first; i <= i_last; i++) {
 			if (!bit_test(bitmap, i))
 				continue;
-			job_rec_ptr->job_ptr->array_task_id = i;
-			_print_one_job_from_format(job_rec_ptr->job_ptr, list);
+			job_ptr->array_task_id = i;
+			_print_one_job_from_format(job_ptr, list);
 		}
 		FREE_NULL_BITMAP(bitmap);
 	} else {
-		_print_one_job_from_format(job_rec_ptr->job_ptr, list);
+		_print_one_job_from_format(job_ptr, list);
 	}
 
 	return SLURM_SUCCESS;
@@ -560,7 +710,7 @@ int _print_job_array_job_id(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -579,7 +729,7 @@ int _print_job_array_task_id(job_info_t * job, int width, bool right,
 		_print_str("N/A", width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -592,7 +742,7 @@ int _print_job_batch_host(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(eh ? eh : "n/a", width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -604,7 +754,7 @@ int _print_job_burst_buffer(job_info_t * job, int width, bool right, char* suffi
 		_print_str(job->burst_buffer, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -617,7 +767,7 @@ int _print_job_burst_buffer_state(job_info_t * job, int width, bool right,
 		_print_str(job->burst_buffer_state, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -630,7 +780,7 @@ int _print_job_cluster_name(job_info_t * job, int width, bool right,
 		_print_str(job->cluster, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -642,7 +792,7 @@ int _print_job_container(job_info_t *job, int width, bool right, char *suffix)
 		_print_str(job->container, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -655,7 +805,7 @@ int _print_job_container_id(job_info_t *job, int width, bool right,
 		_print_str(job->container_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -675,7 +825,7 @@ int _print_job_core_spec(job_info_t * job, int width, bool right, char* suffix)
 		_print_int(job->core_spec, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -686,7 +836,7 @@ int _print_job_delay_boot(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_secs((long)job->delay_boot, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -724,7 +874,7 @@ int _print_job_job_id(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -738,7 +888,7 @@ int _print_job_job_id2(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -750,14 +900,14 @@ int _print_job_partition(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->partition, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
 int _print_job_prefix(job_info_t * job, int width, bool right, char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -774,7 +924,7 @@ int _print_job_reason(job_info_t * job, int width, bool right, char* suffix)
 		_print_str((char *)reason, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -786,7 +936,7 @@ int _print_job_name(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->name, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -798,7 +948,7 @@ int _print_job_licenses(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->licenses, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -810,7 +960,7 @@ int _print_job_wckey(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->wckey, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -821,7 +971,7 @@ int _print_job_user_id(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_int(job->user_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -834,7 +984,7 @@ int _print_job_user_name(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(uname, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -845,7 +995,7 @@ int _print_job_group_id(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_int(job->group_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -859,7 +1009,7 @@ int _print_job_group_name(job_info_t * job, int width, bool right, char* suffix)
 		xfree(group);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -871,7 +1021,7 @@ int _print_job_job_state(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job_state_string(job->job_state), width, right,
 			   true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -883,7 +1033,7 @@ int _print_job_last_sched_eval(job_info_t *job, int width, bool right,
 	else
 		_print_time(job->last_sched_eval, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -896,7 +1046,7 @@ int _print_job_job_state_compact(job_info_t * job, int width, bool right,
 		_print_str(job_state_string_compact(job->job_state), width,
 			   right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -914,7 +1064,7 @@ int _print_job_time_left(job_info_t * job, int width, bool right,
 		_print_secs(time_left, width, right, false);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -930,7 +1080,7 @@ int _print_job_time_limit(job_info_t * job, int width, bool right,
 	else
 		_print_secs((job->time_limit*60), width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_het_job_offset(job_info_t * job, int width, bool right,
@@ -947,7 +1097,7 @@ int _print_job_het_job_offset(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -965,7 +1115,7 @@ int _print_job_het_job_id(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -980,7 +1130,7 @@ int _print_job_het_job_id_set(job_info_t * job, int width, bool right,
 		_print_str(job->het_job_id_set, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_time_used(job_info_t * job, int width, bool right,
@@ -991,7 +1141,7 @@ int _print_job_time_used(job_info_t * job, int width, bool right,
 	else
 		_print_secs(job_time_used(job), width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1024,7 +1174,7 @@ int _print_job_time_submit(job_info_t * job, int width, bool right,
 	else
 		_print_time(job->submit_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1046,7 +1196,7 @@ int _print_job_time_pending(job_info_t *job, int width, bool right,
 	else
 		_print_int((now - job->submit_time), width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1058,7 +1208,7 @@ int _print_job_time_start(job_info_t * job, int width, bool right,
 	else
 		_print_time(job->start_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_deadline(job_info_t * job, int width, bool right, char* suffix)
@@ -1068,7 +1218,7 @@ int _print_job_deadline(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_time(job->deadline, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_time_end(job_info_t * job, int width, bool right, char* suffix)
@@ -1081,7 +1231,7 @@ int _print_job_time_end(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_time(job->end_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1097,7 +1247,7 @@ int _print_job_priority(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(temp, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1111,7 +1261,7 @@ int _print_job_priority_long(job_info_t * job, int width, bool right, char* suff
 		_print_str(temp, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1123,7 +1273,7 @@ int _print_job_nodes(job_info_t * job, int width, bool right, char* suffix)
 		_print_nodes(job->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 
 	return SLURM_SUCCESS;
 }
@@ -1136,7 +1286,7 @@ int _print_job_schednodes(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->sched_nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1165,7 +1315,7 @@ int _print_job_reason_list(job_info_t * job, int width, bool right,
 		_print_nodes(job->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1178,15 +1328,15 @@ int _print_job_node_inx(job_info_t * job, int width, bool right, char* suffix)
 		int curr_width = 0;
 		while (*current != -1 && curr_width < width) {
 			if (curr_width)
-				printf(",");
+				_out(",");
 			curr_width += _print_int(*current, width, right, true);
 			current++;
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1200,7 +1350,7 @@ int _print_job_num_cpus(job_info_t * job, int width, bool right, char* suffix)
        		_print_str(tmp_char, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1216,7 +1366,7 @@ int _print_job_num_nodes(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1254,7 +1404,7 @@ int _print_job_num_sct(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1268,7 +1418,7 @@ int _print_job_num_tasks(job_info_t * job, int width, bool right, char* suffix)
        		_print_str(tmp_char, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1282,7 +1432,7 @@ int _print_job_over_subscribe(job_info_t * job, int width, bool right_justify,
 			   width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1296,7 +1446,7 @@ int _print_job_contiguous(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1314,7 +1464,7 @@ int _print_pn_min_cpus(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1335,7 +1485,7 @@ int _print_sockets(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1356,7 +1506,7 @@ int _print_cores(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1377,7 +1527,7 @@ int _print_threads(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1397,7 +1547,7 @@ int _print_pn_min_memory(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1417,7 +1567,7 @@ _print_pn_min_tmp_disk(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1429,7 +1579,7 @@ int _print_job_req_nodes(job_info_t * job, int width, bool right_justify,
 	else
 		_print_nodes(job->req_nodes, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1441,7 +1591,7 @@ int _print_job_exc_nodes(job_info_t * job, int width, bool right_justify,
 	else
 		_print_nodes(job->exc_nodes, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1458,13 +1608,13 @@ _print_job_req_node_inx(job_info_t * job, int width, bool right_justify,
 			curr_width +=
 			    _print_int(*current, width, right_justify,
 				       true);
-			printf(",");
+			_out(",");
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1481,13 +1631,13 @@ _print_job_exc_node_inx(job_info_t * job, int width, bool right_justify,
 			curr_width +=
 			    _print_int(*current, width, right_justify,
 				       true);
-			printf(",");
+			_out(",");
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1499,7 +1649,7 @@ int _print_job_features(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->features, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1511,7 +1661,7 @@ int _print_job_cluster_features(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->cluster_features, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1523,7 +1673,7 @@ int _print_job_prefer(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->prefer, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1535,7 +1685,7 @@ int _print_job_account(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->account, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1547,7 +1697,7 @@ int _print_job_admin_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->admin_comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1559,7 +1709,7 @@ int _print_job_system_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->system_comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1571,7 +1721,7 @@ int _print_job_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1583,7 +1733,7 @@ int _print_job_dependency(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->dependency, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1595,7 +1745,7 @@ int _print_job_qos(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->qos, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1607,7 +1757,7 @@ int _print_job_reservation(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->resv_name, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1619,7 +1769,7 @@ int _print_job_command(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->command, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1631,7 +1781,7 @@ int _print_job_work_dir(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->work_dir, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1646,7 +1796,7 @@ int _print_job_nice(job_info_t * job, int width, bool right_justify,
 		_print_int(nice, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1660,7 +1810,7 @@ int _print_job_accrue_time(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1673,7 +1823,7 @@ int _print_job_alloc_nodes(job_info_t * job, int width, bool right_justify,
 		_print_str(job->alloc_node, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1686,7 +1836,7 @@ int _print_job_alloc_sid(job_info_t * job, int width, bool right_justify,
 		_print_int(job->alloc_sid, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1699,7 +1849,7 @@ int _print_job_assoc_id(job_info_t * job, int width, bool right_justify,
 		_print_int(job->assoc_id, width, right_justify,true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -1713,7 +1863,7 @@ int _print_job_batch_flag(job_info_t * job, int width, bool right_justify,
 		_print_int(job->batch_flag, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1728,7 +1878,7 @@ int _print_job_boards_per_node(job_info_t * job, int width, bool right_justify,
 		_print_int(job->boards_per_node, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1743,7 +1893,7 @@ int _print_job_cpus_per_task(job_info_t * job, int width, bool right_justify,
 		_print_int(job->cpus_per_task, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1767,7 +1917,7 @@ int _print_job_derived_ec(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -1782,7 +1932,7 @@ int _print_job_eligible_time(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1806,7 +1956,7 @@ int _print_job_exit_code(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1824,7 +1974,7 @@ int _print_job_fed_origin(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1842,7 +1992,7 @@ int _print_job_fed_origin_raw(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1860,7 +2010,7 @@ int _print_job_fed_siblings_active(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1871,11 +2021,12 @@ int _print_job_fed_siblings_active_raw(job_info_t * job, int width,
 		_print_str("ACTIVE_SIBLINGS_RAW", width, right_justify, true);
 	else {
 		int bit = 1;
-		char *ids = NULL;
+		char *ids = NULL, *pos = NULL;
 		uint64_t tmp_sibs = job->fed_siblings_active;
 		while (tmp_sibs) {
 			if (tmp_sibs & 1)
-				xstrfmtcat(ids, "%s%d", (ids) ? "," : "", bit);
+				xstrfmtcatat(ids, &pos, "%s%d",
+					     (ids) ? "," : "", bit);
 
 			tmp_sibs >>= 1;
 			bit++;
@@ -1887,7 +2038,7 @@ int _print_job_fed_siblings_active_raw(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1905,7 +2056,7 @@ int _print_job_fed_siblings_viable(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1916,11 +2067,12 @@ int _print_job_fed_siblings_viable_raw(job_info_t * job, int width,
 		_print_str("VIALBLE_SIBLINGS_RAW", width, right_justify, true);
 	else {
 		int bit = 1;
-		char *ids = NULL;
+		char *ids = NULL, *pos = NULL;
 		uint64_t tmp_sibs = job->fed_siblings_viable;
 		while (tmp_sibs) {
 			if (tmp_sibs & 1)
-				xstrfmtcat(ids, "%s%d", (ids) ? "," : "", bit);
+				xstrfmtcatat(ids, &pos, "%s%d",
+					     (ids) ? "," : "", bit);
 
 			tmp_sibs >>= 1;
 			bit++;
@@ -1932,7 +2084,7 @@ int _print_job_fed_siblings_viable_raw(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1947,7 +2099,7 @@ int _print_job_max_cpus(job_info_t * job, int width, bool right_justify,
 		_print_int(job->num_cpus, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1962,7 +2114,7 @@ int _print_job_max_nodes(job_info_t * job, int width, bool right_justify,
 		_print_int(job->num_nodes, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1975,7 +2127,7 @@ int _print_job_network(job_info_t * job, int width, bool right_justify,
 		_print_str(job->network, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1991,7 +2143,7 @@ int _print_job_ntasks_per_core(job_info_t * job, int width, bool right_justify,
 		_print_int(job->ntasks_per_core, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2007,7 +2159,7 @@ int _print_job_ntasks_per_node(job_info_t * job, int width, bool right_justify,
 		_print_int(job->ntasks_per_node, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2023,7 +2175,7 @@ int _print_job_ntasks_per_socket(job_info_t * job, int width,
 		_print_int(job->ntasks_per_socket, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2039,7 +2191,7 @@ int _print_job_ntasks_per_board(job_info_t * job, int width,
 		_print_int(job->ntasks_per_board, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2056,7 +2208,7 @@ int _print_job_preempt_time(job_info_t * job, int width,
 		_print_time(job->preempt_time, 0, width, right_justify);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2064,13 +2216,16 @@ int _print_job_preempt_time(job_info_t * job, int width,
 int _print_job_profile(job_info_t * job, int width,
 		       bool right_justify, char* suffix)
 {
-	if (job == NULL)
+	if (job == NULL) {
 		_print_str("PROFILE", width, right_justify, true);
-	else
-		_print_str(acct_gather_profile_to_string(job->profile),
-			   width, right_justify, true);
+	} else {
+		char profile_str[128] = "";
+
+		acct_gather_profile_to_string_r(job->profile, profile_str);
+		_print_str(profile_str, width, right_justify, true);
+	}
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2083,7 +2238,7 @@ int _print_job_reboot(job_info_t * job, int width,
 		_print_int(job->reboot, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2096,7 +2251,7 @@ int _print_job_req_switch(job_info_t * job, int width,
 		_print_int(job->req_switch, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2109,7 +2264,7 @@ int _print_job_requeue(job_info_t * job, int width,
 		_print_int(job->requeue, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out("%s",suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2125,7 +2280,7 @@ int _print_job_resize_time(job_info_t * job, int width,
 		_print_str("N/A", width, right_justify, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2139,7 +2294,7 @@ int _print_job_restart_cnt(job_info_t * job, int width,
 		_print_int(job->restart_cnt, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2152,7 +2307,7 @@ int _print_job_sockets_per_board(job_info_t * job, int width,
 		_print_int(job->sockets_per_board, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2185,7 +2340,7 @@ int _print_job_std_err(job_info_t * job, int width,
 		_print_str(job->std_err, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2202,7 +2357,7 @@ int _print_job_std_in(job_info_t * job, int width,
 		_print_str(job->std_in, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2232,7 +2387,7 @@ int _print_job_std_out(job_info_t * job, int width,
 		_print_str(job->std_out, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2245,7 +2400,7 @@ int _print_job_min_time(job_info_t * job, int width,
 		_print_secs((job->time_min*60), width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2259,7 +2414,7 @@ int _print_job_wait4switch(job_info_t * job, int width,
 			    width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2278,7 +2433,7 @@ int _print_job_cpus_per_tres(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2297,7 +2452,7 @@ int _print_job_mem_per_tres(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2319,7 +2474,7 @@ int _print_job_tres_alloc(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2338,7 +2493,7 @@ int _print_job_tres_bind(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2357,7 +2512,7 @@ int _print_job_tres_freq(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2376,7 +2531,7 @@ int _print_job_tres_per_job(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2395,7 +2550,7 @@ int _print_job_tres_per_node(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2414,7 +2569,7 @@ int _print_job_tres_per_socket(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2433,7 +2588,7 @@ int _print_job_tres_per_task(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2446,7 +2601,7 @@ int _print_job_mcs_label(job_info_t * job, int width,
 		_print_str(job->mcs_label, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2468,7 +2623,7 @@ static int _print_step_from_format(void *x, void *arg)
 			return SLURM_ERROR;
 	}
 	list_iterator_destroy(i);
-	printf("\n");
+	_out("\n");
 
 	return SLURM_SUCCESS;
 }
@@ -2498,7 +2653,7 @@ int _print_step_cluster_name(job_step_info_t *step, int width, bool right,
 		_print_str(step->cluster, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2511,7 +2666,7 @@ int _print_step_container(job_step_info_t *step, int width, bool right,
 		_print_str(step->container, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2524,7 +2679,7 @@ int _print_step_container_id(job_step_info_t *step, int width, bool right,
 		_print_str(step->container_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2551,7 +2706,7 @@ int _print_step_id(job_step_info_t * step, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2564,7 +2719,7 @@ int _print_step_partition(job_step_info_t * step, int width, bool right,
 		_print_str(step->partition, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2572,7 +2727,7 @@ int _print_step_prefix(job_step_info_t * step, int width, bool right,
 		       char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2584,7 +2739,7 @@ int _print_step_user_id(job_step_info_t * step, int width, bool right,
 	else
 		_print_int(step->user_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2598,7 +2753,7 @@ int _print_step_user_name(job_step_info_t * step, int width, bool right,
 		_print_str(uname, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2612,7 +2767,7 @@ int _print_step_time_limit(job_step_info_t * step, int width, bool right,
 	else
 		_print_secs(step->time_limit * 60, width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2624,7 +2779,7 @@ int _print_step_time_start(job_step_info_t * step, int width, bool right,
 	else
 		_print_time(step->start_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2638,7 +2793,7 @@ int _print_step_time_used(job_step_info_t * step, int width, bool right,
 		_print_secs(delta_t, width, right, false);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2650,7 +2805,7 @@ int _print_step_name(job_step_info_t * step, int width, bool right,
 	else
 		_print_str(step->name, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2663,7 +2818,7 @@ int _print_step_nodes(job_step_info_t * step, int width, bool right,
 		_print_nodes(step->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2675,7 +2830,7 @@ int _print_step_num_tasks(job_step_info_t * step, int width, bool right,
 	else
 		_print_int(step->num_tasks, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2690,7 +2845,7 @@ int _print_step_array_job_id(job_step_info_t * step, int width, bool right,
 		_print_int(step->step_id.job_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2704,7 +2859,7 @@ int _print_step_array_task_id(job_step_info_t * step, int width, bool right,
 	else
 		_print_str("N/A", width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2718,7 +2873,7 @@ int _print_step_job_id(job_step_info_t * step, int width, bool right,
 		_print_int(step->step_id.job_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2731,7 +2886,7 @@ int _print_step_network(job_step_info_t * step, int width, bool right,
 		_print_str(step->network, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2745,16 +2900,16 @@ int _print_step_node_inx(job_step_info_t * step, int width, bool right,
 		int curr_width = 0;
 		while (*current != -1 && curr_width < width) {
 			if (curr_width)
-				printf(",");
+				_out(",");
 			curr_width += _print_int(*current, width, right, true);
 			current++;
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out(" ");
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2767,7 +2922,7 @@ int _print_step_num_cpus(job_step_info_t * step, int width, bool right,
 		_print_int(step->num_cpus, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2779,7 +2934,7 @@ int _print_step_cpu_freq(job_step_info_t * step, int width, bool right,
 	if (step == NULL) {
 		_print_str("CPU_FREQ", width, right, true);
 		if (suffix)
-			printf("%s", suffix);
+			_out("%s", suffix);
 		return SLURM_SUCCESS;
 	}
 	cpu_freq_to_string(bfm, sizeof(bfm), step->cpu_freq_min);
@@ -2789,7 +2944,7 @@ int _print_step_cpu_freq(job_step_info_t * step, int width, bool right,
 	_print_str(bfall, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2802,7 +2957,7 @@ int _print_step_resv_ports(job_step_info_t * step, int width, bool right,
 		_print_str(step->resv_ports, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2815,7 +2970,7 @@ int _print_step_state(job_step_info_t * step, int width, bool right,
 		_print_str(job_state_string(step->state), width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2828,7 +2983,7 @@ int _print_step_cpus_per_tres(job_step_info_t * step, int width, bool right,
 		_print_str(step->cpus_per_tres, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2841,7 +2996,7 @@ int _print_step_mem_per_tres(job_step_info_t * step, int width, bool right,
 		_print_str(step->mem_per_tres, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2854,7 +3009,7 @@ int _print_step_tres_bind(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_bind, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2867,7 +3022,7 @@ int _print_step_tres_freq(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_freq, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2880,7 +3035,7 @@ int _print_step_tres_per_step(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_step, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2893,7 +3048,7 @@ int _print_step_tres_per_node(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_node, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2906,7 +3061,7 @@ int _print_step_tres_per_socket(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_socket, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2919,7 +3074,7 @@ int _print_step_tres_per_task(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_task, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -3271,6 +3426,6 @@ static int _filter_step(job_step_info_t * step)
 int _print_com_invalid(void * p, int width, bool right, char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out("%s", suffix);
 	return SLURM_SUCCESS;
 }
@@ -64,10 +64,13 @@ typedef struct step_format {
 } step_format_t;
 
 typedef struct squeue_job_rec {
+	bitstr_t *	array_bitmap;	/* combined pending tasks */
+	char *		array_task_str;	/* combined pending tasks */
 	uint32_t job_prio;
 	job_info_t *	job_ptr;
 	char *		part_name;
 	uint32_t	part_prio;
+	char *		state_desc;	/* combined pending tasks' reasons */
 } squeue_job_rec_t;
 
 long job_time_used(job_info_t * job_ptr);
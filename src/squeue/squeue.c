@@ -309,12 +309,34 @@ static int _print_job(bool clear_old, bool log_cluster_name, int argc,
 		show_flags |= SHOW_LOCAL;
 	if (params.sibling_flag)
 		show_flags |= SHOW_FEDERATION | SHOW_SIBLING;
+	/*
+	 * Finished jobs are filtered out below by default, so let slurmctld
+	 * skip packing them. Older controllers ignore the flag.
+	 */
+	if (!params.all_states && !params.state_list && !params.mimetype)
+		show_flags |= SHOW_ACTIVE;
 
 	/* We require detail data when CPUs are requested */
 	if ((params.format && strstr(params.format, "C")) || params.detail_flag)
 		show_flags |= SHOW_DETAIL;
 
-	if (old_job_ptr) {
+	if (old_job_ptr && !params.job_id && !params.user_id &&
+	    !params.job_list && !params.mimetype) {
+		/*
+		 * Only transfer the jobs that changed since old_job_ptr was
+		 * loaded. _filter_job() modifies the job records when
+		 * params.job_list is set, so those can not be reused.
+		 */
+		if (clear_old)
+			old_job_ptr->last_update = 0;
+		if (params.clusters)
+			show_flags |= SHOW_LOCAL;
+		new_job_ptr = old_job_ptr;
+		error_code = slurm_load_jobs_delta(&new_job_ptr, show_flags);
+		if (error_code &&
+		    (slurm_get_errno() == SLURM_NO_CHANGE_IN_DATA))
+			error_code = SLURM_SUCCESS;
+	} else if (old_job_ptr) {
 		if (clear_old)
 			old_job_ptr->last_update = 0;
 		if (params.job_id) {
@@ -87,6 +87,11 @@ static void _signal_while_allocating(int signo);
 static int _wait_nodes_ready(resource_allocation_response_msg_t *alloc);
 
 static sig_atomic_t destroy_job = 0;
+
+static pthread_t lookup_thread = 0;
+static List lookup_resp_list = NULL;
+static int lookup_rc = SLURM_SUCCESS;
+static int lookup_errno = 0;
 static bool is_het_job = false;
 static bool revoke_job = false;
 
@@ -657,10 +662,30 @@ cleanup_allocation(void)
 	return SLURM_SUCCESS;
 }
 
+static void *_lookup_allocation(void *arg)
+{
+	if ((lookup_rc = slurm_het_job_lookup((uint32_t) sropt.jobid,
+					      &lookup_resp_list)) < 0)
+		lookup_errno = errno;
+
+	return NULL;
+}
+
+extern void existing_allocation_prefetch(void)
+{
+	/* --clusters needs working_cluster_rec set before the lookup */
+	if ((sropt.jobid == NO_VAL) || sropt.no_alloc || sropt.test_only ||
+	    opt.clusters || lookup_thread)
+		return;
+
+	slurm_thread_create(&lookup_thread, _lookup_allocation, NULL);
+}
+
 extern List existing_allocation(void)
 {
 	uint32_t old_job_id;
 	List job_resp_list = NULL;
+	int rc;
 
 	if (sropt.jobid == NO_VAL)
 		return NULL;
@@ -679,7 +704,16 @@ extern List existing_allocation(void)
 	}
 
 	old_job_id = (uint32_t) sropt.jobid;
-	if (slurm_het_job_lookup(old_job_id, &job_resp_list) < 0) {
+	if (lookup_thread) {
+		slurm_thread_join(lookup_thread);
+		job_resp_list = lookup_resp_list;
+		lookup_resp_list = NULL;
+		if ((rc = lookup_rc) < 0)
+			errno = lookup_errno;
+	} else {
+		rc = slurm_het_job_lookup(old_job_id, &job_resp_list);
+	}
+	if (rc < 0) {
 		if (sropt.parallel_debug)
 			return NULL;    /* create new allocation as needed */
 		if (errno == ESLURM_ALREADY_DONE)
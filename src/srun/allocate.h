@@ -96,6 +96,13 @@ void job_desc_msg_destroy (job_desc_msg_t *j);
  */
 extern List existing_allocation(void);
 
+/*
+ * Start looking up the allocation that existing_allocation() will return in
+ * a background thread, so the round trip to slurmctld overlaps with the rest
+ * of srun's initialization. existing_allocation() waits for it.
+ */
+extern void existing_allocation_prefetch(void);
+
 /*
  * Create a job step given the job information stored in 'j'
  * After returning, 'j' is filled in with information for job step.
@@ -734,6 +734,13 @@ extern void init_srun(int argc, char **argv, log_options_t *logopt,
 		}
 	}
 
+	/*
+	 * The job id is known once the options are parsed. Confirm the
+	 * allocation with slurmctld while the MPI plugin and the remaining
+	 * options are set up.
+	 */
+	existing_allocation_prefetch();
+
 	if (!mpi_g_client_init(&sropt.mpi_type)) {
 		error("Invalid MPI type '%s', --mpi=list for acceptable types",
 		      sropt.mpi_type);
@@ -2351,9 +2351,10 @@ static int _set_step_gres_bit_alloc(gres_step_state_t *gres_ss,
 			    gres_js->gres_bit_step_alloc[node_offset]);
 	}
 
-	for (int i = 0; i < len && gres_alloc; i++) {
-		if (!bit_test(gres_bit_avail, i) ||
-		    bit_test(gres_bit_alloc, i) ||
+	/* Only visit GRES still free for this job */
+	for (int i = 0; (i < len) && gres_alloc &&
+		     ((i = bit_ffs_from_bit(gres_bit_avail, i)) >= 0); i++) {
+		if (bit_test(gres_bit_alloc, i) ||
 		    !_cores_on_gres(core_bitmap, NULL, gres_ns, i, gres_js))
 			continue;
 
@@ -2676,8 +2677,10 @@ extern int gres_stepmgr_step_alloc(
 		}
 		/* Pass 2: Allocate any available GRES */
 		args.core_bitmap = NULL;
-		(void) list_for_each(job_gres_list, (ListForF) _step_alloc_type,
-				     &args);
+		if (args.gres_needed || args.max_gres)
+			(void) list_for_each(job_gres_list,
+					     (ListForF) _step_alloc_type,
+					     &args);
 		*total_gres_cpu_cnt += args.total_gres_cpu_cnt;
 
 		if (args.rc != SLURM_SUCCESS)
@@ -2704,7 +2707,7 @@ static int _step_dealloc(gres_state_t *gres_state_step, List job_gres_list,
 	gres_step_state_t *gres_ss =
 		(gres_step_state_t *)gres_state_step->gres_data;
 	gres_job_state_t *gres_js;
-	uint32_t j;
+	int j;
 	uint64_t gres_cnt;
 	int len_j, len_s;
 	gres_key_t job_search_key;
@@ -2790,11 +2793,21 @@ static int _step_dealloc(gres_state_t *gres_state_step, List job_gres_list,
 		      step_id, node_offset, len_j, len_s);
 		len_j = MIN(len_j, len_s);
 	}
-	for (j = 0; j < len_j; j++) {
-		if (!bit_test(gres_ss->gres_bit_alloc[node_offset], j))
-			continue;
-		if (gres_js->gres_bit_step_alloc &&
-		    gres_js->gres_bit_step_alloc[node_offset]) {
+	if (!gres_js->gres_bit_step_alloc ||
+	    !gres_js->gres_bit_step_alloc[node_offset]) {
+		/* Nothing to release */
+	} else if (!gres_id_shared(gres_state_job->config_flags) &&
+		   (len_j == len_s) &&
+		   (bit_size(gres_js->gres_bit_step_alloc[node_offset]) ==
+		    len_j)) {
+		/* Release the whole step allocation a word at a time */
+		bit_and_not(gres_js->gres_bit_step_alloc[node_offset],
+			    gres_ss->gres_bit_alloc[node_offset]);
+	} else {
+		for (j = 0; (j < len_j) &&
+			     ((j = bit_ffs_from_bit(
+				       gres_ss->gres_bit_alloc[node_offset],
+				       j)) >= 0) && (j < len_j); j++) {
 			bit_clear(gres_js->gres_bit_step_alloc[node_offset],
 				  j);
 			if (gres_id_shared(gres_state_job->config_flags) &&
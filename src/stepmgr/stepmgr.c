@@ -905,10 +905,16 @@ static bitstr_t *_pick_step_nodes_cpus(job_record_t *job_ptr,
 	return NULL;
 }
 
+typedef struct {
+	bitstr_t *busy;
+	bitstr_t *nodes_avail;
+} mark_busy_args_t;
+
 static int _mark_busy_nodes(void *x, void *arg)
 {
 	step_record_t *step_ptr = (step_record_t *) x;
-	bitstr_t *busy = (bitstr_t *) arg;
+	mark_busy_args_t *args = arg;
+	bitstr_t *busy = args->busy;
 
 	if (step_ptr->state < JOB_RUNNING)
 		return 0;
@@ -939,6 +945,14 @@ static int _mark_busy_nodes(void *x, void *arg)
 		xfree(temp);
 	}
 
+	/*
+	 * Once every available node is busy no other step can change the
+	 * result. Jobs running thousands of small steps would otherwise
+	 * walk all of them for every new step.
+	 */
+	if (bit_super_set(args->nodes_avail, busy))
+		return -1;
+
 	return 0;
 }
 
@@ -1562,8 +1576,14 @@ static bitstr_t *_pick_step_nodes(job_record_t *job_ptr,
 		bit_and_not(nodes_avail, relative_nodes);
 		FREE_NULL_BITMAP(relative_nodes);
 	} else {
+		mark_busy_args_t busy_args = {
+			.nodes_avail = nodes_avail,
+		};
+
 		nodes_idle = bit_alloc (bit_size (nodes_avail) );
-		list_for_each(job_ptr->step_list, _mark_busy_nodes, nodes_idle);
+		busy_args.busy = nodes_idle;
+		list_for_each(job_ptr->step_list, _mark_busy_nodes,
+			      &busy_args);
 		bit_not(nodes_idle);
 		bit_and(nodes_idle, nodes_avail);
 	}
@@ -38,6 +38,7 @@
 #include "src/common/proc_args.h"
 #include "src/interfaces/select.h"
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/sview/sview.h"
@@ -3035,26 +3036,54 @@ static int _sview_job_sort_aval_dec(void *s1, void *s2)
 	return 0;
 }
 
-static int _task_array_match(void *x, void *key)
+/*
+ * Hashes used by _create_job_info_list() so that a refresh against a large
+ * job table doesn't rescan every record for every job.
+ */
+typedef struct {
+	uint32_t job_id;
+	list_t *steps;
+} step_bucket_t;
+
+static void _step_bucket_id(void *item, const char **key, uint32_t *key_len)
 {
-	sview_job_info_t *sview_job_info_ptr = (sview_job_info_t *) x;
-	job_info_t *job_ptr = (job_info_t *) key;
+	step_bucket_t *bucket = item;
 
-	if (sview_job_info_ptr->job_ptr->array_job_id  == job_ptr->array_job_id)
-		return 1;
+	*key = (const char *) &bucket->job_id;
+	*key_len = sizeof(bucket->job_id);
+}
 
-	return 0;
+static void _step_bucket_free(void *item)
+{
+	step_bucket_t *bucket = item;
+
+	FREE_NULL_LIST(bucket->steps);
+	xfree(bucket);
 }
 
-static int _het_job_id_match(void *x, void *key)
+static void _job_info_id(void *item, const char **key, uint32_t *key_len)
 {
-	sview_job_info_t *sview_job_info_ptr = (sview_job_info_t *) x;
-	job_info_t *job_ptr = (job_info_t *) key;
+	sview_job_info_t *sview_job_info_ptr = item;
 
-	if (sview_job_info_ptr->job_ptr->het_job_id  == job_ptr->het_job_id)
-		return 1;
+	*key = (const char *) &sview_job_info_ptr->job_id;
+	*key_len = sizeof(sview_job_info_ptr->job_id);
+}
 
-	return 0;
+static void _job_info_array_id(void *item, const char **key,
+			       uint32_t *key_len)
+{
+	sview_job_info_t *sview_job_info_ptr = item;
+
+	*key = (const char *) &sview_job_info_ptr->job_ptr->array_job_id;
+	*key_len = sizeof(sview_job_info_ptr->job_ptr->array_job_id);
+}
+
+static void _job_info_het_id(void *item, const char **key, uint32_t *key_len)
+{
+	sview_job_info_t *sview_job_info_ptr = item;
+
+	*key = (const char *) &sview_job_info_ptr->job_ptr->het_job_id;
+	*key_len = sizeof(sview_job_info_ptr->job_ptr->het_job_id);
 }
 
 static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
@@ -3064,7 +3093,9 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 	static list_t *info_list = NULL;
 	static list_t *odd_info_list = NULL;
 	list_t *last_list = NULL;
-	list_itr_t *last_list_itr = NULL;
+	xhash_t *last_hash = NULL, *array_hash = NULL, *het_hash = NULL;
+	xhash_t *step_hash = NULL;
+	step_bucket_t *bucket = NULL;
 	static job_info_msg_t *last_job_info_ptr = NULL;
 	static job_step_info_response_msg_t *last_step_info_ptr = NULL;
 	int i = 0, j = 0;
@@ -3087,8 +3118,34 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 		info_list = list_create(NULL);
 		odd_info_list = list_create(_job_info_list_del);
 	}
-	if (last_list)
-		last_list_itr = list_iterator_create(last_list);
+	/*
+	 * Records from the last refresh are looked up by JobId so that their
+	 * tree store iterators are kept and their rows updated in place.
+	 */
+	if (last_list) {
+		last_hash = xhash_init(_job_info_id, _job_info_list_del);
+		while ((sview_job_info_ptr = list_pop(last_list)))
+			xhash_add(last_hash, sview_job_info_ptr);
+	}
+	array_hash = xhash_init(_job_info_array_id, NULL);
+	het_hash = xhash_init(_job_info_het_id, NULL);
+
+	step_hash = xhash_init(_step_bucket_id, _step_bucket_free);
+	for (j = 0; j < step_info_ptr->job_step_count; j++) {
+		step_ptr = &(step_info_ptr->job_steps[j]);
+		if (step_ptr->state != JOB_RUNNING)
+			continue;
+		if (!(bucket = xhash_get(step_hash,
+					 (char *) &step_ptr->step_id.job_id,
+					 sizeof(step_ptr->step_id.job_id)))) {
+			bucket = xmalloc(sizeof(*bucket));
+			bucket->job_id = step_ptr->step_id.job_id;
+			bucket->steps = list_create(NULL);
+			xhash_add(step_hash, bucket);
+		}
+		list_append(bucket->steps, step_ptr);
+	}
+
 	for (i=0; i<job_info_ptr->record_count; i++) {
 		bool added_task = false;
 
@@ -3098,18 +3155,11 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 
 		sview_job_info_ptr = NULL;
 
-		if (last_list_itr) {
-			while ((sview_job_info_ptr =
-				list_next(last_list_itr))) {
-				if (sview_job_info_ptr->job_id ==
-				    job_ptr->job_id) {
-					list_remove(last_list_itr);
-					_job_info_free(sview_job_info_ptr);
-					break;
-				}
-			}
-			list_iterator_reset(last_list_itr);
-		}
+		if (last_hash &&
+		    (sview_job_info_ptr = xhash_pop(last_hash,
+						    (char *) &job_ptr->job_id,
+						    sizeof(job_ptr->job_id))))
+			_job_info_free(sview_job_info_ptr);
 
 		if (!sview_job_info_ptr)
 			sview_job_info_ptr = xmalloc(sizeof(sview_job_info_t));
@@ -3121,8 +3171,9 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 		    (job_ptr->array_task_id != NO_VAL)) {
 			char task_str[64];
 			sview_job_info_t *first_job_info_ptr =
-				list_find_first(info_list,
-						_task_array_match, job_ptr);
+				xhash_get(array_hash,
+					  (char *) &job_ptr->array_job_id,
+					  sizeof(job_ptr->array_job_id));
 			if (job_ptr->array_task_str) {
 				snprintf(task_str, sizeof(task_str), "[%s]",
 					 job_ptr->array_task_str);
@@ -3177,8 +3228,9 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 			snprintf(comp_str, sizeof(comp_str), "%u",
 				 job_ptr->het_job_offset);
 			sview_job_info_t *first_job_info_ptr =
-				list_find_first(info_list,
-						_het_job_id_match, job_ptr);
+				xhash_get(het_hash,
+					  (char *) &job_ptr->het_job_id,
+					  sizeof(job_ptr->het_job_id));
 			if (!first_job_info_ptr) {
 				sview_job_info_ptr->task_list =
 					list_create(NULL);
@@ -3210,14 +3262,10 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 		sview_job_info_ptr->nodes = xstrdup(job_ptr->nodes);
 		sview_job_info_ptr->node_cnt = job_ptr->num_nodes;
 
-		for (j = 0; j < step_info_ptr->job_step_count; j++) {
-			step_ptr = &(step_info_ptr->job_steps[j]);
-			if ((step_ptr->step_id.job_id == job_ptr->job_id) &&
-			    (step_ptr->state == JOB_RUNNING)) {
-				list_append(sview_job_info_ptr->step_list,
-					    step_ptr);
-			}
-		}
+		if ((bucket = xhash_get(step_hash, (char *) &job_ptr->job_id,
+					sizeof(job_ptr->job_id))))
+			list_append_list(sview_job_info_ptr->step_list,
+					 bucket->steps);
 		if (!added_task)
 			list_append(odd_info_list, sview_job_info_ptr);
 
@@ -3228,18 +3276,33 @@ static list_t *_create_job_info_list(job_info_msg_t *job_info_ptr,
 			continue;
 		}
 
-		if (!added_task)
+		if (!added_task) {
 			list_append(info_list, sview_job_info_ptr);
+
+			/* first record of the array/het job in info_list */
+			if (job_ptr->array_job_id &&
+			    !xhash_get(array_hash,
+				       (char *) &job_ptr->array_job_id,
+				       sizeof(job_ptr->array_job_id)))
+				xhash_add(array_hash, sview_job_info_ptr);
+			if (job_ptr->het_job_id &&
+			    !xhash_get(het_hash,
+				       (char *) &job_ptr->het_job_id,
+				       sizeof(job_ptr->het_job_id)))
+				xhash_add(het_hash, sview_job_info_ptr);
+		}
 	}
 
 	list_sort(info_list, (ListCmpF)_sview_job_sort_aval_dec);
 
 	list_sort(odd_info_list, (ListCmpF)_sview_job_sort_aval_dec);
 
-	if (last_list) {
-		list_iterator_destroy(last_list_itr);
-		FREE_NULL_LIST(last_list);
-	}
+	/* free records of jobs which are gone */
+	xhash_free_ptr(&last_hash);
+	FREE_NULL_LIST(last_list);
+	xhash_free_ptr(&array_hash);
+	xhash_free_ptr(&het_hash);
+	xhash_free_ptr(&step_hash);
 
 update_color:
 
@@ -3467,10 +3530,10 @@ extern int get_new_info_job(job_info_msg_t **info_ptr,
 	if (g_job_info_ptr) {
 		if (show_flags != last_flags)
 			g_job_info_ptr->last_update = 0;
-		error_code = slurm_load_jobs(g_job_info_ptr->last_update,
-					     &new_job_ptr, show_flags);
+		/* Replaces g_job_info_ptr, only changed jobs are transferred */
+		new_job_ptr = g_job_info_ptr;
+		error_code = slurm_load_jobs_delta(&new_job_ptr, show_flags);
 		if (error_code == SLURM_SUCCESS) {
-			slurm_free_job_info_msg(g_job_info_ptr);
 			changed = 1;
 		} else if (errno == SLURM_NO_CHANGE_IN_DATA) {
 			error_code = SLURM_NO_CHANGE_IN_DATA;
@@ -28,6 +28,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include "src/common/xhash.h"
+
 #include "src/sview/sview.h"
 
 #define _DEBUG 0
@@ -720,6 +722,14 @@ static void _node_info_list_del(void *object)
 	}
 }
 
+static void _node_info_id(void *item, const char **key, uint32_t *key_len)
+{
+	sview_node_info_t *sview_node_info = item;
+
+	*key = sview_node_info->node_name;
+	*key_len = strlen(sview_node_info->node_name);
+}
+
 static void _display_info_node(list_t *info_list, popup_info_t *popup_win)
 {
 	specific_info_t *spec_info = popup_win->spec_info;
@@ -841,7 +851,7 @@ extern list_t *create_node_info_list(node_info_msg_t *node_info_ptr,
 	static list_t *info_list = NULL;
 	static node_info_msg_t *last_node_info_ptr = NULL;
 	list_t *last_list = NULL;
-	list_itr_t *last_list_itr = NULL;
+	xhash_t *last_hash = NULL;
 	int i = 0;
 	sview_node_info_t *sview_node_info_ptr = NULL;
 	node_info_t *node_ptr = NULL;
@@ -860,8 +870,12 @@ extern list_t *create_node_info_list(node_info_msg_t *node_info_ptr,
 
 	info_list = list_create(_node_info_list_del);
 
-	if (last_list)
-		last_list_itr = list_iterator_create(last_list);
+	/* keep the records (and tree store iterators) of known nodes */
+	if (last_list) {
+		last_hash = xhash_init(_node_info_id, _node_info_list_del);
+		while ((sview_node_info_ptr = list_pop(last_list)))
+			xhash_add(last_hash, sview_node_info_ptr);
+	}
 	for (i=0; i<node_info_ptr->record_count; i++) {
 		node_ptr = &(node_info_ptr->node_array[i]);
 
@@ -870,18 +884,10 @@ extern list_t *create_node_info_list(node_info_msg_t *node_info_ptr,
 
 		sview_node_info_ptr = NULL;
 
-		if (last_list_itr) {
-			while ((sview_node_info_ptr =
-				list_next(last_list_itr))) {
-				if (!xstrcmp(sview_node_info_ptr->node_name,
-					     node_ptr->name)) {
-					list_remove(last_list_itr);
-					_node_info_free(sview_node_info_ptr);
-					break;
-				}
-			}
-			list_iterator_reset(last_list_itr);
-		}
+		if (last_hash &&
+		    (sview_node_info_ptr = xhash_pop_str(last_hash,
+							 node_ptr->name)))
+			_node_info_free(sview_node_info_ptr);
 
 		/* constrain list to included partitions' nodes */
 		/* and there are excluded values to process */
@@ -923,10 +929,9 @@ extern list_t *create_node_info_list(node_info_msg_t *node_info_ptr,
 		}
 	}
 
-	if (last_list) {
-		list_iterator_destroy(last_list_itr);
-		FREE_NULL_LIST(last_list);
-	}
+	/* free records of nodes which are gone */
+	xhash_free_ptr(&last_hash);
+	FREE_NULL_LIST(last_list);
 
 update_color:
 
@@ -237,6 +237,64 @@ START_TEST(test_dict_iteration)
 }
 END_TEST
 
+static data_for_each_cmd_t _check_dict_order(const char *key,
+					     const data_t *data, void *arg)
+{
+	int *found = arg;
+	char buf[32];
+
+	snprintf(buf, sizeof(buf), "key%d", *found);
+	ck_assert_msg(!xstrcmp(key, buf), "check key order");
+	ck_assert_msg(data_get_int(data) == *found, "check value");
+
+	*found += 1;
+	return DATA_FOR_EACH_CONT;
+}
+
+START_TEST(test_dict_large)
+{
+	const int count = 1000;
+	int found = 0;
+	data_t *d = data_set_dict(data_new());
+	char buf[32];
+
+	/* large enough to be indexed */
+	for (int i = 0; i < count; i++) {
+		snprintf(buf, sizeof(buf), "key%d", i);
+		data_set_int(data_key_set(d, buf), i);
+	}
+	ck_assert_msg(data_get_dict_length(d) == count, "dict cardinality");
+
+	for (int i = 0; i < count; i++) {
+		snprintf(buf, sizeof(buf), "key%d", i);
+		ck_assert_msg(data_get_int(data_key_get(d, buf)) == i,
+			      "find key");
+	}
+	ck_assert_msg(!data_key_get(d, "missing"), "missing key");
+
+	/* overwrite must not add a duplicate */
+	data_set_int(data_key_set(d, "key10"), 10);
+	ck_assert_msg(data_get_dict_length(d) == count, "dict cardinality");
+
+	/* insertion order is preserved */
+	ck_assert_msg(data_dict_for_each_const(d, _check_dict_order, &found) ==
+		      count, "order touch count");
+	ck_assert_msg(found == count, "check max found");
+
+	ck_assert_msg(data_key_unset(d, "key500"), "remove key");
+	ck_assert_msg(!data_key_get(d, "key500"), "removed key");
+	ck_assert_msg(!data_key_unset(d, "key500"), "remove removed key");
+	ck_assert_msg(data_get_dict_length(d) == (count - 1),
+		      "dict cardinality");
+
+	data_set_int(data_key_set(d, "key500"), 500);
+	ck_assert_msg(data_get_int(data_key_get(d, "key500")) == 500,
+		      "find readded key");
+
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
 START_TEST(test_dict_typeset)
 {
 	data_t *d = data_new();
@@ -355,6 +413,7 @@ Suite *suite_data(void)
 	tcase_add_test(tc_core, test_detection);
 	tcase_add_test(tc_core, test_dict_typeset);
 	tcase_add_test(tc_core, test_dict_iteration);
+	tcase_add_test(tc_core, test_dict_large);
 	tcase_add_test(tc_core, test_list_iteration);
 
 	suite_add_tcase(s, tc_core);
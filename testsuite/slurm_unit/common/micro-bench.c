@@ -0,0 +1,576 @@
+/*****************************************************************************\
+ *  micro-bench.c - speed of the protocol pack code and core data structures
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Not a test: built with the check programs but never run by "make check".
+ *
+ * Usage: micro-bench [name-filter]
+ *
+ * Prints one JSON object per benchmark, e.g.
+ *   {"name":"bitstring/set_count","size":1048576,"iterations":4096,
+ *    "ns_per_op":1234.5}
+ * so results can be compared between builds. Each benchmark runs for at least
+ * SLURM_BENCH_MIN_MS milliseconds (default 200).
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "slurm/slurm.h"
+#include "slurm/slurm_errno.h"
+
+#include "src/common/bitstring.h"
+#include "src/common/data.h"
+#include "src/common/hostlist.h"
+#include "src/common/log.h"
+#include "src/common/pack.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/slurm_protocol_pack.h"
+#include "src/common/xahash.h"
+#include "src/common/xhash.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/interfaces/hash.h"
+#include "src/interfaces/serializer.h"
+
+#define BITMAP_SIZE (1024 * 1024)
+#define HOST_COUNT 50000
+#define HASH_COUNT 100000
+#define JOB_ENV_COUNT 100
+#define JOB_SCRIPT_SIZE 4096
+#define DATA_DICT_COUNT 1000
+
+typedef void (*bench_func_t)(void *arg);
+
+static const char *filter = NULL;
+static uint64_t min_ns = 200 * 1000000;
+
+static uint64_t _now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+/* Run func until min_ns has elapsed, doubling the batch each round */
+static void _bench(const char *name, int size, bench_func_t func, void *arg)
+{
+	uint64_t iterations = 0, batch = 1, start, elapsed;
+
+	if (filter && !xstrstr(name, filter))
+		return;
+
+	start = _now_ns();
+	do {
+		for (uint64_t i = 0; i < batch; i++)
+			func(arg);
+		iterations += batch;
+		batch *= 2;
+		elapsed = _now_ns() - start;
+	} while (elapsed < min_ns);
+
+	printf("{\"name\":\"%s\",\"size\":%d,\"iterations\":%"PRIu64",\"ns_per_op\":%.1f}\n",
+	       name, size, iterations, (double) elapsed / iterations);
+	fflush(stdout);
+}
+
+/*
+ * pack.c primitives
+ */
+static void _pack_primitives(void *arg)
+{
+	buf_t *buffer = arg;
+	uint32_t u32, len;
+	uint64_t u64;
+	char *str = NULL;
+
+	set_buf_offset(buffer, 0);
+	for (int i = 0; i < 1000; i++) {
+		pack32(i, buffer);
+		pack64(i, buffer);
+		packstr("node00001", buffer);
+	}
+	set_buf_offset(buffer, 0);
+	for (int i = 0; i < 1000; i++) {
+		(void) unpack32(&u32, buffer);
+		(void) unpack64(&u64, buffer);
+		(void) unpackstr_xmalloc(&str, &len, buffer);
+		xfree(str);
+	}
+}
+
+/*
+ * Round trip of a realistic batch job submission through the protocol code
+ */
+static void _pack_job_desc(void *arg)
+{
+	slurm_msg_t *msg = arg;
+	slurm_msg_t out;
+	buf_t *buffer = init_buf(64 * 1024);
+
+	if (pack_msg(msg, buffer) != SLURM_SUCCESS)
+		fatal("pack_msg() failed");
+	set_buf_offset(buffer, 0);
+
+	slurm_msg_t_init(&out);
+	out.msg_type = msg->msg_type;
+	out.protocol_version = msg->protocol_version;
+	if (unpack_msg(&out, buffer) != SLURM_SUCCESS)
+		fatal("unpack_msg() failed");
+
+	slurm_free_msg_data(out.msg_type, out.data);
+	FREE_NULL_BUFFER(buffer);
+}
+
+static job_desc_msg_t *_job_desc_create(void)
+{
+	job_desc_msg_t *job = xmalloc(sizeof(*job));
+
+	slurm_init_job_desc_msg(job);
+	job->name = xstrdup("benchmark_job");
+	job->account = xstrdup("physics");
+	job->partition = xstrdup("batch,debug");
+	job->work_dir = xstrdup("/home/user/project/run");
+	job->std_out = xstrdup("/home/user/project/run/slurm-%j.out");
+	job->min_nodes = 4;
+	job->max_nodes = 4;
+	job->num_tasks = 128;
+	job->cpus_per_task = 2;
+	job->time_limit = 720;
+	job->user_id = 1000;
+	job->group_id = 1000;
+	job->tres_per_node = xstrdup("gres/gpu:4");
+	job->argc = 1;
+	job->argv = xcalloc(2, sizeof(char *));
+	job->argv[0] = xstrdup("/home/user/project/run/job.sh");
+
+	job->script = xmalloc(JOB_SCRIPT_SIZE + 1);
+	xstrcat(job->script, "#!/bin/bash\n");
+	while (strlen(job->script) < (JOB_SCRIPT_SIZE - 64))
+		xstrcat(job->script, "srun --mpi=pmix ./a.out -i input.dat\n");
+
+	job->env_size = JOB_ENV_COUNT;
+	job->environment = xcalloc(JOB_ENV_COUNT + 1, sizeof(char *));
+	for (int i = 0; i < JOB_ENV_COUNT; i++)
+		xstrfmtcat(job->environment[i],
+			   "BENCH_VARIABLE_%d=/usr/local/lib/path/%d", i, i);
+
+	return job;
+}
+
+/*
+ * bitstring.c kernels at cluster-scale sizes
+ */
+typedef struct {
+	bitstr_t *a;
+	bitstr_t *b;
+	bitstr_t *c;
+} bit_args_t;
+
+static void _bit_set_count(void *arg)
+{
+	bit_args_t *args = arg;
+
+	(void) bit_set_count(args->a);
+}
+
+static void _bit_and_or(void *arg)
+{
+	bit_args_t *args = arg;
+
+	bit_copybits(args->c, args->a);
+	bit_and(args->c, args->b);
+	bit_or(args->c, args->b);
+}
+
+static void _bit_overlap(void *arg)
+{
+	bit_args_t *args = arg;
+
+	(void) bit_overlap(args->a, args->b);
+}
+
+static void _bit_walk(void *arg)
+{
+	bit_args_t *args = arg;
+
+	for (int i = bit_ffs(args->b); i >= 0;
+	     i = bit_ffs_from_bit(args->b, i + 1))
+		;
+}
+
+static void _bit_fmt_hexmask(void *arg)
+{
+	bit_args_t *args = arg;
+	char *str = bit_fmt_hexmask(args->a);
+
+	xfree(str);
+}
+
+static void _bit_fmt_full(void *arg)
+{
+	bit_args_t *args = arg;
+	char *str = bit_fmt_full(args->b);
+
+	xfree(str);
+}
+
+/*
+ * hostlist.c on large node lists
+ */
+typedef struct {
+	char *ranged;
+	char **names;
+	hostlist_t *hl;
+} host_args_t;
+
+static void _hostlist_create(void *arg)
+{
+	host_args_t *args = arg;
+	hostlist_t *hl = hostlist_create(args->ranged);
+
+	FREE_NULL_HOSTLIST(hl);
+}
+
+static void _hostlist_ranged_string(void *arg)
+{
+	host_args_t *args = arg;
+	char *str = hostlist_ranged_string_xmalloc(args->hl);
+
+	xfree(str);
+}
+
+static void _hostlist_push_uniq(void *arg)
+{
+	host_args_t *args = arg;
+	hostlist_t *hl = hostlist_create(NULL);
+	char *str;
+
+	for (int i = 0; i < HOST_COUNT; i++)
+		hostlist_push_host(hl, args->names[i]);
+	hostlist_uniq(hl);
+	str = hostlist_ranged_string_xmalloc(hl);
+	xfree(str);
+	FREE_NULL_HOSTLIST(hl);
+}
+
+static void _hostlist_find(void *arg)
+{
+	host_args_t *args = arg;
+
+	(void) hostlist_find(args->hl, args->names[HOST_COUNT / 2]);
+}
+
+/*
+ * xhash.c vs xahash.c storing HASH_COUNT string keyed entries
+ */
+typedef struct {
+	char key[32];
+} hash_entry_t;
+
+static hash_entry_t *hash_entries = NULL;
+
+static void _xhash_id(void *item, const char **key, uint32_t *key_len)
+{
+	hash_entry_t *entry = item;
+
+	*key = entry->key;
+	*key_len = strlen(entry->key);
+}
+
+static void _xhash_build(void *arg)
+{
+	xhash_t *ht = xhash_init(_xhash_id, NULL);
+
+	for (int i = 0; i < HASH_COUNT; i++)
+		xhash_add(ht, &hash_entries[i]);
+	for (int i = 0; i < HASH_COUNT; i++)
+		if (!xhash_get_str(ht, hash_entries[i].key))
+			fatal("xhash lost %s", hash_entries[i].key);
+	xhash_free_ptr(&ht);
+}
+
+static xahash_hash_t _xahash_hash(const void *key, const size_t key_bytes,
+				  void *state)
+{
+	const unsigned char *p = key;
+	xahash_hash_t hash = 2166136261u;
+
+	/* FNV-1a */
+	for (size_t i = 0; i < key_bytes; i++)
+		hash = (hash ^ p[i]) * 16777619u;
+
+	return hash;
+}
+
+static bool _xahash_match(void *entry, const void *key, const size_t key_bytes,
+			  void *state)
+{
+	hash_entry_t **e = entry;
+
+	return !strncmp((*e)->key, key, key_bytes) && !(*e)->key[key_bytes];
+}
+
+static void _xahash_on_insert(void *entry, const void *key,
+			      const size_t key_bytes, void *state)
+{
+	hash_entry_t **e = entry;
+
+	/* key is hash_entry_t.key, the first member */
+	*e = (hash_entry_t *) key;
+}
+
+static void _xahash_on_free(void *entry, void *state)
+{
+	/* entries are not owned by the table */
+}
+
+static void _xahash_build(void *arg)
+{
+	xahash_table_t *ht = xahash_new_table(_xahash_hash, _xahash_match,
+					      _xahash_on_insert,
+					      _xahash_on_free, 0,
+					      sizeof(hash_entry_t *),
+					      HASH_COUNT);
+
+	for (int i = 0; i < HASH_COUNT; i++)
+		(void) xahash_insert_entry(ht, hash_entries[i].key,
+					   strlen(hash_entries[i].key));
+	for (int i = 0; i < HASH_COUNT; i++)
+		if (!xahash_find_entry(ht, hash_entries[i].key,
+				       strlen(hash_entries[i].key)))
+			fatal("xahash lost %s", hash_entries[i].key);
+	FREE_NULL_XAHASH_TABLE(ht);
+}
+
+/*
+ * data_t and the serializers
+ */
+static data_t *_data_dict_create(void)
+{
+	data_t *d = data_set_dict(data_new());
+
+	for (int i = 0; i < DATA_DICT_COUNT; i++) {
+		char key[32];
+		data_t *job;
+
+		snprintf(key, sizeof(key), "job_%d", i);
+		job = data_set_dict(data_key_set(d, key));
+		data_set_int(data_key_set(job, "job_id"), 1000 + i);
+		data_set_string(data_key_set(job, "user_name"), "user");
+		data_set_string(data_key_set(job, "nodes"), "node[0001-0128]");
+		data_set_bool(data_key_set(job, "requeue"), (i % 2));
+		data_set_float(data_key_set(job, "priority"), i * 1.5);
+	}
+
+	return d;
+}
+
+static void _data_copy(void *arg)
+{
+	data_t *copy = data_copy(NULL, arg);
+
+	FREE_NULL_DATA(copy);
+}
+
+static void _serialize_json(void *arg)
+{
+	char *str = NULL;
+	size_t len = 0;
+	data_t *parsed = NULL;
+
+	if (serialize_g_data_to_string(&str, &len, arg, MIME_TYPE_JSON,
+				       SER_FLAGS_COMPACT))
+		fatal("serialize_g_data_to_string() failed");
+	if (serialize_g_string_to_data(&parsed, str, len, MIME_TYPE_JSON))
+		fatal("serialize_g_string_to_data() failed");
+
+	FREE_NULL_DATA(parsed);
+	xfree(str);
+}
+
+/*
+ * Load slurm.conf from a stub file so the hash and serializer plugins can be
+ * found. SLURM_BENCH_PLUGIN_DIR overrides the installed plugin directory.
+ */
+static int _init_conf(void)
+{
+	char *conf_file = xstrdup("micro-bench.conf-XXXXXX"), *conf = NULL;
+	const char *plugin_dir = getenv("SLURM_BENCH_PLUGIN_DIR");
+	int fd, rc = SLURM_ERROR;
+
+	if (!plugin_dir)
+		plugin_dir = SLURM_PREFIX "/lib/slurm/";
+	/* slurm_conf_init() is fatal on a missing PluginDir */
+	if (access(plugin_dir, R_OK | X_OK)) {
+		error("PluginDir %s: %m", plugin_dir);
+		xfree(conf_file);
+		return SLURM_ERROR;
+	}
+	xstrfmtcat(conf, "ClusterName=micro_bench\n"
+		   "PluginDir=%s\n"
+		   "SlurmctldHost=micro_bench\n", plugin_dir);
+
+	if ((fd = mkstemp(conf_file)) < 0) {
+		error("unable to create %s: %m", conf_file);
+	} else {
+		if (write(fd, conf, strlen(conf)) == strlen(conf))
+			rc = slurm_conf_init(conf_file);
+		unlink(conf_file);
+		close(fd);
+	}
+	xfree(conf_file);
+	xfree(conf);
+
+	return rc;
+}
+
+extern int main(int argc, char **argv)
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	const char *min_ms_env = getenv("SLURM_BENCH_MIN_MS");
+	buf_t *buffer;
+	slurm_msg_t msg;
+	bit_args_t bit_args;
+	host_args_t host_args = { 0 };
+	data_t *d;
+	bool have_conf, have_hash = false, have_serializer = false;
+
+	log_opts.stderr_level = LOG_LEVEL_ERROR;
+	log_init("micro-bench", log_opts, 0, NULL);
+
+	if (argc > 1)
+		filter = argv[1];
+	if (min_ms_env && (atoi(min_ms_env) > 0))
+		min_ns = (uint64_t) atoi(min_ms_env) * 1000000;
+
+	/* unpacking a job_desc_msg_t hashes its environment */
+	if ((have_conf = (_init_conf() == SLURM_SUCCESS))) {
+		have_hash = (hash_g_init() == SLURM_SUCCESS);
+		have_serializer = !serializer_g_init(MIME_TYPE_JSON_PLUGIN,
+						     NULL);
+	}
+
+	/* pack */
+	buffer = init_buf(64 * 1024);
+	_bench("pack/primitives", 1000, _pack_primitives, buffer);
+	FREE_NULL_BUFFER(buffer);
+
+	if (have_hash) {
+		slurm_msg_t_init(&msg);
+		msg.msg_type = REQUEST_SUBMIT_BATCH_JOB;
+		msg.protocol_version = SLURM_PROTOCOL_VERSION;
+		msg.data = _job_desc_create();
+		_bench("pack/job_desc_round_trip", JOB_ENV_COUNT,
+		       _pack_job_desc, &msg);
+		slurm_free_job_desc_msg(msg.data);
+	} else {
+		error("hash/k12 not loaded, skipping pack/job_desc_round_trip");
+	}
+
+	/* bitstring, a sparse 1 bit in 7 and a dense 3 bits in 4 */
+	bit_args.a = bit_alloc(BITMAP_SIZE);
+	bit_args.b = bit_alloc(BITMAP_SIZE);
+	bit_args.c = bit_alloc(BITMAP_SIZE);
+	for (int i = 0; i < BITMAP_SIZE; i++) {
+		if (i % 4)
+			bit_set(bit_args.a, i);
+		if (!(i % 7))
+			bit_set(bit_args.b, i);
+	}
+	_bench("bitstring/set_count", BITMAP_SIZE, _bit_set_count, &bit_args);
+	_bench("bitstring/and_or", BITMAP_SIZE, _bit_and_or, &bit_args);
+	_bench("bitstring/overlap", BITMAP_SIZE, _bit_overlap, &bit_args);
+	_bench("bitstring/ffs_from_bit_walk", BITMAP_SIZE, _bit_walk,
+	       &bit_args);
+	_bench("bitstring/fmt_hexmask", BITMAP_SIZE, _bit_fmt_hexmask,
+	       &bit_args);
+	_bench("bitstring/fmt_full", BITMAP_SIZE, _bit_fmt_full, &bit_args);
+	FREE_NULL_BITMAP(bit_args.a);
+	FREE_NULL_BITMAP(bit_args.b);
+	FREE_NULL_BITMAP(bit_args.c);
+
+	/* hostlist, names pushed in a scrambled order */
+	xstrfmtcat(host_args.ranged, "node[00001-%05d]", HOST_COUNT);
+	host_args.hl = hostlist_create(host_args.ranged);
+	host_args.names = xcalloc(HOST_COUNT, sizeof(char *));
+	for (int i = 0; i < HOST_COUNT; i++)
+		xstrfmtcat(host_args.names[i], "node%05d",
+			   (int) ((((uint64_t) i * 7919) % HOST_COUNT) + 1));
+	_bench("hostlist/create", HOST_COUNT, _hostlist_create, &host_args);
+	_bench("hostlist/ranged_string", HOST_COUNT, _hostlist_ranged_string,
+	       &host_args);
+	_bench("hostlist/push_uniq_ranged", HOST_COUNT, _hostlist_push_uniq,
+	       &host_args);
+	_bench("hostlist/find", HOST_COUNT, _hostlist_find, &host_args);
+	for (int i = 0; i < HOST_COUNT; i++)
+		xfree(host_args.names[i]);
+	xfree(host_args.names);
+	FREE_NULL_HOSTLIST(host_args.hl);
+	xfree(host_args.ranged);
+
+	/* xhash vs xahash */
+	hash_entries = xcalloc(HASH_COUNT, sizeof(*hash_entries));
+	for (int i = 0; i < HASH_COUNT; i++)
+		snprintf(hash_entries[i].key, sizeof(hash_entries[i].key),
+			 "account_%d", i);
+	_bench("hash/xhash_add_get", HASH_COUNT, _xhash_build, NULL);
+	_bench("hash/xahash_insert_find", HASH_COUNT, _xahash_build, NULL);
+	xfree(hash_entries);
+
+	/* data_t */
+	d = _data_dict_create();
+	_bench("data/copy", DATA_DICT_COUNT, _data_copy, d);
+	if (have_serializer)
+		_bench("data/serialize_json_round_trip", DATA_DICT_COUNT,
+		       _serialize_json, d);
+	else
+		error("serializer/json not loaded, skipping data/serialize_json_round_trip");
+	FREE_NULL_DATA(d);
+
+	if (have_conf) {
+		serializer_g_fini();
+		hash_g_fini();
+		slurm_fini();
+	}
+	log_fini();
+	return EXIT_SUCCESS;
+}
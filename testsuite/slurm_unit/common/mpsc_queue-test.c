@@ -0,0 +1,212 @@
+/*****************************************************************************\
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <check.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/list.h"
+#include "src/common/log.h"
+#include "src/common/mpsc_queue.h"
+#include "src/common/read_config.h"
+#include "src/common/timers.h"
+#include "src/common/xmalloc.h"
+
+#define PRODUCERS 8
+#define ITEMS_PER_PRODUCER 200000
+
+/* Items are (producer << 32 | sequence), sequence starts at 1 to avoid NULL */
+#define ITEM(producer, seq) ((void *) ((((uintptr_t) (producer)) << 32) | \
+				       (uintptr_t) (seq)))
+#define ITEM_PRODUCER(x) ((uint32_t) (((uintptr_t) (x)) >> 32))
+#define ITEM_SEQ(x) ((uint32_t) (((uintptr_t) (x)) & 0xffffffff))
+
+typedef struct {
+	uint32_t id;
+	mpsc_queue_t *queue;
+	list_t *list;
+} producer_t;
+
+static void *_producer(void *arg)
+{
+	producer_t *p = arg;
+
+	for (uint32_t seq = 1; seq <= ITEMS_PER_PRODUCER; seq++) {
+		if (p->queue)
+			mpsc_queue_enqueue(p->queue, ITEM(p->id, seq));
+		else
+			list_enqueue(p->list, ITEM(p->id, seq));
+	}
+
+	return NULL;
+}
+
+/*
+ * Feed one consumer from PRODUCERS threads, checking that every item arrives
+ * exactly once and in order per producer.
+ * RET usec taken
+ */
+static long _run_contention(mpsc_queue_t *queue, list_t *list)
+{
+	pthread_t threads[PRODUCERS];
+	producer_t producers[PRODUCERS];
+	uint32_t last_seq[PRODUCERS] = { 0 };
+	uint64_t received = 0;
+	DEF_TIMERS;
+
+	START_TIMER;
+	for (int i = 0; i < PRODUCERS; i++) {
+		producers[i].id = i;
+		producers[i].queue = queue;
+		producers[i].list = list;
+		ck_assert(!pthread_create(&threads[i], NULL, _producer,
+					  &producers[i]));
+	}
+
+	while (received < (PRODUCERS * ITEMS_PER_PRODUCER)) {
+		void *x;
+
+		if (queue)
+			x = mpsc_queue_dequeue(queue);
+		else
+			x = list_dequeue(list);
+
+		if (!x)
+			continue;
+
+		ck_assert(ITEM_PRODUCER(x) < PRODUCERS);
+		ck_assert(ITEM_SEQ(x) == (last_seq[ITEM_PRODUCER(x)] + 1));
+		last_seq[ITEM_PRODUCER(x)] = ITEM_SEQ(x);
+		received++;
+	}
+
+	for (int i = 0; i < PRODUCERS; i++)
+		pthread_join(threads[i], NULL);
+	END_TIMER;
+
+	return DELTA_TIMER;
+}
+
+START_TEST(test_basic)
+{
+	mpsc_queue_t *queue = mpsc_queue_create();
+
+	ck_assert(mpsc_queue_is_empty(queue));
+	ck_assert(!mpsc_queue_dequeue(queue));
+
+	/* exercise node reuse over several fill and drain cycles */
+	for (int cycle = 0; cycle < 4; cycle++) {
+		for (uint32_t seq = 1; seq <= 3000; seq++)
+			mpsc_queue_enqueue(queue, ITEM(cycle, seq));
+		ck_assert(!mpsc_queue_is_empty(queue));
+
+		for (uint32_t seq = 1; seq <= 3000; seq++) {
+			void *x = mpsc_queue_dequeue(queue);
+
+			ck_assert(x == ITEM(cycle, seq));
+		}
+		ck_assert(mpsc_queue_is_empty(queue));
+		ck_assert(!mpsc_queue_dequeue(queue));
+	}
+
+	/* items left queued are not freed */
+	mpsc_queue_enqueue(queue, ITEM(0, 1));
+	FREE_NULL_MPSC_QUEUE(queue);
+	ck_assert(!queue);
+}
+END_TEST
+
+START_TEST(test_contention)
+{
+	mpsc_queue_t *queue = mpsc_queue_create();
+	list_t *list = list_create(NULL);
+	long queue_usec, list_usec;
+
+	queue_usec = _run_contention(queue, NULL);
+	ck_assert(mpsc_queue_is_empty(queue));
+	list_usec = _run_contention(NULL, list);
+	ck_assert(!list_count(list));
+
+	info("%d producers x %d items: mpsc_queue %ld usec, list_t %ld usec",
+	     PRODUCERS, ITEMS_PER_PRODUCER, queue_usec, list_usec);
+
+	FREE_NULL_MPSC_QUEUE(queue);
+	FREE_NULL_LIST(list);
+}
+END_TEST
+
+Suite *suite_mpsc_queue(void)
+{
+	Suite *s = suite_create("mpsc_queue");
+	TCase *tc_core = tcase_create("mpsc_queue");
+
+	tcase_set_timeout(tc_core, 120);
+	tcase_add_test(tc_core, test_basic);
+	tcase_add_test(tc_core, test_contention);
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+int main(void)
+{
+	int number_failed;
+	enum print_output po = CK_ENV;
+	enum fork_status fs = CK_FORK_GETENV;
+	SRunner *sr = NULL;
+	const char *debug_env = getenv("SLURM_DEBUG");
+	const char *debug_flags_env = getenv("SLURM_DEBUG_FLAGS");
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+
+	if (debug_env)
+		log_opts.stderr_level = log_string2num(debug_env);
+	if (debug_flags_env)
+		debug_str2flags(debug_flags_env, &slurm_conf.debug_flags);
+
+	log_init("mpsc_queue-test", log_opts, 0, NULL);
+
+	if (log_opts.stderr_level >= LOG_LEVEL_DEBUG) {
+		/* automatically be gdb friendly when debug logging */
+		po = CK_VERBOSE;
+		fs = CK_NOFORK;
+	}
+
+	sr = srunner_create(suite_mpsc_queue());
+	srunner_set_fork_status(sr, fs);
+	srunner_run_all(sr, po);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
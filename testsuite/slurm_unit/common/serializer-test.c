@@ -548,7 +548,7 @@ typedef struct {int a; int b;} mem_track_t;
 #endif /* !HAVE_MALLINFO2 */
 
 static void _test_bandwidth_str(const char *tag, const char *source,
-				const int run_count)
+				const char *mime_type, const int run_count)
 {
 	DEF_TIMERS;
 	int rc;
@@ -573,7 +573,7 @@ static void _test_bandwidth_str(const char *tag, const char *source,
 
 		START_TIMER;
 		rc = serialize_g_string_to_data(&data, source,
-						test_json_len, MIME_TYPE_JSON);
+						test_json_len, mime_type);
 		END_TIMER3(__func__, INFINITE);
 
 		_track_mem(&read_mem);
@@ -592,8 +592,7 @@ static void _test_bandwidth_str(const char *tag, const char *source,
 
 		START_TIMER;
 		rc = serialize_g_data_to_string(&output, &output_len, data,
-						MIME_TYPE_JSON,
-						SER_FLAGS_PRETTY);
+						mime_type, SER_FLAGS_PRETTY);
 		END_TIMER3(__func__, INFINITE);
 
 		_track_mem(&write_mem);
@@ -629,7 +628,7 @@ static void _test_bandwidth_str(const char *tag, const char *source,
 	fastest_read_rate = fastest_read_rate_bytes / BYTES_IN_MiB;
 	fastest_write_rate = fastest_write_rate_bytes / BYTES_IN_MiB;
 
-	printf("%s: %u runs:\n", tag, run_count);
+	printf("%s with %s: %u runs:\n", tag, mime_type, run_count);
 
 	printf("\tfastest read=%"PRIu64" usec\n\tfastest write=%"PRIu64" usec\n\n",
 	       fastest_read, fastest_write);
@@ -649,9 +648,43 @@ static void _test_bandwidth_str(const char *tag, const char *source,
 
 START_TEST(test_bandwidth)
 {
-	for (int i = 0; i < ARRAY_SIZE(test_json); i++)
+	for (int i = 0; i < ARRAY_SIZE(test_json); i++) {
+		data_t *data = NULL;
+		int rc;
+
 		_test_bandwidth_str(test_json[i].tag, test_json[i].source,
-				    test_json[i].run_count);
+				    MIME_TYPE_JSON, test_json[i].run_count);
+
+		/* compare against the other serializers with the same data */
+		rc = serialize_g_string_to_data(&data, test_json[i].source,
+						strlen(test_json[i].source),
+						MIME_TYPE_JSON);
+		assert_int_eq(rc, 0);
+
+		for (int m = 0; m < ARRAY_SIZE(mime_types); m++) {
+			const char *mptr = NULL;
+			const char *mime_type =
+				resolve_mime_type(mime_types[m], &mptr);
+			char *source = NULL;
+
+			if (!mime_type || !xstrcmp(mime_type, MIME_TYPE_JSON)) {
+				debug("skipping bandwidth with %s",
+				      mime_types[m]);
+				continue;
+			}
+
+			rc = serialize_g_data_to_string(&source, NULL, data,
+							mime_type,
+							SER_FLAGS_COMPACT);
+			assert_int_eq(rc, 0);
+
+			_test_bandwidth_str(test_json[i].tag, source, mime_type,
+					    test_json[i].run_count);
+			xfree(source);
+		}
+
+		FREE_NULL_DATA(data);
+	}
 }
 END_TEST
 
@@ -694,6 +727,67 @@ START_TEST(test_compliance)
 }
 END_TEST
 
+START_TEST(test_yaml_strings)
+{
+	/* strings needing quoting, line folding or escaping in YAML */
+	static const char *strs[] = {
+		"",
+		" ",
+		"plain",
+		" leading space",
+		"trailing space ",
+		"-",
+		"- item",
+		"-dash",
+		"? key",
+		": value",
+		"key: value",
+		"a:b",
+		"#comment",
+		"not # a comment",
+		"not#comment",
+		"it's",
+		"\"quoted\"",
+		"node[001-100],other[1-2]",
+		"{flow}",
+		"---",
+		"...",
+		"true",
+		"null",
+		"~",
+		"123",
+		"tab\tinside",
+		"new\nline",
+		"caf\xc3\xa9",
+		"a long string with plenty of spaces that will need to be folded once it passes the 80th column of the output line",
+		"'a long quoted string with plenty of spaces that will need to be folded once it passes the 80th column'",
+	};
+	const char *mptr = NULL;
+	const char *mime_type = resolve_mime_type(MIME_TYPE_YAML, &mptr);
+	data_t *d;
+
+	if (!mime_type) {
+		debug("skipping test without %s", MIME_TYPE_YAML);
+		return;
+	}
+
+	d = data_set_dict(data_new());
+
+	for (int i = 0; i < ARRAY_SIZE(strs); i++) {
+		data_t *list = data_set_list(data_key_set(d, strs[i]));
+
+		data_set_string(data_list_append(list), strs[i]);
+		data_set_string(data_key_set(data_set_dict(
+			data_list_append(list)), strs[i]), strs[i]);
+	}
+
+	for (int f = 0; f < ARRAY_SIZE(flag_combinations); f++)
+		_test_run("yaml strings", d, mime_type, flag_combinations[f]);
+
+	FREE_NULL_DATA(d);
+}
+END_TEST
+
 extern Suite *suite_data(void)
 {
 	Suite *s = suite_create("Serializer");
@@ -705,6 +799,7 @@ extern Suite *suite_data(void)
 	tcase_add_test(tc_core, test_mimetype);
 	tcase_add_test(tc_core, test_parse);
 	tcase_add_test(tc_core, test_compliance);
+	tcase_add_test(tc_core, test_yaml_strings);
 	tcase_add_test(tc_core, test_bandwidth);
 
 	suite_add_tcase(s, tc_core);